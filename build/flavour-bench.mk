@@ -0,0 +1,10 @@
+# Configuration for "bench" flavour:
+# Build executable that runs the component benchmarks (see src/bench/main.cc).
+
+# Optimisation flags.
+CXXFLAGS+=-O3 -DNDEBUG
+
+# Strip executable?
+OPENMSX_STRIP:=false
+
+BENCH:=true
@@ -190,6 +190,7 @@ TARGET_FLAGS+=$(shell $(PYTHON) build/cpu2flags.py $(OPENMSX_TARGET_CPU))
 include build/flavour-$(OPENMSX_FLAVOUR).mk
 
 UNITTEST?=false
+BENCH?=false
 
 
 # Paths
@@ -274,12 +275,22 @@ ifneq ($(COMPONENT_ALSAMIDI),true)
 SOURCES_FULL:=$(filter-out src/serial/MidiSessionALSA.cc,$(SOURCES_FULL))
 endif
 
+ifneq ($(COMPONENT_ALSASOUND),true)
+SOURCES_FULL:=$(filter-out src/sound/ALSASoundDriver.cc,$(SOURCES_FULL))
+endif
+
 ifeq ($(UNITTEST),true)
 SOURCES_FULL:=$(filter-out src/main.cc,$(SOURCES_FULL))
 else
 SOURCES_FULL:=$(filter-out src/unittest/%.cc,$(SOURCES_FULL))
 endif
 
+ifeq ($(BENCH),true)
+SOURCES_FULL:=$(filter-out src/main.cc,$(SOURCES_FULL))
+else
+SOURCES_FULL:=$(filter-out src/bench/%.cc,$(SOURCES_FULL))
+endif
+
 # Apply subset to sources list.
 SOURCES_FULL:=$(filter $(SOURCES_PATH)/$(OPENMSX_SUBSET)%,$(SOURCES_FULL))
 ifeq ($(SOURCES_FULL),)
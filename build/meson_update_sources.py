@@ -12,7 +12,7 @@ def scanSources(baseDir):
 		assert dirPath.startswith(baseDir)
 		prefix = dirPath[len(baseDir):]
 		if prefix:
-			if not (prefix == 'unittest' or prefix.endswith('__pycache__')):
+			if not (prefix in ('unittest', 'bench') or prefix.endswith('__pycache__')):
 				dirs.append(prefix)
 			prefix += '/'
 		else:
@@ -27,10 +27,13 @@ def scanSources(baseDir):
 def mesonSources():
 	files, dirs = scanSources('src/')
 	testSources = []
+	benchSources = []
 	yield "sources = files("
 	for name in sorted(files):
 		if name.startswith('unittest/'):
 			testSources.append(name)
+		elif name.startswith('bench/'):
+			benchSources.append(name)
 		elif not (name == 'main.cc'
 				or name.endswith('Test.cc')
 				or name.endswith('_test.cc')
@@ -47,6 +50,11 @@ def mesonSources():
 		yield "    '%s'," % name
 	yield "    )"
 	yield ""
+	yield "bench_sources = files("
+	for name in benchSources:
+		yield "    '%s'," % name
+	yield "    )"
+	yield ""
 	yield "incdirs = include_directories("
 	for name in dirs:
 		yield "    '%s'," % name
@@ -0,0 +1,3 @@
+// Automatically generated by build system.
+#define HAVE_FTRUNCATE 1
+#define HAVE_MMAP 1
@@ -0,0 +1,49 @@
+namespace eval cpu_benchmark {
+
+set_help_text cpu_benchmark \
+{Usage: cpu_benchmark [<seconds>]
+
+Measures how fast the active machine can be emulated: throttling is turned
+off for the given number of (real) seconds (default 10), after that the
+emulated time and the number of CPU clock cycles (of the active CPU, Z80 or
+R800) per real second are reported. Start this while the MSX is running the
+workload you want to measure.
+}
+
+variable running false
+
+proc cpu_benchmark {{seconds 10}} {
+	variable running
+	if {$running} {
+		error "A benchmark is already running."
+	}
+	if {![string is double -strict $seconds] || $seconds <= 0} {
+		error "Expected a positive number of seconds, got: $seconds"
+	}
+	set cpu [get_active_cpu]
+	set old_throttle $::throttle
+	set ::throttle off
+	set running true
+	after realtime $seconds [namespace code [list finish $cpu $old_throttle \
+		[machine_info time] [openmsx_info realtime]]]
+	return "Benchmarking for $seconds seconds..."
+}
+
+proc finish {cpu old_throttle emu_start real_start} {
+	variable running
+	set emu_time  [expr {[machine_info time] - $emu_start}]
+	set real_time [expr {[openmsx_info realtime] - $real_start}]
+	set ::throttle $old_throttle
+	set running false
+
+	set speed  [expr {$emu_time / $real_time}]
+	set cycles [expr {$speed * [machine_info ${cpu}_freq]}]
+	message [format "%s: %.1fx real time, %.2f million %s cycles per second" \
+		[machine_info config_name] $speed [expr {$cycles / 1e6}] $cpu]
+}
+
+namespace export cpu_benchmark
+
+} ;# namespace cpu_benchmark
+
+namespace import cpu_benchmark::*
@@ -17,11 +17,16 @@ set_help_text filepool \
 
   filepool reset
     Reset the filepool settings to the default values.
+
+  filepool find <sha1> [<typelist>]
+    Search the filepool for a file with the given sha1sum and return its
+    filename (or an empty string if it's not found). Optionally only search
+    the entries for the given filetypes (by default all types).
 }
 
 proc filepool_completion {args} {
 	if {[llength $args] == 2} {
-		return [list list add remove reset]
+		return [list list add remove reset find]
 	}
 	return [list -path -types -position system_rom rom disk tape]
 }
@@ -36,8 +41,9 @@ proc filepool {args} {
 		"add"    {filepool_add {*}$args}
 		"remove" {filepool_remove $args}
 		"reset"  {filepool_reset}
+		"find"   {__filepool_find {*}$args}
 		"default" {
-			error "Invalid subcommand, expected one of 'list add remove reset', but got '$cmd'"
+			error "Invalid subcommand, expected one of 'list add remove reset find', but got '$cmd'"
 		}
 	}
 }
@@ -1,5 +1,7 @@
 # convenience wrappers around the low level savestate commands
 
+user_setting create boolean savestate_binary "Save states in the binary format: much faster, but can only be loaded by the same openMSX version" false
+
 namespace eval savestate {
 
 proc savestate_common {} {
@@ -19,7 +21,11 @@ proc savestate {{name ""}} {
 		catch {file delete -- $png}
 	}
 	set currentID [machine]
-	store_machine $currentID $fullname
+	if {$::savestate_binary} {
+		store_machine -binary $currentID $fullname
+	} else {
+		store_machine $currentID $fullname
+	}
 	return $fullname
 }
 
@@ -0,0 +1,94 @@
+namespace eval cassette_instant_load {
+
+user_setting create boolean cassette_instant_load \
+"Whether CAS and TSX images that are read via the BIOS tape routines (e.g.
+via CLOAD, BLOAD\"CAS:\" or RUN\"CAS:\") are loaded instantly. This works by
+intercepting the BIOS routines TAPION and TAPIN. Programs with their own
+(turbo) loader, and parts of the tape that are not in the standard MSX format,
+are still loaded via the normal (slow) way. Unlike the
+fast_cas_load_hack_enabled setting, the cassetteplayer keeps working as usual
+(tape position, motor control)." false
+
+# The jump target of these BIOS entries is intercepted (instead of the entry
+# itself), so that code that calls the routines directly is also handled.
+variable bios_entries [list 0x00E2 tapion 0x00E5 tapin]
+
+variable bp_ids [list]
+variable machine_switch_trigger_id ""
+
+proc install {} {
+	uninstall
+
+	# The breakpoint addresses depend on the BIOS of the active machine.
+	variable machine_switch_trigger_id [after machine_switch [namespace code install]]
+
+	# SVI machines use a different tape format
+	if {[catch {machine_info type} type] || $type eq "SVI"} return
+	if {[catch {machine_info connector cassetteport}]} return
+
+	variable bios_entries
+	variable bp_ids
+	foreach {addr func} $bios_entries {
+		if {[catch {peek16 $addr "slotted memory"} target]} continue
+		lappend bp_ids [debug set_bp $target {[pc_in_slot 0 0]} [namespace code $func]]
+	}
+}
+
+proc uninstall {} {
+	variable bp_ids
+	foreach id $bp_ids {
+		catch {debug remove_bp $id} ;# may already be removed by the user
+	}
+	set bp_ids [list]
+
+	variable machine_switch_trigger_id
+	if {$machine_switch_trigger_id ne ""} {
+		after cancel $machine_switch_trigger_id
+		set machine_switch_trigger_id ""
+	}
+}
+
+proc ret {} {
+	reg PC [peek16 [reg SP]]
+	reg SP [expr {[reg SP] + 2}]
+}
+
+# In both routines: when the cassetteplayer can't provide the data (no tape,
+# WAV image, custom format), simply continue the BIOS routine, it then reads
+# the waveform as usual.
+
+proc tapion {} {
+	# TAPION: turn motor on and read the sync tone, C-flag set if failed
+	if {[catch {cassetteplayer bios tapion} found] || !$found} return
+	debug write ioports 0xAB 0x08 ;# motor on (PPI port C bit 4 reset)
+	reg F 0x40 ;# ok, clear carry flag
+	ret
+}
+
+proc tapin {} {
+	# TAPIN: read a byte from the tape into A, C-flag set if failed
+	if {[catch {cassetteplayer bios tapin} value] || $value < 0} return
+	reg A $value
+	reg F 0x40 ;# ok, clear carry flag
+	ret
+}
+
+proc setting_changed {name1 name2 op} {
+	if {$::cassette_instant_load} {
+		install
+	} else {
+		uninstall
+	}
+}
+
+trace add variable ::cassette_instant_load write [namespace code setting_changed]
+
+proc initial_set {} {
+	if {$::cassette_instant_load} {
+		install
+	}
+}
+
+after realtime 0 [namespace code initial_set]
+
+} ;# namespace cassette_instant_load
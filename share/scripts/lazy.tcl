@@ -5,6 +5,7 @@ register_lazy "_about.tcl" about
 register_lazy "_backwards_compatibility.tcl" {quit decr restoredefault alias}
 register_lazy "_cheat.tcl" {findcheat}
 register_lazy "_cashandler.tcl" {casload cassave caslist casrun caspos caseject tapedeck}
+register_lazy "_cpu_benchmark.tcl" cpu_benchmark
 register_lazy "_cpuregs.tcl" {reg cpuregs get_active_cpu}
 register_lazy "_cycle.tcl" {cycle cycle_back toggle}
 register_lazy "_cycle_machine.tcl" {cycle_machine cycle_back_machine}
@@ -47,6 +48,7 @@ register_lazy "_savestate.tcl" {
 	savestate loadstate delete_savestate list_savestates list_savestates_raw}
 register_lazy "_scc_toys.tcl" {
 	toggle_scc_editor toggle_psg2scc set_scc_wave toggle_scc_viewer}
+register_lazy "_sdcdb.tcl" sdcdb
 register_lazy "_shuffler.tcl" {shuffler}
 register_lazy "_showdebuggable.tcl" {showdebuggable showmem}
 register_lazy "_slot.tcl" {
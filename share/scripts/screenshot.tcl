@@ -1,6 +1,12 @@
 namespace eval openmsx {
 
 proc screenshot {args} {
+	if {[lindex $args 0] eq "compare"} {
+		if {[llength $args] < 2} {
+			error "Missing reference image, see 'help screenshot'"
+		}
+		return [::openmsx::internal_screenshot -raw -compare {*}[lrange $args 1 end]]
+	}
 	set args2 [list]
 	set sprites true
 	foreach arg $args {
@@ -41,14 +47,25 @@ screenshot -raw -size 640    640x480 raw screenshot (of MSX screen only)
 screenshot -raw -size 320    320x240 raw screenshot (of MSX screen only)
 screenshot -raw -size auto   raw screenshot (of MSX screen only), with size determined by screen mode
 screenshot -raw              raw screenshot (of MSX screen only), default -size (auto)
+screenshot -raw -scaler hq2x raw screenshot, additionally scaled with hq2x (or hq3x, hq4x, scale2x, scale3x, scale4x)
 screenshot -with-osd         Include OSD elements in the screenshot
+screenshot -format ppm       Write an uncompressed PPM file instead of a PNG file (default -format png)
+screenshot -async            Encode and write the file in the background, the command returns immediately
 screenshot -no-sprites       Don't include sprites in the screenshot
 screenshot -guess-name       Guess the name of the running software and use it as prefix
+screenshot compare <ref>     Compare the raw MSX screen against reference image <ref> (PNG or PPM), in memory.
+                             Returns a dict with the number of 'pixels', the number of 'different' pixels,
+                             the 'max_delta' and the 'mean_delta' of the color components (0-255).
+                             Accepts the -size and -scaler options of -raw, and -diff <filename> to also
+                             write an image of the differences.
 }
 
 set_tabcompletion_proc screenshot [namespace code screenshot_tab]
 proc screenshot_tab {args} {
-	list "-prefix" "-raw" "-size" "-with-osd" "-no-sprites" "-guess-name"
+	if {[lindex $args 1] eq "compare"} {
+		return [list "-size" "-scaler" "-diff" "-format" "-async"]
+	}
+	list "compare" "-prefix" "-raw" "-size" "-scaler" "-with-osd" "-format" "-async" "-no-sprites" "-guess-name"
 }
 
 namespace export screenshot
@@ -18,7 +18,12 @@ void main()
 
 	// extend to (64N x 64N) texture-coordinate
 	xy = (floor(64.0 * xy) + fract(weightPos)) / 64.0;
-	vec4 offsets = texture2D(offsetTex, xy);
+	// Offsets of the two neighbours (x0, y0, x1, y1), each 0, 1 or 2,
+	// packed as a base-3 number in one byte. The 0.5 avoids rounding
+	// problems in the division.
+	float packed = floor(texture2D(offsetTex, xy).r * 255.0 + 0.5) + 0.5;
+	vec4 q = floor(packed / vec4(27.0, 9.0, 3.0, 1.0));
+	vec4 offsets = (q - 3.0 * vec4(0.0, q.xyz)) * (128.0 / 255.0);
 	vec3 weights = texture2D(weightTex, xy).xyz;
 
 	vec4 c5 = texture2D(colorTex, mid);
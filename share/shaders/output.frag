@@ -0,0 +1,31 @@
+// Final output pass of the PostProcessor: copy the rendered frame to the
+// screen, optionally (compile-time) mixed with the previous frame and with
+// noise added. This replaces separate blended passes.
+
+uniform sampler2D u_tex;
+#ifdef BLEND
+uniform sampler2D u_prevTex;
+uniform float u_prevWeight;
+#endif
+#ifdef NOISE
+uniform sampler2D u_noiseA;
+uniform sampler2D u_noiseB;
+#endif
+
+varying vec2 v_texCoord;
+#ifdef NOISE
+varying vec2 v_noiseCoord;
+#endif
+
+void main()
+{
+	vec3 color = texture2D(u_tex, v_texCoord).rgb;
+#ifdef BLEND
+	color = mix(color, texture2D(u_prevTex, v_texCoord).rgb, u_prevWeight);
+#endif
+#ifdef NOISE
+	color += texture2D(u_noiseA, v_noiseCoord).r
+	       - texture2D(u_noiseB, v_noiseCoord).r;
+#endif
+	gl_FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,21 @@
+uniform mat4 u_mvpMatrix;
+
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+#ifdef NOISE
+attribute vec2 a_noiseCoord;
+#endif
+
+varying vec2 v_texCoord;
+#ifdef NOISE
+varying vec2 v_noiseCoord;
+#endif
+
+void main()
+{
+	gl_Position = u_mvpMatrix * a_position;
+	v_texCoord  = a_texCoord;
+#ifdef NOISE
+	v_noiseCoord = a_noiseCoord;
+#endif
+}
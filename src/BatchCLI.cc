@@ -0,0 +1,216 @@
+#include "BatchCLI.hh"
+
+#include "CommandLineParser.hh"
+#include "File.hh"
+#include "FileException.hh"
+#include "FileOperations.hh"
+#include "MSXException.hh"
+
+#include "StringOp.hh"
+#include "stl.hh"
+#include "strCat.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+namespace openmsx {
+
+BatchCLI::BatchCLI(CommandLineParser& parser)
+{
+	using enum CommandLineParser::Phase;
+	parser.registerOption("-batch", *this, BEFORE_INIT);
+	parser.registerOption("-j", jobsOption, BEFORE_INIT);
+}
+
+void BatchCLI::parseOption(const std::string& option, std::span<std::string>& cmdLine)
+{
+	if (isActive()) {
+		throw FatalError("Only one -batch option allowed");
+	}
+	jobFile = getArgument(option, cmdLine);
+}
+
+std::string_view BatchCLI::optionHelp() const
+{
+	return "Run each line of the given file as a headless openMSX job";
+}
+
+void BatchCLI::JobsOption::parseOption(const std::string& option, std::span<std::string>& cmdLine)
+{
+	auto arg = getArgument(option, cmdLine);
+	auto n = StringOp::stringToBase<10, unsigned>(arg);
+	if (!n || (*n == 0)) {
+		throw FatalError("Invalid number of parallel jobs: ", arg);
+	}
+	count = *n;
+}
+
+std::string_view BatchCLI::JobsOption::optionHelp() const
+{
+	return "Maximum number of parallel jobs in batch mode (default: number of cores)";
+}
+
+// Split a line in arguments. Arguments are separated by whitespace. Double
+// quotes can be used to group words, a backslash escapes the next character.
+static std::vector<std::string> splitJobLine(std::string_view line)
+{
+	std::vector<std::string> result;
+	std::string current;
+	bool inArg = false;
+	bool quoted = false;
+	for (size_t i = 0; i < line.size(); ++i) {
+		char c = line[i];
+		if ((c == '\\') && ((i + 1) < line.size())) {
+			current += line[++i];
+			inArg = true;
+		} else if (c == '"') {
+			quoted = !quoted;
+			inArg = true;
+		} else if (!quoted && ((c == ' ') || (c == '\t'))) {
+			if (inArg) {
+				result.push_back(std::move(current));
+				current.clear();
+				inArg = false;
+			}
+		} else {
+			current += c;
+			inArg = true;
+		}
+	}
+	if (quoted) {
+		throw FatalError("Unterminated quote in batch job: ", line);
+	}
+	if (inArg) result.push_back(std::move(current));
+	return result;
+}
+
+std::vector<BatchCLI::Job> BatchCLI::readJobFile() const
+{
+	std::vector<Job> result;
+	try {
+		File file(jobFile);
+		auto size = file.getSize();
+		std::string buf(size, '\0');
+		file.read(std::span{buf.data(), buf.size()});
+		for (auto line : StringOp::split_view<StringOp::EmptyParts::REMOVE>(buf, '\n')) {
+			StringOp::trim(line, " \t\r");
+			if (line.empty() || line.starts_with('#')) continue;
+			result.push_back(Job{.args = splitJobLine(line)});
+		}
+	} catch (FileException& e) {
+		throw FatalError("Couldn't read batch job file: ", e.getMessage());
+	}
+	return result;
+}
+
+#ifndef _WIN32
+
+static std::string jobName(size_t i)
+{
+	auto s = std::to_string(i + 1);
+	if (s.size() < 4) s.insert(0, 4 - s.size(), '0');
+	return s;
+}
+
+unsigned BatchCLI::run(const char* executable, std::span<const std::string> commonArgs)
+{
+	auto jobs = readJobFile();
+	auto resultDir = strCat(jobFile, ".results");
+	FileOperations::mkdirp(resultDir);
+
+	unsigned maxParallel = jobsOption.count ? jobsOption.count
+	                                        : std::max(1u, std::thread::hardware_concurrency());
+
+	auto startJob = [&](size_t i) {
+		auto& job = jobs[i];
+		auto name = jobName(i);
+		auto outDir = FileOperations::join(resultDir, name);
+		FileOperations::mkdirp(outDir);
+		auto logFile = strCat(outDir, ".log");
+
+		// Headless: no video, no audio and don't overwrite the user's
+		// settings.xml with these modified settings.
+		std::vector<std::string> args = {
+			executable,
+			"-command", "set save_settings_on_exit false",
+			"-command", "set renderer none",
+			"-command", "set sound_driver null",
+		};
+		append(args, commonArgs);
+		append(args, job.args);
+		std::vector<char*> argv;
+		for (auto& a : args) argv.push_back(a.data());
+		argv.push_back(nullptr);
+
+		std::vector<std::string> envStrings = {
+			strCat("OPENMSX_BATCH_JOB=", name),
+			strCat("OPENMSX_BATCH_OUTDIR=", outDir),
+		};
+		std::vector<char*> envp;
+		for (auto& e : envStrings) envp.push_back(e.data());
+		for (char** e = environ; *e; ++e) {
+			std::string_view v = *e;
+			if (!v.starts_with("OPENMSX_BATCH_")) envp.push_back(*e);
+		}
+		envp.push_back(nullptr);
+
+		posix_spawn_file_actions_t actions;
+		posix_spawn_file_actions_init(&actions);
+		posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+		posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, logFile.c_str(),
+		                                 O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+		pid_t pid;
+		int err = posix_spawnp(&pid, executable, &actions, nullptr, argv.data(), envp.data());
+		posix_spawn_file_actions_destroy(&actions);
+		if (err != 0) {
+			throw FatalError("Couldn't start batch job ", name, ": ", strerror(err));
+		}
+		job.pid = pid;
+	};
+
+	size_t next = 0;
+	unsigned running = 0;
+	unsigned failed = 0;
+	while ((next < jobs.size()) || (running != 0)) {
+		while ((next < jobs.size()) && (running < maxParallel)) {
+			startJob(next++);
+			++running;
+		}
+		int status;
+		pid_t pid = waitpid(-1, &status, 0);
+		if (pid < 0) break; // no more children (shouldn't happen)
+		auto it = std::ranges::find(jobs, pid, &Job::pid);
+		if (it == jobs.end()) continue;
+		--running;
+		it->status = status;
+		bool ok = WIFEXITED(status) && (WEXITSTATUS(status) == 0);
+		if (!ok) ++failed;
+		std::cout << "job " << jobName(it - jobs.begin()) << ": "
+		          << (ok ? "ok" : "FAILED") << '\n' << std::flush;
+	}
+	std::cout << jobs.size() << " jobs, " << failed << " failed, "
+	             "results in " << resultDir << '\n';
+	return failed;
+}
+
+#else
+
+unsigned BatchCLI::run(const char* /*executable*/, std::span<const std::string> /*commonArgs*/)
+{
+	throw FatalError("Batch mode is not supported on this platform");
+}
+
+#endif
+
+} // namespace openmsx
@@ -0,0 +1,63 @@
+#ifndef BATCHCLI_HH
+#define BATCHCLI_HH
+
+#include "CLIOption.hh"
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace openmsx {
+
+class CommandLineParser;
+
+/** Headless batch mode: 'openmsx -batch jobs.txt [-j N] [common args]'.
+  *
+  * Each (non-empty, non-comment) line in the job file contains the command
+  * line arguments for one job. Jobs run as separate openMSX processes, so
+  * each has its own Reactor, Tcl interpreter and MSXMotherBoard (and thus
+  * its own Scheduler, MSXMixer, ...). The emulator core is single threaded
+  * (e.g. the Tcl interpreter cannot be shared between threads), so this is
+  * the way to use multiple cores. At most N jobs run concurrently.
+  *
+  * Every job runs with the 'none' renderer and the 'null' sound driver.
+  * Its stdout/stderr output is captured in '<jobfile>.results/<n>.log'.
+  * The environment variables OPENMSX_BATCH_JOB and OPENMSX_BATCH_OUTDIR
+  * allow the job scripts to store results (screenshots, savestates,
+  * Tcl return values, ...) in a per-job output directory.
+  */
+class BatchCLI final : public CLIOption
+{
+public:
+	explicit BatchCLI(CommandLineParser& parser);
+	void parseOption(const std::string& option,
+	                 std::span<std::string>& cmdLine) override;
+	[[nodiscard]] std::string_view optionHelp() const override;
+
+	[[nodiscard]] bool isActive() const { return !jobFile.empty(); }
+
+	/** Run all jobs, 'commonArgs' are passed to each job (before the
+	  * job specific arguments). Returns the number of failed jobs.
+	  */
+	unsigned run(const char* executable, std::span<const std::string> commonArgs);
+
+private:
+	struct Job {
+		std::vector<std::string> args;
+		int pid = -1;
+		int status = -1;
+	};
+	[[nodiscard]] std::vector<Job> readJobFile() const;
+
+	struct JobsOption final : CLIOption {
+		void parseOption(const std::string& option, std::span<std::string>& cmdLine) override;
+		[[nodiscard]] std::string_view optionHelp() const override;
+		unsigned count = 0; // 0 -> number of cores
+	} jobsOption;
+
+	std::string jobFile;
+};
+
+} // namespace openmsx
+
+#endif
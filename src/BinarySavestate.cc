@@ -0,0 +1,272 @@
+#include "BinarySavestate.hh"
+
+#include "File.hh"
+#include "FileException.hh"
+#include "MSXException.hh"
+#include "MSXMotherBoard.hh"
+#include "ThreadPool.hh"
+#include "Version.hh"
+#include "serialize.hh"
+
+#include "DeltaBlock.hh"
+#include "MemBuffer.hh"
+#include "ranges.hh"
+#include "strCat.hh"
+#include "xrange.hh"
+#include "xxhash.hh"
+
+#include "build-info.hh"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace openmsx::BinarySavestate {
+
+// File layout (all integers in native byte order, the file is anyway only
+// usable on the platform that created it):
+//   char[8]   signature "oMSXbst\x1a"
+//   uint32    format version
+//   uint32    length of the build id, followed by the build id itself
+//   uint64    size of the MemOutputArchive stream
+//   uint32    number of memory blocks (DeltaBlocks), followed by their sizes
+//   uint32    number of chunks, followed by a {rawSize, storedSize,
+//             xxhash of the raw data} triple (3 x uint32) per chunk
+//   ...       the chunks
+// Concatenated, the raw chunks contain the archive stream followed by all
+// memory blocks. A chunk with storedSize == rawSize is not compressed.
+static constexpr std::array<char, 8> SIGNATURE = {'o', 'M', 'S', 'X', 'b', 's', 't', '\x1a'};
+static constexpr uint32_t FORMAT_VERSION = 1;
+static constexpr size_t CHUNK_SIZE = 256 * 1024;
+
+[[nodiscard]] static std::string getBuildId()
+{
+	return strCat(Version::full(), ' ', TARGET_PLATFORM, '-', TARGET_CPU, ' ', BUILD_FLAVOUR);
+}
+
+[[nodiscard]] static uint32_t calcHash(std::span<const uint8_t> data)
+{
+	return xxhash_impl<false>(data.data(), data.size());
+}
+
+bool isBinarySavestate(zstring_view filename)
+{
+	try {
+		File file(filename, "rb");
+		if (file.getSize() < SIGNATURE.size()) return false;
+		std::array<char, SIGNATURE.size()> buf;
+		file.read(std::span<char>{buf});
+		return buf == SIGNATURE;
+	} catch (FileException&) {
+		return false;
+	}
+}
+
+namespace {
+	class Writer {
+	public:
+		template<typename T> void add(const T& t) {
+			auto* p = reinterpret_cast<const uint8_t*>(&t);
+			data.insert(data.end(), p, p + sizeof(T));
+		}
+		void add(std::span<const uint8_t> s) {
+			data.insert(data.end(), s.begin(), s.end());
+		}
+		std::vector<uint8_t> data;
+	};
+
+	class Reader {
+	public:
+		explicit Reader(std::span<const uint8_t> data_) : data(data_) {}
+
+		template<typename T> [[nodiscard]] T get() {
+			T t;
+			memcpy(&t, take(sizeof(T)).data(), sizeof(T));
+			return t;
+		}
+		[[nodiscard]] std::span<const uint8_t> take(size_t n) {
+			if (n > data.size()) {
+				throw MSXException("Corrupt binary savestate: file is truncated.");
+			}
+			auto result = data.first(n);
+			data = data.subspan(n);
+			return result;
+		}
+
+	private:
+		std::span<const uint8_t> data;
+	};
+
+	struct ChunkInfo {
+		uint32_t rawSize;
+		uint32_t storedSize;
+		uint32_t hash;
+	};
+}
+
+void save(zstring_view filename, const MSXMotherBoard& board)
+{
+	LastDeltaBlocks lastDeltaBlocks;
+	std::vector<std::shared_ptr<DeltaBlock>> deltaBlocks;
+	MemOutputArchive out(lastDeltaBlocks, deltaBlocks, false);
+	out.serialize("machine", board);
+	auto stream = std::move(out).releaseBuffer();
+
+	// Gather the stream and the content of all memory blocks.
+	size_t total = stream.size();
+	for (const auto& block : deltaBlocks) total += block->getSize();
+	MemBuffer<uint8_t> raw(total);
+	copy_to_range(std::span{stream}, std::span{raw});
+	size_t pos = stream.size();
+	for (const auto& block : deltaBlocks) {
+		auto size = block->getSize();
+		block->apply(std::span{raw}.subspan(pos, size));
+		pos += size;
+	}
+
+	// Compress the chunks. Favour speed over compression ratio.
+	auto numChunks = (total + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	std::vector<ChunkInfo> infos(numChunks);
+	std::vector<MemBuffer<uint8_t>> packed(numChunks);
+	ThreadPool::parallelForTemporary(numChunks, [&](size_t i) {
+		auto src = std::span{raw}.subspan(i * CHUNK_SIZE, std::min(CHUNK_SIZE, total - i * CHUNK_SIZE));
+		auto& info = infos[i];
+		info.rawSize = uint32_t(src.size());
+		info.hash = calcHash(src);
+		auto dstLen = compressBound(uLong(src.size()));
+		packed[i].resize(dstLen);
+		if ((compress2(packed[i].data(), &dstLen, src.data(), uLong(src.size()), 1) == Z_OK) &&
+		    (dstLen < src.size())) {
+			info.storedSize = uint32_t(dstLen);
+		} else {
+			// not compressible (or compression failed), store as-is
+			info.storedSize = info.rawSize;
+			packed[i].resize(src.size());
+			copy_to_range(src, std::span{packed[i]});
+		}
+	});
+
+	Writer header;
+	header.add(SIGNATURE);
+	header.add(FORMAT_VERSION);
+	auto buildId = getBuildId();
+	header.add(uint32_t(buildId.size()));
+	header.add(std::span{reinterpret_cast<const uint8_t*>(buildId.data()), buildId.size()});
+	header.add(uint64_t(stream.size()));
+	header.add(uint32_t(deltaBlocks.size()));
+	for (const auto& block : deltaBlocks) header.add(uint32_t(block->getSize()));
+	header.add(uint32_t(numChunks));
+	for (const auto& info : infos) {
+		header.add(info.rawSize);
+		header.add(info.storedSize);
+		header.add(info.hash);
+	}
+
+	try {
+		File file(filename, "wb");
+		file.write(std::span{header.data});
+		for (auto i : xrange(numChunks)) {
+			file.write(std::span{packed[i].data(), infos[i].storedSize});
+		}
+	} catch (FileException& e) {
+		throw MSXException("Could not write savestate: ", e.getMessage());
+	}
+}
+
+void load(zstring_view filename, MSXMotherBoard& board)
+{
+	MemBuffer<uint8_t> fileData;
+	try {
+		File file(filename, "rb");
+		fileData.resize(file.getSize());
+		file.read(std::span{fileData});
+	} catch (FileException& e) {
+		throw MSXException("Could not read savestate: ", e.getMessage());
+	}
+	Reader reader(fileData);
+
+	if (!std::ranges::equal(reader.take(SIGNATURE.size()), SIGNATURE,
+	                        [](uint8_t a, char b) { return a == uint8_t(b); })) {
+		throw MSXException("Not a binary savestate.");
+	}
+	if (auto version = reader.get<uint32_t>(); version != FORMAT_VERSION) {
+		throw MSXException("Unsupported binary savestate format version: ", version);
+	}
+	auto idBytes = reader.take(reader.get<uint32_t>());
+	std::string_view buildId(reinterpret_cast<const char*>(idBytes.data()), idBytes.size());
+	if (auto current = getBuildId(); buildId != current) {
+		throw MSXException(
+			"This binary savestate was created by a different build of "
+			"openMSX (", buildId, "), it can only be loaded by that "
+			"same build (this is ", current, ").");
+	}
+
+	auto streamSize = reader.get<uint64_t>();
+	std::vector<uint32_t> blockSizes(reader.get<uint32_t>());
+	size_t total = streamSize;
+	for (auto& s : blockSizes) {
+		s = reader.get<uint32_t>();
+		total += s;
+	}
+	std::vector<ChunkInfo> infos(reader.get<uint32_t>());
+	size_t rawTotal = 0;
+	std::vector<std::span<const uint8_t>> stored;
+	stored.reserve(infos.size());
+	for (auto& info : infos) {
+		info.rawSize    = reader.get<uint32_t>();
+		info.storedSize = reader.get<uint32_t>();
+		info.hash       = reader.get<uint32_t>();
+		rawTotal += info.rawSize;
+	}
+	for (const auto& info : infos) {
+		stored.push_back(reader.take(info.storedSize));
+	}
+	if (rawTotal != total) {
+		throw MSXException("Corrupt binary savestate: inconsistent sizes.");
+	}
+
+	// Decompress all chunks (in parallel) and verify their content.
+	MemBuffer<uint8_t> raw(total);
+	std::vector<size_t> offsets;
+	offsets.reserve(infos.size());
+	size_t pos = 0;
+	for (const auto& info : infos) {
+		offsets.push_back(pos);
+		pos += info.rawSize;
+	}
+	ThreadPool::parallelForTemporary(infos.size(), [&](size_t i) {
+		const auto& info = infos[i];
+		auto dst = std::span{raw}.subspan(offsets[i], info.rawSize);
+		if (info.storedSize == info.rawSize) {
+			copy_to_range(stored[i], dst);
+		} else {
+			auto dstLen = uLongf(dst.size());
+			if ((uncompress(dst.data(), &dstLen, stored[i].data(), uLong(stored[i].size())) != Z_OK) ||
+			    (dstLen != dst.size())) {
+				throw MSXException("Corrupt binary savestate: error while decompressing.");
+			}
+		}
+		if (calcHash(dst) != info.hash) {
+			throw MSXException("Corrupt binary savestate: checksum mismatch.");
+		}
+	});
+
+	std::vector<std::shared_ptr<DeltaBlock>> deltaBlocks;
+	deltaBlocks.reserve(blockSizes.size());
+	pos = streamSize;
+	for (auto size : blockSizes) {
+		deltaBlocks.push_back(std::make_shared<DeltaBlockCopy>(std::span{raw}.subspan(pos, size)));
+		pos += size;
+	}
+
+	MemInputArchive in(std::span{raw}.first(streamSize), deltaBlocks);
+	in.serialize("machine", board);
+}
+
+} // namespace openmsx::BinarySavestate
@@ -0,0 +1,47 @@
+#ifndef BINARYSAVESTATE_HH
+#define BINARYSAVESTATE_HH
+
+#include "zstring_view.hh"
+
+namespace openmsx {
+
+class MSXMotherBoard;
+
+/** Savestate files in a compact binary format.
+  *
+  * The machine is serialized with MemOutputArchive, the same mechanism as
+  * used for reverse snapshots and clone_machine. The resulting stream and
+  * all (large) memory blocks are written as a sequence of independently
+  * zlib-compressed chunks, so both saving and loading can (de)compress the
+  * chunks in parallel.
+  *
+  * Contrary to the XML savestates (XmlOutputArchive), this format stores
+  * the objects with the exact memory layout of the openMSX executable that
+  * created it (there's no per-class versioning). So such a file can only
+  * be loaded by the same openMSX version on the same platform. XML remains
+  * the format for long term storage, exchange and debugging.
+  */
+namespace BinarySavestate {
+
+	/** Does the given file start with the signature of a binary savestate?
+	  * Returns false (doesn't throw) when the file can't be read.
+	  */
+	[[nodiscard]] bool isBinarySavestate(zstring_view filename);
+
+	/** Save the state of the given machine.
+	  * @throws MSXException
+	  */
+	void save(zstring_view filename, const MSXMotherBoard& board);
+
+	/** Restore a machine state saved with save(). 'board' should be a
+	  * freshly created (empty) machine.
+	  * @throws MSXException when the file can't be read, is corrupt or was
+	  *         created by a different build of openMSX.
+	  */
+	void load(zstring_view filename, MSXMotherBoard& board);
+
+} // namespace BinarySavestate
+
+} // namespace openmsx
+
+#endif
@@ -13,6 +13,7 @@
 #include "Reactor.hh"
 #include "RomInfo.hh"
 #include "SettingsConfig.hh"
+#include "StartupProfiler.hh"
 #include "StdioMessages.hh"
 #include "Version.hh"
 #include "XMLException.hh"
@@ -39,6 +40,7 @@ namespace openmsx {
 
 CommandLineParser::CommandLineParser(Reactor& reactor_)
 	: reactor(reactor_)
+	, batchCLI(*this)
 	, msxRomCLI(*this)
 	, cliExtension(*this)
 	, replayCLI(*this)
@@ -57,6 +59,7 @@ CommandLineParser::CommandLineParser(Reactor& reactor_)
 	registerOption("-v",          versionOption, BEFORE_INIT, 1);
 	registerOption("--version",   versionOption, BEFORE_INIT, 1);
 	registerOption("-bash",       bashOption,    BEFORE_INIT, 1);
+	registerOption("-startup-profile", startupProfileOption, BEFORE_INIT);
 
 	registerOption("-setting",    settingOption, BEFORE_SETTINGS);
 	registerOption("-control",    controlOption, BEFORE_SETTINGS, 1);
@@ -165,10 +168,22 @@ void CommandLineParser::parse(std::span<char*> argv)
 	     phase = static_cast<Phase>(std::to_underlying(phase) + 1)) {
 		switch (phase) {
 		case INIT:
+			if (batchCLI.isActive()) {
+				// remaining arguments are passed to each job
+				if (batchCLI.run(argv[0], cmdLine) != 0) {
+					exitCode = 1;
+				}
+				cmdLine = {};
+				parseStatus = Status::EXIT;
+				break;
+			}
 			reactor.init();
 			fileTypeCategoryInfo.emplace(
 				reactor.getOpenMSXInfoCommand(), *this);
-			getInterpreter().init(argv[0]);
+			{
+				StartupProfiler::Scope profile("Tcl init");
+				getInterpreter().init(argv[0]);
+			}
 			break;
 		case LOAD_SETTINGS:
 			// after -control and -setting has been parsed
@@ -186,6 +201,7 @@ void CommandLineParser::parse(std::span<char*> argv)
 				const auto& context = systemFileContext();
 				std::string filename = "settings.xml";
 				try {
+					StartupProfiler::Scope profile("load settings");
 					settingsConfig.loadSetting(context, filename);
 				} catch (XMLException& e) {
 					reactor.getCliComm().printWarning(
@@ -207,6 +223,7 @@ void CommandLineParser::parse(std::span<char*> argv)
 			break;
 		case DEFAULT_MACHINE: {
 			if (!haveConfig) {
+				StartupProfiler::Scope profile("default machine");
 				// load default setup in case the user didn't specify one
 				const auto& defaultSetup =
 					reactor.getDefaultSetupSetting().getString();
@@ -614,6 +631,19 @@ std::string_view CommandLineParser::TestConfigOption::optionHelp() const
 	return "Test if the specified config works and exit";
 }
 
+// class StartupProfileOption
+
+void CommandLineParser::StartupProfileOption::parseOption(
+	const std::string& option, std::span<std::string>& cmdLine)
+{
+	StartupProfiler::enable(FileOperations::expandTilde(getArgument(option, cmdLine)));
+}
+
+std::string_view CommandLineParser::StartupProfileOption::optionHelp() const
+{
+	return "Report startup timing, also as chrome://tracing JSON file";
+}
+
 // class BashOption
 
 void CommandLineParser::BashOption::parseOption(
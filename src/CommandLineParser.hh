@@ -1,6 +1,7 @@
 #ifndef COMMANDLINEPARSER_HH
 #define COMMANDLINEPARSER_HH
 
+#include "BatchCLI.hh"
 #include "CDImageCLI.hh"
 #include "CLIOption.hh"
 #include "CassettePlayerCLI.hh"
@@ -146,6 +147,11 @@ private:
 		[[nodiscard]] std::string_view optionHelp() const override;
 	} testConfigOption;
 
+	struct StartupProfileOption final : CLIOption {
+		void parseOption(const std::string& option, std::span<std::string>& cmdLine) override;
+		[[nodiscard]] std::string_view optionHelp() const override;
+	} startupProfileOption;
+
 	struct BashOption final : CLIOption {
 		void parseOption(const std::string& option, std::span<std::string>& cmdLine) override;
 		[[nodiscard]] std::string_view optionHelp() const override;
@@ -160,6 +166,7 @@ private:
 	};
 	std::optional<FileTypeCategoryInfoTopic> fileTypeCategoryInfo;
 
+	BatchCLI batchCLI;
 	MSXRomCLI msxRomCLI;
 	CliExtension cliExtension;
 	ReplayCLI replayCLI;
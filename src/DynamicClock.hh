@@ -98,9 +98,7 @@ public:
 	}
 
 	[[nodiscard]] uint64_t getTotalTicks() const {
-		// note: don't use divMod.div() because that one only returns a
-		//       32 bit result. Maybe improve in the future.
-		return lastTick.time / getStep();
+		return divMod.div64(lastTick.time);
 	}
 
 	/** Change the frequency at which this clock ticks.
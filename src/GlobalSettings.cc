@@ -28,6 +28,10 @@ GlobalSettings::GlobalSettings(GlobalCommandController& commandController_)
 		EnumSetting<ResampledSoundDevice::ResampleType>::Map{
 			{"hq",   ResampledSoundDevice::ResampleType::HQ},
 			{"blip", ResampledSoundDevice::ResampleType::BLIP}})
+	, pngCompressionSetting(commandController, "png_compression_level",
+		"zlib compression level for screenshots and printer output: "
+		"0 (fastest) .. 9 (smallest files)",
+		6, 0, 9) // 6 is zlib's default
 	, speedManager(commandController)
 	, throttleManager(commandController)
 {
@@ -38,6 +38,7 @@
 #include "Schedulable.hh"
 #include "Scheduler.hh"
 #include "SimpleDebuggable.hh"
+#include "StartupProfiler.hh"
 #include "StateChangeDistributor.hh"
 #include "TclObject.hh"
 #include "XMLElement.hh"
@@ -47,6 +48,7 @@
 #include "ScopedAssign.hh"
 #include "one_of.hh"
 #include "stl.hh"
+#include "strCat.hh"
 #include "unreachable.hh"
 
 #include <algorithm>
@@ -263,8 +265,8 @@ MSXMotherBoard::MSXMotherBoard(Reactor& reactor_)
 	//       on MSXMotherBoard, so "pimpl" has to be set up already.
 	eventDelay = std::make_unique<EventDelay>(
 		*scheduler, *msxCommandController,
-		reactor.getEventDistributor(), *msxEventDistributor,
-		*reverseManager);
+		reactor.getEventDistributor(), reactor.getInputEventGenerator(),
+		*msxEventDistributor, *reverseManager);
 	realTime = std::make_unique<RealTime>(
 		*this, reactor.getGlobalSettings(), *eventDelay);
 
@@ -349,8 +351,10 @@ std::string MSXMotherBoard::loadMachine(const std::string& machine)
 	assert(extensions.empty());
 	assert(!machineConfig2);
 	assert(!getMachineConfig());
+	StartupProfiler::Scope profile(tmpStrCat("load machine ", machine));
 
 	try {
+		StartupProfiler::Scope profileConfig("machine config");
 		machineConfig2 = HardwareConfig::createMachineConfig(*this, machine);
 		setMachineConfig(machineConfig2.get());
 	} catch (FileException& e) {
@@ -361,6 +365,7 @@ std::string MSXMotherBoard::loadMachine(const std::string& machine)
 		                   e.getMessage());
 	}
 	try {
+		StartupProfiler::Scope profileDevices("create devices");
 		machineConfig->parseSlots();
 		machineConfig->createDevices();
 	} catch (MSXException& e) {
@@ -368,6 +373,7 @@ std::string MSXMotherBoard::loadMachine(const std::string& machine)
 		                   e.getMessage());
 	}
 	if (powerSetting.getBoolean()) {
+		StartupProfiler::Scope profilePower("power up");
 		powerUp();
 	}
 	machineName = machine;
@@ -447,6 +453,7 @@ void MSXMotherBoard::storeAsSetup(const std::string& filename, SetupDepth depth)
 
 std::unique_ptr<HardwareConfig> MSXMotherBoard::loadExtension(std::string_view name, std::string_view slotName)
 {
+	StartupProfiler::Scope profile(tmpStrCat("extension config ", name));
 	try {
 		return HardwareConfig::createExtensionConfig(
 			*this, std::string(name), slotName);
@@ -462,6 +469,7 @@ std::unique_ptr<HardwareConfig> MSXMotherBoard::loadExtension(std::string_view n
 std::string MSXMotherBoard::insertExtension(
 	std::string_view name, std::unique_ptr<HardwareConfig> extension)
 {
+	StartupProfiler::Scope profile(tmpStrCat("insert extension ", name));
 	try {
 		extension->parseSlots();
 		extension->createDevices();
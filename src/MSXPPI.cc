@@ -84,6 +84,7 @@ void MSXPPI::writeA(uint8_t value, EmuTime /*time*/)
 
 uint8_t MSXPPI::readB(EmuTime time)
 {
+	keyboard.signalRowRead(selectedRow, time);
 	return peekB(time);
 }
 uint8_t MSXPPI::peekB(EmuTime time) const
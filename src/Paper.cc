@@ -22,13 +22,13 @@ Paper::Paper(unsigned x, unsigned y, double dotSizeX, double dotSizeY)
 	setDotSize(dotSizeX, dotSizeY);
 }
 
-std::string Paper::save() const
+std::string Paper::save(int compressionLevel) const
 {
 	auto filename = FileOperations::getNextNumberedFileName(
 		PRINT_DIR, "page", PRINT_EXTENSION);
 	small_buffer<const uint8_t*, 4096> rowPointers(std::views::transform(xrange(sizeY),
 		[&](size_t y) { return &buf[sizeX * y]; }));
-	PNG::saveGrayscale(sizeX, rowPointers, filename);
+	PNG::saveGrayscale(sizeX, rowPointers, filename, compressionLevel);
 	return filename;
 }
 
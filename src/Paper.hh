@@ -18,7 +18,7 @@ public:
 public:
 	Paper(unsigned x, unsigned y, double dotSizeX, double dotSizeY);
 
-	[[nodiscard]] std::string save() const;
+	[[nodiscard]] std::string save(int compressionLevel) const;
 	void setDotSize(double sizeX, double sizeY);
 	void plot(double x, double y);
 
@@ -0,0 +1,113 @@
+#include "PerfMonitor.hh"
+
+#include "Thread.hh"
+
+#include <cassert>
+#include <chrono>
+
+namespace openmsx::PerfMonitor {
+
+// 10 seconds at 60fps
+static constexpr size_t HISTORY_SIZE = 600;
+static constexpr size_t MAX_DEPTH = 16;
+
+namespace {
+	struct Open {
+		uint64_t start;
+		uint64_t childDuration;
+		Section section;
+	};
+
+	struct State {
+		State() { frames.set_capacity(HISTORY_SIZE); }
+
+		circular_buffer<Frame> frames;
+		Frame current = {};
+		std::array<Open, MAX_DEPTH> open;
+		size_t depth = 0;
+	};
+}
+
+static State& getState()
+{
+	static State state;
+	return state;
+}
+
+[[nodiscard]] static uint64_t now()
+{
+	return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+std::string_view getName(Section section)
+{
+	switch (section) {
+		case Section::EVENTS:         return "events";
+		case Section::CPU:            return "cpu";
+		case Section::SCHEDULER:      return "scheduler";
+		case Section::RASTERIZER:     return "rasterizer";
+		case Section::MIXER:          return "mixer";
+		case Section::POST_PROCESSOR: return "postprocessor";
+		case Section::PAINT:          return "paint";
+		case Section::SLEEP:          return "sleep";
+		default:                      return "?";
+	}
+}
+
+bool detail::begin(Section section)
+{
+	assert(Thread::isMainThread());
+	auto& state = getState();
+	if (state.depth == MAX_DEPTH) [[unlikely]] return false; // shouldn't happen
+	state.open[state.depth++] = Open{now(), 0, section};
+	return true;
+}
+
+void detail::end()
+{
+	auto& state = getState();
+	assert(state.depth > 0);
+	const auto& o = state.open[--state.depth];
+	auto duration = now() - o.start;
+	state.current.sections[size_t(o.section)] += uint32_t(duration - o.childDuration);
+	if (state.depth > 0) {
+		state.open[state.depth - 1].childDuration += duration;
+	}
+}
+
+void setEnabled(bool enable)
+{
+	if (enable == detail::enabled) return;
+	detail::enabled = enable;
+	if (enable) {
+		clearFrames();
+	}
+}
+
+void endFrame()
+{
+	if (!detail::enabled) return;
+	auto& state = getState();
+	auto t = now();
+	if (state.current.start != 0) {
+		state.current.duration = t - state.current.start;
+		if (state.frames.full()) state.frames.pop_front();
+		state.frames.push_back(state.current);
+	}
+	state.current = Frame{.start = t, .duration = 0, .sections = {}};
+}
+
+const circular_buffer<Frame>& getFrames()
+{
+	return getState().frames;
+}
+
+void clearFrames()
+{
+	auto& state = getState();
+	state.frames.clear();
+	state.current = {}; // the next endFrame() starts a new frame
+}
+
+} // namespace openmsx::PerfMonitor
@@ -0,0 +1,99 @@
+#ifndef PERFMONITOR_HH
+#define PERFMONITOR_HH
+
+#include "circular_buffer.hh"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace openmsx {
+
+/** Per-frame timing of the main subsystems (emulation, rendering, sound,
+  * event handling, ...).
+  *
+  * A subsystem marks the time it's busy with (the lifetime of) a Scope
+  * object. Scopes can be nested, e.g. the rasterizer runs from a VDP sync
+  * point, which runs from the Scheduler, which runs from the CPU emulation.
+  * Each section is charged its 'self' time: the time not spent in nested
+  * scopes. When a frame is painted (see Display), the times of the sections
+  * are stored as one entry in a history of the last frames (a scope that is
+  * still open at that point is charged to the next frame). Whatever isn't
+  * covered by any of the sections (Tcl scripts, ...) is the remainder of the
+  * frame duration.
+  *
+  * Monitoring is off by default, then a Scope costs a single (well
+  * predicted) test. Enable it with the 'perf' Tcl command or in the GUI.
+  *
+  * Only use this from the main thread.
+  */
+namespace PerfMonitor {
+
+	enum class Section : uint8_t {
+		EVENTS,         // EventDistributor: delivering events
+		CPU,            // Z80/R800 emulation
+		SCHEDULER,      // executing sync points (the emulated devices)
+		RASTERIZER,     // PixelRenderer: drawing VDP lines
+		MIXER,          // MSXMixer: generating and mixing sound
+		POST_PROCESSOR, // PostProcessor::paint()
+		PAINT,          // other painting: OSD, GUI, buffer swap (vsync)
+		SLEEP,          // RealTime: throttling to the emulation speed
+		NUM
+	};
+	[[nodiscard]] std::string_view getName(Section section);
+
+	struct Frame {
+		uint64_t start;    // in ns, steady_clock
+		uint64_t duration; // in ns
+		std::array<uint32_t, size_t(Section::NUM)> sections; // self time, in ns
+	};
+	/** The part of the frame not covered by any of the sections. */
+	[[nodiscard]] inline uint64_t getOther(const Frame& frame) {
+		uint64_t sum = 0;
+		for (auto t : frame.sections) sum += t;
+		return (frame.duration > sum) ? (frame.duration - sum) : 0;
+	}
+
+	namespace detail {
+		inline bool enabled = false;
+		[[nodiscard]] bool begin(Section section);
+		void end();
+	}
+
+	class Scope
+	{
+	public:
+		explicit Scope(Section section) {
+			if (detail::enabled) [[unlikely]] {
+				active = detail::begin(section);
+			}
+		}
+		~Scope() {
+			if (active) [[unlikely]] detail::end();
+		}
+
+		Scope(const Scope&) = delete;
+		Scope(Scope&&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		Scope& operator=(Scope&&) = delete;
+
+	private:
+		bool active = false;
+	};
+
+	[[nodiscard]] inline bool isEnabled() { return detail::enabled; }
+	/** Enabling clears the history. */
+	void setEnabled(bool enable);
+
+	/** Called when a frame was painted. */
+	void endFrame();
+
+	/** The most recent frames, oldest first. */
+	[[nodiscard]] const circular_buffer<Frame>& getFrames();
+	void clearFrames();
+
+} // namespace PerfMonitor
+
+} // namespace openmsx
+
+#endif
@@ -0,0 +1,252 @@
+#include "PerfTrace.hh"
+
+#include "FileOperations.hh"
+#include "MSXException.hh"
+#include "Thread.hh"
+
+#include "one_of.hh"
+#include "strCat.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+namespace openmsx::PerfTrace {
+
+// Per thread: 64k spans (2.5MB), a few seconds of a busy emulation.
+static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+namespace {
+	struct Entry {
+		const char* category;
+		const char* name;
+		uint64_t start; // ns
+		uint64_t end;   // ns
+		uint64_t emuTime; // EmuTime::infinity() when unknown
+	};
+
+	// Only the owning thread writes to 'entries' and 'count'. Other
+	// threads only read the entries below 'count'. A new recording is
+	// signaled via 'generation', the owner then resets its buffer.
+	struct ThreadBuffer {
+		std::unique_ptr<Entry[]> entries; // allocated on first use
+		std::atomic<size_t> count = 0;
+		std::atomic<size_t> dropped = 0;
+		std::atomic<unsigned> generation = 0;
+		unsigned id = 0;
+		std::string threadName; // protected by State::mutex
+	};
+
+	struct State {
+		std::mutex mutex; // only protects 'buffers' and the thread names
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers; // never shrinks
+		std::atomic<unsigned> generation = 1;
+		uint64_t prevFrame = 0; // main thread only
+	};
+}
+
+static State& getState()
+{
+	static State state;
+	return state;
+}
+
+static ThreadBuffer& getThreadBuffer()
+{
+	// Buffers outlive their thread, so that spans of e.g. a closed
+	// CliConnection still show up in the trace.
+	thread_local ThreadBuffer* buffer = nullptr;
+	if (!buffer) [[unlikely]] {
+		auto& state = getState();
+		std::scoped_lock lock(state.mutex);
+		auto& b = state.buffers.emplace_back(std::make_unique<ThreadBuffer>());
+		b->id = unsigned(state.buffers.size());
+		if (Thread::isMainThread()) b->threadName = "main";
+		buffer = b.get();
+	}
+	return *buffer;
+}
+
+uint64_t detail::now()
+{
+	return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void detail::record(const char* category, const char* name,
+                    uint64_t start, uint64_t end, EmuTime emuTime)
+{
+	auto& buffer = getThreadBuffer();
+	auto gen = getState().generation.load(std::memory_order_acquire);
+	if (buffer.generation.load(std::memory_order_relaxed) != gen) [[unlikely]] {
+		if (!buffer.entries) buffer.entries = std::make_unique_for_overwrite<Entry[]>(BUFFER_SIZE);
+		buffer.count.store(0, std::memory_order_relaxed);
+		buffer.dropped.store(0, std::memory_order_relaxed);
+		buffer.generation.store(gen, std::memory_order_release);
+	}
+	auto n = buffer.count.load(std::memory_order_relaxed);
+	if (n == BUFFER_SIZE) [[unlikely]] {
+		buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	buffer.entries[n] = Entry{category, name, start, end, emuTime.toUint64()};
+	buffer.count.store(n + 1, std::memory_order_release);
+}
+
+void frame()
+{
+	assert(Thread::isMainThread());
+	auto& state = getState();
+	auto t = detail::now();
+	if (isEnabled() && state.prevFrame) {
+		detail::record("display", "frame", state.prevFrame, t, EmuTime::infinity());
+	}
+	state.prevFrame = t;
+}
+
+void setThreadName(std::string name)
+{
+	auto& buffer = getThreadBuffer();
+	std::scoped_lock lock(getState().mutex);
+	buffer.threadName = std::move(name);
+}
+
+void start()
+{
+	auto& state = getState();
+	state.generation.fetch_add(1, std::memory_order_acq_rel);
+	state.prevFrame = 0;
+	detail::enabled = true;
+}
+
+void stop()
+{
+	detail::enabled = false;
+}
+
+// Calls 'op' for each buffer of the current recording, with the (stable)
+// range of recorded entries.
+template<typename Op>
+static void forEachBuffer(Op op)
+{
+	auto& state = getState();
+	auto gen = state.generation.load(std::memory_order_acquire);
+	std::scoped_lock lock(state.mutex);
+	for (const auto& buffer : state.buffers) {
+		if (buffer->generation.load(std::memory_order_acquire) != gen) continue;
+		auto n = buffer->count.load(std::memory_order_acquire);
+		op(*buffer, std::span<const Entry>(buffer->entries.get(), n));
+	}
+}
+
+std::pair<size_t, size_t> getStats()
+{
+	size_t recorded = 0;
+	size_t dropped = 0;
+	forEachBuffer([&](const ThreadBuffer& buffer, std::span<const Entry> entries) {
+		recorded += entries.size();
+		dropped += buffer.dropped.load(std::memory_order_relaxed);
+	});
+	return {recorded, dropped};
+}
+
+std::string demangle(const char* name)
+{
+	std::string result;
+#if defined(__GNUC__) || defined(__clang__)
+	int status = 0;
+	if (char* d = abi::__cxa_demangle(name, nullptr, nullptr, &status)) {
+		result = d;
+		std::free(d);
+	} else {
+		result = name;
+	}
+#else
+	result = name;
+	if (result.starts_with("class ")) result.erase(0, 6);
+#endif
+	if (result.starts_with("openmsx::")) result.erase(0, 9);
+	return result;
+}
+
+static void writeJsonString(std::ostream& os, std::string_view s)
+{
+	os << '"';
+	for (char c : s) {
+		if (c == one_of('"', '\\')) os << '\\';
+		if (uint8_t(c) >= 0x20) os << c;
+	}
+	os << '"';
+}
+
+void save(const std::string& filename)
+{
+	std::ofstream os;
+	FileOperations::openOfStream(os, filename);
+	if (!os) {
+		throw MSXException("Couldn't open ", filename, " for writing.");
+	}
+
+	// Span names are literals, except for the (mangled) type names of the
+	// Schedulables (see Scheduler).
+	std::vector<std::pair<const char*, std::string>> demangled; // cache
+	auto getName = [&](const char* category, const char* name) -> std::string_view {
+		if (std::string_view(category) != "sync") return name;
+		for (const auto& [n, d] : demangled) {
+			if (n == name) return d;
+		}
+		return demangled.emplace_back(name, demangle(name)).second;
+	};
+
+	// Chrome trace format: times in microseconds, complete ("X") events.
+	os << std::fixed << std::setprecision(3);
+	os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	bool first = true;
+	auto separator = [&] {
+		if (!first) os << ",\n";
+		first = false;
+	};
+	uint64_t t0 = uint64_t(-1);
+	forEachBuffer([&](const ThreadBuffer&, std::span<const Entry> entries) {
+		for (const auto& e : entries) t0 = std::min(t0, e.start);
+	});
+	forEachBuffer([&](const ThreadBuffer& buffer, std::span<const Entry> entries) {
+		separator();
+		os << R"({"ph":"M","name":"thread_name","pid":1,"tid":)" << buffer.id
+		   << R"(,"args":{"name":)";
+		writeJsonString(os, buffer.threadName.empty()
+			? strCat("thread ", buffer.id) : buffer.threadName);
+		os << "}}";
+		for (const auto& e : entries) {
+			separator();
+			os << R"({"ph":"X","pid":1,"tid":)" << buffer.id << R"(,"cat":)";
+			writeJsonString(os, e.category);
+			os << R"(,"name":)";
+			writeJsonString(os, getName(e.category, e.name));
+			os << R"(,"ts":)" << double(e.start - t0) * 1e-3
+			   << R"(,"dur":)" << double(e.end - e.start) * 1e-3;
+			if (e.emuTime != EmuTime::infinity().toUint64()) {
+				os << R"(,"args":{"emutime":)" << std::setprecision(9) << EmuTime::fromUint64(e.emuTime).toDouble()
+				   << std::setprecision(3) << '}';
+			}
+			os << '}';
+		}
+	});
+	os << "\n]}\n";
+	if (!os) {
+		throw MSXException("Error while writing ", filename, '.');
+	}
+}
+
+} // namespace openmsx::PerfTrace
@@ -0,0 +1,104 @@
+#ifndef PERFTRACE_HH
+#define PERFTRACE_HH
+
+#include "EmuTime.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace openmsx {
+
+/** Record spans (named time intervals) of emulator-internal activity, for
+  * in-depth performance investigations. The spans can be exported in the
+  * Chrome JSON trace format, which can be viewed in chrome://tracing or in
+  * the Perfetto UI (https://ui.perfetto.dev).
+  *
+  * In contrast to PerfMonitor (which only keeps per-frame totals), this
+  * records each individual span: each CPU slice, each executed sync point
+  * (per Schedulable type), each sound fragment, texture upload, etc. Spans
+  * have a host timestamp and optionally an EmuTime.
+  *
+  * Spans can be recorded from any thread. Each thread appends to its own
+  * buffer, so recording doesn't take any locks (only the first span of a
+  * thread registers its buffer). When a buffer is full, further spans of
+  * that thread are dropped.
+  *
+  * Tracing is off by default, then a Span costs a single test.
+  */
+namespace PerfTrace {
+
+	namespace detail {
+		inline std::atomic<bool> enabled = false;
+		[[nodiscard]] uint64_t now();
+		void record(const char* category, const char* name,
+		            uint64_t start, uint64_t end, EmuTime emuTime);
+	}
+
+	/** Records the lifetime of this object as a span. 'category' and
+	  * 'name' must point to strings with static lifetime (e.g. literals).
+	  */
+	class Span
+	{
+	public:
+		Span(const char* category_, const char* name_, EmuTime emuTime_ = EmuTime::infinity())
+		{
+			if (detail::enabled.load(std::memory_order_relaxed)) [[unlikely]] {
+				category = category_;
+				name = name_;
+				emuTime = emuTime_;
+				start = detail::now();
+			}
+		}
+		~Span() {
+			if (category) [[unlikely]] {
+				detail::record(category, name, start, detail::now(), emuTime);
+			}
+		}
+
+		Span(const Span&) = delete;
+		Span(Span&&) = delete;
+		Span& operator=(const Span&) = delete;
+		Span& operator=(Span&&) = delete;
+
+	private:
+		const char* category = nullptr;
+		const char* name = nullptr;
+		uint64_t start = 0;
+		EmuTime emuTime = EmuTime::zero();
+	};
+
+	/** Mark the end of a frame: records a span since the previous call.
+	  * Only call this from the main thread.
+	  */
+	void frame();
+
+	/** Name of the calling thread, as shown in the trace. */
+	void setThreadName(std::string name);
+
+	[[nodiscard]] inline bool isEnabled() {
+		return detail::enabled.load(std::memory_order_relaxed);
+	}
+	/** Starting discards the spans of a previous recording. */
+	void start();
+	void stop();
+
+	/** Number of recorded and dropped spans (of the current recording). */
+	[[nodiscard]] std::pair<size_t, size_t> getStats();
+
+	/** Write the current recording in Chrome JSON trace format.
+	  * @throws MSXException when the file can't be written.
+	  */
+	void save(const std::string& filename);
+
+	/** Readable form of a typeid(..).name(), without the 'openmsx::'
+	  * prefix. Used for the Schedulable names.
+	  */
+	[[nodiscard]] std::string demangle(const char* name);
+
+} // namespace PerfTrace
+
+} // namespace openmsx
+
+#endif
@@ -1,11 +1,13 @@
 #include "Plotter.hh"
 
 #include "FileOperations.hh"
+#include "GlobalSettings.hh"
 #include "IntegerSetting.hh"
 #include "MSXCliComm.hh"
 #include "MSXMotherBoard.hh"
 #include "PNG.hh"
 #include "PlotterFont.hh"
+#include "Reactor.hh"
 
 #include "ScopedAssign.hh"
 #include "gl_mat.hh"
@@ -35,6 +37,7 @@ static void printDebug(Args&&... args)
 
 MSXPlotter::MSXPlotter(MSXMotherBoard& motherBoard)
 	: cliComm(motherBoard.getMSXCliComm())
+	, pngCompressionSetting(motherBoard.getReactor().getGlobalSettings().getPngCompressionSetting())
 	, dpiSetting(motherBoard.getSharedStuff<IntegerSetting>(
 		"print-resolution",
 		motherBoard.getCommandController(), "print-resolution",
@@ -69,6 +72,8 @@ MSXPlotter::MSXPlotter(MSXMotherBoard& motherBoard)
 MSXPlotter::~MSXPlotter()
 {
 	flushEmulatedPrinter();
+	worker.flush();
+	worker.reportResults(cliComm);
 }
 
 zstring_view MSXPlotter::getName() const
@@ -129,6 +134,8 @@ void MSXPlotter::ejectPaper()
 
 void MSXPlotter::write(uint8_t data)
 {
+	worker.reportResults(cliComm);
+
 	printDebug("Plotter: received 0x", hex_string<2>(data),
 	           " mode=", (mode == Mode::TEXT ? "TEXT" : "GRAPHIC"),
 	           " escState=", int(escState));
@@ -725,22 +732,20 @@ void MSXPlotter::flushEmulatedPrinter()
 	if (!paper) return;
 
 	if (!paper->empty()) {
-		try {
+		// PNG encoding is slow, do it in the background
+		worker.queue([rgb = std::make_shared<Canvas<RgbPixel>>(paper->getRGB()),
+		              level = pngCompressionSetting.getInt()] {
 			static constexpr std::string_view PRINT_DIR = "prints";
 			static constexpr std::string_view PRINT_EXTENSION = ".png";
 			auto filename = FileOperations::getNextNumberedFileName(PRINT_DIR, "page", PRINT_EXTENSION);
 
-			auto rgb = paper->getRGB();
-			auto size = rgb.size();
+			auto size = rgb->size();
 			small_buffer<const uint8_t*, 4096> rowPointers(std::views::transform(xrange(size.y),
-				[&](int y) { return &rgb.getLine(y).data()->x; }));
+				[&](int y) { return &rgb->getLine(y).data()->x; }));
 
-			PNG::saveRGB(size.x, rowPointers, filename);
-
-			cliComm.printInfo("Printed to ", filename);
-		} catch (MSXException& e) {
-			cliComm.printWarning("Failed to print: ", e.getMessage());
-		}
+			PNG::saveRGB(size.x, rowPointers, filename, level);
+			return filename;
+		});
 	}
 	paper.reset();
 }
@@ -2,6 +2,7 @@
 #define PLOTTER_HH
 
 #include "PlotterPaper.hh"
+#include "PrintWorker.hh"
 #include "PrinterCore.hh"
 
 #include "BooleanSetting.hh"
@@ -99,6 +100,7 @@ private:
 
 private:
 	CliComm& cliComm;
+	IntegerSetting& pngCompressionSetting;
 	std::shared_ptr<IntegerSetting> dpiSetting;
 	std::unique_ptr<PlotterPaper> paper;
 
@@ -120,6 +122,10 @@ private:
 	TerminatorSkip terminatorSkip = TerminatorSkip::NONE;
 	bool printNext = false; // For 0x01 literal prefix
 
+	// Saves the ejected pages in the background. The paper itself stays on
+	// this thread (it's also shown by the viewer, and owns a texture).
+	PrintWorker worker;
+
 	// Pen/color state
 	uint8_t selectedPen = 0; // 0=black, 1=blue, 2=green, 3=red
 	bool penDown = false;
@@ -0,0 +1,84 @@
+#include "PrintWorker.hh"
+
+#include "CliComm.hh"
+#include "MSXException.hh"
+
+#include <utility>
+
+namespace openmsx {
+
+PrintWorker::~PrintWorker()
+{
+	if (!thread.joinable()) return;
+	{
+		std::scoped_lock lock(mutex);
+		stop = true;
+	}
+	cond.notify_one();
+	thread.join(); // only returns after the queue is drained
+}
+
+void PrintWorker::queue(Job job)
+{
+	{
+		std::scoped_lock lock(mutex);
+		jobs.push_back(std::move(job));
+	}
+	if (!thread.joinable()) {
+		thread = std::thread([this]() { workerLoop(); });
+	}
+	cond.notify_one();
+}
+
+void PrintWorker::flush()
+{
+	std::unique_lock lock(mutex);
+	emptyCond.wait(lock, [&] { return jobs.empty(); });
+}
+
+void PrintWorker::reportResults(CliComm& cliComm)
+{
+	if (!haveResults) return;
+	std::vector<Result> todo;
+	{
+		std::scoped_lock lock(mutex);
+		todo = std::exchange(results, {});
+		haveResults = false;
+	}
+	for (const auto& r : todo) {
+		if (!r.filename.empty()) {
+			cliComm.printInfo("Printed to ", r.filename);
+		} else {
+			cliComm.printWarning("Failed to print: ", r.error);
+		}
+	}
+}
+
+void PrintWorker::workerLoop()
+{
+	std::unique_lock lock(mutex);
+	while (true) {
+		cond.wait(lock, [&] { return stop || !jobs.empty(); });
+		if (jobs.empty()) return; // stopped and queue is drained
+
+		// Only this thread removes elements, so this reference stays
+		// valid, also when other jobs are added in the meantime.
+		auto& job = jobs.front();
+		lock.unlock();
+		Result result;
+		try {
+			result.filename = job();
+		} catch (MSXException& e) {
+			result.error = e.getMessage();
+		}
+		lock.lock();
+		if (!result.filename.empty() || !result.error.empty()) {
+			results.push_back(std::move(result));
+			haveResults = true;
+		}
+		jobs.pop_front();
+		if (jobs.empty()) emptyCond.notify_all();
+	}
+}
+
+} // namespace openmsx
@@ -0,0 +1,73 @@
+#ifndef PRINTWORKER_HH
+#define PRINTWORKER_HH
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openmsx {
+
+class CliComm;
+
+/** Executes the (expensive) rendering and saving of printed pages in a
+  * background thread, so that long print jobs don't make emulation stutter.
+  *
+  * Jobs are executed one at a time, in the order they were queued, so e.g.
+  * drawing on a page and then saving it can be queued as separate jobs. A
+  * job returns the name of the file it saved (or an empty string when it
+  * didn't save anything) and may throw MSXException. The emulation thread
+  * picks up these results with reportResults().
+  */
+class PrintWorker
+{
+public:
+	using Job = std::function<std::string()>;
+
+	PrintWorker() = default;
+	PrintWorker(const PrintWorker&) = delete;
+	PrintWorker(PrintWorker&&) = delete;
+	PrintWorker& operator=(const PrintWorker&) = delete;
+	PrintWorker& operator=(PrintWorker&&) = delete;
+
+	/** Waits till all queued jobs are executed. */
+	~PrintWorker();
+
+	void queue(Job job);
+
+	/** Wait till all queued jobs are executed. */
+	void flush();
+
+	/** Print the results of the jobs that finished since the previous call
+	  * ("Printed to <file>" or a warning). Cheap when there's nothing to
+	  * report, so it can be called often. */
+	void reportResults(CliComm& cliComm);
+
+private:
+	struct Result {
+		std::string filename;
+		std::string error; // only if 'filename' is empty
+	};
+	void workerLoop();
+
+private:
+	std::mutex mutex;
+	std::condition_variable cond;      // signals new work (or stop)
+	std::condition_variable emptyCond; // signals the queue became empty
+	// The following are protected by 'mutex'.
+	std::deque<Job> jobs;
+	std::vector<Result> results;
+	bool stop = false;
+
+	std::atomic<bool> haveResults = false;
+
+	std::thread thread; // started on the first queued job
+};
+
+} // namespace openmsx
+
+#endif
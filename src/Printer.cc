@@ -3,10 +3,11 @@
 #include "Paper.hh"
 #include "MSXCharacterSets.hh"
 
+#include "GlobalSettings.hh"
 #include "IntegerSetting.hh"
 #include "MSXCliComm.hh"
-#include "MSXException.hh"
 #include "MSXMotherBoard.hh"
+#include "Reactor.hh"
 #include "serialize.hh"
 
 #include "Math.hh"
@@ -67,10 +68,14 @@ ImagePrinter::ImagePrinter(MSXMotherBoard& motherBoard_, bool graphicsHiLo_)
 ImagePrinter::~ImagePrinter()
 {
 	flushEmulatedPrinter();
+	worker.flush();
+	worker.reportResults(motherBoard.getMSXCliComm());
 }
 
 void ImagePrinter::write(uint8_t data)
 {
+	worker.reportResults(motherBoard.getMSXCliComm());
+
 	if (ramLoadOffset < ramLoadEnd) {
 		fontInfo.ram[ramLoadOffset++] = data;
 	} else if (sizeRemainingDataBytes) {
@@ -122,9 +127,22 @@ void ImagePrinter::plot9Dots(double x, double y, unsigned pattern)
 {
 	for (auto i : xrange(9)) {
 		if (pattern & (1 << i)) {
-			paper->plot(x, y + (8 - i) * pixelSizeY);
+			dots.emplace_back(x, y + (8 - i) * pixelSizeY);
 		}
 	}
+	if (dots.size() >= 4096) queueDots();
+}
+
+void ImagePrinter::queueDots()
+{
+	if (dots.empty()) return;
+	worker.queue([paper = paper, dots = std::move(dots)] {
+		for (const auto& d : dots) {
+			paper->plot(d.x, d.y);
+		}
+		return std::string{};
+	});
+	dots.clear(); // moved-from, make it valid again
 }
 
 void ImagePrinter::printGraphicByte(uint8_t data)
@@ -173,7 +191,7 @@ void ImagePrinter::ensurePrintPage()
 		pixelSizeX = double(paperSizeX) / dotsX;
 		pixelSizeY = double(paperSizeY) / dotsY;
 
-		paper = std::make_unique<Paper>(paperSizeX, paperSizeY,
+		paper = std::make_shared<Paper>(paperSizeX, paperSizeY,
 		                                pixelSizeX, pixelSizeY);
 	}
 }
@@ -182,17 +200,16 @@ void ImagePrinter::flushEmulatedPrinter()
 {
 	if (paper) {
 		if (printAreaBottom > printAreaTop) {
-			try {
-				auto filename = paper->save();
-				motherBoard.getMSXCliComm().printInfo(
-					"Printed to ", filename);
-			} catch (MSXException& e) {
-				motherBoard.getMSXCliComm().printWarning(
-					"Failed to print: ", e.getMessage());
-			}
+			// draw the remaining dots and save, both in the background
+			queueDots();
+			worker.queue([paper = std::move(paper),
+			              level = motherBoard.getReactor().getGlobalSettings().getPngCompressionSetting().getInt()] {
+				return paper->save(level);
+			});
 			printAreaTop = -1.0;
 			printAreaBottom = 0.0;
 		}
+		dots.clear();
 		paper.reset();
 	}
 	hpos = leftBorder;
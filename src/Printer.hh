@@ -10,11 +10,13 @@
 #ifndef PRINTER_HH
 #define PRINTER_HH
 
+#include "PrintWorker.hh"
 #include "PrinterCore.hh"
 
 #include <array>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace openmsx {
 
@@ -40,6 +42,7 @@ protected:
 	void flushEmulatedPrinter();
 	void printVisibleCharacter(uint8_t data);
 	void plot9Dots(double x, double y, unsigned pattern);
+	void queueDots();
 
 	[[nodiscard]] virtual std::pair<unsigned, unsigned> getNumberOfDots() = 0;
 	virtual void resetSettings() = 0;
@@ -119,11 +122,18 @@ protected:
 
 private:
 	MSXMotherBoard& motherBoard;
-	std::unique_ptr<Paper> paper;
+	// Only accessed from 'worker' jobs (apart from creating it).
+	std::shared_ptr<Paper> paper;
+	// Dots that still need to be drawn on 'paper', they're handed to
+	// 'worker' in batches.
+	struct Dot { double x, y; };
+	std::vector<Dot> dots;
 
 	std::shared_ptr<IntegerSetting> dpiSetting;
 
 	const bool graphicsHiLo;
+
+	PrintWorker worker; // must be last, jobs are executed till it's destroyed
 };
 
 // emulated MSX printer
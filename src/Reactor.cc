@@ -2,10 +2,13 @@
 
 #include "AfterCommand.hh"
 #include "AviRecorder.hh"
+#include "BinarySavestate.hh"
 #include "BooleanSetting.hh"
+#include "CPUCore.hh"
 #include "Command.hh"
 #include "CommandException.hh"
 #include "CommandLineParser.hh"
+#include "DeltaBlock.hh"
 #include "DiskChanger.hh"
 #include "DiskFactory.hh"
 #include "DiskManipulator.hh"
@@ -16,6 +19,7 @@
 #include "FileContext.hh"
 #include "FileException.hh"
 #include "FilePool.hh"
+#include "FrameHashLogger.hh"
 #include "GlobalCliComm.hh"
 #include "GlobalCommandController.hh"
 #include "GlobalSettings.hh"
@@ -24,17 +28,24 @@
 #include "InfoTopic.hh"
 #include "InputEventGenerator.hh"
 #include "Keyboard.hh"
+#include "MSXCPU.hh"
 #include "MSXMotherBoard.hh"
 #include "MessageCommand.hh"
 #include "Mixer.hh"
 #include "MsxChar2Unicode.hh"
+#include "PerfMonitor.hh"
+#include "PerfTrace.hh"
 #include "RTScheduler.hh"
 #include "RomDatabase.hh"
 #include "RomInfo.hh"
+#include "Scheduler.hh"
+#include "StartupProfiler.hh"
 #include "StateChangeDistributor.hh"
 #include "SymbolManager.hh"
+#include "TclArgParser.hh"
 #include "TclCallbackMessages.hh"
 #include "TclObject.hh"
+#include "TclProfiler.hh"
 #include "UserSettings.hh"
 #include "VideoSystem.hh"
 #include "XMLElement.hh"
@@ -46,10 +57,13 @@
 #include "Thread.hh"
 #include "Timer.hh"
 
+#include "AllocationCounter.hh"
 #include "narrow.hh"
+#include "one_of.hh"
 #include "serialize.hh"
 #include "stl.hh"
 #include "unreachable.hh"
+#include "xrange.hh"
 
 #include "build-info.hh"
 
@@ -164,6 +178,43 @@ private:
 	Reactor& reactor;
 };
 
+class CloneMachineCommand final : public Command
+{
+public:
+	CloneMachineCommand(CommandController& commandController, Reactor& reactor);
+	void execute(std::span<const TclObject> tokens, TclObject& result) override;
+	[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
+	void tabCompletion(std::vector<std::string>& tokens) const override;
+private:
+	Reactor& reactor;
+};
+
+class PerfCommand final : public Command
+{
+public:
+	PerfCommand(CommandController& commandController, Reactor& reactor);
+	void execute(std::span<const TclObject> tokens, TclObject& result) override;
+	[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
+	void tabCompletion(std::vector<std::string>& tokens) const override;
+
+private:
+	void executeTrace(std::span<const TclObject> tokens, TclObject& result);
+	void executeSync(std::span<const TclObject> tokens, TclObject& result);
+	void executeSched(std::span<const TclObject> tokens, TclObject& result);
+
+private:
+	Reactor& reactor;
+};
+
+class TclProfileCommand final : public Command
+{
+public:
+	explicit TclProfileCommand(CommandController& commandController);
+	void execute(std::span<const TclObject> tokens, TclObject& result) override;
+	[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
+	void tabCompletion(std::vector<std::string>& tokens) const override;
+};
+
 class SetupCommand final : public Command
 {
 public:
@@ -218,6 +269,26 @@ private:
 	const uint64_t reference;
 };
 
+class EventLatencyInfo final : public InfoTopic
+{
+public:
+	EventLatencyInfo(InfoCommand& openMSXInfoCommand, const EventDistributor& distributor);
+	void execute(std::span<const TclObject> tokens,
+	             TclObject& result) const override;
+	[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
+private:
+	const EventDistributor& distributor;
+};
+
+class AllocationInfo final : public InfoTopic
+{
+public:
+	explicit AllocationInfo(InfoCommand& openMSXInfoCommand);
+	void execute(std::span<const TclObject> tokens,
+	             TclObject& result) const override;
+	[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
+};
+
 class SoftwareInfoTopic final : public InfoTopic
 {
 public:
@@ -234,25 +305,36 @@ Reactor::Reactor() = default;
 
 void Reactor::init()
 {
+	StartupProfiler::Scope profile("Reactor::init");
+
 	shortcuts = std::make_unique<Shortcuts>();
 	rtScheduler = std::make_unique<RTScheduler>();
 	eventDistributor = std::make_unique<EventDistributor>(*this);
 	globalCliComm = std::make_unique<GlobalCliComm>();
-	globalCommandController = std::make_unique<GlobalCommandController>(
-		*eventDistributor, *globalCliComm, *this);
+	{
+		StartupProfiler::Scope profileCommands("GlobalCommandController (Tcl interpreter)");
+		globalCommandController = std::make_unique<GlobalCommandController>(
+			*eventDistributor, *globalCliComm, *this);
+	}
 	globalSettings = std::make_unique<GlobalSettings>(
 		*globalCommandController);
 	inputEventGenerator = std::make_unique<InputEventGenerator>(
 		*globalCommandController, *eventDistributor);
 	symbolManager = std::make_unique<SymbolManager>(
 		*globalCommandController);
-	imGuiManager = std::make_unique<ImGuiManager>(*this);
+	{
+		StartupProfiler::Scope profileImGui("ImGuiManager");
+		imGuiManager = std::make_unique<ImGuiManager>(*this);
+	}
 	diskFactory = std::make_unique<DiskFactory>(*this);
 	diskManipulator = std::make_unique<DiskManipulator>(
 		*globalCommandController, *this);
 	virtualDrive = std::make_unique<DiskChanger>(
 		*this, "virtual_drive");
-	filePool = std::make_unique<FilePool>(*globalCommandController, *this);
+	{
+		StartupProfiler::Scope profileFilePool("FilePool");
+		filePool = std::make_unique<FilePool>(*globalCommandController, *this);
+	}
 	userSettings = std::make_unique<UserSettings>(
 		*globalCommandController);
 	afterCommand = std::make_unique<AfterCommand>(
@@ -277,6 +359,12 @@ void Reactor::init()
 		*globalCommandController, *this);
 	restoreMachineCommand = std::make_unique<RestoreMachineCommand>(
 		*globalCommandController, *this);
+	cloneMachineCommand = std::make_unique<CloneMachineCommand>(
+		*globalCommandController, *this);
+	perfCommand = std::make_unique<PerfCommand>(
+		*globalCommandController, *this);
+	tclProfileCommand = std::make_unique<TclProfileCommand>(
+		*globalCommandController);
 	setupCommand = std::make_unique<SetupCommand>(
 		*globalCommandController, *this);
 	getClipboardCommand = std::make_unique<GetClipboardCommand>(
@@ -284,18 +372,26 @@ void Reactor::init()
 	setClipboardCommand = std::make_unique<SetClipboardCommand>(
 		*globalCommandController, *this);
 	aviRecordCommand = std::make_unique<AviRecorder>(*this);
+	frameHashLogger = std::make_unique<FrameHashLogger>(*this);
 	extensionInfo = std::make_unique<ConfigInfo>(
 		getOpenMSXInfoCommand(), "extensions");
 	machineInfo   = std::make_unique<ConfigInfo>(
 		getOpenMSXInfoCommand(), "machines");
 	realTimeInfo = std::make_unique<RealTimeInfo>(
 		getOpenMSXInfoCommand());
+	eventLatencyInfo = std::make_unique<EventLatencyInfo>(
+		getOpenMSXInfoCommand(), *eventDistributor);
+	allocationInfo = std::make_unique<AllocationInfo>(
+		getOpenMSXInfoCommand());
 	softwareInfoTopic = std::make_unique<SoftwareInfoTopic>(
 		getOpenMSXInfoCommand(), *this);
 	tclCallbackMessages = std::make_unique<TclCallbackMessages>(
 		*globalCliComm, *globalCommandController);
 
-	createDefaultMachineAndSetupSettings();
+	{
+		StartupProfiler::Scope profileMachineSetting("machine and setup settings");
+		createDefaultMachineAndSetupSettings();
+	}
 
 	saveSetupAtExitNameSetting = std::make_unique<StringSetting>(
 		*globalCommandController, "save_setup_at_exit_name",
@@ -346,6 +442,7 @@ Mixer& Reactor::getMixer()
 RomDatabase& Reactor::getSoftwareDatabase()
 {
 	if (!softwareDatabase) {
+		StartupProfiler::Scope profile("software database");
 		softwareDatabase = std::make_unique<RomDatabase>(*globalCliComm);
 	}
 	return *softwareDatabase;
@@ -628,8 +725,11 @@ void Reactor::runStartupScripts(const CommandLineParser& parser)
 {
 	auto& commandController = *globalCommandController;
 
+	StartupProfiler::Scope profile("startup scripts");
+
 	// execute init.tcl
 	try {
+		StartupProfiler::Scope profileInit("init.tcl");
 		commandController.source(
 			preferSystemFileContext().resolve("init.tcl"));
 	} catch (FileException& e) {
@@ -681,7 +781,7 @@ void Reactor::powerOn()
 
 void Reactor::run()
 {
-	bool blocked = (blockedCounter > 0) || !activeBoard;
+	bool blocked = isBlocked();
 	while (running) {
 		// Compute timeout: sleep if blocked, but not past next RT-event.
 		// This keeps UI responsive while avoiding busy-waiting when paused.
@@ -694,7 +794,7 @@ void Reactor::run()
 			return std::clamp(narrow<int>(deltaUs / 1000), 0, MAX_WAIT_MS);
 		}();
 		eventDistributor->deliverEvents(timeoutMs);
-		blocked = (blockedCounter > 0) || !activeBoard;  // re-evaluate
+		blocked = isBlocked(); // re-evaluate
 		if (!blocked) {
 			// copy shared_ptr to keep Board alive (e.g. in case of
 			// Tcl callbacks)
@@ -1034,15 +1134,27 @@ StoreMachineCommand::StoreMachineCommand(
 
 void StoreMachineCommand::execute(std::span<const TclObject> tokens, TclObject& result)
 {
-	checkNumArgs(tokens, 3, Prefix{1}, "id filename");
-	const auto& machineID = tokens[1].getString();
-	const auto& filename = tokens[2].getString();
+	bool binary = false;
+	std::array info = {flagArg("-binary", binary)};
+	auto args = parseTclArgs(getInterpreter(), tokens.subspan(1), info);
+	if (args.size() != 2) throw SyntaxError();
+	const auto& machineID = args[0].getString();
+	const auto& filename = args[1].getString();
 
 	const auto& board = *reactor.getMachine(machineID);
 
-	XmlOutputArchive out(filename);
-	out.serialize("machine", board);
-	out.close();
+	PerfTrace::Span trace("savestate", "save");
+	if (binary) {
+		try {
+			BinarySavestate::save(filename, board);
+		} catch (MSXException& e) {
+			throw CommandException(e.getMessage());
+		}
+	} else {
+		XmlOutputArchive out(filename);
+		out.serialize("machine", board);
+		out.close();
+	}
 	result = filename;
 }
 
@@ -1050,6 +1162,10 @@ std::string StoreMachineCommand::help(std::span<const TclObject> /*tokens*/) con
 {
 	return
 		"store_machine machineID <filename>  Save state of machine \"machineID\" to indicated file\n"
+		"store_machine -binary machineID <filename>\n"
+		"                                     Same, but in a binary format that's much faster to\n"
+		"                                     save and load, but that can only be loaded by the\n"
+		"                                     same openMSX version (on the same platform)\n"
 		"\n"
 		"This is a low-level command, the 'savestate' script is easier to use.";
 }
@@ -1077,9 +1193,14 @@ void RestoreMachineCommand::execute(std::span<const TclObject> tokens,
 
 	const auto filename = FileOperations::expandTilde(std::string(tokens[1].getString()));
 
+	PerfTrace::Span trace("savestate", "load");
 	try {
-		XmlInputArchive in(filename);
-		in.serialize("machine", *newBoard);
+		if (BinarySavestate::isBinarySavestate(filename)) {
+			BinarySavestate::load(filename, *newBoard);
+		} else {
+			XmlInputArchive in(filename);
+			in.serialize("machine", *newBoard);
+		}
 	} catch (XMLException& e) {
 		throw CommandException("Cannot load state, bad file format: ",
 		                       e.getMessage());
@@ -1110,6 +1231,358 @@ void RestoreMachineCommand::tabCompletion(std::vector<std::string>& tokens) cons
 }
 
 
+// class CloneMachineCommand
+
+CloneMachineCommand::CloneMachineCommand(
+	CommandController& commandController_, Reactor& reactor_)
+	: Command(commandController_, "clone_machine")
+	, reactor(reactor_)
+{
+}
+
+void CloneMachineCommand::execute(std::span<const TclObject> tokens,
+                                  TclObject& result)
+{
+	checkNumArgs(tokens, 2, "id");
+	const auto& board = *reactor.getMachine(tokens[1].getString());
+	auto newBoard = reactor.createEmptyMotherBoard();
+
+	// Same mechanism as used for reverse snapshots: everything is kept in
+	// memory and (large) memory blocks are copied directly, so there's no
+	// file I/O or XML (de)serialization involved. ROM images are not part
+	// of the state, the new machine loads them via the FilePool.
+	try {
+		LastDeltaBlocks lastDeltaBlocks;
+		std::vector<std::shared_ptr<DeltaBlock>> deltaBlocks;
+		MemOutputArchive out(lastDeltaBlocks, deltaBlocks, false);
+		out.serialize("machine", board);
+		auto buffer = std::move(out).releaseBuffer();
+
+		MemInputArchive in(buffer, deltaBlocks);
+		in.serialize("machine", *newBoard);
+	} catch (MSXException& e) {
+		throw CommandException("Cannot clone machine: ", e.getMessage());
+	}
+
+	// Like for restore_machine: don't continue replaying the events of
+	// the original machine.
+	newBoard->getStateChangeDistributor().stopReplay(newBoard->getCurrentTime());
+
+	result = newBoard->getMachineID();
+	reactor.boards.push_back(std::move(newBoard));
+}
+
+std::string CloneMachineCommand::help(std::span<const TclObject> /*tokens*/) const
+{
+	return "clone_machine <machineID>             Create a new machine with the same state as the given machine\n"
+	       "\n"
+	       "The new machine is not activated, use activate_machine for that.";
+}
+
+void CloneMachineCommand::tabCompletion(std::vector<std::string>& tokens) const
+{
+	completeString(tokens, reactor.getMachineIDs());
+}
+
+
+// class PerfCommand
+
+PerfCommand::PerfCommand(CommandController& commandController_,
+                         Reactor& reactor_)
+	: Command(commandController_, "perf")
+	, reactor(reactor_)
+{
+}
+
+[[nodiscard]] static double nsToMs(uint64_t ns)
+{
+	return narrow_cast<double>(ns) * (1.0 / 1000000.0);
+}
+
+void PerfCommand::execute(std::span<const TclObject> tokens, TclObject& result)
+{
+	checkNumArgs(tokens, Between{1, 4}, "?on|off|clear|stats|frames ?count?|trace ?start|stop|save filename?|sync ?reset?|sched ?reset??");
+	using namespace PerfMonitor;
+	if (tokens.size() == 1) {
+		result = isEnabled();
+		return;
+	}
+	const auto& frames = getFrames();
+	auto subCmd = tokens[1].getString();
+	if (subCmd == "trace") {
+		executeTrace(tokens, result);
+		return;
+	}
+	if (subCmd == "sync") {
+		executeSync(tokens, result);
+		return;
+	}
+	if (subCmd == "sched") {
+		executeSched(tokens, result);
+		return;
+	}
+	if (tokens.size() == 4) throw SyntaxError();
+	if (subCmd == one_of("on", "off", "clear", "stats") && (tokens.size() != 2)) {
+		throw SyntaxError();
+	}
+	if (subCmd == "on") {
+		setEnabled(true);
+	} else if (subCmd == "off") {
+		setEnabled(false);
+	} else if (subCmd == "clear") {
+		clearFrames();
+	} else if (subCmd == "stats") {
+		// per section: average and maximum (self) time per frame
+		auto addStats = [&](std::string_view name, auto getTime) {
+			uint64_t total = 0, max = 0;
+			for (const auto& f : frames) {
+				auto t = uint64_t(getTime(f));
+				total += t;
+				max = std::max(max, t);
+			}
+			auto avg = frames.empty() ? 0.0 : nsToMs(total) / double(frames.size());
+			result.addDictKeyValue(name, makeTclDict("avg", avg, "max", nsToMs(max)));
+		};
+		result.addDictKeyValue("frames", int(frames.size()));
+		addStats("frame", [](const Frame& f) { return f.duration; });
+		for (auto s : xrange(size_t(Section::NUM))) {
+			addStats(PerfMonitor::getName(Section(s)), [&](const Frame& f) { return f.sections[s]; });
+		}
+		addStats("other", [](const Frame& f) { return getOther(f); });
+	} else if (subCmd == "frames") {
+		auto count = (tokens.size() == 3)
+		           ? size_t(std::max(0, tokens[2].getInt(getInterpreter())))
+		           : frames.size();
+		count = std::min(count, frames.size());
+		for (auto i : xrange(frames.size() - count, frames.size())) {
+			const auto& f = frames[i];
+			TclObject frame = makeTclDict("frame", nsToMs(f.duration));
+			for (auto s : xrange(size_t(Section::NUM))) {
+				frame.addDictKeyValue(PerfMonitor::getName(Section(s)), nsToMs(f.sections[s]));
+			}
+			frame.addDictKeyValue("other", nsToMs(getOther(f)));
+			result.addListElement(frame);
+		}
+	} else {
+		throw SyntaxError();
+	}
+}
+
+void PerfCommand::executeTrace(std::span<const TclObject> tokens, TclObject& result)
+{
+	if (tokens.size() == 2) {
+		auto [recorded, dropped] = PerfTrace::getStats();
+		result.addDictKeyValues("enabled", PerfTrace::isEnabled(),
+		                        "recorded", int(recorded),
+		                        "dropped", int(dropped));
+		return;
+	}
+	auto subCmd = tokens[2].getString();
+	if (subCmd == "start" && tokens.size() == 3) {
+		PerfTrace::start();
+	} else if (subCmd == "stop" && tokens.size() == 3) {
+		PerfTrace::stop();
+	} else if (subCmd == "save" && tokens.size() == 4) {
+		auto filename = FileOperations::expandTilde(std::string(tokens[3].getString()));
+		PerfTrace::save(filename);
+		result = filename;
+	} else {
+		throw SyntaxError();
+	}
+}
+
+void PerfCommand::executeSync(std::span<const TclObject> tokens, TclObject& result)
+{
+	if (tokens.size() == 3 && tokens[2] == "reset") {
+		Timer::resetSleepStats();
+		return;
+	}
+	if (tokens.size() != 2) throw SyntaxError();
+
+	const auto& stats = Timer::getSleepStats();
+	auto toList = [](const auto& values) {
+		TclObject list;
+		list.addListElements(values);
+		return list;
+	};
+	result.addDictKeyValues("count", int(stats.count),
+	                        "calibration", int(stats.calibration),
+	                        "spin_margin", int(stats.spinMargin),
+	                        "spin_time", double(stats.spinTime) * 1e-3,
+	                        "buckets", toList(Timer::SleepStats::BUCKET_LIMITS),
+	                        "oversleep", toList(stats.oversleep),
+	                        "undersleep", toList(stats.undersleep),
+	                        "late", toList(stats.late),
+	                        "max_oversleep", int(stats.maxOversleep),
+	                        "max_undersleep", int(stats.maxUndersleep),
+	                        "max_late", int(stats.maxLate));
+}
+
+void PerfCommand::executeSched(std::span<const TclObject> tokens, TclObject& result)
+{
+	auto* motherBoard = reactor.getMotherBoard();
+	if (!motherBoard) throw CommandException("No machine.");
+	auto& scheduler = motherBoard->getScheduler();
+	auto& cpu = motherBoard->getCPU();
+	if (tokens.size() == 3 && tokens[2] == "reset") {
+		scheduler.resetSyncPointStats();
+		cpu.resetExitStats();
+		return;
+	}
+	if (tokens.size() != 2) throw SyntaxError();
+
+	auto e = cpu.getExitStats();
+	result.addDictKeyValue("cpu", makeTclDict(
+		"sync_point", int64_t(e.syncPoint),
+		"irq", int64_t(e.slow),
+		"exit_request", int64_t(e.exitRequest),
+		"other", int64_t(e.other),
+		"irq_accepted", int64_t(e.irq),
+		"nmi_accepted", int64_t(e.nmi),
+		"exit_sync", int64_t(e.exitSync),
+		"exit_async", int64_t(e.exitAsync),
+		"breakpoint", int64_t(e.breakpoints)));
+
+	auto stats = to_vector(scheduler.getSyncPointStats());
+	std::ranges::sort(stats, std::greater{}, &Scheduler::SyncPointStats::count);
+	TclObject devices;
+	for (const auto& s : stats) {
+		devices.addListElement(makeTclDict(
+			"name", PerfTrace::demangle(s.type->name()),
+			"count", int64_t(s.count),
+			"interval", s.meanInterval() * 1e6));
+	}
+	result.addDictKeyValue("devices", devices);
+}
+
+std::string PerfCommand::help(std::span<const TclObject> /*tokens*/) const
+{
+	return "Per-frame timing of the emulator subsystems (times in ms).\n"
+	       "  perf                  returns whether monitoring is enabled\n"
+	       "  perf on|off           start (clears the history) or stop monitoring\n"
+	       "  perf clear            clear the history\n"
+	       "  perf stats            average and maximum time per frame, per subsystem\n"
+	       "  perf frames ?count?   the times of the last (up to 600) frames\n"
+	       "  perf trace            status of the trace recording\n"
+	       "  perf trace start      start recording a trace (discards the previous one)\n"
+	       "  perf trace stop       stop recording\n"
+	       "  perf trace save <filename>\n"
+	       "                        save the trace in Chrome JSON trace format, this\n"
+	       "                        can be viewed in chrome://tracing or ui.perfetto.dev\n"
+	       "  perf sync             statistics of the real-time synchronization (in us):\n"
+	       "                        histograms of the oversleep and undersleep of the host\n"
+	       "                        sleep, and of how late the emulation woke up after\n"
+	       "                        spinning the last part; bucket i counts values below\n"
+	       "                        the i-th element of 'buckets' (the last counts the rest)\n"
+	       "  perf sync reset       reset these statistics\n"
+	       "  perf sched            why the CPU emulation loop was interrupted: under\n"
+	       "                        'cpu' why the runs of instructions ended (only\n"
+	       "                        counted while monitoring is on) and how often IRQs\n"
+	       "                        were accepted, exits were requested or breakpoints hit;\n"
+	       "                        under 'devices' per Schedulable type the number of\n"
+	       "                        executed sync-points and the mean interval between\n"
+	       "                        them in emulated us (only while monitoring is on)\n"
+	       "  perf sched reset      reset these statistics\n"
+	       "The subsystems are: events, cpu, scheduler (emulated devices), "
+	       "rasterizer, mixer, postprocessor, paint (GUI, OSD and buffer swap) "
+	       "and sleep (throttling). 'other' is the remaining time of the frame.\n";
+}
+
+void PerfCommand::tabCompletion(std::vector<std::string>& tokens) const
+{
+	using namespace std::literals;
+	static constexpr std::array cmds = {
+		"on"sv, "off"sv, "clear"sv, "stats"sv, "frames"sv, "trace"sv, "sync"sv,
+		"sched"sv,
+	};
+	static constexpr std::array traceCmds = {
+		"start"sv, "stop"sv, "save"sv,
+	};
+	if (tokens.size() == 2) {
+		completeString(tokens, cmds);
+	} else if (tokens.size() == 3 && tokens[1] == "trace") {
+		completeString(tokens, traceCmds);
+	} else if (tokens.size() == 3 && tokens[1] == one_of("sync", "sched")) {
+		static constexpr std::array syncCmds = {"reset"sv};
+		completeString(tokens, syncCmds);
+	} else if (tokens.size() == 4 && tokens[1] == "trace" && tokens[2] == "save") {
+		completeFileName(tokens, userFileContext());
+	}
+}
+
+
+// class TclProfileCommand
+
+TclProfileCommand::TclProfileCommand(CommandController& commandController_)
+	: Command(commandController_, "tcl_profile")
+{
+}
+
+void TclProfileCommand::execute(std::span<const TclObject> tokens, TclObject& result)
+{
+	checkNumArgs(tokens, Between{1, 3}, "?on|off|clear|report ?count??");
+	using namespace TclProfiler;
+	if (tokens.size() == 1) {
+		result = isEnabled();
+		return;
+	}
+	auto subCmd = tokens[1].getString();
+	if (subCmd == "report") {
+		auto entries = getEntries();
+		auto count = (tokens.size() == 3)
+		           ? size_t(std::max(0, tokens[2].getInt(getInterpreter())))
+		           : entries.size();
+		for (const auto& e : std::views::take(entries, count)) {
+			result.addListElement(makeTclDict(
+				"type", TclProfiler::getName(e.kind),
+				"name", e.name,
+				"count", int64_t(e.count),
+				"total", nsToMs(e.total),
+				"self", nsToMs(e.self),
+				"max", nsToMs(e.max)));
+		}
+		return;
+	}
+	if (tokens.size() != 2) throw SyntaxError();
+	if (subCmd == "on") {
+		setEnabled(true);
+	} else if (subCmd == "off") {
+		setEnabled(false);
+	} else if (subCmd == "clear") {
+		TclProfiler::clear();
+	} else {
+		throw SyntaxError();
+	}
+}
+
+std::string TclProfileCommand::help(std::span<const TclObject> /*tokens*/) const
+{
+	return "Profile the time spent in Tcl scripts (times in ms).\n"
+	       "  tcl_profile                returns whether profiling is enabled\n"
+	       "  tcl_profile on|off         start or stop profiling\n"
+	       "  tcl_profile clear          clear the collected profile\n"
+	       "  tcl_profile report ?count? the (count) most expensive scripts, per script its\n"
+	       "                             type, name, number of calls, and the total, self\n"
+	       "                             (excluding nested scripts) and maximum time\n"
+	       "The types are: script (e.g. console input), after (the command of an 'after' "
+	       "event, e.g. the OSD widgets), callback (named after the callback setting) "
+	       "and breakpoint (the condition and command of a breakpoint, watchpoint or "
+	       "condition, named after its id). Long scripts are named after the start of "
+	       "their first line.\n";
+}
+
+void TclProfileCommand::tabCompletion(std::vector<std::string>& tokens) const
+{
+	using namespace std::literals;
+	static constexpr std::array cmds = {
+		"on"sv, "off"sv, "clear"sv, "report"sv,
+	};
+	if (tokens.size() == 2) {
+		completeString(tokens, cmds);
+	}
+}
+
+
 // class SetupCommand
 
 SetupCommand::SetupCommand(CommandController& commandController_,
@@ -1215,11 +1688,9 @@ void ConfigInfo::execute(std::span<const TclObject> tokens, TclObject& result) c
 	}
 	case 3: {
 		try {
-			std::array<char, 8192> allocBuffer; // tweak
-			XMLDocument doc{allocBuffer.data(), sizeof(allocBuffer)};
-			HardwareConfig::loadConfig(
-				doc, configName, tokens[2].getString());
-			if (const auto* info = doc.getRoot()->findChild("info")) {
+			const auto& root = HardwareConfig::getCachedConfig(
+				configName, tokens[2].getString());
+			if (const auto* info = root.findChild("info")) {
 				for (const auto& c : info->getChildren()) {
 					result.addDictKeyValue(c.getName(), c.getData());
 				}
@@ -1268,6 +1739,67 @@ std::string RealTimeInfo::help(std::span<const TclObject> /*tokens*/) const
 }
 
 
+// class EventLatencyInfo
+
+EventLatencyInfo::EventLatencyInfo(InfoCommand& openMSXInfoCommand,
+                                   const EventDistributor& distributor_)
+	: InfoTopic(openMSXInfoCommand, "event_latency")
+	, distributor(distributor_)
+{
+}
+
+void EventLatencyInfo::execute(std::span<const TclObject> /*tokens*/,
+                               TclObject& result) const
+{
+	const auto& stats = distributor.getLatencyStats();
+	auto average = stats.count ? narrow_cast<double>(stats.total) / narrow_cast<double>(stats.count) : 0.0;
+	result.addDictKeyValues("count",   stats.count,
+	                        "average", average * (1.0 / 1000000.0),
+	                        "max",     narrow_cast<double>(stats.max) * (1.0 / 1000000.0));
+}
+
+std::string EventLatencyInfo::help(std::span<const TclObject> /*tokens*/) const
+{
+	return "Returns statistics about the time between posting an event and "
+	       "delivering it in the main thread, over all events since openMSX "
+	       "was started: the number of events and the average and maximum "
+	       "latency in seconds.";
+}
+
+
+// class AllocationInfo
+
+AllocationInfo::AllocationInfo(InfoCommand& openMSXInfoCommand)
+	: InfoTopic(openMSXInfoCommand, "allocations")
+{
+}
+
+void AllocationInfo::execute(std::span<const TclObject> /*tokens*/,
+                             TclObject& result) const
+{
+	if (!AllocationCounter::isEnabled()) {
+		throw CommandException(
+			"openMSX was built without allocation counting "
+			"(enable the meson option 'count_allocations').");
+	}
+	auto counts = AllocationCounter::get();
+	result.addDictKeyValues("allocations",   counts.allocations,
+	                        "deallocations", counts.deallocations,
+	                        "live",          counts.live(),
+	                        "bytes",         counts.bytes);
+}
+
+std::string AllocationInfo::help(std::span<const TclObject> /*tokens*/) const
+{
+	return "Returns heap allocation statistics since openMSX was started: "
+	       "the number of allocations and deallocations, the number of "
+	       "still live allocations and the total number of requested bytes. "
+	       "Compare the results before and after e.g. 'machine' to see what "
+	       "creating a machine costs. Only available in builds with the "
+	       "meson option 'count_allocations'.";
+}
+
+
 // SoftwareInfoTopic
 
 SoftwareInfoTopic::SoftwareInfoTopic(InfoCommand& openMSXInfoCommand, Reactor& reactor_)
@@ -19,8 +19,10 @@ namespace openmsx {
 
 class ActivateMachineCommand;
 class AfterCommand;
+class AllocationInfo;
 class AviRecorder;
 class CliComm;
+class CloneMachineCommand;
 class CommandController;
 class CommandLineParser;
 class ConfigInfo;
@@ -31,8 +33,10 @@ class DiskFactory;
 class DiskManipulator;
 class Display;
 class EventDistributor;
+class EventLatencyInfo;
 class ExitCommand;
 class FilePool;
+class FrameHashLogger;
 class GetClipboardCommand;
 class GlobalCliComm;
 class GlobalCommandController;
@@ -47,6 +51,8 @@ class SetupCommand;
 class MSXMotherBoard;
 class MachineCommand;
 class MessageCommand;
+class PerfCommand;
+class TclProfileCommand;
 class Mixer;
 class MsxChar2Unicode;
 class RTScheduler;
@@ -125,6 +131,9 @@ public:
 
 	void block();
 	void unblock();
+	/** Is emulation not running, e.g. because it's paused or because
+	  * there's no machine? */
+	[[nodiscard]] bool isBlocked() const { return (blockedCounter > 0) || !activeBoard; }
 
 	// convenience methods
 	[[nodiscard]] GlobalSettings& getGlobalSettings() { return *globalSettings; }
@@ -198,13 +207,19 @@ private:
 	std::unique_ptr<ActivateMachineCommand> activateMachineCommand;
 	std::unique_ptr<StoreMachineCommand> storeMachineCommand;
 	std::unique_ptr<RestoreMachineCommand> restoreMachineCommand;
+	std::unique_ptr<CloneMachineCommand> cloneMachineCommand;
+	std::unique_ptr<PerfCommand> perfCommand;
+	std::unique_ptr<TclProfileCommand> tclProfileCommand;
 	std::unique_ptr<SetupCommand> setupCommand;
 	std::unique_ptr<GetClipboardCommand> getClipboardCommand;
 	std::unique_ptr<SetClipboardCommand> setClipboardCommand;
 	std::unique_ptr<AviRecorder> aviRecordCommand;
+	std::unique_ptr<FrameHashLogger> frameHashLogger;
 	std::unique_ptr<ConfigInfo> extensionInfo;
 	std::unique_ptr<ConfigInfo> machineInfo;
 	std::unique_ptr<RealTimeInfo> realTimeInfo;
+	std::unique_ptr<EventLatencyInfo> eventLatencyInfo;
+	std::unique_ptr<AllocationInfo> allocationInfo;
 	std::unique_ptr<SoftwareInfoTopic> softwareInfoTopic;
 	std::unique_ptr<TclCallbackMessages> tclCallbackMessages;
 
@@ -239,6 +254,7 @@ private:
 	friend class ActivateMachineCommand;
 	friend class StoreMachineCommand;
 	friend class RestoreMachineCommand;
+	friend class CloneMachineCommand;
 	friend class SetupCommand;
 };
 
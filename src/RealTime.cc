@@ -6,6 +6,8 @@
 #include "EventDistributor.hh"
 #include "GlobalSettings.hh"
 #include "MSXMotherBoard.hh"
+#include "PerfMonitor.hh"
+#include "RTScheduler.hh"
 #include "Reactor.hh"
 #include "ThrottleManager.hh"
 #include "Timer.hh"
@@ -78,13 +80,13 @@ void RealTime::sync(EmuTime time, bool allowSleep)
 	if (allowSleep) {
 		removeSyncPoint();
 	}
-	internalSync(time, allowSleep);
+	internalSync(time, allowSleep, true);
 	if (allowSleep) {
 		setSyncPoint(time + getEmuDuration(SYNC_INTERVAL));
 	}
 }
 
-void RealTime::internalSync(EmuTime time, bool allowSleep)
+void RealTime::internalSync(EmuTime time, bool allowSleep, bool outsideCpuLoop)
 {
 	if (throttleManager.isThrottled()) {
 		auto realDuration = static_cast<uint64_t>(
@@ -92,23 +94,30 @@ void RealTime::internalSync(EmuTime time, bool allowSleep)
 		idealRealTime += realDuration;
 		auto currentRealTime = Timer::getTime();
 		auto sleep = narrow_cast<int64_t>(idealRealTime - currentRealTime);
-		if (allowSleep) {
-			// want to sleep for 'sleep' us
-			sleep += narrow_cast<int64_t>(sleepAdjust);
-			int64_t delta = 0;
-			if (sleep > 0) {
-				Timer::sleep(sleep); // request to sleep for 'sleep+sleepAdjust'
-				auto slept = narrow<int64_t>(Timer::getTime() - currentRealTime);
-				delta = sleep - slept; // actually slept for 'slept' us
+		if (allowSleep && (sleep > 0)) {
+			// Timer::sleepUntil() compensates for the inaccuracy of
+			// the OS sleep (by spinning the last part).
+			PerfMonitor::Scope perf(PerfMonitor::Section::SLEEP);
+			if (outsideCpuLoop) {
+				// Keep executing RTSchedulables that expire while
+				// sleeping. E.g. Display presents frames at the
+				// host refresh rate (see 'frame_pacing').
+				auto& rtScheduler = motherBoard.getReactor().getRTScheduler();
+				while (true) {
+					auto next = rtScheduler.getNextTime();
+					if (!next || (*next >= idealRealTime)) break;
+					Timer::sleepUntil(*next);
+					rtScheduler.execute();
+				}
 			}
-			const double ALPHA = 0.2;
-			sleepAdjust = sleepAdjust * (1 - ALPHA) + narrow_cast<double>(delta) * ALPHA;
+			Timer::sleepUntil(idealRealTime);
 		}
 		if (-sleep > MAX_LAG) {
 			idealRealTime = currentRealTime - MAX_LAG / 2;
 		}
 	}
 	if (allowSleep) {
+		eventDelay.sampleInput();
 		eventDelay.sync(time);
 	}
 
@@ -117,7 +126,7 @@ void RealTime::internalSync(EmuTime time, bool allowSleep)
 
 void RealTime::executeUntil(EmuTime time)
 {
-	internalSync(time, true);
+	internalSync(time, true, false);
 	setSyncPoint(time + getEmuDuration(SYNC_INTERVAL));
 }
 
@@ -167,7 +176,6 @@ void RealTime::resync()
 	if (!enabled) return;
 
 	idealRealTime = Timer::getTime();
-	sleepAdjust = 0.0;
 	removeSyncPoint();
 	emuTime = getCurrentTime();
 	setSyncPoint(emuTime + getEmuDuration(SYNC_INTERVAL));
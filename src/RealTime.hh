@@ -71,7 +71,9 @@ private:
 	// Observer<ThrottleManager>
 	void update(const ThrottleManager& throttleManager) noexcept override;
 
-	void internalSync(EmuTime time, bool allowSleep);
+	/** @param outsideCpuLoop When true (called from an event listener), it's
+	  *        safe to execute RTSchedulables while sleeping. */
+	void internalSync(EmuTime time, bool allowSleep, bool outsideCpuLoop);
 
 	MSXMotherBoard& motherBoard;
 	EventDistributor& eventDistributor;
@@ -83,7 +85,6 @@ private:
 
 	uint64_t idealRealTime;
 	EmuTime emuTime = EmuTime::zero();
-	double sleepAdjust;
 	bool enabled = true;
 };
 
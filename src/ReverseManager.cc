@@ -6,13 +6,16 @@
 #include "Event.hh"
 #include "EventDelay.hh"
 #include "EventDistributor.hh"
+#include "File.hh"
 #include "FileContext.hh"
+#include "FileException.hh"
 #include "FileOperations.hh"
 #include "Keyboard.hh"
 #include "MSXCliComm.hh"
 #include "MSXCommandController.hh"
 #include "MSXMixer.hh"
 #include "MSXMotherBoard.hh"
+#include "PerfTrace.hh"
 #include "Reactor.hh"
 #include "StateChange.hh"
 #include "StateChangeDistributor.hh"
@@ -23,9 +26,14 @@
 #include "serialize.hh"
 #include "serialize_meta.hh"
 
+#include "MemBuffer.hh"
 #include "format.hh"
+#include "hash_set.hh"
 #include "narrow.hh"
 #include "one_of.hh"
+#include "rapidsax.hh"
+
+#include <zlib.h>
 
 #include <array>
 #include <cassert>
@@ -41,6 +49,9 @@ using namespace std::literals;
 // Time between two snapshots (in seconds)
 static constexpr double SNAPSHOT_PERIOD = 1.0;
 
+// Number of most recent snapshots that are not thinned out
+static constexpr unsigned NUM_RECENT_SNAPSHOTS = 25;
+
 // Max number of snapshots in a replay file
 static constexpr unsigned MAX_NOF_SNAPSHOTS = 10;
 
@@ -101,6 +112,73 @@ struct Replay
 };
 SERIALIZE_CLASS_VERSION(Replay, 4);
 
+// 'savereplay -append' adds the events that were recorded since the previous
+// save as a separate gzip member at the end of the replay file. When loading,
+// these events replace the EndLogEvent that terminated the event log so far.
+// Older openMSX versions only read the first member (the initial replay).
+struct ReplayUpdate
+{
+	ReverseManager::Events* events;
+	EmuTime currentTime = EmuTime::dummy();
+	unsigned reRecordCount = 0;
+
+	template<typename Archive>
+	void serialize(Archive& ar, unsigned /*version*/)
+	{
+		ar.serialize("events",        *events,
+		             "currentTime",   currentTime,
+		             "reRecordCount", reRecordCount);
+	}
+};
+SERIALIZE_CLASS_VERSION(ReplayUpdate, 1);
+
+// Returns the decompressed content of each gzip member in the given file,
+// each followed by rapidsax::EXTRA_BUFFER_SPACE zero bytes. Reading stops at
+// the first damaged member, e.g. an update that was only partially written
+// because openMSX crashed. Returns an empty vector for non-gzip files.
+[[nodiscard]] static std::vector<MemBuffer<char>> readGzipMembers(zstring_view filename)
+{
+	MemBuffer<uint8_t> data;
+	try {
+		File file(filename, "rb");
+		data.resize(file.getSize());
+		file.read(std::span{data});
+	} catch (FileException&) {
+		return {};
+	}
+
+	std::vector<MemBuffer<char>> result;
+	auto input = std::span<const uint8_t>{data};
+	while ((input.size() >= 2) && (input[0] == 0x1f) && (input[1] == 0x8b)) {
+		z_stream s = {};
+		if (inflateInit2(&s, 16 + MAX_WBITS) != Z_OK) break;
+		s.next_in = const_cast<Bytef*>(input.data());
+		s.avail_in = uInt(input.size());
+
+		size_t outSize = 4 * input.size() + rapidsax::EXTRA_BUFFER_SPACE;
+		MemBuffer<char> output(outSize);
+		int err;
+		do {
+			if ((outSize - s.total_out) <= rapidsax::EXTRA_BUFFER_SPACE) {
+				outSize *= 2;
+				output.resize(outSize);
+			}
+			s.next_out = std::bit_cast<Bytef*>(output.data() + s.total_out);
+			s.avail_out = uInt(outSize - rapidsax::EXTRA_BUFFER_SPACE - s.total_out);
+			err = inflate(&s, Z_NO_FLUSH);
+		} while (err == Z_OK);
+		size_t size = s.total_out;
+		input = input.last(s.avail_in);
+		inflateEnd(&s);
+		if (err != Z_STREAM_END) break;
+
+		output.resize(size + rapidsax::EXTRA_BUFFER_SPACE);
+		std::ranges::fill(std::span{output}.subspan(size), 0);
+		result.push_back(std::move(output));
+	}
+	return result;
+}
+
 
 // struct ReverseHistory
 
@@ -108,6 +186,8 @@ void ReverseManager::ReverseHistory::swap(ReverseHistory& other) noexcept
 {
 	std::swap(chunks, other.chunks);
 	std::swap(events, other.events);
+	std::swap(takeTiming, other.takeTiming);
+	std::swap(restoreTiming, other.restoreTiming);
 }
 
 void ReverseManager::ReverseHistory::clear()
@@ -115,6 +195,7 @@ void ReverseManager::ReverseHistory::clear()
 	// clear() and free storage capacity
 	Chunks().swap(chunks);
 	Events().swap(events);
+	snapshotStorage.clear();
 }
 
 
@@ -126,6 +207,10 @@ ReverseManager::ReverseManager(MSXMotherBoard& motherBoard_)
 	, motherBoard(motherBoard_)
 	, eventDistributor(motherBoard.getReactor().getEventDistributor())
 	, reverseCmd(motherBoard.getCommandController())
+	, memoryLimitSetting(
+		motherBoard.getCommandController(), "reverse_memory_limit",
+		"maximum amount of memory (in MB) used for the reverse history, 0 means no limit",
+		1024, 0, 1024 * 1024)
 {
 	eventDistributor.registerEventListener(EventType::TAKE_REVERSE_SNAPSHOT, *this);
 
@@ -233,6 +318,11 @@ void ReverseManager::status(TclObject& result) const
 	}
 	EmuTime le(isCollecting() && (lastEvent != rend(history.events)) ? getTime(*lastEvent) : EmuTime::zero());
 	result.addDictKeyValue("last_event", le.toDouble());
+
+	auto usage = getMemoryUsage();
+	result.addDictKeyValue("memory", TclObject(TclObject::MakeDictTag{},
+		"recent", uint64_t(usage.recent),
+		"older", uint64_t(usage.older)));
 }
 
 void ReverseManager::debugInfo(TclObject& result) const
@@ -249,7 +339,16 @@ void ReverseManager::debugInfo(TclObject& result) const
 		          " (next event index: ", chunk.eventCount, ")\n");
 		totalSize += chunk.savestate.size();
 	}
-	strAppend(res, "total size: ", totalSize, '\n');
+	strAppend(res, "total size: ", totalSize, '\n',
+	          "events: ", history.events.size(),
+	          " (", history.events.size() * sizeof(StateChange), ")\n");
+	auto printTiming = [&](std::string_view name, const Timing& t) {
+		auto average = t.count ? t.total / t.count : 0;
+		strAppend(res, name, ": ", t.count, " (average: ", average,
+		          "us, max: ", t.max, "us)\n");
+	};
+	printTiming("snapshots taken", history.takeTiming);
+	printTiming("snapshots restored", history.restoreTiming);
 	result = res;
 }
 
@@ -388,14 +487,19 @@ void ReverseManager::goTo(
 		} else {
 			// Note: we don't (anymore) erase future snapshots
 			// -- restore old snapshot --
+			auto restoreStart = Timer::getTime();
 			newBoard_ = reactor.createEmptyMotherBoard();
 			newBoard = newBoard_.get();
 			// suppress messages we'd get by deserializing (and
 			// thus instantiating the parts of) the new board
 			newBoard->getMSXCliComm().setSuppressMessages(true);
-			MemInputArchive in(chunk.savestate,
-					   chunk.deltaBlocks);
-			in.serialize("machine", *newBoard);
+			{
+				PerfTrace::Span trace("savestate", "reverse restore", chunk.time);
+				MemInputArchive in(chunk.savestate,
+						   chunk.deltaBlocks);
+				in.serialize("machine", *newBoard);
+			}
+			hist.restoreTiming.add(Timer::getTime() - restoreStart);
 
 			if (eventDelay) {
 				// Handle all events that are scheduled, but not yet
@@ -419,6 +523,9 @@ void ReverseManager::goTo(
 
 			// transfer (or copy) state from old to new machine
 			transferState(*newBoard);
+			if (sameTimeLine) {
+				newManager.appendInfo = appendInfo;
+			}
 
 			// In case of load-replay it's possible we are not collecting,
 			// but calling stop() anyway is ok.
@@ -467,6 +574,13 @@ void ReverseManager::goTo(
 				lastSnapshotTarget = nextSnapshotTarget;
 			}
 		}
+		if (newBoard->getCurrentTime() > startMSXTime) {
+			// Also take a snapshot at the new play position. Seeking
+			// around this position again (e.g. when scrubbing in the
+			// reverse bar) then doesn't have to replay from an older
+			// (possibly far away) snapshot.
+			newBoard->getReverseManager().takeSnapshotIfNew(newBoard->getCurrentTime());
+		}
 		// re-enable messages
 		newBoard->getMSXCliComm().setSuppressMessages(false);
 		// re-enable automatic snapshots
@@ -536,7 +650,11 @@ void ReverseManager::saveReplay(
 
 	std::string_view filenameArg;
 	int maxNofExtraSnapshots = MAX_NOF_SNAPSHOTS;
-	std::array info = {valueArg("-maxnofextrasnapshots", maxNofExtraSnapshots)};
+	bool append = false;
+	std::array info = {
+		valueArg("-maxnofextrasnapshots", maxNofExtraSnapshots),
+		flagArg("-append", append),
+	};
 	auto args = parseTclArgs(interp, tokens.subspan(2), info);
 	switch (args.size()) {
 		case 0: break; // nothing
@@ -550,6 +668,15 @@ void ReverseManager::saveReplay(
 	auto filename = FileOperations::parseCommandFileArgument(
 		filenameArg, REPLAY_DIR, "openmsx", REPLAY_EXTENSION);
 
+	if (append && canAppendReplay(filename)) {
+		appendReplay(filename);
+		result = filename;
+		return;
+	}
+	if (appendInfo && (appendInfo->filename == filename)) {
+		appendInfo.reset(); // we're about to overwrite that file
+	}
+
 	auto& reactor = motherBoard.getReactor();
 	Replay replay(reactor);
 	replay.reRecordCount = reRecordCount;
@@ -631,9 +758,64 @@ void ReverseManager::saveReplay(
 		history.events.pop_back();
 	}
 
+	if (append) {
+		auto st = FileOperations::getStat(filename);
+		if (!st) throw CommandException("Couldn't access ", filename);
+		appendInfo = AppendInfo{
+			.filename = filename,
+			.fileSize = size_t(st->st_size),
+			.firstSnapshotTime = begin(chunks)->second.time,
+			.numEvents = history.events.size(),
+			.reRecordCount = reRecordCount,
+		};
+	}
+
 	result = filename;
 }
 
+bool ReverseManager::canAppendReplay(zstring_view filename) const
+{
+	// Only when the file wasn't touched since we last wrote it, and when
+	// the history only grew since then (going back in time, e.g. to
+	// change the history, increases the re-record count).
+	if (!appendInfo || (appendInfo->filename != filename) ||
+	    (appendInfo->reRecordCount != reRecordCount) ||
+	    (appendInfo->firstSnapshotTime != begin(history.chunks)->second.time) ||
+	    (appendInfo->numEvents > history.events.size()) ||
+	    isReplaying()) {
+		return false;
+	}
+	auto st = FileOperations::getStat(filename);
+	return st && (size_t(st->st_size) == appendInfo->fileSize);
+}
+
+void ReverseManager::appendReplay(zstring_view filename)
+{
+	assert(appendInfo);
+	Events newEvents(begin(history.events) + appendInfo->numEvents,
+	                 end(history.events));
+	newEvents.emplace_back(std::in_place_type_t<EndLogEvent>{},
+	                       getCurrentTime());
+	ReplayUpdate update{&newEvents, getCurrentTime(), reRecordCount};
+	try {
+		XmlOutputArchive out(filename, true);
+		out.serialize("replay_update", update);
+		out.close();
+	} catch (MSXException&) {
+		// Don't know what got written, start over next time.
+		appendInfo.reset();
+		throw;
+	}
+
+	auto st = FileOperations::getStat(filename);
+	if (!st) {
+		appendInfo.reset();
+		throw CommandException("Couldn't access ", filename);
+	}
+	appendInfo->fileSize = size_t(st->st_size);
+	appendInfo->numEvents = history.events.size();
+}
+
 void ReverseManager::loadReplay(
 	Interpreter& interp, std::span<const TclObject> tokens, TclObject& result)
 {
@@ -671,8 +853,34 @@ void ReverseManager::loadReplay(
 	Events events;
 	replay.events = &events;
 	try {
-		XmlInputArchive in(filename);
-		in.serialize("replay", replay);
+		auto members = readGzipMembers(filename);
+		if (members.empty()) {
+			XmlInputArchive in(filename);
+			in.serialize("replay", replay);
+		} else {
+			XmlInputArchive in(std::move(members.front()), filename);
+			in.serialize("replay", replay);
+		}
+		// Apply the updates written by 'savereplay -append'.
+		for (auto& member : std::span{members}.subspan(std::min<size_t>(1, members.size()))) {
+			Events newEvents;
+			ReplayUpdate update{&newEvents};
+			try {
+				XmlInputArchive in(std::move(member), filename);
+				in.serialize("replay_update", update);
+			} catch (MSXException& e) {
+				motherBoard.getMSXCliComm().printWarning(
+					"Ignoring damaged end of replay ", filename, ": ",
+					e.getMessage());
+				break;
+			}
+			if (!events.empty() && std::holds_alternative<EndLogEvent>(events.back())) {
+				events.pop_back();
+			}
+			std::ranges::move(newEvents, std::back_inserter(events));
+			replay.currentTime = update.currentTime;
+			replay.reRecordCount = update.reRecordCount;
+		}
 	} catch (XMLException& e) {
 		throw CommandException("Cannot load replay, bad file format: ",
 		                       e.getMessage());
@@ -851,11 +1059,13 @@ unsigned ReverseManager::ReverseHistory::getNextSeqNum(EmuTime time) const
 
 void ReverseManager::takeSnapshot(EmuTime time)
 {
+	PerfTrace::Span trace("savestate", "reverse snapshot", time);
+	auto start = Timer::getTime();
 	// (possibly) drop old snapshots
 	// TODO does snapshot pruning still happen correctly (often enough)
 	//      when going back/forward in time?
 	unsigned seqNum = history.getNextSeqNum(time);
-	dropOldSnapshots<25>(seqNum);
+	dropOldSnapshots<NUM_RECENT_SNAPSHOTS>(seqNum);
 
 	// During replay we might already have a snapshot with the current
 	// sequence number, though this snapshot does not necessarily have the
@@ -865,11 +1075,24 @@ void ReverseManager::takeSnapshot(EmuTime time)
 	// actually create new snapshot
 	ReverseChunk& newChunk = history.chunks[seqNum];
 	newChunk.deltaBlocks.clear();
-	MemOutputArchive out(history.lastDeltaBlocks, newChunk.deltaBlocks, true);
+	MemOutputArchive out(history.lastDeltaBlocks, newChunk.deltaBlocks, true,
+	                     std::move(history.snapshotStorage));
 	out.serialize("machine", motherBoard);
 	newChunk.time = time;
-	newChunk.savestate = std::move(out).releaseBuffer();
+	newChunk.savestate = std::move(out).releaseCopy(history.snapshotStorage);
 	newChunk.eventCount = replayIndex;
+	history.takeTiming.add(Timer::getTime() - start);
+
+	enforceMemoryLimit();
+}
+
+void ReverseManager::takeSnapshotIfNew(EmuTime time)
+{
+	// Don't replace an existing snapshot with the same sequence number,
+	// in particular not the very first one.
+	if (!history.chunks.contains(history.getNextSeqNum(time))) {
+		takeSnapshot(time);
+	}
 }
 
 void ReverseManager::replayNextEvent()
@@ -932,6 +1155,44 @@ void ReverseManager::dropOldSnapshots(unsigned count)
 	}
 }
 
+ReverseManager::MemoryUsage ReverseManager::getMemoryUsage() const
+{
+	MemoryUsage result;
+	if (history.chunks.empty()) return result;
+
+	// Memory blocks can be shared between snapshots, count them only once
+	// (for the most recent snapshot that uses them).
+	auto lastSeqNum = history.chunks.rbegin()->first;
+	hash_set<const DeltaBlock*> seen;
+	for (const auto& [seqNum, chunk] : std::views::reverse(history.chunks)) {
+		auto& total = (seqNum + NUM_RECENT_SNAPSHOTS > lastSeqNum)
+		            ? result.recent : result.older;
+		total += chunk.savestate.size();
+		for (const auto& block : chunk.deltaBlocks) {
+			for (const auto* b = block.get(); b && seen.insert(b).second;
+			     b = b->getReference()) {
+				total += b->getMemorySize();
+			}
+		}
+	}
+	return result;
+}
+
+void ReverseManager::enforceMemoryLimit()
+{
+	auto limit = size_t(memoryLimitSetting.getInt()) * 1024 * 1024;
+	if (limit == 0) return; // no limit
+
+	// Drop the oldest snapshots, except for the very first one (it's
+	// still possible to go back to any moment in time, but that may take
+	// longer) and the just created one.
+	while (history.chunks.size() > 2) {
+		auto usage = getMemoryUsage();
+		if ((usage.recent + usage.older) <= limit) break;
+		history.chunks.erase(std::next(begin(history.chunks)));
+	}
+}
+
 void ReverseManager::schedule(EmuTime time)
 {
 	syncNewSnapshot.setSyncPoint(time + EmuDuration::sec(SNAPSHOT_PERIOD));
@@ -981,12 +1242,12 @@ std::string ReverseManager::ReverseCmd::help(std::span<const TclObject> /*tokens
 {
 	return "start               start collecting reverse data\n"
 	       "stop                stop collecting\n"
-	       "status              show various status info on reverse\n"
+	       "status              show various status info on reverse (including the memory usage)\n"
 	       "goback <n>          go back <n> seconds in time\n"
 	       "goto <time>         go to an absolute moment in time\n"
 	       "viewonlymode <bool> switch viewonly mode on or off\n"
 	       "truncatereplay      stop replaying and remove all 'future' data\n"
-	       "savereplay [<name>] save the first snapshot and all replay data as a 'replay' (with optional name)\n"
+	       "savereplay [-append] [<name>] save the first snapshot and all replay data as a 'replay' (with optional name), with -append only new events are added to a replay that was saved earlier with -append\n"
 	       "loadreplay [-goto <begin|end|savetime|<n>>] [-viewonly] <name>   load a replay (snapshot and replay data) with given name and start replaying\n";
 }
 
@@ -1002,9 +1263,11 @@ void ReverseManager::ReverseCmd::tabCompletion(std::vector<std::string>& tokens)
 		completeString(tokens, subCommands);
 	} else if ((tokens.size() == 3) || (tokens[1] == "loadreplay")) {
 		if (tokens[1] == one_of("loadreplay", "savereplay")) {
-			static constexpr std::array cmds = {"-goto"sv, "-viewonly"sv};
+			static constexpr std::array loadCmds = {"-goto"sv, "-viewonly"sv};
+			static constexpr std::array saveCmds = {"-append"sv};
 			completeFileName(tokens, userDataFileContext(REPLAY_DIR),
-				(tokens[1] == "loadreplay") ? cmds : std::span<const std::string_view>{});
+				(tokens[1] == "loadreplay") ? std::span<const std::string_view>{loadCmds}
+				                            : std::span<const std::string_view>{saveCmds});
 		} else if (tokens[1] == "viewonlymode") {
 			static constexpr std::array options = {"true"sv, "false"sv};
 			completeString(tokens, options);
@@ -4,19 +4,24 @@
 #include "Command.hh"
 #include "EmuTime.hh"
 #include "EventListener.hh"
+#include "IntegerSetting.hh"
 #include "Schedulable.hh"
 #include "StateChange.hh"
 
 #include "DeltaBlock.hh"
 #include "MemBuffer.hh"
 #include "outer.hh"
+#include "zstring_view.hh"
 
+#include <algorithm>
 #include <cstdint>
 #include <deque>
 #include <map>
 #include <memory>
+#include <optional>
 #include <ranges>
 #include <span>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -86,8 +91,33 @@ private:
 		unsigned eventCount;
 	};
 	using Chunks = std::map<unsigned, ReverseChunk>;
+	// A StateChange is small (32 bytes, the size of the largest event type
+	// plus the variant index) and a deque allocates them in blocks. So
+	// even replays with millions of (analog input) events only use tens
+	// of MBs, that's small compared to the snapshots.
 	using Events = std::deque<StateChange>;
 
+	// Memory used by the snapshots, split in the most recent snapshots
+	// (one per SNAPSHOT_PERIOD) and the older, thinned out, snapshots.
+	struct MemoryUsage {
+		size_t recent = 0;
+		size_t older = 0;
+	};
+
+	// Wall-clock durations (in us) of taking and of restoring snapshots.
+	// Reported by 'reverse debug'. E.g. to judge how much it would cost to
+	// do this every frame.
+	struct Timing {
+		void add(uint64_t duration) {
+			++count;
+			total += duration;
+			max = std::max(max, duration);
+		}
+		uint64_t count = 0;
+		uint64_t total = 0;
+		uint64_t max = 0;
+	};
+
 	struct ReverseHistory {
 		void swap(ReverseHistory& other) noexcept;
 		void clear();
@@ -96,6 +126,9 @@ private:
 		Chunks chunks;
 		Events events;
 		LastDeltaBlocks lastDeltaBlocks;
+		MemBuffer<uint8_t> snapshotStorage; // reused by takeSnapshot()
+		Timing takeTiming;
+		Timing restoreTiming; // create board + deserialize snapshot
 	};
 
 	void start();
@@ -106,6 +139,8 @@ private:
 	void goTo(std::span<const TclObject> tokens);
 	void saveReplay(Interpreter& interp,
 	                std::span<const TclObject> tokens, TclObject& result);
+	[[nodiscard]] bool canAppendReplay(zstring_view filename) const;
+	void appendReplay(zstring_view filename);
 	void loadReplay(Interpreter& interp,
 	                std::span<const TclObject> tokens, TclObject& result);
 
@@ -118,9 +153,12 @@ private:
 	                     unsigned oldEventCount);
 	void transferState(MSXMotherBoard& newBoard);
 	void takeSnapshot(EmuTime time);
+	void takeSnapshotIfNew(EmuTime time);
 	void schedule(EmuTime time);
 	void replayNextEvent();
 	template<unsigned N> void dropOldSnapshots(unsigned count);
+	[[nodiscard]] MemoryUsage getMemoryUsage() const;
+	void enforceMemoryLimit();
 
 	// Schedulable
 	struct SyncNewSnapshot final : Schedulable {
@@ -158,6 +196,8 @@ private:
 		void tabCompletion(std::vector<std::string>& tokens) const override;
 	} reverseCmd;
 
+	IntegerSetting memoryLimitSetting;
+
 	EventDelay* eventDelay = nullptr;
 	ReverseHistory history;
 	unsigned replayIndex = 0;
@@ -166,7 +206,20 @@ private:
 
 	unsigned reRecordCount = 0;
 
+	// The replay file that was last written with 'savereplay -append'.
+	// As long as the history only grew since then, a next save to that
+	// same file only appends the new events.
+	struct AppendInfo {
+		std::string filename;
+		size_t fileSize; // file size right after writing
+		EmuTime firstSnapshotTime = EmuTime::zero();
+		size_t numEvents; // excluding the terminating EndLogEvent
+		unsigned reRecordCount;
+	};
+	std::optional<AppendInfo> appendInfo;
+
 	friend struct Replay;
+	friend struct ReplayUpdate;
 };
 
 } // namespace openmsx
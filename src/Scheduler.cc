@@ -1,6 +1,8 @@
 #include "Scheduler.hh"
 
 #include "MSXCPU.hh"
+#include "PerfMonitor.hh"
+#include "PerfTrace.hh"
 #include "Schedulable.hh"
 #include "Thread.hh"
 
@@ -10,6 +12,7 @@
 #include <algorithm>
 #include <cassert>
 #include <iterator> // for back_inserter
+#include <typeinfo>
 
 namespace openmsx {
 
@@ -40,8 +43,7 @@ void Scheduler::setSyncPoint(EmuTime time, Schedulable& device)
 	// Push sync point into queue.
 	queue.insert(SynchronizationPoint(time, &device),
 	             [](SynchronizationPoint& sp) { sp.setTime(EmuTime::infinity()); },
-	             [](const SynchronizationPoint& x, const SynchronizationPoint& y) {
-	                     return x.getTime() < y.getTime(); });
+	             EarlierSyncPoint{});
 
 	if (!scheduleInProgress && cpu) {
 		// only when scheduleHelper() is not being executed
@@ -55,6 +57,10 @@ Scheduler::SyncPoints Scheduler::getSyncPoints(const Schedulable& device) const
 {
 	SyncPoints result;
 	std::ranges::copy_if(queue, back_inserter(result), EqualSchedulable(device));
+#ifdef SCHEDULER_HEAP_QUEUE
+	// the heap is not sorted, keep the same order as SchedulerQueue
+	std::ranges::stable_sort(result, EarlierSyncPoint{});
+#endif
 	return result;
 }
 
@@ -73,11 +79,22 @@ void Scheduler::removeSyncPoints(const Schedulable& device)
 std::optional<EmuTime> Scheduler::isPending(const Schedulable& device) const
 {
 	assert(Thread::isMainThread());
+#ifdef SCHEDULER_HEAP_QUEUE
+	// the heap is not sorted, search the earliest sync-point
+	std::optional<EmuTime> result;
+	for (const auto& sp : queue) {
+		if ((sp.getDevice() == &device) && (!result || (sp.getTime() < *result))) {
+			result = sp.getTime();
+		}
+	}
+	return result;
+#else
 	if (auto it = std::ranges::find(queue, &device, &SynchronizationPoint::getDevice);
 	    it != std::end(queue)) {
 		return it->getTime();
 	}
 	return {};
+#endif
 }
 
 EmuTime Scheduler::getCurrentTime() const
@@ -88,6 +105,7 @@ EmuTime Scheduler::getCurrentTime() const
 
 void Scheduler::scheduleHelper(EmuTime limit, EmuTime next)
 {
+	PerfMonitor::Scope perf(PerfMonitor::Section::SCHEDULER);
 	assert(!scheduleInProgress);
 	scheduleInProgress = true;
 	while (true) {
@@ -99,7 +117,14 @@ void Scheduler::scheduleHelper(EmuTime limit, EmuTime next)
 
 		queue.remove_front();
 
-		device->executeUntil(next);
+		if (PerfMonitor::isEnabled()) [[unlikely]] {
+			countSyncPoint(*device, next);
+		}
+		{
+			// (typeid is only evaluated when tracing)
+			PerfTrace::Span trace("sync", PerfTrace::isEnabled() ? typeid(*device).name() : "", next);
+			device->executeUntil(next);
+		}
 
 		next = getNext();
 		if (next > limit) [[likely]] break;
@@ -109,6 +134,18 @@ void Scheduler::scheduleHelper(EmuTime limit, EmuTime next)
 	cpu->setNextSyncPoint(next);
 }
 
+void Scheduler::countSyncPoint(const Schedulable& device, EmuTime time)
+{
+	const auto& type = typeid(device);
+	auto it = std::ranges::find_if(syncPointStats,
+		[&](const auto& s) { return *s.type == type; });
+	auto& stats = (it != syncPointStats.end())
+	            ? *it
+	            : syncPointStats.emplace_back(SyncPointStats{.type = &type, .first = time});
+	++stats.count;
+	stats.last = time;
+}
+
 
 template<typename Archive>
 void SynchronizationPoint::serialize(Archive& ar, unsigned /*version*/)
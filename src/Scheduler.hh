@@ -2,9 +2,12 @@
 #define SCHEDULER_HH
 
 #include "EmuTime.hh"
+#include "SchedulerHeapQueue.hh"
 #include "SchedulerQueue.hh"
 
+#include <cstdint>
 #include <optional>
+#include <typeinfo>
 #include <vector>
 
 namespace openmsx {
@@ -30,6 +33,12 @@ private:
 	Schedulable* device = nullptr;
 };
 
+struct EarlierSyncPoint {
+	[[nodiscard]] bool operator()(const SynchronizationPoint& x, const SynchronizationPoint& y) const {
+		return x.getTime() < y.getTime();
+	}
+};
+
 
 class Scheduler
 {
@@ -68,6 +77,27 @@ public:
 		scheduleTime = limit;
 	}
 
+	/** How often the sync-points of a (type of) Schedulable were
+	  * executed. Each sync-point ends the current CPU slice, so this
+	  * shows which devices fragment the CPU emulation. Only collected
+	  * while PerfMonitor is enabled.
+	  */
+	struct SyncPointStats {
+		const std::type_info* type;
+		uint64_t count = 0;
+		EmuTime first = EmuTime::zero();
+		EmuTime last = EmuTime::zero();
+
+		/** Average time between two executeUntil() calls, in seconds. */
+		[[nodiscard]] double meanInterval() const {
+			return (count > 1) ? (last - first).toDouble() / double(count - 1) : 0.0;
+		}
+	};
+	[[nodiscard]] const std::vector<SyncPointStats>& getSyncPointStats() const {
+		return syncPointStats;
+	}
+	void resetSyncPointStats() { syncPointStats.clear(); }
+
 	template<typename Archive>
 	void serialize(Archive& ar, unsigned version);
 
@@ -107,12 +137,21 @@ private: // -> intended for Schedulable
 
 private:
 	void scheduleHelper(EmuTime limit, EmuTime next);
+	void countSyncPoint(const Schedulable& device, EmuTime time);
 
 private:
-	/** Vector used as heap, not a priority queue because that
-	  * doesn't allow removal of non-top element.
+	/** Not a std::priority_queue because that doesn't allow removal of
+	  * non-top element. By default a sorted array is used, this is
+	  * fastest for the typical (small) number of sync-points. Define
+	  * SCHEDULER_HEAP_QUEUE to use a binary heap instead, that scales
+	  * better for (very) heavily loaded machines.
 	  */
+#ifdef SCHEDULER_HEAP_QUEUE
+	SchedulerHeapQueue<SynchronizationPoint, EarlierSyncPoint> queue;
+#else
 	SchedulerQueue<SynchronizationPoint> queue;
+#endif
+	std::vector<SyncPointStats> syncPointStats; // one per Schedulable type
 	EmuTime scheduleTime = EmuTime::zero();
 	MSXCPU* cpu = nullptr;
 	bool scheduleInProgress = false;
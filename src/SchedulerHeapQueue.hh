@@ -0,0 +1,156 @@
+#ifndef SCHEDULERHEAPQUEUE_HH
+#define SCHEDULERHEAPQUEUE_HH
+
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace openmsx {
+
+// Alternative for SchedulerQueue, implemented as a binary min-heap.
+//
+// SchedulerQueue is a sorted array: insert() and remove() are O(N) (though
+// very often O(1) in practice). This heap has O(log N) insert(), remove()
+// (after an O(N) search) and remove_front(). It's only beneficial for
+// machines with many simultaneous sync-points. Select it at build time by
+// defining SCHEDULER_HEAP_QUEUE (see Scheduler.hh).
+//
+// The interface is the same as SchedulerQueue, with these differences:
+// - The ordering is given by the (stateless) LESS template parameter.
+// - begin()/end() iterate over all elements, but NOT in sorted order.
+// Like SchedulerQueue, elements that are equivalent according to LESS keep
+// their insertion order (this is required for deterministic emulation).
+template<typename T, typename LESS> class SchedulerHeapQueue
+{
+public:
+	[[nodiscard]] size_t size()  const { return items.size(); }
+	[[nodiscard]] bool   empty() const { return items.empty(); }
+
+	// Returns reference to the smallest element.
+	[[nodiscard]]       T& front()       { assert(!empty()); return items.front(); }
+	[[nodiscard]] const T& front() const { assert(!empty()); return items.front(); }
+
+	// Unordered iteration.
+	[[nodiscard]]       T* begin()       { return items.data(); }
+	[[nodiscard]] const T* begin() const { return items.data(); }
+	[[nodiscard]]       T* end()         { return items.data() + items.size(); }
+	[[nodiscard]] const T* end()   const { return items.data() + items.size(); }
+
+	// Same signature as SchedulerQueue::insert(). A heap doesn't need a
+	// sentinel, and the ordering is fixed by LESS.
+	void insert(const T& t, std::invocable<T&> auto /*setSentinel*/, LESS /*less*/)
+	{
+		items.push_back(t);
+		order.push_back(counter++);
+		siftUp(items.size() - 1);
+	}
+
+	// Remove the smallest element.
+	void remove_front()
+	{
+		assert(!empty());
+		removeAt(0);
+	}
+
+	// Remove the smallest element for which the given predicate returns
+	// true (like SchedulerQueue, which removes the first match in sorted
+	// order).
+	bool remove(std::predicate<T> auto p)
+	{
+		auto found = size_t(-1);
+		for (size_t i = 0; i < items.size(); ++i) {
+			if (p(items[i]) && ((found == size_t(-1)) || less(i, found))) {
+				found = i;
+			}
+		}
+		if (found == size_t(-1)) return false;
+		removeAt(found);
+		return true;
+	}
+
+	// Remove all elements for which the given predicate returns true.
+	void remove_all(std::predicate<T> auto p)
+	{
+		size_t n = 0;
+		for (size_t i = 0; i < items.size(); ++i) {
+			if (!p(items[i])) {
+				items[n] = items[i];
+				order[n] = order[i];
+				++n;
+			}
+		}
+		if (n == items.size()) return;
+		items.resize(n);
+		order.resize(n);
+		for (size_t i = n / 2; i-- != 0; ) { // re-heapify
+			siftDown(i);
+		}
+	}
+
+private:
+	[[nodiscard]] bool less(size_t i, size_t j) const
+	{
+		LESS l;
+		if (l(items[i], items[j])) return true;
+		if (l(items[j], items[i])) return false;
+		return order[i] < order[j]; // equivalent: oldest first
+	}
+
+	void swapItems(size_t i, size_t j)
+	{
+		std::swap(items[i], items[j]);
+		std::swap(order[i], order[j]);
+	}
+
+	void siftUp(size_t i)
+	{
+		while (i != 0) {
+			size_t parent = (i - 1) / 2;
+			if (!less(i, parent)) break;
+			swapItems(i, parent);
+			i = parent;
+		}
+	}
+
+	void siftDown(size_t i)
+	{
+		size_t n = items.size();
+		while (true) {
+			size_t smallest = i;
+			size_t l = 2 * i + 1;
+			size_t r = l + 1;
+			if ((l < n) && less(l, smallest)) smallest = l;
+			if ((r < n) && less(r, smallest)) smallest = r;
+			if (smallest == i) break;
+			swapItems(i, smallest);
+			i = smallest;
+		}
+	}
+
+	void removeAt(size_t i)
+	{
+		size_t last = items.size() - 1;
+		if (i != last) {
+			items[i] = items[last];
+			order[i] = order[last];
+		}
+		items.pop_back();
+		order.pop_back();
+		if (i < items.size()) {
+			siftDown(i);
+			siftUp(i);
+		}
+	}
+
+private:
+	// Invariant: items.size() == order.size()
+	std::vector<T> items;
+	std::vector<uint64_t> order; // insertion order, breaks ties
+	uint64_t counter = 0;
+};
+
+} // namespace openmsx
+
+#endif // SCHEDULERHEAPQUEUE_HH
@@ -0,0 +1,150 @@
+#include "StartupProfiler.hh"
+
+#include "FileOperations.hh"
+#include "Timer.hh"
+
+#include "one_of.hh"
+#include "stl.hh"
+#include "strCat.hh"
+#include "zstring_view.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <ranges>
+#include <span>
+#include <vector>
+
+namespace openmsx::StartupProfiler {
+
+namespace {
+	struct Phase {
+		std::string name;
+		uint64_t start; // in us, see Timer::getTime()
+		uint64_t duration = 0;
+		uint64_t childDuration = 0; // total duration of the direct sub-phases
+		size_t depth;
+	};
+
+	struct State {
+		std::vector<Phase> phases;
+		std::vector<size_t> open; // indices of the not yet ended phases
+		std::string filename; // empty when not enabled
+		bool recording = true;
+	};
+}
+
+static State& getState()
+{
+	static State state;
+	return state;
+}
+
+Scope::Scope(std::string_view name)
+	: index(size_t(-1))
+{
+	auto& state = getState();
+	if (!state.recording) return;
+	index = state.phases.size();
+	state.phases.push_back(Phase{.name = std::string(name), .start = Timer::getTime(),
+	                             .depth = state.open.size()});
+	state.open.push_back(index);
+}
+
+Scope::~Scope()
+{
+	auto& state = getState();
+	if ((index == size_t(-1)) || !state.recording) return;
+	auto& phase = state.phases[index];
+	phase.duration = Timer::getTime() - phase.start;
+	assert(!state.open.empty() && (state.open.back() == index));
+	state.open.pop_back();
+	if (!state.open.empty()) {
+		state.phases[state.open.back()].childDuration += phase.duration;
+	}
+}
+
+void enable(std::string jsonFilename)
+{
+	getState().filename = std::move(jsonFilename);
+}
+
+static void appendJsonString(std::string& out, std::string_view s)
+{
+	out += '"';
+	for (char c : s) {
+		if (c == one_of('"', '\\')) {
+			out += '\\';
+			out += c;
+		} else if (uint8_t(c) < 0x20) {
+			strAppend(out, "\\u00", hex_string<2>(uint8_t(c)));
+		} else {
+			out += c;
+		}
+	}
+	out += '"';
+}
+
+static void report(std::span<const Phase> phases)
+{
+	auto begin = std::ranges::min(phases, {}, &Phase::start).start;
+	auto end = std::ranges::max(std::views::transform(phases,
+		[](const Phase& p) { return p.start + p.duration; }));
+
+	// Sorted on self time: the time not spent in sub-phases. Sorting on
+	// the total time would put all outer phases at the top.
+	auto sorted = to_vector(std::views::transform(phases, [](const Phase& p) { return &p; }));
+	std::ranges::sort(sorted, std::greater{},
+		[](const Phase* p) { return p->duration - p->childDuration; });
+	std::string text = std::format(
+		"Startup profile, {:.1f}ms in total (times in ms):\n"
+		"    self    total  phase\n", double(end - begin) / 1000.0);
+	for (const auto* p : sorted) {
+		text += std::format("{:8.1f} {:8.1f}  {}{}\n",
+			double(p->duration - p->childDuration) / 1000.0,
+			double(p->duration) / 1000.0,
+			std::string(2 * p->depth, ' '), p->name);
+	}
+	std::cerr << text;
+}
+
+static void writeTrace(zstring_view filename, std::span<const Phase> phases)
+{
+	auto begin = std::ranges::min(phases, {}, &Phase::start).start;
+	std::string json = "{\"traceEvents\":[\n";
+	for (const auto& p : phases) {
+		json += "{\"name\":";
+		appendJsonString(json, p.name);
+		strAppend(json, ",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":", p.start - begin,
+		          ",\"dur\":", p.duration, "},\n");
+	}
+	if (!phases.empty()) json.erase(json.size() - 2, 1); // remove last ','
+	json += "],\"displayTimeUnit\":\"ms\"}\n";
+
+	std::ofstream file;
+	FileOperations::openOfStream(file, filename);
+	file.write(json.data(), std::streamsize(json.size()));
+	if (!file) {
+		std::cerr << "Couldn't write startup profile to " << filename << '\n';
+	}
+}
+
+void finish()
+{
+	auto& state = getState();
+	if (!state.recording) return;
+	state.recording = false;
+
+	if (!state.filename.empty() && !state.phases.empty()) {
+		report(state.phases);
+		writeTrace(state.filename, state.phases);
+	}
+	// free memory
+	state.phases = {};
+	state.open = {};
+}
+
+} // namespace openmsx::StartupProfiler
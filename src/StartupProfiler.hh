@@ -0,0 +1,58 @@
+#ifndef STARTUPPROFILER_HH
+#define STARTUPPROFILER_HH
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace openmsx {
+
+/** Timing of the phases of the openMSX startup (initialization of the
+  * subsystems, loading settings, executing the Tcl scripts, creating the
+  * machine and its devices, ...).
+  *
+  * A phase is marked by (the lifetime of) a Scope object, phases can be
+  * nested. Phases are always recorded from the start of the process till
+  * finish() is called, right before entering the main loop. So the overhead
+  * is limited to startup, and phases that run before the command line is
+  * parsed are recorded as well.
+  *
+  * Only when the '-startup-profile' option was given, finish() prints a
+  * report (sorted on duration) and writes all phases as a JSON file in the
+  * 'Trace Event Format', which can be viewed with chrome://tracing or
+  * https://ui.perfetto.dev.
+  *
+  * Only use this from the main thread.
+  */
+namespace StartupProfiler {
+
+	class Scope
+	{
+	public:
+		explicit Scope(std::string_view name);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope(Scope&&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		Scope& operator=(Scope&&) = delete;
+
+	private:
+		size_t index; // in the list of recorded phases, or 'size_t(-1)'
+	};
+
+	/** Report the recorded phases at finish(), and write them to the
+	  * given file.
+	  */
+	void enable(std::string jsonFilename);
+
+	/** Stop recording (startup is done). If enabled, also report.
+	  * Calling this more than once has no effect.
+	  */
+	void finish();
+
+} // namespace StartupProfiler
+
+} // namespace openmsx
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef BENCHMARK_HH
+#define BENCHMARK_HH
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openmsx::bench {
+
+/** Prevent the compiler from optimizing away the computation of 't'. */
+template<typename T>
+inline void keep(const T& t)
+{
+#if defined(__GNUC__)
+	asm volatile("" : : "g"(&t) : "memory");
+#else
+	static const void* volatile sink;
+	sink = &t;
+#endif
+}
+
+struct Result
+{
+	std::string name;
+	std::string_view unit; // what is counted by 'items', e.g. "pixels"
+	uint64_t iterations;
+	double seconds;
+	double items; // total over all iterations
+};
+
+/** Runs the individual benchmarks and collects their results.
+  *
+  * Each benchmark is a function that processes a fixed amount of work
+  * ('itemsPerIteration' items, e.g. pixels or samples). It's called
+  * repeatedly until at least 'minTime' has passed, and the throughput
+  * (items per second) is reported. All workloads use fixed random seeds,
+  * so the work done is the same in every run.
+  */
+class Runner
+{
+public:
+	Runner(std::string_view filter_, double minTime_)
+		: filter(filter_), minTime(minTime_) {}
+
+	/** Only list the names, don't run anything. */
+	void setListOnly() { listOnly = true; }
+
+	/** Should a benchmark with the given name run? Can be used to skip
+	  * an expensive setup. */
+	[[nodiscard]] bool enabled(std::string_view name) const {
+		return name.contains(filter);
+	}
+
+	template<typename F>
+	void run(std::string_view name, std::string_view unit,
+	         double itemsPerIteration, F f)
+	{
+		if (!enabled(name)) return;
+		if (listOnly) {
+			results.push_back(Result{std::string(name), unit, 0, 0.0, 0.0});
+			return;
+		}
+		using Clock = std::chrono::steady_clock;
+		f(); // warm-up: caches, lazily initialized tables, ...
+		uint64_t iterations = 0;
+		auto start = Clock::now();
+		double elapsed = 0.0;
+		do {
+			// check the time only once per batch, the work per
+			// iteration can be (much) smaller than the clock overhead
+			for (int i = 0; i < 16; ++i) f();
+			iterations += 16;
+			elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+		} while (elapsed < minTime);
+		results.push_back(Result{std::string(name), unit, iterations, elapsed,
+		                         double(iterations) * itemsPerIteration});
+	}
+
+	[[nodiscard]] const std::vector<Result>& getResults() const { return results; }
+
+private:
+	std::vector<Result> results;
+	std::string_view filter;
+	double minTime;
+	bool listOnly = false;
+};
+
+// One function per group of benchmarks (see main.cc).
+void benchBitmapConverter(Runner& runner);
+void benchClock(Runner& runner);
+void benchLineScalers(Runner& runner);
+void benchYM2413(Runner& runner);
+void benchSavestate(Runner& runner);
+void benchTcl(Runner& runner);
+
+} // namespace openmsx::bench
+
+#endif
@@ -0,0 +1,67 @@
+#include "Benchmark.hh"
+
+#include "BitmapConverter.hh"
+
+#include "narrow.hh"
+#include "xrange.hh"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace openmsx::bench {
+
+using Pixel = BitmapConverter::Pixel;
+
+// Rasterize a full (212 lines) frame in each of the bitmap screen modes.
+// (The character modes need a complete VDP, see CharacterConverter.)
+void benchBitmapConverter(Runner& runner)
+{
+	static constexpr int LINES = 212;
+
+	std::mt19937 gen(1234);
+	std::array<Pixel, 16 * 2> palette16;
+	std::array<Pixel, 256>    palette256;
+	std::vector<Pixel>        palette32768(32768);
+	for (auto& p : palette16)    p = Pixel(gen());
+	for (auto& p : palette256)   p = Pixel(gen());
+	for (auto& p : palette32768) p = Pixel(gen());
+	std::span<const Pixel, 32768> pal32k{palette32768.data(), 32768};
+	BitmapConverter converter(palette16, palette256, pal32k);
+
+	// two planes of 128 bytes per line
+	std::vector<std::array<uint8_t, 128>> vram0(LINES), vram1(LINES);
+	for (auto y : xrange(LINES)) {
+		std::ranges::generate(vram0[y], [&] { return narrow_cast<uint8_t>(gen()); });
+		std::ranges::generate(vram1[y], [&] { return narrow_cast<uint8_t>(gen()); });
+	}
+	std::array<Pixel, 512> out;
+
+	auto bench = [&](std::string_view name, uint8_t mode, bool planar, int width) {
+		// bitmap modes: M5..M3 in reg0, YAE and YJK in reg25
+		converter.setDisplayMode(DisplayMode(
+			uint8_t((mode & 0x1C) >> 1), 0, uint8_t((mode & 0x60) >> 2)));
+		runner.run(name, "pixels", double(width) * LINES, [&] {
+			for (auto y : xrange(LINES)) {
+				if (planar) {
+					converter.convertLinePlanar(out, vram0[y], vram1[y]);
+				} else {
+					converter.convertLine(out, vram0[y]);
+				}
+				keep(out);
+			}
+		});
+	};
+	bench("video/BitmapConverter/graphic4", DisplayMode::GRAPHIC4, false, 256);
+	bench("video/BitmapConverter/graphic5", DisplayMode::GRAPHIC5, false, 512);
+	bench("video/BitmapConverter/graphic6", DisplayMode::GRAPHIC6, true,  512);
+	bench("video/BitmapConverter/graphic7", DisplayMode::GRAPHIC7, true,  256);
+	bench("video/BitmapConverter/yjk",
+	      DisplayMode::GRAPHIC7 | DisplayMode::YJK, true, 256);
+	bench("video/BitmapConverter/yjk-yae",
+	      DisplayMode::GRAPHIC7 | DisplayMode::YJK | DisplayMode::YAE, true, 256);
+}
+
+} // namespace openmsx::bench
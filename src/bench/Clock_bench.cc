@@ -0,0 +1,55 @@
+#include "Benchmark.hh"
+
+#include "Clock.hh"
+#include "DynamicClock.hh"
+
+#include "xrange.hh"
+
+#include <random>
+#include <vector>
+
+namespace openmsx::bench {
+
+// The EmuTime <-> ticks conversions that are done (several times) for each
+// sync point: Clock<> divides by a compile-time constant, DynamicClock uses
+// the precomputed reciprocal of DivModBySame.
+void benchClock(Runner& runner)
+{
+	static constexpr size_t NUM = 1024;
+
+	std::mt19937 gen(42);
+	EmuTime start = EmuTime::zero() + EmuDuration::sec(100.0);
+	std::vector<EmuTime> times;
+	times.reserve(NUM);
+	repeat(NUM, [&] {
+		times.push_back(start + EmuDuration(uint64_t(gen() % 10'000'000))); // < 1 frame
+	});
+	unsigned sum = 0;
+
+	auto bench = [&](std::string_view name, auto f) {
+		runner.run(name, "conversions", double(NUM), [&] {
+			for (const auto& t : times) f(t);
+			keep(sum);
+		});
+	};
+
+	Clock<3579545> z80Clock(start);
+	bench("timer/Clock/getTicksTill", [&](EmuTime t) { sum += z80Clock.getTicksTill(t); });
+	bench("timer/Clock/getTicksTill_fast", [&](EmuTime t) { sum += z80Clock.getTicksTill_fast(t); });
+
+	DynamicClock dynClock(start, 3579545);
+	bench("timer/DynamicClock/getTicksTill", [&](EmuTime t) { sum += dynClock.getTicksTill(t); });
+	bench("timer/DynamicClock/getTicksTillUp", [&](EmuTime t) { sum += dynClock.getTicksTillUp(t); });
+	bench("timer/DynamicClock/advance", [&](EmuTime t) {
+		DynamicClock c = dynClock;
+		c.advance(t);
+		sum += unsigned(c.getTime().toUint64());
+	});
+	bench("timer/DynamicClock/getTotalTicks", [&](EmuTime t) {
+		DynamicClock c = dynClock;
+		c.reset(t);
+		sum += unsigned(c.getTotalTicks());
+	});
+}
+
+} // namespace openmsx::bench
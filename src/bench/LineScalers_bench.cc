@@ -0,0 +1,43 @@
+#include "Benchmark.hh"
+
+#include "LineScalers.hh"
+
+#include <random>
+#include <vector>
+
+namespace openmsx::bench {
+
+// The building blocks of the software scalers and of the post-processing
+// (scanlines, blur, OSD blending).
+void benchLineScalers(Runner& runner)
+{
+	static constexpr size_t WIDTH = 640; // output pixels per line
+
+	std::mt19937 gen(42);
+	auto randomLine = [&](size_t size) {
+		std::vector<Pixel> result(size);
+		for (auto& p : result) p = Pixel(gen());
+		return result;
+	};
+	auto in1 = randomLine(2 * WIDTH);
+	auto in2 = randomLine(2 * WIDTH);
+	std::vector<Pixel> out(WIDTH);
+	std::span<const Pixel> src1{in1};
+	std::span<const Pixel> src2{in2};
+
+	auto bench = [&](std::string_view name, auto f) {
+		runner.run(name, "pixels", double(WIDTH), [&] {
+			f();
+			keep(out);
+		});
+	};
+	bench("video/LineScalers/blendLines<1,1>", [&] { blendLines<1, 1>(src1.first(WIDTH), src2.first(WIDTH), out); });
+	bench("video/LineScalers/blendLines<1,3>", [&] { blendLines<1, 3>(src1.first(WIDTH), src2.first(WIDTH), out); });
+	bench("video/LineScalers/alphaBlendLines", [&] { alphaBlendLines(src1.first(WIDTH), src2.first(WIDTH), out); });
+	bench("video/LineScalers/scale_1on2", [&] { scale_1on2(src1.first(WIDTH / 2), out); });
+	bench("video/LineScalers/scale_1on3", [&] { scale_1on3(src1.first(WIDTH / 3), std::span{out}.first(3 * (WIDTH / 3))); });
+	bench("video/LineScalers/scale_2on1", [&] { scale_2on1(src1.first(2 * WIDTH), out); });
+	bench("video/LineScalers/scale_2on3", [&] { scale_2on3(src1.first(2 * (WIDTH / 3)), std::span{out}.first(3 * (WIDTH / 3))); });
+}
+
+} // namespace openmsx::bench
@@ -0,0 +1,105 @@
+#include "Benchmark.hh"
+
+#include "DeltaBlock.hh"
+#include "DirtyPages.hh"
+#include "MemBuffer.hh"
+#include "YM2413Okazaki.hh"
+#include "serialize.hh"
+
+#include "narrow.hh"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace openmsx::bench {
+
+// A stand-in for a machine: a big memory block (with dirty tracking, like
+// TrackedRam) plus a device with a lot of small members.
+struct BenchMachine
+{
+	static constexpr size_t RAM_SIZE = 512 * 1024; // 128kB RAM + 128kB VRAM + 256kB memory mapper
+
+	BenchMachine() : dirty(RAM_SIZE) {
+		// partly zero (like most RAM), partly random
+		std::mt19937 gen(4321);
+		std::ranges::generate(ram, [&] { return narrow_cast<uint8_t>(gen()); });
+		std::ranges::fill(std::span{ram}.subspan(RAM_SIZE / 2), 0);
+	}
+
+	template<typename Archive>
+	void serialize(Archive& ar, unsigned /*version*/)
+	{
+		ar.serialize("fm", fm);
+		if constexpr (Archive::IS_LOADER) {
+			ar.serialize_blob("ram", std::span{ram});
+			dirty.markAllDirty();
+		} else if (ar.isReverseSnapshot()) {
+			ar.serialize_blob("ram", std::span{ram}, dirty, lastReverseSnapshot);
+			lastReverseSnapshot = dirty.checkpoint();
+		} else {
+			ar.serialize_blob("ram", std::span{ram});
+		}
+	}
+
+	MemBuffer<uint8_t> ram{RAM_SIZE};
+	DirtyPages dirty;
+	DirtyPages::Epoch lastReverseSnapshot = 0;
+	YM2413Okazaki::YM2413 fm;
+};
+
+// In-memory savestates (as used by clone_machine and the binary savestate
+// format) and reverse snapshots.
+void benchSavestate(Runner& runner)
+{
+	auto machine = std::make_unique<BenchMachine>();
+	static constexpr auto SIZE = double(BenchMachine::RAM_SIZE);
+
+	runner.run("savestate/save", "bytes", SIZE, [&] {
+		LastDeltaBlocks lastDeltaBlocks;
+		std::vector<std::shared_ptr<DeltaBlock>> deltaBlocks;
+		MemOutputArchive out(lastDeltaBlocks, deltaBlocks, false);
+		out.serialize("machine", *machine);
+		auto buffer = std::move(out).releaseBuffer();
+		keep(buffer);
+	});
+
+	if (runner.enabled("savestate/load")) {
+		LastDeltaBlocks lastDeltaBlocks;
+		std::vector<std::shared_ptr<DeltaBlock>> deltaBlocks;
+		MemOutputArchive out(lastDeltaBlocks, deltaBlocks, false);
+		out.serialize("machine", *machine);
+		auto buffer = std::move(out).releaseBuffer();
+
+		runner.run("savestate/load", "bytes", SIZE, [&] {
+			MemInputArchive in(buffer, deltaBlocks);
+			in.serialize("machine", *machine);
+			keep(*machine);
+		});
+	}
+
+	// Typical emulation between two reverse snapshots: a few pages of
+	// memory are written. Snapshots are taken in a sequence (like the
+	// ReverseManager does), so only the changes are stored.
+	if (runner.enabled("reverse/snapshot")) {
+		LastDeltaBlocks lastDeltaBlocks;
+		MemBuffer<uint8_t> storage;
+		std::mt19937 gen(8765);
+		runner.run("reverse/snapshot", "bytes", SIZE, [&] {
+			for (int i = 0; i < 16; ++i) {
+				auto addr = gen() % BenchMachine::RAM_SIZE;
+				machine->ram[addr] ^= 0x55;
+				machine->dirty.markDirty(addr);
+			}
+			std::vector<std::shared_ptr<DeltaBlock>> deltaBlocks;
+			MemOutputArchive out(lastDeltaBlocks, deltaBlocks, true, std::move(storage));
+			out.serialize("machine", *machine);
+			auto buffer = std::move(out).releaseCopy(storage);
+			keep(buffer);
+		});
+	}
+}
+
+} // namespace openmsx::bench
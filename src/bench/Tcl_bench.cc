@@ -0,0 +1,53 @@
+#include "Benchmark.hh"
+
+#include "Interpreter.hh"
+#include "TclObject.hh"
+
+#include "xrange.hh"
+
+#include <array>
+#include <cstdint>
+#include <list>
+
+namespace openmsx::bench {
+
+// The overhead of building Tcl results, as done by commands that are polled
+// every frame from scripts ('debug read', 'debug list', info topics, ...).
+// (Registering an openMSX command requires a CommandController, so the
+// round-trip benchmarks use built-in Tcl commands.)
+void benchTcl(Runner& runner)
+{
+	Interpreter interp;
+
+	runner.run("commands/Interpreter/execute expr", "commands", 1.0, [&] {
+		auto result = interp.execute("expr {0x12 + 0x34}");
+		keep(result);
+	});
+	interp.execute("set data [lrepeat 256 0]");
+	runner.run("commands/Interpreter/execute lindex", "commands", 1.0, [&] {
+		auto result = interp.execute("lindex $data 100");
+		keep(result);
+	});
+
+	std::array<uint8_t, 256> bytes;
+	for (auto i : xrange(bytes.size())) bytes[i] = uint8_t(i * 37);
+	runner.run("commands/TclObject/list of bytes", "elements", double(bytes.size()), [&] {
+		TclObject result;
+		result.addListElements(bytes);
+		keep(result);
+	});
+	std::list<int> values(bytes.begin(), bytes.end()); // not random-access
+	runner.run("commands/TclObject/list of bytes (forward range)", "elements", double(values.size()), [&] {
+		TclObject result;
+		result.addListElements(values);
+		keep(result);
+	});
+	runner.run("commands/TclObject/small ints", "objects", 16.0, [&] {
+		for (auto i : xrange(16)) {
+			TclObject result(i);
+			keep(result);
+		}
+	});
+}
+
+} // namespace openmsx::bench
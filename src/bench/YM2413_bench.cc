@@ -0,0 +1,55 @@
+#include "Benchmark.hh"
+
+#include "YM2413Burczynski.hh"
+#include "YM2413NukeYKT.hh"
+#include "YM2413Okazaki.hh"
+
+#include "strCat.hh"
+#include "xrange.hh"
+
+#include <array>
+#include <memory>
+
+namespace openmsx::bench {
+
+// Generate sound with all channels playing, for each of the YM2413 cores.
+// (The other sound chips are tied to MSXMotherBoard/DeviceConfig, they
+// can't be instantiated standalone.)
+void benchYM2413(Runner& runner)
+{
+	static constexpr unsigned NUM = 1024; // samples per call
+
+	std::array<std::array<float, NUM>, 9 + 5> buffers;
+
+	auto bench = [&](std::string_view name, YM2413Core& core, bool rhythm) {
+		runner.run(name, "samples", NUM, [&] {
+			// Restart the notes each time, so that every call does the
+			// same amount of work (the cores skip silent channels).
+			core.reset();
+			for (auto ch : xrange(uint8_t(9))) {
+				core.pokeReg(uint8_t(0x10 + ch), uint8_t(0x50 + 16 * ch));      // F-number (low)
+				core.pokeReg(uint8_t(0x30 + ch), uint8_t(((ch + 1) << 4) | 2)); // instrument, volume
+				core.pokeReg(uint8_t(0x20 + ch), uint8_t(0x10 | (4 << 1)));     // key-on, block
+			}
+			if (rhythm) core.pokeReg(0x0E, 0x3F); // rhythm mode, all drums on
+
+			std::array<float*, 9 + 5> bufs;
+			for (auto i : xrange(bufs.size())) {
+				buffers[i].fill(0.0f);
+				bufs[i] = buffers[i].data();
+			}
+			core.generateChannels(bufs, NUM);
+			keep(buffers);
+		});
+	};
+	auto benchCore = [&](std::string_view name, auto create) {
+		auto core = create();
+		bench(strCat("sound/", name, "/melodic"), *core, false);
+		bench(strCat("sound/", name, "/rhythm"), *core, true);
+	};
+	benchCore("YM2413Okazaki",    [] { return std::make_unique<YM2413Okazaki   ::YM2413>(); });
+	benchCore("YM2413Burczynski", [] { return std::make_unique<YM2413Burczynski::YM2413>(); });
+	benchCore("YM2413NukeYKT",    [] { return std::make_unique<YM2413NukeYKT   ::YM2413>(); });
+}
+
+} // namespace openmsx::bench
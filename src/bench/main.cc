@@ -0,0 +1,111 @@
+// openmsx-bench: measures the throughput of (headless) emulator components.
+//
+// Usage: openmsx-bench [--list] [--filter <substring>] [--time <seconds>]
+//                      [--format json|text]
+//
+// The default output is a single JSON object (on stdout), so that results of
+// different openMSX versions and/or host CPUs can be collected and compared
+// by scripts.
+
+#include "Benchmark.hh"
+
+#include "Version.hh"
+#include "build-info.hh"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <string_view>
+
+using namespace openmsx;
+using namespace openmsx::bench;
+
+static void printJson(std::span<const Result> results)
+{
+	std::cout << "{\n"
+	          << "  \"openmsx\": \"" << std::string_view(Version::full()) << "\",\n"
+	          << "  \"platform\": \"" << TARGET_PLATFORM << "\",\n"
+	          << "  \"cpu\": \"" << TARGET_CPU << "\",\n"
+	          << "  \"flavour\": \"" << BUILD_FLAVOUR << "\",\n"
+	          << "  \"results\": [";
+	bool first = true;
+	for (const auto& r : results) {
+		std::cout << (first ? "\n" : ",\n")
+		          << "    {\"name\": \"" << r.name << '"'
+		          << ", \"iterations\": " << r.iterations
+		          << ", \"seconds\": " << r.seconds
+		          << ", \"unit\": \"" << r.unit << '"'
+		          << ", \"per_second\": " << (r.items / r.seconds) << '}';
+		first = false;
+	}
+	std::cout << "\n  ]\n}\n";
+}
+
+static void printText(std::span<const Result> results)
+{
+	for (const auto& r : results) {
+		std::cout << std::left << std::setw(40) << r.name << ' '
+		          << std::right << std::setw(12) << std::fixed << std::setprecision(3)
+		          << (r.items / r.seconds / 1e6) << " M" << r.unit << "/s\n";
+	}
+}
+
+static int usage()
+{
+	std::cerr << "Usage: openmsx-bench [--list] [--filter <substring>] "
+	             "[--time <seconds>] [--format json|text]\n";
+	return 1;
+}
+
+int main(int argc, char** argv)
+{
+	std::string_view filter;
+	double minTime = 0.5;
+	bool list = false;
+	bool json = true;
+	for (int i = 1; i < argc; ++i) {
+		std::string_view arg = argv[i];
+		bool hasValue = (i + 1) < argc;
+		if (arg == "--list") {
+			list = true;
+		} else if (arg == "--filter" && hasValue) {
+			filter = argv[++i];
+		} else if (arg == "--time" && hasValue) {
+			char* end = nullptr;
+			minTime = std::strtod(argv[++i], &end);
+			if ((*end != '\0') || !(minTime > 0.0)) return usage();
+		} else if (arg == "--format" && hasValue) {
+			std::string_view format = argv[++i];
+			if (format == "json") {
+				json = true;
+			} else if (format == "text") {
+				json = false;
+			} else {
+				return usage();
+			}
+		} else {
+			return usage();
+		}
+	}
+
+	Runner runner(filter, minTime);
+	if (list) runner.setListOnly();
+
+	benchBitmapConverter(runner);
+	benchClock(runner);
+	benchLineScalers(runner);
+	benchYM2413(runner);
+	benchSavestate(runner);
+	benchTcl(runner);
+
+	const auto& results = runner.getResults();
+	if (list) {
+		for (const auto& r : results) std::cout << r.name << '\n';
+	} else if (json) {
+		printJson(results);
+	} else {
+		printText(results);
+	}
+	return 0;
+}
@@ -6,7 +6,6 @@
 #include "Filename.hh"
 #include "MSXException.hh"
 
-#include "narrow.hh"
 #include "stl.hh"
 #include "xrange.hh"
 
@@ -34,14 +33,9 @@ namespace openmsx {
 // So every sample repeated 4 times.
 static constexpr unsigned AUDIO_OVERSAMPLE = 4;
 
-static void append(std::vector<int8_t>& wave, size_t count, int8_t value)
+static void writeSilence(TapeEdges& wave, unsigned s)
 {
-	wave.insert(wave.end(), count, value);
-}
-
-static void writeSilence(std::vector<int8_t>& wave, unsigned s)
-{
-	append(wave, s, 0);
+	wave.append(s, 0);
 }
 
 static bool compare(const uint8_t* p, std::span<const uint8_t> rhs)
@@ -72,23 +66,25 @@ static constexpr unsigned SHORT_HEADER =  4000 / 2;
 // headers definitions
 static constexpr std::array<uint8_t, 8> CAS_HEADER = { 0x1F,0xA6,0xDE,0xBA,0xCC,0x13,0x7D,0x74 };
 
-static void write0(std::vector<int8_t>& wave)
+static void write0(TapeEdges& wave)
 {
-	static constexpr std::array<int8_t, 4> chunk{127, 127, -127, -127};
-	::append(wave, chunk);
+	wave.append(2,  127);
+	wave.append(2, -127);
 }
-static void write1(std::vector<int8_t>& wave)
+static void write1(TapeEdges& wave)
 {
-	static constexpr std::array<int8_t, 4> chunk{127, -127, 127, -127};
-	::append(wave, chunk);
+	repeat(2, [&] {
+		wave.append(1,  127);
+		wave.append(1, -127);
+	});
 }
 
-static void writeHeader(std::vector<int8_t>& wave, unsigned s)
+static void writeHeader(TapeEdges& wave, unsigned s)
 {
 	repeat(s, [&] { write1(wave); });
 }
 
-static void writeByte(std::vector<int8_t>& wave, uint8_t b)
+static void writeByte(TapeEdges& wave, uint8_t b)
 {
 	// one start bit
 	write0(wave);
@@ -105,22 +101,46 @@ static void writeByte(std::vector<int8_t>& wave, uint8_t b)
 	write1(wave);
 }
 
+// tape position of the end of the waveform (so far)
+static EmuTime currentPos(const CasImage::Data& data)
+{
+	return EmuTime::zero() + EmuDuration::hz(data.frequency) * data.wave.size();
+}
+
+// write silence and a sync tone, this starts a new block
+static void writeBlockStart(CasImage::Data& data, unsigned silence, unsigned header)
+{
+	writeSilence(data.wave, silence);
+	auto headerStart = currentPos(data);
+	writeHeader(data.wave, header);
+	data.blocks.push_back({.headerStart = headerStart, .dataStart = currentPos(data),
+	                       .data = {}, .byteEnd = {}});
+}
+
+static void writeBlockByte(CasImage::Data& data, uint8_t b)
+{
+	writeByte(data.wave, b);
+	auto& block = data.blocks.back();
+	block.data.push_back(b);
+	block.byteEnd.push_back(currentPos(data));
+}
+
 // write data until a header is detected
-static bool writeData(std::vector<int8_t>& wave, std::span<const uint8_t> cas, size_t& pos)
+static bool writeData(CasImage::Data& data, std::span<const uint8_t> cas, size_t& pos)
 {
 	bool eof = false;
 	while ((pos + CAS_HEADER.size()) <= cas.size()) {
 		if (compare(&cas[pos], CAS_HEADER)) {
 			return eof;
 		}
-		writeByte(wave, cas[pos]);
+		writeBlockByte(data, cas[pos]);
 		if (cas[pos] == 0x1A) {
 			eof = true;
 		}
 		pos++;
 	}
 	while (pos < cas.size()) {
-		writeByte(wave, cas[pos++]);
+		writeBlockByte(data, cas[pos++]);
 	}
 	return false;
 }
@@ -130,7 +150,6 @@ static CasImage::Data convert(std::span<const uint8_t> cas, const std::string& f
 {
 	CasImage::Data data;
 	data.frequency = OUTPUT_FREQUENCY;
-	auto& wave = data.wave;
 
 	// search for a header in the .cas file
 	bool issueWarning = false;
@@ -144,8 +163,7 @@ static CasImage::Data convert(std::span<const uint8_t> cas, const std::string& f
 			// them, we do also (hence a lot of code).
 			headerFound = true;
 			pos += CAS_HEADER.size();
-			writeSilence(wave, LONG_SILENCE);
-			writeHeader(wave, LONG_HEADER);
+			writeBlockStart(data, LONG_SILENCE, LONG_HEADER);
 			if ((pos + ASCII_HEADER.size()) <= cas.size()) {
 				// determine file type
 				using enum CassetteImage::FileType;
@@ -163,31 +181,29 @@ static CasImage::Data convert(std::span<const uint8_t> cas, const std::string& f
 				if (firstFile) firstFileType = type;
 				switch (type) {
 					case ASCII:
-						writeData(wave, cas, pos);
+						writeData(data, cas, pos);
 						do {
 							pos += CAS_HEADER.size();
-							writeSilence(wave, SHORT_SILENCE);
-							writeHeader(wave, SHORT_HEADER);
-							bool eof = writeData(wave, cas, pos);
+							writeBlockStart(data, SHORT_SILENCE, SHORT_HEADER);
+							bool eof = writeData(data, cas, pos);
 							if (eof) break;
 						} while ((pos + CAS_HEADER.size()) <= cas.size());
 						break;
 					case BINARY:
 					case BASIC:
-						writeData(wave, cas, pos);
-						writeSilence(wave, SHORT_SILENCE);
-						writeHeader(wave, SHORT_HEADER);
+						writeData(data, cas, pos);
+						writeBlockStart(data, SHORT_SILENCE, SHORT_HEADER);
 						pos += CAS_HEADER.size();
-						writeData(wave, cas, pos);
+						writeData(data, cas, pos);
 						break;
 					default:
 						// unknown file type: using long header
-						writeData(wave, cas, pos);
+						writeData(data, cas, pos);
 						break;
 				}
 			} else {
 				// unknown file type: using long header
-				writeData(wave, cas, pos);
+				writeData(data, cas, pos);
 			}
 			firstFile = false;
 		} else {
@@ -216,21 +232,21 @@ static constexpr std::array<uint8_t, 17> header = {
 	0x7f,
 };
 
-static void writeBit(std::vector<int8_t>& wave, bool bit)
+static void writeBit(TapeEdges& wave, bool bit)
 {
 	size_t count = bit ? 1 : 2;
-	append(wave, count,  127);
-	append(wave, count, -127);
+	wave.append(count,  127);
+	wave.append(count, -127);
 }
 
-static void writeByte(std::vector<int8_t>& wave, uint8_t byte)
+static void writeByte(TapeEdges& wave, uint8_t byte)
 {
 	for (int i = 7; i >= 0; --i) {
 		writeBit(wave, (byte >> i) & 1);
 	}
 }
 
-static void processBlock(std::span<const uint8_t> subBuf, std::vector<int8_t>& wave)
+static void processBlock(std::span<const uint8_t> subBuf, TapeEdges& wave)
 {
 	writeSilence(wave, 1200);
 	writeBit(wave, true);
@@ -287,6 +303,7 @@ CasImage::Data CasImage::init(const Filename& filename, FilePool& filePool, CliC
 		}
 	}();
 	setFirstFileType(fileType, filename);
+	setBlocks(std::move(result.blocks));
 
 	// conversion successful, now calc sha1sum
 	setSha1Sum(filePool.getSha1Sum(file, filename.getResolved()));
@@ -303,7 +320,7 @@ int16_t CasImage::getSampleAt(EmuTime time) const
 {
 	EmuDuration d = time - EmuTime::zero();
 	unsigned pos = d.getTicksAt(data.frequency);
-	return narrow<int16_t>((pos < data.wave.size()) ? (data.wave[pos] * 256) : 0);
+	return int16_t(data.wave.getLevel(pos) * 256);
 }
 
 EmuTime CasImage::getEndTime() const
@@ -319,14 +336,8 @@ unsigned CasImage::getFrequency() const
 
 void CasImage::fillBuffer(unsigned pos, std::span<float*, 1> bufs, unsigned num) const
 {
-	size_t nbSamples = data.wave.size();
-	if ((pos / AUDIO_OVERSAMPLE) < nbSamples) {
-		for (auto i : xrange(num)) {
-			bufs[0][i] = ((pos / AUDIO_OVERSAMPLE) < nbSamples)
-			           ? narrow_cast<float>(data.wave[pos / AUDIO_OVERSAMPLE])
-			           : 0.0f;
-			++pos;
-		}
+	if ((pos / AUDIO_OVERSAMPLE) < data.wave.size()) {
+		data.wave.fill(pos, std::span{bufs[0], num}, AUDIO_OVERSAMPLE);
 	} else {
 		bufs[0] = nullptr;
 	}
@@ -2,6 +2,8 @@
 #define CASIMAGE_HH
 
 #include "CassetteImage.hh"
+#include "TapeEdges.hh"
+
 #include <cstdint>
 #include <vector>
 
@@ -27,7 +29,8 @@ public:
 	[[nodiscard]] float getAmplificationFactorImpl() const override;
 
 	struct Data {
-		std::vector<int8_t> wave;
+		TapeEdges wave;
+		std::vector<Block> blocks;
 		unsigned frequency;
 	};
 
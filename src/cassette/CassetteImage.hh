@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <span>
 #include <string>
+#include <vector>
 
 namespace openmsx {
 
@@ -17,6 +18,18 @@ class CassetteImage
 public:
 	enum class FileType : uint8_t { ASCII, BINARY, BASIC, UNKNOWN };
 
+	/** A block in the standard MSX tape format, as read by the BIOS
+	  * routines TAPION (the sync tone) and TAPIN (the data bytes).
+	  * Positions are relative to the start of the tape (like the 'time'
+	  * parameter of getSampleAt()).
+	  */
+	struct Block {
+		EmuTime headerStart; // start of the sync tone
+		EmuTime dataStart;   // start of the first data byte
+		std::vector<uint8_t> data;
+		std::vector<EmuTime> byteEnd; // for each data byte: end of that byte
+	};
+
 	virtual ~CassetteImage() = default;
 	[[nodiscard]] virtual int16_t getSampleAt(EmuTime time) const = 0;
 	[[nodiscard]] virtual EmuTime getEndTime() const = 0;
@@ -36,16 +49,24 @@ public:
 	 */
 	[[nodiscard]] const Sha1Sum& getSha1Sum() const;
 
+	/** The blocks in this image (sorted on position) that are in the
+	  * standard MSX format. Empty when unknown (e.g. for WAV images).
+	  * Blocks in custom (turbo) formats are not included.
+	  */
+	[[nodiscard]] std::span<const Block> getBlocks() const { return blocks; }
+
 protected:
 	CassetteImage() = default;
 	// Please make sure this method is called from the constructor of each
 	// subclass! (And only from there.)
 	void setFirstFileType(FileType type, const Filename& fileName);
 	void setSha1Sum(const Sha1Sum& sha1sum);
+	void setBlocks(std::vector<Block> blocks_) { blocks = std::move(blocks_); }
 
 private:
 	FileType firstFileType = FileType::UNKNOWN;
 	Sha1Sum sha1sum;
+	std::vector<Block> blocks;
 };
 
 } // namespace openmsx
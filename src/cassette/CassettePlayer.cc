@@ -262,6 +262,40 @@ void CassettePlayer::setTapePos(EmuTime time, double newPos)
 	wind(time);
 }
 
+bool CassettePlayer::biosTapion(EmuTime time)
+{
+	if (getState() != State::PLAY) return false;
+	sync(time);
+
+	// Like the BIOS: skip to the data of the next block whose sync tone
+	// hasn't been (completely) passed yet.
+	auto blocks = playImage->getBlocks();
+	auto it = std::ranges::upper_bound(blocks, tapePos, {}, &CassetteImage::Block::dataStart);
+	if (it == blocks.end()) return false;
+	tapePos = it->dataStart;
+	updateLoadingState(time);
+	return true;
+}
+
+std::optional<uint8_t> CassettePlayer::biosTapin(EmuTime time)
+{
+	if (getState() != State::PLAY) return {};
+	sync(time);
+
+	// The tape may have rolled a bit since the previous byte (the motor
+	// is on while the BIOS routines run), so take the first byte that
+	// didn't end yet in the block that contains the current position.
+	auto blocks = playImage->getBlocks();
+	auto it = std::ranges::upper_bound(blocks, tapePos, {}, &CassetteImage::Block::dataStart);
+	if (it == blocks.begin()) return {};
+	const auto& block = *--it;
+	auto b = std::ranges::upper_bound(block.byteEnd, tapePos);
+	if (b == block.byteEnd.end()) return {};
+	tapePos = *b;
+	updateLoadingState(time);
+	return block.data[std::distance(block.byteEnd.begin(), b)];
+}
+
 double CassettePlayer::getTapeLength(EmuTime time)
 {
 	if (playImage) {
@@ -641,8 +675,12 @@ void CassettePlayer::generateChannels(std::span<float*> buffers, unsigned num)
 		buffers[0] = nullptr;
 		return;
 	}
-	assert(buffers.size() == 1);
-	playImage->fillBuffer(audioPos, buffers.first<1>(), num);
+	if (isChannelUsed(0)) {
+		playImage->fillBuffer(audioPos, buffers.first<1>(), num);
+	} else {
+		// nobody listens, don't generate the waveform
+		buffers[0] = nullptr;
+	}
 	audioPos += num;
 }
 
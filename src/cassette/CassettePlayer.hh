@@ -18,6 +18,7 @@
 #include <array>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace openmsx {
@@ -76,6 +77,18 @@ public:
 	  * continuously). */
 	double getTapeLength(EmuTime time);
 
+	/** Support for instant loading via the BIOS tape routines, only
+	  * possible for blocks in the standard MSX format (see
+	  * CassetteImage::getBlocks()). When these return false/nullopt the
+	  * caller should let the BIOS read the waveform instead.
+	  *  biosTapion(): like TAPION, wind the tape to the data of the next
+	  *                block.
+	  *  biosTapin():  like TAPIN, returns the data byte at the current
+	  *                tape position and winds the tape past it.
+	  */
+	bool biosTapion(EmuTime time);
+	std::optional<uint8_t> biosTapin(EmuTime time);
+
 	friend class CassettePlayerCommand;
 
 private:
@@ -78,6 +78,16 @@ void CassettePlayerCommand::execute(
 			throw SyntaxError();
 		}
 
+	} else if (tokens[1] == "bios" && tokens.size() == 3) {
+		if (tokens[2] == "tapion") {
+			result = cassettePlayer->biosTapion(time);
+		} else if (tokens[2] == "tapin") {
+			auto value = cassettePlayer->biosTapin(time);
+			result = value ? int(*value) : -1;
+		} else {
+			throw SyntaxError();
+		}
+
 	} else if (tokens[1] == "setpos" && tokens.size() == 3) {
 		stopRecording();
 		cassettePlayer->setTapePos(time, tokens[2].getDouble(getInterpreter()));
@@ -187,6 +197,22 @@ std::string CassettePlayerCommand::help(std::span<const TclObject> tokens) const
 		} else if (tokens[1] == "getlength") {
 			helpText =
 			    "Return the length of the tape in seconds.";
+		} else if (tokens[1] == "bios") {
+			helpText =
+			    "Support for instant loading of CAS and TSX images, "
+			    "meant to be called from breakpoints on the BIOS "
+			    "tape routines (see the 'cassette_instant_load' "
+			    "setting).\n"
+			    "'cassetteplayer bios tapion' winds the tape to the "
+			    "data of the next block and returns 1, or returns 0 "
+			    "if there is no such block in the standard MSX "
+			    "format.\n"
+			    "'cassetteplayer bios tapin' returns the data byte "
+			    "at the current tape position (and winds past it), "
+			    "or -1 if the tape is not positioned in a block in "
+			    "the standard MSX format.\n"
+			    "In both cases the BIOS should read the waveform "
+			    "itself when this fails.";
 		}
 	} else {
 		helpText =
@@ -210,6 +236,8 @@ std::string CassettePlayerCommand::help(std::span<const TclObject> tokens) const
 		    ": wind the tape to the given position\n"
 		    "cassetteplayer getlength         "
 		    ": query the total length of the tape\n"
+		    "cassetteplayer bios tapion|tapin "
+		    ": used for instant loading, see 'help cassetteplayer bios'\n"
 		    "cassetteplayer <filename>        "
 		    ": insert (a different) tape file\n";
 	}
@@ -222,7 +250,7 @@ void CassettePlayerCommand::tabCompletion(std::vector<std::string>& tokens) cons
 	if (tokens.size() == 2) {
 		static constexpr std::array cmds = {
 			"eject"sv, "rewind"sv, "motorcontrol"sv, "insert"sv, "new"sv,
-			"play"sv, "getpos"sv, "setpos"sv, "getlength"sv,
+			"play"sv, "getpos"sv, "setpos"sv, "getlength"sv, "bios"sv,
 			//"record"sv,
 		};
 		completeFileName(tokens, userFileContext(), cmds);
@@ -231,12 +259,16 @@ void CassettePlayerCommand::tabCompletion(std::vector<std::string>& tokens) cons
 	} else if ((tokens.size() == 3) && (tokens[1] == "motorcontrol")) {
 		static constexpr std::array extra = {"on"sv, "off"sv};
 		completeString(tokens, extra);
+	} else if ((tokens.size() == 3) && (tokens[1] == "bios")) {
+		static constexpr std::array extra = {"tapion"sv, "tapin"sv};
+		completeString(tokens, extra);
 	}
 }
 
 bool CassettePlayerCommand::needRecord(std::span<const TclObject> tokens) const
 {
-	return tokens.size() > 1;
+	// 'bios' is executed from breakpoints, so it's already deterministic
+	return (tokens.size() > 1) && (tokens[1] != "bios");
 }
 
 } // namespace openmsx
@@ -0,0 +1,59 @@
+#include "TapeEdges.hh"
+
+#include "narrow.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace openmsx {
+
+void TapeEdges::append(size_t count, int8_t level)
+{
+	if (count == 0) return;
+	if (edges.empty() || (edges.back().level != level)) {
+		edges.push_back(Edge{narrow<uint32_t>(length), level});
+	}
+	length += count;
+}
+
+size_t TapeEdges::findEdge(size_t pos) const
+{
+	assert(pos < length);
+	auto inEdge = [&](size_t i) {
+		return (edges[i].start <= pos) && (pos < edgeEnd(i));
+	};
+	if (lastEdge < edges.size()) {
+		if (inEdge(lastEdge)) return lastEdge;
+		if ((lastEdge + 1 < edges.size()) && inEdge(lastEdge + 1)) {
+			return ++lastEdge;
+		}
+	}
+	auto it = std::ranges::upper_bound(edges, pos, {}, &Edge::start);
+	assert(it != edges.begin());
+	lastEdge = std::distance(edges.begin(), it) - 1;
+	return lastEdge;
+}
+
+int8_t TapeEdges::getLevel(size_t pos) const
+{
+	if (pos >= length) return 0;
+	return edges[findEdge(pos)].level;
+}
+
+void TapeEdges::fill(size_t pos, std::span<float> out, unsigned oversample) const
+{
+	size_t end = length * oversample;
+	if (pos < end) {
+		auto i = findEdge(pos / oversample);
+		while (!out.empty() && (pos < end)) {
+			auto num = std::min(edgeEnd(i) * oversample - pos, out.size());
+			std::ranges::fill(out.first(num), float(edges[i].level));
+			out = out.subspan(num);
+			pos += num;
+			++i;
+		}
+	}
+	std::ranges::fill(out, 0.0f);
+}
+
+} // namespace openmsx
@@ -0,0 +1,59 @@
+#ifndef TAPEEDGES_HH
+#define TAPEEDGES_HH
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace openmsx {
+
+/** The waveform of a generated tape signal (CAS and TSX images).
+  *
+  * Such a signal is a square wave: it only consists of stretches of a
+  * constant level. Instead of storing every sample, only the positions where
+  * the level changes (the edges) are stored. Positions are sample numbers
+  * (at the sample rate of the image).
+  *
+  * The level at some position is found with a binary search, though
+  * typically the tape is read sequentially and then the previously found
+  * edge (or the next one) is used directly.
+  */
+class TapeEdges
+{
+public:
+	/** Append 'count' samples with the given level. */
+	void append(size_t count, int8_t level);
+
+	/** Length of the signal (in samples). */
+	[[nodiscard]] size_t size() const { return length; }
+
+	/** Number of stretches with a constant level. */
+	[[nodiscard]] size_t numEdges() const { return edges.size(); }
+
+	/** The level at the given position, 0 past the end. */
+	[[nodiscard]] int8_t getLevel(size_t pos) const;
+
+	/** Fill the buffer with the signal, starting at position 'pos'. Each
+	  * sample is repeated 'oversample' times (also 'pos' is expressed in
+	  * these oversampled units). Past the end the signal is 0. */
+	void fill(size_t pos, std::span<float> out, unsigned oversample = 1) const;
+
+private:
+	[[nodiscard]] size_t findEdge(size_t pos) const;
+	[[nodiscard]] size_t edgeEnd(size_t i) const {
+		return (i + 1 < edges.size()) ? edges[i + 1].start : length;
+	}
+
+private:
+	struct Edge {
+		uint32_t start;
+		int8_t level;
+	};
+	std::vector<Edge> edges; // sorted on 'start', first starts at 0
+	size_t length = 0;
+	mutable size_t lastEdge = 0; // speeds up sequential lookups
+};
+
+} // namespace openmsx
+
+#endif
@@ -13,7 +13,9 @@
 #include "Filename.hh"
 #include "MSXException.hh"
 
-#include "xrange.hh"
+#include "stl.hh"
+
+#include <ranges>
 
 namespace openmsx {
 
@@ -26,6 +28,20 @@ TsxImage::TsxImage(const Filename& filename, FilePool& filePool, CliComm& cliCom
 		// Move the parsed waveform here
 		output = std::move(parser.stealOutput());
 
+		// Translate sample numbers to tape positions
+		auto toTime = [](size_t sample) {
+			Clock<TsxParser::OUTPUT_FREQUENCY> clk(EmuTime::zero());
+			clk += unsigned(sample);
+			return clk.getTime();
+		};
+		auto msxBlocks = parser.stealMsxBlocks();
+		setBlocks(to_vector(std::views::transform(msxBlocks, [&](auto& b) {
+			return Block{.headerStart = toTime(b.headerStart),
+			             .dataStart = toTime(b.dataStart),
+			             .data = std::move(b.data),
+			             .byteEnd = to_vector(std::views::transform(b.byteEnd, toTime))};
+		})));
+
 		// Translate the TsxReader-filetype to a CassetteImage-filetype
 		if (auto type = parser.getFirstFileType()) {
 			setFirstFileType([&] {
@@ -54,7 +70,7 @@ int16_t TsxImage::getSampleAt(EmuTime time) const
 {
 	static const Clock<TsxParser::OUTPUT_FREQUENCY> zero(EmuTime::zero());
 	unsigned pos = zero.getTicksTill(time);
-	return pos < output.size() ? output[pos] * 256 : 0;
+	return int16_t(output.getLevel(pos) * 256);
 }
 
 EmuTime TsxImage::getEndTime() const
@@ -71,14 +87,8 @@ unsigned TsxImage::getFrequency() const
 
 void TsxImage::fillBuffer(unsigned pos, std::span<float*, 1> bufs, unsigned num) const
 {
-	size_t nbSamples = output.size();
-	if (pos < nbSamples) {
-		for (auto i : xrange(num)) {
-			bufs[0][i] = (pos < nbSamples)
-			           ? output[pos]
-			           : 0;
-			++pos;
-		}
+	if (pos < output.size()) {
+		output.fill(pos, std::span{bufs[0], num});
 	} else {
 		bufs[0] = nullptr;
 	}
@@ -6,7 +6,7 @@
 #define TSXIMAGE_HH
 
 #include "CassetteImage.hh"
-#include <vector>
+#include "TapeEdges.hh"
 
 namespace openmsx {
 
@@ -27,7 +27,7 @@ public:
 	[[nodiscard]] float getAmplificationFactorImpl() const override;
 
 private:
-	/*const*/ std::vector<signed char> output;
+	/*const*/ TapeEdges output;
 };
 
 } // namespace openmsx
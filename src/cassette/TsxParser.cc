@@ -130,7 +130,7 @@ TsxParser::TsxParser(std::span<const uint8_t> file)
 void TsxParser::writeSample(uint32_t tStates, int8_t value)
 {
 	accumBytes += tStates2samples(float(tStates));
-	output.insert(end(output), int(accumBytes), value);
+	output.append(size_t(accumBytes), value);
 	accumBytes -= float(int(accumBytes));
 }
 
@@ -148,7 +148,7 @@ void TsxParser::writePulses(uint32_t count, uint32_t tStates)
 void TsxParser::writeSilence(int ms)
 {
 	if (!ms) return;
-	output.insert(end(output), OUTPUT_FREQUENCY * ms / 1000, 0);
+	output.append(OUTPUT_FREQUENCY * ms / 1000, 0);
 	currentValue = 127;
 }
 
@@ -335,8 +335,16 @@ void TsxParser::processBlock4B(const Block4B& b)
 		error(strCat("Invalid block #4B: unsupported byte-cfg: ", hex_string<2>(b.byteCfg)));
 	}
 
+	// Only blocks in the standard MSX format can be read by the BIOS.
+	bool msxFormat = (numZeroPulses == 2) && (numOnePulses == 4) &&
+	                 (numStartBits == 1) && !startBitVal &&
+	                 (numStopBits == 2) && stopBitVal && !msb;
+	MsxBlock msxBlock;
+	msxBlock.headerStart = output.size();
+
 	// write a header signal
 	writePulses(b.pulses, pulsePilot);
+	msxBlock.dataStart = output.size();
 
 	// write KCS bytes
 	auto write_01 = [&](bool bit) {
@@ -360,7 +368,12 @@ void TsxParser::processBlock4B(const Block4B& b)
 		}
 		// stop bit(s)
 		write_N_01(numStopBits, stopBitVal);
+		if (msxFormat) {
+			msxBlock.data.push_back(d);
+			msxBlock.byteEnd.push_back(output.size());
+		}
 	}
+	if (msxFormat) msxBlocks.push_back(std::move(msxBlock));
 	writeSilence(b.pauseMs);
 }
 
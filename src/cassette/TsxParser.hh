@@ -5,6 +5,8 @@
 #ifndef TSXPARSER_HH
 #define TSXPARSER_HH
 
+#include "TapeEdges.hh"
+
 #include "endian.hh"
 
 #include <array>
@@ -25,10 +27,20 @@ public:
 		ASCII, BINARY, BASIC, UNKNOWN,
 	};
 
+	// A block in the standard MSX format (see CassetteImage::Block),
+	// positions are sample numbers in the output.
+	struct MsxBlock {
+		size_t headerStart;
+		size_t dataStart;
+		std::vector<uint8_t> data;
+		std::vector<size_t> byteEnd;
+	};
+
 public:
 	explicit TsxParser(std::span<const uint8_t> file);
 
-	[[nodiscard]] std::vector<int8_t>&& stealOutput() { return std::move(output); }
+	[[nodiscard]] openmsx::TapeEdges&& stealOutput() { return std::move(output); }
+	[[nodiscard]] std::vector<MsxBlock>&& stealMsxBlocks() { return std::move(msxBlocks); }
 	[[nodiscard]] std::optional<FileType> getFirstFileType() const { return firstFileType; }
 	[[nodiscard]] const std::vector<std::string>& getMessages() const { return messages; }
 
@@ -122,7 +134,8 @@ private:
 
 private:
 	// The parsed result is stored here
-	std::vector<int8_t> output;
+	openmsx::TapeEdges output;
+	std::vector<MsxBlock> msxBlocks;
 	std::vector<std::string> messages;
 	std::optional<FileType> firstFileType;
 
@@ -3,6 +3,8 @@
 #include "File.hh"
 #include "FilePool.hh"
 #include "Filename.hh"
+#include "MappedFile.hh"
+#include "WavData.hh"
 
 #include "Math.hh"
 #include "narrow.hh"
@@ -12,6 +14,7 @@
 #include <array>
 #include <cassert>
 #include <map>
+#include <vector>
 
 namespace openmsx {
 
@@ -30,19 +33,26 @@ public:
 		t0 = t1;
 		return y;
 	}
+	[[nodiscard]] float getState() const { return t0; }
+	void setState(float state) { t0 = state; }
 private:
 	float R = 0.0f;
 	float t0 = 0.0f;
 };
 
 
+struct WavStream {
+	MappedFile<const uint8_t> mmap;
+	WavData::Raw raw; // points into 'mmap'
+	Sha1Sum sum;
+	// The state of the DC-filter at the start of each chunk, it's only
+	// known up to the furthest chunk that has been decoded so far.
+	std::vector<float> checkpoints = {0.0f};
+};
+
 class WavImageCache
 {
 public:
-	struct WavInfo {
-		WavData wav;
-		Sha1Sum sum;
-	};
 
 	WavImageCache(const WavImageCache&) = delete;
 	WavImageCache(WavImageCache&&) = delete;
@@ -50,8 +60,8 @@ public:
 	WavImageCache& operator=(WavImageCache&&) = delete;
 
 	static WavImageCache& instance();
-	const WavInfo& get(const std::string& filename, FilePool& filePool);
-	void release(const WavData* wav);
+	WavStream& get(const std::string& filename, FilePool& filePool);
+	void release(const WavStream* stream);
 
 private:
 	WavImageCache() = default;
@@ -60,7 +70,7 @@ private:
 	// typically contains very few elements, but values need stable addresses
 	struct Entry {
 		unsigned refCount = 0;
-		WavInfo info;
+		WavStream stream;
 	};
 	std::map<std::string, Entry, std::less<>> cache;
 };
@@ -76,7 +86,7 @@ WavImageCache& WavImageCache::instance()
 	return wavImageCache;
 }
 
-const WavImageCache::WavInfo& WavImageCache::get(const std::string& filename, FilePool& filePool)
+WavStream& WavImageCache::get(const std::string& filename, FilePool& filePool)
 {
 	// Reading file or parsing as .wav may throw, so only create cache
 	// entry after all went well.
@@ -84,20 +94,20 @@ const WavImageCache::WavInfo& WavImageCache::get(const std::string& filename, Fi
 	if (it == cache.end()) {
 		File file(filename);
 		Entry entry;
-		entry.info.sum = filePool.getSha1Sum(file, filename);
-		entry.info.wav = WavData(std::move(file), DCFilter{});
+		entry.stream.sum = filePool.getSha1Sum(file, filename);
+		entry.stream.mmap = file.mmap<const uint8_t>();
+		entry.stream.raw = WavData::parse(entry.stream.mmap);
 		it = cache.try_emplace(filename, std::move(entry)).first;
 	}
 	auto& entry = it->second;
 	++entry.refCount;
-	return entry.info;
-
+	return entry.stream;
 }
 
-void WavImageCache::release(const WavData* wav)
+void WavImageCache::release(const WavStream* stream)
 {
 	// cache contains very few entries, so linear search is ok
-	auto it = std::ranges::find(cache, wav, [](auto& pr) { return &pr.second.info.wav; });
+	auto it = std::ranges::find(cache, stream, [](auto& pr) { return &pr.second.stream; });
 	assert(it != end(cache));
 	auto& entry = it->second;
 	--entry.refCount; // decrease reference count
@@ -109,17 +119,63 @@ void WavImageCache::release(const WavData* wav)
 
 WavImage::WavImage(const Filename& filename, FilePool& filePool)
 {
-	const auto& entry = WavImageCache::instance().get(filename.getResolved(), filePool);
-	wav = &entry.wav;
-	setSha1Sum(entry.sum);
-	clock.setFreq(wav->getFreq());
+	stream = &WavImageCache::instance().get(filename.getResolved(), filePool);
+	setSha1Sum(stream->sum);
+	clock.setFreq(stream->raw.freq);
 	// Note: type detection not implemented yet for WAV images
 	setFirstFileType(FileType::UNKNOWN, filename);
 }
 
 WavImage::~WavImage()
 {
-	WavImageCache::instance().release(wav);
+	WavImageCache::instance().release(stream);
+}
+
+std::span<const int16_t> WavImage::getChunk(size_t chunk) const
+{
+	for (auto i : xrange(chunks.size())) {
+		if (chunks[i].index == chunk) {
+			lastUsed = unsigned(i);
+			return chunks[i].samples;
+		}
+	}
+
+	const auto& raw = stream->raw;
+	auto decode = [&](size_t c, std::span<int16_t, CHUNK_SIZE> out) {
+		DCFilter filter;
+		filter.setFreq(raw.freq);
+		filter.setState(stream->checkpoints[c]);
+		auto first = c * CHUNK_SIZE;
+		auto num = std::min(CHUNK_SIZE, raw.length - first);
+		raw.convert(first, out.first(num), filter);
+		std::ranges::fill(out.subspan(num), 0);
+		return filter.getState();
+	};
+
+	// The filter state at the start of this chunk depends on all earlier
+	// samples. The first time a chunk is reached, the filter is run over
+	// all (not yet visited) preceding chunks. That's needed only once per
+	// file, later (e.g. after rewinding) it restarts from a checkpoint.
+	auto& checkpoints = stream->checkpoints;
+	std::array<int16_t, CHUNK_SIZE> dummy;
+	while (checkpoints.size() <= chunk) {
+		checkpoints.push_back(decode(checkpoints.size() - 1, dummy));
+	}
+
+	lastUsed ^= 1; // replace the least recently used chunk
+	auto& c = chunks[lastUsed];
+	auto endState = decode(chunk, c.samples);
+	c.index = chunk;
+	if (checkpoints.size() == chunk + 1) {
+		checkpoints.push_back(endState);
+	}
+	return c.samples;
+}
+
+int16_t WavImage::getSample(size_t pos) const
+{
+	if (pos >= stream->raw.length) return 0;
+	return getChunk(pos / CHUNK_SIZE)[pos % CHUNK_SIZE];
 }
 
 int16_t WavImage::getSampleAt(EmuTime time) const
@@ -136,10 +192,10 @@ int16_t WavImage::getSampleAt(EmuTime time) const
 	// work in openMSX (with sample-and-hold it didn't work).
 	auto [sample, x] = clock.getTicksTillAsIntFloat(time);
 	std::array<float, 4> p = {
-		float(wav->getSample(sample - 1)), // intentional: underflow wraps to UINT_MAX
-		float(wav->getSample(sample + 0)),
-		float(wav->getSample(sample + 1)),
-		float(wav->getSample(sample + 2))
+		float(getSample(sample - 1)), // intentional: underflow wraps to UINT_MAX
+		float(getSample(sample + 0)),
+		float(getSample(sample + 1)),
+		float(getSample(sample + 2))
 	};
 	return Math::clipToInt16(int(Math::cubicHermite(p, x)));
 }
@@ -147,7 +203,7 @@ int16_t WavImage::getSampleAt(EmuTime time) const
 EmuTime WavImage::getEndTime() const
 {
 	DynamicClock clk(clock);
-	clk += wav->getSize();
+	clk += stream->raw.length;
 	return clk.getTime();
 }
 
@@ -158,9 +214,9 @@ unsigned WavImage::getFrequency() const
 
 void WavImage::fillBuffer(unsigned pos, std::span<float*, 1> bufs, unsigned num) const
 {
-	if (pos < wav->getSize()) {
+	if (pos < stream->raw.length) {
 		for (auto i : xrange(num)) {
-			bufs[0][i] = wav->getSample(pos + i);
+			bufs[0][i] = getSample(pos + i);
 		}
 	} else {
 		bufs[0] = nullptr;
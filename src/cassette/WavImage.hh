@@ -4,14 +4,22 @@
 #include "CassetteImage.hh"
 
 #include "DynamicClock.hh"
-#include "WavData.hh"
 
+#include <array>
 #include <cstdint>
+#include <span>
 
 namespace openmsx {
 
 class Filename;
 class FilePool;
+struct WavStream;
+
+/** A .wav file is not decoded as a whole. The file is memory-mapped, and
+  * only the chunks of samples that are actually played are decoded (and
+  * passed through the DC-removal filter). A small cache holds the most
+  * recently decoded chunks.
+  */
 
 class WavImage final : public CassetteImage
 {
@@ -30,8 +38,21 @@ public:
 	[[nodiscard]] float getAmplificationFactorImpl() const override;
 
 private:
-	const WavData* wav;
+	[[nodiscard]] int16_t getSample(size_t pos) const;
+	[[nodiscard]] std::span<const int16_t> getChunk(size_t chunk) const;
+
+private:
+	static constexpr size_t CHUNK_SIZE = 4096; // in samples
+
+	WavStream* stream;
 	DynamicClock clock{EmuTime::zero()};
+
+	struct Chunk {
+		size_t index = size_t(-1);
+		std::array<int16_t, CHUNK_SIZE> samples;
+	};
+	mutable std::array<Chunk, 2> chunks;
+	mutable unsigned lastUsed = 0;
 };
 
 } // namespace openmsx
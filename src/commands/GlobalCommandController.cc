@@ -2,8 +2,10 @@
 
 #include "CliConnection.hh"
 #include "CommandException.hh"
+#include "Debugger.hh"
 #include "GlobalCliComm.hh"
 #include "LocalFileReference.hh"
+#include "MSXMotherBoard.hh"
 #include "ProxyCommand.hh"
 #include "ProxySetting.hh"
 #include "Reactor.hh"
@@ -40,6 +42,8 @@ GlobalCommandController::GlobalCommandController(
 	, helpCmd(*this)
 	, tabCompletionCmd(*this)
 	, updateCmd(*this)
+	, streamCmd(*this)
+	, protocolCmd(*this)
 	, platformInfo(getOpenMSXInfoCommand())
 	, versionInfo (getOpenMSXInfoCommand())
 	, romInfoTopic(getOpenMSXInfoCommand())
@@ -588,6 +592,120 @@ void GlobalCommandController::UpdateCmd::tabCompletion(std::vector<std::string>&
 }
 
 
+// class StreamCmd
+
+GlobalCommandController::StreamCmd::StreamCmd(CommandController& commandController_)
+	: Command(commandController_, "openmsx_stream")
+{
+}
+
+CliConnection& GlobalCommandController::StreamCmd::getConnection()
+{
+	const auto& controller = OUTER(GlobalCommandController, streamCmd);
+	if (auto* c = controller.getConnection()) {
+		return *c;
+	}
+	throw CommandException("This command only makes sense when "
+	                       "it's used from an external application.");
+}
+
+void GlobalCommandController::StreamCmd::execute(
+	std::span<const TclObject> tokens, TclObject& result)
+{
+	checkNumArgs(tokens, AtLeast{2}, "subcommand ?arg ...?");
+	auto& connection = getConnection();
+	if (tokens[1] == "subscribe") {
+		checkNumArgs(tokens, Between{3, 4}, Prefix{2}, "debuggable ?frames?");
+		auto name = tokens[2].getString();
+		const auto& controller = OUTER(GlobalCommandController, streamCmd);
+		if (auto* motherBoard = controller.getReactor().getMotherBoard();
+		    motherBoard && !motherBoard->getDebugger().findDebuggable(name)) {
+			throw CommandException("No such debuggable: ", name);
+		}
+		int interval = (tokens.size() == 4) ? tokens[3].getInt(getInterpreter()) : 1;
+		if (interval <= 0) {
+			throw CommandException("Interval must be at least one frame");
+		}
+		connection.subscribeStream(name, unsigned(interval));
+	} else if (tokens[1] == "unsubscribe") {
+		checkNumArgs(tokens, 3, Prefix{2}, "debuggable");
+		if (!connection.unsubscribeStream(tokens[2].getString())) {
+			throw CommandException("Not subscribed to: ", tokens[2].getString());
+		}
+	} else if (tokens[1] == "list") {
+		checkNumArgs(tokens, 2, Prefix{2}, nullptr);
+		for (const auto& s : connection.getStreams()) {
+			result.addListElement(s.debuggable, s.interval);
+		}
+	} else {
+		throw SyntaxError();
+	}
+}
+
+std::string GlobalCommandController::StreamCmd::help(std::span<const TclObject> /*tokens*/) const
+{
+	return "Periodically send the content of debuggables to an external application.\n"
+	       "  openmsx_stream subscribe <debuggable> [<frames>]  send every <frames> frames (default 1)\n"
+	       "  openmsx_stream unsubscribe <debuggable>           stop sending this debuggable\n"
+	       "  openmsx_stream list                               list debuggables and intervals\n"
+	       "The data is sent in binary form, see doc/manual/openmsx-control.html.";
+}
+
+void GlobalCommandController::StreamCmd::tabCompletion(std::vector<std::string>& tokens) const
+{
+	switch (tokens.size()) {
+	case 2: {
+		using namespace std::literals;
+		static constexpr std::array ops = {"subscribe"sv, "unsubscribe"sv, "list"sv};
+		completeString(tokens, ops);
+		break;
+	}
+	case 3: {
+		const auto& controller = OUTER(GlobalCommandController, streamCmd);
+		if (auto* motherBoard = controller.getReactor().getMotherBoard()) {
+			completeString(tokens, std::views::keys(motherBoard->getDebugger().getDebuggables()));
+		}
+		break;
+	}
+	}
+}
+
+
+// class ProtocolCmd
+
+GlobalCommandController::ProtocolCmd::ProtocolCmd(CommandController& commandController_)
+	: Command(commandController_, "openmsx_protocol")
+{
+}
+
+void GlobalCommandController::ProtocolCmd::execute(
+	std::span<const TclObject> tokens, TclObject& /*result*/)
+{
+	checkNumArgs(tokens, 2, "binary");
+	if (tokens[1] != "binary") throw SyntaxError();
+	const auto& controller = OUTER(GlobalCommandController, protocolCmd);
+	auto* connection = controller.getConnection();
+	if (!connection) {
+		throw CommandException("This command only makes sense when "
+		                       "it's used from an external application.");
+	}
+	connection->switchToBinaryProtocol();
+}
+
+std::string GlobalCommandController::ProtocolCmd::help(std::span<const TclObject> /*tokens*/) const
+{
+	return "Switch the connection of an external application to the binary protocol, "
+	       "see doc/manual/openmsx-control.html.";
+}
+
+void GlobalCommandController::ProtocolCmd::tabCompletion(std::vector<std::string>& tokens) const
+{
+	using namespace std::literals;
+	static constexpr std::array ops = {"binary"sv};
+	completeString(tokens, ops);
+}
+
+
 // Platform info
 
 GlobalCommandController::PlatformInfo::PlatformInfo(InfoCommand& openMSXInfoCommand_)
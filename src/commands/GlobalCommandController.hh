@@ -138,6 +138,22 @@ private:
 		CliConnection& getConnection();
 	} updateCmd;
 
+	struct StreamCmd final : Command {
+		explicit StreamCmd(CommandController& commandController);
+		void execute(std::span<const TclObject> tokens, TclObject& result) override;
+		[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
+		void tabCompletion(std::vector<std::string>& tokens) const override;
+	private:
+		CliConnection& getConnection();
+	} streamCmd;
+
+	struct ProtocolCmd final : Command {
+		explicit ProtocolCmd(CommandController& commandController);
+		void execute(std::span<const TclObject> tokens, TclObject& result) override;
+		[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
+		void tabCompletion(std::vector<std::string>& tokens) const override;
+	} protocolCmd;
+
 	struct PlatformInfo final : InfoTopic {
 		explicit PlatformInfo(InfoCommand& openMSXInfoCommand);
 		void execute(std::span<const TclObject> tokens,
@@ -5,6 +5,7 @@
 #include "InterpreterOutput.hh"
 #include "MSXCommandController.hh"
 #include "TclObject.hh"
+#include "TclProfiler.hh"
 
 #include "FileOperations.hh"
 #include "MSXCPUInterface.hh"
@@ -221,6 +222,7 @@ bool Interpreter::isComplete(zstring_view command) const
 
 TclObject Interpreter::execute(zstring_view command)
 {
+	TclProfiler::Scope profile(TclProfiler::Kind::SCRIPT, [&] { return command; });
 	if (Tcl_Eval(interp, command.c_str()) != TCL_OK) {
 		throw CommandException(Tcl_GetStringResult(interp));
 	}
@@ -229,6 +231,7 @@ TclObject Interpreter::execute(zstring_view command)
 
 TclObject Interpreter::executeFile(zstring_view filename)
 {
+	TclProfiler::Scope profile(TclProfiler::Kind::SCRIPT, [&] { return filename; });
 	if (Tcl_EvalFile(interp, filename.c_str()) != TCL_OK) {
 		throw CommandException(Tcl_GetStringResult(interp));
 	}
@@ -273,6 +276,11 @@ void Interpreter::unsetVariable(const char* name)
 	Tcl_UnsetVar(interp, name, TCL_GLOBAL_ONLY);
 }
 
+void Interpreter::unsetVariable(const TclObject& arrayName, const TclObject& arrayIndex)
+{
+	Tcl_UnsetVar2(interp, arrayName.getString().c_str(), arrayIndex.getString().c_str(), TCL_GLOBAL_ONLY);
+}
+
 static TclObject getSafeValue(const BaseSetting& setting)
 {
 	// TODO use c++23 std::optional<T>::or_else()
@@ -42,6 +42,7 @@ public:
 	void setVariable(const TclObject& name, const TclObject& value);
 	void setVariable(const TclObject& arrayName, const TclObject& arrayIndex, const TclObject& value);
 	void unsetVariable(const char* name);
+	void unsetVariable(const TclObject& arrayName, const TclObject& arrayIndex);
 	void registerSetting(BaseSetting& variable);
 	void unregisterSetting(BaseSetting& variable);
 
@@ -3,6 +3,7 @@
 #include "CommandController.hh"
 #include "CommandException.hh"
 #include "GlobalCommandController.hh"
+#include "TclProfiler.hh"
 
 #include "CliComm.hh"
 #include "Reactor.hh"
@@ -87,6 +88,8 @@ TclObject TclCallback::execute(std::string_view arg1, std::string_view arg2) con
 
 TclObject TclCallback::executeCommon(TclObject& command) const
 {
+	TclProfiler::Scope profile(TclProfiler::Kind::CALLBACK,
+		[&] { return getSetting().getFullName(); });
 	try {
 		return command.executeCommand(callbackSetting.getInterpreter());
 	} catch (CommandException& e) {
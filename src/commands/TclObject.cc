@@ -5,6 +5,8 @@
 
 #include "narrow.hh"
 
+#include <array>
+
 namespace openmsx {
 
 [[noreturn]] static void throwException(Tcl_Interp* interp)
@@ -23,6 +25,21 @@ static void unshare(Tcl_Obj*& obj)
 	}
 }
 
+Tcl_Obj* TclObject::getSmallInt(int i)
+{
+	assert(unsigned(i) < NUM_SMALL_INTS);
+	// A Tcl_Obj may only be used in the thread that created it, so one
+	// cache per thread. The cache holds a reference, so these objects are
+	// never freed (on purpose).
+	thread_local std::array<Tcl_Obj*, NUM_SMALL_INTS> cache = {};
+	auto*& o = cache[i];
+	if (!o) [[unlikely]] {
+		o = Tcl_NewIntObj(i);
+		Tcl_IncrRefCount(o);
+	}
+	return o;
+}
+
 void TclObject::addListElement(Tcl_Obj* element)
 {
 	// Although it's theoretically possible that Tcl_ListObjAppendElement()
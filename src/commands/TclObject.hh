@@ -221,12 +221,14 @@ private:
 		return Tcl_NewStringObj(s, int(strlen(s)));
 	}
 	[[nodiscard]] static Tcl_Obj* newObj(bool b) {
-		return Tcl_NewBooleanObj(b);
+		return getSmallInt(b ? 1 : 0);
 	}
 	[[nodiscard]] static Tcl_Obj* newObj(int i) {
+		if (unsigned(i) < NUM_SMALL_INTS) return getSmallInt(i);
 		return Tcl_NewIntObj(i);
 	}
 	[[nodiscard]] static Tcl_Obj* newObj(unsigned u) {
+		if (u < NUM_SMALL_INTS) return getSmallInt(int(u));
 		return Tcl_NewIntObj(narrow_cast<int>(u));
 	}
 	[[nodiscard]] static Tcl_Obj* newObj(int64_t i) {
@@ -288,13 +290,22 @@ private:
 			addListElement(*it);
 		}
 	}
-	template<std::random_access_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+	template<std::forward_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
 	void addListElementsImpl(Iterator first, Sentinel last) {
+		// multi-pass: add all elements at once (grow the list only once)
 		small_buffer<Tcl_Obj*, 128> objv(std::views::transform(std::ranges::subrange(first, last),
 			[](const auto& t) { return newObj(t); }));
 		addListElementsImpl(narrow<int>(objv.size()), objv.data());
 	}
 
+	/** Small integers (e.g. the result of 'debug read', or the elements of
+	  * a list of bytes) are very common. Instead of allocating a new
+	  * Tcl_Obj for each of them, we return a (shared) cached object. This
+	  * is fine because all modifications go through unshare() (or
+	  * assign(), but only on unshared objects). */
+	static constexpr unsigned NUM_SMALL_INTS = 256;
+	[[nodiscard]] static Tcl_Obj* getSmallInt(int i);
+
 	void addListElement(Tcl_Obj* element);
 	void addListElementsImpl(int objc, Tcl_Obj* const* objv);
 	void addListElementsImpl(std::initializer_list<Tcl_Obj*> l);
@@ -0,0 +1,128 @@
+#include "TclProfiler.hh"
+
+#include "Thread.hh"
+
+#include "hash_map.hh"
+#include "xxhash.hh"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+
+namespace openmsx::TclProfiler {
+
+static constexpr size_t MAX_DEPTH = 64;
+static constexpr size_t MAX_NAME_LENGTH = 80;
+
+namespace {
+	struct Open {
+		uint64_t start;
+		uint64_t childDuration;
+		size_t entry; // index in 'entries'
+	};
+
+	struct State {
+		std::vector<Entry> entries;
+		std::array<hash_map<std::string, size_t, XXHasher>, size_t(Kind::NUM)> index;
+		std::array<Open, MAX_DEPTH> open;
+		size_t depth = 0;
+	};
+}
+
+static State& getState()
+{
+	static State state;
+	return state;
+}
+
+[[nodiscard]] static uint64_t now()
+{
+	return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Scripts can be long, only keep (the start of) the first non-empty line.
+[[nodiscard]] static std::string_view shorten(std::string_view name)
+{
+	auto start = name.find_first_not_of(" \t\r\n");
+	if (start == std::string_view::npos) return {};
+	name.remove_prefix(start);
+	if (auto end = name.find_first_of("\r\n"); end != std::string_view::npos) {
+		name = name.substr(0, end);
+	}
+	return name.substr(0, MAX_NAME_LENGTH);
+}
+
+std::string_view getName(Kind kind)
+{
+	switch (kind) {
+		case Kind::SCRIPT:     return "script";
+		case Kind::AFTER:      return "after";
+		case Kind::CALLBACK:   return "callback";
+		case Kind::BREAKPOINT: return "breakpoint";
+		default:               return "?";
+	}
+}
+
+bool detail::begin(Kind kind, std::string_view name)
+{
+	assert(Thread::isMainThread());
+	auto& state = getState();
+	if (state.depth == MAX_DEPTH) [[unlikely]] return false; // deep recursion
+
+	name = shorten(name);
+	auto& index = state.index[size_t(kind)];
+	auto it = index.find(name);
+	if (it == index.end()) {
+		it = index.try_emplace(std::string(name), state.entries.size()).first;
+		state.entries.push_back(Entry{.kind = kind, .name = std::string(name)});
+	}
+	state.open[state.depth++] = Open{now(), 0, it->second};
+	return true;
+}
+
+void detail::end()
+{
+	auto& state = getState();
+	assert(state.depth > 0);
+	const auto& o = state.open[--state.depth];
+	auto duration = now() - o.start;
+	auto& entry = state.entries[o.entry];
+	++entry.count;
+	entry.total += duration;
+	entry.self += duration - std::min(duration, o.childDuration);
+	entry.max = std::max(entry.max, duration);
+	if (state.depth > 0) {
+		state.open[state.depth - 1].childDuration += duration;
+	}
+}
+
+void setEnabled(bool enable)
+{
+	detail::enabled = enable;
+}
+
+void clear()
+{
+	auto& state = getState();
+	// The open scopes still refer to their entries, so only reset those.
+	if (state.depth == 0) {
+		state.entries.clear();
+		for (auto& index : state.index) index.clear();
+	} else {
+		for (auto& e : state.entries) {
+			e.count = e.total = e.self = e.max = 0;
+		}
+	}
+}
+
+std::vector<Entry> getEntries()
+{
+	auto result = getState().entries;
+	std::erase_if(result, [](const Entry& e) { return e.count == 0; });
+	std::ranges::sort(result, std::greater{}, &Entry::total);
+	return result;
+}
+
+} // namespace openmsx::TclProfiler
@@ -0,0 +1,90 @@
+#ifndef TCLPROFILER_HH
+#define TCLPROFILER_HH
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openmsx {
+
+/** Attributes the time spent in Tcl to the script that was executed.
+  *
+  * Tcl is executed from many places: 'after' commands (e.g. the OSD
+  * widgets run from 'after frame'), TclCallback based settings, the
+  * commands and conditions of breakpoints, watchpoints and conditions,
+  * console input, ... Each of these marks the execution with (the lifetime
+  * of) a Scope object, together with a name that identifies the script
+  * (the command itself, the name of the callback setting or the id of the
+  * breakpoint). Per name the number of calls, the total and 'self' time
+  * (the time not spent in nested scopes) and the maximum time are
+  * accumulated until the profile is cleared.
+  *
+  * Profiling is off by default, then a Scope costs a single test (the name
+  * isn't computed). Enable it with the 'tcl_profile' command.
+  *
+  * Only use this from the main thread.
+  */
+namespace TclProfiler {
+
+	enum class Kind : uint8_t {
+		SCRIPT,     // Interpreter::execute(), executeFile()
+		AFTER,      // an 'after' command
+		CALLBACK,   // a TclCallback
+		BREAKPOINT, // the condition and command of a break/watchpoint or condition
+		NUM
+	};
+	[[nodiscard]] std::string_view getName(Kind kind);
+
+	struct Entry {
+		Kind kind;
+		std::string name;
+		uint64_t count = 0;
+		uint64_t total = 0; // in ns
+		uint64_t self = 0;  // in ns
+		uint64_t max = 0;   // in ns
+	};
+
+	namespace detail {
+		inline bool enabled = false;
+		[[nodiscard]] bool begin(Kind kind, std::string_view name);
+		void end();
+	}
+
+	class Scope
+	{
+	public:
+		/** 'getName' returns something convertible to std::string_view,
+		  * it's only called when profiling is enabled. */
+		template<typename GetName>
+		Scope(Kind kind, GetName getName) {
+			if (detail::enabled) [[unlikely]] {
+				active = detail::begin(kind, getName());
+			}
+		}
+		~Scope() {
+			if (active) [[unlikely]] detail::end();
+		}
+
+		Scope(const Scope&) = delete;
+		Scope(Scope&&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		Scope& operator=(Scope&&) = delete;
+
+	private:
+		bool active = false;
+	};
+
+	[[nodiscard]] inline bool isEnabled() { return detail::enabled; }
+	/** Enabling does not clear the collected profile. */
+	void setEnabled(bool enable);
+	void clear();
+
+	/** The collected profile, sorted on decreasing total time. */
+	[[nodiscard]] std::vector<Entry> getEntries();
+
+} // namespace TclProfiler
+
+} // namespace openmsx
+
+#endif
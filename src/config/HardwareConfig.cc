@@ -4,14 +4,20 @@
 #include "CommandController.hh"
 #include "DeviceConfig.hh"
 #include "DeviceFactory.hh"
+#include "FileContext.hh"
+#include "FileException.hh"
 #include "FileOperations.hh"
+#include "FilePool.hh"
 #include "MSXCPUInterface.hh"
 #include "MSXMotherBoard.hh"
+#include "Reactor.hh"
+#include "StartupProfiler.hh"
 #include "TclArgParser.hh"
 #include "XMLException.hh"
 #include "serialize.hh"
 #include "serialize_stl.hh"
 
+#include "strCat.hh"
 #include "xrange.hh"
 
 #include <algorithm>
@@ -19,6 +25,8 @@
 #include <cassert>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 #include <version> // for _LIBCPP_VERSION
 
 namespace openmsx {
@@ -235,10 +243,42 @@ XMLElement& HardwareConfig::getDevicesElem()
 	return getConfig().getChild("devices");
 }
 
-static void loadHelper(XMLDocument& doc, zstring_view filename)
+// Parsed hardware configuration files. Machines often get created with the
+// same configuration (e.g. by the reverse system or when replaying), then only
+// the parsed tree needs to be copied. An entry is re-parsed when the file's
+// modification time or size changes. Only accessed from the main thread.
+struct CachedConfig {
+	std::string filename;
+	time_t modificationTime;
+	size_t size;
+	std::unique_ptr<XMLDocument> doc;
+};
+static std::vector<CachedConfig> configCache;
+
+// Returns the parsed document, from the cache if possible. The reference stays
+// valid till the next call to this function.
+static const XMLDocument& getCachedDocument(zstring_view filename)
 {
 	try {
-		doc.load(filename, "msxconfig2.dtd");
+		auto st = FileOperations::getStat(filename);
+		// (without 'st' the load() below throws a proper error)
+		auto modTime = st ? FileOperations::getModificationDate(*st) : time_t(0);
+		auto size = st ? size_t(st->st_size) : size_t(0);
+		auto it = std::ranges::find(configCache, filename, &CachedConfig::filename);
+		if (!st || (it == configCache.end()) ||
+		    (it->modificationTime != modTime) || (it->size != size)) {
+			auto parsed = std::make_unique<XMLDocument>();
+			parsed->load(filename, "msxconfig2.dtd");
+			if (it == configCache.end()) {
+				it = configCache.emplace(configCache.end(), std::string(filename),
+				                         modTime, size, std::move(parsed));
+			} else {
+				it->modificationTime = modTime;
+				it->size = size;
+				it->doc = std::move(parsed);
+			}
+		}
+		return *it->doc;
 	} catch (XMLException& e) {
 		throw MSXException(
 			"Loading of hardware configuration failed: ",
@@ -265,15 +305,17 @@ static std::string getFilename(std::string_view type, std::string_view name)
 	}
 }
 
-void HardwareConfig::loadConfig(XMLDocument& doc, std::string_view type, std::string_view name)
+const XMLElement& HardwareConfig::getCachedConfig(std::string_view type, std::string_view name)
 {
-	loadHelper(doc, getFilename(type, name));
+	const auto& doc = getCachedDocument(getFilename(type, name));
+	assert(doc.getRoot()); // guaranteed by XMLDocument::load()
+	return *doc.getRoot();
 }
 
 void HardwareConfig::load(std::string_view type_)
 {
 	std::string filename = getFilename(type_, hwName);
-	loadHelper(config, filename);
+	config.load(getCachedDocument(filename));
 
 	assert(!userName.empty());
 	const auto& dirname = FileOperations::getDirName(filename);
@@ -365,8 +407,49 @@ uint8_t HardwareConfig::parseSlotMap() const
 	return initialPrimarySlots;
 }
 
+// Collect the files that Rom::init() will most likely load: the resolved
+// filename of a savestate, or else the first <filename> that exists. ROMs
+// that are located via their sha1sum don't need to be hashed.
+static void collectRomFiles(const XMLElement& elem, const FileContext& context,
+                            std::vector<std::string>& result)
+{
+	for (const auto& c : elem.getChildren()) {
+		if (c.getName() != "rom") {
+			collectRomFiles(c, context, result);
+			continue;
+		}
+		if (c.findChild("firstblock")) continue;
+		if (const auto* resolved = c.findChild("resolvedFilename")) {
+			if (std::string name{resolved->getData()};
+			    FileOperations::isRegularFile(name)) {
+				result.push_back(std::move(name));
+				continue;
+			}
+		}
+		if (c.findChild("resolvedSha1")) continue;
+		for (const auto* f : c.getChildren("filename")) {
+			try {
+				result.push_back(context.resolve(f->getData()));
+				break;
+			} catch (FileException&) {
+				// try next
+			}
+		}
+	}
+}
+
 void HardwareConfig::createDevices()
 {
+	// Devices are created one by one, each ROM device then loads and
+	// hashes its file(s). For machines with many (large) ROMs, first
+	// hash all these files in parallel, then the devices find the sha1sums
+	// in the filepool cache (and the content in the OS file cache).
+	{
+		StartupProfiler::Scope profile("prefetch ROMs");
+		std::vector<std::string> romFiles;
+		collectRomFiles(getDevicesElem(), getFileContext(), romFiles);
+		motherBoard.getReactor().getFilePool().prefetchSha1Sums(romFiles);
+	}
 	createDevices(getDevicesElem(), nullptr, nullptr);
 }
 
@@ -380,6 +463,8 @@ void HardwareConfig::createDevices(XMLElement& elem,
 		} else if (childName == "secondary") {
 			createDevices(c, primary, &c);
 		} else {
+			StartupProfiler::Scope profile(tmpStrCat(
+				"device ", childName, ' ', c.getAttributeValue("id", {})));
 			DeviceConfig config2(*this, c, primary, secondary);
 			auto device = DeviceFactory::create(config2);
 			if (device) {
@@ -29,7 +29,11 @@ public:
 		ROM
 	};
 
-	static void loadConfig(XMLDocument& doc, std::string_view type, std::string_view name);
+	/** Get the (parsed) root element of a machine or extension config
+	  * file, without making a copy. The reference is only valid until the
+	  * next configuration gets loaded.
+	  */
+	[[nodiscard]] static const XMLElement& getCachedConfig(std::string_view type, std::string_view name);
 
 	[[nodiscard]] static std::unique_ptr<HardwareConfig> createMachineConfig(
 		MSXMotherBoard& motherBoard, std::string machineName);
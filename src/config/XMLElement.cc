@@ -369,23 +369,40 @@ void XMLDocument::load(zstring_view filename, std::string_view systemID)
 	} catch (FileException& e) {
 		throw XMLException(filename, ": failed to read: ", e.getMessage());
 	}
+	parse(buf.data(), filename, systemID);
+}
+
+void XMLDocument::load(MemBuffer<char> data, std::string_view name, std::string_view systemID)
+{
+	assert(!root);
+	memBuf = std::move(data);
+	parse(memBuf.data(), name, systemID);
+}
 
+void XMLDocument::load(const XMLDocument& source)
+{
+	assert(!root);
+	if (source.root) root = clone(*source.root);
+}
+
+void XMLDocument::parse(char* data, std::string_view name, std::string_view systemID)
+{
 	XMLDocumentHandler handler(*this);
 	try {
-		rapidsax::parse<rapidsax::zeroTerminateStrings>(handler, buf.data());
+		rapidsax::parse<rapidsax::zeroTerminateStrings>(handler, data);
 	} catch (rapidsax::ParseError& e) {
-		throw XMLException(filename, ": Document parsing failed: ", e.what());
+		throw XMLException(name, ": Document parsing failed: ", e.what());
 	}
 	if (!root) {
-		throw XMLException(filename,
+		throw XMLException(name,
 			": Document doesn't contain mandatory root Element");
 	}
 	if (handler.getSystemID().empty()) {
-		throw XMLException(filename, ": Missing systemID.\n"
+		throw XMLException(name, ": Missing systemID.\n"
 			"You're probably using an old incompatible file format.");
 	}
 	if (handler.getSystemID() != systemID) {
-		throw XMLException(filename, ": systemID doesn't match "
+		throw XMLException(name, ": systemID doesn't match "
 			"(expected ", systemID, ", got ", handler.getSystemID(), ")\n"
 			"You're probably using an old incompatible file format.");
 	}
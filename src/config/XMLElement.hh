@@ -3,6 +3,7 @@
 
 #include "MappedFile.hh"
 
+#include "MemBuffer.hh"
 #include "monotonic_allocator.hh"
 #include "serialize_meta.hh"
 #include "zstring_view.hh"
@@ -310,6 +311,12 @@ public:
 
 	// Load/parse an xml file. Requires that the document is still empty.
 	void load(zstring_view filename, std::string_view systemID);
+	// Same, but parse an in-memory document. 'data' must end with (at
+	// least) rapidsax::EXTRA_BUFFER_SPACE zero bytes. 'name' is only used
+	// in error messages.
+	void load(MemBuffer<char> data, std::string_view name, std::string_view systemID);
+	// Make this (empty) document a deep copy of another document.
+	void load(const XMLDocument& source);
 
 	[[nodiscard]] const XMLElement* getRoot() const { return root; }
 	[[nodiscard]] XMLElement* getRoot() { return root; }
@@ -344,6 +351,7 @@ public:
 	void serialize(XmlOutputArchive& ar, unsigned version) const;
 
 private:
+	void parse(char* data, std::string_view name, std::string_view systemID);
 	XMLElement* loadElement(MemInputArchive& ar);
 	XMLElement* clone(const XMLElement& inElem);
 	XMLElement* clone(const OldXMLElement& elem);
@@ -351,6 +359,7 @@ private:
 private:
 	XMLElement* root = nullptr;
 	MappedFile<char> buf;
+	MemBuffer<char> memBuf; // alternative for 'buf'
 	// part of c++17, but not yet implemented in libc++
 	//    std::pmr::monotonic_buffer_resource allocator;
 	monotonic_allocator allocator;
@@ -83,6 +83,9 @@ public:
 	void attribute(std::string_view name, std::string_view value);
 	void data(std::string_view value);
 	void dataRaw(std::string_view value); // if you're sure 'value' doesn't need to be escaped
+	// Like dataRaw(), but the (non-empty) data is written directly to
+	// 'Operations' by the caller, in between this call and end().
+	void beginDataRaw();
 	void end(std::string_view tag);
 
 	void with_tag(std::string_view tag, std::invocable auto next);
@@ -163,6 +166,16 @@ void XMLOutputStream<Writer>::dataRaw(std::string_view value)
 	state = DATA;
 }
 
+template<typename Writer>
+void XMLOutputStream<Writer>::beginDataRaw()
+{
+	ops.check(level > 0);
+	ops.check(state == CLOSE);
+
+	writeChar('>');
+	state = DATA;
+}
+
 template<typename Writer>
 void XMLOutputStream<Writer>::end(std::string_view tag)
 {
@@ -4,8 +4,10 @@
 #include "stl.hh"
 #include "strCat.hh"
 #include "utf8_unchecked.hh"
+#include "xrange.hh"
 
 #include <algorithm>
+#include <cassert>
 #include <ranges>
 
 namespace openmsx {
@@ -69,6 +71,44 @@ ConsoleLine ConsoleLine::splitAtColumn(unsigned column)
 	return result;
 }
 
+std::vector<ConsoleLine> ConsoleLine::wrap(unsigned column, size_t maxPieces) const
+{
+	assert(column > 0);
+	std::vector<size_t> starts = {0}; // byte position where each piece starts
+	auto it = line.begin(), et = line.end();
+	while (true) {
+		for (unsigned c = 0; (c < column) && (it != et); ++c) {
+			utf8::unchecked::next(it);
+		}
+		if (it == et) break;
+		starts.push_back(std::distance(line.begin(), it));
+	}
+
+	auto first = (starts.size() > maxPieces) ? (starts.size() - maxPieces) : 0;
+	std::vector<ConsoleLine> result;
+	result.reserve(starts.size() - first);
+	for (auto i : xrange(first, starts.size())) {
+		auto end = (i + 1 < starts.size()) ? starts[i + 1] : line.size();
+		result.push_back(subLine(starts[i], end));
+	}
+	return result;
+}
+
+ConsoleLine ConsoleLine::subLine(size_t begin, size_t end) const
+{
+	ConsoleLine result;
+	result.line.assign(line, begin, end - begin);
+	if (chunks.empty()) return result;
+
+	auto it = std::ranges::upper_bound(chunks, begin, {}, &Chunk::pos);
+	assert(it != chunks.begin());
+	result.chunks.push_back({.color = it[-1].color, .pos = 0});
+	for (/**/; (it != chunks.end()) && (it->pos < end); ++it) {
+		result.chunks.push_back({.color = it->color, .pos = it->pos - begin});
+	}
+	return result;
+}
+
 size_t ConsoleLine::numChars() const
 {
 	return utf8::unchecked::size(line);
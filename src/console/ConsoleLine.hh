@@ -38,6 +38,12 @@ public:
 	  * The remainder of the line is returned, this could be an empty line. */
 	ConsoleLine splitAtColumn(unsigned column);
 
+	/** Split this line in pieces of (up to) 'column' characters. Gives the
+	  * same result as repeatedly calling splitAtColumn(), but takes linear
+	  * instead of quadratic time for very long lines. Only the last
+	  * 'maxPieces' pieces are returned. */
+	[[nodiscard]] std::vector<ConsoleLine> wrap(unsigned column, size_t maxPieces = size_t(-1)) const;
+
 	/** Get the number of UTF8 characters in this line. So multi-byte
 	  * characters are counted as a single character. */
 	[[nodiscard]] size_t numChars() const;
@@ -60,6 +66,9 @@ public:
 		std::string_view::size_type pos;
 	};
 
+private:
+	[[nodiscard]] ConsoleLine subLine(size_t begin, size_t end) const;
+
 private:
 	std::string line;
 	std::vector<Chunk> chunks;
@@ -1,5 +1,6 @@
 #include "OSDGUILayer.hh"
 
+#include "GLContext.hh"
 #include "OSDGUI.hh"
 #include "OSDTopWidget.hh"
 
@@ -20,6 +21,7 @@ void OSDGUILayer::paint(OutputSurface& output)
 {
 	auto& top = getGUI().getTopWidget();
 	top.paintRecursive(output);
+	gl::context->flushFillBatch();
 	top.showAllErrors();
 }
 
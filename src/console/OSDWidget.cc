@@ -2,6 +2,7 @@
 
 #include "CommandException.hh"
 #include "Display.hh"
+#include "GLContext.hh"
 #include "GLUtil.hh"
 #include "OutputSurface.hh"
 #include "TclObject.hh"
@@ -61,6 +62,7 @@ private:
 
 GLScopedClip::GLScopedClip(const OutputSurface& output, vec2 xy, vec2 wh)
 {
+	gl::context->flushFillBatch(); // batched triangles use the old clip rectangle
 	auto& [x, y] = xy;
 	auto& [w, h] = wh;
 	normalize(x, w); normalize(y, h);
@@ -86,6 +88,7 @@ GLScopedClip::GLScopedClip(const OutputSurface& output, vec2 xy, vec2 wh)
 
 GLScopedClip::~GLScopedClip()
 {
+	gl::context->flushFillBatch();
 	if (origClip) {
 		glScissor((*origClip)[0], (*origClip)[1], (*origClip)[2], (*origClip)[3]);
 	} else {
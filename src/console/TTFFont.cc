@@ -4,7 +4,10 @@
 #include "MSXException.hh"
 
 #include "StringOp.hh"
+#include "hash_map.hh"
 #include "stl.hh"
+#include "utf8_unchecked.hh"
+#include "xrange.hh"
 #include "zstring_view.hh"
 
 #include <SDL_ttf.h>
@@ -30,6 +33,16 @@ private:
 	~SDLTTF();
 };
 
+// A rasterized glyph. Only the coverage (alpha) is stored, so the same glyph
+// can be used for any color.
+struct Glyph {
+	std::vector<uint8_t> alpha; // width x height, can be empty (e.g. a space)
+	int width = 0;
+	int height = 0;
+	int left = 0; // x-position of the bitmap relative to the pen position
+	int advance = 0;
+};
+
 class TTFFontPool
 {
 public:
@@ -42,6 +55,10 @@ public:
 	TTF_Font* get(const std::string& filename, int ptSize, int faceIndex);
 	void release(TTF_Font* font);
 
+	/** Get the rasterized glyph for the given unicode code point. The
+	  * result is only valid till the next call to this method. */
+	const Glyph& getGlyph(TTF_Font* font, uint32_t codePoint);
+
 private:
 	TTFFontPool() = default;
 	~TTFFontPool();
@@ -67,8 +84,15 @@ private:
 		int size;
 		int count;
 		int faceIndex;
+		// Glyphs are shared by all users of this font. Only new glyphs
+		// have to be rasterized, e.g. when an OSD counter changes.
+		hash_map<uint32_t, Glyph> glyphs;
 	};
 	std::vector<FontInfo> pool;
+
+	// Limits the memory used by the glyph cache of a single font (more is
+	// only needed for texts with lots of different characters).
+	static constexpr size_t MAX_CACHED_GLYPHS = 1024;
 };
 
 
@@ -131,6 +155,39 @@ TTF_Font* TTFFontPool::get(const std::string& filename, int ptSize, int faceInde
 	return result;
 }
 
+const Glyph& TTFFontPool::getGlyph(TTF_Font* font, uint32_t codePoint)
+{
+	auto& glyphs = rfind_unguarded(pool, font, &FontInfo::font)->glyphs;
+	if (const auto* glyph = lookup(glyphs, codePoint)) return *glyph;
+	if (glyphs.size() >= MAX_CACHED_GLYPHS) glyphs.clear();
+
+	Glyph glyph;
+	int minX, maxX, minY, maxY;
+	if (TTF_GlyphMetrics32(font, codePoint, &minX, &maxX, &minY, &maxY, &glyph.advance) == 0) {
+		// Same as rendering a single character string: the bitmap
+		// is shifted to the right when the glyph extends to the left
+		// of the pen position.
+		glyph.left = std::min(0, minX);
+		SDLSurfacePtr rendered(TTF_RenderGlyph32_Blended(font, codePoint, SDL_Color{255, 255, 255, 255}));
+		if (rendered) {
+			SDLSurfacePtr surface(SDL_ConvertSurfaceFormat(rendered.get(), SDL_PIXELFORMAT_ARGB8888, 0));
+			if (surface) {
+				glyph.width = surface->w;
+				glyph.height = surface->h;
+				glyph.alpha.resize(size_t(glyph.width) * glyph.height);
+				for (auto y : xrange(glyph.height)) {
+					const auto* src = static_cast<const uint32_t*>(surface.getLinePtr(y));
+					auto* dst = &glyph.alpha[size_t(y) * glyph.width];
+					for (auto x : xrange(glyph.width)) {
+						dst[x] = uint8_t(src[x] >> 24);
+					}
+				}
+			}
+		}
+	}
+	return glyphs.emplace_noDuplicateCheck(codePoint, std::move(glyph))->second;
+}
+
 void TTFFontPool::release(TTF_Font* font)
 {
 	auto it = rfind_unguarded(pool, font, &FontInfo::font);
@@ -155,52 +212,63 @@ TTFFont::~TTFFont()
 	TTFFontPool::instance().release(static_cast<TTF_Font*>(font));
 }
 
+// Calls 'op(glyph, x)' for each character in the (single line) text, with 'x'
+// the pen position. Returns the final pen position.
+template<typename Op>
+static int forEachGlyph(TTF_Font* font, std::string_view line, Op op)
+{
+	auto& pool = TTFFontPool::instance();
+	bool kerning = TTF_GetFontKerning(font) != 0;
+	uint32_t prev = 0;
+	int pen = 0;
+	const auto* it = line.data();
+	const auto* end = it + line.size();
+	while (it != end) {
+		uint32_t cp = utf8::unchecked::next(it);
+		if (kerning && prev) pen += TTF_GetFontKerningSizeGlyphs32(font, prev, cp);
+		const auto& glyph = pool.getGlyph(font, cp);
+		op(glyph, pen);
+		pen += glyph.advance;
+		prev = cp;
+	}
+	return pen;
+}
+
+// Horizontal extent of the rendered line: {offset of the pen start, width}.
+static std::pair<int, int> getLineExtent(TTF_Font* font, std::string_view line)
+{
+	int minX = 0;
+	int maxX = 0;
+	int pen = forEachGlyph(font, line, [&](const Glyph& glyph, int x) {
+		minX = std::min(minX, x + glyph.left);
+		maxX = std::max(maxX, x + glyph.left + glyph.width);
+	});
+	maxX = std::max(maxX, pen);
+	return {-minX, maxX - minX};
+}
+
 SDLSurfacePtr TTFFont::render(std::string text, uint8_t r, uint8_t g, uint8_t b) const
 {
-	SDL_Color color = { r, g, b, 0 };
+	auto* ttf = static_cast<TTF_Font*>(font);
 
 	// Optimization: remove trailing empty lines
 	StringOp::trimRight(text, " \n");
 	if (text.empty()) return SDLSurfacePtr(nullptr);
 
-	// Split on newlines
-	auto lines_view = StringOp::split_view(text, '\n');
-	auto lines_it = lines_view.begin();
-	auto lines_end = lines_view.end();
-	assert(lines_it != lines_end);
-
-	auto current_line = *lines_it;
-	++lines_it;
-	if (lines_it == lines_end) {
-		// Special case for a single line: we can avoid the
-		// copy to an extra SDL_Surface
-		assert(!text.empty());
-		SDLSurfacePtr surface(
-			TTF_RenderUTF8_Blended(static_cast<TTF_Font*>(font),
-			                       text.c_str(), color));
-		if (!surface) {
-			throw MSXException(TTF_GetError());
-		}
-		return surface;
-	}
-
-	// Determine maximum width and lineHeight
+	// Determine maximum width and number of lines
+	auto lines = StringOp::split_view(text, '\n');
 	int width = 0;
-	int lineHeight = 0; // initialize to avoid warning
-	int numLines = 1;
-	while (true) {
-		auto [w, h] = getSize(std::string(current_line));
-		width = std::max(width, w);
-		lineHeight = h;
-		if (lines_it == lines_end) break;
-		current_line = *lines_it;
-		++lines_it;
+	int numLines = 0;
+	for (auto line : lines) {
+		width = std::max(width, getLineExtent(ttf, line).second);
 		++numLines;
 	}
+	if (width == 0) return SDLSurfacePtr(nullptr);
+
 	// There might be extra space between two successive lines
 	// (so lineSkip might be bigger than lineHeight).
 	int lineSkip = getHeight();
-	// We assume that height is the same for all lines.
+	int lineHeight = TTF_FontHeight(ttf);
 	// For the last line we don't include spacing between two lines.
 	auto height = (numLines - 1) * lineSkip + lineHeight;
 
@@ -208,33 +276,29 @@ SDLSurfacePtr TTFFont::render(std::string text, uint8_t r, uint8_t g, uint8_t b)
 	SDLSurfacePtr destination(SDL_CreateRGBSurface(SDL_SWSURFACE, width, height,
 			32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000));
 	if (!destination) {
-		throw MSXException("Couldn't allocate surface for multiline text.");
+		throw MSXException("Couldn't allocate surface for text.");
 	}
 
-	// Actually render the text:
-	// TODO use enumerate() in the future (c++20)
-	int i = -1;
-	for (auto line : lines_view) {
-		++i;
-		// Render single line
-		if (line.empty()) {
-			// SDL_TTF gives an error on empty lines, but we can
-			// simply skip such lines
-			continue;
-		}
-		SDLSurfacePtr surf(TTF_RenderUTF8_Blended(
-			static_cast<TTF_Font*>(font),
-			std::string(line).c_str(), color));
-		if (!surf) {
-			throw MSXException(TTF_GetError());
-		}
-
-		// Copy line to destination surface
-		SDL_Rect rect;
-		rect.x = 0;
-		rect.y = Sint16(i * lineSkip);
-		SDL_SetSurfaceBlendMode(surf.get(), SDL_BLENDMODE_NONE); // no blending during copy
-		SDL_BlitSurface(surf.get(), nullptr, destination.get(), &rect);
+	// Compose the text from the (cached) glyphs. Where glyphs overlap the
+	// highest coverage wins.
+	uint32_t rgb = (r << 16) | (g << 8) | (b << 0);
+	int lineY = 0;
+	for (auto line : lines) {
+		int offset = getLineExtent(ttf, line).first;
+		forEachGlyph(ttf, line, [&](const Glyph& glyph, int x) {
+			x += offset + glyph.left;
+			int w = std::min(glyph.width, width - x);
+			int h = std::min(glyph.height, height - lineY);
+			for (auto y : xrange(h)) {
+				const auto* src = &glyph.alpha[size_t(y) * glyph.width];
+				auto* dst = static_cast<uint32_t*>(destination.getLinePtr(lineY + y)) + x;
+				for (auto i : xrange(w)) {
+					auto a = std::max(uint32_t(src[i]), dst[i] >> 24);
+					dst[i] = (a << 24) | rgb;
+				}
+			}
+		});
+		lineY += lineSkip;
 	}
 	return destination;
 }
@@ -264,12 +328,10 @@ int TTFFont::getWidth() const
 
 gl::ivec2 TTFFont::getSize(zstring_view text) const
 {
-	int width, height;
-	if (TTF_SizeUTF8(static_cast<TTF_Font*>(font), text.c_str(),
-	                 &width, &height)) {
-		throw MSXException(TTF_GetError());
-	}
-	return {width, height};
+	// Use the same (cached) glyphs as render(), so this is cheap and
+	// consistent with the actual rendering.
+	auto* ttf = static_cast<TTF_Font*>(font);
+	return {getLineExtent(ttf, text).second, TTF_FontHeight(ttf)};
 }
 
 } // namespace openmsx
@@ -2,14 +2,19 @@
 #define BREAKPOINTBASE_HH
 
 #include "CommandException.hh"
+#include "CompiledCondition.hh"
 #include "GlobalCliComm.hh"
 #include "TclObject.hh"
+#include "TclProfiler.hh"
 
 #include "ScopedAssign.hh"
 #include "strCat.hh"
 
+#include <memory>
+
 namespace openmsx {
 
+class Debugger;
 class Interpreter;
 
 /** CRTP base class for CPU break and watch points.
@@ -26,7 +31,12 @@ public:
 	[[nodiscard]] bool isEnabled() const { return enabled; }
 	[[nodiscard]] bool onlyOnce() const { return once; }
 
-	void setCondition(const TclObject& c) { condition = c; }
+	void setCondition(const TclObject& c) {
+		condition = c;
+		auto cc = CompiledCondition::compile(condition.getString());
+		compiled = cc ? std::make_shared<const CompiledCondition>(std::move(*cc))
+		              : nullptr;
+	}
 	void setCommand(const TclObject& c) { command = c; }
 	void setEnabled(Interpreter& interp, const TclObject& e) {
 		setEnabled(e.getBoolean(interp)); // may throw
@@ -37,14 +47,15 @@ public:
 	}
 	void setOnce(bool o) { once = o; }
 
-	bool checkAndExecute(GlobalCliComm& cliComm, Interpreter& interp) {
+	bool checkAndExecute(GlobalCliComm& cliComm, Interpreter& interp, Debugger& debugger) {
 		if (!enabled) return false;
 		if (executing) {
 			// no recursive execution
 			return false;
 		}
 		ScopedAssign sa(executing, true);
-		if (isTrue(cliComm, interp)) {
+		TclProfiler::Scope profile(TclProfiler::Kind::BREAKPOINT, [&] { return getIdStr(); });
+		if (isTrue(cliComm, interp, debugger)) {
 			try {
 				command.executeCommand(interp, true); // compile command
 			} catch (CommandException& e) {
@@ -63,11 +74,15 @@ private:
 	// Note: we require GlobalCliComm here because breakpoint objects can
 	// be transferred to different MSX machines, and so the MSXCliComm
 	// object won't remain valid.
-	[[nodiscard]] bool isTrue(GlobalCliComm& cliComm, Interpreter& interp) const {
+	[[nodiscard]] bool isTrue(GlobalCliComm& cliComm, Interpreter& interp, Debugger& debugger) const {
 		if (condition.getString().empty()) {
 			// unconditional bp
 			return true;
 		}
+		if (compiled) {
+			if (auto result = compiled->evaluate(debugger)) return *result;
+			// otherwise let Tcl evaluate it (and report the error)
+		}
 		try {
 			return condition.evalBool(interp);
 		} catch (CommandException& e) {
@@ -79,6 +94,8 @@ private:
 private:
 	TclObject command{"debug break"};
 	TclObject condition;
+	// Shared: breakpoints get copied on each hit (see MSXCPUInterface).
+	std::shared_ptr<const CompiledCondition> compiled; // redundant: calculated from 'condition'
 	bool enabled = true;
 	bool once = false;
 	bool executing = false;
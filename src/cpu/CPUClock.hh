@@ -58,6 +58,20 @@ protected:
 		return halts;
 	}
 
+	/** Implementation of an endless loop that has no side effects (e.g.
+	  * 'jr $'), where each iteration takes 'cycles' cycles. Executing it
+	  * one iteration at a time would add 'cycles' till limitReached()
+	  * becomes true, this does the same in one step. Returns the number of
+	  * iterations. Only valid while the limit is not yet reached.
+	  */
+	unsigned advanceLoop(unsigned cycles) {
+		assert(!limitReached());
+		unsigned n = unsigned(remaining) / cycles + 1;
+		add(n * cycles);
+		assert(limitReached());
+		return n;
+	}
+
 	/** R800 runs at 7MHz, but I/O is done over a slower 3.5MHz bus. So
 	  * sometimes right before I/O it's needed to wait for one cycle so
 	  * that we're at the start of a clock cycle of the slower bus.
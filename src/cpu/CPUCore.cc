@@ -157,6 +157,22 @@
 // raises the IRQ line. So it is important to check for exit after every
 // instruction, otherwise we would enter the IRQ routine a couple of
 // instructions too late.
+//
+//
+// DYNAMIC TRANSLATION
+// -------------------
+//
+// The above also explains why openMSX has no JIT (translating Z80 basic
+// blocks to host code). A translated block can only run as a unit when,
+// between two instructions, nothing can happen that the interpreter checks
+// for: the exit-test (sync points, IRQ, slowInstructions), front-door memory
+// accesses (MMIO, watchpoints, unmapped cache lines) and I/O. On MSX those are
+// frequent: e.g. VDP polling loops do I/O every few instructions, and
+// mappers switch banks (and thus invalidate cache lines) constantly. So a JIT
+// would still exit to this interpreter very often, while every such exit
+// point must reproduce the exact same cycle timing as the interpreter. The
+// cheaper wins (computed goto dispatch, repeated block instructions executed
+// in-place, see BLOCK_LD) are what's implemented instead.
 
 #include "CPUCore.hh"
 
@@ -165,8 +181,11 @@
 #include "R800.hh"
 #include "Z80.hh"
 
+#include "CallStackShadow.hh"
+#include "InstructionTraceWriter.hh"
 #include "MSXCliComm.hh"
 #include "MSXMotherBoard.hh"
+#include "PerfMonitor.hh"
 #include "Scheduler.hh"
 #include "TclCallback.hh"
 #include "Thread.hh"
@@ -200,7 +219,7 @@
 //
 // Probably the easiest way to enable this, is to pass the -DUSE_COMPUTED_GOTO
 // flag to the compiler. This is for example done in the super-opt flavour.
-// See build/flavour-super-opt.mk
+// See build/flavour-super-opt.mk. For meson builds use '-Dcomputed_goto=true'.
 
 #ifndef _MSC_VER
   // [[maybe_unused]] on a label is not (yet?) officially part of c++
@@ -394,12 +413,14 @@ template<typename T> void CPUCore<T>::exitCPULoopAsync()
 {
 	// can get called from non-main threads
 	exitLoop = true;
+	exitAsyncCount.fetch_add(1, std::memory_order_relaxed);
 }
 template<typename T> void CPUCore<T>::exitCPULoopSync()
 {
 	assert(Thread::isMainThread());
 	exitLoop = true;
 	T::disableLimit();
+	++exitStats.exitSync;
 }
 template<typename T> inline bool CPUCore<T>::needExitCPULoop()
 {
@@ -419,6 +440,34 @@ template<typename T> inline bool CPUCore<T>::needExitCPULoop()
 	//return exitLoop.exchange(false);
 }
 
+template<typename T> CPUExitStats CPUCore<T>::getExitStats() const
+{
+	auto result = exitStats;
+	result.exitAsync = exitAsyncCount.load(std::memory_order_relaxed);
+	return result;
+}
+
+template<typename T> void CPUCore<T>::resetExitStats()
+{
+	exitStats = {};
+	exitAsyncCount = 0;
+}
+
+// Called when the fast loop stops executing instructions, before the
+// pending sync-points are executed.
+template<typename T> void CPUCore<T>::countSliceEnd()
+{
+	if (exitLoop) {
+		++exitStats.exitRequest;
+	} else if (slowInstructions) {
+		++exitStats.slow;
+	} else if (T::getTimeFast() >= scheduler.getNext()) {
+		++exitStats.syncPoint;
+	} else {
+		++exitStats.other;
+	}
+}
+
 template<typename T> void CPUCore<T>::setSlowInstructions()
 {
 	slowInstructions = 2;
@@ -759,6 +808,7 @@ template<typename T> inline void CPUCore<T>::nmi()
 	setIFF1(false);
 	PUSH<T::EE_NMI_1>(getPC());
 	setPC(0x0066);
+	if (callStack) [[unlikely]] callStack->call(getPC(), getSP());
 	T::add(T::CC_NMI);
 }
 
@@ -774,6 +824,7 @@ template<typename T> inline void CPUCore<T>::irq0()
 	setIFF2(false);
 	PUSH<T::EE_IRQ0_1>(getPC());
 	setPC(0x0038);
+	if (callStack) [[unlikely]] callStack->call(getPC(), getSP());
 	T::setMemPtr(getPC());
 	T::add(T::CC_IRQ0);
 }
@@ -787,6 +838,7 @@ template<typename T> inline void CPUCore<T>::irq1()
 	setIFF2(false);
 	PUSH<T::EE_IRQ1_1>(getPC());
 	setPC(0x0038);
+	if (callStack) [[unlikely]] callStack->call(getPC(), getSP());
 	T::setMemPtr(getPC());
 	T::add(T::CC_IRQ1);
 }
@@ -801,6 +853,7 @@ template<typename T> inline void CPUCore<T>::irq2()
 	PUSH<T::EE_IRQ2_1>(getPC());
 	unsigned x = interface->readIRQVector() | (getI() << 8);
 	setPC(RD_WORD(x, T::CC_IRQ2_2));
+	if (callStack) [[unlikely]] callStack->call(getPC(), getSP());
 	T::setMemPtr(getPC());
 	T::add(T::CC_IRQ2);
 }
@@ -2425,10 +2478,35 @@ template<typename T> ExecIRQ CPUCore<T>::getExecIRQ() const
 	return ExecIRQ::NONE;
 }
 
+template<typename T> void CPUCore<T>::traceInstruction()
+{
+	auto time = T::getTimeFast();
+	InstructionTrace::Record record;
+	record.time = time.toUint64();
+	record.pc = getPC();
+	record.sp = getSP();
+	record.af = getAF();
+	record.bc = getBC();
+	record.de = getDE();
+	record.hl = getHL();
+	record.ix = getIX();
+	record.iy = getIY();
+	for (auto i : xrange(4)) {
+		record.opcode[i] = interface->peekMem(narrow_cast<uint16_t>(getPC() + i), time);
+	}
+	record.i = getI();
+	record.r = getR();
+	record.im = getIM();
+	record.flags = (getIFF1() ? InstructionTrace::Record::IFF1 : 0) |
+	               (T::IS_R800 ? InstructionTrace::Record::R800 : 0);
+	instructionTrace->push(record);
+}
+
 template<typename T> void CPUCore<T>::executeSlow(ExecIRQ execIRQ)
 {
 	if (execIRQ == ExecIRQ::NMI) [[unlikely]] {
 		nmiEdge = false;
+		++exitStats.nmi;
 		nmi(); // NMI occurred
 	} else if (execIRQ == ExecIRQ::IRQ) [[unlikely]] {
 		// normal interrupt
@@ -2454,6 +2532,7 @@ template<typename T> void CPUCore<T>::executeSlow(ExecIRQ execIRQ)
 			setF(getF() & ~V_FLAG);
 		}
 		IRQAccept.signal();
+		++exitStats.irq;
 		switch (getIM()) {
 			case 0: irq0();
 				break;
@@ -2470,6 +2549,7 @@ template<typename T> void CPUCore<T>::executeSlow(ExecIRQ execIRQ)
 		setSlowInstructions();
 	} else {
 		assert(T::limitReached()); // we want only one instruction
+		if (instructionTrace) traceInstruction();
 		executeInstructions();
 		endInstruction();
 
@@ -2515,7 +2595,7 @@ template<typename T> void CPUCore<T>::execute2(bool fastForward)
 	// Note: we call scheduler _after_ executing the instruction and before
 	// deciding between executeFast() and executeSlow() (because a
 	// SyncPoint could set an IRQ and then we must choose executeSlow())
-	if (fastForward || !interface->anyBreakPoints()) {
+	if (fastForward || (!interface->anyBreakPoints() && !instructionTrace)) {
 		// fast path, no breakpoints, no tracing
 		do {
 			if (slowInstructions) {
@@ -2532,6 +2612,9 @@ template<typename T> void CPUCore<T>::execute2(bool fastForward)
 						// step for multiple instructions
 						endInstruction();
 					}
+					if (PerfMonitor::isEnabled()) [[unlikely]] {
+						countSliceEnd();
+					}
 					scheduler.schedule(T::getTimeFast());
 					if (needExitCPULoop()) return;
 				}
@@ -2541,6 +2624,7 @@ template<typename T> void CPUCore<T>::execute2(bool fastForward)
 		do {
 			if (slowInstructions == 0) {
 				assert(T::limitReached()); // only one instruction
+				if (instructionTrace) traceInstruction();
 				executeInstructions();
 				endInstruction();
 			} else {
@@ -2587,6 +2671,7 @@ template<typename T> void CPUCore<T>::execute2(bool fastForward)
 			if ((execIRQ == ExecIRQ::NONE) &&
 			    interface->checkBreakPoints(getPC())) {
 				assert(interface->isBreaked());
+				++exitStats.breakpoints;
 				break;
 			}
 		} while (!needExitCPULoop());
@@ -3821,6 +3906,7 @@ template<typename T> template<typename COND> II CPUCore<T>::call(COND cond) {
 	if (cond(getF())) {
 		PUSH<T::EE_CALL>(getPC() + 3); /**/
 		setPC(addr);
+		if (callStack) [[unlikely]] callStack->call(addr, getSP());
 		if constexpr (T::IS_R800) {
 			setCurrentCall();
 			setSlowInstructions();
@@ -3837,6 +3923,7 @@ template<typename T> template<unsigned ADDR> II CPUCore<T>::rst() {
 	PUSH<0>(getPC() + 1); /**/
 	T::setMemPtr(ADDR);
 	setPC(ADDR);
+	if (callStack) [[unlikely]] callStack->call(ADDR, getSP());
 	if constexpr (T::IS_R800) {
 		setCurrentCall();
 		setSlowInstructions();
@@ -3923,12 +4010,38 @@ template<typename T> template<typename COND> II CPUCore<T>::jr(COND cond) {
 		}
 		setPC(narrow_cast<uint16_t>(getPC() + 2 + ofst));
 		T::setMemPtr(getPC());
+		if constexpr (!T::IS_R800) {
+			if ((ofst == -2) && !T::limitReached() && isIdleJr()) {
+				// Idle loop ('jr $' or 'jr cc,$' with a condition
+				// that can't change): nothing happens till the
+				// next sync point (e.g. an IRQ). Skip ahead to
+				// the exact same state as executing all these
+				// iterations one by one (including the cycles of
+				// this one, normally added by NEXT).
+				auto n = T::advanceLoop(T::CC_JR_A);
+				incR(narrow_cast<uint8_t>(n - 1));
+				return {0, 0};
+			}
+		}
 		return {0/*2*/, T::CC_JR_A};
 	} else {
 		return {2, T::CC_JR_B};
 	}
 }
 
+template<typename T> inline bool CPUCore<T>::isIdleJr() const {
+	// The instruction at PC must be a 'jr $' (or 'jr cc,$'), in cached
+	// memory (re-fetching it has no side effects and doesn't trigger
+	// watchpoints).
+	auto pc = getPC();
+	auto pc1 = narrow_cast<uint16_t>(pc + 1);
+	const uint8_t* line0 = readCacheLine[pc  >> CacheLine::BITS];
+	const uint8_t* line1 = readCacheLine[pc1 >> CacheLine::BITS];
+	if ((uintptr_t(line0) <= 1) || (uintptr_t(line1) <= 1)) return false;
+	auto op = line0[pc];
+	return ((op == 0x18) || ((op & 0xE7) == 0x20)) && (line1[pc1] == 0xFE);
+}
+
 // DJNZ e
 template<typename T> II CPUCore<T>::djnz() {
 	uint8_t b = getB() - 1;
@@ -4045,7 +4158,7 @@ template<typename T> II CPUCore<T>::cpir() { return BLOCK_CP( 1, true ); }
 
 
 // block LD
-template<typename T> inline II CPUCore<T>::BLOCK_LD(int increase, bool repeat) {
+template<typename T> inline void CPUCore<T>::BLOCK_LD_step(int increase) {
 	uint8_t val = RDMEM(getHL(), T::CC_LDI_1);
 	WRMEM(getDE(), val, T::CC_LDI_2);
 	setHL(narrow_cast<uint16_t>(getHL() + increase));
@@ -4060,13 +4173,50 @@ template<typename T> inline II CPUCore<T>::BLOCK_LD(int increase, bool repeat) {
 		f |= uint8_t((getA() + val) & X_FLAG);        // bit 3 -> flag 3
 	}
 	setF(f);
-	if (repeat && getBC()) {
-		//setPC(getPC() - 2);
-		T::setMemPtr(getPC() + 1);
-		return {uint16_t(-1)/*1*/, T::CC_LDIR};
-	} else {
+}
+template<typename T> inline II CPUCore<T>::BLOCK_LD(int increase, bool repeat) {
+	BLOCK_LD_step(increase);
+	if (!repeat || !getBC()) {
 		return {1, T::CC_LDI};
 	}
+	//setPC(getPC() - 2);
+	T::setMemPtr(getPC() + 1);
+	if constexpr (!T::IS_R800) {
+		// Fast path: instead of going through the main loop for every
+		// iteration, execute the following iterations right here. This
+		// is only done as long as that has exactly the same effect as
+		// re-fetching and re-executing the instruction: the instruction
+		// itself, the source and destination byte must all be in
+		// cached memory (so no watchpoints and no side effects) and the
+		// instruction must not have been overwritten by the previous
+		// iteration. On R800 memory accesses have extra timing effects
+		// (page-breaks, refresh), so there we always take the slow path.
+		auto canRepeat = [&] {
+			auto pc = getPC(); // points to the 2nd opcode byte
+			auto prefix = narrow_cast<uint16_t>(pc - 1);
+			const uint8_t* line1 = readCacheLine[prefix >> CacheLine::BITS];
+			const uint8_t* line2 = readCacheLine[pc     >> CacheLine::BITS];
+			const uint8_t* src   = readCacheLine[getHL() >> CacheLine::BITS];
+			const uint8_t* dst   = writeCacheLine[getDE() >> CacheLine::BITS];
+			return (uintptr_t(line1) > 1) && (uintptr_t(line2) > 1) &&
+			       (uintptr_t(src) > 1) && (uintptr_t(dst) > 1) &&
+			       (line1[prefix] == 0xED) &&
+			       (line2[pc] == ((increase > 0) ? 0xB0 : 0xB8));
+		};
+		while (canRepeat()) {
+			// cycles of the previous iteration (normally added by NEXT)
+			T::add(T::CC_LDIR);
+			if (T::limitReached()) {
+				// Same state as after the previous iteration in
+				// the main loop, but the cycles are already added.
+				return {uint16_t(-1), 0};
+			}
+			incR(2); // refetch of the (2-byte) opcode
+			BLOCK_LD_step(increase);
+			if (!getBC()) return {1, T::CC_LDI};
+		}
+	}
+	return {uint16_t(-1)/*1*/, T::CC_LDIR};
 }
 template<typename T> II CPUCore<T>::ldd()  { return BLOCK_LD(-1, false); }
 template<typename T> II CPUCore<T>::ldi()  { return BLOCK_LD( 1, false); }
@@ -18,6 +18,8 @@
 
 namespace openmsx {
 
+class CallStackShadow;
+class InstructionTraceWriter;
 class MSXCPUInterface;
 class Scheduler;
 class MSXMotherBoard;
@@ -51,6 +53,31 @@ struct CacheLines {
 	std::span<      uint8_t*, CacheLine::NUM> write;
 };
 
+/** Why the CPU emulation loop stopped executing instructions. */
+struct CPUExitStats {
+	// Why a slice (a run of instructions in the fast loop) ended. These
+	// are only counted while PerfMonitor is enabled.
+	uint64_t syncPoint = 0;   // reached the next sync-point
+	uint64_t slow = 0;        // raised IRQ or NMI, or EI or HALT
+	uint64_t exitRequest = 0; // exitCPULoopSync() or exitCPULoopAsync()
+	uint64_t other = 0;       // e.g. an earlier sync-point was set during IO
+
+	uint64_t irq = 0;         // accepted IRQs
+	uint64_t nmi = 0;         // accepted NMIs
+	uint64_t exitSync = 0;    // calls to exitCPULoopSync()
+	uint64_t exitAsync = 0;   // calls to exitCPULoopAsync()
+	uint64_t breakpoints = 0; // breaks on a breakpoint or condition
+
+	CPUExitStats& operator+=(const CPUExitStats& o) {
+		syncPoint += o.syncPoint; slow += o.slow;
+		exitRequest += o.exitRequest; other += o.other;
+		irq += o.irq; nmi += o.nmi;
+		exitSync += o.exitSync; exitAsync += o.exitAsync;
+		breakpoints += o.breakpoints;
+		return *this;
+	}
+};
+
 template<typename CPU_POLICY>
 class CPUCore final : public CPUBase, public CPURegs, public CPU_POLICY
 {
@@ -60,6 +87,15 @@ public:
 
 	void setInterface(MSXCPUInterface* interface_) { interface = interface_; }
 
+	/** Record all executed instructions in the given trace (or stop
+	  * recording when nullptr). Instructions executed in fast-forward
+	  * mode are not recorded. */
+	void setInstructionTrace(InstructionTraceWriter* trace) { instructionTrace = trace; }
+
+	/** Report all calls (CALL, RST, interrupts) to the given shadow call
+	  * stack (or stop reporting when nullptr). */
+	void setCallStack(CallStackShadow* stack) { callStack = stack; }
+
 	/**
 	 * Reset the CPU.
 	 */
@@ -79,6 +115,9 @@ public:
 	  */
 	void exitCPULoopAsync();
 
+	[[nodiscard]] CPUExitStats getExitStats() const;
+	void resetExitStats();
+
 	void warp(EmuTime time);
 	[[nodiscard]] EmuTime getCurrentTime() const;
 	void wait(EmuTime time);
@@ -127,7 +166,9 @@ public:
 private:
 	void execute2(bool fastForward);
 	[[nodiscard]] bool needExitCPULoop();
+	void countSliceEnd();
 	void setSlowInstructions();
+	void traceInstruction();
 	void doSetFreq();
 
 	// Observer<Setting>  !! non-virtual !!
@@ -141,6 +182,8 @@ private:
 	MSXMotherBoard& motherboard;
 	Scheduler& scheduler;
 	MSXCPUInterface* interface = nullptr;
+	InstructionTraceWriter* instructionTrace = nullptr;
+	CallStackShadow* callStack = nullptr;
 
 	TclCallback& diHaltCallback;
 
@@ -165,6 +208,9 @@ private:
 
 	std::atomic<bool> exitLoop = false;
 
+	CPUExitStats exitStats; // except 'exitAsync'
+	std::atomic<uint64_t> exitAsyncCount = 0;
+
 	/** An NMOS Z80 and a CMOS Z80 behave slightly differently */
 	const bool isCMOS;
 
@@ -415,6 +461,7 @@ private:
 	template<Reg16 REG, int EE> inline II jp_SS();
 	template<typename COND> inline II jp(COND cond);
 	template<typename COND> inline II jr(COND cond);
+	[[nodiscard]] inline bool isIdleJr() const;
 	inline II djnz();
 
 	template<Reg16 REG, int EE> inline II ex_xsp_SS();
@@ -431,6 +478,7 @@ private:
 	inline II cpdr();
 	inline II cpir();
 
+	inline void BLOCK_LD_step(int increase);
 	inline II BLOCK_LD(int increase, bool repeat);
 	inline II ldd();
 	inline II ldi();
@@ -0,0 +1,57 @@
+#ifndef CALLSTACKSHADOW_HH
+#define CALLSTACKSHADOW_HH
+
+#include "static_vector.hh"
+
+#include <cstdint>
+#include <span>
+
+namespace openmsx {
+
+/** Keeps track of the (approximate) call stack of the emulated CPU.
+  *
+  * The CPU reports every CALL, RST and interrupt. Returns are not reported,
+  * instead a frame is dropped as soon as the stack pointer has moved above
+  * the return address that was pushed for it. This also copes reasonably
+  * well with code that manipulates the stack directly, e.g. 'POP HL; JP
+  * (HL)' or reloading SP.
+  */
+class CallStackShadow
+{
+public:
+	struct Frame {
+		uint16_t target; // start address of the called routine
+		uint16_t sp;     // SP right after the return address was pushed
+	};
+	static constexpr size_t MAX_DEPTH = 256;
+
+	/** Called right after a return address was pushed and the jump to
+	  * 'target' was made. */
+	void call(uint16_t target, uint16_t sp) {
+		// A frame with the same or a lower stack position can't be
+		// alive anymore.
+		while (!frames.empty() && (frames.back().sp <= sp)) frames.pop_back();
+		if (frames.size() < MAX_DEPTH) [[likely]] {
+			frames.push_back(Frame{target, sp});
+		}
+	}
+
+	/** Drop the frames that have been returned from, given the current
+	  * value of SP. */
+	void unwind(uint16_t sp) {
+		while (!frames.empty() && (frames.back().sp < sp)) frames.pop_back();
+	}
+
+	void clear() { frames.clear(); }
+
+	/** Outermost frame first. */
+	[[nodiscard]] std::span<const Frame> getFrames() const { return frames; }
+
+private:
+	// Invariant: 'sp' is strictly decreasing.
+	static_vector<Frame, MAX_DEPTH> frames;
+};
+
+} // namespace openmsx
+
+#endif
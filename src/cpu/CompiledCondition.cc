@@ -0,0 +1,395 @@
+#include "CompiledCondition.hh"
+
+#include "Debuggable.hh"
+#include "Debugger.hh"
+
+#include "narrow.hh"
+#include "one_of.hh"
+#include "stl.hh"
+#include "unreachable.hh"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <utility>
+
+namespace openmsx {
+
+// Same layout as the 'CPU regs' debuggable (see also _cpuregs.tcl).
+static constexpr std::array<std::pair<std::string_view, uint8_t>, 28> regB = {{
+	{"A",    0}, {"F",    1}, {"B",    2}, {"C",    3},
+	{"D",    4}, {"E",    5}, {"H",    6}, {"L",    7},
+	{"A2",   8}, {"F2",   9}, {"B2",  10}, {"C2",  11},
+	{"D2",  12}, {"E2",  13}, {"H2",  14}, {"L2",  15},
+	{"IXH", 16}, {"IXL", 17}, {"IYH", 18}, {"IYL", 19},
+	{"PCH", 20}, {"PCL", 21}, {"SPH", 22}, {"SPL", 23},
+	{"I",   24}, {"R",   25}, {"IM",  26}, {"IFF", 27},
+}};
+static constexpr std::array<std::pair<std::string_view, uint8_t>, 12> regW = {{
+	{"AF",   0}, {"BC",   2}, {"DE",   4}, {"HL",   6},
+	{"AF2",  8}, {"BC2", 10}, {"DE2", 12}, {"HL2", 14},
+	{"IX",  16}, {"IY",  18}, {"PC",  20}, {"SP",  22},
+}};
+
+[[nodiscard]] static bool isSpace(char c)
+{
+	return c == one_of(' ', '\t', '\n', '\r');
+}
+
+[[nodiscard]] static bool isIdentChar(char c)
+{
+	return ((c >= '0') && (c <= '9')) ||
+	       ((c >= 'a') && (c <= 'z')) ||
+	       ((c >= 'A') && (c <= 'Z')) ||
+	       (c == '_');
+}
+
+[[nodiscard]] static std::string toUpper(std::string_view s)
+{
+	std::string result(s);
+	for (auto& c : result) {
+		if ((c >= 'a') && (c <= 'z')) c = char(c - 'a' + 'A');
+	}
+	return result;
+}
+
+// Integer literal as accepted by Tcl expressions. Numbers with a leading
+// zero (octal in Tcl 8) are rejected, as are values that could overflow.
+[[nodiscard]] static std::optional<int64_t> parseNumber(std::string_view s)
+{
+	if (s.empty()) return {};
+	unsigned base = 10;
+	if ((s.size() > 2) && (s[0] == '0')) {
+		switch (s[1]) {
+			case 'x': case 'X': base = 16; break;
+			case 'b': case 'B': base =  2; break;
+			case 'o': case 'O': base =  8; break;
+			default: return {};
+		}
+		s.remove_prefix(2);
+	} else if ((s.size() > 1) && (s[0] == '0')) {
+		return {};
+	}
+	if (s.size() > 32) return {};
+	int64_t result = 0;
+	for (char c : s) {
+		unsigned digit = (c >= '0' && c <= '9') ? unsigned(c - '0')
+		               : (c >= 'a' && c <= 'f') ? unsigned(c - 'a' + 10)
+		               : (c >= 'A' && c <= 'F') ? unsigned(c - 'A' + 10)
+		               : 99;
+		if (digit >= base) return {};
+		result = result * base + digit;
+		if (result > 0xffff'ffff) return {};
+	}
+	return result;
+}
+
+class ConditionParser
+{
+public:
+	explicit ConditionParser(std::string_view expr) : str(expr) {}
+
+	[[nodiscard]] std::optional<CompiledCondition> parse() {
+		if (!parseOr()) return {};
+		skipSpace();
+		if (!str.empty()) return {};
+		assert(depth == 1);
+		return std::move(result);
+	}
+
+private:
+	using OpCode = CompiledCondition::OpCode;
+
+	void skipSpace() {
+		while (!str.empty() && isSpace(str.front())) str.remove_prefix(1);
+	}
+	[[nodiscard]] bool consume(std::string_view token) {
+		skipSpace();
+		if (!str.starts_with(token)) return false;
+		str.remove_prefix(token.size());
+		return true;
+	}
+	// Like consume(), but don't match a prefix of a longer operator,
+	// e.g. '&' in '&&' or '<' in '<='.
+	[[nodiscard]] bool consumeSingle(char c, std::string_view notFollowedBy) {
+		skipSpace();
+		if (str.empty() || (str[0] != c)) return false;
+		if ((str.size() > 1) && contains(notFollowedBy, str[1])) return false;
+		str.remove_prefix(1);
+		return true;
+	}
+
+	[[nodiscard]] bool emit(OpCode code, uint8_t arg = 0, int64_t value = 0) {
+		switch (code) {
+		using enum OpCode;
+		case LITERAL: case READ8: case READ16_LE: case READ16_BE:
+			if (++depth > CompiledCondition::MAX_DEPTH) return false;
+			break;
+		case NOT: case BIT_NOT: case NEG:
+			break;
+		default:
+			assert(depth >= 2);
+			--depth;
+		}
+		result.program.push_back({code, arg, value});
+		return true;
+	}
+
+	[[nodiscard]] bool binary(bool(ConditionParser::*sub)(), auto&& matchOp) {
+		if (!(this->*sub)()) return false;
+		while (true) {
+			auto op = matchOp();
+			if (!op) return true;
+			if (!(this->*sub)()) return false;
+			if (!emit(*op)) return false;
+		}
+	}
+
+	[[nodiscard]] bool parseOr() {
+		return binary(&ConditionParser::parseAnd, [&] {
+			return consume("||") ? std::optional(OpCode::OR) : std::nullopt;
+		});
+	}
+	[[nodiscard]] bool parseAnd() {
+		return binary(&ConditionParser::parseBitOr, [&] {
+			return consume("&&") ? std::optional(OpCode::AND) : std::nullopt;
+		});
+	}
+	[[nodiscard]] bool parseBitOr() {
+		return binary(&ConditionParser::parseBitXor, [&] {
+			return consumeSingle('|', "|") ? std::optional(OpCode::BIT_OR) : std::nullopt;
+		});
+	}
+	[[nodiscard]] bool parseBitXor() {
+		return binary(&ConditionParser::parseBitAnd, [&] {
+			return consume("^") ? std::optional(OpCode::BIT_XOR) : std::nullopt;
+		});
+	}
+	[[nodiscard]] bool parseBitAnd() {
+		return binary(&ConditionParser::parseEquality, [&] {
+			return consumeSingle('&', "&") ? std::optional(OpCode::BIT_AND) : std::nullopt;
+		});
+	}
+	[[nodiscard]] bool parseEquality() {
+		return binary(&ConditionParser::parseRelational, [&]() -> std::optional<OpCode> {
+			if (consume("==")) return OpCode::EQ;
+			if (consume("!=")) return OpCode::NE;
+			return {};
+		});
+	}
+	[[nodiscard]] bool parseRelational() {
+		return binary(&ConditionParser::parseAdditive, [&]() -> std::optional<OpCode> {
+			if (consume("<=")) return OpCode::LE;
+			if (consume(">=")) return OpCode::GE;
+			if (consumeSingle('<', "<")) return OpCode::LT;
+			if (consumeSingle('>', ">")) return OpCode::GT;
+			return {};
+		});
+	}
+	[[nodiscard]] bool parseAdditive() {
+		return binary(&ConditionParser::parseUnary, [&]() -> std::optional<OpCode> {
+			if (consume("+")) return OpCode::ADD;
+			if (consume("-")) return OpCode::SUB;
+			return {};
+		});
+	}
+	[[nodiscard]] bool parseUnary() {
+		if (consumeSingle('!', "=")) return parseUnary() && emit(OpCode::NOT);
+		if (consume("~")) return parseUnary() && emit(OpCode::BIT_NOT);
+		if (consume("-")) return parseUnary() && emit(OpCode::NEG);
+		if (consume("+")) return parseUnary();
+		return parsePrimary();
+	}
+	[[nodiscard]] bool parsePrimary() {
+		if (consume("(")) {
+			return parseOr() && consume(")");
+		}
+		if (consume("[")) {
+			return parseCommand() && consume("]");
+		}
+		skipSpace();
+		size_t len = 0;
+		while ((len < str.size()) && isIdentChar(str[len])) ++len;
+		auto num = parseNumber(str.substr(0, len));
+		if (!num) return false;
+		str.remove_prefix(len);
+		return emit(OpCode::LITERAL, 0, *num);
+	}
+
+	// A single word of a command, without any substitutions.
+	[[nodiscard]] std::optional<std::string_view> parseWord() {
+		while (!str.empty() && (str[0] == one_of(' ', '\t'))) str.remove_prefix(1);
+		if (str.empty()) return {};
+		auto quoted = [&](char close) -> std::optional<std::string_view> {
+			auto end = str.find(close, 1);
+			if (end == std::string_view::npos) return {};
+			auto word = str.substr(1, end - 1);
+			if (word.find_first_of("$[]{}\\\"") != std::string_view::npos) return {};
+			str.remove_prefix(end + 1);
+			if (!str.empty() && (str[0] != one_of(' ', '\t', ']'))) return {};
+			return word;
+		};
+		if (str[0] == '"') return quoted('"');
+		if (str[0] == '{') return quoted('}');
+		size_t len = 0;
+		while ((len < str.size()) && !isSpace(str[len]) && (str[len] != ']')) {
+			if (contains(std::string_view("$[{}\\\";"), str[len])) return {};
+			++len;
+		}
+		if (len == 0) return {};
+		auto word = str.substr(0, len);
+		str.remove_prefix(len);
+		return word;
+	}
+	[[nodiscard]] bool atCommandEnd() {
+		while (!str.empty() && (str[0] == one_of(' ', '\t'))) str.remove_prefix(1);
+		return str.starts_with(']');
+	}
+
+	[[nodiscard]] bool parseCommand() {
+		auto cmd = parseWord();
+		if (!cmd) return false;
+		if (*cmd == "reg") {
+			auto name = parseWord();
+			if (!name || !atCommandEnd()) return false;
+			auto upper = toUpper(*name);
+			if (auto it = std::ranges::find(regB, upper, &std::pair<std::string_view, uint8_t>::first);
+			    it != regB.end()) {
+				return emitRead(OpCode::READ8, "CPU regs", it->second);
+			}
+			if (auto it = std::ranges::find(regW, upper, &std::pair<std::string_view, uint8_t>::first);
+			    it != regW.end()) {
+				return emitRead(OpCode::READ16_BE, "CPU regs", it->second);
+			}
+			return false;
+		} else if (*cmd == "debug") {
+			auto sub = parseWord();
+			if (!sub || (*sub != "read")) return false;
+			auto name = parseWord();
+			if (!name) return false;
+			auto addr = parseWord();
+			if (!addr || !atCommandEnd()) return false;
+			auto a = parseNumber(*addr);
+			return a && emitRead(OpCode::READ8, *name, *a);
+		} else {
+			OpCode code = (*cmd == one_of("peek", "peek8", "peek_u8"))             ? OpCode::READ8
+			            : (*cmd == one_of("peek16", "peek16_LE", "peek_u16")) ? OpCode::READ16_LE
+			            : (*cmd == "peek16_BE")                                      ? OpCode::READ16_BE
+			            : OpCode::LITERAL;
+			if (code == OpCode::LITERAL) return false;
+			auto addr = parseWord();
+			if (!addr) return false;
+			auto a = parseNumber(*addr);
+			if (!a) return false;
+			std::string_view name = "memory";
+			if (!atCommandEnd()) {
+				auto m = parseWord();
+				if (!m || !atCommandEnd()) return false;
+				name = *m;
+			}
+			return emitRead(code, name, *a);
+		}
+	}
+	[[nodiscard]] bool emitRead(OpCode code, std::string_view name, int64_t addr) {
+		auto& names = result.names;
+		auto it = std::ranges::find(names, name);
+		if (it == names.end()) {
+			if (names.size() == 256) return false;
+			names.emplace_back(name);
+			it = names.end() - 1;
+		}
+		return emit(code, narrow<uint8_t>(it - names.begin()), addr);
+	}
+
+private:
+	std::string_view str;
+	CompiledCondition result;
+	unsigned depth = 0;
+};
+
+std::optional<CompiledCondition> CompiledCondition::compile(std::string_view expr)
+{
+	return ConditionParser(expr).parse();
+}
+
+std::optional<int64_t> CompiledCondition::evaluateValue(Lookup lookup) const
+{
+	std::array<int64_t, MAX_DEPTH> stack;
+	unsigned sp = 0;
+	auto read = [&](const Op& op, unsigned offset) -> std::optional<int64_t> {
+		auto* debuggable = lookup(names[op.arg]);
+		if (!debuggable) return {};
+		auto addr = op.value + offset;
+		if (addr >= int64_t(debuggable->getSize())) return {};
+		return debuggable->read(narrow<unsigned>(addr));
+	};
+	for (const auto& op : program) {
+		switch (op.code) {
+		using enum OpCode;
+		case LITERAL:
+			stack[sp++] = op.value;
+			continue;
+		case READ8: {
+			auto v = read(op, 0);
+			if (!v) return {};
+			stack[sp++] = *v;
+			continue;
+		}
+		case READ16_LE:
+		case READ16_BE: {
+			auto v0 = read(op, 0);
+			auto v1 = read(op, 1);
+			if (!v0 || !v1) return {};
+			stack[sp++] = (op.code == READ16_LE) ? (*v0 + 256 * *v1)
+			                                     : (256 * *v0 + *v1);
+			continue;
+		}
+		case NOT:     stack[sp - 1] = !stack[sp - 1]; continue;
+		case BIT_NOT: stack[sp - 1] = ~stack[sp - 1]; continue;
+		case NEG:     stack[sp - 1] = -stack[sp - 1]; continue;
+		default:
+			break;
+		}
+		assert(sp >= 2);
+		auto b = stack[--sp];
+		auto& a = stack[sp - 1];
+		switch (op.code) {
+		using enum OpCode;
+		case ADD:     a = a + b; break;
+		case SUB:     a = a - b; break;
+		case BIT_AND: a = a & b; break;
+		case BIT_XOR: a = a ^ b; break;
+		case BIT_OR:  a = a | b; break;
+		case EQ:      a = a == b; break;
+		case NE:      a = a != b; break;
+		case LT:      a = a <  b; break;
+		case LE:      a = a <= b; break;
+		case GT:      a = a >  b; break;
+		case GE:      a = a >= b; break;
+		case AND:     a = a && b; break;
+		case OR:      a = a || b; break;
+		default: UNREACHABLE;
+		}
+	}
+	assert(sp == 1);
+	return stack[0];
+}
+
+std::optional<int64_t> CompiledCondition::evaluateValue(Debugger& debugger) const
+{
+	return evaluateValue([&](std::string_view name) { return debugger.findDebuggable(name); });
+}
+
+std::optional<bool> CompiledCondition::evaluate(Lookup lookup) const
+{
+	if (auto v = evaluateValue(lookup)) return *v != 0;
+	return {};
+}
+
+std::optional<bool> CompiledCondition::evaluate(Debugger& debugger) const
+{
+	if (auto v = evaluateValue(debugger)) return *v != 0;
+	return {};
+}
+
+} // namespace openmsx
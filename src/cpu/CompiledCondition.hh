@@ -0,0 +1,76 @@
+#ifndef COMPILEDCONDITION_HH
+#define COMPILEDCONDITION_HH
+
+#include "function_ref.hh"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openmsx {
+
+class Debuggable;
+class Debugger;
+
+/** Native evaluator for a common subset of breakpoint conditions.
+ *
+ * Evaluating a condition via the Tcl interpreter on every hit is relatively
+ * expensive, mostly because of the (script) procs 'reg' and 'peek' that
+ * typically appear in it. Conditions that only consist of
+ *  - integer literals,
+ *  - [reg <name>], [peek <addr>], [peek16 <addr>] (and their aliases),
+ *  - [debug read <debuggable> <addr>],
+ *  - the operators ! ~ - + & ^ | == != < <= > >= && || and parentheses
+ * are translated into a small stack program that reads the debuggables
+ * directly. The same program can also compute the integer value of such an
+ * expression (e.g. for watch expressions).
+ *
+ * When the condition can't be compiled, or when evaluation hits something
+ * the Tcl version would report as an error (unknown debuggable, address
+ * out of range), the caller should fall back to the Tcl evaluation. Note
+ * that this assumes the 'reg' and 'peek' procs have their standard
+ * definitions.
+ */
+class CompiledCondition
+{
+public:
+	using Lookup = function_ref<Debuggable*(std::string_view)>;
+
+	/** Returns std::nullopt if 'expr' is not in the supported subset. */
+	[[nodiscard]] static std::optional<CompiledCondition> compile(std::string_view expr);
+
+	/** Returns std::nullopt if the result must be obtained via Tcl. */
+	[[nodiscard]] std::optional<bool> evaluate(Lookup lookup) const;
+	[[nodiscard]] std::optional<bool> evaluate(Debugger& debugger) const;
+
+	/** Like evaluate(), but returns the integer value of the expression. */
+	[[nodiscard]] std::optional<int64_t> evaluateValue(Lookup lookup) const;
+	[[nodiscard]] std::optional<int64_t> evaluateValue(Debugger& debugger) const;
+
+private:
+	enum class OpCode : uint8_t {
+		LITERAL,
+		READ8, READ16_LE, READ16_BE, // arg = debuggable index, value = address
+		NOT, BIT_NOT, NEG,
+		ADD, SUB, BIT_AND, BIT_XOR, BIT_OR,
+		EQ, NE, LT, LE, GT, GE,
+		AND, OR,
+	};
+	struct Op {
+		OpCode code;
+		uint8_t arg = 0;
+		int64_t value = 0;
+	};
+	static constexpr unsigned MAX_DEPTH = 16;
+
+	std::vector<Op> program; // in postfix order
+	std::vector<std::string> names; // debuggable names, indexed by Op::arg
+
+	friend class ConditionParser;
+};
+
+} // namespace openmsx
+
+#endif
@@ -8,6 +8,8 @@
 #include "Debugger.hh"
 #include "IntegerSetting.hh"
 #include "MSXMotherBoard.hh"
+#include "PerfMonitor.hh"
+#include "PerfTrace.hh"
 #include "Scheduler.hh"
 #include "TclObject.hh"
 #include "serialize.hh"
@@ -75,6 +77,18 @@ void MSXCPU::setInterface(MSXCPUInterface* interface_)
 	if (r800) r800->setInterface(interface);
 }
 
+void MSXCPU::setInstructionTrace(InstructionTraceWriter* trace)
+{
+	          z80 ->setInstructionTrace(trace);
+	if (r800) r800->setInstructionTrace(trace);
+}
+
+void MSXCPU::setCallStack(CallStackShadow* stack)
+{
+	          z80 ->setCallStack(stack);
+	if (r800) r800->setCallStack(stack);
+}
+
 void MSXCPU::doReset(EmuTime time)
 {
 	          z80 ->doReset(time);
@@ -102,6 +116,8 @@ void MSXCPU::setDRAMmode(bool dram)
 
 void MSXCPU::execute(bool fastForward)
 {
+	PerfMonitor::Scope perf(PerfMonitor::Section::CPU);
+	PerfTrace::Span trace("cpu", "execute", getCurrentTime());
 	if (z80Active != newZ80Active) {
 		EmuTime time = getCurrentTime();
 		z80Active = newZ80Active;
@@ -130,6 +146,18 @@ void MSXCPU::exitCPULoopAsync()
 	          : r800->exitCPULoopAsync();
 }
 
+CPUExitStats MSXCPU::getExitStats() const
+{
+	auto result = z80->getExitStats();
+	if (r800) result += r800->getExitStats();
+	return result;
+}
+void MSXCPU::resetExitStats()
+{
+	z80->resetExitStats();
+	if (r800) r800->resetExitStats();
+}
+
 EmuTime MSXCPU::getCurrentTime() const
 {
 	return z80Active ? z80 ->getCurrentTime()
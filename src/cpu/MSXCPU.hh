@@ -18,6 +18,8 @@
 
 namespace openmsx {
 
+class CallStackShadow;
+class InstructionTraceWriter;
 class MSXMotherBoard;
 class MSXCPUInterface;
 class CPUClock;
@@ -25,6 +27,7 @@ class CPURegs;
 class Z80TYPE;
 class R800TYPE;
 template<typename T> class CPUCore;
+struct CPUExitStats;
 class TclObject;
 class Interpreter;
 
@@ -129,6 +132,10 @@ public:
 	/** See CPUCore::exitCPULoopAsync() */
 	void exitCPULoopAsync();
 
+	/** Summed over the Z80 and R800, see CPUExitStats. */
+	[[nodiscard]] CPUExitStats getExitStats() const;
+	void resetExitStats();
+
 	/** Is the R800 currently active? */
 	[[nodiscard]] bool isR800Active() const { return !z80Active; }
 
@@ -137,6 +144,12 @@ public:
 
 	void setInterface(MSXCPUInterface* interface);
 
+	/** See CPUCore::setInstructionTrace() */
+	void setInstructionTrace(InstructionTraceWriter* trace);
+
+	/** See CPUCore::setCallStack() */
+	void setCallStack(CallStackShadow* stack);
+
 	/** (un)pause CPU. During pause the CPU executes NOP instructions
 	  * continuously (just like during HALT). Used by turbor hw pause. */
 	void setPaused(bool paused);
@@ -49,6 +49,7 @@ static unsigned breakedSettingCount = 0;
 static constexpr uint8_t SECONDARY_SLOT_BIT = 0x01;
 static constexpr uint8_t MEMORY_WATCH_BIT   = 0x02;
 static constexpr uint8_t GLOBAL_RW_BIT      = 0x04;
+static constexpr uint8_t ACCESS_PROFILE_BIT = 0x08;
 
 std::ostream& operator<<(std::ostream& os, EnumTypeName<CacheLineCounters>)
 {
@@ -200,6 +201,9 @@ uint8_t MSXCPUInterface::readMemSlow(uint16_t address, EmuTime time)
 				g.device->globalRead(address, time);
 			}
 		}
+		if (accessProfiling) {
+			++accessProfile->memRead[getProfileSlot(address)][address >> 8];
+		}
 		// execute read watches before actual read
 		if (readWatchSet[address >> CacheLine::BITS]
 		                [address &  CacheLine::LOW]) {
@@ -216,6 +220,10 @@ uint8_t MSXCPUInterface::readMemSlow(uint16_t address, EmuTime time)
 void MSXCPUInterface::writeMemSlow(uint16_t address, uint8_t value, EmuTime time)
 {
 	tick(CacheLineCounters::DisallowCacheWrite);
+	if (accessProfiling) [[unlikely]] {
+		// before the write, it may change the slot selection
+		++accessProfile->memWrite[getProfileSlot(address)][address >> 8];
+	}
 	if ((address == 0xFFFF) && isExpanded(primarySlotState[3])) [[unlikely]] {
 		setSubSlot(primarySlotState[3], value);
 		// Confirmed on turboR GT machine: write does _not_ also go to
@@ -870,12 +878,14 @@ void MSXCPUInterface::insertBreakPoint(BreakPoint bp)
 {
 	cliComm.update(CliComm::UpdateType::DEBUG_UPDT, bp.getIdStr(), "add");
 	breakPoints.push_back(std::move(bp));
+	breakPointsDirty = true;
 }
 
 void MSXCPUInterface::removeBreakPoint(const BreakPoint& bp)
 {
 	cliComm.update(CliComm::UpdateType::DEBUG_UPDT, bp.getIdStr(), "remove");
 	breakPoints.erase(find_unguarded(breakPoints, &bp, [](const BreakPoint& i) { return &i; }));
+	breakPointsDirty = true;
 }
 void MSXCPUInterface::removeBreakPoint(unsigned id)
 {
@@ -884,10 +894,22 @@ void MSXCPUInterface::removeBreakPoint(unsigned id)
 	    it != breakPoints.end()) {
 		cliComm.update(CliComm::UpdateType::DEBUG_UPDT, it->getIdStr(), "remove");
 		breakPoints.erase(it);
+		breakPointsDirty = true;
+	}
+}
+
+void MSXCPUInterface::updateBreakPointAddresses()
+{
+	breakPointAddresses.reset();
+	for (const auto& bp : breakPoints) {
+		if (!bp.isEnabled()) continue;
+		if (auto addr = bp.getAddress()) breakPointAddresses.set(*addr);
 	}
+	anyEnabledCondition = std::ranges::any_of(conditions, &DebugCondition::isEnabled);
+	breakPointsDirty = false;
 }
 
-bool MSXCPUInterface::checkBreakPoints(unsigned pc)
+bool MSXCPUInterface::checkBreakPointsSlow(unsigned pc)
 {
 	// create copy for the case that breakpoint/condition removes itself
 	//  - avoids iterating over a changing collection
@@ -903,15 +925,16 @@ bool MSXCPUInterface::checkBreakPoints(unsigned pc)
 
 	auto& globalCliComm = motherBoard.getReactor().getGlobalCliComm();
 	auto& interp        = motherBoard.getReactor().getInterpreter();
+	auto& debugger      = motherBoard.getDebugger();
 	auto scopedBlock = motherBoard.getStateChangeDistributor().tempBlockNewEventsDuringReplay();
 	for (auto& p : bpCopy) {
-		bool remove = p.checkAndExecute(globalCliComm, interp);
+		bool remove = p.checkAndExecute(globalCliComm, interp, debugger);
 		if (remove) {
 			removeBreakPoint(p.getId());
 		}
 	}
 	for (auto& c : condCopy) {
-		bool remove = c.checkAndExecute(globalCliComm, interp);
+		bool remove = c.checkAndExecute(globalCliComm, interp, debugger);
 		if (remove) {
 			removeCondition(c.getId());
 		}
@@ -992,6 +1015,7 @@ void MSXCPUInterface::setCondition(DebugCondition cond)
 {
 	cliComm.update(CliComm::UpdateType::DEBUG_UPDT, cond.getIdStr(), "add");
 	conditions.push_back(std::move(cond));
+	breakPointsDirty = true;
 }
 
 void MSXCPUInterface::removeCondition(const DebugCondition& cond)
@@ -999,6 +1023,7 @@ void MSXCPUInterface::removeCondition(const DebugCondition& cond)
 	cliComm.update(CliComm::UpdateType::DEBUG_UPDT, cond.getIdStr(), "remove");
 	conditions.erase(rfind_unguarded(conditions, &cond,
 	                                 [](auto& e) { return &e; }));
+	breakPointsDirty = true;
 }
 
 void MSXCPUInterface::removeCondition(unsigned id)
@@ -1008,6 +1033,7 @@ void MSXCPUInterface::removeCondition(unsigned id)
 	    it != conditions.end()) {
 		cliComm.update(CliComm::UpdateType::DEBUG_UPDT, it->getIdStr(), "remove");
 		conditions.erase(it);
+		breakPointsDirty = true;
 	}
 }
 
@@ -1045,6 +1071,41 @@ void MSXCPUInterface::updateMemWatch(WatchPoint::Type type)
 	msxcpu.invalidateAllSlotsRWCache(0x0000, 0x10000);
 }
 
+unsigned MSXCPUInterface::getProfileSlot(uint16_t address) const
+{
+	auto page = address >> 14;
+	auto ps = primarySlotState[page];
+	auto ss = isExpanded(ps) ? secondarySlotState[page] : 0;
+	return 4 * ps + ss;
+}
+
+void MSXCPUInterface::setAccessProfiling(bool enable)
+{
+	if (enable == accessProfiling) return;
+	if (enable && !accessProfile) {
+		accessProfile = std::make_unique<AccessProfile>(); // zero-initialized
+	}
+	accessProfiling = enable;
+
+	// Route all memory accesses via readMemSlow()/writeMemSlow(), so
+	// that the fast path doesn't need an extra check.
+	for (auto i : xrange(CacheLine::NUM)) {
+		if (enable) {
+			disallowReadCache [i] |=  ACCESS_PROFILE_BIT;
+			disallowWriteCache[i] |=  ACCESS_PROFILE_BIT;
+		} else {
+			disallowReadCache [i] &= ~ACCESS_PROFILE_BIT;
+			disallowWriteCache[i] &= ~ACCESS_PROFILE_BIT;
+		}
+	}
+	msxcpu.invalidateAllSlotsRWCache(0x0000, 0x10000);
+}
+
+void MSXCPUInterface::clearAccessProfile()
+{
+	if (accessProfile) *accessProfile = {};
+}
+
 void MSXCPUInterface::executeMemWatch(WatchPoint::Type type,
                                       unsigned address, unsigned value)
 {
@@ -1053,6 +1114,7 @@ void MSXCPUInterface::executeMemWatch(WatchPoint::Type type,
 
 	auto& globalCliComm = motherBoard.getReactor().getGlobalCliComm();
 	auto& interp        = motherBoard.getReactor().getInterpreter();
+	auto& debugger      = motherBoard.getDebugger();
 	interp.setVariable(TclObject("wp_last_address"),
 	                   TclObject(int(address)));
 	if (value != ~0u) {
@@ -1065,7 +1127,7 @@ void MSXCPUInterface::executeMemWatch(WatchPoint::Type type,
 		if ((w->getBeginAddress() <= address) &&
 		    (w->getEndAddress()   >= address) &&
 		    (w->getType()         == type)) {
-			bool remove = w->checkAndExecute(globalCliComm, interp);
+			bool remove = w->checkAndExecute(globalCliComm, interp, debugger);
 			if (remove) {
 				removeWatchPoint(w);
 			}
@@ -1125,6 +1187,7 @@ void MSXCPUInterface::cleanup()
 	//      global objects.
 	breakPoints.clear();
 	conditions.clear();
+	breakPointsDirty = true;
 }
 
 MSXDevice* MSXCPUInterface::getMSXDevice(int ps, int ss, int page)
@@ -164,6 +164,7 @@ public:
 	 * @see MSXDevice::readIO()
 	 */
 	uint8_t readIO(uint16_t port, EmuTime time) {
+		if (accessProfiling) [[unlikely]] ++accessProfile->ioRead[port & 0xFF];
 		return IO_In[port & 0xFF]->readIO(port, time);
 	}
 
@@ -172,6 +173,7 @@ public:
 	 * @see MSXDevice::writeIO()
 	 */
 	void writeIO(uint16_t port, uint8_t value, EmuTime time) {
+		if (accessProfiling) [[unlikely]] ++accessProfile->ioWrite[port & 0xFF];
 		IO_Out[port & 0xFF]->writeIO(port, value, time);
 	}
 
@@ -264,7 +266,10 @@ public:
 	void removeBreakPoint(const BreakPoint& bp);
 	void removeBreakPoint(unsigned id);
 	using BreakPoints = std::vector<BreakPoint>;
-	[[nodiscard]] static BreakPoints& getBreakPoints() { return breakPoints; }
+	[[nodiscard]] static BreakPoints& getBreakPoints() {
+		breakPointsDirty = true; // caller may modify them
+		return breakPoints;
+	}
 
 	void setWatchPoint(const std::shared_ptr<WatchPoint>& watchPoint);
 	void removeWatchPoint(std::shared_ptr<WatchPoint> watchPoint);
@@ -302,7 +307,10 @@ public:
 	void removeCondition(const DebugCondition& cond);
 	void removeCondition(unsigned id);
 	using Conditions = std::vector<DebugCondition>;
-	[[nodiscard]] static Conditions& getConditions() { return conditions; }
+	[[nodiscard]] static Conditions& getConditions() {
+		breakPointsDirty = true; // caller may modify them
+		return conditions;
+	}
 
 	[[nodiscard]] static bool isBreaked() { return breaked; }
 	void doBreak();
@@ -314,7 +322,14 @@ public:
 	{
 		return !breakPoints.empty() || !conditions.empty();
 	}
-	[[nodiscard]] bool checkBreakPoints(unsigned pc);
+	[[nodiscard]] bool checkBreakPoints(unsigned pc)
+	{
+		if (breakPointsDirty) [[unlikely]] updateBreakPointAddresses();
+		if (!anyEnabledCondition && !breakPointAddresses[pc]) [[likely]] {
+			return false;
+		}
+		return checkBreakPointsSlow(pc);
+	}
 
 	// cleanup global variables
 	static void cleanup();
@@ -324,6 +339,25 @@ public:
 	void setFastForward(bool fastForward_) { fastForward = fastForward_; }
 	[[nodiscard]] bool isFastForward() const { return fastForward; }
 
+	// Memory and I/O access profiling: count the number of reads and
+	// writes per 256-byte memory page (separately for each slot) and per
+	// I/O port.
+	struct AccessProfile {
+		using Counts = std::array<uint64_t, 256>;
+		std::array<Counts, 16> memRead;  // indexed by '4 * ps + ss'
+		std::array<Counts, 16> memWrite;
+		Counts ioRead;
+		Counts ioWrite;
+	};
+	/** While enabled, memory accesses no longer go via the CPU cache
+	  * lines, so emulation becomes (a lot) slower. Disabling keeps the
+	  * collected counts. */
+	void setAccessProfiling(bool enable);
+	[[nodiscard]] bool isAccessProfiling() const { return accessProfiling; }
+	void clearAccessProfile();
+	/** Returns nullptr when profiling was never enabled. */
+	[[nodiscard]] const AccessProfile* getAccessProfile() const { return accessProfile.get(); }
+
 	[[nodiscard]] MSXDevice* getMSXDevice(int ps, int ss, int page);
 	[[nodiscard]] MSXDevice* getVisibleMSXDevice(int page) { return visibleDevices[page]; }
 
@@ -349,8 +383,12 @@ private:
 	void registerWatchPoint(WatchPoint& wp);
 	void unregisterWatchPoint(WatchPoint& wp);
 
+	static void updateBreakPointAddresses();
+	[[nodiscard]] bool checkBreakPointsSlow(unsigned pc);
+
 	void removeAllWatchPoints();
 	void updateMemWatch(WatchPoint::Type type);
+	[[nodiscard]] unsigned getProfileSlot(uint16_t address) const;
 	void executeMemWatch(WatchPoint::Type type, unsigned address,
 	                     unsigned value = ~0u);
 
@@ -446,6 +484,10 @@ private:
 	std::vector<GlobalRwInfo> globalReads;
 	std::vector<GlobalRwInfo> globalWrites;
 
+	// IO dispatch: one (virtual) call per access. Only when a port is
+	// really shared (MSXMultiIODevice) or watched (MSXWatchIODevice) there
+	// is an extra level of indirection. Both are rare, so there's no need
+	// for anything fancier (function pointers, per-device fast paths).
 	std::array<MSXDevice*, 256> IO_In;
 	std::array<MSXDevice*, 256> IO_Out;
 	std::array<std::array<std::array<MSXDevice*, 4>, 4>, 4> slotLayout;
@@ -458,8 +500,16 @@ private:
 
 	bool fastForward = false; // no need to serialize
 
+	std::unique_ptr<AccessProfile> accessProfile; // no need to serialize
+	bool accessProfiling = false;
+
 	//  All CPUs (Z80 and R800) of all MSX machines share this state.
 	static inline BreakPoints breakPoints; // unsorted
+	// Addresses of all enabled breakpoints, allows a quick rejection in
+	// checkBreakPoints(). Recalculated when 'breakPointsDirty' is set.
+	static inline std::bitset<0x10000> breakPointAddresses;
+	static inline bool anyEnabledCondition = false;
+	static inline bool breakPointsDirty = true;
 	WatchPoints watchPoints; // ordered in creation order,  TODO must also be static
 	static inline Conditions conditions; // ordered in creation order
 	static inline bool breaked = false;
@@ -82,10 +82,11 @@ protected:
 			// there is a statically predictable page break at this
 			// point -> 'add(1)' moved to static cost table
 		} else {
-			if ((newPage != lastPage) ||
-			    (extraMemoryDelay[address >> 14])) [[unlikely]] {
-				add(1);
-			}
+			// Computed without branches: whether there's a page break
+			// depends on the data access pattern of the emulated
+			// program and is hard to predict.
+			add(unsigned((newPage != lastPage) |
+			             (extraMemoryDelay[address >> 14] != 0)));
 		}
 		if constexpr (!POST_PB) {
 			lastPage = newPage;
@@ -110,11 +111,7 @@ protected:
 				add(1);
 			}
 		} else {
-			if (extraMemoryDelay[address >> 14]) [[unlikely]] {
-				add(2);
-			} else if (newPage != lastPage) [[unlikely]] {
-				add(1);
-			}
+			add(extraMemoryDelay[address >> 14] ? 2 : unsigned(newPage != lastPage));
 		}
 		if constexpr (!POST_PB) {
 			lastPage = newPage;
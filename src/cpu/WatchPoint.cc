@@ -67,7 +67,7 @@ void WatchPoint::doReadCallback(MSXMotherBoard& motherBoard, unsigned port)
 	// this watchpoint deletes itself in checkAndExecute()
 	auto keepAlive = shared_from_this();
 	auto scopedBlock = motherBoard.getStateChangeDistributor().tempBlockNewEventsDuringReplay();
-	if (bool remove = checkAndExecute(cliComm, interp); remove) {
+	if (bool remove = checkAndExecute(cliComm, interp, motherBoard.getDebugger()); remove) {
 		cpuInterface.removeWatchPoint(keepAlive);
 	}
 
@@ -88,7 +88,7 @@ void WatchPoint::doWriteCallback(MSXMotherBoard& motherBoard, unsigned port, uns
 	// see comment in doReadCallback() above
 	auto keepAlive = shared_from_this();
 	auto scopedBlock = motherBoard.getStateChangeDistributor().tempBlockNewEventsDuringReplay();
-	if (bool remove = checkAndExecute(cliComm, interp); remove) {
+	if (bool remove = checkAndExecute(cliComm, interp, motherBoard.getDebugger()); remove) {
 		cpuInterface.removeWatchPoint(keepAlive);
 	}
 
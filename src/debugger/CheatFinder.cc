@@ -0,0 +1,193 @@
+#include "CheatFinder.hh"
+
+#include "Debuggable.hh"
+
+#include "narrow.hh"
+#include "one_of.hh"
+#include "unreachable.hh"
+#include "xrange.hh"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <span>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace openmsx {
+
+static constexpr size_t WORD_BITS = 64;
+static constexpr size_t WORDS_PER_PAGE = CheatFinder::PAGE_SIZE / WORD_BITS;
+
+std::optional<CheatFinder::Compare> CheatFinder::parseCompare(std::string_view str)
+{
+	if (str == "==") return Compare::EQUAL;
+	if (str == "!=") return Compare::NOT_EQUAL;
+	if (str == "<" ) return Compare::LESS;
+	if (str == "<=") return Compare::LESS_EQUAL;
+	if (str == ">" ) return Compare::GREATER;
+	if (str == ">=") return Compare::GREATER_EQUAL;
+	return {};
+}
+
+// The strict comparisons are computed as the negation of the non-strict
+// ones (e.g. 'a < b' as '!(a >= b)'), because that's what SSE2 offers
+// for unsigned bytes.
+[[nodiscard]] static constexpr bool isNegated(CheatFinder::Compare op)
+{
+	using enum CheatFinder::Compare;
+	return op == one_of(NOT_EQUAL, LESS, GREATER);
+}
+
+template<CheatFinder::Compare OP>
+[[nodiscard]] static uint64_t compare64(const uint8_t* newValues, const uint8_t* ref)
+{
+	using enum CheatFinder::Compare;
+	uint64_t result = 0;
+#ifdef __SSE2__
+	for (auto i : xrange(WORD_BITS / 16)) {
+		auto a = _mm_loadu_si128(std::bit_cast<const __m128i*>(newValues + 16 * i));
+		auto b = _mm_loadu_si128(std::bit_cast<const __m128i*>(ref       + 16 * i));
+		auto m = [&] {
+			if constexpr (OP == one_of(EQUAL, NOT_EQUAL)) {
+				return _mm_cmpeq_epi8(a, b);
+			} else if constexpr (OP == one_of(LESS_EQUAL, GREATER)) {
+				return _mm_cmpeq_epi8(_mm_min_epu8(a, b), a); // a <= b
+			} else {
+				return _mm_cmpeq_epi8(_mm_max_epu8(a, b), a); // a >= b
+			}
+		}();
+		result |= uint64_t(uint16_t(_mm_movemask_epi8(m))) << (16 * i);
+	}
+#else
+	for (auto i : xrange(WORD_BITS)) {
+		auto a = newValues[i];
+		auto b = ref[i];
+		bool r = [&] {
+			if constexpr (OP == one_of(EQUAL, NOT_EQUAL)) {
+				return a == b;
+			} else if constexpr (OP == one_of(LESS_EQUAL, GREATER)) {
+				return a <= b;
+			} else {
+				return a >= b;
+			}
+		}();
+		result |= uint64_t(r) << i;
+	}
+#endif
+	return isNegated(OP) ? ~result : result;
+}
+
+// Call 'f' with a pointer to the compare function for the given operator.
+template<typename F>
+static decltype(auto) dispatch(CheatFinder::Compare op, F f)
+{
+	using enum CheatFinder::Compare;
+	switch (op) {
+		case EQUAL:         return f(&compare64<EQUAL>);
+		case NOT_EQUAL:     return f(&compare64<NOT_EQUAL>);
+		case LESS:          return f(&compare64<LESS>);
+		case LESS_EQUAL:    return f(&compare64<LESS_EQUAL>);
+		case GREATER:       return f(&compare64<GREATER>);
+		case GREATER_EQUAL: return f(&compare64<GREATER_EQUAL>);
+		default: UNREACHABLE;
+	}
+}
+
+uint64_t CheatFinder::compare64(Compare op, const uint8_t* newValues, const uint8_t* ref)
+{
+	return dispatch(op, [&](auto* cmp) { return cmp(newValues, ref); });
+}
+
+void CheatFinder::start(std::string name, Debuggable& debuggable)
+{
+	debuggableName = std::move(name);
+	memSize = debuggable.getSize();
+	auto numWords = (memSize + WORD_BITS - 1) / WORD_BITS;
+
+	newValues.assign(numWords * WORD_BITS, 0);
+	debuggable.readBlock(0, std::span{newValues.data(), memSize});
+	oldValues = newValues;
+
+	candidates.assign(numWords, ~uint64_t(0));
+	if (auto tail = memSize % WORD_BITS) {
+		candidates.back() = (uint64_t(1) << tail) - 1;
+	}
+	numCandidates = memSize;
+}
+
+size_t CheatFinder::search(Debuggable& debuggable, Compare op, std::optional<uint8_t> value)
+{
+	assert(isStarted());
+	assert(debuggable.getSize() == memSize);
+
+	std::array<uint8_t, WORD_BITS> splat;
+	if (value) splat.fill(*value);
+
+	// For 'new <op> old' on a page that didn't change at all, all
+	// candidates of that page either remain or all are dropped.
+	bool keepUnchanged = !isNegated(op);
+
+	numCandidates = 0;
+	dispatch(op, [&](auto* cmp) {
+		for (size_t page = 0; page * PAGE_SIZE < memSize; ++page) {
+			auto w0 = page * WORDS_PER_PAGE;
+			auto w1 = std::min(w0 + WORDS_PER_PAGE, candidates.size());
+			auto words = std::span{candidates}.subspan(w0, w1 - w0);
+			if (std::ranges::all_of(words, [](uint64_t w) { return w == 0; })) {
+				continue; // no candidates left, don't even read this page
+			}
+
+			auto begin = page * PAGE_SIZE;
+			auto num = std::min(PAGE_SIZE, memSize - begin);
+			auto oldPage = std::span{oldValues}.subspan(begin, num);
+			auto newPage = std::span{newValues}.subspan(begin, num);
+			std::ranges::copy(newPage, oldPage.begin());
+			debuggable.readBlock(narrow<unsigned>(begin), newPage);
+
+			if (!value && std::ranges::equal(oldPage, newPage)) {
+				if (!keepUnchanged) std::ranges::fill(words, 0);
+			} else {
+				for (auto i : xrange(words.size())) {
+					if (words[i] == 0) continue;
+					auto offset = begin + i * WORD_BITS;
+					const auto* ref = value ? splat.data() : &oldValues[offset];
+					words[i] &= cmp(&newValues[offset], ref);
+				}
+			}
+			for (auto w : words) numCandidates += std::popcount(w);
+		}
+	});
+	return numCandidates;
+}
+
+void CheatFinder::clear()
+{
+	debuggableName.clear();
+	candidates = {};
+	oldValues = {};
+	newValues = {};
+	memSize = 0;
+	numCandidates = 0;
+}
+
+std::vector<CheatFinder::Result> CheatFinder::getResults(size_t max) const
+{
+	std::vector<Result> result;
+	result.reserve(std::min(max, numCandidates));
+	for (auto i : xrange(candidates.size())) {
+		for (auto w = candidates[i]; w; w &= w - 1) {
+			if (result.size() == max) return result;
+			auto addr = i * WORD_BITS + size_t(std::countr_zero(w));
+			result.push_back({.address = narrow<unsigned>(addr),
+			                  .oldValue = oldValues[addr],
+			                  .newValue = newValues[addr]});
+		}
+	}
+	return result;
+}
+
+} // namespace openmsx
@@ -0,0 +1,76 @@
+#ifndef CHEATFINDER_HH
+#define CHEATFINDER_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openmsx {
+
+class Debuggable;
+
+/** Search engine for the cheat finder: narrow down the locations in a
+  * debuggable whose value changed in a given way between two searches.
+  *
+  * The remaining candidates are stored as a bitset (one bit per location),
+  * the values as two full copies (of the previous and the current search).
+  * A search only reads the 4kB pages of the debuggable that still contain
+  * candidates, and compares 64 locations at once (with SSE2 when
+  * available). So narrowing down a search that's already down to a few
+  * locations is cheap, even for a 4MB memory mapper.
+  */
+class CheatFinder
+{
+public:
+	enum class Compare : uint8_t {
+		EQUAL, NOT_EQUAL, LESS, LESS_EQUAL, GREATER, GREATER_EQUAL
+	};
+	static constexpr size_t PAGE_SIZE = 4096; // granularity of reading the debuggable
+
+	struct Result {
+		unsigned address;
+		uint8_t oldValue;
+		uint8_t newValue;
+	};
+
+	/** Parse "==", "!=", "<", "<=", ">" or ">=". */
+	[[nodiscard]] static std::optional<Compare> parseCompare(std::string_view str);
+
+	/** Compare 64 consecutive values: bit 'i' in the result is set when
+	  * 'newValues[i] <op> ref[i]' holds. */
+	[[nodiscard]] static uint64_t compare64(Compare op, const uint8_t* newValues, const uint8_t* ref);
+
+	/** (Re)start a search: all locations of the debuggable are candidates. */
+	void start(std::string name, Debuggable& debuggable);
+
+	/** Keep only the candidates for which 'new <op> old' holds, or
+	  * 'new <op> value' when a value is given.
+	  * @return the number of remaining candidates */
+	size_t search(Debuggable& debuggable, Compare op, std::optional<uint8_t> value = {});
+
+	/** Stop searching, releases the memory. */
+	void clear();
+
+	[[nodiscard]] bool isStarted() const { return !candidates.empty(); }
+	[[nodiscard]] const std::string& getDebuggableName() const { return debuggableName; }
+	[[nodiscard]] size_t getMemorySize() const { return memSize; }
+	[[nodiscard]] size_t getNumCandidates() const { return numCandidates; }
+
+	/** The remaining candidates in increasing address order, at most 'max'. */
+	[[nodiscard]] std::vector<Result> getResults(size_t max = size_t(-1)) const;
+
+private:
+	std::string debuggableName;
+	std::vector<uint64_t> candidates; // one bit per location
+	std::vector<uint8_t> oldValues; // size rounded up to a multiple of 64
+	std::vector<uint8_t> newValues; // idem
+	size_t memSize = 0;
+	size_t numCandidates = 0;
+};
+
+} // namespace openmsx
+
+#endif
@@ -32,6 +32,14 @@ public:
 		}
 	}
 
+	virtual void writeBlock(unsigned start, std::span<const uint8_t> input) {
+		// default implementation, subclasses may override it with a more efficient version
+		assert(narrow<unsigned>(start + input.size()) <= getSize());
+		for (auto i : xrange(input.size())) {
+			write(narrow_cast<unsigned>(start + i), input[i]);
+		}
+	}
+
 protected:
 	Debuggable() = default;
 	~Debuggable() = default;
@@ -6,12 +6,18 @@
 #include "Dasm.hh"
 #include "DebugCondition.hh"
 #include "Debuggable.hh"
+#include "File.hh"
+#include "FileContext.hh"
+#include "FileException.hh"
+#include "FileOperations.hh"
+#include "InstructionTraceWriter.hh"
 #include "MSXCPU.hh"
 #include "MSXCPUInterface.hh"
 #include "MSXCliComm.hh"
 #include "MSXMotherBoard.hh"
 #include "ProbeBreakPoint.hh"
 #include "Reactor.hh"
+#include "SamplingProfiler.hh"
 #include "SymbolManager.hh"
 #include "TclArgParser.hh"
 #include "TclObject.hh"
@@ -52,6 +58,7 @@ void Debugger::registerDebuggable(std::string name, Debuggable& debuggable)
 {
 	assert(!debuggables.contains(name));
 	debuggables.emplace_noDuplicateCheck(std::move(name), &debuggable);
+	lastDebuggable = nullptr;
 }
 
 void Debugger::unregisterDebuggable(std::string_view name, Debuggable& debuggable)
@@ -59,6 +66,33 @@ void Debugger::unregisterDebuggable(std::string_view name, Debuggable& debuggabl
 	assert(debuggables.contains(name));
 	assert(debuggables[name] == &debuggable); (void)debuggable;
 	debuggables.erase(name);
+	lastDebuggable = nullptr;
+}
+
+void Debugger::startInstructionTrace(const std::string& filename)
+{
+	stopInstructionTrace(); // a new trace replaces the current one
+	instructionTrace = std::make_unique<InstructionTraceWriter>(filename);
+	if (cpu) cpu->setInstructionTrace(instructionTrace.get());
+}
+
+void Debugger::stopInstructionTrace()
+{
+	if (cpu) cpu->setInstructionTrace(nullptr);
+	instructionTrace.reset(); // flushes the file
+}
+
+void Debugger::startProfiler(EmuDuration interval)
+{
+	stopProfiler();
+	profiler = std::make_unique<SamplingProfiler>(*this, interval);
+	if (cpu) cpu->setCallStack(&profiler->getCallStack());
+}
+
+void Debugger::stopProfiler()
+{
+	if (cpu) cpu->setCallStack(nullptr);
+	profiler.reset();
 }
 
 Debuggable* Debugger::findDebuggable(std::string_view name)
@@ -76,6 +110,18 @@ Debuggable& Debugger::getDebuggable(std::string_view name)
 	return *result;
 }
 
+Debuggable& Debugger::getDebuggable(const TclObject& name)
+{
+	if (lastDebuggable &&
+	    (name.getTclObjectNonConst() == lastDebuggableName.getTclObjectNonConst())) {
+		return *lastDebuggable;
+	}
+	auto& result = getDebuggable(name.getString());
+	lastDebuggableName = name;
+	lastDebuggable = &result;
+	return result;
+}
+
 void Debugger::registerProbe(ProbeBase& probe)
 {
 	auto it = std::ranges::lower_bound(probes, probe.getName(), {}, &ProbeBase::getName);
@@ -179,6 +225,23 @@ void Debugger::transfer(Debugger& other)
 
 	tracer.transfer(other, *this);
 
+	// Continue an active instruction trace on the new machine.
+	if (other.instructionTrace) {
+		if (other.cpu) other.cpu->setInstructionTrace(nullptr);
+		instructionTrace = std::move(other.instructionTrace);
+		if (cpu) cpu->setInstructionTrace(instructionTrace.get());
+	}
+
+	// Continue profiling on the new machine, keep the collected samples.
+	if (other.profiler) {
+		startProfiler(other.profiler->getInterval());
+		profiler->takeSamples(*other.profiler);
+		other.stopProfiler();
+	}
+
+	// Continue a cheat finder search on the new machine.
+	cheatFinder = std::move(other.cheatFinder);
+
 	// Breakpoints and conditions are (currently) global, so no need to
 	// copy those.
 }
@@ -255,7 +318,11 @@ void Debugger::Cmd::execute(
 		"list_conditions",   [&]{ listConditions(tokens, result); },
 		"probe",             [&]{ probe(tokens, result); },
 		"symbols",           [&]{ symbols(tokens, result); },
-		"trace",             [&]{ auto& d = debugger(); d.tracer.execute(d, tokens, result, time); });
+		"trace",             [&]{ auto& d = debugger(); d.tracer.execute(d, tokens, result, time); },
+		"instruction_trace", [&]{ instructionTrace(tokens, result); },
+		"access_profile",    [&]{ accessProfile(tokens, result); },
+		"profile",           [&]{ profile(tokens, result); },
+		"cheat_finder",      [&]{ cheatFinder(tokens, result); });
 }
 
 void Debugger::Cmd::list(TclObject& result)
@@ -266,21 +333,21 @@ void Debugger::Cmd::list(TclObject& result)
 void Debugger::Cmd::desc(std::span<const TclObject> tokens, TclObject& result)
 {
 	checkNumArgs(tokens, 3, "debuggable");
-	const Debuggable& device = debugger().getDebuggable(tokens[2].getString());
+	const Debuggable& device = debugger().getDebuggable(tokens[2]);
 	result = device.getDescription();
 }
 
 void Debugger::Cmd::size(std::span<const TclObject> tokens, TclObject& result)
 {
 	checkNumArgs(tokens, 3, "debuggable");
-	const Debuggable& device = debugger().getDebuggable(tokens[2].getString());
+	const Debuggable& device = debugger().getDebuggable(tokens[2]);
 	result = device.getSize();
 }
 
 void Debugger::Cmd::read(std::span<const TclObject> tokens, TclObject& result)
 {
 	checkNumArgs(tokens, 4, Prefix{2}, "debuggable address");
-	Debuggable& device = debugger().getDebuggable(tokens[2].getString());
+	Debuggable& device = debugger().getDebuggable(tokens[2]);
 	unsigned addr = tokens[3].getInt(getInterpreter());
 	if (addr >= device.getSize()) {
 		throw CommandException("Invalid address");
@@ -292,7 +359,7 @@ void Debugger::Cmd::readBlock(std::span<const TclObject> tokens, TclObject& resu
 {
 	checkNumArgs(tokens, 5, Prefix{2}, "debuggable address size");
 	auto& interp = getInterpreter();
-	Debuggable& device = debugger().getDebuggable(tokens[2].getString());
+	Debuggable& device = debugger().getDebuggable(tokens[2]);
 	unsigned devSize = device.getSize();
 	unsigned addr = tokens[3].getInt(interp);
 	if (addr >= devSize) {
@@ -312,7 +379,7 @@ void Debugger::Cmd::write(std::span<const TclObject> tokens, TclObject& /*result
 {
 	checkNumArgs(tokens, 5, Prefix{2}, "debuggable address value");
 	auto& interp = getInterpreter();
-	Debuggable& device = debugger().getDebuggable(tokens[2].getString());
+	Debuggable& device = debugger().getDebuggable(tokens[2]);
 	unsigned addr = tokens[3].getInt(interp);
 	if (addr >= device.getSize()) {
 		throw CommandException("Invalid address");
@@ -328,7 +395,7 @@ void Debugger::Cmd::write(std::span<const TclObject> tokens, TclObject& /*result
 void Debugger::Cmd::writeBlock(std::span<const TclObject> tokens, TclObject& /*result*/)
 {
 	checkNumArgs(tokens, 5, Prefix{2}, "debuggable address values");
-	Debuggable& device = debugger().getDebuggable(tokens[2].getString());
+	Debuggable& device = debugger().getDebuggable(tokens[2]);
 	unsigned devSize = device.getSize();
 	unsigned addr = tokens[3].getInt(getInterpreter());
 	if (addr >= devSize) {
@@ -339,9 +406,7 @@ void Debugger::Cmd::writeBlock(std::span<const TclObject> tokens, TclObject& /*r
 		throw CommandException("Invalid size");
 	}
 
-	for (auto i : xrange(buf.size())) {
-		device.write(unsigned(addr + i), buf[i]);
-	}
+	device.writeBlock(addr, buf);
 }
 
 static constexpr char toHex(byte x)
@@ -1143,6 +1208,201 @@ void Debugger::Cmd::symbolsLookup(std::span<const TclObject> tokens, TclObject&
 	}
 }
 
+void Debugger::Cmd::instructionTrace(std::span<const TclObject> tokens, TclObject& result)
+{
+	checkNumArgs(tokens, AtLeast{3}, "subcommand ?arg ...?");
+	auto& d = debugger();
+	executeSubCommand(tokens[2].getString(),
+		"start", [&]{
+			checkNumArgs(tokens, 4, Prefix{3}, "filename");
+			auto filename = FileOperations::expandTilde(std::string(tokens[3].getString()));
+			try {
+				d.startInstructionTrace(filename);
+			} catch (FileException& e) {
+				throw CommandException("Couldn't start instruction trace: ", e.getMessage());
+			}
+		},
+		"stop", [&]{
+			checkNumArgs(tokens, 3, "");
+			d.stopInstructionTrace();
+		},
+		"status", [&]{
+			checkNumArgs(tokens, 3, "");
+			if (!d.instructionTrace) return;
+			const auto& trace = *d.instructionTrace;
+			auto stats = trace.getStats();
+			result = makeTclDict("file", trace.getFilename(),
+			                     "records", stats.records,
+			                     "stalls", stats.stalls);
+			if (auto error = trace.getError()) {
+				result.addDictKeyValue("error", *error);
+			}
+		});
+}
+
+void Debugger::Cmd::accessProfile(std::span<const TclObject> tokens, TclObject& result)
+{
+	checkNumArgs(tokens, AtLeast{3}, "subcommand ?arg ...?");
+	auto& interface = debugger().motherBoard.getCPUInterface();
+	auto countsDict = [&](const auto& reads, const auto& writes) {
+		TclObject r, w;
+		r.addListElements(reads);
+		w.addListElements(writes);
+		return makeTclDict("read", r, "write", w);
+	};
+	static constexpr MSXCPUInterface::AccessProfile emptyProfile = {};
+	const auto* profile = interface.getAccessProfile();
+	if (!profile) profile = &emptyProfile;
+
+	executeSubCommand(tokens[2].getString(),
+		"start", [&]{
+			checkNumArgs(tokens, 3, "");
+			interface.setAccessProfiling(true);
+		},
+		"stop", [&]{
+			checkNumArgs(tokens, 3, "");
+			interface.setAccessProfiling(false);
+		},
+		"clear", [&]{
+			checkNumArgs(tokens, 3, "");
+			interface.clearAccessProfile();
+		},
+		"status", [&]{
+			checkNumArgs(tokens, 3, "");
+			result = interface.isAccessProfiling();
+		},
+		"memory", [&]{
+			checkNumArgs(tokens, Between{4, 5}, Prefix{3}, "primary-slot ?secondary-slot?");
+			auto& interp = getInterpreter();
+			auto ps = tokens[3].getInt(interp);
+			auto ss = (tokens.size() == 5) ? tokens[4].getInt(interp) : 0;
+			if ((ps < 0) || (ps > 3) || (ss < 0) || (ss > 3)) {
+				throw CommandException("Invalid slot: ", ps, '-', ss);
+			}
+			auto slot = 4 * ps + ss;
+			result = countsDict(profile->memRead[slot], profile->memWrite[slot]);
+		},
+		"io", [&]{
+			checkNumArgs(tokens, 3, "");
+			result = countsDict(profile->ioRead, profile->ioWrite);
+		});
+}
+
+void Debugger::Cmd::profile(std::span<const TclObject> tokens, TclObject& result)
+{
+	checkNumArgs(tokens, AtLeast{3}, "subcommand ?arg ...?");
+	auto& d = debugger();
+	executeSubCommand(tokens[2].getString(),
+		"start", [&]{
+			checkNumArgs(tokens, Between{3, 4}, Prefix{3}, "?cycles?");
+			int cycles = 3579; // about 1000 samples per second
+			if (tokens.size() == 4) {
+				cycles = tokens[3].getInt(getInterpreter());
+				if (cycles <= 0) {
+					throw CommandException("Sample interval must be positive.");
+				}
+			}
+			// expressed in Z80 cycles (3.58MHz), also when the R800 is active
+			d.startProfiler(EmuDuration::hz(3579545) * cycles);
+		},
+		"stop", [&]{
+			checkNumArgs(tokens, 3, "");
+			d.stopProfiler();
+		},
+		"clear", [&]{
+			checkNumArgs(tokens, 3, "");
+			if (d.profiler) d.profiler->clear();
+		},
+		"status", [&]{
+			checkNumArgs(tokens, 3, "");
+			if (!d.profiler) return;
+			result = makeTclDict("samples", d.profiler->getNumSamples(),
+			                     "interval", d.profiler->getInterval().toDouble());
+		},
+		"folded", [&]{
+			checkNumArgs(tokens, Between{3, 4}, Prefix{3}, "?filename?");
+			if (!d.profiler) {
+				throw CommandException("Profiler is not running.");
+			}
+			auto folded = d.profiler->getFoldedStacks(getSymbolManager());
+			if (tokens.size() == 3) {
+				result = folded;
+				return;
+			}
+			auto filename = FileOperations::expandTilde(std::string(tokens[3].getString()));
+			try {
+				File file(filename, File::OpenMode::TRUNCATE);
+				file.write(std::span{folded});
+			} catch (FileException& e) {
+				throw CommandException("Couldn't write profile: ", e.getMessage());
+			}
+		});
+}
+
+void Debugger::Cmd::cheatFinder(std::span<const TclObject> tokens, TclObject& result)
+{
+	checkNumArgs(tokens, AtLeast{3}, "subcommand ?arg ...?");
+	auto& d = debugger();
+	auto& finder = d.cheatFinder;
+	executeSubCommand(tokens[2].getString(),
+		"start", [&]{
+			checkNumArgs(tokens, Between{3, 4}, Prefix{3}, "?debuggable?");
+			std::string name = (tokens.size() == 4) ? std::string(tokens[3].getString()) : "memory";
+			auto& debuggable = d.getDebuggable(name);
+			finder.start(std::move(name), debuggable);
+			result = uint64_t(finder.getNumCandidates());
+		},
+		"search", [&]{
+			checkNumArgs(tokens, Between{4, 5}, Prefix{3}, "operator ?value?");
+			if (!finder.isStarted()) {
+				throw CommandException("No search started, use 'debug cheat_finder start'.");
+			}
+			auto op = CheatFinder::parseCompare(tokens[3].getString());
+			if (!op) {
+				throw CommandException("Invalid operator '", tokens[3].getString(),
+				                       "', must be one of ==, !=, <, <=, > or >=.");
+			}
+			std::optional<uint8_t> value;
+			if (tokens.size() == 5) {
+				auto v = tokens[4].getInt(getInterpreter());
+				if ((v < 0) || (v > 255)) {
+					throw CommandException("Value out of range: ", v);
+				}
+				value = narrow_cast<uint8_t>(v);
+			}
+			auto* debuggable = d.findDebuggable(finder.getDebuggableName());
+			if (!debuggable || (debuggable->getSize() != finder.getMemorySize())) {
+				throw CommandException("Debuggable '", finder.getDebuggableName(),
+				                       "' changed, restart the search.");
+			}
+			result = uint64_t(finder.search(*debuggable, *op, value));
+		},
+		"results", [&]{
+			checkNumArgs(tokens, Between{3, 4}, Prefix{3}, "?max?");
+			auto max = size_t(-1);
+			if (tokens.size() == 4) {
+				auto m = tokens[3].getInt(getInterpreter());
+				if (m < 0) {
+					throw CommandException("Maximum must be non-negative.");
+				}
+				max = size_t(m);
+			}
+			for (const auto& r : finder.getResults(max)) {
+				result.addListElement(makeTclList(r.address, r.oldValue, r.newValue));
+			}
+		},
+		"status", [&]{
+			checkNumArgs(tokens, 3, "");
+			if (!finder.isStarted()) return;
+			result = makeTclDict("debuggable", finder.getDebuggableName(),
+			                     "candidates", uint64_t(finder.getNumCandidates()));
+		},
+		"stop", [&]{
+			checkNumArgs(tokens, 3, "");
+			finder.clear();
+		});
+}
+
 // A tiny structural string type, because we're not using C++26 yet that let's you constexpr + std::string
 template<size_t N>
 struct FixedStr {
@@ -1193,6 +1453,10 @@ std::string Debugger::Cmd::help(std::span<const TclObject> tokens) const
 		"    disasm_blob  disassemble a instruction in Tcl binary string\n"
 		"    symbols      manage debug symbols\n"
 		"    trace        trace related subcommands\n"
+		"    instruction_trace  record all executed instructions in a file\n"
+		"    access_profile  count memory and I/O accesses\n"
+		"    profile      sampling profiler for the emulated software\n"
+		"    cheat_finder search for memory locations that changed in a given way\n"
 		"  The arguments are specific for each subcommand.\n"
 		"  Type 'help debug <subcommand>' for help about a specific subcommand.\n";
 
@@ -1514,6 +1778,71 @@ std::string Debugger::Cmd::help(std::span<const TclObject> tokens) const
 		"           and/or with an optionally given value\n"
 		"  Note: an easier syntax to lookup a symbol value based on the name is:\n"
 		"        $sym(<name>)\n";
+	constexpr auto instructionTraceHelp =
+		"debug instruction_trace <subcommand> [<arguments>]\n"
+		"  Possible subcommands are:\n"
+		"    start <filename>  record all executed instructions in the given file\n"
+		"                      (replaces a trace that's already running)\n"
+		"    stop              stop recording and close the file\n"
+		"    status            returns a dict with the file name, the number of\n"
+		"                      recorded instructions and the number of times the\n"
+		"                      emulation had to wait for the file writer\n"
+		"  For each instruction the address, opcode bytes, registers and the\n"
+		"  emulation time are stored in a compact, compressed binary format. The\n"
+		"  Probe/Trace Viewer (File menu) can load these files.\n"
+		"  Instructions executed during fast-forward are not recorded.\n";
+	constexpr auto accessProfileHelp =
+		"debug access_profile <subcommand> [<arguments>]\n"
+		"  Possible subcommands are:\n"
+		"    start                  start counting memory and I/O accesses\n"
+		"    stop                   stop counting, the counts are kept\n"
+		"    clear                  reset all counts to zero\n"
+		"    status                 returns whether counting is active\n"
+		"    memory <ps> [<ss>]     returns a dict with 'read' and 'write' lists of\n"
+		"                           256 access counts, one per 256-byte page of the\n"
+		"                           given slot\n"
+		"    io                     returns a dict with 'read' and 'write' lists of\n"
+		"                           256 access counts, one per I/O port\n"
+		"  Only accesses from the CPU are counted (not from the debugger).\n"
+		"  While counting is active emulation is slower.\n";
+	constexpr auto profileHelp =
+		"debug profile <subcommand> [<arguments>]\n"
+		"  Possible subcommands are:\n"
+		"    start [<cycles>]    start taking a sample every <cycles> Z80 clock\n"
+		"                        cycles (default 3579, about 1000 per second)\n"
+		"                        (restarts the profiler when it was running)\n"
+		"    stop                stop profiling and discard all samples\n"
+		"    clear               discard all samples, but keep profiling\n"
+		"    status              returns a dict with the number of samples and\n"
+		"                        the sample interval in seconds\n"
+		"    folded [<filename>] returns the samples (or writes them to the given\n"
+		"                        file) in the 'folded stacks' format, which can be\n"
+		"                        turned into a flame graph with external tools\n"
+		"  Each sample records the call stack: all routines that were entered via\n"
+		"  CALL, RST or an interrupt and that didn't return yet. Routines are named\n"
+		"  after the matching debug symbol (see 'debug symbols'), taking the slot\n"
+		"  and segment into account, otherwise as <address>@<slot>[:<segment>].\n";
+	constexpr auto cheatFinderHelp =
+		"debug cheat_finder <subcommand> [<arguments>]\n"
+		"  Possible subcommands are:\n"
+		"    start [<debuggable>]     (re)start a search in the given debuggable\n"
+		"                             (default 'memory'), all locations are\n"
+		"                             candidates, returns their number\n"
+		"    search <op> [<value>]    keep the candidates for which '<new> <op> <old>'\n"
+		"                             holds, or '<new> <op> <value>' when a value\n"
+		"                             is given, <op> is one of ==, !=, <, <=, >, >=\n"
+		"                             returns the number of remaining candidates\n"
+		"    results [<max>]          returns a list of {address old new} triplets\n"
+		"                             for (at most <max> of) the remaining candidates\n"
+		"    status                   returns a dict with the debuggable and the\n"
+		"                             number of candidates (empty when not started)\n"
+		"    stop                     stop searching, releases the memory\n"
+		"  Each search only reads the parts of the debuggable that still contain\n"
+		"  candidates, so narrowing down is fast, also for a large memory mapper.\n"
+		"  Example: find a counter that decreases:\n"
+		"    debug cheat_finder start\n"
+		"    (lose a life)\n"
+		"    debug cheat_finder search <\n";
 	constexpr auto unknownHelp =
 		"Unknown subcommand, use 'help debug' to see a list of valid "
 		"subcommands.\n";
@@ -1628,6 +1957,14 @@ std::string Debugger::Cmd::help(std::span<const TclObject> tokens) const
 		return symbolsHelp;
 	} else if (tokens[1] == "trace") {
 		return debugger().tracer.help(tokens);
+	} else if (tokens[1] == "instruction_trace") {
+		return instructionTraceHelp;
+	} else if (tokens[1] == "access_profile") {
+		return accessProfileHelp;
+	} else if (tokens[1] == "profile") {
+		return profileHelp;
+	} else if (tokens[1] == "cheat_finder") {
+		return cheatFinderHelp;
 	} else {
 		return unknownHelp;
 	}
@@ -1673,6 +2010,7 @@ void Debugger::Cmd::tabCompletion(std::vector<std::string>& tokens) const
 		"disasm"sv, "disasm_blob"sv, "set_bp"sv, "remove_bp"sv, "set_watchpoint"sv,
 		"remove_watchpoint"sv, "set_condition"sv, "remove_condition"sv, "trace"sv,
 		"probe"sv, "symbols"sv, "breakpoint"sv, "watchpoint"sv, "watchexpr"sv, "condition"sv,
+		"instruction_trace"sv, "access_profile"sv, "profile"sv, "cheat_finder"sv,
 	};
 	static constexpr std::array types = {
 		"read_io"sv, "write_io"sv, "read_mem"sv, "write_mem"sv,
@@ -1719,6 +2057,27 @@ void Debugger::Cmd::tabCompletion(std::vector<std::string>& tokens) const
 				completeString(tokens, subCmds);
 			} else if (tokens[1] == "trace") {
 				debugger().tracer.tabCompletion(debugger(), tokens);
+			} else if (tokens[1] == "instruction_trace") {
+				static constexpr std::array subCmds = {
+					"start"sv, "stop"sv, "status"sv,
+				};
+				completeString(tokens, subCmds);
+			} else if (tokens[1] == "access_profile") {
+				static constexpr std::array subCmds = {
+					"start"sv, "stop"sv, "clear"sv, "status"sv,
+					"memory"sv, "io"sv,
+				};
+				completeString(tokens, subCmds);
+		} else if (tokens[1] == "profile") {
+				static constexpr std::array subCmds = {
+					"start"sv, "stop"sv, "clear"sv, "status"sv, "folded"sv,
+				};
+				completeString(tokens, subCmds);
+			} else if (tokens[1] == "cheat_finder") {
+				static constexpr std::array subCmds = {
+					"start"sv, "search"sv, "results"sv, "status"sv, "stop"sv,
+				};
+				completeString(tokens, subCmds);
 			}
 		}
 		break;
@@ -1727,6 +2086,13 @@ void Debugger::Cmd::tabCompletion(std::vector<std::string>& tokens) const
 		    (tokens[2] == one_of("desc", "read", "set_bp"))) {
 			completeString(tokens, std::views::transform(
 				debugger().probes, &ProbeBase::getName));
+		} else if ((size == 4) && (tokens[1] == "cheat_finder") && (tokens[2] == "start")) {
+			completeString(tokens, std::views::keys(debugger().debuggables));
+		} else if ((size == 4) && (tokens[1] == "cheat_finder") && (tokens[2] == "search")) {
+			static constexpr std::array ops = {
+				"=="sv, "!="sv, "<"sv, "<="sv, ">"sv, ">="sv,
+			};
+			completeString(tokens, ops);
 		} else if (tokens[1] == "breakpoint") {
 			if ((size == 4) && tokens[2] == one_of("remove"sv, "configure"sv)) {
 				completeString(tokens, getBreakPointIds());
@@ -1773,6 +2139,9 @@ void Debugger::Cmd::tabCompletion(std::vector<std::string>& tokens) const
 			}
 		} else if (tokens[1] == "trace") {
 			debugger().tracer.tabCompletion(debugger(), tokens);
+		} else if ((size == 4) && (((tokens[1] == "instruction_trace") && (tokens[2] == "start")) ||
+		                           ((tokens[1] == "profile") && (tokens[2] == "folded")))) {
+			completeFileName(tokens, userFileContext());
 		}
 		break;
 	}
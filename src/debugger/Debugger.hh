@@ -1,6 +1,7 @@
 #ifndef DEBUGGER_HH
 #define DEBUGGER_HH
 
+#include "CheatFinder.hh"
 #include "Probe.hh"
 #include "Tracer.hh"
 
@@ -21,10 +22,12 @@ namespace openmsx {
 class BreakPoint;
 class DebugCondition;
 class Debuggable;
+class InstructionTraceWriter;
 class MSXCPU;
 class MSXMotherBoard;
 class ProbeBase;
 class ProbeBreakPoint;
+class SamplingProfiler;
 class SymbolManager;
 
 class Debugger
@@ -57,9 +60,11 @@ public:
 
 	[[nodiscard]] auto& getProbes() { return probes; }
 	[[nodiscard]] Tracer& getTracer() { return tracer; }
+	[[nodiscard]] CheatFinder& getCheatFinder() { return cheatFinder; }
 
 private:
 	[[nodiscard]] Debuggable& getDebuggable(std::string_view name);
+	[[nodiscard]] Debuggable& getDebuggable(const TclObject& name);
 	[[nodiscard]] ProbeBase& getProbe(std::string_view name);
 
 	std::string insertProbeBreakPoint(
@@ -67,6 +72,11 @@ private:
 		ProbeBase& probe, bool once, unsigned newId = -1);
 	void removeProbeBreakPoint(std::string_view name);
 
+	void startInstructionTrace(const std::string& filename);
+	void stopInstructionTrace();
+	void startProfiler(EmuDuration interval);
+	void stopProfiler();
+
 	MSXMotherBoard& motherBoard;
 
 	class Cmd final : public RecordedCommand {
@@ -147,15 +157,30 @@ private:
 		void symbolsRemove(std::span<const TclObject> tokens, TclObject& result);
 		void symbolsFiles(std::span<const TclObject> tokens, TclObject& result);
 		void symbolsLookup(std::span<const TclObject> tokens, TclObject& result);
+		void instructionTrace(std::span<const TclObject> tokens, TclObject& result);
+		void accessProfile(std::span<const TclObject> tokens, TclObject& result);
+		void profile(std::span<const TclObject> tokens, TclObject& result);
+		void cheatFinder(std::span<const TclObject> tokens, TclObject& result);
 	} cmd;
 
 	Tracer tracer;
 	friend class Tracer;
 
 	hash_map<std::string, Debuggable*, XXHasher> debuggables;
+	// Result of the last getDebuggable(const TclObject&) lookup. Scripts
+	// typically execute 'debug read <name> ...' many times with the same
+	// (literal) Tcl_Obj as name. Holding a reference keeps that Tcl_Obj
+	// alive and, because it's then shared, unmodified. So comparing the
+	// Tcl_Obj pointers is enough to detect a repeated lookup. Cleared when
+	// a debuggable is (un)registered.
+	TclObject lastDebuggableName;
+	Debuggable* lastDebuggable = nullptr;
 	std::vector<ProbeBase*> probes; // sorted on name
 	std::vector<std::unique_ptr<ProbeBreakPoint>> probeBreakPoints; // unordered
 	MSXCPU* cpu = nullptr;
+	std::unique_ptr<InstructionTraceWriter> instructionTrace;
+	std::unique_ptr<SamplingProfiler> profiler;
+	CheatFinder cheatFinder;
 };
 
 } // namespace openmsx
@@ -0,0 +1,56 @@
+#ifndef INSTRUCTIONTRACE_HH
+#define INSTRUCTIONTRACE_HH
+
+#include "endian.hh"
+
+#include <array>
+#include <cstdint>
+
+/** File format of the binary instruction traces written by
+  * InstructionTraceWriter and read by InstructionTraceFile.
+  *
+  * The file starts with a FileHeader, followed by a sequence of blocks.
+  * Each block is a BlockHeader followed by 'compressedSize' bytes of zlib
+  * data, which inflates to 'numRecords' Record structures. Blocks are
+  * independent, so a reader can index the file and only inflate the
+  * blocks it actually needs.
+  */
+namespace openmsx::InstructionTrace {
+
+static constexpr std::array<char, 12> MAGIC = {
+	'o', 'M', 'S', 'X', '-', 'i', 't', 'r', 'a', 'c', 'e', '\0'
+};
+static constexpr uint16_t VERSION = 1;
+
+// Maximum number of records per block.
+static constexpr unsigned BLOCK_RECORDS = 4096;
+
+struct FileHeader {
+	std::array<char, 12> magic;
+	Endian::L16 version;
+	Endian::L16 recordSize;
+};
+static_assert(sizeof(FileHeader) == 16);
+
+struct BlockHeader {
+	Endian::L32 compressedSize;
+	Endian::L32 numRecords;
+};
+static_assert(sizeof(BlockHeader) == 8);
+
+// CPU state right before an instruction is executed.
+struct Record {
+	static constexpr uint8_t IFF1 = 0x01;
+	static constexpr uint8_t R800 = 0x02;
+
+	Endian::L64 time; // EmuTime, in units of EmuTime::MAIN_FREQ
+	Endian::L16 pc, sp, af, bc, de, hl, ix, iy;
+	std::array<uint8_t, 4> opcode; // the bytes at 'pc'
+	uint8_t i, r, im;
+	uint8_t flags; // combination of IFF1 and R800
+};
+static_assert(sizeof(Record) == 32);
+
+} // namespace openmsx::InstructionTrace
+
+#endif
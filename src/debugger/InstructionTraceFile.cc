@@ -0,0 +1,110 @@
+#include "InstructionTraceFile.hh"
+
+#include "MSXException.hh"
+
+#include "narrow.hh"
+#include "xrange.hh"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+namespace openmsx {
+
+using namespace InstructionTrace;
+
+InstructionTraceFile::InstructionTraceFile(const std::string& filename_)
+	: filename(filename_)
+	, file(filename)
+	, mapped(file.mmap<const uint8_t>())
+{
+	std::span data{mapped.data(), mapped.size()};
+	FileHeader header;
+	if (data.size() < sizeof(header)) {
+		throw MSXException("Not an instruction trace file: ", filename);
+	}
+	memcpy(&header, data.data(), sizeof(header));
+	if ((header.magic != MAGIC) || (header.recordSize != sizeof(Record))) {
+		throw MSXException("Not an instruction trace file: ", filename);
+	}
+	if (header.version != VERSION) {
+		throw MSXException("Unsupported instruction trace version: ", uint16_t(header.version));
+	}
+
+	size_t pos = sizeof(header);
+	while ((data.size() - pos) >= sizeof(BlockHeader)) {
+		BlockHeader bh;
+		memcpy(&bh, data.data() + pos, sizeof(bh));
+		pos += sizeof(bh);
+		if ((data.size() - pos) < bh.compressedSize) break; // truncated
+		if ((bh.numRecords == 0) || (bh.numRecords > BLOCK_RECORDS)) {
+			throw MSXException("Corrupt instruction trace file: ", filename);
+		}
+		blocks.push_back(Block{
+			.offset = pos,
+			.compressedSize = bh.compressedSize,
+			.numRecords = bh.numRecords,
+			.firstRecord = numRecords});
+		pos += bh.compressedSize;
+		numRecords += bh.numRecords;
+	}
+}
+
+size_t InstructionTraceFile::findBlock(uint64_t index) const
+{
+	assert(index < numRecords);
+	auto it = std::ranges::upper_bound(blocks, index, {}, &Block::firstRecord);
+	assert(it != blocks.begin());
+	return (it - blocks.begin()) - 1;
+}
+
+void InstructionTraceFile::loadBlock(size_t blockIdx)
+{
+	if (blockIdx == cachedBlock) return;
+	const auto& block = blocks[blockIdx];
+	cache.resize(block.numRecords);
+	auto dstLen = uLongf(cache.size() * sizeof(Record));
+	if ((uncompress(std::bit_cast<Bytef*>(cache.data()), &dstLen,
+	                std::bit_cast<const Bytef*>(mapped.data() + block.offset),
+	                uLong(block.compressedSize)) != Z_OK) ||
+	    (dstLen != cache.size() * sizeof(Record))) {
+		cachedBlock = size_t(-1);
+		throw MSXException("Corrupt instruction trace file: ", filename);
+	}
+	cachedBlock = blockIdx;
+}
+
+const Record& InstructionTraceFile::getRecord(uint64_t index)
+{
+	auto blockIdx = findBlock(index);
+	loadBlock(blockIdx);
+	return cache[narrow<size_t>(index - blocks[blockIdx].firstRecord)];
+}
+
+uint64_t InstructionTraceFile::findTime(uint64_t time)
+{
+	// Time normally increases monotonically throughout a trace (it
+	// doesn't when e.g. a savestate was loaded while tracing, then the
+	// result is only approximate). First search the block, using only the
+	// first record of each block.
+	size_t lo = 0, hi = blocks.size();
+	while (lo < hi) {
+		auto mid = lo + (hi - lo) / 2;
+		if (getRecord(blocks[mid].firstRecord).time < time) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	if (lo == 0) return 0;
+	// The result is in block 'lo - 1' or it's the first record of block 'lo'.
+	const auto& block = blocks[lo - 1];
+	loadBlock(lo - 1);
+	auto it = std::ranges::lower_bound(cache, time, {}, [](const Record& r) { return uint64_t(r.time); });
+	return block.firstRecord + (it - cache.begin());
+}
+
+} // namespace openmsx
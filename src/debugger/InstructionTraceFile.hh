@@ -0,0 +1,66 @@
+#ifndef INSTRUCTIONTRACEFILE_HH
+#define INSTRUCTIONTRACEFILE_HH
+
+#include "InstructionTrace.hh"
+
+#include "File.hh"
+#include "MappedFile.hh"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace openmsx {
+
+/** Read access to an instruction trace file written by
+  * InstructionTraceWriter.
+  *
+  * The file is memory-mapped and only its block headers are parsed when
+  * it's opened. A block is inflated when a record in it is requested; the
+  * most recently used block is cached.
+  */
+class InstructionTraceFile
+{
+public:
+	/** Throws MSXException when the file can't be opened or is not a
+	  * valid trace file. A truncated last block (e.g. because the
+	  * emulator crashed while tracing) is ignored. */
+	explicit InstructionTraceFile(const std::string& filename);
+
+	[[nodiscard]] const std::string& getFilename() const { return filename; }
+	[[nodiscard]] uint64_t size() const { return numRecords; }
+	[[nodiscard]] size_t numBlocks() const { return blocks.size(); }
+
+	/** Throws MSXException when the block containing this record is
+	  * corrupt. */
+	[[nodiscard]] const InstructionTrace::Record& getRecord(uint64_t index);
+
+	/** Index of the first record with a time >= the given time (or size()
+	  * if there's no such record). Only inflates the blocks it needs. */
+	[[nodiscard]] uint64_t findTime(uint64_t time);
+
+private:
+	struct Block {
+		size_t offset; // of the compressed data in the file
+		uint32_t compressedSize;
+		uint32_t numRecords;
+		uint64_t firstRecord;
+	};
+
+	[[nodiscard]] size_t findBlock(uint64_t index) const;
+	void loadBlock(size_t blockIdx);
+
+private:
+	std::string filename;
+	File file;
+	MappedFile<const uint8_t> mapped;
+	std::vector<Block> blocks;
+	uint64_t numRecords = 0;
+
+	std::vector<InstructionTrace::Record> cache;
+	size_t cachedBlock = size_t(-1);
+};
+
+} // namespace openmsx
+
+#endif
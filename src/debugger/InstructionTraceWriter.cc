@@ -0,0 +1,105 @@
+#include "InstructionTraceWriter.hh"
+
+#include "MSXException.hh"
+
+#include <zlib.h>
+
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+namespace openmsx {
+
+using namespace InstructionTrace;
+
+InstructionTraceWriter::InstructionTraceWriter(const std::string& filename_)
+	: filename(filename_)
+	, file(filename, File::OpenMode::TRUNCATE)
+	, ring(CAPACITY)
+{
+	FileHeader header;
+	header.magic = MAGIC;
+	header.version = VERSION;
+	header.recordSize = uint16_t(sizeof(Record));
+	file.write(std::span{&header, 1});
+
+	thread = std::thread([this]() { workerLoop(); });
+}
+
+InstructionTraceWriter::~InstructionTraceWriter()
+{
+	stop.store(true, std::memory_order_release);
+	thread.join(); // only returns after the ring buffer is drained
+}
+
+std::optional<std::string> InstructionTraceWriter::getError() const
+{
+	if (!failed.load(std::memory_order_acquire)) return {};
+	return error;
+}
+
+void InstructionTraceWriter::waitForSpace(unsigned next)
+{
+	++stats.stalls;
+	while (next == readIdx.load(std::memory_order_acquire)) {
+		std::this_thread::yield();
+	}
+}
+
+void InstructionTraceWriter::workerLoop()
+{
+	std::vector<Record> block;
+	block.reserve(BLOCK_RECORDS);
+	while (true) {
+		// Read 'stop' before 'writeIdx': once 'stop' is seen, all records
+		// are visible.
+		bool stopping = stop.load(std::memory_order_acquire);
+		auto rd = readIdx.load(std::memory_order_relaxed);
+		auto wr = writeIdx.load(std::memory_order_acquire);
+		while ((rd != wr) && (block.size() < BLOCK_RECORDS)) {
+			block.push_back(ring[rd]);
+			rd = (rd + 1) & MASK;
+		}
+		readIdx.store(rd, std::memory_order_release);
+
+		bool drained = stopping && (rd == wr);
+		if ((block.size() == BLOCK_RECORDS) || (drained && !block.empty())) {
+			if (!failed.load(std::memory_order_relaxed)) {
+				try {
+					writeBlock(block);
+				} catch (MSXException& e) {
+					// keep draining (and dropping) records, so
+					// that the emulation thread doesn't block
+					error = e.getMessage();
+					failed.store(true, std::memory_order_release);
+				}
+			}
+			block.clear();
+		}
+		if (drained) break;
+		if (rd == wr) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+}
+
+void InstructionTraceWriter::writeBlock(std::span<const Record> records)
+{
+	auto srcLen = uLong(records.size_bytes());
+	auto dstLen = compressBound(srcLen);
+	MemBuffer<uint8_t> buf(sizeof(BlockHeader) + dstLen);
+	// favor speed over size, a trace can grow very large
+	if (compress2(buf.data() + sizeof(BlockHeader), &dstLen,
+	              std::bit_cast<const Bytef*>(records.data()), srcLen, 1)
+	    != Z_OK) {
+		throw MSXException("Error while compressing instruction trace.");
+	}
+	BlockHeader header;
+	header.compressedSize = uint32_t(dstLen);
+	header.numRecords = uint32_t(records.size());
+	memcpy(buf.data(), &header, sizeof(header));
+	file.write(buf.first(sizeof(BlockHeader) + dstLen));
+}
+
+} // namespace openmsx
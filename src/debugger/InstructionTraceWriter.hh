@@ -0,0 +1,90 @@
+#ifndef INSTRUCTIONTRACEWRITER_HH
+#define INSTRUCTIONTRACEWRITER_HH
+
+#include "InstructionTrace.hh"
+
+#include "File.hh"
+
+#include "MemBuffer.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+
+namespace openmsx {
+
+/** Records a binary trace of all executed CPU instructions.
+  *
+  * The emulation thread appends fixed-size records to a lock-free
+  * single-producer/single-consumer ring buffer. A background thread
+  * drains that buffer, compresses the records in blocks and writes them
+  * to the file (see InstructionTrace.hh for the format).
+  *
+  * When the writer thread can't keep up, the emulation thread waits for
+  * it: a trace never has gaps.
+  */
+class InstructionTraceWriter
+{
+public:
+	struct Stats {
+		uint64_t records = 0; // total number of recorded instructions
+		uint64_t stalls = 0;  // number of times the ring buffer was full
+	};
+
+public:
+	/** Throws FileException when the file can't be created. */
+	explicit InstructionTraceWriter(const std::string& filename);
+	InstructionTraceWriter(const InstructionTraceWriter&) = delete;
+	InstructionTraceWriter(InstructionTraceWriter&&) = delete;
+	InstructionTraceWriter& operator=(const InstructionTraceWriter&) = delete;
+	InstructionTraceWriter& operator=(InstructionTraceWriter&&) = delete;
+
+	/** Writes all pending records and closes the file. */
+	~InstructionTraceWriter();
+
+	/** Only called from the emulation thread. */
+	void push(const InstructionTrace::Record& record) {
+		auto wr = writeIdx.load(std::memory_order_relaxed);
+		auto next = (wr + 1) & MASK;
+		if (next == readIdx.load(std::memory_order_acquire)) [[unlikely]] {
+			waitForSpace(next);
+		}
+		ring[wr] = record;
+		writeIdx.store(next, std::memory_order_release);
+		++stats.records;
+	}
+
+	[[nodiscard]] const std::string& getFilename() const { return filename; }
+	[[nodiscard]] Stats getStats() const { return stats; }
+	/** Error message of a failed write, the trace is incomplete. */
+	[[nodiscard]] std::optional<std::string> getError() const;
+
+private:
+	static constexpr unsigned CAPACITY = 1 << 16; // must be a power of 2
+	static constexpr unsigned MASK = CAPACITY - 1;
+
+	void waitForSpace(unsigned next);
+	void workerLoop();
+	void writeBlock(std::span<const InstructionTrace::Record> records);
+
+private:
+	std::string filename;
+	File file;
+	MemBuffer<InstructionTrace::Record> ring;
+	Stats stats; // only accessed from the emulation thread
+
+	std::atomic<unsigned> readIdx = 0;
+	std::atomic<unsigned> writeIdx = 0;
+	std::atomic<bool> stop = false;
+	std::atomic<bool> failed = false;
+	std::string error; // only valid (and no longer written) when 'failed' is set
+
+	std::thread thread; // must be last, started after the above members are initialized
+};
+
+} // namespace openmsx
+
+#endif
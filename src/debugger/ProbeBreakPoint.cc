@@ -40,7 +40,7 @@ void ProbeBreakPoint::update(const ProbeBase& /*subject*/) noexcept
 	auto& reactor = motherBoard.getReactor();
 	auto& cliComm = reactor.getGlobalCliComm();
 	auto& interp  = reactor.getInterpreter();
-	bool remove = checkAndExecute(cliComm, interp);
+	bool remove = checkAndExecute(cliComm, interp, debugger);
 	if (remove) {
 		debugger.removeProbeBreakPoint(*this);
 	}
@@ -0,0 +1,172 @@
+#include "SamplingProfiler.hh"
+
+#include "Debugger.hh"
+#include "SymbolManager.hh"
+
+#include "CPURegs.hh"
+#include "MSXCPU.hh"
+#include "MSXCPUInterface.hh"
+#include "MSXMemoryMapperBase.hh"
+#include "MSXMotherBoard.hh"
+#include "MSXRom.hh"
+#include "RomBlockDebuggable.hh"
+#include "RomPlain.hh"
+
+#include "stl.hh"
+#include "strCat.hh"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace openmsx {
+
+// Encoding of a location (see getLocation()):
+//   bits  0-15: address
+//   bits 16-17: primary slot
+//   bits 18-19: secondary slot
+//   bit     20: slot is expanded
+//   bit     21: segment is known
+//   bits 32-47: segment
+static constexpr uint64_t HAS_SS  = uint64_t(1) << 20;
+static constexpr uint64_t HAS_SEG = uint64_t(1) << 21;
+
+SamplingProfiler::SamplingProfiler(Debugger& debugger_, EmuDuration interval_)
+	: Schedulable(debugger_.getMotherBoard().getScheduler())
+	, debugger(debugger_)
+	, motherBoard(debugger_.getMotherBoard())
+	, interval(interval_)
+{
+	setSyncPoint(getCurrentTime() + interval);
+}
+
+SamplingProfiler::~SamplingProfiler() = default;
+
+void SamplingProfiler::takeSamples(SamplingProfiler& other)
+{
+	samples = std::move(other.samples);
+	numSamples = other.numSamples;
+	other.clear();
+}
+
+void SamplingProfiler::clear()
+{
+	samples.clear();
+	numSamples = 0;
+}
+
+uint64_t SamplingProfiler::getLocation(uint16_t addr) const
+{
+	auto& interface = motherBoard.getCPUInterface();
+	auto page = uint8_t(addr >> 14);
+	auto ps = interface.getPrimarySlot(page);
+	uint64_t result = addr | (uint64_t(ps) << 16);
+	if (interface.isExpanded(ps)) {
+		result |= (uint64_t(interface.getSecondarySlot(page)) << 18) | HAS_SS;
+	}
+
+	std::optional<unsigned> segment;
+	const auto* device = interface.getVisibleMSXDevice(page);
+	if (const auto* mapper = dynamic_cast<const MSXMemoryMapperBase*>(device)) {
+		segment = mapper->getSelectedSegment(page);
+	} else if (const auto* rom = dynamic_cast<const MSXRom*>(device);
+	           rom && !dynamic_cast<const RomPlain*>(rom)) {
+		if (auto* debug8 = dynamic_cast<RomBlockDebuggableBase::Debuggable8*>(
+			debugger.findDebuggable(tmpStrCat(rom->getName(), " romblocks")))) {
+			if (auto seg = debug8->getRomBlocks().readExt(addr); seg != unsigned(-1)) {
+				segment = seg;
+			}
+		}
+	}
+	if (segment) {
+		result |= (uint64_t(*segment & 0xffff) << 32) | HAS_SEG;
+	}
+	return result;
+}
+
+void SamplingProfiler::executeUntil(EmuTime time)
+{
+	const auto& regs = motherBoard.getCPU().getRegisters();
+	callStack.unwind(regs.getSP());
+
+	key.clear();
+	auto append = [&](uint64_t location) {
+		auto bytes = std::bit_cast<std::array<char, sizeof(location)>>(location);
+		key.append(bytes.data(), bytes.size());
+	};
+	for (const auto& frame : callStack.getFrames()) {
+		append(getLocation(frame.target));
+	}
+	auto [it, inserted] = samples.try_emplace(key, 0);
+	++it->second;
+	++numSamples;
+
+	setSyncPoint(time + interval);
+}
+
+[[nodiscard]] static std::string getFrameName(SymbolManager& symbolManager, uint64_t location)
+{
+	auto addr = uint16_t(location);
+	auto ps = unsigned(location >> 16) & 3;
+	auto ss = unsigned(location >> 18) & 3;
+	auto segment = (location & HAS_SEG) ? std::optional<uint16_t>(uint16_t(location >> 32))
+	                                    : std::nullopt;
+
+	// Prefer symbols that specify (and match) the slot and/or segment.
+	auto psSs = uint8_t(ps + 4 * ss);
+	const Symbol* best = nullptr;
+	int bestPriority = -1;
+	for (const Symbol* symbol : symbolManager.lookupValue(addr)) {
+		if (symbol->slot && *symbol->slot != psSs) continue;
+		if (symbol->segment && symbol->segment != segment) continue;
+		int priority = int(symbol->slot.has_value()) + int(symbol->segment.has_value());
+		if (priority > bestPriority) {
+			best = symbol;
+			bestPriority = priority;
+		}
+	}
+	if (best) return best->name;
+
+	return strCat("0x", hex_string<4>(addr), '@', ps,
+	              strCat_if((location & HAS_SS) != 0, '-', ss),
+	              strCat_if(segment.has_value(), ':', STRCAT_LAZY(*segment)));
+}
+
+std::string SamplingProfiler::getFoldedStacks(SymbolManager& symbolManager) const
+{
+	// Different locations can have the same name (e.g. when symbols don't
+	// specify a segment), so merge the stacks after naming them.
+	hash_map<uint64_t, std::string> names;
+	hash_map<std::string, uint64_t, XXHasher> stacks;
+	std::string stack;
+	for (const auto& [locations, count] : samples) {
+		stack.clear();
+		for (size_t i = 0; i < locations.size(); i += sizeof(uint64_t)) {
+			std::array<char, sizeof(uint64_t)> bytes;
+			std::ranges::copy(std::string_view(locations).substr(i, bytes.size()), bytes.begin());
+			auto location = std::bit_cast<uint64_t>(bytes);
+			auto* name = lookup(names, location);
+			if (!name) {
+				name = &names.emplace_noDuplicateCheck(
+					location, getFrameName(symbolManager, location))->second;
+			}
+			if (!stack.empty()) stack += ';';
+			stack += *name;
+		}
+		if (stack.empty()) stack = "[no call]";
+		stacks[stack] += count;
+	}
+
+	auto lines = to_vector<std::pair<std::string, uint64_t>>(stacks);
+	std::ranges::sort(lines);
+	std::string result;
+	for (const auto& [s, count] : lines) {
+		strAppend(result, s, ' ', count, '\n');
+	}
+	return result;
+}
+
+} // namespace openmsx
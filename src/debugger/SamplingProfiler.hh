@@ -0,0 +1,71 @@
+#ifndef SAMPLINGPROFILER_HH
+#define SAMPLINGPROFILER_HH
+
+#include "CallStackShadow.hh"
+#include "EmuDuration.hh"
+#include "Schedulable.hh"
+
+#include "hash_map.hh"
+#include "xxhash.hh"
+
+#include <cstdint>
+#include <string>
+
+namespace openmsx {
+
+class Debugger;
+class MSXMotherBoard;
+class SymbolManager;
+
+/** Statistical profiler for the emulated software.
+  *
+  * At a fixed interval (in emulated time) it records the current call
+  * stack, as tracked by CallStackShadow, together with the slot and
+  * segment that were selected for each of the called routines. The result
+  * can be exported in the 'folded stacks' format understood by flame graph
+  * tools. Routines are named via the SymbolManager; routines without a
+  * matching symbol are shown as their address.
+  */
+class SamplingProfiler final : public Schedulable
+{
+public:
+	SamplingProfiler(Debugger& debugger, EmuDuration interval);
+	SamplingProfiler(const SamplingProfiler&) = delete;
+	SamplingProfiler(SamplingProfiler&&) = delete;
+	SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+	SamplingProfiler& operator=(SamplingProfiler&&) = delete;
+	~SamplingProfiler();
+
+	/** Continue profiling with the samples collected by another profiler
+	  * (used when the debugger is transferred to a new machine). */
+	void takeSamples(SamplingProfiler& other);
+	void clear();
+
+	[[nodiscard]] EmuDuration getInterval() const { return interval; }
+	[[nodiscard]] uint64_t getNumSamples() const { return numSamples; }
+	[[nodiscard]] CallStackShadow& getCallStack() { return callStack; }
+
+	/** One line per distinct call stack: the frames, outermost first,
+	  * separated by ';', followed by a space and the number of samples. */
+	[[nodiscard]] std::string getFoldedStacks(SymbolManager& symbolManager) const;
+
+private:
+	void executeUntil(EmuTime time) override;
+	[[nodiscard]] uint64_t getLocation(uint16_t addr) const;
+
+private:
+	Debugger& debugger;
+	MSXMotherBoard& motherBoard;
+	const EmuDuration interval;
+	CallStackShadow callStack;
+
+	// Key: the encoded locations (see getLocation()) of all frames,
+	// outermost first, as 8 bytes per frame.
+	hash_map<std::string, uint64_t, XXHasher> samples;
+	uint64_t numSamples = 0;
+	std::string key; // reused to avoid allocations
+};
+
+} // namespace openmsx
+
+#endif
@@ -4,7 +4,9 @@
 
 #include "MSXMotherBoard.hh"
 
+#include "narrow.hh"
 #include "unreachable.hh"
+#include "xrange.hh"
 
 namespace openmsx {
 
@@ -55,4 +57,18 @@ void SimpleDebuggable::write(unsigned /*address*/, byte /*value*/,
 	// does nothing
 }
 
+void SimpleDebuggable::writeBlock(unsigned start, std::span<const byte> input)
+{
+	writeBlock(start, input, motherBoard.getCurrentTime());
+}
+
+void SimpleDebuggable::writeBlock(unsigned start, std::span<const byte> input,
+                                  EmuTime time)
+{
+	// default implementation, subclasses may override it with a more efficient version
+	for (auto i : xrange(input.size())) {
+		write(narrow_cast<unsigned>(start + i), input[i], time);
+	}
+}
+
 } // namespace openmsx
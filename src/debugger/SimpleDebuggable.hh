@@ -19,6 +19,8 @@ public:
 	[[nodiscard]] virtual uint8_t read(unsigned address, EmuTime time);
 	void write(unsigned address, uint8_t value) override;
 	virtual void write(unsigned address, uint8_t value, EmuTime time);
+	void writeBlock(unsigned start, std::span<const uint8_t> input) override;
+	virtual void writeBlock(unsigned start, std::span<const uint8_t> input, EmuTime time);
 
 	[[nodiscard]] const std::string& getName() const { return name; }
 	[[nodiscard]] MSXMotherBoard& getMotherBoard() const { return motherBoard; }
@@ -0,0 +1,124 @@
+#include "SymbolIndex.hh"
+
+#include "SymbolManager.hh"
+
+#include "stl.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <ranges>
+#include <tuple>
+#include <utility>
+
+namespace openmsx {
+
+void SymbolIndex::insertFile(std::span<const Symbol> symbols, unsigned filePos)
+{
+	assert(filePos <= numFiles);
+	if (filePos != numFiles) {
+		// typically a file is added at the end, then nothing needs to move
+		for (auto& e : byValue) {
+			if (e.filePos >= filePos) ++e.filePos;
+		}
+		for (auto& [name, entries] : byName) {
+			for (auto& e : entries) {
+				if (e.filePos >= filePos) ++e.filePos;
+			}
+		}
+	}
+	++numFiles;
+
+	auto added = to_vector(std::views::transform(symbols, [&](const Symbol& sym) {
+		return Entry{sym.value, filePos, &sym};
+	}));
+	auto order = [](const Entry& x, const Entry& y) {
+		return std::tie(x.value, x.filePos, x.symbol) < std::tie(y.value, y.filePos, y.symbol);
+	};
+	std::ranges::sort(added, order);
+	std::vector<Entry> merged;
+	merged.reserve(byValue.size() + added.size());
+	std::ranges::merge(byValue, added, std::back_inserter(merged), order);
+	byValue = std::move(merged);
+	updateValueSymbols();
+
+	for (const auto& sym : symbols) {
+		auto& entries = byName[std::string_view(sym.name)];
+		auto it = std::ranges::upper_bound(entries, filePos, {}, &NameEntry::filePos);
+		entries.insert(it, NameEntry{filePos, &sym});
+	}
+}
+
+void SymbolIndex::eraseFile(std::span<const Symbol> symbols, unsigned filePos)
+{
+	assert(filePos < numFiles);
+	std::erase_if(byValue, [&](const Entry& e) { return e.filePos == filePos; });
+	for (auto& e : byValue) {
+		if (e.filePos > filePos) --e.filePos;
+	}
+	updateValueSymbols();
+
+	for (const auto& sym : symbols) {
+		auto it = byName.find(std::string_view(sym.name));
+		if (it == byName.end()) continue; // already handled (duplicate name)
+		auto entries = std::move(it->second);
+		byName.erase(it);
+		std::erase_if(entries, [&](const NameEntry& e) { return e.filePos == filePos; });
+		if (!entries.empty()) {
+			// The key may point into the name of an erased symbol, so
+			// re-insert with the name of a remaining symbol.
+			auto key = std::string_view(entries.front().symbol->name);
+			byName.try_emplace(key, std::move(entries));
+		}
+	}
+	for (auto& [name, entries] : byName) {
+		for (auto& e : entries) {
+			if (e.filePos > filePos) --e.filePos;
+		}
+	}
+	--numFiles;
+}
+
+void SymbolIndex::clear()
+{
+	byValue.clear();
+	valueSymbols.clear();
+	byName.clear();
+	numFiles = 0;
+}
+
+void SymbolIndex::updateValueSymbols()
+{
+	valueSymbols.resize(byValue.size());
+	std::ranges::transform(byValue, valueSymbols.begin(), &Entry::symbol);
+}
+
+std::span<const Symbol* const> SymbolIndex::lookupValue(uint16_t value) const
+{
+	auto [first, last] = std::ranges::equal_range(byValue, value, {}, &Entry::value);
+	auto b = std::distance(byValue.begin(), first);
+	auto e = std::distance(byValue.begin(), last);
+	return std::span{valueSymbols}.subspan(b, e - b);
+}
+
+const Symbol* SymbolIndex::lookupName(std::string_view name) const
+{
+	const auto* entries = lookup(byName, name);
+	if (!entries) return nullptr;
+	assert(!entries->empty());
+	if (auto it = std::ranges::find(*entries, name, [](const NameEntry& e) -> std::string_view { return e.symbol->name; });
+	    it != entries->end()) {
+		return it->symbol;
+	}
+	return entries->front().symbol;
+}
+
+const Symbol* SymbolIndex::lookupExactName(std::string_view name) const
+{
+	const auto* entries = lookup(byName, name);
+	if (!entries) return nullptr;
+	auto it = std::ranges::find(*entries, name, [](const NameEntry& e) -> std::string_view { return e.symbol->name; });
+	return (it != entries->end()) ? it->symbol : nullptr;
+}
+
+} // namespace openmsx
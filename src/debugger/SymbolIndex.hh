@@ -0,0 +1,76 @@
+#ifndef SYMBOL_INDEX_HH
+#define SYMBOL_INDEX_HH
+
+#include "StringOp.hh"
+#include "hash_map.hh"
+#include "xxhash.hh"
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace openmsx {
+
+struct Symbol;
+
+/** Index on the symbols of all loaded symbol files, to quickly find symbols
+  * by value or by name.
+  *
+  * The values are kept in a flat sorted array (binary search), the names in
+  * a (case-insensitive) hash map. Symbols of files that come earlier take
+  * precedence, so each entry also remembers the position of its file.
+  *
+  * The index doesn't own the symbols, it points to them. So they must not
+  * move while they're in the index (moving the std::vector<Symbol> that
+  * holds them is fine).
+  */
+class SymbolIndex
+{
+public:
+	/** Add the symbols of a file that's inserted at the given position in
+	  * the list of files (files at or after that position move one up). */
+	void insertFile(std::span<const Symbol> symbols, unsigned filePos);
+
+	/** Remove the symbols of the file at the given position ('symbols'
+	  * must be the same as when it was inserted). */
+	void eraseFile(std::span<const Symbol> symbols, unsigned filePos);
+
+	void clear();
+
+	/** All symbols with the given value. In order of file, and within a
+	  * file in the order of the symbols. */
+	[[nodiscard]] std::span<const Symbol* const> lookupValue(uint16_t value) const;
+
+	/** The symbol with the given name, or nullptr. If there's no exact
+	  * match, a case-insensitive match is returned. */
+	[[nodiscard]] const Symbol* lookupName(std::string_view name) const;
+
+	/** Like lookupName(), but only an exact (case-sensitive) match. */
+	[[nodiscard]] const Symbol* lookupExactName(std::string_view name) const;
+
+	[[nodiscard]] size_t size() const { return byValue.size(); }
+
+private:
+	struct Entry {
+		uint16_t value;
+		unsigned filePos;
+		const Symbol* symbol;
+	};
+	struct NameEntry {
+		unsigned filePos;
+		const Symbol* symbol;
+	};
+
+	void updateValueSymbols();
+
+private:
+	std::vector<Entry> byValue; // sorted on (value, filePos, symbol)
+	std::vector<const Symbol*> valueSymbols; // same order as 'byValue'
+	hash_map<std::string_view, std::vector<NameEntry>, XXHasher_IgnoreCase, StringOp::casecmp> byName;
+	unsigned numFiles = 0;
+};
+
+} // namespace openmsx
+
+#endif
@@ -438,18 +438,20 @@ template std::optional<uint32_t> SymbolManager::parseValue<uint32_t>(std::string
 	return symbolFile;
 }
 
-void SymbolManager::refresh()
+void SymbolManager::symbolsChanged(std::span<const Symbol> symbols)
 {
-	// Drop caches
-	lookupValueCache.clear();
+	++generation;
 
 	// Allow to access symbol-values in Tcl expression with syntax: $sym(JIFFY)
+	// Only the entries for the given (added or removed) symbols can change.
 	auto& interp = commandController.getInterpreter();
 	TclObject arrayName("sym");
-	interp.unsetVariable(arrayName.getString().c_str());
-	for (const auto& file : files) {
-		for (const auto& sym : file.symbols) {
-			interp.setVariable(arrayName, TclObject(sym.name), TclObject(sym.value));
+	for (const auto& sym : symbols) {
+		TclObject name(sym.name);
+		if (const auto* s = index.lookupExactName(sym.name)) {
+			interp.setVariable(arrayName, name, TclObject(s->value));
+		} else {
+			interp.unsetVariable(arrayName, name);
 		}
 	}
 
@@ -460,16 +462,28 @@ bool SymbolManager::reloadFile(
 	zstring_view filename, LoadEmpty loadEmpty, SymbolFile::Type type,
 	std::optional<uint8_t> slot, std::optional<uint16_t> segment)
 {
-	auto file = loadSymbolFile(filename, type, slot, segment); // might throw
+	return addFile(loadSymbolFile(filename, type, slot, segment), loadEmpty); // might throw
+}
+
+bool SymbolManager::addFile(SymbolFile file, LoadEmpty loadEmpty)
+{
 	if (file.symbols.empty() && loadEmpty == LoadEmpty::NOT_ALLOWED) return false;
 
-	if (auto it = std::ranges::find(files, filename, &SymbolFile::filename);
+	// Note: the index points to the symbols, those don't move when the
+	// SymbolFile objects are moved.
+	if (auto it = std::ranges::find(files, file.filename, &SymbolFile::filename);
 	    it == files.end()) {
 		files.push_back(std::move(file));
+		index.insertFile(files.back().symbols, narrow<unsigned>(files.size() - 1));
+		symbolsChanged(files.back().symbols);
 	} else {
-		*it = std::move(file);
+		auto pos = narrow<unsigned>(std::distance(files.begin(), it));
+		index.eraseFile(it->symbols, pos);
+		auto old = std::exchange(*it, std::move(file));
+		index.insertFile(it->symbols, pos);
+		symbolsChanged(old.symbols);
+		symbolsChanged(it->symbols);
 	}
-	refresh();
 	return true;
 }
 
@@ -477,33 +491,28 @@ void SymbolManager::removeFile(std::string_view filename)
 {
 	auto it = std::ranges::find(files, filename, &SymbolFile::filename);
 	if (it == files.end()) return; // not found
+	index.eraseFile(it->symbols, narrow<unsigned>(std::distance(files.begin(), it)));
+	auto old = std::move(*it);
 	files.erase(it);
-	refresh();
+	symbolsChanged(old.symbols);
 }
 
 void SymbolManager::removeAllFiles()
 {
+	index.clear();
+	auto old = std::move(files);
 	files.clear();
-	refresh();
+	for (const auto& file : old) {
+		symbolsChanged(file.symbols);
+	}
 }
 
 std::optional<uint16_t> SymbolManager::lookupSymbol(std::string_view str) const
 {
-	// linear search is fine: only used interactively
-	// prefer an exact match
-	for (const auto& file : files) {
-		if (auto it = std::ranges::find(file.symbols, str, &Symbol::name);
-		    it != file.symbols.end()) {
-			return it->value;
-		}
-	}
-	// but if not found, a case-insensitive match is fine as well
-	for (const auto& file : files) {
-		if (auto it = std::ranges::find_if(file.symbols, [&](const auto& sym) {
-			return StringOp::casecmp{}(str, sym.name); });
-		    it != file.symbols.end()) {
-			return it->value;
-		}
+	// prefer an exact match, but if not found, a case-insensitive match
+	// is fine as well
+	if (const auto* sym = index.lookupName(str)) {
+		return sym->value;
 	}
 	return {};
 }
@@ -516,20 +525,9 @@ std::optional<uint16_t> SymbolManager::parseSymbolOrValue(std::string_view str)
 	return parseValue<uint16_t>(str);
 }
 
-std::span<Symbol const * const> SymbolManager::lookupValue(uint16_t value)
+std::span<Symbol const * const> SymbolManager::lookupValue(uint16_t value) const
 {
-	if (lookupValueCache.empty()) {
-		for (const auto& file : files) {
-			for (const auto& sym : file.symbols) {
-				auto [it, inserted] = lookupValueCache.try_emplace(sym.value, std::vector<const Symbol*>{});
-				it->second.push_back(&sym);
-			}
-		}
-	}
-	if (auto* sym = lookup(lookupValueCache, value)) {
-		return *sym;
-	}
-	return {};
+	return index.lookupValue(value);
 }
 
 SymbolFile* SymbolManager::findFile(std::string_view filename)
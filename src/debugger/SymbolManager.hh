@@ -1,8 +1,9 @@
 #ifndef SYMBOL_MANAGER_HH
 #define SYMBOL_MANAGER_HH
 
+#include "SymbolIndex.hh"
+
 #include "function_ref.hh"
-#include "hash_map.hh"
 #include "zstring_view.hh"
 
 #include <cassert>
@@ -80,15 +81,21 @@ public:
 	enum class LoadEmpty : uint8_t { ALLOWED, NOT_ALLOWED };
 	bool reloadFile(zstring_view filename, LoadEmpty loadEmpty, SymbolFile::Type type,
 	                std::optional<uint8_t> slot, std::optional<uint16_t> segment);
+	// Same as reloadFile(), but for an already loaded file (see
+	// loadSymbolFile(), this part can be done in a background thread).
+	bool addFile(SymbolFile file, LoadEmpty loadEmpty);
 
 	void removeFile(std::string_view filename);
 	void removeAllFiles();
 
 	[[nodiscard]] const auto& getFiles() const { return files; }
 	[[nodiscard]] SymbolFile* findFile(std::string_view filename);
-	[[nodiscard]] std::span<Symbol const * const> lookupValue(uint16_t value);
+	[[nodiscard]] std::span<Symbol const * const> lookupValue(uint16_t value) const;
 	[[nodiscard]] std::optional<uint16_t> lookupSymbol(std::string_view s) const;
 	[[nodiscard]] std::optional<uint16_t> parseSymbolOrValue(std::string_view s) const;
+	/** Changes each time the set of symbols changes, e.g. to invalidate
+	  * cached results of lookupValue(). */
+	[[nodiscard]] uint64_t getGeneration() const { return generation; }
 
 	[[nodiscard]] static std::string getFileFilters();
 	[[nodiscard]] static SymbolFile::Type getTypeForFilter(std::string_view filter);
@@ -118,13 +125,14 @@ public:
 		std::optional<uint8_t> slot, std::optional<uint16_t> segment);
 
 private:
-	void refresh();
+	void symbolsChanged(std::span<const Symbol> symbols);
 
 private:
 	CommandController& commandController;
 	SymbolObserver* observer = nullptr; // only one for now, could become a vector later
 	std::vector<SymbolFile> files;
-	hash_map<uint16_t, std::vector<const Symbol*>> lookupValueCache; // calculated from 'files'
+	SymbolIndex index; // calculated from 'files'
+	uint64_t generation = 0;
 };
 
 
@@ -0,0 +1,198 @@
+#include "TraceArchive.hh"
+
+#include "FileException.hh"
+#include "FileOperations.hh"
+
+#include "stl.hh"
+#include "unreachable.hh"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <utility>
+
+namespace openmsx {
+
+enum class ArchiveTag : uint8_t { MONOSTATE, U64, DOUBLE, STRING };
+
+// See https://en.wikipedia.org/wiki/LEB128 for a description of the
+// 'unsigned LEB' format.
+static void storeUleb(std::vector<uint8_t>& result, uint64_t value)
+{
+	do {
+		uint8_t b = value & 0x7F;
+		value >>= 7;
+		if (value) b |= 0x80;
+		result.push_back(b);
+	} while (value);
+}
+
+[[nodiscard]] static uint64_t loadUleb(std::span<const uint8_t>& data)
+{
+	uint64_t result = 0;
+	int shift = 0;
+	while (true) {
+		assert(!data.empty());
+		uint8_t b = data.front();
+		data = data.subspan(1);
+		result |= uint64_t(b & 0x7F) << shift;
+		if ((b & 0x80) == 0) return result;
+		shift += 7;
+	}
+}
+
+static void encode(std::vector<uint8_t>& out, uint64_t deltaTime, const TraceValue& value)
+{
+	storeUleb(out, deltaTime);
+	value.visit(overloaded{
+		[&](std::monostate) {
+			out.push_back(uint8_t(ArchiveTag::MONOSTATE));
+		},
+		[&](uint64_t u) {
+			out.push_back(uint8_t(ArchiveTag::U64));
+			storeUleb(out, u);
+		},
+		[&](double d) {
+			out.push_back(uint8_t(ArchiveTag::DOUBLE));
+			auto bytes = std::bit_cast<std::array<uint8_t, sizeof(double)>>(d);
+			out.insert(out.end(), bytes.begin(), bytes.end());
+		},
+		[&](std::string_view s) {
+			out.push_back(uint8_t(ArchiveTag::STRING));
+			storeUleb(out, s.size());
+			out.insert(out.end(), s.begin(), s.end());
+		}
+	});
+}
+
+// Decode one event and advance 'data' past it.
+[[nodiscard]] static TraceEvent decode(std::span<const uint8_t>& data, uint64_t& time)
+{
+	time += loadUleb(data);
+	assert(!data.empty());
+	auto tag = ArchiveTag(data.front());
+	data = data.subspan(1);
+	auto value = [&] -> TraceValue {
+		switch (tag) {
+		case ArchiveTag::MONOSTATE:
+			return std::monostate{};
+		case ArchiveTag::U64:
+			return loadUleb(data);
+		case ArchiveTag::DOUBLE: {
+			std::array<uint8_t, sizeof(double)> bytes;
+			std::ranges::copy(data.first(bytes.size()), bytes.begin());
+			data = data.subspan(bytes.size());
+			return std::bit_cast<double>(bytes);
+		}
+		case ArchiveTag::STRING: {
+			auto len = size_t(loadUleb(data));
+			std::string_view s(std::bit_cast<const char*>(data.data()), len);
+			data = data.subspan(len);
+			return s;
+		}
+		default:
+			UNREACHABLE;
+		}
+	}();
+	return {EmuTime::fromUint64(time), std::move(value)};
+}
+
+TraceArchive::~TraceArchive()
+{
+	clear();
+}
+
+void TraceArchive::append(const TraceEvent& event)
+{
+	auto t = event.time.toUint64();
+	assert(t >= lastTime);
+	encode(pending, t - lastTime, event.value);
+	lastTime = t;
+	++numEvents;
+	if (pending.size() >= 64 * 1024) flush();
+}
+
+void TraceArchive::flush()
+{
+	if (pending.empty()) return;
+	if (!file.is_open()) {
+		auto fp = FileOperations::openUniqueFile(FileOperations::getTempDir(), filename);
+		if (!fp) {
+			throw FileException("Couldn't create temp file for trace data");
+		}
+		fp.reset();
+		file = File(filename, "wb+");
+	}
+	file.write(std::span{pending});
+	fileSize += pending.size();
+	pending.clear();
+}
+
+void TraceArchive::truncate(EmuTime time)
+{
+	if (empty() || (time.toUint64() > lastTime)) return;
+
+	// Find the first event at or after 'time', and its position in the
+	// encoded data. This is rare (only when a replay is interrupted), so
+	// a linear search is fine.
+	flush();
+	size_t newSize = 0;
+	size_t newNum = 0;
+	uint64_t newLastTime = 0;
+	{
+		file.flush();
+		auto mapped = file.mmap<const uint8_t>();
+		auto all = std::span{mapped.data(), fileSize};
+		auto data = all;
+		uint64_t t = 0;
+		while (!data.empty()) {
+			auto event = decode(data, t);
+			if (event.time >= time) break;
+			newSize = all.size() - data.size();
+			newLastTime = t;
+			++newNum;
+		}
+	}
+	if (newNum == 0) {
+		clear();
+		return;
+	}
+	fileSize = newSize;
+	numEvents = newNum;
+	lastTime = newLastTime;
+	file.seek(fileSize);
+}
+
+void TraceArchive::clear()
+{
+	file.close();
+	if (!filename.empty()) {
+		FileOperations::unlink(filename);
+		filename.clear();
+	}
+	pending.clear();
+	fileSize = 0;
+	numEvents = 0;
+	lastTime = 0;
+}
+
+
+// class TraceArchive::Reader
+
+TraceArchive::Reader::Reader(TraceArchive& archive)
+{
+	archive.flush();
+	if (archive.fileSize == 0) return;
+	archive.file.flush();
+	mapped = archive.file.mmap<const uint8_t>();
+	data = std::span{mapped.data(), archive.fileSize};
+}
+
+TraceEvent TraceArchive::Reader::next()
+{
+	assert(!atEnd());
+	return decode(data, time);
+}
+
+} // namespace openmsx
@@ -0,0 +1,81 @@
+#ifndef TRACEARCHIVE_HH
+#define TRACEARCHIVE_HH
+
+#include "EmuTime.hh"
+#include "File.hh"
+#include "MappedFile.hh"
+#include "TraceValue.hh"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace openmsx {
+
+struct TraceEvent {
+	EmuTime time;
+	TraceValue value;
+};
+
+/** Compact storage for the oldest events of a trace.
+  *
+  * Events are delta-encoded (the time as an LEB128 offset to the previous
+  * event, integers also as LEB128, strings without padding) and written to a
+  * temporary file, so a long-running trace doesn't keep growing in memory.
+  * The events can only be read back sequentially, via Reader, which memory
+  * maps that file.
+  */
+class TraceArchive
+{
+public:
+	TraceArchive() = default;
+	TraceArchive(const TraceArchive&) = delete;
+	TraceArchive(TraceArchive&&) = delete;
+	TraceArchive& operator=(const TraceArchive&) = delete;
+	TraceArchive& operator=(TraceArchive&&) = delete;
+	~TraceArchive();
+
+	/** Append an event, it must not be older than the last appended one.
+	  * @throws FileException when the temporary file can't be written. */
+	void append(const TraceEvent& event);
+
+	/** Drop all events at or after the given time.
+	  * @throws FileException */
+	void truncate(EmuTime time);
+
+	/** Drop all events and remove the temporary file. */
+	void clear();
+
+	[[nodiscard]] size_t size() const { return numEvents; }
+	[[nodiscard]] bool empty() const { return numEvents == 0; }
+
+	class Reader {
+	public:
+		/** @throws FileException */
+		explicit Reader(TraceArchive& archive);
+
+		[[nodiscard]] bool atEnd() const { return data.empty(); }
+		[[nodiscard]] TraceEvent next();
+
+	private:
+		MappedFile<const uint8_t> mapped;
+		std::span<const uint8_t> data;
+		uint64_t time = 0;
+	};
+
+private:
+	void flush();
+
+private:
+	std::string filename; // of the temporary file, empty if not yet created
+	File file;
+	std::vector<uint8_t> pending; // encoded, but not yet written to 'file'
+	size_t fileSize = 0; // can be smaller than the actual file, see truncate()
+	size_t numEvents = 0;
+	uint64_t lastTime = 0;
+};
+
+} // namespace openmsx
+
+#endif
@@ -0,0 +1,191 @@
+#include "TraceSummary.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <utility>
+
+namespace openmsx {
+
+[[nodiscard]] static constexpr uint64_t lowMask(size_t n)
+{
+	return (n >= 64) ? ~uint64_t(0) : ((uint64_t(1) << n) - 1);
+}
+
+static void append(TraceSummary::Node& node, bool value)
+{
+	if (node.empty()) {
+		node.first = value;
+	} else if (node.last != value) {
+		++node.numEdges;
+	}
+	node.last = value;
+	node.anyFalse |= !value;
+	node.anyTrue  |=  value;
+}
+
+[[nodiscard]] static TraceSummary::Node combine(const TraceSummary::Node& a, const TraceSummary::Node& b)
+{
+	if (a.empty()) return b;
+	if (b.empty()) return a;
+	return {.numEdges = a.numEdges + b.numEdges + (a.last != b.first),
+	        .first = a.first,
+	        .last = b.last,
+	        .anyFalse = a.anyFalse || b.anyFalse,
+	        .anyTrue  = a.anyTrue  || b.anyTrue};
+}
+
+void TraceSummary::push_back(bool value)
+{
+	auto i = num++;
+	if ((i % BITS) == 0) bits.push_back(0);
+	if (value) bits.back() |= uint64_t(1) << (i % BITS);
+
+	// The new value is the last one of one node on each level.
+	if (levels.empty()) levels.emplace_back();
+	size_t idx = i / BITS;
+	for (size_t level = 0; /**/; ++level, idx /= FANOUT) {
+		auto& nodes = levels[level];
+		if (idx == nodes.size()) nodes.emplace_back();
+		append(nodes[idx], value);
+		if (nodes.size() == 1) break; // this is the root
+
+		if (level + 1 == levels.size()) {
+			// Old root got a sibling: add a level on top, its (only)
+			// node starts as a copy of the old root.
+			auto oldRoot = nodes.front();
+			levels.emplace_back(1, oldRoot);
+		}
+	}
+}
+
+void TraceSummary::truncate(size_t newSize)
+{
+	if (newSize >= num) return;
+	auto oldBits = std::move(bits);
+	clear();
+	for (size_t i = 0; i < newSize; ++i) {
+		push_back((oldBits[i / BITS] >> (i % BITS)) & 1);
+	}
+}
+
+void TraceSummary::dropFront(size_t n)
+{
+	n = std::min(n, num);
+	auto oldBits = std::move(bits);
+	auto oldNum = num;
+	clear();
+	for (size_t i = n; i < oldNum; ++i) {
+		push_back((oldBits[i / BITS] >> (i % BITS)) & 1);
+	}
+}
+
+void TraceSummary::clear()
+{
+	bits.clear();
+	levels.clear();
+	num = 0;
+}
+
+TraceSummary::Node TraceSummary::summarizeWord(size_t idx, size_t begin, size_t end) const
+{
+	assert(begin < end && end <= BITS);
+	auto n = end - begin;
+	auto m = (bits[idx] >> begin) & lowMask(n);
+	auto ones = size_t(std::popcount(m));
+	return {.numEdges = size_t(std::popcount((m ^ (m >> 1)) & lowMask(n - 1))),
+	        .first = bool(m & 1),
+	        .last = bool((m >> (n - 1)) & 1),
+	        .anyFalse = ones < n,
+	        .anyTrue = ones != 0};
+}
+
+TraceSummary::Node TraceSummary::summarize(size_t level, size_t idx, size_t begin, size_t end) const
+{
+	auto nodeBegin = idx * nodeSpan(level);
+	auto nodeEnd = std::min(nodeBegin + nodeSpan(level), num);
+	begin = std::max(begin, nodeBegin);
+	end   = std::min(end,   nodeEnd);
+	if (begin >= end) return {};
+	if ((begin == nodeBegin) && (end == nodeEnd)) return levels[level][idx];
+	if (level == 0) return summarizeWord(idx, begin - nodeBegin, end - nodeBegin);
+
+	Node result;
+	auto childSpan = nodeSpan(level - 1);
+	auto c0 = (begin - nodeBegin) / childSpan;
+	auto c1 = (end - 1 - nodeBegin) / childSpan;
+	for (auto c = c0; c <= c1; ++c) {
+		result = combine(result, summarize(level - 1, idx * FANOUT + c, begin, end));
+	}
+	return result;
+}
+
+TraceSummary::Node TraceSummary::summarize(size_t begin, size_t end) const
+{
+	assert(begin <= end && end <= num);
+	if (begin == end) return {};
+	return summarize(levels.size() - 1, 0, begin, end);
+}
+
+size_t TraceSummary::findNext(size_t level, size_t idx, size_t begin, bool value) const
+{
+	auto nodeBegin = idx * nodeSpan(level);
+	auto nodeEnd = std::min(nodeBegin + nodeSpan(level), num);
+	if (nodeEnd <= begin) return num;
+	const auto& node = levels[level][idx];
+	if (!(value ? node.anyTrue : node.anyFalse)) return num;
+
+	auto from = (begin > nodeBegin) ? (begin - nodeBegin) : 0;
+	if (level == 0) {
+		auto w = value ? bits[idx] : ~bits[idx];
+		w &= ~lowMask(from) & lowMask(nodeEnd - nodeBegin);
+		return w ? (nodeBegin + size_t(std::countr_zero(w))) : num;
+	}
+
+	const auto& children = levels[level - 1];
+	for (auto c = from / nodeSpan(level - 1); c < FANOUT; ++c) {
+		auto childIdx = idx * FANOUT + c;
+		if (childIdx >= children.size()) break;
+		if (auto r = findNext(level - 1, childIdx, begin, value); r != num) return r;
+	}
+	return num;
+}
+
+size_t TraceSummary::findNext(size_t begin, bool value) const
+{
+	if (begin >= num) return num;
+	return findNext(levels.size() - 1, 0, begin, value);
+}
+
+std::optional<size_t> TraceSummary::findPrev(size_t level, size_t idx, size_t end, bool value) const
+{
+	auto nodeBegin = idx * nodeSpan(level);
+	if (end <= nodeBegin) return {};
+	const auto& node = levels[level][idx];
+	if (!(value ? node.anyTrue : node.anyFalse)) return {};
+
+	auto nodeEnd = std::min({nodeBegin + nodeSpan(level), num, end});
+	if (level == 0) {
+		auto w = value ? bits[idx] : ~bits[idx];
+		w &= lowMask(nodeEnd - nodeBegin);
+		if (!w) return {};
+		return nodeBegin + (BITS - 1 - size_t(std::countl_zero(w)));
+	}
+
+	const auto& children = levels[level - 1];
+	auto last = std::min((nodeEnd - 1 - nodeBegin) / nodeSpan(level - 1),
+	                     children.size() - 1 - idx * FANOUT);
+	for (auto c = last + 1; c-- > 0; /**/) {
+		if (auto r = findPrev(level - 1, idx * FANOUT + c, end, value)) return r;
+	}
+	return {};
+}
+
+std::optional<size_t> TraceSummary::findPrev(size_t end, bool value) const
+{
+	end = std::min(end, num);
+	if (end == 0) return {};
+	return findPrev(levels.size() - 1, 0, end, value);
+}
+
+} // namespace openmsx
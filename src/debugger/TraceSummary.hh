@@ -0,0 +1,82 @@
+#ifndef TRACESUMMARY_HH
+#define TRACESUMMARY_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace openmsx {
+
+/** Hierarchical (mipmap-like) summary of the boolean value of each event in
+  * a trace, built incrementally while events are added.
+  *
+  * The values themselves are stored as a bit per event. On top of that
+  * there's a pyramid of nodes: a node on level 0 summarizes 64 events, a
+  * node on level N+1 summarizes FANOUT nodes of level N. Each node stores
+  * whether it contains false and/or true values (the min and max value),
+  * its first and last value and the number of value changes (edges).
+  *
+  * This allows to summarize any range of events, or to search for the
+  * next/previous event with a given value, in O(FANOUT * log(N)) instead of
+  * in O(N). E.g. for a probe that is triggered a million times without
+  * changing its value.
+  */
+class TraceSummary
+{
+public:
+	static constexpr size_t BITS = 64; // events per level 0 node
+	static constexpr size_t LOG_FANOUT = 4;
+	static constexpr size_t FANOUT = 1 << LOG_FANOUT;
+
+	struct Node {
+		size_t numEdges = 0; // value changes between consecutive events
+		bool first = false;
+		bool last = false;
+		bool anyFalse = false;
+		bool anyTrue = false;
+
+		[[nodiscard]] bool empty() const { return !anyFalse && !anyTrue; }
+	};
+
+	void push_back(bool value);
+	/** Drop all values starting at the given index (rare, this rebuilds the
+	  * whole pyramid). */
+	void truncate(size_t newSize);
+	/** Drop the first n values (also rebuilds the whole pyramid). */
+	void dropFront(size_t n);
+	void clear();
+
+	[[nodiscard]] size_t size() const { return num; }
+	[[nodiscard]] bool operator[](size_t i) const {
+		return (bits[i / BITS] >> (i % BITS)) & 1;
+	}
+
+	/** Summary of the values in the range [begin, end). */
+	[[nodiscard]] Node summarize(size_t begin, size_t end) const;
+
+	/** Index of the first value >= 'begin' that equals 'value', or size()
+	  * when there's no such value. */
+	[[nodiscard]] size_t findNext(size_t begin, bool value) const;
+
+	/** Index of the last value < 'end' that equals 'value'. */
+	[[nodiscard]] std::optional<size_t> findPrev(size_t end, bool value) const;
+
+private:
+	[[nodiscard]] static constexpr size_t nodeSpan(size_t level) {
+		return BITS << (LOG_FANOUT * level);
+	}
+	[[nodiscard]] Node summarize(size_t level, size_t idx, size_t begin, size_t end) const;
+	[[nodiscard]] Node summarizeWord(size_t idx, size_t begin, size_t end) const;
+	[[nodiscard]] size_t findNext(size_t level, size_t idx, size_t begin, bool value) const;
+	[[nodiscard]] std::optional<size_t> findPrev(size_t level, size_t idx, size_t end, bool value) const;
+
+private:
+	std::vector<uint64_t> bits;
+	std::vector<std::vector<Node>> levels; // levels.back() has a single (root) node
+	size_t num = 0;
+};
+
+} // namespace openmsx
+
+#endif
@@ -3,6 +3,8 @@
 #include "Debugger.hh"
 #include "ProbeBreakPoint.hh"
 
+#include "CommandException.hh"
+#include "FileException.hh"
 #include "Interpreter.hh"
 #include "MSXMotherBoard.hh"
 #include "ReverseManager.hh"
@@ -16,12 +18,20 @@
 
 #include <cassert>
 #include <format>
+#include <limits>
+#include <optional>
 #include <queue>
+#include <span>
 
 namespace openmsx {
 
 Tracer::Tracer(Debugger& debugger)
 	: stateChangeDistributor(debugger.getMotherBoard().getStateChangeDistributor())
+	, memoryLimitSetting(
+		debugger.getMotherBoard().getCommandController(), "trace_memory_limit",
+		"Maximum number of events per trace that is kept in memory, older events are "
+		"moved to a temporary file (0 means no limit).",
+		4'000'000, 0, std::numeric_limits<int>::max())
 {
 	stateChangeDistributor.registerListener(*this);
 }
@@ -47,12 +57,55 @@ void Tracer::Trace::addEvent(EmuTime t, TraceValue v, bool merge)
 		[](std::string_view) { return STRING; }
 	});
 	type = std::max(type, valueFormat);
+	summary.push_back(v.get_as_bool());
 	events.emplace_back(t, std::move(v));
+
+	if (auto limit = memoryLimit ? size_t(memoryLimit->getInt()) : 0;
+	    limit && (events.size() > limit)) {
+		// keep the most recent half, so that this only happens once in a while
+		spill(events.size() - limit / 2);
+	}
+}
+
+void Tracer::Trace::spill(size_t n)
+{
+	assert(n <= events.size());
+	auto numArchived = archive.size();
+	try {
+		for (const auto& event : std::span{events}.first(n)) {
+			archive.append(event);
+		}
+	} catch (FileException&) {
+		// Can't write the temporary file (e.g. the disk is full). Then
+		// drop these events, keeping memory bounded is more important.
+		numDropped += numArchived + n;
+		archive.clear();
+	}
+	events.erase(events.begin(), events.begin() + ptrdiff_t(n));
+	summary.dropFront(n);
 }
 
 void Tracer::Trace::clear()
 {
 	events.clear();
+	summary.clear();
+	archive.clear();
+	numDropped = 0;
+}
+
+void Tracer::Trace::truncate(EmuTime time)
+{
+	auto it = std::ranges::lower_bound(events, time, {}, &Event::time);
+	events.erase(it, events.end());
+	summary.truncate(events.size());
+	if (events.empty()) {
+		try {
+			archive.truncate(time);
+		} catch (FileException&) {
+			numDropped += archive.size();
+			archive.clear();
+		}
+	}
 }
 
 void Tracer::Trace::attachProbe(Debugger& debugger, ProbeBase& probe)
@@ -115,6 +168,7 @@ void Tracer::transfer(Debugger& oldDebugger, Debugger& newDebugger)
 				trace->attachProbe(newDebugger, *newProbe);
 			}
 		}
+		trace->memoryLimit = &memoryLimitSetting;
 		traces.push_back(std::move(trace));
 	}
 	oldTracer.traces.clear();
@@ -124,8 +178,7 @@ void Tracer::stopReplay(EmuTime time) noexcept
 {
 	// when replay stops, drop all future events
 	for (auto& trace : traces) {
-		auto it = std::ranges::lower_bound(trace->events, time, {}, &Event::time);
-		trace->events.erase(it, trace->events.end());
+		trace->truncate(time);
 	}
 }
 
@@ -137,6 +190,7 @@ Tracer::Trace& Tracer::getOrCreateTrace(Debugger& debugger, std::string_view nam
 			return it->get();
 		} else {
 			it = traces.insert(it, std::make_unique<Trace>(std::string(name)));
+			(*it)->memoryLimit = &memoryLimitSetting;
 			return it->get();
 		}
 	}();
@@ -248,15 +302,22 @@ void Tracer::list(Command& cmd, std::span<const TclObject> tokens, TclObject& re
 	} else {
 		// list specific trace
 		std::string_view name = tokens[3].getString();
-		const Trace* trace = findTrace(name);
+		Trace* trace = findTrace(name);
 		if (!trace) {
 			throw CommandException("No such trace: ", name);
 		}
-		for (const auto& event : trace->events) {
+		auto addEvent = [&](const Event& event) {
 			result.addListElement(makeTclList(
 				event.time.toDouble(),
 				toTclObject(event.value)));
+		};
+		try {
+			TraceArchive::Reader reader(trace->archive);
+			while (!reader.atEnd()) addEvent(reader.next());
+		} catch (FileException& e) {
+			throw CommandException("Couldn't read the archived events: ", e.getMessage());
 		}
+		for (const auto& event : trace->events) addEvent(event);
 	}
 }
 
@@ -381,14 +442,34 @@ void Tracer::tabCompletion(const Debugger& debugger, std::vector<std::string>& t
 
 void Tracer::exportVCD(zstring_view filename)
 {
+	// Per trace: first stream the archived events (from disk), then the
+	// ones in memory.
+	struct Cursor {
+		std::optional<TraceArchive::Reader> reader;
+		size_t idx = 0;
+		std::optional<Event> current;
+	};
+	std::vector<Cursor> cursors(traces.size());
+	auto advance = [&](size_t i) {
+		auto& c = cursors[i];
+		const auto& t = *traces[i];
+		if (c.reader && !c.reader->atEnd()) {
+			c.current = c.reader->next();
+		} else if (c.idx < t.events.size()) {
+			c.current = t.events[c.idx++];
+		} else {
+			c.current.reset();
+		}
+	};
+
 	// k-way merge using a min-heap over traces to avoid collecting & sorting all events
-	std::vector<size_t> idx(traces.size(), 0);
 	using HeapEntry = std::pair<uint64_t, size_t>; // time, trace
 	std::priority_queue<HeapEntry, std::vector<HeapEntry>, std::greater<HeapEntry>> heap;
 	for (size_t i = 0; i < traces.size(); ++i) {
-		const auto& t = *traces[i];
-		if (!t.events.empty()) {
-			heap.emplace(t.events.front().time.toUint64(), i);
+		cursors[i].reader.emplace(traces[i]->archive);
+		advance(i);
+		if (cursors[i].current) {
+			heap.emplace(cursors[i].current->time.toUint64(), i);
 		}
 	}
 
@@ -486,9 +567,9 @@ void Tracer::exportVCD(zstring_view filename)
 	for (size_t i = 0; i < traces.size(); ++i) {
 		const auto& t = *traces[i];
 		TraceValue initVal = std::monostate{};
-		if (!t.events.empty()) {
-			uint64_t firstNs = t.events.front().time.toUint64();
-			if (firstNs == 0) initVal = t.events.front().value;
+		if (const auto& first = cursors[i].current) {
+			uint64_t firstNs = first->time.toUint64();
+			if (firstNs == 0) initVal = first->value;
 		}
 		emitValue(t.getType(), i, initVal, false);
 	}
@@ -504,15 +585,13 @@ void Tracer::exportVCD(zstring_view filename)
 			os << '#' << time << '\n';
 		}
 
-		size_t pos = idx[tr];
-		const auto& t = *traces[tr];
-		const auto& val = t.events[pos].value;
-		emitValue(t.getType(), tr, val, true);
+		auto& c = cursors[tr];
+		emitValue(traces[tr]->getType(), tr, c.current->value, true);
 
-		// advance index and push next event for this trace
-		++idx[tr];
-		if (idx[tr] < t.events.size()) {
-			heap.emplace(t.events[idx[tr]].time.toUint64(), tr);
+		// advance and push next event for this trace
+		advance(tr);
+		if (c.current) {
+			heap.emplace(c.current->time.toUint64(), tr);
 		}
 	}
 }
@@ -2,8 +2,11 @@
 #define TRACER_HH
 
 #include "EmuTime.hh"
+#include "IntegerSetting.hh"
 #include "StateChangeListener.hh"
 #include "TclObject.hh"
+#include "TraceArchive.hh"
+#include "TraceSummary.hh"
 #include "TraceValue.hh"
 
 #include "Observer.hh"
@@ -21,10 +24,7 @@ class StateChangeDistributor;
 class Tracer final : public StateChangeListener
 {
 public:
-	struct Event {
-		EmuTime time;
-		TraceValue value;
-	};
+	using Event = TraceEvent;
 	struct Trace final : Observer<ProbeBase> {
 		// Type of values seen so far. Ordered from specific to general:
 		enum class Type : uint8_t { MONOSTATE = 0, BOOL = 1, INTEGER = 2, DOUBLE = 3, STRING = 4 };
@@ -36,9 +36,11 @@ public:
 
 		void addEvent(EmuTime t, TraceValue v, bool merge);
 		void clear();
+		void truncate(EmuTime time); // drop all events at or after 'time'
 		void attachProbe(Debugger& debugger, ProbeBase& probe);
 		void detachProbe(ProbeBase& probe);
 		void update(const ProbeBase& subject) noexcept override;
+		void spill(size_t n);
 
 		[[nodiscard]] bool isBool() const { return type == Type::BOOL; }
 		[[nodiscard]] Type getType() const { return type; }
@@ -49,7 +51,11 @@ public:
 
 		std::string name;
 		std::string description;
-		std::vector<Event> events;
+		std::vector<Event> events; // the most recent events
+		TraceSummary summary; // of 'events[i].value.get_as_bool()'
+		TraceArchive archive; // older events, moved out of 'events'
+		size_t numDropped = 0; // older events lost because they couldn't be archived
+		const IntegerSetting* memoryLimit = nullptr; // max size of 'events', owned by the Tracer
 		MSXMotherBoard* motherBoard = nullptr; // non-nullptr if attached to a Probe
 		Type type = Type::MONOSTATE;
 		Format format = Format::DEC;
@@ -92,6 +98,7 @@ private:
 
 private:
 	StateChangeDistributor& stateChangeDistributor;
+	IntegerSetting memoryLimitSetting;
 	std::vector<std::unique_ptr<Trace>> traces; // sorted on name
 };
 
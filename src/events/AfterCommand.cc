@@ -13,6 +13,7 @@
 #include "Reactor.hh"
 #include "Schedulable.hh"
 #include "TclObject.hh"
+#include "TclProfiler.hh"
 
 #include "strCat.hh"
 #include "StringOp.hh"
@@ -39,6 +40,8 @@ struct DelayedCommand {
 	AfterCommand& afterCommand;
 
 	void execute() {
+		TclProfiler::Scope profile(TclProfiler::Kind::AFTER,
+			[&] { return command.getString(); });
 		try {
 			command.executeCommand(afterCommand.getInterpreter());
 		} catch (CommandException& e) {
@@ -54,15 +57,18 @@ public:
 	[[nodiscard]] const auto& getCommand() const { return command; }
 	[[nodiscard]] auto getId() const { return id; }
 	[[nodiscard]] auto getIdStr() const { return tmpStrCat("after#", id); }
+	[[nodiscard]] auto getIndex() const { return idx; }
 	[[nodiscard]] DelayedCommand extractCommand();
+	void setIndex(AfterCommand::Index idx_) { idx = idx_; }
 protected:
 	AfterCmd(AfterCommand& afterCommand,
 		 TclObject command);
-	AfterCommand::Index removeSelf();
 
 	AfterCommand& afterCommand;
 	TclObject command;
 	const unsigned id;
+	AfterCommand::Index idx = 0; // index of this object in 'afterCmdPool'
+
 	static inline unsigned lastAfterId = 0;
 };
 
@@ -139,6 +145,56 @@ using AllAfterCmds = std::variant<AfterTimeCmd,
                                   AfterRealTimeCmd>;
 static ObjectPool<AllAfterCmds> afterCmdPool;
 
+[[nodiscard]] static AfterCmd& getCmd(AfterCommand::Index idx)
+{
+	return std::visit([](AfterCmd& cmd) -> AfterCmd& { return cmd; }, afterCmdPool[idx]);
+}
+
+[[nodiscard]] static size_t simpleEventSlot(EventType type)
+{
+	switch (type) {
+		using enum EventType;
+		case FINISH_FRAME:   return 0;
+		case BREAK:          return 1;
+		case BOOT:           return 2;
+		case QUIT:           return 3;
+		case MACHINE_LOADED: return 4;
+		default: UNREACHABLE;
+	}
+}
+
+static void eraseIndex(std::vector<AfterCommand::Index>& cmds, AfterCommand::Index idx)
+{
+	if (auto it = std::ranges::find(cmds, idx); it != cmds.end()) {
+		cmds.erase(it); // keep the order, that's the execution order
+	}
+}
+
+template<typename CmdType, typename... Args>
+CmdType& AfterCommand::addCmd(Args&&... args)
+{
+	auto [idx, ptr] = afterCmdPool.emplace(
+		std::in_place_type_t<CmdType>{}, std::forward<Args>(args)...);
+	auto& cmd = std::get<CmdType>(*ptr);
+	cmd.setIndex(idx);
+	afterCmds.insert_noDuplicateCheck(idx);
+	return cmd;
+}
+
+// Remove the command from all bookkeeping (but not from 'afterCmdPool').
+void AfterCommand::unlink(Index idx)
+{
+	afterCmds.erase(idx);
+	std::visit(overloaded {
+		[&](const AfterTimeCmd&        /*cmd*/) { eraseIndex(expiredCmds, idx); },
+		[&](const AfterIdleCmd&        /*cmd*/) { eraseIndex(expiredCmds, idx);
+		                                          eraseIndex(idleCmds, idx); },
+		[&](const AfterSimpleEventCmd& cmd    ) { eraseIndex(simpleEventCmds[simpleEventSlot(cmd.getTypeEnum())], idx); },
+		[&](const AfterInputEventCmd&  /*cmd*/) { eraseIndex(inputEventCmds, idx); },
+		[&](const AfterRealTimeCmd&    /*cmd*/) { /*nothing*/ }
+	}, afterCmdPool[idx]);
+}
+
 
 AfterCommand::AfterCommand(Reactor& reactor_,
                            EventDistributor& eventDistributor_,
@@ -232,22 +288,18 @@ void AfterCommand::afterTime(std::span<const TclObject> tokens, TclObject& resul
 	MSXMotherBoard* motherBoard = reactor.getMotherBoard();
 	if (!motherBoard) return;
 	double time = getTime(getInterpreter(), tokens[2]);
-	auto [idx, ptr] = afterCmdPool.emplace(
-		std::in_place_type_t<AfterTimeCmd>{},
+	auto& cmd = addCmd<AfterTimeCmd>(
 		motherBoard->getScheduler(), *this, tokens[3], time);
-	result = std::get<AfterTimeCmd>(*ptr).getIdStr();
-	afterCmds.push_back(idx);
+	result = cmd.getIdStr();
 }
 
 void AfterCommand::afterRealTime(std::span<const TclObject> tokens, TclObject& result)
 {
 	checkNumArgs(tokens, 4, Prefix{2}, "seconds command");
 	double time = getTime(getInterpreter(), tokens[2]);
-	auto [idx, ptr] = afterCmdPool.emplace(
-		std::in_place_type_t<AfterRealTimeCmd>{},
+	auto& cmd = addCmd<AfterRealTimeCmd>(
 		reactor.getRTScheduler(), *this, tokens[3], time);
-	result = std::get<AfterRealTimeCmd>(*ptr).getIdStr();
-	afterCmds.push_back(idx);
+	result = cmd.getIdStr();
 }
 
 void AfterCommand::afterTclTime(
@@ -255,32 +307,28 @@ void AfterCommand::afterTclTime(
 {
 	TclObject command;
 	command.addListElements(std::views::drop(tokens, 2));
-	auto [idx, ptr] = afterCmdPool.emplace(
-		std::in_place_type_t<AfterRealTimeCmd>{},
+	auto& cmd = addCmd<AfterRealTimeCmd>(
 		reactor.getRTScheduler(), *this, command, ms * (1.0 / 1000.0));
-	result = std::get<AfterRealTimeCmd>(*ptr).getIdStr();
-	afterCmds.push_back(idx);
+	result = cmd.getIdStr();
 }
 
 void AfterCommand::afterSimpleEvent(std::span<const TclObject> tokens, TclObject& result, EventType type)
 {
 	checkNumArgs(tokens, 3, "command");
-	auto [idx, ptr] = afterCmdPool.emplace(
-		std::in_place_type_t<AfterSimpleEventCmd>{},
+	auto& cmd = addCmd<AfterSimpleEventCmd>(
 		*this, tokens[2], type);
-	result = std::get<AfterSimpleEventCmd>(*ptr).getIdStr();
-	afterCmds.push_back(idx);
+	simpleEventCmds[simpleEventSlot(type)].push_back(cmd.getIndex());
+	result = cmd.getIdStr();
 }
 
 void AfterCommand::afterInputEvent(
 	Event event, std::span<const TclObject> tokens, TclObject& result)
 {
 	checkNumArgs(tokens, 3, "command");
-	auto [idx, ptr] = afterCmdPool.emplace(
-		std::in_place_type_t<AfterInputEventCmd>{},
+	auto& cmd = addCmd<AfterInputEventCmd>(
 		*this, std::move(event), tokens[2]);
-	result = std::get<AfterInputEventCmd>(*ptr).getIdStr();
-	afterCmds.push_back(idx);
+	inputEventCmds.push_back(cmd.getIndex());
+	result = cmd.getIdStr();
 }
 
 void AfterCommand::afterIdle(std::span<const TclObject> tokens, TclObject& result)
@@ -289,17 +337,20 @@ void AfterCommand::afterIdle(std::span<const TclObject> tokens, TclObject& resul
 	MSXMotherBoard* motherBoard = reactor.getMotherBoard();
 	if (!motherBoard) return;
 	double time = getTime(getInterpreter(), tokens[2]);
-	auto [idx, ptr] = afterCmdPool.emplace(
-		std::in_place_type_t<AfterIdleCmd>{},
+	auto& cmd = addCmd<AfterIdleCmd>(
 		motherBoard->getScheduler(), *this, tokens[3], time);
-	result = std::get<AfterIdleCmd>(*ptr).getIdStr();
-	afterCmds.push_back(idx);
+	idleCmds.push_back(cmd.getIndex());
+	result = cmd.getIdStr();
 }
 
 void AfterCommand::afterInfo(std::span<const TclObject> /*tokens*/, TclObject& result) const
 {
+	// list in order of creation
+	auto sorted = to_vector(afterCmds);
+	std::ranges::sort(sorted, {}, [](Index idx) { return getCmd(idx).getId(); });
+
 	std::string str;
-	for (auto idx : afterCmds) {
+	for (auto idx : sorted) {
 		const auto& var = afterCmdPool[idx];
 		std::visit([&](const AfterCmd& cmd) { strAppend(str, cmd.getIdStr(), ": "); }, var);
 		std::visit(overloaded {
@@ -320,17 +371,12 @@ void AfterCommand::afterCancel(std::span<const TclObject> tokens, TclObject& /*r
 	if (tokens.size() == 3) {
 		if (auto idStr = tokens[2].getString(); idStr.starts_with("after#")) {
 			if (auto id = StringOp::stringTo<unsigned>(idStr.substr(6))) {
-				auto equalId = [id = *id](Index idx) {
-					return std::visit([&](const AfterCmd& cmd) {
-						 return cmd.getId() == id;
-					}, afterCmdPool[idx]);
-				};
-				if (auto it = std::ranges::find_if(afterCmds, equalId);
-				    it != end(afterCmds)) {
-					auto idx = *it;
-					afterCmds.erase(it);
-					afterCmdPool.remove(idx);
-					return;
+				for (auto idx : afterCmds) {
+					if (getCmd(idx).getId() == *id) {
+						unlink(idx);
+						afterCmdPool.remove(idx);
+						return;
+					}
 				}
 			}
 		}
@@ -338,21 +384,21 @@ void AfterCommand::afterCancel(std::span<const TclObject> tokens, TclObject& /*r
 	TclObject command;
 	command.addListElements(std::views::drop(tokens, 2));
 	std::string_view cmdStr = command.getString();
-	auto equalCmd = [&](Index idx) {
-		return std::visit([&](const AfterCmd& cmd) {
-			return cmd.getCommand() == cmdStr;
-		}, afterCmdPool[idx]);
-	};
-	if (auto it = std::ranges::find_if(afterCmds, equalCmd);
-	    it != end(afterCmds)) {
-		auto idx = *it;
-		afterCmds.erase(it);
+	// Tcl manual is not clear about this, but it seems there's only
+	// occurrences of this command canceled. It's also not clear which of
+	// the (possibly) several matches is canceled, we take the oldest.
+	const AfterCmd* oldest = nullptr;
+	for (auto idx : afterCmds) {
+		const auto& cmd = getCmd(idx);
+		if ((cmd.getCommand() == cmdStr) &&
+		    (!oldest || (cmd.getId() < oldest->getId()))) {
+			oldest = &cmd;
+		}
+	}
+	if (oldest) {
+		auto idx = oldest->getIndex();
+		unlink(idx);
 		afterCmdPool.remove(idx);
-		// Tcl manual is not clear about this, but it seems
-		// there's only occurrences of this command canceled.
-		// It's also not clear which of the (possibly) several
-		// matches is canceled.
-		return;
 	}
 	// It's not an error if no match is found
 }
@@ -384,56 +430,35 @@ void AfterCommand::tabCompletion(std::vector<std::string>& tokens) const
 	// TODO : make more complete
 }
 
-// Execute the cmds for which the predicate returns true, and erase those from afterCmds.
-void AfterCommand::executeMatches(std::predicate<Index> auto pred)
+// Execute the cmds (from the given list) for which the predicate returns true,
+// and erase those from the list and from afterCmds.
+void AfterCommand::executeMatches(std::vector<Index>& cmds, std::predicate<Index> auto pred)
 {
 	static std::vector<Index> matches; // static to keep capacity for next call
 	assert(matches.empty());
 
-	// Usually there are very few matches (typically even 0 or 1), so no
-	// need to reserve() space.
-	auto p = partition_copy_remove(afterCmds, std::back_inserter(matches), pred);
-	afterCmds.erase(p.second, end(afterCmds));
+	auto p = partition_copy_remove(cmds, std::back_inserter(matches), pred);
+	cmds.erase(p.second, end(cmds));
+	for (auto idx : matches) afterCmds.erase(idx);
 	for (auto idx : matches) {
-		auto delayed = std::visit([](AfterCmd& cmd) { return cmd.extractCommand(); },
-		                          afterCmdPool[idx]);
+		auto delayed = getCmd(idx).extractCommand();
 		afterCmdPool.remove(idx);
 		delayed.execute();
 	}
 	matches.clear(); // for next call (but keep capacity)
 }
 
-struct AfterSimpleEventPred {
-	bool operator()(AfterCommand::Index idx) const {
-		return std::visit(overloaded {
-			[&](const AfterSimpleEventCmd& cmd) { return cmd.getTypeEnum() == type; },
-			[&](const AfterCmd& /*cmd*/) { return false; }
-		}, afterCmdPool[idx]);
-	}
-	const EventType type;
-};
 void AfterCommand::executeSimpleEvents(EventType type)
 {
-	executeMatches(AfterSimpleEventPred{type});
+	executeMatches(simpleEventCmds[simpleEventSlot(type)],
+	               [](Index /*idx*/) { return true; });
 }
 
-struct AfterEmuTimePred {
-	bool operator()(AfterCommand::Index idx) const {
-		return std::visit(overloaded {
-			[&](const AfterTimedCmd& cmd) { return cmd.getTime() == 0.0; },
-			[&](const AfterCmd& /*cmd*/) { return false; }
-		}, afterCmdPool[idx]);
-	}
-};
-
 struct AfterInputEventPred {
 	explicit AfterInputEventPred(const Event& event_)
 		: event(event_) {}
 	bool operator()(AfterCommand::Index idx) const {
-		return std::visit(overloaded {
-			[&](const AfterInputEventCmd& cmd) { return matches(cmd.getEvent(), event); },
-			[&](const AfterCmd& /*cmd*/) { return false; }
-		}, afterCmdPool[idx]);
+		return matches(std::get<AfterInputEventCmd>(afterCmdPool[idx]).getEvent(), event);
 	}
 	const Event& event;
 };
@@ -451,15 +476,12 @@ bool AfterCommand::signalEvent(const Event& event)
 			executeSimpleEvents(EventType::QUIT);
 		},
 		[&](const AfterTimedEvent&) {
-			executeMatches(AfterEmuTimePred());
+			executeMatches(expiredCmds, [](Index /*idx*/) { return true; });
 		},
 		[&](const EventBase&) {
-			executeMatches(AfterInputEventPred(event));
-			for (auto idx : afterCmds) {
-				std::visit(overloaded {
-					[](AfterIdleCmd& cmd) { cmd.reschedule(); },
-					[](const AfterCmd& /*cmd*/) { /*nothing*/ }
-				}, afterCmdPool[idx]);
+			executeMatches(inputEventCmds, AfterInputEventPred(event));
+			for (auto idx : idleCmds) {
+				std::get<AfterIdleCmd>(afterCmdPool[idx]).reschedule();
 			}
 		}
 	}, event);
@@ -479,17 +501,6 @@ DelayedCommand AfterCmd::extractCommand()
 	return DelayedCommand{.command = std::move(command), .afterCommand = afterCommand};
 }
 
-AfterCommand::Index AfterCmd::removeSelf()
-{
-	auto equalThis = [&](AfterCommand::Index idx) {
-		return std::visit([&](const AfterCmd& cmd) { return &cmd == this; },
-			          afterCmdPool[idx]);
-	};
-	auto it = rfind_if_unguarded(afterCommand.afterCmds, equalThis);
-	auto idx = *it;
-	afterCommand.afterCmds.erase(it); // move_pop_back ?
-	return idx;
-}
 
 
 // class  AfterTimedCmd
@@ -518,13 +529,15 @@ void AfterTimedCmd::reschedule()
 
 void AfterTimedCmd::executeUntil(EmuTime /*time*/)
 {
+	if (time == 0.0) return; // already expired (rescheduled 'after idle')
 	time = 0.0; // execute on next event
+	afterCommand.expiredCmds.push_back(idx);
 	afterCommand.eventDistributor.distributeEvent(AfterTimedEvent());
 }
 
 void AfterTimedCmd::schedulerDeleted()
 {
-	auto idx = removeSelf();
+	afterCommand.unlink(idx);
 	afterCmdPool.remove(idx);
 }
 
@@ -599,12 +612,11 @@ AfterRealTimeCmd::AfterRealTimeCmd(
 
 void AfterRealTimeCmd::executeRT()
 {
-	// Remove self before executing, but keep self alive till the end of
-	// this method. Otherwise execute could execute 'after cancel ..' and
-	// removeSelf() asserts that it can't find itself anymore.
-	auto idx = removeSelf();
+	// Remove self before executing. Otherwise execute could execute
+	// 'after cancel ..' on this command.
+	afterCommand.unlink(idx);
 	auto delayed = extractCommand();
-	afterCmdPool.remove(idx);
+	afterCmdPool.remove(idx); // destroys 'this'
 	delayed.execute();
 }
 
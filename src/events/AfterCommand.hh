@@ -6,6 +6,9 @@
 
 #include "Command.hh"
 
+#include "hash_set.hh"
+
+#include <array>
 #include <concepts>
 #include <vector>
 
@@ -31,7 +34,10 @@ public:
 	void tabCompletion(std::vector<std::string>& tokens) const override;
 
 private:
-	void executeMatches(std::predicate<Index> auto pred);
+	template<typename CmdType, typename... Args>
+	CmdType& addCmd(Args&&... args);
+	void unlink(Index idx);
+	void executeMatches(std::vector<Index>& cmds, std::predicate<Index> auto pred);
 	void executeSimpleEvents(EventType type);
 	void afterSimpleEvent(std::span<const TclObject> tokens, TclObject& result, EventType type);
 	void afterInputEvent(Event event,
@@ -48,7 +54,18 @@ private:
 	bool signalEvent(const Event& event) override;
 
 private:
-	std::vector<Index> afterCmds;
+	// All pending commands, in no particular order (sort on id when the
+	// order matters).
+	hash_set<Index> afterCmds;
+	// Per trigger, only the commands that may fire on that trigger. So
+	// dispatching an event doesn't need to look at all pending commands.
+	// 'after time/idle/realtime' commands are ordered on time by the
+	// (RT)Scheduler, they're only added to 'expiredCmds' once their time
+	// has passed.
+	std::array<std::vector<Index>, 5> simpleEventCmds; // see simpleEventSlot()
+	std::vector<Index> inputEventCmds;
+	std::vector<Index> idleCmds;
+	std::vector<Index> expiredCmds;
 	Reactor& reactor;
 	EventDistributor& eventDistributor;
 
@@ -0,0 +1,33 @@
+#include "BinaryCliCommParser.hh"
+
+#include "endian.hh"
+
+BinaryCliCommParser::BinaryCliCommParser(std::function<void(const std::string&)> callback_)
+	: callback(std::move(callback_))
+{
+}
+
+void BinaryCliCommParser::parse(std::span<const char> buf)
+{
+	buffer.append(buf.data(), buf.size());
+	std::span<const char> data = buffer;
+	while (data.size() >= 4) {
+		auto size = Endian::read_UA_L32(data.data());
+		if ((data.size() - 4) < size) break; // wait for more data
+		parseMessage(data.subspan(4, size));
+		data = data.subspan(4 + size);
+	}
+	buffer.erase(0, buffer.size() - data.size());
+}
+
+void BinaryCliCommParser::parseMessage(std::span<const char> message)
+{
+	while (message.size() >= 4) {
+		auto size = Endian::read_UA_L32(message.data());
+		message = message.subspan(4);
+		if (message.size() < size) break; // malformed, ignore the rest
+		command.assign(message.data(), size);
+		callback(command);
+		message = message.subspan(size);
+	}
+}
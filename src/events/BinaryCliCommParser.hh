@@ -0,0 +1,29 @@
+#ifndef BINARYCLICOMMPARSER_HH
+#define BINARYCLICOMMPARSER_HH
+
+#include <functional>
+#include <span>
+#include <string>
+
+/** Parser for the binary variant of the control protocol (see
+  * doc/manual/openmsx-control.html). The input is a sequence of messages:
+  *   uint32 (little endian) size of the message, followed by the message
+  * where each message contains one or more commands:
+  *   uint32 (little endian) size of the command, followed by the command
+  * The callback is invoked for each command, in order.
+  */
+class BinaryCliCommParser
+{
+public:
+	explicit BinaryCliCommParser(std::function<void(const std::string&)> callback);
+	void parse(std::span<const char> buf);
+
+private:
+	void parseMessage(std::span<const char> message);
+
+	std::function<void(const std::string&)> callback;
+	std::string buffer; // incomplete message
+	std::string command;
+};
+
+#endif
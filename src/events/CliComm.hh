@@ -33,6 +33,7 @@ public:
 		SOUND_DEVICE,
 		CONNECTOR,
 		DEBUG_UPDT,
+		FRAME_HASH,
 		NUM // must be last
 	};
 
@@ -103,7 +104,7 @@ public:
 		static constexpr array_with_enum_index<UpdateType, std::string_view> updateStr = {
 			"led", "setting", "setting-info", "hardware", "plug",
 			"media", "status", "extension", "sounddevice", "connector",
-			"debug"
+			"debug", "framehash"
 		};
 		return std::span{updateStr};
 	}
@@ -10,20 +10,29 @@
 #include "Event.hh"
 #include "EventDistributor.hh"
 
-#include "CommandController.hh"
 #include "CommandException.hh"
+#include "Debuggable.hh"
+#include "Debugger.hh"
+#include "GlobalCommandController.hh"
+#include "MSXMotherBoard.hh"
+#include "PerfTrace.hh"
+#include "Reactor.hh"
 #include "TclObject.hh"
 #include "XMLEscape.hh"
 
 #include "TemporaryString.hh"
 #include "cstdiop.hh"
+#include "endian.hh"
 #include "ranges.hh"
 #include "unistdp.hh"
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cassert>
+#include <initializer_list>
 #include <iostream>
+#include <utility>
 
 #ifdef _WIN32
 #include "SocketStreamWrapper.hh"
@@ -34,21 +43,66 @@ namespace openmsx {
 
 using namespace std::literals;
 
+// Frames of the binary protocol (from openMSX to the client):
+//   uint8  frame type
+//   uint32 (little endian) size of the payload, followed by the payload
+// The payload consists of several fields, separated by a zero byte.
+enum class Frame : uint8_t {
+	REPLY_OK  = 0, // result
+	REPLY_NOK = 1, // error message
+	LOG       = 2, // level, message
+	UPDATE    = 3, // type, machine, name, value
+	STREAM    = 4, // machine, debuggable, raw data
+};
+
+// Append the frame header and the fields, except for the last 'rawSize' bytes
+// of the payload, those must be appended by the caller.
+static void appendFrame(std::string& out, Frame type,
+                        std::initializer_list<std::string_view> fields, size_t rawSize = 0)
+{
+	size_t size = rawSize;
+	for (auto f : fields) size += f.size() + 1; // including separator
+	if (rawSize == 0 && size != 0) --size; // no separator after the last field
+
+	std::array<char, 5> header;
+	header[0] = char(type);
+	Endian::write_UA_L32(&header[1], narrow<uint32_t>(size));
+	out.append(header.data(), header.size());
+	bool first = true;
+	for (auto f : fields) {
+		if (!first) out += '\0';
+		first = false;
+		out.append(f);
+	}
+	if (rawSize != 0) out += '\0';
+}
+
+[[nodiscard]] static std::string frame(Frame type, std::initializer_list<std::string_view> fields)
+{
+	std::string result;
+	appendFrame(result, type, fields);
+	return result;
+}
+
+
 // class CliConnection
 
-CliConnection::CliConnection(CommandController& commandController_,
+CliConnection::CliConnection(GlobalCommandController& commandController_,
                              EventDistributor& eventDistributor_)
-	: parser([this](const std::string& cmd) { execute(cmd); })
-	, commandController(commandController_)
+	: commandController(commandController_)
 	, eventDistributor(eventDistributor_)
+	, parser([this](const std::string& cmd) { execute(cmd); })
+	, binaryParser([this](const std::string& cmd) { execute(cmd); })
 {
 	std::ranges::fill(updateEnabled, false);
 
 	eventDistributor.registerEventListener(EventType::CLICOMMAND, *this);
+	eventDistributor.registerEventListener(EventType::FINISH_FRAME, *this);
 }
 
 CliConnection::~CliConnection()
 {
+	eventDistributor.unregisterEventListener(EventType::FINISH_FRAME, *this);
 	eventDistributor.unregisterEventListener(EventType::CLICOMMAND, *this);
 }
 
@@ -58,6 +112,10 @@ void CliConnection::log(CliComm::LogLevel level, std::string_view message, float
 	if (level == CliComm::LogLevel::PROGRESS && fraction >= 0.0f) {
 		strAppend(fullMessage, "... ", int(100.0f * fraction), '%');
 	}
+	if (binaryOutput) {
+		output(frame(Frame::LOG, {toString(level), fullMessage}));
+		return;
+	}
 	output(tmpStrCat("<log level=\"", toString(level), "\">",
 	                 XMLEscape(fullMessage), "</log>\n"));
 }
@@ -67,6 +125,10 @@ void CliConnection::update(CliComm::UpdateType type, std::string_view machine,
 {
 	if (!getUpdateEnable(type)) return;
 
+	if (binaryOutput) {
+		output(frame(Frame::UPDATE, {toString(type), machine, name, value}));
+		return;
+	}
 	auto tmp = tmpStrCat(
 		"<update type=\"", toString(type), '\"',
 		strCat_if(!machine.empty(), " machine=\"", machine, '"'),
@@ -82,12 +144,25 @@ void CliConnection::startOutput()
 
 void CliConnection::start()
 {
-	thread = std::thread([this]() { run(); });
+	thread = std::thread([this]() {
+		PerfTrace::setThreadName("cli connection");
+		run();
+	});
+}
+
+void CliConnection::parse(std::span<const char> buf)
+{
+	PerfTrace::Span trace("cli", "parse");
+	if (binaryInput) {
+		binaryParser.parse(buf);
+	} else {
+		parser.parse(buf);
+	}
 }
 
 void CliConnection::end()
 {
-	output("</openmsx-output>\n");
+	if (!binaryOutput) output("</openmsx-output>\n");
 	close();
 
 	poller.abort();
@@ -99,28 +174,129 @@ void CliConnection::end()
 
 void CliConnection::execute(const std::string& command)
 {
-	eventDistributor.distributeEvent(CliCommandEvent(command, this));
+	// Runs in the helper thread. Commands are queued, only the first one
+	// of a batch triggers an event. So all commands that arrive before
+	// the main thread handles that event are executed together.
+	bool wasEmpty;
+	{
+		std::scoped_lock lock(commandMutex);
+		wasEmpty = pendingCommands.empty();
+		pendingCommands.push_back(command);
+	}
+	if (wasEmpty) {
+		eventDistributor.distributeEvent(CliCommandEvent(this));
+	}
 }
 
-static TemporaryString reply(std::string_view message, bool status)
+void CliConnection::appendReply(std::string_view message, bool status)
 {
-	return tmpStrCat("<reply result=\"", (status ? "ok"sv : "nok"sv), "\">",
-	                 XMLEscape(message), "</reply>\n");
+	if (binaryOutput) {
+		appendFrame(replyBuffer, status ? Frame::REPLY_OK : Frame::REPLY_NOK,
+		            {tmpStrCat(nextCommandId++), message});
+	} else {
+		strAppend(replyBuffer, "<reply result=\"", (status ? "ok"sv : "nok"sv), "\">",
+		          XMLEscape(message), "</reply>\n");
+	}
 }
 
-bool CliConnection::signalEvent(const Event& event)
+void CliConnection::executePending()
 {
-	assert(getType(event) == EventType::CLICOMMAND);
-	if (const auto& commandEvent = get_event<CliCommandEvent>(event);
-	    commandEvent.getId() == this) {
+	{
+		std::scoped_lock lock(commandMutex);
+		std::swap(pendingCommands, executingCommands);
+	}
+	PerfTrace::Span trace("cli", "execute");
+	// Collect all replies, and send them at once.
+	replyBuffer.clear();
+	for (const auto& command : executingCommands) {
 		try {
-			auto result = commandController.executeCommand(
-				commandEvent.getCommand(), this).getString();
-			output(reply(result, true));
+			auto result = commandController.executeCommand(command, this).getString();
+			bool switching = std::exchange(switchToBinary, false);
+			// Switch the input before sending the reply: the client
+			// may send binary messages as soon as it receives it.
+			if (switching) binaryInput = true;
+			appendReply(result, true);
+			if (switching) binaryOutput = true;
 		} catch (CommandException& e) {
+			switchToBinary = false;
 			std::string result = std::move(e).getMessage() + '\n';
-			output(reply(result, false));
+			appendReply(result, false);
+		}
+	}
+	executingCommands.clear();
+	output(replyBuffer);
+}
+
+void CliConnection::subscribeStream(std::string_view debuggable, unsigned interval)
+{
+	assert(interval > 0);
+	if (auto it = std::ranges::find(streams, debuggable, &StreamSubscription::debuggable);
+	    it != streams.end()) {
+		it->interval = interval;
+		it->countdown = std::min(it->countdown, interval);
+	} else {
+		streams.push_back(StreamSubscription{
+			.debuggable = std::string(debuggable),
+			.interval = interval,
+			.countdown = interval});
+	}
+}
+
+bool CliConnection::unsubscribeStream(std::string_view debuggable)
+{
+	auto it = std::ranges::find(streams, debuggable, &StreamSubscription::debuggable);
+	if (it == streams.end()) return false;
+	streams.erase(it);
+	return true;
+}
+
+void CliConnection::sendStream(const StreamSubscription& subscription)
+{
+	auto* motherBoard = commandController.getReactor().getMotherBoard();
+	if (!motherBoard) return;
+	auto* debuggable = motherBoard->getDebugger().findDebuggable(subscription.debuggable);
+	if (!debuggable) return; // e.g. not present in this machine
+
+	// Send the raw content, without any escaping. The 'size' attribute
+	// tells the client how many bytes follow the opening tag.
+	auto size = debuggable->getSize();
+	if (binaryOutput) {
+		appendFrame(streamBuffer, Frame::STREAM,
+		            {motherBoard->getMachineID(), subscription.debuggable}, size);
+	} else {
+		strAppend(streamBuffer,
+		          "<stream machine=\"", motherBoard->getMachineID(),
+		          "\" name=\"", XMLEscape(subscription.debuggable),
+		          "\" size=\"", size, "\">");
+	}
+	auto headerSize = streamBuffer.size();
+	streamBuffer.resize(headerSize + size);
+	debuggable->readBlock(0, std::span{std::bit_cast<uint8_t*>(streamBuffer.data() + headerSize), size});
+	if (!binaryOutput) streamBuffer += "</stream>\n";
+}
+
+bool CliConnection::signalEvent(const Event& event)
+{
+	if (getType(event) == EventType::FINISH_FRAME) {
+		// Only count the frames of the selected video source (there's
+		// one event per video source).
+		if (const auto& frameEvent = get_event<FinishFrameEvent>(event);
+		    frameEvent.getSource() == frameEvent.getSelectedSource()) {
+			// Send all streams of this frame at once.
+			streamBuffer.clear();
+			for (auto& subscription : streams) {
+				if (--subscription.countdown == 0) {
+					subscription.countdown = subscription.interval;
+					sendStream(subscription);
+				}
+			}
+			if (!streamBuffer.empty()) output(streamBuffer);
 		}
+		return false;
+	}
+	assert(getType(event) == EventType::CLICOMMAND);
+	if (get_event<CliCommandEvent>(event).getId() == this) {
+		executePending();
 	}
 	return false;
 }
@@ -129,7 +305,7 @@ bool CliConnection::signalEvent(const Event& event)
 // class StdioConnection
 
 static constexpr int BUF_SIZE = 4096;
-StdioConnection::StdioConnection(CommandController& commandController_,
+StdioConnection::StdioConnection(GlobalCommandController& commandController_,
                                  EventDistributor& eventDistributor_)
 	: CliConnection(commandController_, eventDistributor_)
 {
@@ -153,7 +329,7 @@ void StdioConnection::run()
 		std::array<char, BUF_SIZE> buf;
 		auto n = read(STDIN_FILENO, buf.data(), sizeof(buf));
 		if (n > 0) {
-			parser.parse(subspan(buf, 0, n));
+			parse(subspan(buf, 0, n));
 		} else if (n < 0) {
 			break;
 		}
@@ -178,7 +354,7 @@ void StdioConnection::close()
 // but that gives a old-style-cast warning
 static const HANDLE OPENMSX_INVALID_HANDLE_VALUE = reinterpret_cast<HANDLE>(-1);
 
-PipeConnection::PipeConnection(CommandController& commandController_,
+PipeConnection::PipeConnection(GlobalCommandController& commandController_,
                                EventDistributor& eventDistributor_,
                                std::string_view name)
 	: CliConnection(commandController_, eventDistributor_)
@@ -243,7 +419,7 @@ void PipeConnection::run()
 			if (!GetOverlappedResult(pipeHandle, &overlapped, &bytesRead, TRUE)) {
 				break; // Pipe broke
 			}
-			parser.parse(std::span{buf, bytesRead});
+			parse(std::span{buf, bytesRead});
 		} else if (wait == WAIT_OBJECT_0) {
 			break; // Shutdown
 		} else {
@@ -275,7 +451,7 @@ void PipeConnection::close()
 
 // class SocketConnection
 
-SocketConnection::SocketConnection(CommandController& commandController_,
+SocketConnection::SocketConnection(GlobalCommandController& commandController_,
                                    EventDistributor& eventDistributor_,
                                    SOCKET sd_)
 	: CliConnection(commandController_, eventDistributor_)
@@ -322,7 +498,7 @@ void SocketConnection::run()
 		std::array<char, BUF_SIZE> buf;
 		auto n = sock_recv(sd, buf.data(), sizeof(buf));
 		if (n > 0) {
-			parser.parse(subspan(buf, 0, n));
+			parse(subspan(buf, 0, n));
 		} else if (n < 0) {
 			break;
 		}
@@ -2,6 +2,7 @@
 #define CLICONNECTION_HH
 
 #include "AdhocCliCommParser.hh"
+#include "BinaryCliCommParser.hh"
 #include "CliComm.hh"
 #include "CliListener.hh"
 #include "EventListener.hh"
@@ -10,14 +11,19 @@
 #include "Poller.hh"
 #include "stl.hh"
 
+#include <atomic>
+#include <cstdint>
 #include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
 
 namespace openmsx {
 
-class CommandController;
 class EventDistributor;
+class GlobalCommandController;
 
 class CliConnection : public CliListener, private EventListener
 {
@@ -29,6 +35,32 @@ public:
 		return updateEnabled[type];
 	}
 
+	/** Periodically send the content of a debuggable (of the active
+	  * machine) over this connection, see doc/manual/openmsx-control.html.
+	  * Subscribing again to the same debuggable only changes the interval.
+	  * These methods (and the streaming itself) run in the main thread.
+	  * @param debuggable Name of the debuggable.
+	  * @param interval Send once every 'interval' frames (must be > 0).
+	  */
+	void subscribeStream(std::string_view debuggable, unsigned interval);
+	/** Returns false if there was no subscription for this debuggable. */
+	bool unsubscribeStream(std::string_view debuggable);
+
+	struct StreamSubscription {
+		std::string debuggable;
+		unsigned interval;  // in frames
+		unsigned countdown; // frames until the next transfer
+	};
+	[[nodiscard]] std::span<const StreamSubscription> getStreams() const {
+		return streams;
+	}
+
+	/** Switch both directions of this connection to the binary protocol,
+	  * see doc/manual/openmsx-control.html. Takes effect right after the
+	  * (still XML) reply to the current command.
+	  */
+	void switchToBinaryProtocol() { switchToBinary = true; }
+
 	/** Starts the helper thread.
 	  * Called when this CliConnection is added to GlobalCliComm (and
 	  * after it's allowed to respond to external commands).
@@ -37,7 +69,7 @@ public:
 	void start();
 
 protected:
-	CliConnection(CommandController& commandController,
+	CliConnection(GlobalCommandController& commandController,
 	              EventDistributor& eventDistributor);
 	~CliConnection() override;
 
@@ -61,13 +93,21 @@ protected:
 	  */
 	void startOutput();
 
-	AdhocCliCommParser parser;
+	/** Parse data received from the client (called from the helper
+	  * thread).
+	  */
+	void parse(std::span<const char> buf);
+
 	Poller poller;
 
 private:
 	virtual void run() = 0;
 
 	void execute(const std::string& command);
+	void executePending();
+	void appendReply(std::string_view message, bool status);
+	/** Appends to 'streamBuffer'. */
+	void sendStream(const StreamSubscription& subscription);
 
 	// CliListener
 	void log(CliComm::LogLevel level, std::string_view message, float fraction) noexcept override;
@@ -77,18 +117,33 @@ private:
 	// EventListener
 	bool signalEvent(const Event& event) override;
 
-	CommandController& commandController;
+	GlobalCommandController& commandController;
 	EventDistributor& eventDistributor;
 
 	std::thread thread;
 
+	AdhocCliCommParser parser;
+	BinaryCliCommParser binaryParser;
+	std::atomic<bool> binaryInput = false;
+	std::atomic<bool> binaryOutput = false;
+	bool switchToBinary = false; // set by the 'openmsx_protocol' command
+	uint32_t nextCommandId = 0; // binary protocol only
+
+	std::mutex commandMutex;
+	std::vector<std::string> pendingCommands; // protected by 'commandMutex'
+	std::vector<std::string> executingCommands; // main thread only
+	std::string replyBuffer; // reused to avoid allocations
+
 	array_with_enum_index<CliComm::UpdateType, bool> updateEnabled;
+
+	std::vector<StreamSubscription> streams;
+	std::string streamBuffer; // reused to avoid allocations
 };
 
 class StdioConnection final : public CliConnection
 {
 public:
-	StdioConnection(CommandController& commandController,
+	StdioConnection(GlobalCommandController& commandController,
 	                EventDistributor& eventDistributor);
 	~StdioConnection() override;
 
@@ -103,7 +158,7 @@ private:
 class PipeConnection final : public CliConnection
 {
 public:
-	PipeConnection(CommandController& commandController,
+	PipeConnection(GlobalCommandController& commandController,
 	               EventDistributor& eventDistributor,
 	               std::string_view name);
 	~PipeConnection() override;
@@ -122,7 +177,7 @@ private:
 class SocketConnection final : public CliConnection
 {
 public:
-	SocketConnection(CommandController& commandController,
+	SocketConnection(GlobalCommandController& commandController,
 	                 EventDistributor& eventDistributor,
 	                 SOCKET sd);
 	~SocketConnection() override;
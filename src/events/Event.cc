@@ -92,7 +92,7 @@ bool operator==(const Event& x, const Event& y)
 			       std::tuple(b.getSource(), b.getSelectedSource(), b.isSkipped());
 		},
 		[](const CliCommandEvent& a, const CliCommandEvent& b) {
-			return a.getCommand() == b.getCommand();
+			return a.getId() == b.getId();
 		},
 		[](const GroupEvent& a, const GroupEvent& b) {
 			return a.getTclListComponents() ==
@@ -193,8 +193,8 @@ TclObject toTclList(const Event& event)
 		[](const FinishFrameEvent& e) {
 			return makeTclList("finishframe", e.getSource(), e.getSelectedSource(), e.isSkipped());
 		},
-		[](const CliCommandEvent& e) {
-			return makeTclList("CliCmd", e.getCommand());
+		[](const CliCommandEvent& /*e*/) {
+			return makeTclList("CliCmd");
 		},
 		[](const GroupEvent& e) {
 			return e.getTclListComponents();
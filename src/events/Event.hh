@@ -332,22 +332,17 @@ private:
 };
 
 /** Command received on CliComm connection. */
+/** The given connection has received one or more commands (they're queued in
+  * the connection itself). */
 class CliCommandEvent final : public EventBase
 {
 public:
-	CliCommandEvent(std::string_view command_, const CliConnection* id_)
-		: command(allocate_c_string(command_)), id(id_) {}
-	CliCommandEvent(const CliCommandEvent&) { assert(false); }
-	CliCommandEvent& operator=(const CliCommandEvent&) { assert(false); return *this; }
-	CliCommandEvent(CliCommandEvent&&) = default;
-	CliCommandEvent& operator=(CliCommandEvent&&) = default;
-	~CliCommandEvent() = default;
-
-	[[nodiscard]] zstring_view getCommand() const { return command.get(); }
+	explicit CliCommandEvent(const CliConnection* id_)
+		: id(id_) {}
+
 	[[nodiscard]] const CliConnection* getId() const { return id; }
 
 private:
-	StringStorage command;
 	const CliConnection* id;
 };
 
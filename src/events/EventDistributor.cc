@@ -4,9 +4,11 @@
 #include "InputEventGenerator.hh"
 
 #include "Interpreter.hh"
+#include "PerfMonitor.hh"
 #include "RTScheduler.hh"
 #include "Reactor.hh"
 #include "Thread.hh"
+#include "Timer.hh"
 
 #include "stl.hh"
 
@@ -30,6 +32,7 @@ void EventDistributor::registerEventListener(
 	// insert at highest position that keeps listeners sorted on priority
 	auto it = std::ranges::upper_bound(priorityMap, priority, {}, &Entry::priority);
 	priorityMap.emplace(it, Entry{.priority = priority, .listener = &listener});
+	numListeners[size_t(type)] = unsigned(priorityMap.size());
 }
 
 void EventDistributor::unregisterEventListener(
@@ -38,25 +41,15 @@ void EventDistributor::unregisterEventListener(
 	std::scoped_lock lock(mutex);
 	auto& priorityMap = listeners[size_t(type)];
 	priorityMap.erase(rfind_unguarded(priorityMap, &listener, &Entry::listener));
+	numListeners[size_t(type)] = unsigned(priorityMap.size());
 }
 
 void EventDistributor::distributeEvent(Event&& event)
 {
-	// TODO: Implement a real solution against modifying data structure while
-	//       iterating through it.
-	//       For example, assign nullptr first and then iterate again after
-	//       delivering events to remove the nullptr values.
 	// TODO: Is it useful to test for 0 listeners or should we just always
 	//       queue the event?
-	std::unique_lock lock(mutex);
-	if (!listeners[size_t(getType(event))].empty()) {
-		scheduledEvents.push_back(std::move(event));
-		// must release lock, otherwise there's a deadlock:
-		//   thread 1: Reactor::deleteMotherBoard()
-		//             EventDistributor::unregisterEventListener()
-		//   thread 2: EventDistributor::distributeEvent()
-		//             Reactor::enterMainLoop()
-		lock.unlock();
+	if (numListeners[size_t(getType(event))] != 0) {
+		scheduledEvents.push(ScheduledEvent{std::move(event), Timer::getTime()});
 		reactor.enterMainLoop();
 	}
 }
@@ -74,10 +67,12 @@ void EventDistributor::deliverEvents(std::optional<int> timeoutMs)
 	assert(Thread::isMainThread());
 
 	reactor.getInputEventGenerator().poll(timeoutMs);
+
+	// not including the above poll(), that blocks while paused
+	PerfMonitor::Scope perf(PerfMonitor::Section::EVENTS);
 	reactor.getInterpreter().poll();
 	reactor.getRTScheduler().execute();
 
-	std::unique_lock lock(mutex);
 	// It's possible that executing an event triggers scheduling of another
 	// event. We also want to execute those secondary events. That's why
 	// we have this while loop here.
@@ -87,11 +82,18 @@ void EventDistributor::deliverEvents(std::optional<int> timeoutMs)
 	// done before we exit this method.
 	while (!scheduledEvents.empty()) {
 		assert(eventsCopy.empty());
-		swap(eventsCopy, scheduledEvents);
-		for (const auto& event : eventsCopy) {
+		scheduledEvents.popAll(eventsCopy);
+		for (const auto& [event, postTime] : eventsCopy) {
+			auto latency = Timer::getTime() - postTime;
+			++latencyStats.count;
+			latencyStats.total += latency;
+			latencyStats.max = std::max(latencyStats.max, latency);
+
 			auto type = getType(event);
-			priorityMapCopy = listeners[size_t(type)];
-			lock.unlock();
+			{
+				std::scoped_lock lock(mutex);
+				priorityMapCopy = listeners[size_t(type)];
+			}
 			auto allowPriority = Priority::LOWEST; // allow all
 			for (const auto& e : priorityMapCopy) {
 				// It's possible delivery to one of the previous
@@ -105,7 +107,6 @@ void EventDistributor::deliverEvents(std::optional<int> timeoutMs)
 					allowPriority = e.priority;
 				}
 			}
-			lock.lock();
 		}
 		eventsCopy.clear();
 	}
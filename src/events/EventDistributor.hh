@@ -3,7 +3,10 @@
 
 #include "Event.hh"
 
+#include "MPSCQueue.hh"
+
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <mutex>
 #include <optional>
@@ -53,6 +56,7 @@ public:
 	/** Schedule the given event for delivery. Actual delivery happens
 	  * when the deliverEvents() method is called. Events are always
 	  * in the main thread.
+	  * This can be called from any thread, it doesn't take a lock.
 	  */
 	void distributeEvent(Event&& event);
 
@@ -65,6 +69,16 @@ public:
 	  */
 	void deliverEvents(std::optional<int> timeoutMs = std::nullopt);
 
+	/** Time between distributeEvent() and the start of the delivery of
+	  * that event, measured over all events since startup.
+	  */
+	struct LatencyStats {
+		uint64_t count = 0;
+		uint64_t total = 0; // in us
+		uint64_t max = 0;   // in us
+	};
+	[[nodiscard]] const LatencyStats& getLatencyStats() const { return latencyStats; }
+
 private:
 	[[nodiscard]] bool isRegistered(EventType type, EventListener* listener) const;
 
@@ -77,9 +91,18 @@ private:
 	};
 	using PriorityMap = std::vector<Entry>; // sorted on priority
 	std::array<PriorityMap, size_t(EventType::NUM_EVENT_TYPES)> listeners;
-	using EventQueue = std::vector<Event>;
-	EventQueue scheduledEvents;
-	std::mutex mutex; // lock data structures
+	// Copy of 'listeners[type].size()' that can be read without taking
+	// the lock (from any thread).
+	std::array<std::atomic<unsigned>, size_t(EventType::NUM_EVENT_TYPES)> numListeners = {};
+	std::mutex mutex; // lock 'listeners'
+
+	struct ScheduledEvent {
+		Event event;
+		uint64_t postTime; // see Timer::getTime()
+	};
+	using EventQueue = std::vector<ScheduledEvent>;
+	MPSCQueue<ScheduledEvent> scheduledEvents;
+	LatencyStats latencyStats;
 };
 
 } // namespace openmsx
@@ -61,6 +61,18 @@ void sock_close(SOCKET sd)
 #endif
 }
 
+// Stop both sending and receiving. Unlike sock_close() this doesn't release
+// the descriptor, so it's safe while another thread still uses it (a
+// blocking recv() in that thread returns).
+void sock_shutdown(SOCKET sd)
+{
+#ifdef _WIN32
+	shutdown(sd, SD_BOTH);
+#else
+	shutdown(sd, SHUT_RDWR);
+#endif
+}
+
 
 ptrdiff_t sock_recv(SOCKET sd, char* buf, size_t count)
 {
@@ -33,6 +33,7 @@ using in_addr_t =  UINT32;
 
 [[nodiscard]] std::string sock_error();
 void sock_close(SOCKET sd);
+void sock_shutdown(SOCKET sd);
 [[nodiscard]] ptrdiff_t sock_recv(SOCKET sd, char* buf, size_t count);
 [[nodiscard]] ptrdiff_t sock_send(SOCKET sd, const char* buf, size_t count);
 
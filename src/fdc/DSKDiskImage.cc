@@ -1,16 +1,38 @@
 #include "DSKDiskImage.hh"
 
 #include "File.hh"
+#include "FileException.hh"
+#include "MSXException.hh"
 #include "Filename.hh"
 #include "FilePool.hh"
+#include "Timer.hh"
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace openmsx {
 
+// Sector writes are buffered and written back to the file in runs of
+// consecutive sectors. This avoids a seek+write system call pair for each
+// sector when MSX software writes a lot (e.g. copying files). The buffer is
+// written back when it gets too big or when the oldest buffered write is
+// older than FLUSH_INTERVAL (checked on each access of this disk). That
+// write-back happens in a background thread (via a separate file handle),
+// so that slow storage doesn't stall the emulation. Until it's finished,
+// reads take those sectors from 'writing'. flushWrites() (on eject, before
+// making a savestate and on exit) waits for the background write and
+// writes the remaining sectors synchronously.
+static constexpr size_t MAX_DIRTY_SECTORS = 64; // 32kB
+static constexpr uint64_t FLUSH_INTERVAL = 1'000'000; // in us
+
 DSKDiskImage::DSKDiskImage(const Filename& fileName)
 	: SectorBasedDisk(DiskName(fileName))
 	, file(std::make_shared<File>(fileName.getResolved(), File::OpenMode::PRE_CACHE))
 {
 	setNbSectors(file->getSize() / sizeof(SectorBuffer));
+	enableReadAhead();
 }
 
 DSKDiskImage::DSKDiskImage(const Filename& fileName,
@@ -19,19 +41,111 @@ DSKDiskImage::DSKDiskImage(const Filename& fileName,
 	, file(std::move(file_))
 {
 	setNbSectors(file->getSize() / sizeof(SectorBuffer));
+	enableReadAhead();
+}
+
+DSKDiskImage::~DSKDiskImage()
+{
+	try {
+		flushWrites();
+	} catch (MSXException&) {
+		// Nothing we can do here. Normally the owner already called
+		// flushWrites() (and reported the error).
+	}
 }
 
 void DSKDiskImage::readSectorsImpl(
 	std::span<SectorBuffer> buffers, size_t startSector)
 {
+	if (flushing.valid() &&
+	    (flushing.wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+		finishFlush();
+	}
+	flushWritesIfDue();
 	file->seek(startSector * sizeof(SectorBuffer));
 	file->read(buffers);
+	auto overlay = [&](const std::map<size_t, SectorBuffer>& sectors) {
+		for (auto it = sectors.lower_bound(startSector);
+		     (it != sectors.end()) && (it->first < (startSector + buffers.size()));
+		     ++it) {
+			buffers[it->first - startSector] = it->second;
+		}
+	};
+	overlay(writing);
+	overlay(dirty); // more recent than 'writing'
 }
 
 void DSKDiskImage::writeSectorImpl(size_t sector, const SectorBuffer& buf)
 {
-	file->seek(sector * sizeof(buf));
-	file->write(buf.raw);
+	if (dirty.empty()) firstDirtyTime = Timer::getTime();
+	dirty.insert_or_assign(sector, buf);
+	if (dirty.size() >= MAX_DIRTY_SECTORS) {
+		startFlush();
+	} else {
+		flushWritesIfDue();
+	}
+}
+
+void DSKDiskImage::flushWritesIfDue()
+{
+	if (!dirty.empty() && ((Timer::getTime() - firstDirtyTime) >= FLUSH_INTERVAL)) {
+		startFlush();
+	}
+}
+
+using Runs = std::vector<std::pair<size_t, std::vector<SectorBuffer>>>;
+[[nodiscard]] static Runs collectRuns(const std::map<size_t, SectorBuffer>& sectors)
+{
+	Runs runs;
+	for (const auto& [sector, buf] : sectors) {
+		if (runs.empty() || ((runs.back().first + runs.back().second.size()) != sector)) {
+			runs.emplace_back(sector, std::vector<SectorBuffer>{});
+		}
+		runs.back().second.push_back(buf);
+	}
+	return runs;
+}
+
+void DSKDiskImage::startFlush()
+{
+	finishFlush(); // at most one background write at a time
+	writing = std::move(dirty);
+	dirty.clear();
+	flushing = std::async(std::launch::async,
+		[name = std::string(getName().getResolved()), runs = collectRuns(writing)] {
+			try {
+				File f(name);
+				for (const auto& [first, run] : runs) {
+					f.seek(first * sizeof(SectorBuffer));
+					f.write(std::span{run});
+				}
+				return true;
+			} catch (FileException&) {
+				return false;
+			}
+		});
+}
+
+void DSKDiskImage::finishFlush()
+{
+	if (!flushing.valid()) return;
+	if (!flushing.get()) {
+		// Keep the sectors, they're retried in the next write-back
+		// (flushWrites() reports the error when that fails again).
+		dirty.merge(writing); // on duplicates 'dirty' has the newest data
+		if (!dirty.empty()) firstDirtyTime = Timer::getTime();
+	}
+	writing.clear();
+}
+
+void DSKDiskImage::flushWrites()
+{
+	finishFlush();
+	for (const auto& [first, run] : collectRuns(dirty)) {
+		file->seek(first * sizeof(SectorBuffer));
+		file->write(std::span{run});
+	}
+	dirty.clear();
 }
 
 bool DSKDiskImage::isWriteProtectedImpl() const
@@ -41,6 +155,7 @@ bool DSKDiskImage::isWriteProtectedImpl() const
 
 Sha1Sum DSKDiskImage::getSha1SumImpl(FilePool& filePool)
 {
+	flushWrites(); // the sum is calculated on the file content
 	if (hasPatches()) {
 		return SectorAccessibleDisk::getSha1SumImpl(filePool);
 	}
@@ -2,6 +2,10 @@
 #define DSKDISKIMAGE_HH
 
 #include "SectorBasedDisk.hh"
+
+#include <cstdint>
+#include <future>
+#include <map>
 #include <memory>
 
 namespace openmsx {
@@ -13,6 +17,9 @@ class DSKDiskImage final : public SectorBasedDisk
 public:
 	explicit DSKDiskImage(const Filename& filename);
 	DSKDiskImage(const Filename& filename, std::shared_ptr<File> file);
+	~DSKDiskImage() override;
+
+	void flushWrites() override;
 
 private:
 	void readSectorsImpl(
@@ -21,8 +28,20 @@ private:
 	[[nodiscard]] bool isWriteProtectedImpl() const override;
 	[[nodiscard]] Sha1Sum getSha1SumImpl(FilePool& filePool) override;
 
+	void flushWritesIfDue();
+	void startFlush();
+	void finishFlush();
+
 private:
 	const std::shared_ptr<File> file;
+
+	// Written sectors that are not yet written to 'file' (see .cc).
+	std::map<size_t, SectorBuffer> dirty;
+	uint64_t firstDirtyTime = 0; // Timer::getTime() of the oldest entry
+
+	// Sectors that are being written by the background task 'flushing'.
+	std::map<size_t, SectorBuffer> writing;
+	std::future<bool> flushing; // result: success?
 };
 
 } // namespace openmsx
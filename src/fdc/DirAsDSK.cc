@@ -273,6 +273,7 @@ DirAsDSK::DirAsDSK(DiskChanger& diskChanger_, CliComm& cliComm_,
 	, cliComm(cliComm_)
 	, hostDir(FileOperations::expandTilde(hostDir_.getResolved() + '/'))
 	, syncMode(syncMode_)
+	, dirWatcher(hostDir)
 	, nofSectors((diskChanger_.isDoubleSidedDrive() ? 2 : 1) * SECTORS_PER_TRACK * NUM_TRACKS)
 	, nofSectorsPerFat(narrow<unsigned>((((3 * nofSectors) / (2 * SECTORS_PER_CLUSTER)) + SECTOR_SIZE - 1) / SECTOR_SIZE))
 	, firstSector2ndFAT(FIRST_FAT_SECTOR + nofSectorsPerFat)
@@ -333,6 +334,7 @@ DirAsDSK::DirAsDSK(DiskChanger& diskChanger_, CliComm& cliComm_,
 	assert(mapDirs.empty());
 
 	// Import the host filesystem.
+	dirWatcher.clearChanges();
 	syncWithHost();
 }
 
@@ -365,7 +367,7 @@ void DirAsDSK::checkCaches()
 			return true;
 		}
 	}();
-	if (needSync) {
+	if (needSync && dirWatcher.hasChanges()) {
 		flushCaches();
 	}
 }
@@ -390,7 +392,10 @@ void DirAsDSK::readSectorImpl(size_t sector, SectorBuffer& buf)
 				return true;
 			}
 		}();
-		if (needSync) {
+		if (needSync && dirWatcher.hasChanges()) {
+			// Clear before syncing, so changes made during the
+			// sync are picked up next time.
+			dirWatcher.clearChanges();
 			syncWithHost();
 			flushCaches(); // e.g. sha1sum
 			// Let the disk drive report the disk has been ejected.
@@ -1,6 +1,7 @@
 #ifndef DIRASDSK_HH
 #define DIRASDSK_HH
 
+#include "DirWatcher.hh"
 #include "DiskImageUtils.hh"
 #include "EmuTime.hh"
 #include "FileOperations.hh"
@@ -131,6 +132,7 @@ private:
 	CliComm& cliComm; // TODO don't use CliComm to report errors/warnings
 	const std::string hostDir;
 	const SyncMode syncMode;
+	DirWatcher dirWatcher; // to skip syncWithHost() when nothing changed
 
 	EmuTime lastAccess = EmuTime::zero(); // last time there was a sector read/write
 
@@ -80,6 +80,7 @@ void DiskChanger::createCommand()
 
 DiskChanger::~DiskChanger()
 {
+	flushDisk();
 	if (stateChangeDistributor) {
 		stateChangeDistributor->unregisterListener(*this);
 	}
@@ -177,9 +178,21 @@ void DiskChanger::ejectDisk()
 	changeDisk(std::make_unique<DummyDisk>());
 }
 
+void DiskChanger::flushDisk()
+{
+	try {
+		disk->flushWrites();
+	} catch (MSXException& e) {
+		controller.getCliComm().printWarning(
+			"Failed to write changes to disk image ",
+			getDiskName().getResolved(), ": ", e.getMessage());
+	}
+}
+
 void DiskChanger::changeDisk(std::unique_ptr<Disk> newDisk)
 {
 	if (preChangeCallback) preChangeCallback();
+	if (disk) flushDisk();
 	disk = std::move(newDisk);
 	diskChangedFlag = true;
 	controller.getCliComm().update(CliComm::UpdateType::MEDIA, getDriveName(),
@@ -324,6 +337,7 @@ void DiskChanger::serialize(Archive& ar, unsigned version)
 	auto& filePool = reactor.getFilePool();
 	Sha1Sum oldChecksum{Sha1Sum::UninitializedTag{}};
 	if constexpr (!Archive::IS_LOADER) {
+		flushDisk();
 		oldChecksum = calcSha1(getSectorAccessibleDisk(), filePool);
 	}
 	ar.serialize("checksum", oldChecksum);
@@ -81,6 +81,7 @@ private:
 	void execute(std::span<const TclObject> tokens);
 	void insertDisk(std::span<const TclObject> args);
 	void ejectDisk();
+	void flushDisk();
 	void sendChangeDiskEvent(std::span<const TclObject> args);
 
 	// StateChangeListener
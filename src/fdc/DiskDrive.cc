@@ -101,6 +101,11 @@ bool DummyDrive::isDummyDrive() const
 	return true;
 }
 
+bool DummyDrive::isTurbo() const
+{
+	return false;
+}
+
 void DummyDrive::applyWd2793ReadTrackQuirk()
 {
 	// nothing
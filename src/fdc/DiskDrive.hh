@@ -95,6 +95,13 @@ public:
 	 */
 	[[nodiscard]] virtual bool isDummyDrive() const = 0;
 
+	/** Is the 'turbo_disk' setting active? The drive itself then rotates
+	  * faster, the FDC should use TURBO_DELAY instead of its head step
+	  * and head load/settle delays.
+	  */
+	[[nodiscard]] virtual bool isTurbo() const = 0;
+	static constexpr auto TURBO_DELAY = EmuDuration::usec(100);
+
 	/** See RawTrack::applyWd2793ReadTrackQuirk() */
 	virtual void applyWd2793ReadTrackQuirk() = 0;
 	virtual void invalidateWd2793ReadTrackQuirk() = 0;
@@ -126,6 +133,7 @@ public:
 	bool diskChanged() override;
 	[[nodiscard]] bool peekDiskChanged() const override;
 	[[nodiscard]] bool isDummyDrive() const override;
+	[[nodiscard]] bool isTurbo() const override;
 	void applyWd2793ReadTrackQuirk() override;
 	void invalidateWd2793ReadTrackQuirk() override;
 };
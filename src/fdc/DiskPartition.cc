@@ -49,9 +49,11 @@ DiskPartition::DiskPartition(SectorAccessibleDisk& parent_,
 	setNbSectors(length);
 }
 
-void DiskPartition::readSectorImpl(size_t sector, SectorBuffer& buf)
+void DiskPartition::readSectorsImpl(
+	std::span<SectorBuffer> buffers, size_t startSector)
 {
-	parent.readSector(start + sector, buf);
+	// forward the whole range, so the parent can read it in one go
+	parent.readSectors(buffers, start + startSector);
 }
 
 void DiskPartition::writeSectorImpl(size_t sector, const SectorBuffer& buf)
@@ -59,6 +61,11 @@ void DiskPartition::writeSectorImpl(size_t sector, const SectorBuffer& buf)
 	parent.writeSector(start + sector, buf);
 }
 
+void DiskPartition::flushWrites()
+{
+	parent.flushWrites();
+}
+
 bool DiskPartition::isWriteProtectedImpl() const
 {
 	return parent.isWriteProtected();
@@ -24,8 +24,11 @@ public:
 	DiskPartition(SectorAccessibleDisk& parent,
 	              size_t start, size_t length);
 
+	void flushWrites() override;
+
 private:
-	void readSectorImpl (size_t sector,       SectorBuffer& buf) override;
+	void readSectorsImpl(
+		std::span<SectorBuffer> buffers, size_t startSector) override;
 	void writeSectorImpl(size_t sector, const SectorBuffer& buf) override;
 	[[nodiscard]] bool isWriteProtectedImpl() const override;
 
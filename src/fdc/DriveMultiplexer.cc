@@ -135,6 +135,11 @@ bool DriveMultiplexer::isDummyDrive() const
 	return drive[selected]->isDummyDrive();
 }
 
+bool DriveMultiplexer::isTurbo() const
+{
+	return drive[selected]->isTurbo();
+}
+
 void DriveMultiplexer::applyWd2793ReadTrackQuirk()
 {
 	drive[selected]->applyWd2793ReadTrackQuirk();
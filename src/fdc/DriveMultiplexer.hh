@@ -49,6 +49,7 @@ public:
 	bool diskChanged() override;
 	[[nodiscard]] bool peekDiskChanged() const override;
 	[[nodiscard]] bool isDummyDrive() const override;
+	[[nodiscard]] bool isTurbo() const override;
 	void applyWd2793ReadTrackQuirk() override;
 	void invalidateWd2793ReadTrackQuirk() override;
 
@@ -171,6 +171,11 @@ void MSXtar::writeLogicalSector(unsigned sector, const SectorBuffer& buf)
 		//   --> update cache
 		fatBuffer[fatSector] = buf;
 		fatCacheDirty = true;
+	} else if (auto it = dirCache.find(sector); it != dirCache.end()) {
+		// a (former) directory sector, e.g. the cluster of a deleted
+		// subdir got reused for file data --> keep the cache coherent
+		it->second.buf = buf;
+		it->second.dirty = true;
 	} else {
 		disk.writeSector(sector, buf);
 	}
@@ -184,11 +189,60 @@ void MSXtar::readLogicalSector(unsigned sector, SectorBuffer& buf)
 		// we have a cache and this is a sector of the 1st FAT
 		//   --> read from cache
 		buf = fatBuffer[fatSector];
+	} else if (auto it = dirCache.find(sector); it != dirCache.end()) {
+		buf = it->second.buf;
 	} else {
 		disk.readSector(sector, buf);
 	}
 }
 
+// Directory sectors are read and rewritten over and over while importing
+// many files (each new entry rescans the directory), so keep them in memory
+// and only write them back (together with the FAT) in the destructor.
+void MSXtar::writeDirSector(unsigned sector, const SectorBuffer& buf)
+{
+	assert(sector - fatStart >= sectorsPerFat);
+	auto& cached = dirCache[sector];
+	cached.buf = buf;
+	cached.dirty = true;
+}
+
+void MSXtar::readDirSector(unsigned sector, SectorBuffer& buf)
+{
+	if (auto it = dirCache.find(sector); it != dirCache.end()) {
+		buf = it->second.buf;
+	} else {
+		readLogicalSector(sector, buf);
+		dirCache.try_emplace(sector, CachedSector{buf, false});
+	}
+}
+
+void MSXtar::flushCaches() noexcept
+{
+	// write back in ascending sector order
+	for (auto& [sector, cached] : dirCache) {
+		if (!cached.dirty) continue;
+		try {
+			disk.writeSector(sector, cached.buf);
+			cached.dirty = false;
+		} catch (MSXException&) {
+			// nothing
+		}
+	}
+
+	if (!fatCacheDirty) return;
+	for (auto fat : xrange(fatCount)) {
+		for (auto i : xrange(sectorsPerFat)) {
+			try {
+				disk.writeSector(i + fatStart + fat * sectorsPerFat, fatBuffer[i]);
+			} catch (MSXException&) {
+				// nothing
+			}
+		}
+	}
+	fatCacheDirty = false;
+}
+
 MSXtar::MSXtar(SectorAccessibleDisk& sectorDisk, const MsxChar2Unicode& msxChars_)
 	: disk(sectorDisk)
 	, msxChars(msxChars_)
@@ -214,6 +268,7 @@ MSXtar::MSXtar(SectorAccessibleDisk& sectorDisk, const MsxChar2Unicode& msxChars
 MSXtar::MSXtar(MSXtar&& other) noexcept
 	: disk(other.disk)
 	, fatBuffer(std::move(other.fatBuffer))
+	, dirCache(std::move(other.dirCache))
 	, msxChars(other.msxChars)
 	, findFirstFreeClusterStart(other.findFirstFreeClusterStart)
 	, clusterCount(other.clusterCount)
@@ -227,21 +282,12 @@ MSXtar::MSXtar(MSXtar&& other) noexcept
 	, fatCacheDirty(other.fatCacheDirty)
 {
 	other.fatCacheDirty = false;
+	other.dirCache.clear();
 }
 
 MSXtar::~MSXtar()
 {
-	if (!fatCacheDirty) return;
-
-	for (auto fat : xrange(fatCount)) {
-		for (auto i : xrange(sectorsPerFat)) {
-			try {
-				disk.writeSector(i + fatStart + fat * sectorsPerFat, fatBuffer[i]);
-			} catch (MSXException&) {
-				// nothing
-			}
-		}
-	}
+	flushCaches();
 }
 
 // Get the next cluster number from the FAT chain
@@ -398,7 +444,7 @@ unsigned MSXtar::appendClusterToSubdir(unsigned sector)
 	SectorBuffer buf;
 	std::ranges::fill(buf.raw, 0);
 	for (auto i : xrange(sectorsPerCluster)) {
-		writeLogicalSector(i + nextSector, buf);
+		writeDirSector(i + nextSector, buf);
 	}
 
 	Cluster curCl = sectorToCluster(sector);
@@ -415,7 +461,7 @@ unsigned MSXtar::appendClusterToSubdir(unsigned sector)
 unsigned MSXtar::findUsableIndexInSector(unsigned sector)
 {
 	SectorBuffer buf;
-	readLogicalSector(sector, buf);
+	readDirSector(sector, buf);
 
 	// find a not used (0x00) or delete entry (0xE5)
 	for (auto i : xrange(DIR_ENTRIES_PER_SECTOR)) {
@@ -528,7 +574,7 @@ unsigned MSXtar::addSubdir(
 
 	// load the sector
 	SectorBuffer buf;
-	readLogicalSector(result.sector, buf);
+	readDirSector(result.sector, buf);
 
 	auto& dirEntry = buf.dirEntry[result.index];
 	copy_to_range(msxName, dirEntry.filename);
@@ -542,13 +588,13 @@ unsigned MSXtar::addSubdir(
 	writeFAT(curCl, EndOfChain{});
 
 	// save the sector again
-	writeLogicalSector(result.sector, buf);
+	writeDirSector(result.sector, buf);
 
 	// clear this cluster
 	unsigned logicalSector = clusterToSector(curCl);
 	std::ranges::fill(buf.raw, 0);
 	for (auto i : xrange(sectorsPerCluster)) {
-		writeLogicalSector(i + logicalSector, buf);
+		writeDirSector(i + logicalSector, buf);
 	}
 
 	// now add the '.' and '..' entries!!
@@ -574,7 +620,7 @@ unsigned MSXtar::addSubdir(
 	}
 
 	// and save this in the first sector of the new subdir
-	writeLogicalSector(logicalSector, buf);
+	writeDirSector(logicalSector, buf);
 
 	return logicalSector;
 }
@@ -702,7 +748,7 @@ std::string MSXtar::deleteEntry(const FAT::FileName& msxName, unsigned rootSecto
 		return "entry not found";
 	}
 	deleteEntry(buf.dirEntry[entry.index]);
-	writeLogicalSector(entry.sector, buf);
+	writeDirSector(entry.sector, buf);
 	return "";
 }
 
@@ -742,7 +788,7 @@ void MSXtar::deleteDirectory(unsigned sector)
 {
 	for (/* */ ; sector != 0; sector = getNextSector(sector)) {
 		SectorBuffer buf;
-		readLogicalSector(sector, buf);
+		readDirSector(sector, buf);
 		for (auto& dirEntry : buf.dirEntry) {
 			if (dirEntry.filename[0] == char(0x00)) {
 				return;
@@ -752,7 +798,7 @@ void MSXtar::deleteDirectory(unsigned sector)
 			}
 			deleteEntry(dirEntry);
 		}
-		writeLogicalSector(sector, buf);
+		writeDirSector(sector, buf);
 	}
 }
 
@@ -773,7 +819,7 @@ std::string MSXtar::renameItem(std::string_view currentName, std::string_view ne
 	}
 
 	buf.dirEntry[oldEntry.index].filename = newMsxName;
-	writeLogicalSector(oldEntry.sector, buf);
+	writeDirSector(oldEntry.sector, buf);
 	return "";
 }
 
@@ -789,7 +835,7 @@ MSXtar::DirEntry MSXtar::findEntryInDir(
 	result.index = 0; // avoid warning (only some gcc versions complain)
 	while (result.sector) {
 		// read sector and scan 16 entries
-		readLogicalSector(result.sector, buf);
+		readDirSector(result.sector, buf);
 		for (result.index = 0; result.index < DIR_ENTRIES_PER_SECTOR; ++result.index) {
 			if (std::ranges::equal(buf.dirEntry[result.index].filename, msxName)) {
 				return result;
@@ -817,13 +863,13 @@ std::string MSXtar::addFileToDSK(const std::string& fullHostName, unsigned rootS
 		} else {
 			// first delete entry
 			deleteEntry(dummy.dirEntry[fullMsxDirEntry.index]);
-			writeLogicalSector(fullMsxDirEntry.sector, dummy);
+			writeDirSector(fullMsxDirEntry.sector, dummy);
 		}
 	}
 
 	SectorBuffer buf;
 	DirEntry entry = addEntryToDir(rootSector);
-	readLogicalSector(entry.sector, buf);
+	readDirSector(entry.sector, buf);
 	auto& dirEntry = buf.dirEntry[entry.index];
 	memset(&dirEntry, 0, sizeof(dirEntry));
 	copy_to_range(msxName, dirEntry.filename);
@@ -838,10 +884,10 @@ std::string MSXtar::addFileToDSK(const std::string& fullHostName, unsigned rootS
 		alterFileInDSK(dirEntry, fullHostName);
 	} catch (MSXException&) {
 		// still write directory entry
-		writeLogicalSector(entry.sector, buf);
+		writeDirSector(entry.sector, buf);
 		throw;
 	}
-	writeLogicalSector(entry.sector, buf);
+	writeDirSector(entry.sector, buf);
 	return {};
 }
 
@@ -868,7 +914,7 @@ std::string MSXtar::addOrCreateSubdir(zstring_view hostDirName, unsigned sector,
 		} else {
 			// first delete existing file
 			deleteEntry(msxDirEntry);
-			writeLogicalSector(entry.sector, buf);
+			writeDirSector(entry.sector, buf);
 		}
 	}
 	// add new directory
@@ -937,7 +983,7 @@ TclObject MSXtar::dirRaw()
 	TclObject result;
 	for (unsigned sector = chrootSector; sector != 0; sector = getNextSector(sector)) {
 		SectorBuffer buf;
-		readLogicalSector(sector, buf);
+		readDirSector(sector, buf);
 		for (auto& dirEntry : buf.dirEntry) {
 			if (dirEntry.filename[0] == char(0x00)) {
 				return result;
@@ -1084,7 +1130,7 @@ void MSXtar::recurseDirExtract(std::string_view dirName, unsigned sector)
 {
 	for (/* */ ; sector != 0; sector = getNextSector(sector)) {
 		SectorBuffer buf;
-		readLogicalSector(sector, buf);
+		readDirSector(sector, buf);
 		for (auto& dirEntry : buf.dirEntry) {
 			if (dirEntry.filename[0] == char(0x00)) {
 				return;
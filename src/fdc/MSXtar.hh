@@ -14,6 +14,7 @@
 #include "zstring_view.hh"
 
 #include <cstdint>
+#include <map>
 #include <string_view>
 #include <variant>
 
@@ -81,6 +82,9 @@ private:
 
 	void writeLogicalSector(unsigned sector, const SectorBuffer& buf);
 	void readLogicalSector (unsigned sector,       SectorBuffer& buf);
+	void writeDirSector(unsigned sector, const SectorBuffer& buf);
+	void readDirSector (unsigned sector,       SectorBuffer& buf);
+	void flushCaches() noexcept;
 
 	[[nodiscard]] unsigned clusterToSector(FAT::Cluster cluster) const;
 	[[nodiscard]] FAT::Cluster sectorToCluster(unsigned sector) const;
@@ -123,6 +127,11 @@ private:
 
 	SectorAccessibleDisk& disk;
 	MemBuffer<SectorBuffer> fatBuffer;
+	struct CachedSector {
+		SectorBuffer buf;
+		bool dirty;
+	};
+	std::map<unsigned, CachedSector> dirCache; // only directory sectors
 	const MsxChar2Unicode& msxChars;
 	FAT::Cluster findFirstFreeClusterStart{0}; // all clusters before this one are in use
 
@@ -451,10 +451,7 @@ void NowindHost::transferSectors(unsigned transferAddress, unsigned amount)
 	send16(narrow_cast<uint16_t>(amount));
 
 	std::span fullBuf{buffer[0].raw.data(), buffer.size() * SECTOR_SIZE};
-	for (auto buf = fullBuf.subspan(transferred, amount);
-	     auto b : buf) {
-		send(b);
-	}
+	hostToMsxFifo.append_range(fullBuf.subspan(transferred, amount));
 	send(0xAF);
 	send(0x07); // used for validation
 }
@@ -468,10 +465,7 @@ void NowindHost::transferSectorsBackwards(unsigned transferAddress, unsigned amo
 	send(narrow_cast<uint8_t>(amount / 64));
 
 	std::span fullBuf{buffer[0].raw.data(), buffer.size() * SECTOR_SIZE};
-	for (auto buf = fullBuf.subspan(transferred, amount);
-	     auto b : std::views::reverse(buf)) {
-		send(b);
-	}
+	hostToMsxFifo.append_range(std::views::reverse(fullBuf.subspan(transferred, amount)));
 	send(0xAF);
 	send(0x07); // used for validation
 }
@@ -43,6 +43,16 @@ RealDrive::RealDrive(MSXMotherBoard& motherBoard_, EmuDuration motorTimeout_,
 	, trackMode(trackMode_)
 {
 	drivesInUse = getDrivesInUse(motherBoard);
+	turboSetting = motherBoard.getSharedStuff<BooleanSetting>(
+		"turboDiskSetting",
+		motherBoard.getCommandController(), "turbo_disk",
+		"Skip the mechanical delays of the disk drives: the disk rotates "
+		"much faster and head stepping is (almost) instant. Useful for "
+		"automated tests, but some copy protections and timing sensitive "
+		"software won't work.",
+		false, Setting::Save::NO);
+	turboSetting->attach(*this);
+	rotationSpeed = turboSetting->getBoolean() ? TURBO_ROTATION_SPEED : 1;
 
 	unsigned i = 0;
 	while ((*drivesInUse)[i]) {
@@ -70,6 +80,7 @@ RealDrive::~RealDrive()
 		// ignore
 	}
 	doSetMotor(false, getCurrentTime()); // to send LED event
+	turboSetting->detach(*this);
 
 	motherBoard.unregisterMediaProvider(*this);
 
@@ -328,7 +339,7 @@ unsigned RealDrive::getCurrentAngle(EmuTime time) const
 {
 	if (motorStatus) {
 		// rotating, take passed time into account
-		auto deltaAngle = motorTimer.getTicksTillUp(time);
+		auto deltaAngle = motorTimer.getTicksTillUp(time) * rotationSpeed;
 		return narrow_cast<unsigned>((startAngle + deltaAngle) % TICKS_PER_ROTATION);
 	} else {
 		// not rotating, angle didn't change
@@ -374,6 +385,11 @@ void RealDrive::execMotorTimeout(EmuTime time)
 	doSetMotor(false, time);
 }
 
+static constexpr unsigned divUp(unsigned a, unsigned b)
+{
+	return (a + b - 1) / b;
+}
+
 bool RealDrive::indexPulse(EmuTime time)
 {
 	// Tested on real NMS8250:
@@ -391,8 +407,8 @@ EmuTime RealDrive::getTimeTillIndexPulse(EmuTime time, int count)
 		return EmuTime::infinity();
 	}
 	unsigned delta = TICKS_PER_ROTATION - getCurrentAngle(time);
-	auto dur1 = MotorClock::duration(delta);
-	auto dur2 = MotorClock::duration(TICKS_PER_ROTATION) * (count - 1);
+	auto dur1 = MotorClock::duration(divUp(delta, rotationSpeed));
+	auto dur2 = MotorClock::duration(TICKS_PER_ROTATION / rotationSpeed) * (count - 1);
 	return time + dur1 + dur2;
 }
 
@@ -447,10 +463,6 @@ uint8_t RealDrive::readTrackByte(int idx)
 	return trackValid ? track.read(idx) : 0;
 }
 
-static constexpr unsigned divUp(unsigned a, unsigned b)
-{
-	return (a + b - 1) / b;
-}
 EmuTime RealDrive::getNextSector(EmuTime time, RawTrack::Sector& sector)
 {
 	getTrack();
@@ -478,7 +490,7 @@ EmuTime RealDrive::getNextSector(EmuTime time, RawTrack::Sector& sector)
 	if (delta < 4) delta += TICKS_PER_ROTATION;
 	assert(4 <= delta); assert(unsigned(delta) < (TICKS_PER_ROTATION + 4));
 
-	return time + MotorClock::duration(delta);
+	return time + MotorClock::duration(divUp(delta, rotationSpeed));
 }
 
 void RealDrive::flushTrack()
@@ -508,6 +520,20 @@ bool RealDrive::isDummyDrive() const
 	return false;
 }
 
+bool RealDrive::isTurbo() const
+{
+	return rotationSpeed != 1;
+}
+
+void RealDrive::update(const Setting& /*setting*/) noexcept
+{
+	// Keep the current angle, only the rotation speed from now on changes.
+	auto time = getCurrentTime();
+	startAngle = getCurrentAngle(time);
+	motorTimer.advance(time);
+	rotationSpeed = turboSetting->getBoolean() ? TURBO_ROTATION_SPEED : 1;
+}
+
 void RealDrive::applyWd2793ReadTrackQuirk()
 {
 	track.applyWd2793ReadTrackQuirk();
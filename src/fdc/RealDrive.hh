@@ -4,8 +4,10 @@
 #include "DiskChanger.hh"
 #include "DiskDrive.hh"
 
+#include "BooleanSetting.hh"
 #include "Clock.hh"
 #include "MSXMotherBoard.hh"
+#include "Observer.hh"
 #include "Schedulable.hh"
 #include "ThrottleManager.hh"
 #include "serialize_meta.hh"
@@ -20,6 +22,7 @@ namespace openmsx {
 /** This class implements a real drive, single or double sided.
  */
 class RealDrive final : public DiskDrive, public MediaProvider
+                      , private Observer<Setting>
 {
 public:
 	static constexpr unsigned MAX_DRIVES = 26; // a-z
@@ -53,6 +56,7 @@ public:
 	bool diskChanged() override;
 	[[nodiscard]] bool peekDiskChanged() const override;
 	[[nodiscard]] bool isDummyDrive() const override;
+	[[nodiscard]] bool isTurbo() const override;
 
 	void applyWd2793ReadTrackQuirk() override;
 	void invalidateWd2793ReadTrackQuirk() override;
@@ -97,9 +101,16 @@ private:
 	void getTrack();
 	void invalidateTrack();
 
+	// Observer<Setting>
+	void update(const Setting& setting) noexcept override;
+
 private:
 	static constexpr unsigned TICKS_PER_ROTATION = 200000;
 	static constexpr unsigned INDEX_DURATION = TICKS_PER_ROTATION / 50;
+	// In turbo mode the disk spins this many times faster (a rotation
+	// takes 6.25ms instead of 200ms). The data rate of the FDC doesn't
+	// change, so the MSX software still sees the same DRQ timing.
+	static constexpr unsigned TURBO_ROTATION_SPEED = 32;
 
 	MSXMotherBoard& motherBoard;
 	LoadingIndicator loadingIndicator;
@@ -117,6 +128,8 @@ private:
 	const DiskDrive::TrackMode trackMode;
 
 	std::shared_ptr<DrivesInUse> drivesInUse;
+	std::shared_ptr<BooleanSetting> turboSetting; // shared by all drives
+	unsigned rotationSpeed = 1; // 1 or TURBO_ROTATION_SPEED
 
 	RawTrack track;
 	bool trackValid = false;
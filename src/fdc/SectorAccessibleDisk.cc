@@ -6,8 +6,10 @@
 #include "IPSPatch.hh"
 
 #include "enumerate.hh"
+#include "ranges.hh"
 #include "sha1.hh"
 
+#include <algorithm>
 #include <array>
 #include <memory>
 
@@ -29,24 +31,72 @@ void SectorAccessibleDisk::readSectors(
 	std::span<SectorBuffer> buffers, size_t startSector)
 {
 	auto last = startSector + buffers.size() - 1;
+	size_t nbSectors = 0; // only known when 'last > 1'
 	if (!isDummyDisk() && // in that case we want DriveEmptyException
-	    (last > 1) && // allow reading sector 0 and 1 without calling
+	    (last > 1)) { // allow reading sector 0 and 1 without calling
 	                  // getNbSectors() because this potentially calls
 	                  // detectGeometry() and that would cause an
 	                  // infinite loop
-	    (getNbSectors() <= last)) {
-		throw NoSuchSectorException("No such sector");
+		nbSectors = getNbSectors();
+		if (nbSectors <= last) {
+			throw NoSuchSectorException("No such sector");
+		}
 	}
 	try {
-		// in the end this calls readSectorsImpl()
-		patch->copyBlock(startSector * sizeof(SectorBuffer),
-		                 std::span{buffers[0].raw.data(),
-		                           buffers.size_bytes()});
+		if (readAheadEnabled && (nbSectors != 0)) {
+			readSectorsReadAhead(buffers, startSector, nbSectors);
+		} else {
+			readSectorsPatched(buffers, startSector);
+		}
 	} catch (MSXException& e) {
 		throw DiskIOErrorException("Disk I/O error: ", e.getMessage());
 	}
 }
 
+void SectorAccessibleDisk::readSectorsPatched(
+	std::span<SectorBuffer> buffers, size_t startSector)
+{
+	// in the end this calls readSectorsImpl()
+	patch->copyBlock(startSector * sizeof(SectorBuffer),
+	                 std::span{buffers[0].raw.data(), buffers.size_bytes()});
+}
+
+void SectorAccessibleDisk::readSectorsReadAhead(
+	std::span<SectorBuffer> buffers, size_t startSector, size_t nbSectors)
+{
+	auto num = buffers.size();
+	bool sequential = startSector == nextSector;
+	nextSector = startSector + num;
+
+	if ((readAheadStart <= startSector) &&
+	    ((startSector + num) <= (readAheadStart + readAheadBuf.size()))) {
+		copy_to_range(subspan(readAheadBuf, startSector - readAheadStart, num),
+		              buffers);
+		return;
+	}
+
+	// Miss: grow the read-ahead while the access pattern is sequential,
+	// otherwise only read what was requested.
+	readAheadSize = sequential
+	              ? std::clamp(2 * readAheadSize, MIN_READ_AHEAD, MAX_READ_AHEAD)
+	              : 0;
+	auto total = std::min(num + readAheadSize, nbSectors - startSector);
+	if (total == num) {
+		readAheadBuf.clear();
+		readSectorsPatched(buffers, startSector);
+		return;
+	}
+	readAheadBuf.resize(total);
+	try {
+		readSectorsPatched(readAheadBuf, startSector);
+	} catch (MSXException&) {
+		readAheadBuf.clear();
+		throw;
+	}
+	readAheadStart = startSector;
+	copy_to_range(subspan(readAheadBuf, 0, num), buffers);
+}
+
 void SectorAccessibleDisk::readSectorsImpl(
 	std::span<SectorBuffer> buffers, size_t startSector)
 {
@@ -83,10 +133,26 @@ void SectorAccessibleDisk::writeSector(size_t sector, const SectorBuffer& buf)
 void SectorAccessibleDisk::writeSectors(
 	std::span<const SectorBuffer> buffers, size_t startSector)
 {
-	// Simply write one-at-a-time. There's no possibility (nor any need) yet
-	// to allow to optimize this
+	if (buffers.empty()) return;
+	if (isWriteProtected()) {
+		throw WriteProtectedException();
+	}
+	if (!isDummyDisk() && (getNbSectors() < (startSector + buffers.size()))) {
+		throw NoSuchSectorException("No such sector");
+	}
+	try {
+		writeSectorsImpl(buffers, startSector);
+	} catch (MSXException& e) {
+		throw DiskIOErrorException("Disk I/O error: ", e.getMessage());
+	}
+	flushCaches();
+}
+
+void SectorAccessibleDisk::writeSectorsImpl(
+	std::span<const SectorBuffer> buffers, size_t startSector)
+{
 	for (auto [i, buf] : enumerate(buffers)) {
-		writeSector(startSector + i, buf);
+		writeSectorImpl(startSector + i, buf);
 	}
 }
 
@@ -99,6 +165,7 @@ size_t SectorAccessibleDisk::getNbSectors()
 void SectorAccessibleDisk::applyPatch(Filename patchFile)
 {
 	patch = std::make_unique<IPSPatch>(std::move(patchFile), std::move(patch));
+	flushCaches();
 }
 
 std::vector<Filename> SectorAccessibleDisk::getPatches() const
@@ -161,6 +228,11 @@ bool SectorAccessibleDisk::isDummyDisk() const
 	return false;
 }
 
+void SectorAccessibleDisk::flushWrites()
+{
+	// nothing
+}
+
 void SectorAccessibleDisk::checkCaches()
 {
 	// nothing
@@ -169,6 +241,8 @@ void SectorAccessibleDisk::checkCaches()
 void SectorAccessibleDisk::flushCaches()
 {
 	sha1cache.clear();
+	readAheadBuf.clear();
+	readAheadSize = 0;
 }
 
 } // namespace openmsx
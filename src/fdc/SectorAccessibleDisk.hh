@@ -33,6 +33,12 @@ public:
 
 	[[nodiscard]] virtual bool isDummyDisk() const;
 
+	/** Write buffered sector writes (if any) to the underlying storage.
+	  * Called e.g. before the disk is ejected or a savestate is made.
+	  * Throws MSXException on error.
+	  */
+	virtual void flushWrites();
+
 	// patch stuff
 	void applyPatch(Filename patchFile);
 	[[nodiscard]] std::vector<Filename> getPatches() const;
@@ -60,18 +66,43 @@ protected:
 	void setPeekMode(bool peek) { peekMode = peek; }
 	[[nodiscard]] bool isPeekMode() const { return peekMode; }
 
+	/** Enable the read-ahead cache (by default it's disabled). Only
+	  * suited for subclasses that read their data from a (large) file,
+	  * and where the content can only change via writeSector() (or when
+	  * flushCaches() is called). When sequential reads are detected, the
+	  * following sectors are read together with the requested ones (in
+	  * one call to readSectorsImpl()). The amount of read-ahead grows as
+	  * long as the access pattern stays sequential.
+	  */
+	void enableReadAhead() { readAheadEnabled = true; }
+
 	virtual void checkCaches();
 	virtual void flushCaches();
 	virtual Sha1Sum getSha1SumImpl(FilePool& filePool);
 
 private:
 	virtual void writeSectorImpl(size_t sector, const SectorBuffer& buf) = 0;
+	// Default implementation delegates to writeSectorImpl(), subclasses
+	// can override this if they can write multiple sectors more efficiently.
+	virtual void writeSectorsImpl(std::span<const SectorBuffer> buffers, size_t startSector);
 	[[nodiscard]] virtual size_t getNbSectorsImpl() = 0;
 	[[nodiscard]] virtual bool isWriteProtectedImpl() const = 0;
 
+	void readSectorsPatched(std::span<SectorBuffer> buffers, size_t startSector);
+	void readSectorsReadAhead(std::span<SectorBuffer> buffers, size_t startSector,
+	                          size_t nbSectors);
+
 private:
+	static constexpr size_t MIN_READ_AHEAD = 8;
+	static constexpr size_t MAX_READ_AHEAD = 128; // 64kB
+
 	std::unique_ptr<const PatchInterface> patch;
 	Sha1Sum sha1cache;
+	std::vector<SectorBuffer> readAheadBuf; // sectors [readAheadStart, +size)
+	size_t readAheadStart = 0;
+	size_t readAheadSize = 0; // number of extra sectors for the next miss
+	size_t nextSector = size_t(-1); // a read starting here is sequential
+	bool readAheadEnabled = false;
 	bool forcedWriteProtect = false;
 	bool peekMode = false;
 };
@@ -616,7 +616,8 @@ void TC8566AF::startReadWriteSector(EmuTime time)
 	// load drive head, if not already loaded
 	EmuTime headLoadTime = time;
 	if (!isHeadLoaded(time)) {
-		headLoadTime += getHeadLoadDelay();
+		headLoadTime += drive[driveSelect]->isTurbo() ? DiskDrive::TURBO_DELAY
+		                                              : getHeadLoadDelay();
 		// set 'head is loaded'
 		headUnloadTime = EmuTime::infinity();
 	}
@@ -776,7 +777,8 @@ void TC8566AF::doSeek(int n)
 
 	currentDrive.step(direction, si.time);
 
-	si.time += getSeekDelay();
+	si.time += currentDrive.isTurbo() ? DiskDrive::TURBO_DELAY
+	                                  : getSeekDelay();
 	setSyncPoint(si.time);
 }
 
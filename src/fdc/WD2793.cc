@@ -94,6 +94,13 @@ void WD2793::setDrqRate(unsigned trackLength)
 	drqTime.setFreq(trackLength * DiskDrive::ROTATIONS_PER_SECOND);
 }
 
+EmuDuration WD2793::getSettleDelay() const
+{
+	// head settle delay of type 2/3 commands with E_FLAG set
+	return drive.isTurbo() ? DiskDrive::TURBO_DELAY
+	                       : EmuDuration::msec(30); // when 1MHz clock
+}
+
 bool WD2793::getIRQ(EmuTime time) const
 {
 	return peekIRQ(time);
@@ -498,7 +505,8 @@ void WD2793::step(EmuTime time)
 		endType1Cmd(time);
 	} else {
 		drive.step(directionIn, time);
-		schedule(FSM::SEEK, time + timePerStep[commandReg & STEP_SPEED]);
+		schedule(FSM::SEEK, time + (drive.isTurbo() ? DiskDrive::TURBO_DELAY
+		                                            : timePerStep[commandReg & STEP_SPEED]));
 	}
 }
 
@@ -537,7 +545,7 @@ void WD2793::startType2Cmd(EmuTime time)
 
 		if (commandReg & E_FLAG) {
 			schedule(FSM::TYPE2_LOADED,
-			         time + EmuDuration::msec(30)); // when 1MHz clock
+			         time + getSettleDelay());
 		} else {
 			type2Loaded(time);
 		}
@@ -838,7 +846,7 @@ void WD2793::startType3Cmd(EmuTime time)
 
 		if (commandReg & E_FLAG) {
 			schedule(FSM::TYPE3_LOADED,
-			         time + EmuDuration::msec(30)); // when 1MHz clock
+			         time + getSettleDelay());
 		} else {
 			type3Loaded(time);
 		}
@@ -101,6 +101,7 @@ private:
 	void endCmd(EmuTime time);
 
 	void setDrqRate(unsigned trackLength);
+	[[nodiscard]] EmuDuration getSettleDelay() const;
 	[[nodiscard]] bool isReady() const;
 
 	void schedule(FSM state, EmuTime time);
@@ -5,21 +5,52 @@
 
 #include "File.hh"
 
+#include "hash_map.hh"
+#include "xxhash.hh"
+
 namespace openmsx {
 
-XSADiskImage::XSADiskImage(const Filename& filename, File& file)
-	: SectorBasedDisk(DiskName(filename))
+// Decoded images are shared by all XSADiskImage objects (of all machines)
+// that use the same (unmodified) file. So reinserting a disk, or recreating
+// the machine (e.g. when going back in time with reverse) doesn't decode the
+// image again. The most recently decoded image is kept alive even when it's
+// (temporarily) not used anymore.
+using XSAData = MemBuffer<SectorBuffer>;
+struct XSACacheEntry {
+	time_t time;
+	std::weak_ptr<const XSAData> data;
+};
+static hash_map<std::string, XSACacheEntry, XXHasher> xsaCache;
+static std::shared_ptr<const XSAData> lastDecoded;
+
+[[nodiscard]] static std::shared_ptr<const XSAData> decode(
+	const std::string& name, File& file)
 {
+	auto time = file.getModificationDate();
+	if (auto* entry = lookup(xsaCache, name); entry && (entry->time == time)) {
+		if (auto result = entry->data.lock()) return result;
+	}
+
 	auto mmap = file.mmap<const uint8_t>();
 	XSAExtractor extractor(mmap);
-	data = std::move(extractor).extractData();
-	setNbSectors(data.size());
+	auto result = std::make_shared<const XSAData>(std::move(extractor).extractData());
+
+	xsaCache.insert_or_assign(name, XSACacheEntry{time, result});
+	lastDecoded = result;
+	return result;
+}
+
+XSADiskImage::XSADiskImage(const Filename& filename, File& file)
+	: SectorBasedDisk(DiskName(filename))
+	, data(decode(filename.getResolved(), file))
+{
+	setNbSectors(data->size());
 }
 
 void XSADiskImage::readSectorsImpl(
 	std::span<SectorBuffer> buffers, size_t startSector)
 {
-	copy_to_range(std::span{&data[startSector], buffers.size()}, buffers);
+	copy_to_range(std::span{&(*data)[startSector], buffers.size()}, buffers);
 }
 
 void XSADiskImage::writeSectorImpl(size_t /*sector*/, const SectorBuffer& /*buf*/)
@@ -12,6 +12,8 @@
 
 #include "MemBuffer.hh"
 
+#include <memory>
+
 namespace openmsx {
 
 class File;
@@ -28,7 +30,8 @@ private:
 	void writeSectorImpl(size_t sector, const SectorBuffer& buf) override;
 	[[nodiscard]] bool isWriteProtectedImpl() const override;
 
-	MemBuffer<SectorBuffer> data;
+	// shared with other images of the same file (see .cc)
+	std::shared_ptr<const MemBuffer<SectorBuffer>> data;
 };
 
 } // namespace openmsx
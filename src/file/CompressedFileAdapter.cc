@@ -2,12 +2,16 @@
 
 #include "FileException.hh"
 #include "MappedFile.hh"
+#include "SeekableInflate.hh"
+#include "ZlibInflate.hh"
 
 #include "hash_set.hh"
 #include "ranges.hh"
 #include "xxhash.hh"
 
 #include <cstring>
+#include <mutex>
+#include <optional>
 
 namespace openmsx {
 
@@ -18,6 +22,23 @@ struct GetURLFromDecompressed {
 };
 static hash_set<std::unique_ptr<CompressedFileAdapter::Decompressed>,
                 GetURLFromDecompressed, XXHasher> decompressCache;
+// Files can also be opened from the FilePool background indexing thread.
+static std::mutex decompressCacheMutex;
+
+// Random access to a (large) compressed file, see SeekableInflate.
+struct CompressedFileAdapter::Seekable {
+	Seekable(FileBase& f, CompressedFileAdapter& adapter)
+		: mmap(f.mmap(0, true))
+	{
+		auto [offset, size] = adapter.parseHeader(mmap, originalName);
+		if (size < SEEKABLE_THRESHOLD) return;
+		inflate.emplace(subspan(mmap, offset));
+	}
+
+	MappedFile<const uint8_t> mmap;
+	std::string originalName;
+	std::optional<SeekableInflate> inflate; // empty if not worth it
+};
 
 
 CompressedFileAdapter::CompressedFileAdapter(std::unique_ptr<FileBase> file_, zstring_view filename_)
@@ -29,6 +50,7 @@ CompressedFileAdapter::CompressedFileAdapter(std::unique_ptr<FileBase> file_, zs
 CompressedFileAdapter::~CompressedFileAdapter()
 {
 	if (decompressed) {
+		std::scoped_lock lock(decompressCacheMutex);
 		auto it = decompressCache.find(decompressed->cachedURL);
 		assert(it != end(decompressCache));
 		assert(it->get() == decompressed);
@@ -44,28 +66,64 @@ void CompressedFileAdapter::decompress()
 {
 	if (decompressed) return;
 
+	std::unique_lock lock(decompressCacheMutex);
 	auto it = decompressCache.find(filename);
 	if (it == end(decompressCache)) {
+		// Don't hold the lock during the (possibly slow) decompression.
+		lock.unlock();
 		auto d = std::make_unique<Decompressed>();
-		decompress(*file, *d);
+		{
+			auto mmap = MappedFile<const uint8_t>(file->mmap(0, true));
+			auto [offset, size] = parseHeader(mmap, d->originalName);
+			ZlibInflate zlib(subspan(mmap, offset));
+			d->buf = zlib.inflate(size ? size : 65536);
+		}
 		d->cachedModificationDate = getModificationDate();
 		d->cachedURL = filename;
-		it = decompressCache.insert_noDuplicateCheck(std::move(d));
+		lock.lock();
+		it = decompressCache.find(filename); // another thread could have been faster
+		if (it == end(decompressCache)) {
+			it = decompressCache.insert_noDuplicateCheck(std::move(d));
+		}
 	}
 	++(*it)->useCount;
 	decompressed = it->get();
+	lock.unlock();
 
 	// close original file after successful decompress
+	seekable.reset();
 	file.reset();
 }
 
+void CompressedFileAdapter::openForReading()
+{
+	if (decompressed || seekable) return;
+	bool inCache = [&] {
+		// Already fully decompressed by another user of this file?
+		std::scoped_lock lock(decompressCacheMutex);
+		return decompressCache.contains(filename);
+	}();
+	if (!inCache) {
+		seekable = std::make_unique<Seekable>(*file, *this);
+	}
+	if (!seekable || !seekable->inflate) {
+		// Small enough, or already decompressed.
+		seekable.reset();
+		decompress();
+	}
+}
+
 void CompressedFileAdapter::read(std::span<uint8_t> buffer)
 {
-	decompress();
-	if (decompressed->buf.size() < (pos + buffer.size())) {
+	openForReading();
+	if (getSize() < (pos + buffer.size())) {
 		throw FileException("Read beyond end of file");
 	}
-	copy_to_range(decompressed->buf.subspan(pos, buffer.size()), buffer);
+	if (seekable) {
+		seekable->inflate->read(pos, buffer);
+	} else {
+		copy_to_range(decompressed->buf.subspan(pos, buffer.size()), buffer);
+	}
 	pos += buffer.size();
 }
 
@@ -82,8 +140,9 @@ MappedFileImpl CompressedFileAdapter::mmap(size_t extra, bool is_const)
 
 size_t CompressedFileAdapter::getSize()
 {
-	decompress();
-	return decompressed->buf.size();
+	openForReading();
+	return seekable ? seekable->inflate->getSize()
+	                : decompressed->buf.size();
 }
 
 void CompressedFileAdapter::seek(size_t newPos)
@@ -108,8 +167,9 @@ void CompressedFileAdapter::flush()
 
 zstring_view CompressedFileAdapter::getOriginalName()
 {
-	decompress();
-	return decompressed->originalName;
+	openForReading();
+	return seekable ? seekable->originalName
+	                : decompressed->originalName;
 }
 
 bool CompressedFileAdapter::isReadOnly() const
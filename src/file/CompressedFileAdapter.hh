@@ -33,19 +33,37 @@ public:
 	[[nodiscard]] bool isReadOnly() const final;
 	[[nodiscard]] time_t getModificationDate() final;
 
+	/** Files whose decompressed size is at least this big are not fully
+	  * decompressed in memory when they're only accessed via read() (e.g.
+	  * hard disk images). Instead a SeekableInflate index is built. */
+	static constexpr size_t SEEKABLE_THRESHOLD = 16 * 1024 * 1024;
+
 protected:
+	struct DeflateStream {
+		size_t offset; // start of the raw deflate data in the file
+		size_t size;   // (expected) size of the decompressed data, 0 if unknown
+	};
+
 	explicit CompressedFileAdapter(std::unique_ptr<FileBase> file, zstring_view filename);
 	~CompressedFileAdapter() override;
-	virtual void decompress(FileBase& file, Decompressed& decompressed) = 0;
+	/** Parse the header in front of the deflate data.
+	  * Throws FileException when the format is not recognized. */
+	[[nodiscard]] virtual DeflateStream parseHeader(
+		std::span<const uint8_t> data, std::string& originalName) = 0;
 
 private:
 	void decompress();
+	void openForReading();
 
 private:
-	// invariant: exactly one of 'file' and 'decompressed' is '!= nullptr'
+	struct Seekable;
+
+	// invariant: 'decompressed' and 'seekable' are not both '!= nullptr'
+	//            'file' is '!= nullptr' iff 'decompressed' is '== nullptr'
 	std::unique_ptr<FileBase> file;
 	std::string filename;
 	const Decompressed* decompressed = nullptr;
+	std::unique_ptr<Seekable> seekable;
 	size_t pos = 0;
 };
 
@@ -0,0 +1,120 @@
+#include "DirWatcher.hh"
+
+#include "foreach_file.hh"
+#include "strCat.hh"
+
+#ifdef __linux__
+#  include <sys/inotify.h>
+#  include <unistd.h>
+#endif
+
+#include <array>
+#include <cstring>
+
+namespace openmsx {
+
+#ifdef __linux__
+
+static constexpr uint32_t WATCH_MASK =
+	IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM |
+	IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+DirWatcher::DirWatcher(const std::string& dir)
+	: fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+{
+	if (fd == -1) return; // not supported, always report changes
+	std::string path = dir;
+	addWatchRecursive(path);
+}
+
+DirWatcher::~DirWatcher()
+{
+	if (fd != -1) ::close(fd); // also removes all watches
+}
+
+void DirWatcher::addWatchRecursive(std::string& dir)
+{
+	int wd = inotify_add_watch(fd, dir.c_str(), WATCH_MASK);
+	if (wd == -1) {
+		// e.g. the limit on the number of watches was reached, we
+		// can't reliably detect changes anymore
+		::close(fd);
+		fd = -1;
+		return;
+	}
+	watches.insert_or_assign(wd, dir);
+	auto fileAction = [](const std::string& /*path*/) { /*nothing*/ };
+	auto dirAction = [&](std::string& path) {
+		addWatchRecursive(path);
+		return fd != -1; // stop traversal on error
+	};
+	foreach_file_and_directory(dir, fileAction, dirAction);
+}
+
+void DirWatcher::poll()
+{
+	if (fd == -1) return;
+	alignas(inotify_event) std::array<char, 4096> buf;
+	while (true) {
+		auto len = ::read(fd, buf.data(), buf.size());
+		if (len <= 0) return; // no (more) events, EAGAIN
+		for (ssize_t i = 0; (fd != -1) && (i < len); ) {
+			inotify_event event;
+			memcpy(&event, &buf[i], sizeof(event));
+			i += ssize_t(sizeof(event) + event.len);
+			changed = true;
+
+			if (event.mask & IN_Q_OVERFLOW) {
+				// Events got lost, e.g. a new subdirectory may not
+				// be watched. Give up, always report changes.
+				::close(fd);
+				fd = -1;
+			} else if (event.mask & IN_IGNORED) {
+				watches.erase(event.wd);
+			} else if ((event.mask & IN_ISDIR) &&
+			           (event.mask & (IN_CREATE | IN_MOVED_TO)) &&
+			           (event.len != 0)) {
+				// new subdirectory, watch it as well
+				if (const auto* parent = lookup(watches, event.wd)) {
+					std::string_view name(&buf[i - event.len]); // zero-padded
+					auto path = parent->ends_with('/') ? strCat(*parent, name)
+					                                   : strCat(*parent, '/', name);
+					addWatchRecursive(path);
+				}
+			}
+		}
+	}
+}
+
+#else
+
+DirWatcher::DirWatcher(const std::string& /*dir*/)
+{
+	// not implemented on this platform, always report changes
+}
+
+DirWatcher::~DirWatcher() = default;
+
+void DirWatcher::addWatchRecursive(std::string& /*dir*/)
+{
+}
+
+void DirWatcher::poll()
+{
+}
+
+#endif
+
+bool DirWatcher::hasChanges()
+{
+	poll();
+	return changed || (fd == -1);
+}
+
+void DirWatcher::clearChanges()
+{
+	poll();
+	changed = false;
+}
+
+} // namespace openmsx
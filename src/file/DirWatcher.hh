@@ -0,0 +1,50 @@
+#ifndef DIRWATCHER_HH
+#define DIRWATCHER_HH
+
+#include "hash_map.hh"
+
+#include <string>
+
+namespace openmsx {
+
+/** Detects changes in a host directory tree (files or subdirectories being
+  * added, removed, renamed or modified).
+  *
+  * This allows users of a host directory to skip a (potentially expensive)
+  * rescan when nothing changed. On systems where watching is not supported
+  * (currently only Linux/inotify is implemented) or when the OS reports
+  * that it lost track of some events, the directory is always reported as
+  * (possibly) changed, so callers can unconditionally rely on the result.
+  */
+class DirWatcher
+{
+public:
+	/** Start watching the given directory (and all its subdirectories).
+	  * Never throws, on error it falls back to always report changes. */
+	explicit DirWatcher(const std::string& dir);
+	DirWatcher(const DirWatcher&) = delete;
+	DirWatcher(DirWatcher&&) = delete;
+	DirWatcher& operator=(const DirWatcher&) = delete;
+	DirWatcher& operator=(DirWatcher&&) = delete;
+	~DirWatcher();
+
+	/** Has anything (possibly) changed since the last clearChanges() call
+	  * (or since construction)? */
+	[[nodiscard]] bool hasChanges();
+
+	/** Call this right before rescanning the directory. */
+	void clearChanges();
+
+private:
+	void poll();
+	void addWatchRecursive(std::string& dir);
+
+private:
+	hash_map<int, std::string> watches; // watch descriptor -> directory
+	int fd = -1;
+	bool changed = true;
+};
+
+} // namespace openmsx
+
+#endif
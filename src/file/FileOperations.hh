@@ -75,6 +75,12 @@ namespace openmsx::FileOperations {
 	  */
 	int deleteRecursive(zstring_view path);
 
+	/** Rename a file, an existing file with the new name is replaced
+	  * (atomically on POSIX systems).
+	  * @result 0 on success, -1 on error
+	  */
+	int rename(zstring_view oldPath, zstring_view newPath);
+
 	/** Call fopen() in a platform-independent manner
 	  * @param filename the file path
 	  * @param mode the mode parameter, same as fopen
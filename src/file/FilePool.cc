@@ -41,16 +41,24 @@ FilePool::FilePool(CommandController& controller, Reactor& reactor_)
 		"This is an internal setting. Don't change this directly, "
 		"instead use the 'filepool' command.",
 		initialFilePoolSettingValue().getString())
+	, backgroundIndexSetting(
+		controller, "filepool_background_index",
+		"Index the filepool directories in a background thread, so "
+		"that looking up a file never needs to wait for a directory scan.",
+		false)
 	, reactor(reactor_)
 	, sha1SumCommand(controller)
+	, findCommand(controller)
 {
 	filePoolSetting.attach(*this);
+	backgroundIndexSetting.attach(*this);
 	reactor.getEventDistributor().registerEventListener(EventType::QUIT, *this);
 }
 
 FilePool::~FilePool()
 {
 	reactor.getEventDistributor().unregisterEventListener(EventType::QUIT, *this);
+	backgroundIndexSetting.detach(*this);
 	filePoolSetting.detach(*this);
 }
 
@@ -74,6 +82,11 @@ std::optional<Sha1Sum> FilePool::getSha1Sum(zstring_view filename)
 	}
 }
 
+void FilePool::prefetchSha1Sums(std::span<const std::string> filenames)
+{
+	core.prefetchSha1Sums(filenames);
+}
+
 [[nodiscard]] static FileType parseTypes(Interpreter& interp, const TclObject& list)
 {
 	using enum FileType;
@@ -143,8 +156,15 @@ FilePoolCore::Directories FilePool::getDirectories() const
 
 void FilePool::update(const Setting& setting) noexcept
 {
-	assert(&setting == &filePoolSetting); (void)setting;
-	(void)getDirectories(); // check for syntax errors
+	if (&setting == &filePoolSetting) {
+		(void)getDirectories(); // check for syntax errors
+	} else {
+		assert(&setting == &backgroundIndexSetting);
+	}
+	// (re)start when enabled or when the directories changed
+	if (backgroundIndexSetting.getBoolean()) {
+		core.indexInBackground();
+	}
 }
 
 void FilePool::reportProgress(std::string_view message, float fraction)
@@ -192,4 +212,34 @@ void FilePool::Sha1SumCommand::tabCompletion(std::vector<std::string>& tokens) c
 	completeFileName(tokens, userFileContext());
 }
 
+
+// class FindCommand
+
+FilePool::FindCommand::FindCommand(CommandController& commandController_)
+	: Command(commandController_, "__filepool_find")
+{
+}
+
+void FilePool::FindCommand::execute(std::span<const TclObject> tokens, TclObject& result)
+{
+	checkNumArgs(tokens, Between{2, 3}, "sha1 ?types?");
+	Sha1Sum sha1(Sha1Sum::UninitializedTag{});
+	try {
+		sha1.parse(tokens[1].getString());
+	} catch (MSXException& e) {
+		throw CommandException(e.getMessage());
+	}
+	using enum FileType;
+	auto types = (tokens.size() == 3)
+	           ? parseTypes(getInterpreter(), tokens[2])
+	           : (SYSTEM_ROM | ROM | DISK | TAPE);
+	auto& filePool = OUTER(FilePool, findCommand);
+	result = filePool.getFile(types, sha1).filename; // empty if not found
+}
+
+std::string FilePool::FindCommand::help(std::span<const TclObject> /*tokens*/) const
+{
+	return "Internal command, use 'filepool find' instead.";
+}
+
 } // namespace openmsx
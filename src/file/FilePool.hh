@@ -1,6 +1,7 @@
 #ifndef FILEPOOL_HH
 #define FILEPOOL_HH
 
+#include "BooleanSetting.hh"
 #include "Command.hh"
 #include "EventListener.hh"
 #include "FilePoolCore.hh"
@@ -8,6 +9,8 @@
 #include "StringSetting.hh"
 
 #include <optional>
+#include <span>
+#include <string>
 #include <string_view>
 
 namespace openmsx {
@@ -37,6 +40,9 @@ public:
 	[[nodiscard]] Sha1Sum getSha1Sum(File& file, std::string_view filename);
 	[[nodiscard]] std::optional<Sha1Sum> getSha1Sum(zstring_view filename);
 
+	/** See FilePoolCore::prefetchSha1Sums(). */
+	void prefetchSha1Sums(std::span<const std::string> filenames);
+
 	[[nodiscard]] FilePoolCore::Directories getDirectories() const;
 
 private:
@@ -51,6 +57,7 @@ private:
 private:
 	FilePoolCore core;
 	StringSetting filePoolSetting;
+	BooleanSetting backgroundIndexSetting;
 	Reactor& reactor;
 
 	class Sha1SumCommand final : public Command {
@@ -61,6 +68,13 @@ private:
 		void tabCompletion(std::vector<std::string>& tokens) const override;
 	} sha1SumCommand;
 
+	class FindCommand final : public Command {
+	public:
+		explicit FindCommand(CommandController& commandController);
+		void execute(std::span<const TclObject> tokens, TclObject& result) override;
+		[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
+	} findCommand;
+
 	bool quit = false;
 };
 
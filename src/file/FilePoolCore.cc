@@ -4,11 +4,14 @@
 #include "foreach_file.hh"
 
 #include "Date.hh"
+#include "ThreadPool.hh"
 #include "Timer.hh"
 #include "one_of.hh"
 #include "ranges.hh"
 
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <optional>
 #include <tuple>
@@ -40,6 +43,7 @@ FilePoolCore::FilePoolCore(std::string fileCache_,
 
 FilePoolCore::~FilePoolCore()
 {
+	stopIndexing();
 	if (needWrite) {
 		writeSha1sums();
 	}
@@ -165,36 +169,37 @@ static std::optional<std::tuple<Sha1Sum, const char*, std::string_view>> parse(
 	return std::tuple{sha1, timeStr, filename};
 }
 
+// Binary '.filecache' format, this can be loaded without any parsing (the
+// filenames are used directly from the mapped file). All values are stored in
+// native byte order (the file is rebuilt if it doesn't match).
+//   header:  magic (8 bytes), byte order mark (uint32), number of entries (uint32)
+//   entries: sha1sum (20 bytes), modification time (int64),
+//            filename length (uint32), filename (not zero-terminated)
+// The entries are sorted on sha1sum. Older versions wrote a text format, that
+// format can still be read.
+static constexpr std::string_view BINARY_MAGIC = "oMSXfpc1";
+static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+static constexpr size_t BINARY_HEADER_SIZE = 8 + 4 + 4;
+static constexpr size_t BINARY_ENTRY_SIZE = sizeof(Sha1Sum) + 8 + 4; // excluding filename
+
 void FilePoolCore::readSha1sums()
 {
 	assert(sha1Index.empty());
 	assert(fileMem.empty());
 
 	File file(fileCache);
-	auto size = file.getSize();
-	fileMem.resize(size + 1);
-	file.read(fileMem.first(size));
-	fileMem[size] = '\n'; // ensure there's always a '\n' at the end
-
-	// Process each line.
-	// Assume lines are separated by "\n", "\r\n" or "\n\r" (but not "\r").
-	auto* data = fileMem.begin();
-	auto* data_end = fileMem.end();
-	while (data != data_end) {
-		// memchr() seems better optimized than std::find_if()
-		auto* it = static_cast<char*>(memchr(data, '\n', data_end - data));
-		if (it == nullptr) it = data_end;
-		if ((it != data) && (it[-1] == '\r')) --it;
-
-		if (auto r = parse({data, it})) {
-			auto [sum, timeStr, filename] = *r;
-			sha1Index.push_back(pool.emplace(sum, timeStr, filename).idx);
-			// sha1Index not yet guaranteed sorted
-		}
-
-		data = std::find_if(it + 1, data_end, [](char c) {
-			return c != one_of('\n', '\r');
-		});
+	// One extra byte for the text format, see below. This is a private
+	// mapping, so modifying it is allowed.
+	fileMem = file.mmap<char>(1);
+	auto size = fileMem.size() - 1;
+	std::span<char> data{fileMem.data(), size};
+
+	if (std::string_view{data.data(), std::min(size, BINARY_MAGIC.size())} == BINARY_MAGIC) {
+		readBinaryIndex(data);
+	} else {
+		fileMem[size] = '\n'; // ensure there's always a '\n' at the end
+		readTextIndex({fileMem.data(), fileMem.size()});
+		needWrite = !sha1Index.empty(); // convert to binary format on exit
 	}
 
 	if (!std::ranges::is_sorted(sha1Index, {}, GetSha1{pool})) {
@@ -220,44 +225,125 @@ void FilePoolCore::readSha1sums()
 	}
 }
 
+void FilePoolCore::readTextIndex(std::span<char> mem)
+{
+	// Process each line.
+	// Assume lines are separated by "\n", "\r\n" or "\n\r" (but not "\r").
+	auto* data = mem.data();
+	auto* data_end = data + mem.size();
+	while (data != data_end) {
+		// memchr() seems better optimized than std::find_if()
+		auto* it = static_cast<char*>(memchr(data, '\n', data_end - data));
+		if (it == nullptr) it = data_end;
+		if ((it != data) && (it[-1] == '\r')) --it;
+
+		if (auto r = parse({data, it})) {
+			auto [sum, timeStr, filename] = *r;
+			sha1Index.push_back(pool.emplace(sum, timeStr, filename).idx);
+			// sha1Index not yet guaranteed sorted
+		}
+
+		data = std::find_if(it + 1, data_end, [](char c) {
+			return c != one_of('\n', '\r');
+		});
+	}
+}
+
+void FilePoolCore::readBinaryIndex(std::span<const char> data)
+{
+	if (data.size() < BINARY_HEADER_SIZE) {
+		needWrite = true; // rewrite the (empty) index on exit
+		return;
+	}
+	uint32_t bom, count;
+	memcpy(&bom,   &data[8],  4);
+	memcpy(&count, &data[12], 4);
+	if (bom != BYTE_ORDER_MARK) {
+		// Written on a different platform, start with an empty index
+		// and rewrite it on exit.
+		needWrite = true;
+		return;
+	}
+	data = data.subspan(BINARY_HEADER_SIZE);
+
+	sha1Index.reserve(count);
+	while (data.size() >= BINARY_ENTRY_SIZE) {
+		Sha1Sum sum(Sha1Sum::UninitializedTag{});
+		int64_t time;
+		uint32_t len;
+		memcpy(&sum,  &data[0], sizeof(Sha1Sum));
+		memcpy(&time, &data[sizeof(Sha1Sum)], 8);
+		memcpy(&len,  &data[sizeof(Sha1Sum) + 8], 4);
+		data = data.subspan(BINARY_ENTRY_SIZE);
+		if (len > data.size()) break; // truncated file
+		if (time_t(time) != Date::INVALID_TIME_T) {
+			std::string_view filename{data.data(), len};
+			sha1Index.push_back(pool.emplace(sum, time_t(time), filename).idx);
+		}
+		data = data.subspan(len);
+	}
+}
+
 void FilePoolCore::writeSha1sums()
 {
+	// First build the new content in memory: the filenames may still point
+	// into the mapping of the old file, so that mapping must be released
+	// before the file is overwritten.
+	std::string out;
+	auto write = [&](const void* p, size_t n) {
+		out.append(static_cast<const char*>(p), n);
+	};
+	auto count = uint32_t(sha1Index.size());
+	write(BINARY_MAGIC.data(), BINARY_MAGIC.size());
+	write(&BYTE_ORDER_MARK, 4);
+	write(&count, 4);
+	for (auto idx : sha1Index) {
+		auto& entry = pool[idx];
+		auto time = int64_t(entry.getTime()); // possibly INVALID_TIME_T, skipped on load
+		auto len = uint32_t(entry.filename.size());
+		write(&entry.sum, sizeof(Sha1Sum));
+		write(&time, 8);
+		write(&len, 4);
+		write(entry.filename.data(), len);
+	}
+	fileMem = {};
+
 	std::ofstream file;
-	FileOperations::openOfStream(file, fileCache);
+	FileOperations::openOfStream(file, fileCache, std::ios::binary);
 	if (!file.is_open()) {
 		return;
 	}
-	for (auto idx : sha1Index) {
-		const auto& entry = pool[idx];
-		file << entry.sum << "  ";
-		if (entry.timeStr) {
-			file << entry.timeStr;
-		} else {
-			assert(entry.time != Date::INVALID_TIME_T);
-			std::array<char, 24> buf;
-			file << Date::toString(entry.time, buf);
-		}
-		file << "  " << entry.filename << '\n';
-	}
+	file.write(out.data(), std::streamsize(out.size()));
 }
 
 FilePoolCore::Result FilePoolCore::getFile(FileType fileType, const Sha1Sum& sha1sum)
 {
-	auto result = getFromPool(sha1sum);
+	std::unique_lock lock(mutex);
+	auto result = getFromPool(lock, sha1sum);
 	if (result.file.is_open()) return result;
 
-	// not found in cache, need to scan directories
 	stop = false;
+	if (indexing) {
+		// The background thread is already scanning the directories,
+		// wait for it instead of scanning them ourselves.
+		if (!waitForIndexing(lock)) return {}; // aborted
+		result = getFromPool(lock, sha1sum);
+		if (result.file.is_open()) return result;
+		// Still not found, the final scan below is (relatively) fast
+		// because all files are already indexed.
+	}
+
+	// not found in cache, need to scan directories
 	ScanProgress progress {
 		.lastTime = Timer::getTime(),
 	};
 
 	for (const auto& [path, types] : getDirectories()) {
 		if ((types & fileType) != FileType::NONE) {
-			result = scanDirectory(sha1sum, FileOperations::expandTilde(std::string(path)), path, progress);
+			result = scanDirectory(lock, sha1sum, FileOperations::expandTilde(std::string(path)), path, progress);
 			if (result.file.is_open()) {
 				if (progress.printed) {
-					reportProgress(tmpStrCat("Found file with sha1sum ", sha1sum), 1.0f);
+					reportProgressUnlocked(lock, tmpStrCat("Found file with sha1sum ", sha1sum), 1.0f);
 				}
 				return result;
 			}
@@ -265,12 +351,13 @@ FilePoolCore::Result FilePoolCore::getFile(FileType fileType, const Sha1Sum& sha
 	}
 
 	if (progress.printed) {
-		reportProgress(tmpStrCat("Did not find file with sha1sum ", sha1sum), 1.0f);
+		reportProgressUnlocked(lock, tmpStrCat("Did not find file with sha1sum ", sha1sum), 1.0f);
 	}
 	return result; // not found
 }
 
-Sha1Sum FilePoolCore::calcSha1sum(File& file, std::string_view filename) const
+Sha1Sum FilePoolCore::calcSha1sum(File& file, std::string_view filename,
+                                  bool showProgress) const
 {
 	// Calculate sha1 in several steps so that we can show progress
 	// information. We take a fixed step size for an efficient calculation.
@@ -298,7 +385,7 @@ Sha1Sum FilePoolCore::calcSha1sum(File& file, std::string_view filename) const
 		remaining -= STEP_SIZE;
 
 		auto now = Timer::getTime();
-		if ((now - lastShowedProgress) > 250'000) { // 4Hz
+		if (showProgress && ((now - lastShowedProgress) > 250'000)) { // 4Hz
 			report(float(done) / float(size));
 			lastShowedProgress = now;
 			everShowedProgress = true;
@@ -314,60 +401,90 @@ Sha1Sum FilePoolCore::calcSha1sum(File& file, std::string_view filename) const
 	return sha1.digest();
 }
 
-FilePoolCore::Result FilePoolCore::getFromPool(const Sha1Sum& sha1sum)
+// Both the sha1sum calculation and the progress callback run without holding
+// the lock: the callback may repaint the screen, which may query the filepool
+// again. Pointers or iterators into the database are invalidated by this.
+Sha1Sum FilePoolCore::calcAndStoreSha1sum(std::unique_lock<std::mutex>& lock, File& file,
+                                          const std::string& filename, time_t time)
 {
-	auto [b, e] = std::ranges::equal_range(sha1Index, sha1sum, {}, GetSha1{pool});
-	// use indices instead of iterators
-	auto i    = distance(begin(sha1Index), b);
-	auto last = distance(begin(sha1Index), e);
-	while (i != last) {
-		auto it = begin(sha1Index) + i;
+	lock.unlock();
+	Sha1Sum sum(Sha1Sum::UninitializedTag{});
+	try {
+		sum = calcSha1sum(file, filename);
+	} catch (...) {
+		lock.lock();
+		throw;
+	}
+	lock.lock();
+	storeSha1(sum, time, filename);
+	return sum;
+}
+
+void FilePoolCore::storeSha1(const Sha1Sum& sum, time_t time, std::string_view filename)
+{
+	if (auto [idx, entry] = findInDatabase(filename); idx == Index(-1)) {
+		insert(sum, time, filename);
+	} else {
+		entry->setTime(time);
+		adjustSha1(idx, *entry, sum);
+	}
+}
+
+void FilePoolCore::reportProgressUnlocked(std::unique_lock<std::mutex>& lock,
+                                          std::string_view message, float fraction)
+{
+	lock.unlock();
+	reportProgress(message, fraction);
+	lock.lock();
+}
+
+FilePoolCore::Result FilePoolCore::getFromPool(std::unique_lock<std::mutex>& lock, const Sha1Sum& sha1sum)
+{
+	// Each iteration either returns, or updates or removes the first entry
+	// with this sha1sum. The latter may release the lock, so the index is
+	// searched again each time.
+	while (true) {
+		auto it = std::ranges::lower_bound(sha1Index, sha1sum, {}, GetSha1{pool});
+		if ((it == end(sha1Index)) || (pool[*it].sum != sha1sum)) {
+			return {}; // not found
+		}
 		auto& entry = pool[*it];
 		if (entry.getTime() == Date::INVALID_TIME_T) {
 			// Invalid time/date format. Remove from
 			// database and continue searching.
 			remove(it);
-			--last;
 			continue;
 		}
+		std::string filename(entry.filename);
 		try {
-			File file(std::string(entry.filename));
+			File file(filename);
 			auto newTime = file.getModificationDate();
 			if (entry.getTime() == newTime) {
 				// When modification time is unchanged, assume
 				// sha1sum is also unchanged. So avoid
 				// expensive sha1sum calculation.
-				return {.file = std::move(file), .filename = std::string(entry.filename)};
+				return {.file = std::move(file), .filename = std::move(filename)};
 			}
-			entry.setTime(newTime); // update timestamp
-			needWrite = true;
-			auto newSum = calcSha1sum(file, entry.filename);
+			// Update timestamp and sha1sum (when the sum changed,
+			// the entry moves away from this position).
+			auto newSum = calcAndStoreSha1sum(lock, file, filename, newTime);
 			if (newSum == sha1sum) {
 				// Modification time was changed, but
 				// (recalculated) sha1sum is still the same.
-				return {.file = std::move(file), .filename = std::string(entry.filename)};
-			}
-			// Sha1sum has changed: update sha1sum, move entry to
-			// new position new sum and continue searching.
-			if (adjustSha1(it, entry, newSum)) {
-				// after
-				--last; // no ++i
-			} else {
-				// before (or at)
-				++i;
+				return {.file = std::move(file), .filename = std::move(filename)};
 			}
 		} catch (FileException&) {
 			// Error reading file: remove from db and continue
 			// searching.
-			remove(it);
-			--last;
+			if (auto [idx, e] = findInDatabase(filename); idx != Index(-1)) {
+				remove(idx, *e);
+			}
 		}
 	}
-	return {}; // not found
 }
 
 FilePoolCore::Result FilePoolCore::scanDirectory(
-	const Sha1Sum& sha1sum, const std::string& directory, std::string_view poolPath,
+	std::unique_lock<std::mutex>& lock, const Sha1Sum& sha1sum, const std::string& directory, std::string_view poolPath,
 	ScanProgress& progress)
 {
 	Result result;
@@ -379,14 +496,15 @@ FilePoolCore::Result FilePoolCore::scanDirectory(
 			assert(!result.file.is_open());
 			return false; // abort foreach_file_recursive
 		}
-		result = scanFile(sha1sum, path, st, poolPath, progress);
+		result = scanFile(lock, sha1sum, path, st, poolPath, progress);
 		return !result.file.is_open(); // abort traversal when found
 	};
 	foreach_file_recursive(directory, fileAction);
 	return result;
 }
 
-FilePoolCore::Result FilePoolCore::scanFile(const Sha1Sum& sha1sum, zstring_view filename,
+FilePoolCore::Result FilePoolCore::scanFile(std::unique_lock<std::mutex>& lock,
+                            const Sha1Sum& sha1sum, zstring_view filename,
                             const FileOperations::Stat& st, std::string_view poolPath,
                             ScanProgress& progress)
 {
@@ -396,7 +514,7 @@ FilePoolCore::Result FilePoolCore::scanFile(const Sha1Sum& sha1sum, zstring_view
 	    now > (progress.lastTime + 250'000)) { // 4Hz
 		progress.lastTime = now;
 		progress.printed = true;
-		reportProgress(tmpStrCat(
+		reportProgressUnlocked(lock, tmpStrCat(
 		        "Searching for file with sha1sum ", sha1sum,
 		        "...\nIndexing filepool ", poolPath, ": [",
 		        progress.amountScanned, "]: ",
@@ -405,39 +523,26 @@ FilePoolCore::Result FilePoolCore::scanFile(const Sha1Sum& sha1sum, zstring_view
 	}
 
 	auto time = FileOperations::getModificationDate(st);
-	if (auto [idx, entry] = findInDatabase(filename); idx == Index(-1)) {
-		// not in pool
-		try {
-			File file(filename);
-			auto sum = calcSha1sum(file, filename);
-			insert(sum, time, filename);
-			if (sum == sha1sum) {
-				return {.file = std::move(file), .filename = std::string(filename)};
+	try {
+		if (auto [idx, entry] = findInDatabase(filename);
+		    (idx != Index(-1)) && (entry->getTime() == time)) {
+			// db is still up to date
+			assert(filename == entry->filename);
+			if (entry->sum == sha1sum) {
+				return {.file = File(filename), .filename = std::string(filename)};
 			}
-		} catch (FileException&) {
-			// ignore
+			return {}; // not found
 		}
-	} else {
-		// already in pool
-		assert(filename == entry->filename);
-		try {
-			if (entry->getTime() == time) {
-				// db is still up to date
-				if (entry->sum == sha1sum) {
-					return {.file = File(filename), .filename = std::string(filename)};
-				}
-			} else {
-				// db outdated
-				File file(filename);
-				auto sum = calcSha1sum(file, filename);
-				entry->setTime(time);
-				adjustSha1(idx, *entry, sum);
-				if (sum == sha1sum) {
-					return {.file = std::move(file), .filename = std::string(filename)};
-				}
-			}
-		} catch (FileException&) {
-			// error reading file, remove from db
+		// not in pool or db outdated
+		File file(filename);
+		std::string name(filename);
+		auto sum = calcAndStoreSha1sum(lock, file, name, time);
+		if (sum == sha1sum) {
+			return {.file = std::move(file), .filename = std::move(name)};
+		}
+	} catch (FileException&) {
+		// error reading file, remove from db
+		if (auto [idx, entry] = findInDatabase(filename); idx != Index(-1)) {
 			remove(idx, *entry);
 		}
 	}
@@ -462,6 +567,7 @@ std::pair<FilePoolCore::Index, FilePoolCore::Entry*> FilePoolCore::findInDatabas
 
 Sha1Sum FilePoolCore::getSha1Sum(File& file, std::string_view filename)
 {
+	std::unique_lock lock(mutex);
 	auto time = file.getModificationDate();
 
 	auto [idx, entry] = findInDatabase(filename);
@@ -472,16 +578,117 @@ Sha1Sum FilePoolCore::getSha1Sum(File& file, std::string_view filename)
 	}
 
 	// not in database or timestamp mismatch
-	auto sum = calcSha1sum(file, filename);
-	if (idx == Index(-1)) {
-		// was not yet in database, insert new entry
-		insert(sum, time, filename);
-	} else {
-		// was already in database, but with wrong timestamp (and sha1sum)
-		entry->setTime(time);
-		adjustSha1(idx, *entry, sum);
+	return calcAndStoreSha1sum(lock, file, std::string(filename), time);
+}
+
+void FilePoolCore::indexInBackground()
+{
+	stopIndexing(); // restart if still running
+
+	indexDirs.clear();
+	for (const auto& [path, types] : getDirectories()) {
+		indexDirs.emplace_back(FileOperations::expandTilde(std::string(path)), types);
 	}
-	return sum;
+	indexStop = false;
+	indexedFiles = 0;
+	indexing = true; // no lock needed, thread isn't running
+	indexThread = std::thread([this] { indexLoop(); });
+}
+
+bool FilePoolCore::isIndexing() const
+{
+	std::scoped_lock lock(mutex);
+	return indexing;
+}
+
+void FilePoolCore::stopIndexing()
+{
+	if (!indexThread.joinable()) return;
+	indexStop = true;
+	indexThread.join();
+	indexing = false;
+}
+
+bool FilePoolCore::waitForIndexing(std::unique_lock<std::mutex>& lock)
+{
+	while (indexing) {
+		indexCond.wait_for(lock, std::chrono::milliseconds(250));
+		if (!indexing) break;
+		reportProgressUnlocked(lock, tmpStrCat("Waiting for the filepool to be indexed... [",
+		                                       indexedFiles.load(), " files]"), -1.0f);
+		if (stop) return false;
+	}
+	return true;
+}
+
+void FilePoolCore::indexLoop()
+{
+	// Hash several files concurrently (the indexing thread itself also
+	// takes part). Files are processed in batches, so that the directory
+	// traversal doesn't have to run concurrently with the hashing.
+	ThreadPool pool(std::max(2u, std::thread::hardware_concurrency()) - 1);
+	constexpr size_t BATCH_SIZE = 64;
+	std::vector<std::pair<std::string, time_t>> batch;
+	auto flush = [&] {
+		pool.parallelFor(batch.size(), [&](size_t i) {
+			if (indexStop) return;
+			indexFile(batch[i].first, batch[i].second);
+		});
+		batch.clear();
+	};
+
+	// 'indexDirs' is not modified while this thread is running.
+	for (const auto& [directory, types] : indexDirs) {
+		foreach_file_recursive(directory, [&](const std::string& path, const FileOperations::Stat& st) {
+			if (indexStop) return false;
+			batch.emplace_back(path, FileOperations::getModificationDate(st));
+			if (batch.size() == BATCH_SIZE) flush();
+			return true;
+		});
+		if (indexStop) break;
+	}
+	flush();
+
+	std::scoped_lock lock(mutex);
+	indexing = false;
+	indexCond.notify_all();
+}
+
+void FilePoolCore::indexFile(const std::string& filename, time_t time)
+{
+	updateSha1(filename, time);
+	++indexedFiles;
+}
+
+void FilePoolCore::updateSha1(const std::string& filename, time_t time)
+{
+	{
+		std::scoped_lock lock(mutex);
+		auto [idx, entry] = findInDatabase(filename);
+		if ((idx != Index(-1)) && (entry->getTime() == time)) {
+			return; // db is still up to date
+		}
+	}
+	try {
+		// Calculate the sha1sum without holding the lock.
+		File file(filename);
+		auto sum = calcSha1sum(file, filename, false);
+
+		std::scoped_lock lock(mutex);
+		storeSha1(sum, time, filename);
+	} catch (FileException&) {
+		// ignore
+	}
+}
+
+void FilePoolCore::prefetchSha1Sums(std::span<const std::string> filenames)
+{
+	ThreadPool::parallelForTemporary(filenames.size(), [&](size_t i) {
+		const auto& filename = filenames[i];
+		if (auto st = FileOperations::getStat(filename)) {
+			updateSha1(filename, FileOperations::getModificationDate(*st));
+		}
+	});
 }
 
 } // namespace openmsx
@@ -3,19 +3,24 @@
 
 #include "File.hh"
 #include "FileOperations.hh"
+#include "MappedFile.hh"
 
-#include "MemBuffer.hh"
 #include "ObjectPool.hh"
 #include "SimpleHashSet.hh"
 #include "sha1.hh"
 #include "xxhash.hh"
 
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <cstdint>
 #include <ctime>
 #include <functional>
+#include <mutex>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 namespace openmsx {
@@ -69,12 +74,32 @@ public:
 	 */
 	[[nodiscard]] Sha1Sum getSha1Sum(File& file, std::string_view filename);
 
+	/** Make sure the sha1sums of the given files are in the cache, so
+	 * that later getSha1Sum() calls for these files are cheap. Files
+	 * that are not yet (or no longer correctly) cached are hashed in
+	 * parallel. Non-existing files are ignored.
+	 */
+	void prefetchSha1Sums(std::span<const std::string> filenames);
+
 	/** This is only meaningful to call from within the 'reportProgress'
 	 * callback (constructor parameter). This will abort the current search
 	 * and cause getFile() to return a not-found result.
 	 */
 	void abort() { stop = true; }
 
+	/** (Re)index all files in the filepool directories in a background
+	 * thread: new or modified files get their sha1sum calculated. While
+	 * this is in progress, a getFile() that doesn't find the file in the
+	 * index first waits for the background thread, instead of scanning
+	 * the directories itself. Calling this again while a previous scan is
+	 * still in progress restarts that scan (e.g. because the directories
+	 * have changed).
+	 */
+	void indexInBackground();
+
+	/** Is a background scan (see above) in progress? */
+	[[nodiscard]] bool isIndexing() const;
+
 private:
 	struct ScanProgress {
 		uint64_t lastTime;
@@ -144,21 +169,37 @@ private:
 	bool adjustSha1(Index idx,              Entry& entry, const Sha1Sum& newSum);
 
 	void readSha1sums();
+	void readTextIndex(std::span<char> data);
+	void readBinaryIndex(std::span<const char> data);
 	void writeSha1sums();
 
-	[[nodiscard]] Result getFromPool(const Sha1Sum& sha1sum);
+	void stopIndexing();
+	void indexLoop();
+	void indexFile(const std::string& filename, time_t time);
+	void updateSha1(const std::string& filename, time_t time);
+	[[nodiscard]] bool waitForIndexing(std::unique_lock<std::mutex>& lock);
+
+	[[nodiscard]] Result getFromPool(std::unique_lock<std::mutex>& lock, const Sha1Sum& sha1sum);
 	[[nodiscard]] Result scanDirectory(
+		std::unique_lock<std::mutex>& lock,
 		const Sha1Sum& sha1sum,
 	        const std::string& directory,
 	        std::string_view poolPath,
 	        ScanProgress& progress);
 	[[nodiscard]] Result scanFile(
+		std::unique_lock<std::mutex>& lock,
 		const Sha1Sum& sha1sum,
 	        zstring_view filename,
 	        const FileOperations::Stat& st,
 	        std::string_view poolPath,
 	        ScanProgress& progress);
-	[[nodiscard]] Sha1Sum calcSha1sum(File& file, std::string_view filename) const;
+	[[nodiscard]] Sha1Sum calcSha1sum(File& file, std::string_view filename,
+	                                  bool showProgress = true) const;
+	Sha1Sum calcAndStoreSha1sum(std::unique_lock<std::mutex>& lock, File& file,
+	                            const std::string& filename, time_t time);
+	void storeSha1(const Sha1Sum& sum, time_t time, std::string_view filename);
+	void reportProgressUnlocked(std::unique_lock<std::mutex>& lock,
+	                            std::string_view message, float fraction);
 	[[nodiscard]] std::pair<Index, Entry*> findInDatabase(std::string_view filename);
 
 private:
@@ -166,7 +207,7 @@ private:
 	std::function<Directories()> getDirectories;
 	std::function<void(std::string_view, float)> reportProgress;
 
-	MemBuffer<char> fileMem; // content of initial .filecache
+	MappedFile<char> fileMem; // content of initial .filecache
 	std::vector<std::string> stringBuffer; // owns strings that are not in 'fileMem'
 
 	Pool pool; // the actual entries
@@ -176,6 +217,16 @@ private:
 	bool stop = false; // abort long search (set via reportProgress callback)
 	bool needWrite = false; // dirty '.filecache'? write on exit
 
+	// Background indexing. When the thread is running, all above members
+	// are protected by 'mutex' (the public methods take the lock).
+	mutable std::mutex mutex;
+	std::condition_variable indexCond; // signals end of background scan
+	std::vector<std::pair<std::string, FileType>> indexDirs; // copy, for the thread
+	std::thread indexThread;
+	std::atomic<bool> indexStop = false;
+	std::atomic<unsigned> indexedFiles = 0; // progress of the background scan
+	bool indexing = false; // protected by 'mutex'
+
 	friend struct GetSha1;
 };
 
@@ -1,9 +1,10 @@
 #include "GZFileAdapter.hh"
 
 #include "FileException.hh"
-#include "MappedFile.hh"
 #include "ZlibInflate.hh"
 
+#include "endian.hh"
+
 namespace openmsx {
 
 static constexpr uint8_t ASCII_FLAG  = 0x01; // bit 0 set: file probably ascii text
@@ -54,14 +55,19 @@ GZFileAdapter::GZFileAdapter(std::unique_ptr<FileBase> file_, zstring_view filen
 	return true;
 }
 
-void GZFileAdapter::decompress(FileBase& f, Decompressed& d)
+GZFileAdapter::DeflateStream GZFileAdapter::parseHeader(
+	std::span<const uint8_t> data, std::string& originalName)
 {
-	auto mmap = MappedFile<const uint8_t>(f.mmap(0, true));
-	ZlibInflate zlib(mmap);
-	if (!skipHeader(zlib, d.originalName)) {
+	ZlibInflate zlib(data);
+	if (!skipHeader(zlib, originalName)) {
 		throw FileException("Not a gzip header");
 	}
-	d.buf = zlib.inflate();
+	auto offset = data.size() - zlib.getRemainingInput().size();
+	// The trailer ends with the uncompressed size (modulo 2^32).
+	size_t size = (data.size() >= (offset + 8))
+	            ? Endian::read_UA_L32(&data[data.size() - 4])
+	            : 0;
+	return {offset, size};
 }
 
 } // namespace openmsx
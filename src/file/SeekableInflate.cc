@@ -0,0 +1,145 @@
+#include "SeekableInflate.hh"
+
+#include "FileException.hh"
+
+#include "ranges.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#define ZLIB_CONST
+#include <zlib.h>
+
+namespace openmsx {
+
+namespace {
+// Calls inflateEnd() when going out of scope.
+struct InflateStream {
+	InflateStream() {
+		if (int err = inflateInit2(&s, -MAX_WBITS); err != Z_OK) {
+			throw FileException("Error initializing inflate struct: ", zError(err));
+		}
+	}
+	InflateStream(const InflateStream&) = delete;
+	InflateStream(InflateStream&&) = delete;
+	InflateStream& operator=(const InflateStream&) = delete;
+	InflateStream& operator=(InflateStream&&) = delete;
+	~InflateStream() { inflateEnd(&s); }
+
+	z_stream s = {};
+};
+}
+
+SeekableInflate::SeekableInflate(std::span<const uint8_t> input_)
+	: input(input_)
+{
+	if (input.size() > std::numeric_limits<uInt>::max()) {
+		throw FileException("Error while decompressing: input file too big");
+	}
+
+	InflateStream stream;
+	auto& s = stream.s;
+	s.next_in = input.data();
+	s.avail_in = uInt(input.size());
+
+	// Decompress into a circular buffer, only the last 32kB of output is
+	// needed to create a checkpoint.
+	std::array<uint8_t, WINDOW_SIZE> window = {};
+	s.avail_out = 0;
+	checkpoints.push_back(Checkpoint{.outPos = 0, .inPos = 0, .bits = 0, .window = {}});
+	size_t lastCheckpoint = 0;
+	while (true) {
+		if (s.avail_out == 0) {
+			s.next_out = window.data();
+			s.avail_out = WINDOW_SIZE;
+		}
+		// Z_BLOCK: stop at each deflate block boundary
+		int err = ::inflate(&s, Z_BLOCK);
+		if (err == Z_STREAM_END) break;
+		if (err != Z_OK) {
+			throw FileException("Error decompressing: ", zError(err));
+		}
+		bool atBlockBoundary = (s.data_type & 128) && !(s.data_type & 64);
+		if (atBlockBoundary && ((s.total_out - lastCheckpoint) >= CHECKPOINT_DISTANCE)) {
+			auto& cp = checkpoints.emplace_back();
+			cp.outPos = s.total_out;
+			cp.inPos = s.total_in;
+			cp.bits = s.data_type & 7;
+			// unroll the circular buffer
+			auto used = WINDOW_SIZE - s.avail_out;
+			copy_to_range(subspan(window, used), cp.window);
+			copy_to_range(subspan(window, 0, used), subspan(cp.window, WINDOW_SIZE - used));
+			lastCheckpoint = s.total_out;
+		}
+	}
+	size = s.total_out;
+}
+
+const MemBuffer<uint8_t>& SeekableInflate::getChunk(size_t idx)
+{
+	++useCounter;
+	if (auto it = std::ranges::find(cache, idx, &CachedChunk::idx); it != cache.end()) {
+		it->lastUse = useCounter;
+		return it->data;
+	}
+	auto& entry = *std::ranges::min_element(cache, {}, &CachedChunk::lastUse);
+	entry.idx = size_t(-1); // in case of exceptions
+	inflateChunk(idx, entry.data);
+	entry.idx = idx;
+	entry.lastUse = useCounter;
+	return entry.data;
+}
+
+void SeekableInflate::inflateChunk(size_t idx, MemBuffer<uint8_t>& chunk)
+{
+	++numInflates;
+	const auto& cp = checkpoints[idx];
+	auto end = (idx + 1 < checkpoints.size()) ? checkpoints[idx + 1].outPos : size;
+	auto len = end - cp.outPos;
+	chunk.resize(len);
+
+	InflateStream stream;
+	auto& s = stream.s;
+	if (cp.bits) {
+		// Part of the previous byte still needs to be consumed.
+		assert(cp.inPos > 0);
+		inflatePrime(&s, cp.bits, input[cp.inPos - 1] >> (8 - cp.bits));
+	}
+	if (cp.outPos != 0) {
+		inflateSetDictionary(&s, cp.window.data(), WINDOW_SIZE);
+	}
+	s.next_in = input.data() + cp.inPos;
+	s.avail_in = uInt(input.size() - cp.inPos);
+	s.next_out = chunk.data();
+	s.avail_out = uInt(len);
+	while (s.avail_out != 0) {
+		int err = ::inflate(&s, Z_NO_FLUSH);
+		if (err == Z_STREAM_END) break;
+		if (err != Z_OK) {
+			throw FileException("Error decompressing: ", zError(err));
+		}
+	}
+	if (s.avail_out != 0) {
+		throw FileException("Error decompressing: unexpected end of stream");
+	}
+}
+
+void SeekableInflate::read(size_t pos, std::span<uint8_t> buffer)
+{
+	assert((pos + buffer.size()) <= size);
+	while (!buffer.empty()) {
+		auto it = std::ranges::upper_bound(checkpoints, pos, {}, &Checkpoint::outPos);
+		assert(it != checkpoints.begin());
+		auto idx = size_t(std::distance(checkpoints.begin(), it) - 1);
+		const auto& chunk = getChunk(idx);
+
+		auto offset = pos - checkpoints[idx].outPos;
+		auto num = std::min(buffer.size(), chunk.size() - offset);
+		copy_to_range(chunk.subspan(offset, num), buffer);
+		buffer = buffer.subspan(num);
+		pos += num;
+	}
+}
+
+} // namespace openmsx
@@ -0,0 +1,75 @@
+#ifndef SEEKABLEINFLATE_HH
+#define SEEKABLEINFLATE_HH
+
+#include "MemBuffer.hh"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace openmsx {
+
+/** Random access into a raw deflate stream, without keeping the whole
+  * decompressed data in memory.
+  *
+  * The constructor decompresses the stream once, and records a checkpoint
+  * (the position in both streams plus the last 32kB of output) roughly
+  * every CHECKPOINT_DISTANCE bytes. Later a read at an arbitrary position
+  * only needs to decompress from the nearest checkpoint. The few most
+  * recently used chunks (the data between two checkpoints) are kept, so
+  * sequential reads are cheap, and so is alternating between a few regions
+  * (e.g. a file system's directory and the data of a file).
+  *
+  * This is the same technique as in the 'zran.c' example of zlib.
+  */
+class SeekableInflate
+{
+public:
+	static constexpr size_t CHECKPOINT_DISTANCE = 1024 * 1024;
+	static constexpr size_t NUM_CACHED_CHUNKS = 4;
+
+	/** The input must remain valid for the lifetime of this object.
+	  * Throws FileException on invalid (or too big) input. */
+	explicit SeekableInflate(std::span<const uint8_t> input);
+
+	/** Size of the decompressed data. */
+	[[nodiscard]] size_t getSize() const { return size; }
+
+	/** Requires pos + buffer.size() <= getSize(). */
+	void read(size_t pos, std::span<uint8_t> buffer);
+
+	[[nodiscard]] size_t getNumCheckpoints() const { return checkpoints.size(); }
+	/** Number of times a chunk was decompressed (for tests). */
+	[[nodiscard]] size_t getNumInflates() const { return numInflates; }
+
+private:
+	static constexpr size_t WINDOW_SIZE = 32768;
+	struct Checkpoint {
+		size_t outPos; // position in the decompressed data
+		size_t inPos;  // position in the compressed data
+		int bits;      // number of bits of input[inPos - 1] that are not yet consumed
+		std::array<uint8_t, WINDOW_SIZE> window;
+	};
+
+	struct CachedChunk {
+		MemBuffer<uint8_t> data; // decompressed data of checkpoint 'idx'
+		size_t idx = size_t(-1); // -1 if not in use
+		uint64_t lastUse = 0;
+	};
+	[[nodiscard]] const MemBuffer<uint8_t>& getChunk(size_t idx);
+	void inflateChunk(size_t idx, MemBuffer<uint8_t>& chunk);
+
+private:
+	std::span<const uint8_t> input;
+	std::vector<Checkpoint> checkpoints; // sorted on 'outPos', at least 1 element
+	size_t size = 0;
+
+	std::array<CachedChunk, NUM_CACHED_CHUNKS> cache; // least recently used is replaced
+	uint64_t useCounter = 0;
+	size_t numInflates = 0;
+};
+
+} // namespace openmsx
+
+#endif
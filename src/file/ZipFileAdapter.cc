@@ -1,7 +1,6 @@
 #include "ZipFileAdapter.hh"
 
 #include "FileException.hh"
-#include "MappedFile.hh"
 #include "ZlibInflate.hh"
 
 namespace openmsx {
@@ -11,10 +10,10 @@ ZipFileAdapter::ZipFileAdapter(std::unique_ptr<FileBase> file_, zstring_view fil
 {
 }
 
-void ZipFileAdapter::decompress(FileBase& f, Decompressed& d)
+ZipFileAdapter::DeflateStream ZipFileAdapter::parseHeader(
+	std::span<const uint8_t> data, std::string& originalName)
 {
-	auto mmap = MappedFile<const uint8_t>(f.mmap(0, true));
-	ZlibInflate zlib(mmap);
+	ZlibInflate zlib(data);
 
 	if (zlib.get32LE() != 0x04034B50) {
 		throw FileException("Invalid ZIP file");
@@ -35,10 +34,10 @@ void ZipFileAdapter::decompress(FileBase& f, Decompressed& d)
 	unsigned origSize = zlib.get32LE(); // uncompressed size
 	unsigned filenameLen = zlib.get16LE(); // filename length
 	unsigned extraFieldLen = zlib.get16LE(); // extra field length
-	d.originalName = zlib.getString(filenameLen); // original filename
+	originalName = zlib.getString(filenameLen); // original filename
 	zlib.skip(extraFieldLen); // skip "extra field"
 
-	d.buf = zlib.inflate(origSize);
+	return {data.size() - zlib.getRemainingInput().size(), origSize};
 }
 
 } // namespace openmsx
@@ -11,7 +11,8 @@ public:
 	explicit ZipFileAdapter(std::unique_ptr<FileBase> file, zstring_view filename);
 
 private:
-	void decompress(FileBase& file, Decompressed& decompressed) override;
+	[[nodiscard]] DeflateStream parseHeader(
+		std::span<const uint8_t> data, std::string& originalName) override;
 };
 
 } // namespace openmsx
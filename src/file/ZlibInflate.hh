@@ -29,6 +29,11 @@ public:
 	[[nodiscard]] std::string getString(size_t len);
 	[[nodiscard]] std::string getCString();
 
+	/** The not yet consumed part of the input. */
+	[[nodiscard]] std::span<const uint8_t> getRemainingInput() const {
+		return {s.next_in, s.avail_in};
+	}
+
 	[[nodiscard]] MemBuffer<uint8_t> inflate(size_t sizeHint = 65536);
 
 private:
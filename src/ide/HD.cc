@@ -3,6 +3,8 @@
 #include "DeviceConfig.hh"
 #include "Display.hh"
 #include "FileContext.hh"
+#include "FileException.hh"
+#include "FileOperations.hh"
 #include "FilePool.hh"
 #include "GlobalSettings.hh"
 #include "HDImageCLI.hh"
@@ -12,16 +14,40 @@
 #include "Reactor.hh"
 #include "Timer.hh"
 
+#include "enumerate.hh"
 #include "narrow.hh"
 #include "serialize.hh"
+#include "strCat.hh"
 #include "tiger.hh"
+#include "xrange.hh"
+#include "xxhash.hh"
 
 #include <array>
 #include <cassert>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 namespace openmsx {
 
+// The leaf hashes of the tiger tree of a hard disk image are stored in the
+// user data directory, so that reopening an unmodified image (in a later
+// session) doesn't need to read and hash the full image again. Format (all
+// values in native byte order, the file is ignored if that doesn't match):
+//   header: magic (8 bytes), byte order mark (uint32), image size (uint64),
+//           modification time (int64), filename length (uint32),
+//           filename (not zero-terminated)
+//   leaf hashes: one TigerHash (24 bytes) per TigerTree::BLOCK_SIZE bytes
+static constexpr std::string_view TTH_MAGIC = "oMSXtth1";
+static constexpr uint32_t TTH_BYTE_ORDER_MARK = 0x01020304;
+static constexpr size_t TTH_HEADER_SIZE = 8 + 4 + 8 + 8 + 4; // excluding filename
+
+[[nodiscard]] static std::string getTigerTreeCacheName(std::string_view image)
+{
+	return strCat(FileOperations::getUserDataDir(), "/tthcache/",
+	              hex_string<8>(xxhash(image)));
+}
+
 std::shared_ptr<HD::HDInUse> HD::getDrivesInUse(MSXMotherBoard& motherBoard)
 {
 	return motherBoard.getSharedStuff<HDInUse>("hdInUse");
@@ -65,6 +91,8 @@ HD::HD(const DeviceConfig& config)
 		filesize = file.getSize();
 	}
 	tigerTree.emplace(*this, filesize, filename.getResolved());
+	loadTigerTreeCache();
+	enableReadAhead();
 
 	(*hdInUse)[id] = true;
 	hdCommand.emplace(
@@ -80,6 +108,7 @@ HD::HD(const DeviceConfig& config)
 
 HD::~HD()
 {
+	saveTigerTreeCache();
 	motherBoard.unregisterMediaProvider(*this);
 	motherBoard.getMSXCliComm().update(CliComm::UpdateType::HARDWARE, name, "remove");
 
@@ -104,10 +133,15 @@ void HD::setMedia(const TclObject& info, EmuTime /*time*/)
 
 void HD::switchImage(const Filename& newFilename)
 {
+	saveTigerTreeCache();
 	file = File(newFilename.getResolved());
 	filename = newFilename;
 	filesize = file.getSize();
+	overlay.clear();
+	flushCaches();
 	tigerTree.emplace(*this, filesize, filename.getResolved());
+	tigerTreeCacheInSync = false;
+	loadTigerTreeCache();
 	motherBoard.getMSXCliComm().update(CliComm::UpdateType::MEDIA, getName(),
 	                                   filename.getResolved());
 }
@@ -122,24 +156,91 @@ void HD::readSectorsImpl(
 {
 	file.seek(startSector * sizeof(SectorBuffer));
 	file.read(buffers);
+	if (!overlay.empty()) [[unlikely]] {
+		for (auto i : xrange(buffers.size())) {
+			if (const auto* buf = lookup(overlay, startSector + i)) {
+				buffers[i] = *buf;
+			}
+		}
+	}
 }
 
 void HD::writeSectorImpl(size_t sector, const SectorBuffer& buf)
 {
-	file.seek(sector * sizeof(buf));
-	file.write(buf.raw);
+	if (overlayEnabled) {
+		overlay.insert_or_assign(sector, buf);
+	} else {
+		file.seek(sector * sizeof(buf));
+		file.write(buf.raw);
+		tigerTreeCacheInSync = false;
+	}
 	tigerTree->notifyChange(sector * sizeof(buf), sizeof(buf),
 	                        file.getModificationDate());
 }
 
+void HD::writeSectorsImpl(std::span<const SectorBuffer> buffers, size_t startSector)
+{
+	// Same as above, but with a single seek+write (and a single tiger
+	// tree update) for the whole range.
+	if (overlayEnabled) {
+		for (auto [i, buf] : enumerate(buffers)) {
+			overlay.insert_or_assign(startSector + i, buf);
+		}
+	} else {
+		file.seek(startSector * sizeof(SectorBuffer));
+		file.write(buffers);
+		tigerTreeCacheInSync = false;
+	}
+	tigerTree->notifyChange(startSector * sizeof(SectorBuffer), buffers.size_bytes(),
+	                        file.getModificationDate());
+}
+
 bool HD::isWriteProtectedImpl() const
 {
-	return file.isReadOnly();
+	return !overlayEnabled && file.isReadOnly();
+}
+
+void HD::setOverlayEnabled(bool enabled)
+{
+	if (!enabled && !overlay.empty()) {
+		throw MSXException("The overlay of ", name, " still contains "
+		                   "changes, commit or discard them first.");
+	}
+	overlayEnabled = enabled;
+}
+
+void HD::commitOverlay()
+{
+	if (file.isReadOnly()) {
+		throw FileException("Image file is read-only: ", filename.getResolved());
+	}
+	for (const auto& [sector, buf] : overlay) {
+		file.seek(sector * sizeof(buf));
+		file.write(buf.raw);
+	}
+	tigerTreeCacheInSync = false;
+	// The content didn't change, but the modification date of the file
+	// did, inform the tiger tree about that.
+	for (const auto& [sector, buf] : overlay) {
+		tigerTree->notifyChange(sector * sizeof(buf), sizeof(buf),
+		                        file.getModificationDate());
+	}
+	overlay.clear();
+}
+
+void HD::discardOverlay()
+{
+	for (const auto& [sector, buf] : overlay) {
+		tigerTree->notifyChange(sector * sizeof(buf), sizeof(buf),
+		                        file.getModificationDate());
+	}
+	overlay.clear();
+	flushCaches(); // the visible content changed
 }
 
 Sha1Sum HD::getSha1SumImpl(FilePool& filePool)
 {
-	if (hasPatches()) {
+	if (hasPatches() || !overlay.empty()) {
 		return SectorAccessibleDisk::getSha1SumImpl(filePool);
 	}
 	return filePool.getSha1Sum(file, filename.getResolved());
@@ -191,6 +292,74 @@ uint8_t* HD::getData(size_t offset, size_t size)
 	return work.bufs[0].raw.data();
 }
 
+void HD::loadTigerTreeCache()
+{
+	if (tigerTree->allLeavesValid()) return; // already known in this session
+	if (hasPatches()) return; // hashes are calculated on the patched data
+	try {
+		const auto& image = filename.getResolved();
+		File cacheFile(getTigerTreeCacheName(image));
+		auto numLeaves = tigerTree->getNumLeaves();
+		if (cacheFile.getSize() != TTH_HEADER_SIZE + image.size() +
+		                           numLeaves * sizeof(TigerHash)) return;
+		std::vector<uint8_t> header(TTH_HEADER_SIZE + image.size());
+		cacheFile.read(std::span{header});
+
+		uint32_t bom, len;
+		uint64_t size;
+		int64_t time;
+		memcpy(&bom,  &header[8], 4);
+		memcpy(&size, &header[12], 8);
+		memcpy(&time, &header[20], 8);
+		memcpy(&len,  &header[28], 4);
+		std::string_view magic(reinterpret_cast<const char*>(header.data()), 8);
+		std::string_view name(reinterpret_cast<const char*>(&header[TTH_HEADER_SIZE]), image.size());
+		if ((magic != TTH_MAGIC) || (bom != TTH_BYTE_ORDER_MARK) ||
+		    (size != filesize) || (time_t(time) != file.getModificationDate()) ||
+		    (len != image.size()) || (name != image)) {
+			return; // stale, or belongs to a different image
+		}
+
+		std::vector<TigerHash> leaves(numLeaves);
+		cacheFile.read(std::span{leaves});
+		tigerTree->setLeafHashes(leaves);
+		tigerTreeCacheInSync = true;
+	} catch (FileException&) {
+		// no (usable) cache, the hashes will be calculated when needed
+	}
+}
+
+void HD::saveTigerTreeCache()
+{
+	if (tigerTreeCacheInSync || !overlay.empty() || hasPatches() ||
+	    !tigerTree->allLeavesValid()) return;
+	try {
+		const auto& image = filename.getResolved();
+		auto size = uint64_t(filesize);
+		auto time = int64_t(file.getModificationDate());
+		auto len = uint32_t(image.size());
+		std::vector<uint8_t> out(TTH_HEADER_SIZE + len +
+		                         tigerTree->getNumLeaves() * sizeof(TigerHash));
+		memcpy(&out[0],  TTH_MAGIC.data(), 8);
+		memcpy(&out[8],  &TTH_BYTE_ORDER_MARK, 4);
+		memcpy(&out[12], &size, 8);
+		memcpy(&out[20], &time, 8);
+		memcpy(&out[28], &len, 4);
+		memcpy(&out[TTH_HEADER_SIZE], image.data(), len);
+		tigerTree->getLeafHashes(std::span{
+			reinterpret_cast<TigerHash*>(&out[TTH_HEADER_SIZE + len]),
+			tigerTree->getNumLeaves()});
+
+		auto cacheName = getTigerTreeCacheName(image);
+		FileOperations::mkdirp(std::string(FileOperations::getDirName(cacheName)));
+		File cacheFile(cacheName, File::OpenMode::TRUNCATE);
+		cacheFile.write(std::span{out});
+		tigerTreeCacheInSync = true;
+	} catch (FileException&) {
+		// ignore, only means the hashes must be recalculated next time
+	}
+}
+
 bool HD::isCacheStillValid(time_t& cacheTime)
 {
 	time_t fileTime = file.getModificationDate();
@@ -11,6 +11,7 @@
 #include "serialize_meta.hh"
 
 #include "TigerTree.hh"
+#include "hash_map.hh"
 
 #include <bitset>
 #include <optional>
@@ -38,6 +39,23 @@ public:
 
 	[[nodiscard]] std::string getTigerTreeHash();
 
+	/** When the overlay is enabled, written sectors are kept in memory
+	  * instead of being written to the image file. So the image file
+	  * itself stays unmodified (it may even be read-only), until the
+	  * changes are explicitly committed. Changing the image file discards
+	  * the overlay content.
+	  */
+	[[nodiscard]] bool isOverlayEnabled() const { return overlayEnabled; }
+	/** Number of sectors that are modified in the overlay. */
+	[[nodiscard]] size_t getOverlaySize() const { return overlay.size(); }
+	/** Throws MSXException when disabling while the overlay still
+	  * contains changes. */
+	void setOverlayEnabled(bool enabled);
+	/** Write the overlay content to the image file and clear the
+	  * overlay. Throws FileException on error (e.g. read-only file). */
+	void commitOverlay();
+	void discardOverlay();
+
 	// MediaInfoProvider
 	void getMediaInfo(TclObject& result) override;
 	void setMedia(const TclObject& info, EmuTime time) override;
@@ -52,6 +70,7 @@ private:
 	void readSectorsImpl(
 		std::span<SectorBuffer> buffers, size_t startSector) override;
 	void writeSectorImpl(size_t sector, const SectorBuffer& buf) override;
+	void writeSectorsImpl(std::span<const SectorBuffer> buffers, size_t startSector) override;
 	[[nodiscard]] size_t getNbSectorsImpl() override;
 	[[nodiscard]] bool isWriteProtectedImpl() const override;
 	[[nodiscard]] Sha1Sum getSha1SumImpl(FilePool& filePool) override;
@@ -68,6 +87,9 @@ private:
 
 	void showProgress(size_t position, size_t maxPosition);
 
+	void loadTigerTreeCache();
+	void saveTigerTreeCache();
+
 private:
 	MSXMotherBoard& motherBoard;
 	std::string name;
@@ -80,6 +102,11 @@ private:
 
 	std::shared_ptr<HDInUse> hdInUse;
 
+	hash_map<size_t, SectorBuffer> overlay; // sector number -> content
+	bool overlayEnabled = false;
+	// Is the persisted copy of the tiger tree leaf hashes (still) in sync?
+	bool tigerTreeCacheInSync = false;
+
 	uint64_t lastProgressTime;
 	bool everDidProgress;
 };
@@ -8,6 +8,8 @@
 #include "FileException.hh"
 #include "TclObject.hh"
 
+#include "narrow.hh"
+
 #include <array>
 
 namespace openmsx {
@@ -36,6 +38,8 @@ void HDCommand::execute(std::span<const TclObject> tokens, TclObject& result,
 			TclObject options = makeTclList("readonly");
 			result.addListElement(options);
 		}
+	} else if (tokens[1] == "overlay") {
+		executeOverlay(tokens, result);
 	} else if ((tokens.size() == 2) ||
 	           ((tokens.size() == 3) && tokens[1] == "insert")) {
 		if (powerSetting.getBoolean()) {
@@ -68,15 +72,55 @@ void HDCommand::execute(std::span<const TclObject> tokens, TclObject& result,
 	}
 }
 
+void HDCommand::executeOverlay(std::span<const TclObject> tokens, TclObject& result)
+{
+	if (tokens.size() == 2) {
+		result.addDictKeyValues("enabled", hd.isOverlayEnabled(),
+		                        "sectors", narrow<int>(hd.getOverlaySize()));
+		return;
+	}
+	if (tokens.size() != 3) {
+		throw CommandException("Too many or wrong arguments.");
+	}
+	const auto& subCmd = tokens[2].getString();
+	try {
+		if (subCmd == "on") {
+			hd.setOverlayEnabled(true);
+		} else if (subCmd == "off") {
+			hd.setOverlayEnabled(false);
+		} else if (subCmd == "commit") {
+			hd.commitOverlay();
+		} else if (subCmd == "discard") {
+			if (powerSetting.getBoolean()) {
+				throw CommandException(
+					"Can only discard the overlay when MSX "
+					"is powered down.");
+			}
+			hd.discardOverlay();
+		} else {
+			throw CommandException("Unknown overlay subcommand: ", subCmd);
+		}
+	} catch (MSXException& e) {
+		throw CommandException(std::move(e).getMessage());
+	}
+}
+
 std::string HDCommand::help(std::span<const TclObject> /*tokens*/) const
 {
-	return hd.getName() + ": change the hard disk image for this hard disk drive\n";
+	return hd.getName() + ": change the hard disk image for this hard disk drive\n" +
+	       hd.getName() + " overlay [on|off|commit|discard]: keep written sectors\n"
+	       "  in memory instead of writing them to the image file\n";
 }
 
 void HDCommand::tabCompletion(std::vector<std::string>& tokens) const
 {
 	using namespace std::literals;
-	static constexpr std::array extra = {"insert"sv};
+	if ((tokens.size() == 3) && (tokens[1] == "overlay")) {
+		static constexpr std::array subCmds = {"on"sv, "off"sv, "commit"sv, "discard"sv};
+		completeString(tokens, subCmds);
+		return;
+	}
+	static constexpr std::array extra = {"insert"sv, "overlay"sv};
 	completeFileName(tokens, userFileContext(),
 		(tokens.size() < 3) ? extra : std::span<const std::string_view>{});
 
@@ -84,6 +128,8 @@ void HDCommand::tabCompletion(std::vector<std::string>& tokens) const
 
 bool HDCommand::needRecord(std::span<const TclObject> tokens) const
 {
+	// Querying the overlay state doesn't change anything.
+	if ((tokens.size() == 2) && (tokens[1] == "overlay")) return false;
 	return tokens.size() > 1;
 }
 
@@ -25,6 +25,9 @@ public:
 	[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
 	void tabCompletion(std::vector<std::string>& tokens) const override;
 	[[nodiscard]] bool needRecord(std::span<const TclObject> tokens) const override;
+private:
+	void executeOverlay(std::span<const TclObject> tokens, TclObject& result);
+
 private:
 	HD& hd;
 	const BooleanSetting& powerSetting;
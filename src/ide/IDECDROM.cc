@@ -122,8 +122,7 @@ unsigned IDECDROM::readBlockStart(AlignedBuffer& buf, unsigned count)
 	assert(readSectorData);
 	if (file.is_open()) {
 		//fprintf(stderr, "read sector data at %08X\n", transferOffset);
-		file.seek(transferOffset);
-		file.read(std::span{buf.data(), count});
+		readData(transferOffset, std::span{buf.data(), count});
 		transferOffset += count;
 		return count;
 	} else {
@@ -134,6 +133,37 @@ unsigned IDECDROM::readBlockStart(AlignedBuffer& buf, unsigned count)
 	}
 }
 
+void IDECDROM::readData(size_t offset, std::span<uint8_t> dst)
+{
+	// A data transfer is split in blocks of (at most) 'byteCountLimit'
+	// bytes. Instead of doing a seek+read on the image for each block, read
+	// a larger chunk at once and serve the following blocks from that.
+	if ((readAheadStart <= offset) &&
+	    ((offset + dst.size()) <= (readAheadStart + readAheadBuf.size()))) {
+		std::ranges::copy(std::span{readAheadBuf}.subspan(offset - readAheadStart, dst.size()),
+		                  dst.begin());
+		return;
+	}
+	auto size = file.getSize();
+	if ((offset + dst.size()) > size) {
+		// Let File report the error.
+		file.seek(offset);
+		file.read(dst);
+		return;
+	}
+	auto num = std::min<size_t>(std::max(dst.size(), READ_AHEAD_SIZE), size - offset);
+	readAheadBuf.resize(num);
+	readAheadStart = offset;
+	try {
+		file.seek(offset);
+		file.read(readAheadBuf);
+	} catch (...) {
+		readAheadBuf.clear();
+		throw;
+	}
+	std::ranges::copy(std::span{readAheadBuf}.first(dst.size()), dst.begin());
+}
+
 void IDECDROM::readEnd()
 {
 	setInterruptReason(I_O | C_D);
@@ -322,6 +352,7 @@ void IDECDROM::eject()
 {
 	file.close();
 	filename.clear();
+	readAheadBuf.clear();
 	mediaChanged = true;
 	senseKey = 0x06 << 16; // unit attention (medium changed)
 	getMotherBoard().getMSXCliComm().update(CliComm::UpdateType::MEDIA, name, {});
@@ -331,6 +362,7 @@ void IDECDROM::insert(zstring_view fname)
 {
 	file = File(fname);
 	filename = fname;
+	readAheadBuf.clear();
 	mediaChanged = true;
 	senseKey = 0x06 << 16; // unit attention (medium changed)
 	getMotherBoard().getMSXCliComm().update(CliComm::UpdateType::MEDIA, name, filename);
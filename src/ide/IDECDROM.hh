@@ -10,6 +10,8 @@
 #include <bitset>
 #include <memory>
 #include <optional>
+#include <span>
+#include <vector>
 
 namespace openmsx {
 
@@ -81,6 +83,9 @@ private:
 
 	void executePacketCommand(AlignedBuffer& packet);
 
+	/** Read from the CD image, using (and refilling) the read-ahead buffer. */
+	void readData(size_t offset, std::span<uint8_t> dst);
+
 	std::string name;
 	std::optional<CDXCommand> cdxCommand; // delayed init
 	File file;
@@ -88,6 +93,11 @@ private:
 	unsigned byteCountLimit;
 	unsigned transferOffset;
 
+	// Read-ahead buffer, see readData(). Cleared when the medium changes.
+	static constexpr size_t READ_AHEAD_SIZE = 64 * 1024;
+	std::vector<uint8_t> readAheadBuf;
+	size_t readAheadStart = 0;
+
 	unsigned senseKey;
 
 	bool readSectorData;
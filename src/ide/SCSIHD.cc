@@ -277,12 +277,10 @@ unsigned SCSIHD::readSectors(unsigned& blocks)
 	unsigned counter = currentLength * SECTOR_SIZE;
 
 	try {
-		for (auto i : xrange(numSectors)) {
-			auto* sbuf = aligned_cast<SectorBuffer*>(buffer);
-			readSector(currentSector, sbuf[i]);
-			++currentSector;
-			--currentLength;
-		}
+		auto* sbuf = aligned_cast<SectorBuffer*>(buffer);
+		SectorAccessibleDisk::readSectors(std::span{sbuf, numSectors}, currentSector);
+		currentSector += numSectors;
+		currentLength -= numSectors;
 		blocks = currentLength;
 		return counter;
 	} catch (MSXException&) {
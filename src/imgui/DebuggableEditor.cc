@@ -582,11 +582,22 @@ void DebuggableEditor::drawContents(const Sizes& s, Debuggable& debuggable, unsi
 	auto changedColor = debugger->getChangesColor();
 	auto greyColor = getColor(imColor::TEXT_DISABLED);
 
+	bool searchAll = searchPattern && (searchHighlight == static_cast<int>(SearchHighlight::ALL));
+	auto searchLen = searchAll ? narrow<unsigned>(searchPattern->size()) : 0u;
+
 	const auto totalLineCount = int((memSize + columns - 1) / columns);
 	im::ListClipper(totalLineCount, -1, s.lineHeight, [&](int line) {
 		auto addr = unsigned(line) * columns;
 		ImGui::StrCat(formatAddr(s, addr), ':');
 
+		// Fetch the bytes of this line with a single readBlock() call,
+		// including the surrounding bytes that a search match can span.
+		auto dataStart = addr - std::min(addr, searchLen);
+		auto dataEnd = std::min(addr + unsigned(columns) + searchLen, memSize);
+		lineData.resize(dataEnd - dataStart);
+		debuggable.readBlock(dataStart, lineData);
+		auto peek = [&](unsigned a) { return lineData[a - dataStart]; };
+
 		auto previewDataTypeSize = DataTypeGetSize(previewDataType);
 		auto inside = [](unsigned a, unsigned start, unsigned size) {
 			return (start <= a) && (a < (start + size));
@@ -601,10 +612,10 @@ void DebuggableEditor::drawContents(const Sizes& s, Debuggable& debuggable, unsi
 				if (searchResult) {
 					return inside(a, *searchResult, len);
 				}
-			} else if (searchHighlight == static_cast<int>(SearchHighlight::ALL)) {
-				int start = std::max(0, int(a - len + 1));
+			} else if (searchAll) {
+				int start = std::max(int(dataStart), int(a - len + 1));
 				for (unsigned i = start; i <= a; ++i) {
-					if (match(debuggable, memSize, i)) return true;
+					if (match(lineData, i - dataStart)) return true;
 				}
 			}
 			return false;
@@ -655,7 +666,7 @@ void DebuggableEditor::drawContents(const Sizes& s, Debuggable& debuggable, unsi
 					},
 					ImGuiInputTextFlags_CharsHexadecimal);
 			} else {
-				uint8_t b = debuggable.read(addr);
+				uint8_t b = peek(addr);
 				bool changed = drawChanges && (b != snapshot[addr]);
 				bool grey = (b == 0) && greyOutZeroes;
 				im::StyleColor(changed || grey, ImGuiCol_Text, changed ? changedColor : greyColor, [&]{
@@ -707,7 +718,7 @@ void DebuggableEditor::drawContents(const Sizes& s, Debuggable& debuggable, unsi
 							return b;
 						});
 				} else {
-					uint8_t c = debuggable.read(addr);
+					uint8_t c = peek(addr);
 					bool changed = drawChanges && (c != snapshot[addr]);
 					char display = formatAsciiData(c);
 					bool grey = display != char(c);
@@ -995,21 +1006,22 @@ void DebuggableEditor::drawSearch(const Sizes& s, Debuggable& debuggable, unsign
 	ImGui::Combo("##search_highlight", &searchHighlight, "None\0Single\0All\0\0");
 }
 
-bool DebuggableEditor::match(Debuggable& debuggable, unsigned memSize, unsigned addr)
+bool DebuggableEditor::match(std::span<const uint8_t> data, size_t offset) const
 {
 	assert(searchPattern);
-	if ((addr + searchPattern->size()) > memSize) return false;
-	for (auto [i, c] : enumerate(*searchPattern)) {
-		if (debuggable.read(narrow<unsigned>(addr + i)) != c) return false;
-	}
-	return true;
+	if ((offset + searchPattern->size()) > data.size()) return false;
+	return std::ranges::equal(data.subspan(offset, searchPattern->size()), *searchPattern);
 }
 
 void DebuggableEditor::search(const Sizes& s, Debuggable& debuggable, unsigned memSize)
 {
+	// Read the whole debuggable once, instead of byte per byte while searching.
+	std::vector<uint8_t> data(memSize);
+	debuggable.readBlock(0, data);
+
 	std::optional<unsigned> found;
 	auto test = [&](unsigned addr) {
-		if (match(debuggable, memSize, addr)) {
+		if (match(data, addr)) {
 			found = addr;
 			return true;
 		}
@@ -66,7 +66,7 @@ private:
 	void drawSearch(const Sizes& s, Debuggable& debuggable, unsigned memSize);
 	void parseSearchString(std::string_view str);
 	void search(const Sizes& s, Debuggable& debuggable, unsigned memSize);
-	[[nodiscard]] bool match(Debuggable& debuggable, unsigned memSize, unsigned addr);
+	[[nodiscard]] bool match(std::span<const uint8_t> data, size_t offset) const;
 	void drawPreviewLine(const Sizes& s, Debuggable& debuggable, unsigned memSize);
 
 private:
@@ -151,6 +151,7 @@ private:
 	bool resetCursor = false;
 
 	std::vector<uint8_t> snapshot;
+	std::vector<uint8_t> lineData; // visible bytes of the line being drawn
 };
 
 } // namespace openmsx
@@ -357,15 +357,30 @@ void ImGuiBitmapViewer::paint(MSXMotherBoard* motherBoard)
 		auto palette = manager.palette->getPalette(vdp);
 		if (color0 < 16) palette[0] = palette[color0];
 
-		MemBuffer<uint32_t> pixels(512 * 256 * 4); // max size: screen 6/7, show all pages
-		renderBitmap(vram.getData(), palette, mode, height, page,
-				pixels.data());
+		// Re-render only when the relevant part of VRAM was written to
+		// (or when some parameter changed), otherwise reuse the texture.
+		BitmapKey key{std::string(motherBoard->getMachineID()), mode, page, height, palette};
+		bool planar = mode != one_of(SCR5, SCR6);
+		auto vramDirty = [&] {
+			const auto& dirty = vram.getDirtyPages();
+			size_t begin = 0x8000 * page;
+			size_t num = 128 * height;
+			return dirty.isRangeDirty(begin, num, bitmapEpoch) ||
+			       (planar && dirty.isRangeDirty(begin + 0x10000, num, bitmapEpoch));
+		};
 		if (!bitmapTex) {
 			bitmapTex.emplace(false, false); // no interpolation, no wrapping
 		}
-		bitmapTex->bind();
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0,
-				GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		if (key != bitmapKey || vramDirty()) {
+			MemBuffer<uint32_t> pixels(512 * 256 * 4); // max size: screen 6/7, show all pages
+			renderBitmap(vram.getData(), palette, mode, height, page,
+					pixels.data());
+			bitmapTex->bind();
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0,
+					GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+			bitmapKey = std::move(key);
+			bitmapEpoch = vdp->getVRAM().getDirtyPages().checkpoint();
+		}
 		int zx = (1 + bitmapZoom) * divX;
 		int zy = (1 + bitmapZoom) * 2;
 		auto zm = gl::vec2(float(zx), float(zy));
@@ -382,18 +397,22 @@ void ImGuiBitmapViewer::paint(MSXMotherBoard* motherBoard)
 
 			if (bitmapGrid && (zx > 1) && (zy > 1)) {
 				auto color = ImGui::ColorConvertFloat4ToU32(bitmapGridColor);
-				for (auto y : xrange(zy)) {
-					auto* line = &pixels[y * zx];
-					for (auto x : xrange(zx)) {
-						line[x] = (x == 0 || y == 0) ? color : 0;
-					}
-				}
 				if (!bitmapGridTex) {
 					bitmapGridTex.emplace(false, true); // no interpolation, with wrapping
 				}
-				bitmapGridTex->bind();
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, zx, zy, 0,
-						GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+				if (GridKey gKey{zx, zy, color}; gKey != gridKey) {
+					std::array<uint32_t, 16 * 16> pixels; // max zoom 8x (x2 for narrow pixels)
+					for (auto y : xrange(zy)) {
+						auto* line = &pixels[y * zx];
+						for (auto x : xrange(zx)) {
+							line[x] = (x == 0 || y == 0) ? color : 0;
+						}
+					}
+					bitmapGridTex->bind();
+					glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, zx, zy, 0,
+							GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+					gridKey = gKey;
+				}
 				ImGui::SetCursorPos(pos);
 				ImGui::Image(bitmapGridTex->getImGui(), size, gl::vec2{}, msxSize);
 			}
@@ -6,6 +6,9 @@
 #include "GLUtil.hh"
 #include "gl_vec.hh"
 
+#include "DirtyPages.hh"
+
+#include <array>
 #include <cstdint>
 #include <optional>
 #include <span>
@@ -54,6 +57,22 @@ private:
 	std::optional<gl::Texture> bitmapTex; // TODO also deallocate when needed
 	std::optional<gl::Texture> bitmapGridTex;
 
+	// Only re-render and re-upload the textures when something changed.
+	struct BitmapKey {
+		std::string machineID; // VRAM dirty epochs are per machine
+		int mode, page, height;
+		std::array<uint32_t, 16> palette;
+		bool operator==(const BitmapKey&) const = default;
+	};
+	std::optional<BitmapKey> bitmapKey;
+	DirtyPages::Epoch bitmapEpoch = 0;
+	struct GridKey {
+		int zx, zy;
+		uint32_t color;
+		bool operator==(const GridKey&) const = default;
+	};
+	std::optional<GridKey> gridKey;
+
 	int showCmdOverlay = 0; // 0->none, 1->in-progress, 2->also finished
 	gl::vec4 colorSrcDone{0.0f, 1.0f, 0.0f, 0.66f};
 	gl::vec4 colorSrcTodo{0.0f, 1.0f, 0.0f, 0.33f};
@@ -382,13 +382,26 @@ void ImGuiCharacter::paint(MSXMotherBoard* motherBoard)
 			return {256,  64}; // SCR1, OTHER
 		}();
 		std::array<uint32_t, 256 * 256> pixels; // max size for SCR2
-		renderPatterns(mode, palette, fgCol, bgCol, fgBlink, bgBlink, patTable, colTable, lines, pixels);
+		setIndexSizes(mode, patTable, colTable);
+		PatternKey key{std::string(motherBoard->getMachineID()), mode, lines, patReg, colReg,
+		               fgCol, bgCol, fgBlink, bgBlink,
+		               overrideColorTable ? std::optional(colorTabVal) : std::nullopt,
+		               palette};
+		auto& dirtyPages = vdp->getVRAM().getDirtyPages();
+		bool usesColTable = (mode == one_of(SCR1, SCR2)) && !overrideColorTable;
 		if (!patternTex.get()) {
 			patternTex = gl::Texture(false, false); // no interpolation, no wrapping
 		}
-		patternTex.bind();
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, patternTexSize.x, patternTexSize.y, 0,
-			GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		if (key != patternKey ||
+		    patTable.isDirty(dirtyPages, patternEpoch) ||
+		    (usesColTable && colTable.isDirty(dirtyPages, patternEpoch))) {
+			renderPatterns(mode, palette, fgCol, bgCol, fgBlink, bgBlink, patTable, colTable, lines, pixels);
+			patternTex.bind();
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, patternTexSize.x, patternTexSize.y, 0,
+				GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+			patternKey = std::move(key);
+			patternEpoch = dirtyPages.checkpoint();
+		}
 
 		// create grid texture
 		auto charWidth = mode == one_of(TEXT40, TEXT80) ? 6 : 8;
@@ -652,15 +665,38 @@ static void draw8(uint8_t pattern, uint32_t fgCol, uint32_t bgCol, std::span<uin
 	out[7] = (pattern & 0x01) ? fgCol : bgCol;
 }
 
+void ImGuiCharacter::setIndexSizes(int mode, VramTable& pat, VramTable& col)
+{
+	switch (mode) {
+	case TEXT40:
+	case TEXT80:
+		pat.setIndexSize(11);
+		col.setIndexSize(9); // only matters for TEXT80
+		break;
+	case SCR1:
+		pat.setIndexSize(11);
+		col.setIndexSize(6);
+		break;
+	case SCR2:
+		pat.setIndexSize(13);
+		col.setIndexSize(13);
+		break;
+	case SCR3:
+		pat.setIndexSize(11);
+		col.setIndexSize(13); // not used?
+		break;
+	default:
+		break;
+	}
+}
+
 void ImGuiCharacter::renderPatterns(int mode, std::span<const uint32_t, 16> palette,
                                     int fgCol, int bgCol, int fgBlink, int bgBlink,
-                                    VramTable& pat, VramTable& col, int lines, std::span<uint32_t> output)
+                                    const VramTable& pat, const VramTable& col, int lines, std::span<uint32_t> output)
 {
 	switch (mode) {
 	case TEXT40:
 	case TEXT80: {
-		pat.setIndexSize(11);
-		col.setIndexSize(9); // only matters for TEXT80
 		auto fg = palette[fgCol];
 		auto bg = palette[bgCol];
 		auto fgB = palette[fgBlink];
@@ -683,8 +719,6 @@ void ImGuiCharacter::renderPatterns(int mode, std::span<const uint32_t, 16> pale
 		break;
 	}
 	case SCR1:
-		pat.setIndexSize(11);
-		col.setIndexSize(6);
 		for (auto row : xrange(8)) {
 			for (auto group : xrange(4)) { // 32 columns, split in 4 groups of 8
 				auto color = col[4 * row + group];
@@ -704,8 +738,6 @@ void ImGuiCharacter::renderPatterns(int mode, std::span<const uint32_t, 16> pale
 		}
 		break;
 	case SCR2:
-		pat.setIndexSize(13);
-		col.setIndexSize(13);
 		for (auto row : xrange((lines == 192 ? 3 : 4) * 8)) {
 			for (auto column : xrange(32)) {
 				auto patNum = 32 * row + column;
@@ -722,8 +754,6 @@ void ImGuiCharacter::renderPatterns(int mode, std::span<const uint32_t, 16> pale
 		}
 		break;
 	case SCR3:
-		pat.setIndexSize(11);
-		col.setIndexSize(13); // not used?
 		for (auto group : xrange(4)) {
 			for (auto row : xrange(8)) {
 				for (auto column : xrange(32)) {
@@ -6,6 +6,11 @@
 #include "GLUtil.hh"
 #include "gl_vec.hh"
 
+#include "DirtyPages.hh"
+
+#include <array>
+#include <cstdint>
+#include <optional>
 #include <string>
 
 namespace openmsx {
@@ -21,9 +26,10 @@ public:
 	void paint(MSXMotherBoard* motherBoard) override;
 
 private:
+	static void setIndexSizes(int mode, VramTable& pat, VramTable& col);
 	static void renderPatterns(int mode, std::span<const uint32_t, 16> palette,
 	                           int fgCol, int bgCol, int fgBlink, int bgBlink,
-	                           VramTable& pat, VramTable& col, int lines, std::span<uint32_t> output);
+	                           const VramTable& pat, const VramTable& col, int lines, std::span<uint32_t> output);
 	void initHexDigits();
 
 public:
@@ -71,6 +77,20 @@ private:
 	gl::Texture gridTex   {gl::Null{}};
 	gl::Texture smallHexDigits{gl::Null{}};
 
+	// Only re-render the pattern texture when the pattern or color table
+	// in VRAM was written to or when some parameter changed.
+	struct PatternKey {
+		std::string machineID; // VRAM dirty epochs are per machine
+		int mode, lines;
+		unsigned patReg, colReg;
+		int fgCol, bgCol, fgBlink, bgBlink;
+		std::optional<uint8_t> colorTabVal;
+		std::array<uint32_t, 16> palette;
+		bool operator==(const PatternKey&) const = default;
+	};
+	std::optional<PatternKey> patternKey;
+	DirtyPages::Epoch patternEpoch = 0;
+
 	static constexpr auto persistentElements = std::tuple{
 		PersistentElement   {"show",            &ImGuiCharacter::show},
 		PersistentElement   {"overrideAll",     &ImGuiCharacter::overrideAll},
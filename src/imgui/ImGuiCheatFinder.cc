@@ -4,28 +4,45 @@
 #include "ImGuiManager.hh"
 #include "ImGuiUtils.hh"
 
+#include "Debuggable.hh"
+#include "Debugger.hh"
+#include "MSXMotherBoard.hh"
+
+#include "StringOp.hh"
 #include "narrow.hh"
 #include "stl.hh"
 
+#include <algorithm>
+#include <optional>
 #include <ranges>
 
 namespace openmsx {
 
 using namespace std::literals;
 
-void ImGuiCheatFinder::paint(MSXMotherBoard* /*motherBoard*/)
+void ImGuiCheatFinder::paint(MSXMotherBoard* motherBoard)
 {
 	if (!show) return;
 
+	auto* debugger = motherBoard ? &motherBoard->getDebugger() : nullptr;
+	auto* finder = debugger ? &debugger->getCheatFinder() : nullptr;
+	if (!finder || !finder->isStarted()) {
+		searchResults.clear();
+	} else if (searchResults.size() != finder->getNumCandidates()) {
+		// e.g. narrowed down via the 'debug cheat_finder' command
+		searchResults = finder->getResults();
+	}
+
 	bool start = false;
-	std::string searchExpr;
+	std::optional<CheatFinder::Compare> searchOp;
+	std::optional<uint8_t> searchWith;
 
 	ImGui::SetNextWindowSize(gl::vec2{35, 0} * ImGui::GetFontSize(), ImGuiCond_FirstUseEver);
 	im::Window("Cheat Finder", &show, [&]{
 		const auto& style = ImGui::GetStyle();
 		auto tSize = ImGui::CalcTextSize("=="sv).x + 2.0f * style.FramePadding.x;
 		auto bSpacing = 2.0f;
-		auto height = 12.5f * ImGui::GetTextLineHeightWithSpacing();
+		auto height = 14.0f * ImGui::GetTextLineHeightWithSpacing();
 		auto sWidth = 2.0f * (style.WindowBorderSize + style.WindowPadding.x)
 		              + style.IndentSpacing + 6 * tSize + 5 * bSpacing;
 		im::Child("search", {sWidth, height}, ImGuiChildFlags_Borders, [&]{
@@ -34,26 +51,40 @@ void ImGuiCheatFinder::paint(MSXMotherBoard* /*motherBoard*/)
 			           "  openMSX tutorial: Working with the Cheat Finder\n"
 			           "  http://www.youtube.com/watch?v=F11ltfkCtKo\n"
 			           "The UI has changed, but the ideas remain the same.");
+			ImGui::SetNextItemWidth(-FLT_MIN);
+			im::Combo("##debuggable", debuggableName.c_str(), [&]{
+				if (!debugger) return;
+				auto names = to_vector(std::views::keys(debugger->getDebuggables()));
+				std::ranges::sort(names, StringOp::caseless{});
+				for (const auto& name : names) {
+					if (ImGui::Selectable(name.c_str(), name == debuggableName)) {
+						debuggableName = name;
+						start = true;
+					}
+				}
+			});
+			simpleToolTip("Search in this debuggable, e.g. 'memory' is what the CPU currently sees, "
+			              "'memory mapper' is all RAM of the memory mapper");
 			im::Disabled(searchResults.empty(), [&]{
 				ImGui::TextUnformatted("Compare"sv);
 				im::Indent([&]{
 					auto bSize = ImVec2{tSize, 0.0f};
-					if (ImGui::Button("<",  bSize)) searchExpr = "$new < $old";
+					if (ImGui::Button("<",  bSize)) searchOp = CheatFinder::Compare::LESS;
 					simpleToolTip("Search for memory locations with strictly decreased value");
 					ImGui::SameLine(0.0f, bSpacing);
-					if (ImGui::Button("<=", bSize)) searchExpr = "$new <= $old";
+					if (ImGui::Button("<=", bSize)) searchOp = CheatFinder::Compare::LESS_EQUAL;
 					simpleToolTip("Search for memory locations with decreased value");
 					ImGui::SameLine(0.0f, bSpacing);
-					if (ImGui::Button("!=", bSize)) searchExpr = "$new != $old";
+					if (ImGui::Button("!=", bSize)) searchOp = CheatFinder::Compare::NOT_EQUAL;
 					simpleToolTip("Search for memory locations with changed value");
 					ImGui::SameLine(0.0f, bSpacing);
-					if (ImGui::Button("==", bSize)) searchExpr = "$new == $old";
+					if (ImGui::Button("==", bSize)) searchOp = CheatFinder::Compare::EQUAL;
 					simpleToolTip("Search for memory locations with unchanged value");
 					ImGui::SameLine(0.0f, bSpacing);
-					if (ImGui::Button(">=", bSize)) searchExpr = "$new >= $old";
+					if (ImGui::Button(">=", bSize)) searchOp = CheatFinder::Compare::GREATER_EQUAL;
 					simpleToolTip("Search for memory locations with increased value");
 					ImGui::SameLine(0.0f, bSpacing);
-					if (ImGui::Button(">",  bSize)) searchExpr = "$new > $old";
+					if (ImGui::Button(">",  bSize)) searchOp = CheatFinder::Compare::GREATER;
 					simpleToolTip("Search for memory locations with strictly increased value");
 				});
 				ImGui::TextUnformatted("Specific value"sv);
@@ -62,7 +93,8 @@ void ImGuiCheatFinder::paint(MSXMotherBoard* /*motherBoard*/)
 					ImGui::InputScalar("##value", ImGuiDataType_U8, &searchValue);
 					ImGui::SameLine();
 					if (ImGui::Button("Go")) {
-						searchExpr = strCat("$new == ", searchValue);
+						searchOp = CheatFinder::Compare::EQUAL;
+						searchWith = searchValue;
 					}
 					simpleToolTip("Search for memory locations with a specific value");
 				});
@@ -86,6 +118,7 @@ void ImGuiCheatFinder::paint(MSXMotherBoard* /*motherBoard*/)
 				            ImGuiTableFlags_BordersV |
 				            ImGuiTableFlags_BordersOuter |
 				            ImGuiTableFlags_ScrollY;
+				auto addrFormat = (finder->getMemorySize() <= 0x10000) ? "0x%04x" : "0x%06x";
 				im::Table("##table", 3, flags, [&]{
 					ImGui::TableSetupScrollFreeze(0, 1); // Make top row always visible
 					ImGui::TableSetupColumn("Address");
@@ -96,7 +129,7 @@ void ImGuiCheatFinder::paint(MSXMotherBoard* /*motherBoard*/)
 					im::ListClipper(searchResults.size(), [&](int i) {
 						const auto& row = searchResults[i];
 						if (ImGui::TableNextColumn()) { // addr
-							ImGui::Text("0x%04x", row.address);
+							ImGui::Text(addrFormat, row.address);
 						}
 						if (ImGui::TableNextColumn()) { // old
 							ImGui::Text("%d", row.oldValue);
@@ -110,21 +143,23 @@ void ImGuiCheatFinder::paint(MSXMotherBoard* /*motherBoard*/)
 		});
 	});
 
+	if (!finder) return;
 	if (start) {
-		manager.execute(TclObject("cheat_finder::start"));
-		searchExpr = "1"; // could be optimized, but good enough
+		if (auto* debuggable = debugger->findDebuggable(debuggableName)) {
+			finder->start(debuggableName, *debuggable);
+		}
+	}
+	if (searchOp && finder->isStarted()) {
+		auto* debuggable = debugger->findDebuggable(finder->getDebuggableName());
+		if (debuggable && (debuggable->getSize() == finder->getMemorySize())) {
+			finder->search(*debuggable, *searchOp, searchWith);
+		} else {
+			finder->clear();
+		}
 	}
-	if (!searchExpr.empty()) {
-		auto result = manager.execute(makeTclList("cheat_finder::search", searchExpr)).value_or(TclObject{});
-		searchResults = to_vector(std::views::transform(xrange(result.size()), [&](size_t i) {
-			auto line = result.getListIndexUnchecked(i);
-			auto addr     = line.getListIndexUnchecked(0).getOptionalInt().value_or(0);
-			auto oldValue = line.getListIndexUnchecked(1).getOptionalInt().value_or(0);
-			auto newValue = line.getListIndexUnchecked(2).getOptionalInt().value_or(0);
-			return SearchResult{.address = narrow_cast<uint16_t>(addr),
-			                    .oldValue = narrow_cast<uint8_t>(oldValue),
-			                    .newValue = narrow_cast<uint8_t>(newValue)};
-		}));
+	if (start || searchOp) {
+		searchResults = finder->isStarted() ? finder->getResults()
+		                                    : std::vector<CheatFinder::Result>{};
 	}
 }
 
@@ -3,7 +3,10 @@
 
 #include "ImGuiPart.hh"
 
+#include "CheatFinder.hh"
+
 #include <cstdint>
+#include <string>
 #include <vector>
 
 namespace openmsx {
@@ -19,12 +22,8 @@ public:
 	bool show = false;
 
 private:
-	struct SearchResult {
-		uint16_t address;
-		uint8_t oldValue;
-		uint8_t newValue;
-	};
-	std::vector<SearchResult> searchResults;
+	std::vector<CheatFinder::Result> searchResults;
+	std::string debuggableName = "memory";
 	uint8_t searchValue = 0;
 };
 
@@ -79,6 +79,14 @@ void ImGuiConsole::loadLine(std::string_view name, zstring_view value)
 
 void ImGuiConsole::print(std::string_view text, imColor color)
 {
+	// When printing more lines than fit in the scrollback buffer, the
+	// first lines would immediately be dropped again, so skip them.
+	auto numLines = size_t(std::ranges::count(text, '\n')) +
+	                ((text.empty() || text.back() != '\n') ? 1 : 0);
+	for (auto skip = numLines - std::min(numLines, lines.capacity()); skip; --skip) {
+		text.remove_prefix(text.find('\n') + 1);
+	}
+
 	do {
 		auto pos = text.find('\n');
 		newLineConsole(ConsoleLine(std::string(text.substr(0, pos)), color));
@@ -95,11 +103,9 @@ void ImGuiConsole::newLineConsole(ConsoleLine line)
 	};
 
 	if (wrap) {
-		do {
-			auto rest = line.splitAtColumn(columns);
-			addLine(std::move(line));
-			line = std::move(rest);
-		} while (!line.str().empty());
+		for (auto& l : line.wrap(std::max(columns, 1u), lines.capacity())) {
+			addLine(std::move(l));
+		}
 	} else {
 		addLine(std::move(line));
 	}
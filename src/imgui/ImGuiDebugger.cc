@@ -30,11 +30,13 @@
 #include "narrow.hh"
 #include "stl.hh"
 #include "strCat.hh"
+#include "xrange.hh"
 
 #include <imgui.h>
 #include <imgui_stdlib.h>
 
 #include <algorithm>
+#include <cmath>
 
 using namespace std::literals;
 
@@ -248,6 +250,7 @@ void ImGuiDebugger::showMenu(MSXMotherBoard* motherBoard)
 		ImGui::MenuItem("CPU flags", nullptr, &showFlags);
 		ImGui::MenuItem("Slots", nullptr, &showSlots);
 		ImGui::MenuItem("Stack", nullptr, &showStack);
+		ImGui::MenuItem("Memory/IO access profile", nullptr, &showAccessProfile);
 		auto it = std::ranges::lower_bound(hexEditors, "memory", {}, &DebuggableEditor::getDebuggableName);
 		bool memoryOpen = (it != hexEditors.end()) && (*it)->open;
 		if (ImGui::MenuItem("Memory", nullptr, &memoryOpen)) {
@@ -329,6 +332,7 @@ void ImGuiDebugger::paint(MSXMotherBoard* motherBoard)
 	drawStack(regs, cpuInterface, time);
 	drawRegisters(regs);
 	drawFlags(regs);
+	drawAccessProfile(cpuInterface);
 
 	showChangesFrameCounter = std::max(0, showChangesFrameCounter - 1);
 }
@@ -794,4 +798,97 @@ void ImGuiDebugger::drawFlags(CPURegs& regs)
 	});
 }
 
+void ImGuiDebugger::drawAccessProfile(MSXCPUInterface& cpuInterface)
+{
+	if (!showAccessProfile) return;
+	im::Window("Memory/IO access profile", &showAccessProfile, [&]{
+		bool enabled = cpuInterface.isAccessProfiling();
+		if (ImGui::Checkbox("Count accesses", &enabled)) {
+			cpuInterface.setAccessProfiling(enabled);
+		}
+		simpleToolTip("While counting, emulation is slower");
+		ImGui::SameLine();
+		if (ImGui::Button("Clear")) {
+			cpuInterface.clearAccessProfile();
+		}
+
+		auto viewName = [&](int view) {
+			if (view == 16) return std::string("I/O ports");
+			auto ps = view / 4;
+			return cpuInterface.isExpanded(ps) ? strCat("Slot ", ps, '-', view % 4)
+			                                   : strCat("Slot ", ps);
+		};
+		ImGui::SetNextItemWidth(ImGui::GetFontSize() * 7.0f);
+		im::Combo("##view", viewName(accessProfileView).c_str(), [&]{
+			for (auto ps : xrange(4)) {
+				auto numSub = cpuInterface.isExpanded(ps) ? 4 : 1;
+				for (auto ss : xrange(numSub)) {
+					auto view = 4 * ps + ss;
+					if (ImGui::Selectable(viewName(view).c_str(), view == accessProfileView)) {
+						accessProfileView = view;
+					}
+				}
+			}
+			if (ImGui::Selectable(viewName(16).c_str(), accessProfileView == 16)) {
+				accessProfileView = 16;
+			}
+		});
+		ImGui::SameLine();
+		ImGui::RadioButton("read", &accessProfileType, 0);
+		ImGui::SameLine();
+		ImGui::RadioButton("write", &accessProfileType, 1);
+		ImGui::SameLine();
+		ImGui::RadioButton("both", &accessProfileType, 2);
+
+		const auto* profile = cpuInterface.getAccessProfile();
+		if (!profile) return;
+		bool isIO = accessProfileView == 16;
+		const auto& reads  = isIO ? profile->ioRead  : profile->memRead [accessProfileView];
+		const auto& writes = isIO ? profile->ioWrite : profile->memWrite[accessProfileView];
+		auto getCount = [&](unsigned i) {
+			return ((accessProfileType != 1) ? reads [i] : 0) +
+			       ((accessProfileType != 0) ? writes[i] : 0);
+		};
+		uint64_t maxCount = 0;
+		for (auto i : xrange(256u)) maxCount = std::max(maxCount, getCount(i));
+		// logarithmic scale, the counts easily span many orders of magnitude
+		auto scale = 1.0f / std::log1p(float(std::max<uint64_t>(maxCount, 1)));
+
+		// 16 x 16 grid: one cell per 256-byte page or per I/O port
+		auto cellSize = gl::vec2(ImGui::GetFrameHeight());
+		auto labelWidth = ImGui::CalcTextSize("0000"sv).x + ImGui::GetStyle().ItemSpacing.x;
+		gl::vec2 topLeft = ImGui::GetCursorScreenPos();
+		auto gridPos = topLeft + gl::vec2(labelWidth, 0.0f);
+		auto* drawList = ImGui::GetWindowDrawList();
+		auto textColor = ImGui::GetColorU32(ImGuiCol_Text);
+		for (auto row : xrange(16u)) {
+			auto y = float(row) * cellSize.y;
+			auto label = isIO ? strCat(hex_string<1>(row), 'x')
+			                  : strCat(hex_string<2>(row << 4), "00");
+			drawList->AddText(topLeft + gl::vec2(0.0f, y), textColor, label.c_str());
+			for (auto col : xrange(16u)) {
+				auto count = getCount(16 * row + col);
+				auto t = std::log1p(float(count)) * scale;
+				auto color = (count == 0)
+					? ImGui::GetColorU32(ImGuiCol_FrameBg)
+					: ImGui::ColorConvertFloat4ToU32(ImVec4(t, 0.3f * (1.0f - t), 1.0f - t, 1.0f));
+				auto p = gridPos + gl::vec2(float(col) * cellSize.x, y);
+				drawList->AddRectFilled(p, p + cellSize - gl::vec2(1.0f), color);
+			}
+		}
+		ImGui::InvisibleButton("##grid", gl::vec2(labelWidth, 0.0f) + 16.0f * cellSize);
+		if (ImGui::IsItemHovered()) {
+			auto [col, row] = trunc((gl::vec2(ImGui::GetIO().MousePos) - gridPos) / cellSize);
+			if ((0 <= col) && (col < 16) && (0 <= row) && (row < 16)) {
+				auto i = unsigned(16 * row + col);
+				auto where = isIO ? strCat("port 0x", hex_string<2>(i))
+				                  : strCat("0x", hex_string<4>(i << 8), "-0x", hex_string<4>((i << 8) | 0xff));
+				im::Tooltip([&]{
+					ImGui::StrCat(where, "\nreads: ", reads[i], "\nwrites: ", writes[i]);
+				});
+			}
+		}
+	});
+}
+
 } // namespace openmsx
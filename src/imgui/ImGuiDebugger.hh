@@ -67,6 +67,7 @@ private:
 	void drawStack(const CPURegs& regs, const MSXCPUInterface& cpuInterface, EmuTime time);
 	void drawRegisters(CPURegs& regs);
 	void drawFlags(CPURegs& regs);
+	void drawAccessProfile(MSXCPUInterface& cpuInterface);
 
 	void actionBreakContinue(MSXCPUInterface& cpuInterface);
 	void actionStepIn(MSXCPUInterface& cpuInterface);
@@ -98,6 +99,9 @@ private:
 	bool showFlags = false;
 	bool showXYFlags = false;
 	int flagsLayout = 1;
+	bool showAccessProfile = false;
+	int accessProfileView = 0; // 4 * ps + ss, or 16 for I/O ports
+	int accessProfileType = 2; // 0 = read, 1 = write, 2 = both
 	std::string breakpointFile;
 	bool reloadBreakpoints = false;
 
@@ -112,6 +116,9 @@ private:
 		PersistentElement{"showFlags",         &ImGuiDebugger::showFlags},
 		PersistentElement{"showXYFlags",       &ImGuiDebugger::showXYFlags},
 		PersistentElementMax{"flagsLayout",    &ImGuiDebugger::flagsLayout, 2},
+		PersistentElement{"showAccessProfile", &ImGuiDebugger::showAccessProfile},
+		PersistentElementMax{"accessProfileView", &ImGuiDebugger::accessProfileView, 17},
+		PersistentElementMax{"accessProfileType", &ImGuiDebugger::accessProfileType, 3},
 		PersistentElement{"showChanges",       &ImGuiDebugger::showChanges},
 		PersistentElement{"changesColor",      &ImGuiDebugger::changesColor},
 		PersistentElement{"breakpointFile",    &ImGuiDebugger::breakpointFile},
@@ -30,6 +30,7 @@
 
 #include <cstdint>
 #include <ranges>
+#include <utility>
 #include <vector>
 
 using namespace std::literals;
@@ -241,10 +242,8 @@ void ImGuiDisassembly::paint(MSXMotherBoard* motherBoard)
 			auto& bps = cpuInterface.getBreakPoints();
 			auto textSize = ImGui::GetTextLineHeight();
 
-			std::string mnemonic;
 			std::string opcodesStr;
 			std::vector<std::string_view> candidates;
-			std::array<uint8_t, 4> opcodes;
 			ImGuiListClipper clipper; // only draw the actually visible rows
 			clipper.Begin(0x10000, ImGui::GetTextLineHeightWithSpacing());
 			if (gotoTarget) {
@@ -254,12 +253,20 @@ void ImGuiDisassembly::paint(MSXMotherBoard* motherBoard)
 			std::optional<unsigned> minAddr;
 			std::optional<unsigned> maxAddr;
 			bool toClipboard = false;
+			bool prevCacheMiss = std::exchange(dasmCacheMiss, false);
 			while (clipper.Step()) {
 				// Note this while loop can iterate multiple times, though we mitigate this by passing the
 				// row height to the ImGuiListClipper constructor. Another reason is because we called
 				// clipper.IncludeItemsByIndex(), but that only happens when 'gotoTarget' is set.
 				// Because of this it's acceptable to just record the min and max address in the for loop below.
-				auto addr16 = instructionBoundary(cpuInterface, narrow<uint16_t>(clipper.DisplayStart), time);
+				// Searching the instruction boundary scans backwards. Reuse
+				// the result of the previous frame when the view didn't
+				// scroll and none of the shown instructions changed.
+				if (!topBoundary || (topBoundary->first != clipper.DisplayStart) || prevCacheMiss) {
+					topBoundary.emplace(clipper.DisplayStart, instructionBoundary(
+						cpuInterface, narrow<uint16_t>(clipper.DisplayStart), time));
+				}
+				auto addr16 = topBoundary->second;
 				for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row) {
 					unsigned addr = addr16;
 					minAddr = std::min(addr, minAddr.value_or(std::numeric_limits<unsigned>::max()));
@@ -324,10 +331,10 @@ void ImGuiDisassembly::paint(MSXMotherBoard* motherBoard)
 							}
 						}
 
-						std::optional<uint16_t> mnemonicAddr;
-						std::span<const Symbol* const> mnemonicLabels;
-						auto len = disassemble(cpuInterface, addr, pc, time,
-							opcodes, mnemonic, mnemonicAddr, mnemonicLabels);
+						const auto& line = disassemble(cpuInterface, addr, pc, time);
+						auto len = line.len;
+						const auto& mnemonicAddr = line.mnemonicAddr;
+						const auto& mnemonicLabels = line.mnemonicLabels;
 
 						if (ImGui::TableNextColumn()) { // addr
 							bool focusScrollToAddress = false;
@@ -434,7 +441,7 @@ void ImGuiDisassembly::paint(MSXMotherBoard* motherBoard)
 
 							auto slot = getCurrentSlot(cpuInterface, debugger, addr16);
 							auto psSs = uint8_t((slot.ss.value_or(0) << 2) + slot.ps);
-							auto addrLabels = symbolManager.lookupValue(addr16);
+							auto addrLabels = line.addrLabels;
 							for (const Symbol* symbol: addrLabels) {
 								// skip symbols with any mismatch
 								if (symbol->slot && *symbol->slot != psSs) continue;
@@ -470,7 +477,7 @@ void ImGuiDisassembly::paint(MSXMotherBoard* motherBoard)
 						if (ImGui::TableNextColumn()) { // opcode
 							opcodesStr.clear();
 							for (auto i : xrange(len)) {
-								strAppend(opcodesStr, hex_string<2>(opcodes[i]), ' ');
+								strAppend(opcodesStr, hex_string<2>(line.opcodes[i]), ' ');
 							}
 							im::Font(manager.fontMono, [&]{
 								ImGui::TextUnformatted(opcodesStr.data(), opcodesStr.data() + 3 * size_t(len) - 1);
@@ -480,7 +487,7 @@ void ImGuiDisassembly::paint(MSXMotherBoard* motherBoard)
 						if (ImGui::TableNextColumn()) { // mnemonic
 							auto pos = ImGui::GetCursorPos();
 							im::Font(manager.fontMono, [&]{
-								ImGui::TextUnformatted(mnemonic);
+								ImGui::TextUnformatted(line.mnemonic);
 							});
 							if (mnemonicAddr) {
 								ImGui::SetCursorPos(pos);
@@ -535,56 +542,70 @@ void ImGuiDisassembly::paint(MSXMotherBoard* motherBoard)
 	});
 }
 
-unsigned ImGuiDisassembly::disassemble(
-	const MSXCPUInterface& cpuInterface, unsigned addr, unsigned pc, EmuTime time,
-	std::span<uint8_t, 4> opcodes, std::string& mnemonic,
-	std::optional<uint16_t>& mnemonicAddr, std::span<const Symbol* const>& mnemonicLabels)
+const ImGuiDisassembly::Line& ImGuiDisassembly::disassemble(
+	const MSXCPUInterface& cpuInterface, unsigned addr, unsigned pc, EmuTime time)
 {
-	mnemonic.clear();
-	auto len = dasm(cpuInterface, narrow<uint16_t>(addr), opcodes, mnemonic, time,
-		[&](std::string& output, uint16_t a) {
-			mnemonicAddr = a;
-			mnemonicLabels = symbolManager.lookupValue(a);
-			if (!mnemonicLabels.empty()) {
-				strAppend(output, mnemonicLabels[cycleLabelsCounter % mnemonicLabels.size()]->name);
-			} else {
-				appendAddrAsHex(output, a);
-			}
-		});
-	assert(len >= 1);
-	if ((addr < pc) && (pc < (addr + len))) {
+	auto gen = symbolManager.getGeneration();
+	if ((gen != dasmCacheSymbolGeneration) || (cycleLabelsCounter != dasmCacheLabelsCounter) ||
+	    (dasmCache.size() > 0x4000)) { // keep memory usage bounded
+		dasmCache.clear();
+		dasmCacheSymbolGeneration = gen;
+		dasmCacheLabelsCounter = cycleLabelsCounter;
+	}
+
+	auto addr16 = narrow<uint16_t>(addr);
+	std::array<uint8_t, 4> buf;
+	auto bytes = fetchInstruction(cpuInterface, addr16, buf, time);
+	auto& line = dasmCache[addr16];
+	if (!std::ranges::equal(bytes, std::span{line.opcodes}.first(line.len))) {
+		dasmCacheMiss = true;
+		std::ranges::copy(bytes, line.opcodes.begin());
+		line.len = narrow<unsigned>(bytes.size());
+		line.mnemonic.clear();
+		line.mnemonicAddr.reset();
+		line.mnemonicLabels = {};
+		dasm(bytes, addr16, line.mnemonic,
+			[&](std::string& output, uint16_t a) {
+				line.mnemonicAddr = a;
+				line.mnemonicLabels = symbolManager.lookupValue(a);
+				if (!line.mnemonicLabels.empty()) {
+					strAppend(output, line.mnemonicLabels[cycleLabelsCounter % line.mnemonicLabels.size()]->name);
+				} else {
+					appendAddrAsHex(output, a);
+				}
+			});
+		line.addrLabels = symbolManager.lookupValue(addr16);
+	}
+	assert(line.len >= 1);
+	if ((addr < pc) && (pc < (addr + line.len))) {
 		// pc is strictly inside current instruction,
 		// replace the just disassembled instruction with "db #..."
-		mnemonicAddr.reset();
-		mnemonicLabels = {};
-		len = pc - addr;
-		assert((1 <= len) && (len <= 3));
-		mnemonic = strCat("db     ", join(
-			std::views::transform(xrange(len),
-				[&](unsigned i) { return strCat('#', hex_string<2>(opcodes[i])); }),
+		pcInsideLine.opcodes = line.opcodes;
+		pcInsideLine.len = pc - addr;
+		assert((1 <= pcInsideLine.len) && (pcInsideLine.len <= 3));
+		pcInsideLine.mnemonic = strCat("db     ", join(
+			std::views::transform(xrange(pcInsideLine.len),
+				[&](unsigned i) { return strCat('#', hex_string<2>(line.opcodes[i])); }),
 			','));
+		pcInsideLine.mnemonicAddr.reset();
+		pcInsideLine.mnemonicLabels = {};
+		pcInsideLine.addrLabels = line.addrLabels;
+		return pcInsideLine;
 	}
-	return len;
+	return line;
 }
 
 void ImGuiDisassembly::disassembleToClipboard(
 	const MSXCPUInterface& cpuInterface, unsigned pc, EmuTime time,
 	unsigned minAddr, unsigned maxAddr)
 {
-	std::string mnemonic;
-	std::array<uint8_t, 4> opcodes;
-	std::optional<uint16_t> mnemonicAddr;
-	std::span<const Symbol* const> mnemonicLabels;
-
 	std::string result;
 
 	unsigned addr = minAddr;
 	while (addr <= maxAddr) {
-		mnemonic.clear();
-		auto len = disassemble(cpuInterface, addr, pc, time,
-			opcodes, mnemonic, mnemonicAddr, mnemonicLabels);
-		strAppend(result , '\t', mnemonic, '\n');
-		addr += len;
+		const auto& line = disassemble(cpuInterface, addr, pc, time);
+		strAppend(result , '\t', line.mnemonic, '\n');
+		addr += line.len;
 	}
 
 	manager.getReactor().getDisplay().getVideoSystem().setClipboardText(result);
@@ -3,6 +3,10 @@
 
 #include "ImGuiPart.hh"
 
+#include "hash_map.hh"
+
+#include <array>
+#include <cstdint>
 #include <optional>
 #include <span>
 #include <string>
@@ -39,10 +43,17 @@ public:
 		getRomBlocks(Debugger& debugger, const MSXDevice* device);
 
 private:
-	unsigned disassemble(
-		const MSXCPUInterface& cpuInterface, unsigned addr, unsigned pc, EmuTime time,
-		std::span<uint8_t, 4> opcodes, std::string& mnemonic,
-		std::optional<uint16_t>& mnemonicAddr, std::span<const Symbol* const>& mnemonicLabels);
+	struct Line {
+		std::array<uint8_t, 4> opcodes = {};
+		unsigned len = 0;
+		std::string mnemonic;
+		std::optional<uint16_t> mnemonicAddr;
+		std::span<const Symbol* const> mnemonicLabels;
+		std::span<const Symbol* const> addrLabels; // symbols for the address of this line
+	};
+	// The returned reference is only valid until the next call.
+	const Line& disassemble(
+		const MSXCPUInterface& cpuInterface, unsigned addr, unsigned pc, EmuTime time);
 	void disassembleToClipboard(
 		const MSXCPUInterface& cpuInterface, unsigned pc, EmuTime time,
 		unsigned minAddr, unsigned maxAddr);
@@ -67,6 +78,19 @@ private:
 	bool syncDisassemblyWithPC = false;
 	float disassemblyScrollY = 0.0f;
 
+	// Disassembled instructions, per address. An entry is only reused when
+	// the opcode bytes in memory are still the same. That covers writes to
+	// memory as well as switching slots or mapper segments, without the
+	// need to observe any of those. Formatting the mnemonic and looking up
+	// the symbols is what's expensive, peeking the bytes is cheap.
+	hash_map<uint16_t, Line> dasmCache;
+	Line pcInsideLine; // not cached, see disassemble()
+	uint64_t dasmCacheSymbolGeneration = 0;
+	size_t dasmCacheLabelsCounter = 0;
+	bool dasmCacheMiss = false;
+	// Instruction boundary for the top row of the previous frame.
+	std::optional<std::pair<int, uint16_t>> topBoundary;
+
 	static constexpr auto persistentElements = std::tuple{
 		PersistentElement{"show",              &ImGuiDisassembly::show},
 		PersistentElement{"followPC",          &ImGuiDisassembly::followPC},
@@ -24,6 +24,14 @@ ImGuiLayer::ImGuiLayer(ImGuiManager& manager_)
 
 void ImGuiLayer::paint(OutputSurface& /*surface*/)
 {
+	if (!manager.needRebuild()) {
+		// Nothing changed, draw the same GUI on top of the (possibly
+		// changed) MSX screen. Secondary viewport windows keep their
+		// content, they're not repainted.
+		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		return;
+	}
+
 	manager.preNewFrame();
 
 	// Start the Dear ImGui frame
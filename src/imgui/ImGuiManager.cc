@@ -16,6 +16,7 @@
 #include "ImGuiOpenFile.hh"
 #include "ImGuiOsdIcons.hh"
 #include "ImGuiPalette.hh"
+#include "ImGuiPerfMonitor.hh"
 #include "ImGuiPlotterViewer.hh"
 #include "ImGuiRasterViewer.hh"
 #include "ImGuiReverseBar.hh"
@@ -45,6 +46,7 @@
 #include "RomDatabase.hh"
 #include "RomInfo.hh"
 #include "SettingsConfig.hh"
+#include "StartupProfiler.hh"
 #include "VDP.hh"
 
 #include "format.hh"
@@ -100,6 +102,7 @@ std::tuple<ImFont*, std::string> ImGuiManager::addFont(zstring_view filename, in
 
 void ImGuiManager::loadFont()
 {
+	StartupProfiler::Scope profile("ImGui fonts");
 	ImGuiIO& io = ImGui::GetIO();
 
 	assert(fontProp == nullptr);
@@ -138,7 +141,11 @@ void ImGuiManager::initializeImGui()
 	static auto iniFilename = systemFileContext().resolveCreate("imgui.ini");
 	io.IniFilename = iniFilename.c_str();
 
-	loadFont();
+	// Reading (and decompressing) the font files is postponed till the
+	// first frame gets painted (see preNewFrame()). So it's skipped when
+	// the GUI is never shown (e.g. when running without video output).
+	// Glyphs are anyway only rasterized when they're needed.
+	needReloadFont = true;
 }
 
 static void cleanupImGui()
@@ -186,6 +193,7 @@ ImGuiManager::ImGuiManager(Reactor& reactor_)
 	waveViewer = std::make_unique<ImGuiWaveViewer>(*this);
 	diskManipulator = std::make_unique<ImGuiDiskManipulator>(*this);
 	soundChip = std::make_unique<ImGuiSoundChip>(*this);
+	perfMonitor = std::make_unique<ImGuiPerfMonitor>(*this);
 	keyboard = std::make_unique<ImGuiKeyboard>(*this);
 	console = std::make_unique<ImGuiConsole>(*this);
 	messages = std::make_unique<ImGuiMessages>(*this);
@@ -384,6 +392,7 @@ void ImGuiManager::printError(std::string_view message)
 
 bool ImGuiManager::signalEvent(const Event& event)
 {
+	markActivity();
 	if (const auto* evt = get_event_if<SdlEvent>(event)) {
 		const ImGuiIO& io = ImGui::GetIO();
 		if (!io.BackendPlatformUserData) {
@@ -447,6 +456,7 @@ bool ImGuiManager::signalEvent(const Event& event)
 void ImGuiManager::update(const Setting& /*setting*/) noexcept
 {
 	needReloadFont = true;
+	markActivity();
 }
 
 // TODO share code with ImGuiMedia
@@ -492,6 +502,29 @@ void ImGuiManager::preNewFrame()
 	}
 }
 
+bool ImGuiManager::needRebuild()
+{
+	// While emulation runs, the content of the GUI (e.g. the debugger)
+	// changes all the time. When it's paused, the content only changes in
+	// response to events (input, Tcl commands from the GUI, ...), so then,
+	// when there were no events for a while, the previous frame can be
+	// drawn again. Some changes are not signaled via events (e.g. a Tcl
+	// 'after realtime' callback), so still rebuild at a low rate.
+	static constexpr uint64_t ACTIVE_PERIOD = 1'000'000; // us
+	static constexpr uint64_t IDLE_REBUILD_PERIOD = 250'000; // us
+	auto now = Timer::getTime();
+	bool animating = (menuAlpha != (guiActive ? 1.0f : 0.0f) && menuFade) ||
+	                 (insertedInfoTimeout > 0.0f) ||
+	                 ImGui::GetIO().WantTextInput; // blinking cursor
+	bool rebuild = !reactor.isBlocked() || animating ||
+	               (ImGui::GetFrameCount() == 0) || // no previous frame
+	               !loadIniFile.empty() || needReloadFont ||
+	               ((now - lastActivity) < ACTIVE_PERIOD) ||
+	               ((now - lastRebuild) >= IDLE_REBUILD_PERIOD);
+	if (rebuild) lastRebuild = now;
+	return rebuild;
+}
+
 static bool hoverMenuBar()
 {
 	const auto* viewport = ImGui::GetMainViewport();
@@ -726,7 +759,7 @@ void ImGuiManager::paintImGui(bool msxDisplayAreaFocused)
 		insertedInfoTimeout = 3.0f;
 		ImGui::OpenPopup("inserted-info");
 	}
-	im::Popup("inserted-info", [&]{
+	bool infoOpen = im::Popup("inserted-info", [&]{
 		insertedInfoTimeout -= ImGui::GetIO().DeltaTime;
 		if (insertedInfoTimeout <= 0.0f || insertedInfo.empty()) {
 			ImGui::CloseCurrentPopup();
@@ -735,6 +768,7 @@ void ImGuiManager::paintImGui(bool msxDisplayAreaFocused)
 			ImGui::TextUnformatted(insertedInfo);
 		});
 	});
+	if (!infoOpen) insertedInfoTimeout = 0.0f; // e.g. closed by clicking elsewhere
 }
 
 void ImGuiManager::drawStatusBar(MSXMotherBoard* motherBoard)
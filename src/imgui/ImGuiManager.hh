@@ -13,12 +13,14 @@
 #include "Reactor.hh"
 #include "RomTypes.hh"
 #include "TclObject.hh"
+#include "Timer.hh"
 
 #include "Observer.hh"
 #include "StringReplacer.hh"
 #include "strCat.hh"
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <optional>
 #include <string_view>
@@ -45,6 +47,7 @@ class ImGuiMsxMusicViewer;
 class ImGuiOpenFile;
 class ImGuiOsdIcons;
 class ImGuiPalette;
+class ImGuiPerfMonitor;
 class ImGuiPlotterViewer;
 class ImGuiRasterViewer;
 class ImGuiReverseBar;
@@ -94,6 +97,15 @@ public:
 	void preNewFrame();
 	void paintImGui(bool msxDisplayAreaFocused);
 
+	/** Should the ImGui frame be rebuilt, or can the previous draw data
+	  * be rendered again? See ImGuiLayer::paint().
+	  */
+	[[nodiscard]] bool needRebuild();
+	/** Rebuild the ImGui frame for a while, e.g. because some (timed)
+	  * content changed without any user input.
+	  */
+	void markActivity() { lastActivity = Timer::getTime(); }
+
 	void storeWindowPosition(gl::ivec2 pos) { windowPos = pos; }
 	[[nodiscard]] gl::ivec2 retrieveWindowPosition() const { return windowPos; }
 
@@ -178,6 +190,7 @@ public:
 	std::unique_ptr<ImGuiDiskManipulator> diskManipulator;
 	std::unique_ptr<ImGuiSettings> settings;
 	std::unique_ptr<ImGuiSoundChip> soundChip;
+	std::unique_ptr<ImGuiPerfMonitor> perfMonitor;
 	std::unique_ptr<ImGuiKeyboard> keyboard;
 	std::unique_ptr<ImGuiConsole> console;
 	std::unique_ptr<ImGuiMessages> messages;
@@ -198,6 +211,8 @@ private:
 	std::vector<std::function<void()>> delayedActionQueue;
 	std::vector<std::function<void()>> delayedActionQueue2;
 	float menuAlpha = 1.0f;
+	uint64_t lastActivity = 0; // see markActivity()
+	uint64_t lastRebuild = 0;
 
 	std::string droppedFile;
 	std::string insertedInfo;
@@ -269,6 +269,7 @@ void ImGuiMessages::paintOSD()
 		return false; // keep message
 	});
 	if (drawInfo.empty()) return;
+	manager.markActivity(); // keep animating while the messages fade out
 
 	int flags = ImGuiWindowFlags_NoMove
 	          | ImGuiWindowFlags_NoBackground
@@ -446,6 +447,7 @@ static bool needThrottle(const circular_buffer<ImGuiMessages::Message>& buffer,
 
 void ImGuiMessages::log(CliComm::LogLevel level, std::string_view text, float fraction)
 {
+	manager.markActivity();
 	if (level == PROGRESS) {
 		progressMessage = text;
 		progressFraction = fraction;
@@ -0,0 +1,162 @@
+#include "ImGuiPerfMonitor.hh"
+
+#include "ImGuiCpp.hh"
+#include "ImGuiUtils.hh"
+
+#include "PerfMonitor.hh"
+
+#include "xrange.hh"
+
+#include <imgui.h>
+
+#include <algorithm>
+
+namespace openmsx {
+
+using namespace PerfMonitor;
+static constexpr auto NUM_SECTIONS = size_t(Section::NUM);
+
+[[nodiscard]] static ImU32 getSectionColor(size_t section)
+{
+	auto [r, g, b] = generateDistinctColor(unsigned(section));
+	return ImGui::ColorConvertFloat4ToU32(ImVec4(r, g, b, 1.0f));
+}
+
+void ImGuiPerfMonitor::save(ImGuiTextBuffer& buf)
+{
+	savePersistent(buf, *this, persistentElements);
+}
+
+void ImGuiPerfMonitor::loadLine(std::string_view name, zstring_view value)
+{
+	loadOnePersistent(name, value, *this, persistentElements);
+}
+
+void ImGuiPerfMonitor::paint(MSXMotherBoard* /*motherBoard*/)
+{
+	if (!show) return;
+
+	ImGui::SetNextWindowSize(gl::vec2{36, 24} * ImGui::GetFontSize(), ImGuiCond_FirstUseEver);
+	im::Window("Performance monitor", &show, [&]{
+		bool enabled = isEnabled();
+		if (ImGui::Checkbox("Enabled", &enabled)) {
+			setEnabled(enabled);
+		}
+		simpleToolTip("Measure the time spent per frame in the main subsystems.\n"
+		              "This adds a small overhead.");
+		ImGui::SameLine();
+		if (ImGui::Button("Clear")) clearFrames();
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(ImGui::GetFontSize() * 8.0f);
+		ImGui::SliderFloat("Scale", &scaleMs, 5.0f, 200.0f, "%.0f ms", ImGuiSliderFlags_Logarithmic);
+
+		if (getFrames().empty()) {
+			ImGui::TextUnformatted(enabled ? "Waiting for frames ..." : "Monitoring is disabled.");
+			return;
+		}
+		paintTimeline();
+		paintTable();
+	});
+}
+
+// One bar per frame, newest on the right, stacked per section.
+void ImGuiPerfMonitor::paintTimeline()
+{
+	const auto& frames = getFrames();
+	gl::vec2 size{ImGui::GetContentRegionAvail().x, 8.0f * ImGui::GetTextLineHeightWithSpacing()};
+	gl::vec2 topLeft = ImGui::GetCursorScreenPos();
+	gl::vec2 bottomRight = topLeft + size;
+	ImGui::Dummy(size);
+
+	auto* drawList = ImGui::GetWindowDrawList();
+	drawList->AddRectFilled(topLeft, bottomRight, ImGui::GetColorU32(ImGuiCol_FrameBg));
+
+	// one pixel per frame (at most), only show what fits
+	auto barWidth = std::max(1.0f, size.x / float(frames.capacity()));
+	auto num = std::min(frames.size(), size_t(size.x / barWidth));
+	auto pixelsPerNs = size.y / (scaleMs * 1e6f);
+	auto otherColor = getColor(imColor::GRAY);
+
+	float x = bottomRight.x - float(num) * barWidth;
+	for (auto i : xrange(frames.size() - num, frames.size())) {
+		const auto& frame = frames[i];
+		float y = bottomRight.y;
+		auto addBar = [&](uint64_t ns, ImU32 color) {
+			float y1 = std::max(topLeft.y, y - float(ns) * pixelsPerNs);
+			if (y1 < y) drawList->AddRectFilled(gl::vec2{x, y1}, gl::vec2{x + barWidth, y}, color);
+			y = y1;
+		};
+		for (auto s : xrange(NUM_SECTIONS)) {
+			addBar(frame.sections[s], getSectionColor(s));
+		}
+		addBar(getOther(frame), otherColor);
+		x += barWidth;
+	}
+
+	// reference lines for 60Hz and 50Hz
+	for (float ms : {1000.0f / 60.0f, 1000.0f / 50.0f}) {
+		float y = bottomRight.y - ms * 1e6f * pixelsPerNs;
+		if (y <= topLeft.y) continue;
+		drawList->AddLine(gl::vec2{topLeft.x, y}, gl::vec2{bottomRight.x, y}, getColor(imColor::TEXT_DISABLED));
+	}
+}
+
+// Average and maximum time per section over the whole history.
+void ImGuiPerfMonitor::paintTable()
+{
+	const auto& frames = getFrames();
+	std::array<uint64_t, NUM_SECTIONS> sum = {};
+	std::array<uint64_t, NUM_SECTIONS> max = {};
+	uint64_t sumFrame = 0, maxFrame = 0;
+	uint64_t sumOther = 0, maxOther = 0;
+	for (const auto& frame : frames) {
+		for (auto s : xrange(NUM_SECTIONS)) {
+			sum[s] += frame.sections[s];
+			max[s] = std::max<uint64_t>(max[s], frame.sections[s]);
+		}
+		sumFrame += frame.duration;
+		maxFrame = std::max(maxFrame, frame.duration);
+		auto other = getOther(frame);
+		sumOther += other;
+		maxOther = std::max(maxOther, other);
+	}
+	auto n = double(frames.size());
+
+	int flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingStretchProp;
+	im::Table("sections", 4, flags, [&]{
+		ImGui::TableSetupColumn("section");
+		ImGui::TableSetupColumn("avg (ms)");
+		ImGui::TableSetupColumn("max (ms)");
+		ImGui::TableSetupColumn("% of frame");
+		ImGui::TableHeadersRow();
+
+		auto row = [&](std::string_view name, ImU32 color, uint64_t total, uint64_t maximum) {
+			if (ImGui::TableNextColumn()) {
+				if (color) {
+					auto h = ImGui::GetTextLineHeight();
+					gl::vec2 pos = ImGui::GetCursorScreenPos();
+					ImGui::GetWindowDrawList()->AddRectFilled(pos, pos + gl::vec2{h, h}, color);
+					ImGui::Dummy(gl::vec2{h, h});
+					ImGui::SameLine();
+				}
+				ImGui::TextUnformatted(name);
+			}
+			if (ImGui::TableNextColumn()) {
+				ImGui::Text("%.2f", double(total) / n * 1e-6);
+			}
+			if (ImGui::TableNextColumn()) {
+				ImGui::Text("%.2f", double(maximum) * 1e-6);
+			}
+			if (ImGui::TableNextColumn()) {
+				ImGui::Text("%.1f", sumFrame ? 100.0 * double(total) / double(sumFrame) : 0.0);
+			}
+		};
+		for (auto s : xrange(NUM_SECTIONS)) {
+			row(getName(Section(s)), getSectionColor(s), sum[s], max[s]);
+		}
+		row("other", getColor(imColor::GRAY), sumOther, maxOther);
+		row("frame", 0, sumFrame, maxFrame);
+	});
+}
+
+} // namespace openmsx
@@ -0,0 +1,36 @@
+#ifndef IMGUI_PERFMONITOR_HH
+#define IMGUI_PERFMONITOR_HH
+
+#include "ImGuiPart.hh"
+
+namespace openmsx {
+
+class ImGuiPerfMonitor final : public ImGuiPart
+{
+public:
+	using ImGuiPart::ImGuiPart;
+
+	[[nodiscard]] zstring_view iniName() const override { return "perf-monitor"; }
+	void save(ImGuiTextBuffer& buf) override;
+	void loadLine(std::string_view name, zstring_view value) override;
+	void paint(MSXMotherBoard* motherBoard) override;
+
+private:
+	void paintTable();
+	void paintTimeline();
+
+public:
+	bool show = false;
+
+private:
+	float scaleMs = 40.0f; // vertical scale of the timeline
+
+	static constexpr auto persistentElements = std::tuple{
+		PersistentElement{"show", &ImGuiPerfMonitor::show},
+		PersistentElement{"scale", &ImGuiPerfMonitor::scaleMs},
+	};
+};
+
+} // namespace openmsx
+
+#endif
@@ -13,12 +13,15 @@
 #include "one_of.hh"
 #include "ranges.hh"
 #include "stl.hh"
+#include "strCat.hh"
 #include "subrange_between.hh"
 #include "unreachable.hh"
+#include "xrange.hh"
 
 #include <imgui.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 
 namespace openmsx {
@@ -196,6 +199,19 @@ void ImGuiRasterViewer::paintSettings()
 	ImGui::SeparatorEx(ImGuiSeparatorFlags_Vertical);
 	ImGui::SameLine();
 
+	ImGui::Checkbox("Register writes", &showRegWrites);
+	ImGui::SameLine();
+	im::Disabled(!showRegWrites, [&]{
+		ImGui::ColorEdit4("Register write color", regWriteColor.data(),
+			ImGuiColorEditFlags_NoInputs | ImGuiColorEditFlags_NoLabel | ImGuiColorEditFlags_AlphaBar);
+	});
+	HelpMarker("Shows the positions where VDP registers (R#0-R#31) changed during the last frame. "
+	           "When hovering the display, the registers that had a different value at that position are listed.");
+
+	ImGui::SameLine();
+	ImGui::SeparatorEx(ImGuiSeparatorFlags_Vertical);
+	ImGui::SameLine();
+
 	ImGui::Checkbox("Traces", &showTraces);
 	ImGui::SameLine();
 	im::Disabled(!showTraces, [&]{
@@ -476,6 +492,17 @@ void ImGuiRasterViewer::paintDisplay(MSXMotherBoard& motherBoard)
 				addAnnotation([]{ return "Next line-IRQ position (future)"; }, lineIrqColor, *hTime);
 			}
 		}
+		if (showRegWrites) {
+			EmuTime from = time.saturateSubtract(frameDuration);
+			for (const auto& change : vdp->getRegisterHistory().getChanges(from, time)) {
+				auto print = [&]{
+					return strCat("R#", change.reg, ": 0x", hex_string<2>(change.oldValue),
+					              " -> 0x", hex_string<2>(change.newValue));
+				};
+				// bring into the 'future' (doesn't change screen position)
+				addAnnotation(print, regWriteColor, change.time + frameDuration);
+			}
+		}
 		if (showTraces) {
 			EmuTime from = time.saturateSubtract(frameDuration);
 			EmuTime to = time;
@@ -582,6 +609,29 @@ void ImGuiRasterViewer::paintDisplay(MSXMotherBoard& motherBoard)
 			ImGui::SameLine();
 			ImGui::TextUnformatted("line="sv); dec3(vy);
 
+			if (showRegWrites) {
+				// registers that had a different value when the beam was at this position
+				auto tt = vdp->getTimeInFrame(vy * VDP::TICKS_PER_LINE + tx);
+				if (tt > time) tt -= frameDuration;
+				std::array<uint8_t, 32> current;
+				for (auto r : xrange(32)) current[r] = vdp->peekRegister(r, time);
+				auto regs = current;
+				std::string text;
+				if (!vdp->getRegisterHistory().getValuesAt(tt, regs)) {
+					text = "registers: unknown";
+				} else {
+					for (auto r : xrange(32)) {
+						if (regs[r] == current[r]) continue;
+						strAppend(text, text.empty() ? "" : " ", "R#", r, "=0x", hex_string<2>(regs[r]));
+					}
+				}
+				if (!text.empty()) {
+					ImGui::SameLine(0.0f, 20.0f);
+					im::ScopedFont sf(manager.fontMono);
+					ImGui::TextUnformatted(text);
+				}
+			}
+
 			if (showMarkers && ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
 				if (closestPos.x < FLT_MAX) {
 					auto [xx, yy] = trunc((closestPos - scrnPos) / (gl::vec2(0.5f, 2.0f) * float(zoom)));
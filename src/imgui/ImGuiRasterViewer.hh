@@ -61,6 +61,7 @@ private:
 	gl::vec4 beamColor{1.0f, 0.0f, 0.0f, 0.8f}; // RGBA
 	gl::vec4 vblankIrqColor{1.0f, 1.0f, 0.0f, 0.8f}; // RGBA
 	gl::vec4 lineIrqColor{0.0f, 1.0f, 1.0f, 0.8f}; // RGBA
+	gl::vec4 regWriteColor{1.0f, 0.0f, 1.0f, 0.8f}; // RGBA
 	gl::vec4 markerColor1{0.0f, 1.0f, 0.0f, 0.8f}; // RGBA
 	gl::vec4 markerColor2{1.0f, 0.0f, 0.0f, 0.8f}; // RGBA
 	gl::vec4 shadeColor{1.0f, 1.0f, 0.0f, 0.3f}; // RGBA
@@ -73,6 +74,7 @@ private:
 	bool showBeam = true;
 	bool showVblankIrq = false;
 	bool showLineIrq = false;
+	bool showRegWrites = false;
 	bool showTraces = false;
 	bool showMarkers = true;
 	bool showConfigure = false;
@@ -91,6 +93,7 @@ private:
 		PersistentElement{"beam",           &ImGuiRasterViewer::showBeam},
 		PersistentElement{"vblankIrq",      &ImGuiRasterViewer::showVblankIrq},
 		PersistentElement{"lineIrq",        &ImGuiRasterViewer::showLineIrq},
+		PersistentElement{"regWrites",      &ImGuiRasterViewer::showRegWrites},
 		PersistentElement{"traces",         &ImGuiRasterViewer::showTraces},
 		PersistentElement{"markers",        &ImGuiRasterViewer::showMarkers},
 		PersistentElement{"shadeTrace",     &ImGuiRasterViewer::shadeTrace},
@@ -100,6 +103,7 @@ private:
 		PersistentElement{"beamColor",      &ImGuiRasterViewer::beamColor},
 		PersistentElement{"vblankIrqColor", &ImGuiRasterViewer::vblankIrqColor},
 		PersistentElement{"lineIrqColor",   &ImGuiRasterViewer::lineIrqColor},
+		PersistentElement{"regWriteColor",  &ImGuiRasterViewer::regWriteColor},
 		PersistentElement{"marker1Color",   &ImGuiRasterViewer::markerColor1},
 		PersistentElement{"marker2Color",   &ImGuiRasterViewer::markerColor2},
 		PersistentElement{"shadeColor",     &ImGuiRasterViewer::shadeColor},
@@ -9,6 +9,8 @@
 #include "SoundDevice.hh"
 #include "StringSetting.hh"
 
+#include "narrow.hh"
+
 #include <imgui.h>
 
 #include <algorithm>
@@ -80,11 +82,12 @@ void ImGuiSoundChip::showChipSettings(MSXMotherBoard& motherBoard)
 		                 ImGuiTableFlags_Reorderable |
 		                 ImGuiTableFlags_Hideable |
 		                 ImGuiTableFlags_NoHostExtendX;
-		im::Table("table", 4, tableFlags, [&]{
+		im::Table("table", 5, tableFlags, [&]{
 			ImGui::TableSetupColumn("Device",   ImGuiTableColumnFlags_WidthStretch);
 			ImGui::TableSetupColumn("Volume",   ImGuiTableColumnFlags_NoResize | ImGuiTableColumnFlags_WidthFixed, 10.0f * ImGui::GetFontSize());
 			ImGui::TableSetupColumn("Balance",  ImGuiTableColumnFlags_NoResize | ImGuiTableColumnFlags_WidthFixed,  6.0f * ImGui::GetFontSize());
 			ImGui::TableSetupColumn("Channels", ImGuiTableColumnFlags_NoResize | ImGuiTableColumnFlags_WidthFixed,  5.0f * ImGui::GetFontSize());
+			ImGui::TableSetupColumn("Cost",     ImGuiTableColumnFlags_NoResize | ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_DefaultHide, 6.0f * ImGui::GetFontSize());
 			ImGui::TableHeadersRow();
 
 			const auto& msxMixer = motherBoard.getMSXMixer();
@@ -130,6 +133,13 @@ void ImGuiSoundChip::showChipSettings(MSXMotherBoard& motherBoard)
 						ImGui::Checkbox("##channels", &enabled);
 					});
 				}
+				if (ImGui::TableNextColumn()) {
+					const auto& profile = info.profile;
+					if (profile.samples) {
+						ImGui::StrCat(narrow_cast<unsigned>(profile.nanoseconds / profile.samples), " ns");
+					}
+					simpleToolTip("Average time spent per generated sample (see 'machine_info sound_profile').");
+				}
 			});
 		});
 	});
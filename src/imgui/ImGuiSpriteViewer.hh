@@ -6,6 +6,11 @@
 #include "GLUtil.hh"
 #include "gl_vec.hh"
 
+#include "DirtyPages.hh"
+
+#include <array>
+#include <cstdint>
+#include <optional>
 #include <string>
 
 namespace openmsx {
@@ -62,6 +67,29 @@ private:
 	gl::Texture renderTex  {gl::Null{}};
 	gl::vecN<2, int> gridPosition;
 
+	// Only re-render the pattern and sprite textures when the sprite
+	// tables in VRAM were written to or when some parameter changed.
+	struct PatternKey {
+		std::string machineID; // VRAM dirty epochs are per machine
+		int mode, size;
+		unsigned patReg;
+		bool planar;
+		uint32_t one, zero;
+		bool operator==(const PatternKey&) const = default;
+	};
+	struct RenderKey {
+		std::string machineID;
+		int mode, size, mag, transparent, verticalScroll, lines;
+		unsigned patReg, attReg;
+		bool planar, limitPerLine, stopY;
+		std::array<uint32_t, 16> palette;
+		bool operator==(const RenderKey&) const = default;
+	};
+	std::optional<PatternKey> patternKey;
+	std::optional<RenderKey> renderKey;
+	DirtyPages::Epoch patternEpoch = 0;
+	DirtyPages::Epoch renderEpoch = 0;
+
 	static constexpr auto validSizes = {8, 16};
 	static constexpr auto persistentElements = std::tuple{
 		PersistentElement{"show",                &ImGuiSpriteViewer::show},
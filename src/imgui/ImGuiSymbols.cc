@@ -28,6 +28,7 @@
 #include <imgui_stdlib.h>
 
 #include <cassert>
+#include <chrono>
 #include <ranges>
 
 namespace openmsx {
@@ -67,10 +68,23 @@ void ImGuiSymbols::save(ImGuiTextBuffer& buf)
 			buf.appendf("segment=%d\n", *segment);
 		}
 	}
+	for (const auto& load : pendingLoads) {
+		if (load.discard || symbolManager.findFile(load.info.filename) ||
+		    contains(fileError, load.info.filename, &FileInfo::filename)) continue;
+		buf.appendf("symbolfile=%s\n", load.info.filename.c_str());
+		buf.appendf("symbolfiletype=%s\n", SymbolFile::toString(load.info.type).c_str());
+		if (load.info.slot) {
+			buf.appendf("slotsubslot=%d\n", *load.info.slot);
+		}
+		if (load.info.segment) {
+			buf.appendf("segment=%d\n", *load.info.segment);
+		}
+	}
 }
 
 void ImGuiSymbols::loadStart()
 {
+	discardPendingLoads();
 	symbolManager.removeAllFiles();
 	fileError.clear();
 }
@@ -116,23 +130,51 @@ void ImGuiSymbols::loadEnd()
 void ImGuiSymbols::loadFile(
 	const std::string& filename, SymbolManager::LoadEmpty loadEmpty, SymbolFile::Type type,
 	std::optional<uint8_t> slot, std::optional<uint16_t> segment)
+{
+	discardPendingLoads(filename); // only the most recent request counts
+	auto result = std::async(std::launch::async, [=] {
+		return SymbolManager::loadSymbolFile(filename, type, slot, segment);
+	});
+	pendingLoads.emplace_back(FileInfo{filename, std::string{}, type, slot, segment},
+	                          loadEmpty, std::move(result));
+}
+
+void ImGuiSymbols::checkPendingLoads()
 {
 	auto& cliComm = manager.getCliComm();
-	auto it = std::ranges::find(fileError, filename, &FileInfo::filename);
-	try {
-		if (!symbolManager.reloadFile(filename, loadEmpty, type, slot, segment)) {
-			cliComm.printWarning("Symbol file \"", filename,
-			                     "\" doesn't contain any symbols");
+	std::erase_if(pendingLoads, [&](PendingLoad& load) {
+		using namespace std::chrono_literals;
+		if (load.result.wait_for(0s) != std::future_status::ready) return false;
+		if (load.discard) return true;
+
+		const auto& [filename, error, type, slot, segment] = load.info;
+		auto it = std::ranges::find(fileError, filename, &FileInfo::filename);
+		try {
+			if (!symbolManager.addFile(load.result.get(), load.loadEmpty)) {
+				cliComm.printWarning("Symbol file \"", filename,
+				                     "\" doesn't contain any symbols");
+			}
+			if (it != fileError.end()) fileError.erase(it); // clear previous error
+		} catch (MSXException& e) {
+			cliComm.printWarning(
+				"Couldn't load symbol file \"", filename, "\": ", e.getMessage());
+			if (it != fileError.end()) {
+				it->error = e.getMessage(); // overwrite previous error
+				it->type = type;
+			} else {
+				fileError.emplace_back(filename, e.getMessage(), type, slot, segment); // set error
+			}
 		}
-		if (it != fileError.end()) fileError.erase(it); // clear previous error
-	} catch (MSXException& e) {
-		cliComm.printWarning(
-			"Couldn't load symbol file \"", filename, "\": ", e.getMessage());
-		if (it != fileError.end()) {
-			it->error = e.getMessage(); // overwrite previous error
-			it->type = type;
-		} else {
-			fileError.emplace_back(filename, e.getMessage(), type, slot, segment); // set error
+		return true;
+	});
+}
+
+void ImGuiSymbols::discardPendingLoads(std::string_view filename)
+{
+	// Can't abort the background thread, instead ignore the result.
+	for (auto& load : pendingLoads) {
+		if (filename.empty() || load.info.filename == filename) {
+			load.discard = true;
 		}
 	}
 }
@@ -310,6 +352,7 @@ void ImGuiSymbols::drawTable(MSXMotherBoard* motherBoard, const std::string& fil
 
 void ImGuiSymbols::paint(MSXMotherBoard* motherBoard)
 {
+	if (!pendingLoads.empty()) checkPendingLoads();
 	if (!show) return;
 
 	const auto& style = ImGui::GetStyle();
@@ -324,6 +367,10 @@ void ImGuiSymbols::paint(MSXMotherBoard* motherBoard)
 					loadFile(filename, SymbolManager::LoadEmpty::NOT_ALLOWED, type, {}, {});
 				});
 		}
+		if (auto n = std::ranges::count(pendingLoads, false, &PendingLoad::discard)) {
+			ImGui::SameLine();
+			ImGui::StrCat("Loading ", n, " symbol file(s)...");
+		}
 
 		im::TreeNode("Symbols per file", ImGuiTreeNodeFlags_DefaultOpen, [&]{
 			std::optional<FileInfo> reloadAction;
@@ -424,6 +471,7 @@ void ImGuiSymbols::paint(MSXMotherBoard* motherBoard)
 				         reloadAction->type, reloadAction->slot, reloadAction->segment);
 			}
 			if (!removeAction.empty()) {
+				discardPendingLoads(removeAction);
 				symbolManager.removeFile(removeAction);
 				if (auto it = std::ranges::find(fileError, removeAction, &FileInfo::filename);
 					it != fileError.end()) {
@@ -444,6 +492,7 @@ void ImGuiSymbols::paint(MSXMotherBoard* motherBoard)
 			}
 			ImGui::SameLine();
 			if (ImGui::Button("Remove all")) {
+				discardPendingLoads();
 				symbolManager.removeAllFiles();
 				fileError.clear();
 			}
@@ -6,6 +6,7 @@
 #include "SymbolManager.hh"
 
 #include <cstdint>
+#include <future>
 #include <optional>
 #include <vector>
 
@@ -49,6 +50,8 @@ public:
 private:
 	void loadFile(const std::string& filename, SymbolManager::LoadEmpty loadEmpty, SymbolFile::Type type,
 	              std::optional<uint8_t> slot, std::optional<uint16_t> segment);
+	void checkPendingLoads();
+	void discardPendingLoads(std::string_view filename = {});
 
 	template<bool FILTER_FILE>
 	void drawTable(MSXMotherBoard* motherBoard, const std::string& file = {});
@@ -65,6 +68,16 @@ private:
 
 	std::vector<FileInfo> fileError;
 
+	// Symbol files are parsed in a background thread (large files can
+	// take a while), the result is added to the SymbolManager in paint().
+	struct PendingLoad {
+		FileInfo info;
+		SymbolManager::LoadEmpty loadEmpty;
+		std::future<SymbolFile> result;
+		bool discard = false; // file was removed (or reloaded again) meanwhile
+	};
+	std::vector<PendingLoad> pendingLoads;
+
 	struct SortState {
 		int columnIndex = -1;
 		ImGuiSortDirection direction = ImGuiSortDirection_None;
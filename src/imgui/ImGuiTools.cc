@@ -8,6 +8,7 @@
 #include "ImGuiManager.hh"
 #include "ImGuiMessages.hh"
 #include "ImGuiMsxMusicViewer.hh"
+#include "ImGuiPerfMonitor.hh"
 #include "ImGuiPlotterViewer.hh"
 #include "ImGuiSCCViewer.hh"
 #include "ImGuiTrainer.hh"
@@ -148,6 +149,9 @@ void ImGuiTools::showMenu(MSXMotherBoard* motherBoard)
 		simpleToolTip("The plotter should be plugged into the printer port");
 		ImGui::Separator();
 
+		ImGui::MenuItem("Performance monitor", nullptr, &manager.perfMonitor->show);
+		ImGui::Separator();
+
 		im::Menu("Toys", [&]{
 			const auto& toys = getAllToyScripts(manager);
 			for (const auto& toy : toys) {
@@ -330,6 +334,9 @@ void ImGuiTools::paintRecord()
 					ImGui::RadioButton("640 x 480", &recordVideoSize, static_cast<int>(VideoSize::V_640));
 					ImGui::SameLine(0.0f, 30.0f);
 					ImGui::RadioButton("960 x 720", &recordVideoSize, static_cast<int>(VideoSize::V_960));
+					ImGui::Checkbox("Fast compression", &recordFast);
+					HelpMarker("Use about half the CPU time for video compression, "
+						"at the cost of bigger files.");
 				});
 			});
 			ImGui::Separator();
@@ -366,6 +373,9 @@ void ImGuiTools::paintRecord()
 					} else if (recordVideoSize == static_cast<int>(VideoSize::V_960)) {
 						cmd.addListElement("-triplesize");
 					}
+					if (recordFast) {
+						cmd.addListElement("-fast");
+					}
 				}
 
 				if (FileOperations::exists(getRecordFilename())) {
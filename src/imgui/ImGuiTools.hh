@@ -54,6 +54,7 @@ private:
 	int recordAudio = static_cast<int>(Audio::AUTO);
 	enum class VideoSize : int { V_320, V_640, V_960, NUM };
 	int recordVideoSize = static_cast<int>(VideoSize::V_320);
+	bool recordFast = false;
 
 	ConfirmDialogTclCommand confirmDialog;
 
@@ -67,7 +68,8 @@ private:
 		PersistentElement{"screenshotWithOsd", &ImGuiTools::screenshotWithOsd},
 		PersistentElementMax{"recordSource", &ImGuiTools::recordSource, static_cast<int>(Source::NUM)},
 		PersistentElementMax{"recordAudio", &ImGuiTools::recordAudio, static_cast<int>(Audio::NUM)},
-		PersistentElementMax{"recordVideoSize", &ImGuiTools::recordVideoSize, static_cast<int>(VideoSize::NUM)}
+		PersistentElementMax{"recordVideoSize", &ImGuiTools::recordVideoSize, static_cast<int>(VideoSize::NUM)},
+		PersistentElement{"recordFast", &ImGuiTools::recordFast}
 	};
 };
 
@@ -5,19 +5,24 @@
 #include "ImGuiUtils.hh"
 #include "Shortcuts.hh"
 
+#include "Dasm.hh"
 #include "Debugger.hh"
 #include "EmuDuration.hh"
+#include "MSXException.hh"
 #include "MSXMotherBoard.hh"
 #include "ReverseManager.hh"
 
+#include "StringOp.hh"
 #include "find_closest.h"
 #include "one_of.hh"
+#include "strCat.hh"
 #include "timeline.hh"
 
 #include "imgui_stdlib.h"
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 
 namespace openmsx {
 
@@ -258,7 +263,8 @@ static void drawEventsVoid(
 }
 
 static void drawEventsBool(
-	gl::vec2 topLeft, const Convertor& convertor, EmuTime maxT, Events events, bool rowHovered)
+	gl::vec2 topLeft, const Convertor& convertor, EmuTime maxT, const Tracer::Trace& trace,
+	Events events, bool rowHovered)
 {
 	if (events.empty()) return;
 
@@ -295,8 +301,25 @@ static void drawEventsBool(
 		yp = y;
 	};
 	auto dummyFormat = Tracer::Trace::Format::DEC;
-	processTimeline(events, maxT, convertor, drawDetailed,
-	                DrawCoarse{nullptr, drawList, topLeft.x, y0, y1, colorNormal, colorHover, dummyFormat, rowHovered});
+	DrawCoarse drawBlock{nullptr, drawList, topLeft.x, y0, y1, colorNormal, colorHover, dummyFormat, rowHovered};
+	auto drawCoarse = [&](float x0, float x1, auto first, auto last) {
+		// Many events, but possibly all with the same value.
+		auto begin = size_t(std::to_address(first) - trace.events.data());
+		auto end = begin + size_t(last - first);
+		auto summary = trace.summary.summarize(begin, end);
+		if (summary.numEdges == 0) {
+			drawDetailed(x0, x1, *first);
+			return;
+		}
+		drawBlock(x0, x1, first, last);
+		yp = summary.last ? y0 : y1;
+		if (rowHovered && (topLeft.x + x0) <= mouseX && mouseX < (topLeft.x + x1)) {
+			im::Tooltip([&]{
+				ImGui::StrCat(summary.numEdges, " edges");
+			});
+		}
+	};
+	processTimeline(events, maxT, convertor, drawDetailed, drawCoarse);
 }
 
 [[nodiscard]] std::string_view ImGuiTraceViewer::formatTraceValue(const TraceValue& value, std::span<char, 64> tmpBuf,
@@ -435,6 +458,14 @@ void ImGuiTraceViewer::drawMenuBar(EmuTime minT, EmuDuration totalT, Tracer& tra
 					}
 				});
 		}
+		ImGui::Separator();
+		if (ImGui::MenuItem("Load instruction trace ...")) {
+			manager.openFile->selectFile(
+				"Load instruction trace", "Instruction trace (*.itrace){.itrace}",
+				[&](const auto& fn) { loadInstructionTrace(fn); });
+		}
+		ImGui::MenuItem("Show instruction trace", nullptr, &showInstructionTrace, instructionTrace != nullptr);
+		ImGui::Separator();
 		if (ImGui::MenuItem("Close")) show = false;
 	});
 	im::Menu("View", [&]{
@@ -815,33 +846,40 @@ void ImGuiTraceViewer::scrollTo(EmuTime time)
 	return std::to_address(it);
 }
 
+// Use the summary index to skip over (possibly many) events with the same value.
+[[nodiscard]] static const Tracer::Event* findSmallerWithValue(const Tracer::Trace& trace, EmuTime time, bool value)
+{
+	if (!trace.isBool()) return findStrictlySmaller(trace, time);
+	auto it = std::ranges::lower_bound(trace.events, time, {}, &Tracer::Event::time);
+	auto idx = trace.summary.findPrev(size_t(it - trace.events.begin()), value);
+	return idx ? &trace.events[*idx] : nullptr;
+}
+
+[[nodiscard]] static const Tracer::Event* findBiggerWithValue(const Tracer::Trace& trace, EmuTime time, bool value)
+{
+	if (!trace.isBool()) return findStrictlyBigger(trace, time);
+	auto it = std::ranges::upper_bound(trace.events, time, {}, &Tracer::Event::time);
+	auto idx = trace.summary.findNext(size_t(it - trace.events.begin()), value);
+	return (idx < trace.events.size()) ? &trace.events[idx] : nullptr;
+}
+
 void ImGuiTraceViewer::gotoPrevNegEdge(EmuTime& selectedTime)
 {
 	if (const auto* trace = getTrace(traces, selectedRow)) {
-		auto time = selectedTime;
-		while (true) {
-			const auto* event = findStrictlySmaller(*trace, time);
-			if (!event) return;
-			time = event->time;
-			if (!trace->isBool() || event->value.get_u64() == 0) break;
+		if (const auto* event = findSmallerWithValue(*trace, selectedTime, false)) {
+			selectedTime = event->time;
+			scrollTo(event->time);
 		}
-		selectedTime = time;
-		scrollTo(time);
 	}
 }
 
 void ImGuiTraceViewer::gotoPrevPosEdge(EmuTime& selectedTime)
 {
 	if (const auto* trace = getTrace(traces, selectedRow)) {
-		auto time = selectedTime;
-		while (true) {
-			const auto* event = findStrictlySmaller(*trace, time);
-			if (!event) return;
-			time = event->time;
-			if (!trace->isBool() || event->value.get_u64() != 0) break;
+		if (const auto* event = findSmallerWithValue(*trace, selectedTime, true)) {
+			selectedTime = event->time;
+			scrollTo(event->time);
 		}
-		selectedTime = time;
-		scrollTo(time);
 	}
 }
 
@@ -868,30 +906,20 @@ void ImGuiTraceViewer::gotoNextEdge(EmuTime& selectedTime)
 void ImGuiTraceViewer::gotoNextNegEdge(EmuTime& selectedTime)
 {
 	if (const auto* trace = getTrace(traces, selectedRow)) {
-		auto time = selectedTime;
-		while (true) {
-			const auto* event = findStrictlyBigger(*trace, time);
-			if (!event) return;
-			time = event->time;
-			if (!trace->isBool() || event->value.get_u64() == 0) break;
+		if (const auto* event = findBiggerWithValue(*trace, selectedTime, false)) {
+			selectedTime = event->time;
+			scrollTo(event->time);
 		}
-		selectedTime = time;
-		scrollTo(time);
 	}
 }
 
 void ImGuiTraceViewer::gotoNextPosEdge(EmuTime& selectedTime)
 {
 	if (const auto* trace = getTrace(traces, selectedRow)) {
-		auto time = selectedTime;
-		while (true) {
-			const auto* event = findStrictlyBigger(*trace, time);
-			if (!event) return;
-			time = event->time;
-			if (!trace->isBool() || event->value.get_u64() != 0) break;
+		if (const auto* event = findBiggerWithValue(*trace, selectedTime, true)) {
+			selectedTime = event->time;
+			scrollTo(event->time);
 		}
-		selectedTime = time;
-		scrollTo(time);
 	}
 }
 
@@ -1123,7 +1151,22 @@ void ImGuiTraceViewer::drawNames(float rulerHeight, float rowHeight, int mouseRo
 				selectedRow = row;
 				openContext = true;
 			}
-			simpleToolTip(trace->description);
+			simpleToolTip([&]{
+				auto result = trace->description;
+				auto addLine = [&](auto&&... args) {
+					strAppend(result, result.empty() ? "" : "\n", std::forward<decltype(args)>(args)...);
+				};
+				if (!trace->archive.empty()) {
+					addLine(trace->archive.size(), " older events are moved to a temporary file "
+					        "(see 'trace_memory_limit'), these are not shown here, "
+					        "but they are included in 'Export as VCD'.");
+				}
+				if (trace->numDropped) {
+					addLine(trace->numDropped, " older events were lost because "
+					        "they couldn't be written to a temporary file.");
+				}
+				return result;
+			});
 		});
 		drawList->PopClipRect();
 
@@ -1355,7 +1398,7 @@ void ImGuiTraceViewer::drawGraphs(float rulerHeight, float rowHeight, int mouseR
 				drawEventsVoid(tl, convertor, maxT, visibleEvents, rowHovered);
 				break;
 			case Tracer::Trace::Type::BOOL:
-				drawEventsBool(tl, convertor, maxT, visibleEvents, rowHovered);
+				drawEventsBool(tl, convertor, maxT, trace, visibleEvents, rowHovered);
 				break;
 			default:
 				drawEventsValue(tl, convertor, maxT, visibleEvents, rowHovered, trace.getFormat());
@@ -1468,6 +1511,125 @@ void ImGuiTraceViewer::paint(MSXMotherBoard* motherBoard)
 			paintHelp();
 		});
 	}
+	if (showInstructionTrace && instructionTrace) {
+		ImGui::SetNextWindowSize(gl::vec2{60, 30} * ImGui::GetFontSize(), ImGuiCond_FirstUseEver);
+		im::Window("Instruction Trace", &showInstructionTrace, [&] {
+			paintInstructionTrace();
+		});
+	}
+}
+
+void ImGuiTraceViewer::loadInstructionTrace(const std::string& filename)
+{
+	try {
+		instructionTrace = std::make_unique<InstructionTraceFile>(filename);
+		instrTraceSelected = 0;
+		instrTraceScrollTo = 0;
+		showInstructionTrace = true;
+	} catch (MSXException& e) {
+		manager.printError("Couldn't load instruction trace: ", e.getMessage());
+	}
+}
+
+void ImGuiTraceViewer::paintInstructionTrace()
+{
+	auto& trace = *instructionTrace;
+	// ImGuiListClipper uses 'int' indices
+	auto count = std::min<uint64_t>(trace.size(), std::numeric_limits<int>::max());
+	ImGui::TextUnformatted(strCat(trace.getFilename(), ": ", trace.size(), " instructions"));
+	if (count == 0) return;
+
+	ImGui::SetNextItemWidth(10.0f * ImGui::GetFontSize());
+	if (ImGui::InputText("##goto", &instrTraceGoto, ImGuiInputTextFlags_EnterReturnsTrue)) {
+		if (auto n = StringOp::stringTo<uint64_t>(instrTraceGoto)) {
+			instrTraceSelected = std::min(*n, count - 1);
+			instrTraceScrollTo = instrTraceSelected;
+		}
+	}
+	simpleToolTip("Go to instruction number");
+	ImGui::SameLine();
+	if (ImGui::Button("Primary marker")) {
+		try {
+			instrTraceSelected = std::min(trace.findTime(selectedTime1.toUint64()), count - 1);
+			instrTraceScrollTo = instrTraceSelected;
+		} catch (MSXException& e) {
+			manager.printError(e.getMessage());
+		}
+	}
+	simpleToolTip("Go to the first instruction at or after the primary marker in the Probe/Trace Viewer");
+
+	int flags = ImGuiTableFlags_RowBg |
+	            ImGuiTableFlags_BordersV |
+	            ImGuiTableFlags_BordersOuter |
+	            ImGuiTableFlags_Hideable |
+	            ImGuiTableFlags_ScrollY;
+	im::Table("##instructions", 11, flags, [&]{
+		ImGui::TableSetupScrollFreeze(0, 1); // Make top row always visible
+		ImGui::TableSetupColumn("#");
+		ImGui::TableSetupColumn("time (s)");
+		ImGui::TableSetupColumn("PC");
+		ImGui::TableSetupColumn("opcode", ImGuiTableColumnFlags_DefaultHide);
+		ImGui::TableSetupColumn("instruction");
+		ImGui::TableSetupColumn("AF");
+		ImGui::TableSetupColumn("BC");
+		ImGui::TableSetupColumn("DE");
+		ImGui::TableSetupColumn("HL");
+		ImGui::TableSetupColumn("IX", ImGuiTableColumnFlags_DefaultHide);
+		ImGui::TableSetupColumn("SP");
+		ImGui::TableHeadersRow();
+
+		auto forceIndex = instrTraceScrollTo ? narrow<int>(*instrTraceScrollTo) : -1;
+		std::string str;
+		im::ListClipper(count, forceIndex, [&](int i) {
+			InstructionTrace::Record record;
+			try {
+				record = trace.getRecord(i);
+			} catch (MSXException&) {
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted("corrupt"sv);
+				return;
+			}
+			auto time = EmuTime::fromUint64(record.time);
+			uint16_t pc = record.pc;
+			auto len = instructionLength(record.opcode).value_or(1);
+			auto opcode = std::span{record.opcode}.first(len);
+
+			if (ImGui::TableNextColumn()) { // #
+				if (ImGui::Selectable(tmpStrCat(i).c_str(), uint64_t(i) == instrTraceSelected,
+				                      ImGuiSelectableFlags_SpanAllColumns)) {
+					instrTraceSelected = i;
+					selectedTime1 = time; // also move primary marker
+				}
+				if (instrTraceScrollTo && (*instrTraceScrollTo == uint64_t(i))) {
+					ImGui::SetScrollHereY(0.5f);
+					instrTraceScrollTo.reset();
+				}
+			}
+			if (ImGui::TableNextColumn()) { // time
+				ImGui::Text("%.9f", time.toDouble());
+			}
+			if (ImGui::TableNextColumn()) { // PC
+				ImGui::Text("%04X", pc);
+			}
+			if (ImGui::TableNextColumn()) { // opcode
+				str.clear();
+				for (auto b : opcode) strAppend(str, hex_string<2>(b), ' ');
+				ImGui::TextUnformatted(str);
+			}
+			if (ImGui::TableNextColumn()) { // instruction
+				str.clear();
+				dasm(opcode, pc, str);
+				ImGui::TextUnformatted(str);
+			}
+			for (uint16_t reg : {uint16_t(record.af), uint16_t(record.bc), uint16_t(record.de),
+			                     uint16_t(record.hl), uint16_t(record.ix), uint16_t(record.sp)}) {
+				if (ImGui::TableNextColumn()) {
+					ImGui::Text("%04X", reg);
+				}
+			}
+		});
+	});
 }
 
 const std::vector<Tracer::Trace*>& ImGuiTraceViewer::getTraces(MSXMotherBoard& motherBoard)
@@ -5,10 +5,15 @@
 
 #include "EmuDuration.hh"
 #include "EmuTime.hh"
+#include "InstructionTraceFile.hh"
 #include "Tracer.hh"
 
 #include "gl_vec.hh"
 
+#include <cstdint>
+#include <memory>
+#include <optional>
+
 namespace openmsx {
 
 struct Convertor;
@@ -82,6 +87,8 @@ private:
 	void paintMain(MSXMotherBoard& motherBoard);
 	void paintSelect(MSXMotherBoard& motherBoard);
 	void paintHelp();
+	void paintInstructionTrace();
+	void loadInstructionTrace(const std::string& filename);
 
 private:
 	std::vector<Tracer::Trace*> traces; // recalculated each frame, but can be queried by ImGuiRasterViewer
@@ -143,6 +150,13 @@ private:
 	std::optional<HelpSection> helpSection;
 	bool showHelp = false;
 
+	// binary instruction trace, see 'debug instruction_trace'
+	std::unique_ptr<InstructionTraceFile> instructionTrace;
+	std::optional<uint64_t> instrTraceScrollTo;
+	uint64_t instrTraceSelected = 0;
+	std::string instrTraceGoto;
+	bool showInstructionTrace = false;
+
 	static constexpr auto persistentElements = std::tuple{
 		PersistentElement   {"show",             &ImGuiTraceViewer::show},
 		PersistentElement   {"showSelect",       &ImGuiTraceViewer::showSelect},
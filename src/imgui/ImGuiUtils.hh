@@ -5,6 +5,7 @@
 
 #include "Reactor.hh"
 
+#include "DirtyPages.hh"
 #include "Math.hh"
 #include "StringOp.hh"
 #include "circular_buffer.hh"
@@ -453,6 +454,21 @@ public:
 		}
 		return vram[addr];
 	}
+
+	/** Was any part of this table written to since the given epoch?
+	  * Conservative: checks all addresses between the lowest and the
+	  * highest address of the table. */
+	[[nodiscard]] bool isDirty(const DirtyPages& dirty, DirtyPages::Epoch since) const {
+		auto first = getAddress(0);
+		auto last = getAddress(~0u);
+		if (planar) {
+			// even addresses in the lower, odd in the upper 64kB
+			auto num = (last >> 1) - (first >> 1) + 1;
+			return dirty.isRangeDirty(first >> 1, num, since) ||
+			       dirty.isRangeDirty(0x1'0000 | (first >> 1), num, since);
+		}
+		return dirty.isRangeDirty(first, last - first + 1, since);
+	}
 private:
 	std::span<const uint8_t> vram;
 	unsigned registerMask = 0;
@@ -5,7 +5,10 @@
 #include "ImGuiUtils.hh"
 
 #include "CommandException.hh"
+#include "Debugger.hh"
+#include "MSXMotherBoard.hh"
 #include "SymbolManager.hh"
+#include "Timer.hh"
 
 #include "narrow.hh"
 
@@ -54,9 +57,36 @@ void ImGuiWatchExpr::loadLine(std::string_view name, zstring_view value)
 	}
 }
 
-void ImGuiWatchExpr::paint(MSXMotherBoard* /*motherBoard*/)
+void ImGuiWatchExpr::checkRefresh(MSXMotherBoard* motherBoard)
+{
+	// Re-evaluating all expressions every frame is wasteful: typically
+	// they only change when the emulated machine has advanced. While
+	// running, limit the update rate (faster is unreadable anyway). When
+	// paused, memory can still be changed (e.g. via the debugger), so also
+	// refresh periodically.
+	static constexpr uint64_t RUNNING_INTERVAL =  50'000; // us
+	static constexpr uint64_t PAUSED_INTERVAL  = 500'000; // us
+
+	auto now = Timer::getTime();
+	auto elapsed = now - lastRefresh;
+	std::optional<EmuTime> time;
+	if (motherBoard) time = motherBoard->getCurrentTime();
+	bool machineChanged = motherBoard != lastMotherBoard;
+	bool advanced = time != lastTime;
+	if (machineChanged ||
+	    (advanced && elapsed >= RUNNING_INTERVAL) ||
+	    (elapsed >= PAUSED_INTERVAL)) {
+		for (auto& watch : watches) watch.result.reset();
+		lastMotherBoard = motherBoard;
+		lastTime = time;
+		lastRefresh = now;
+	}
+}
+
+void ImGuiWatchExpr::paint(MSXMotherBoard* motherBoard)
 {
 	if (!show) return;
+	checkRefresh(motherBoard);
 
 	ImGui::SetNextWindowSize(gl::vec2{35, 15} * ImGui::GetFontSize(), ImGuiCond_FirstUseEver);
 	im::Window("Watch expression", &show, [&]{
@@ -84,7 +114,7 @@ void ImGuiWatchExpr::paint(MSXMotherBoard* /*motherBoard*/)
 				checkSort();
 
 				im::ID_for_range(watches.size(), [&](int row) {
-					drawRow(row);
+					drawRow(row, motherBoard);
 				});
 			});
 		});
@@ -179,11 +209,12 @@ void ImGuiWatchExpr::refreshSymbols()
 {
 	// symbols changed, expression might have used those symbols
 	for (auto& watch : watches) {
-		watch.expression.reset(); // drop cache
+		watch.dropCache();
 	}
 }
 
-std::expected<TclObject, std::string> ImGuiWatchExpr::evalExpr(WatchExpr& watch, Interpreter& interp) const
+std::expected<TclObject, std::string> ImGuiWatchExpr::evalExpr(
+	WatchExpr& watch, Interpreter& interp, MSXMotherBoard* motherBoard) const
 {
 	if (watch.exprStr.empty()) return {};
 
@@ -195,9 +226,16 @@ std::expected<TclObject, std::string> ImGuiWatchExpr::evalExpr(WatchExpr& watch,
 			// keep original expression
 			watch.expression = watch.exprStr;
 		}
+		// try to avoid the Tcl interpreter for simple expressions
+		watch.compiled = CompiledCondition::compile(watch.expression->getString());
 	}
 	assert(watch.expression);
 
+	if (watch.compiled && motherBoard) {
+		if (auto v = watch.compiled->evaluateValue(motherBoard->getDebugger())) {
+			return TclObject(*v);
+		}
+	}
 	try {
 		return watch.expression->eval(interp);
 	} catch (CommandException& e) {
@@ -205,26 +243,32 @@ std::expected<TclObject, std::string> ImGuiWatchExpr::evalExpr(WatchExpr& watch,
 	}
 }
 
-void ImGuiWatchExpr::drawRow(int row)
+void ImGuiWatchExpr::drawRow(int row, MSXMotherBoard* motherBoard)
 {
 	auto& interp = manager.getInterpreter();
 	auto& watch = watches[row];
 
-	// evaluate 'expression'
-	auto exprVal = evalExpr(watch, interp);
-
-	// format the result
-	std::expected<TclObject, std::string> formatted;
-	if (!watch.format.getString().empty()) {
-		auto frmtCmd = makeTclList("format", watch.format, exprVal ? *exprVal : TclObject("0"));
-		try {
-			formatted = frmtCmd.executeCommand(interp);
-		} catch (CommandException& e) {
-			formatted = std::unexpected(e.getMessage());
+	if (!watch.result) {
+		// evaluate 'expression'
+		auto exprVal = evalExpr(watch, interp, motherBoard);
+
+		// format the result
+		std::expected<TclObject, std::string> formatted;
+		if (!watch.format.getString().empty()) {
+			auto frmtCmd = makeTclList("format", watch.format, exprVal ? *exprVal : TclObject("0"));
+			try {
+				formatted = frmtCmd.executeCommand(interp);
+			} catch (CommandException& e) {
+				formatted = std::unexpected(e.getMessage());
+			}
+		} else {
+			formatted = exprVal ? *exprVal : TclObject();
 		}
-	} else {
-		formatted = exprVal ? *exprVal : TclObject();
+		watch.result.emplace(std::move(exprVal), std::move(formatted));
 	}
+	// copy: editing below may drop the cached result
+	auto exprVal = watch.result->value;
+	auto formatted = watch.result->formatted;
 
 	const auto& display = exprVal ? (formatted ? formatted->getString() : exprVal->getString())
 	                              : exprVal.error();
@@ -255,7 +299,7 @@ void ImGuiWatchExpr::drawRow(int row)
 			auto avail = ImGui::GetContentRegionAvail().x;
 			ImGui::SetNextItemWidth(-FLT_MIN);
 			if (ImGui::InputText("##expr", &watch.exprStr)) {
-				watch.expression.reset();
+				watch.dropCache();
 			}
 			tooWideToolTip(avail, watch.exprStr);
 		});
@@ -268,6 +312,7 @@ void ImGuiWatchExpr::drawRow(int row)
 			auto str = std::string(watch.format.getString());
 			if (ImGui::InputText("##format", &str)) {
 				watch.format = str;
+				watch.result.reset();
 			}
 			if (formatted) {
 				tooWideToolTip(avail, str);
@@ -3,9 +3,13 @@
 
 #include "ImGuiPart.hh"
 
+#include "CompiledCondition.hh"
+#include "EmuTime.hh"
 #include "TclObject.hh"
 
+#include <cstdint>
 #include <expected>
+#include <optional>
 #include <vector>
 
 namespace openmsx {
@@ -31,15 +35,24 @@ public:
 		[[nodiscard]] const auto& getExpression()  const { return exprStr; }
 		[[nodiscard]] const auto& getFormat()      const { return format; }
 		void setDescription(const TclObject& d) { description = d.getString(); }
-		void setExpression (const TclObject& e) { exprStr = e.getString(); expression.reset(); }
-		void setFormat     (const TclObject& f) { format = f.getString(); }
+		void setExpression (const TclObject& e) { exprStr = e.getString(); dropCache(); }
+		void setFormat     (const TclObject& f) { format = f.getString(); result.reset(); }
+		void dropCache() { expression.reset(); compiled.reset(); result.reset(); }
 
 		unsigned id = 0;
 		std::string description;
 		std::string exprStr;
 		std::optional<TclObject> expression; // cache, generate from 'expression'
+		std::optional<CompiledCondition> compiled; // only valid when 'expression' is set
 		TclObject format;
 
+		// cached evaluation result, see ImGuiWatchExpr::paint()
+		struct Result {
+			std::expected<TclObject, std::string> value;
+			std::expected<TclObject, std::string> formatted;
+		};
+		std::optional<Result> result;
+
 		static inline unsigned lastId = 0;
 	};
 
@@ -56,8 +69,9 @@ public:
 	[[nodiscard]] auto& getWatchExprs() { return watches; }
 
 private:
-	void drawRow(int row);
+	void drawRow(int row, MSXMotherBoard* motherBoard);
 	void checkSort();
+	void checkRefresh(MSXMotherBoard* motherBoard);
 
 public:
 	bool show = false;
@@ -67,10 +81,16 @@ private:
 
 	std::vector<WatchExpr> watches;
 
-	[[nodiscard]] std::expected<TclObject, std::string> evalExpr(WatchExpr& watch, Interpreter& interp) const;
+	[[nodiscard]] std::expected<TclObject, std::string> evalExpr(
+		WatchExpr& watch, Interpreter& interp, MSXMotherBoard* motherBoard) const;
 
 	int selectedRow = -1;
 
+	// When to re-evaluate the expressions, see checkRefresh().
+	MSXMotherBoard* lastMotherBoard = nullptr;
+	std::optional<EmuTime> lastTime;
+	uint64_t lastRefresh = 0; // in us
+
 	static constexpr auto persistentElements = std::tuple{
 		PersistentElement{"show", &ImGuiWatchExpr::show},
 		// manually handle 'watches'
@@ -2,6 +2,7 @@
 
 #include "Event.hh"
 #include "EventDistributor.hh"
+#include "InputEventGenerator.hh"
 #include "MSXEventDistributor.hh"
 #include "MSXException.hh"
 #include "ReverseManager.hh"
@@ -21,15 +22,21 @@ namespace openmsx {
 EventDelay::EventDelay(Scheduler& scheduler_,
                        CommandController& commandController,
                        EventDistributor& eventDistributor_,
+                       InputEventGenerator& inputEventGenerator_,
                        MSXEventDistributor& msxEventDistributor_,
                        ReverseManager& reverseManager)
 	: Schedulable(scheduler_)
 	, eventDistributor(eventDistributor_)
+	, inputEventGenerator(inputEventGenerator_)
 	, msxEventDistributor(msxEventDistributor_)
 	, prevReal(Timer::getTime())
 	, delaySetting(
 		commandController, "inputdelay",
 		"delay input to avoid key-skips", 0.0, 0.0, 10.0)
+	, lateSamplingSetting(
+		commandController, "late_input_sampling",
+		"poll host input right before emulating the next frame, "
+		"this lowers the input latency", false)
 {
 	using enum EventType;
 	for (auto type : {KEY_DOWN, KEY_UP,
@@ -60,6 +67,13 @@ bool EventDelay::signalEvent(const Event& event)
 	return false;
 }
 
+void EventDelay::sampleInput()
+{
+	if (lateSamplingSetting.getBoolean()) {
+		inputEventGenerator.poll();
+	}
+}
+
 void EventDelay::sync(EmuTime curEmu)
 {
 	auto curRealTime = Timer::getTime();
@@ -128,7 +142,6 @@ void EventDelay::sync(EmuTime curEmu)
 			}
 		}
 #endif
-		scheduledEvents.push_back(e);
 		const auto& sdlEvent = get_event<SdlEvent>(e);
 		uint32_t eventSdlTime = sdlEvent.getCommonSdlEvent().timestamp;
 		uint32_t sdlNow = SDL_GetTicks();
@@ -140,6 +153,9 @@ void EventDelay::sync(EmuTime curEmu)
 		               ? time - emuOffset
 		               : curEmu;
 		assert(curEmu <= schedTime);
+		if (mergeMotion(e, schedTime)) continue;
+		scheduledEvents.push_back(e);
+		lastScheduledTime = schedTime;
 		setSyncPoint(schedTime);
 	}
 	toBeScheduledEvents.clear();
@@ -149,6 +165,31 @@ void EventDelay::sync(EmuTime curEmu)
 #endif
 }
 
+bool EventDelay::mergeMotion(const Event& event, EmuTime schedTime)
+{
+	// A high polling-rate mouse generates up to 1000 motion events per
+	// second, and each of those would become a separate StateChange in
+	// the reverse/replay history. When the previous (not yet delivered)
+	// event is also a mouse motion at the same EmuTime, the MSX can't
+	// observe the difference, so combine both. The relative motion is
+	// summed (the devices themselves handle the sub-step fractions), the
+	// absolute position is the latest.
+	if (getType(event) != EventType::MOUSE_MOTION) return false;
+	if (scheduledEvents.empty() || (lastScheduledTime != schedTime)) return false;
+	auto& last = scheduledEvents.back();
+	if (getType(last) != EventType::MOUSE_MOTION) return false;
+
+	SDL_Event merged = get_event<MouseMotionEvent>(last).getSdlEvent();
+	const auto& motion = get_event<MouseMotionEvent>(event).getSdlEvent().motion;
+	merged.motion.xrel += motion.xrel;
+	merged.motion.yrel += motion.yrel;
+	merged.motion.x = motion.x;
+	merged.motion.y = motion.y;
+	merged.motion.state = motion.state;
+	last = MouseMotionEvent(merged);
+	return true;
+}
+
 void EventDelay::executeUntil(EmuTime time)
 {
 	try {
@@ -1,6 +1,7 @@
 #ifndef EVENTDELAY_HH
 #define EVENTDELAY_HH
 
+#include "BooleanSetting.hh"
 #include "EmuTime.hh"
 #include "Event.hh"
 #include "EventListener.hh"
@@ -18,6 +19,7 @@ namespace openmsx {
 class Scheduler;
 class CommandController;
 class EventDistributor;
+class InputEventGenerator;
 class MSXEventDistributor;
 class ReverseManager;
 
@@ -30,6 +32,7 @@ class EventDelay final : private EventListener, private Schedulable
 public:
 	EventDelay(Scheduler& scheduler, CommandController& commandController,
 	           EventDistributor& eventDistributor,
+	           InputEventGenerator& inputEventGenerator,
 	           MSXEventDistributor& msxEventDistributor,
 	           ReverseManager& reverseManager);
 	~EventDelay();
@@ -37,6 +40,16 @@ public:
 	void sync(EmuTime curEmu);
 	void flush();
 
+	/** When the 'late_input_sampling' setting is enabled, poll the host
+	  * input (SDL) now. RealTime calls this right after it has slept to
+	  * catch up with real time, so right before emulation of the next
+	  * frame starts. Without this, input that arrives while sleeping is
+	  * only seen one main-loop iteration (typically one frame) later.
+	  * The polled events are queued in the EventDistributor, and still
+	  * delivered before emulation continues.
+	  */
+	void sampleInput();
+
 private:
 	// EventListener
 	bool signalEvent(const Event& event) override;
@@ -44,12 +57,18 @@ private:
 	// Schedulable
 	void executeUntil(EmuTime time) override;
 
+	/** Try to combine a mouse motion event with the last scheduled
+	  * event. Returns true when merged (then 'event' should be dropped). */
+	[[nodiscard]] bool mergeMotion(const Event& event, EmuTime schedTime);
+
 private:
 	EventDistributor& eventDistributor;
+	InputEventGenerator& inputEventGenerator;
 	MSXEventDistributor& msxEventDistributor;
 
 	std::vector<Event> toBeScheduledEvents;
 	std::deque<Event> scheduledEvents;
+	EmuTime lastScheduledTime = EmuTime::zero(); // of scheduledEvents.back()
 
 #if PLATFORM_ANDROID
 	std::vector<std::pair<int, Event>> nonMatchedKeyPresses;
@@ -58,6 +77,7 @@ private:
 	EmuTime prevEmu = EmuTime::zero();
 	uint64_t prevReal;
 	FloatSetting delaySetting;
+	BooleanSetting lateSamplingSetting;
 };
 
 } // namespace openmsx
@@ -1651,14 +1651,16 @@ Keyboard::KeyInserter::KeyInserter(
 void Keyboard::KeyInserter::execute(
 	std::span<const TclObject> tokens, TclObject& /*result*/, EmuTime /*time*/)
 {
-	checkNumArgs(tokens, AtLeast{2}, "?-release? ?-freq hz? ?-cancel? text");
+	checkNumArgs(tokens, AtLeast{2}, "?-release? ?-fast? ?-freq hz? ?-cancel? text");
 
 	bool cancel = false;
 	releaseBeforePress = false;
+	fast = false;
 	typingFrequency = 15;
 	std::array info = {
 		flagArg("-cancel", cancel),
 		flagArg("-release", releaseBeforePress),
+		flagArg("-fast", fast),
 		valueArg("-freq", typingFrequency),
 	};
 	auto arguments = parseTclArgs(getInterpreter(), tokens.subspan(1), info);
@@ -1681,13 +1683,14 @@ std::string Keyboard::KeyInserter::help(std::span<const TclObject> /*tokens*/) c
 	return "Type a string in the emulated MSX.\n"
 	       "Use -release to make sure the keys are always released before typing new ones (necessary for some game input routines, but in general, this means typing is twice as slow).\n"
 	       "Use -freq to tweak how fast typing goes and how long the keys will be pressed (and released in case -release was used). Keys will be typed at the given frequency and will remain pressed/released for 1/freq seconds\n"
+	       "Use -fast to continue with the next key as soon as the MSX has scanned the keyboard (but at the latest after 1/freq seconds). This is usually a lot faster, but doesn't work with software that only looks at the keyboard state some time after it was scanned.\n"
 	       "Use -cancel to cancel a (long) in-progress type command.";
 }
 
 void Keyboard::KeyInserter::tabCompletion(std::vector<std::string>& tokens) const
 {
 	using namespace std::literals;
-	static constexpr std::array options = {"-release"sv, "-freq"sv};
+	static constexpr std::array options = {"-release"sv, "-fast"sv, "-freq"sv};
 	completeString(tokens, options);
 }
 
@@ -1707,6 +1710,7 @@ void Keyboard::KeyInserter::type(std::string_view str)
 void Keyboard::KeyInserter::executeUntil(EmuTime time)
 {
 	auto& keyboard = OUTER(Keyboard, keyTypeCmd);
+	unscannedRows = 0;
 	if (lockKeysMask != 0) {
 		// release CAPS and/or Code/Kana Lock keys
 		keyboard.pressLockKeys(lockKeysMask, false);
@@ -1761,6 +1765,25 @@ void Keyboard::KeyInserter::executeUntil(EmuTime time)
 void Keyboard::KeyInserter::reschedule(EmuTime time)
 {
 	setSyncPoint(time + EmuDuration::hz(typingFrequency));
+	// Rows 0-8 are present on all MSX keyboards, and they contain all
+	// keys used for typing. A (BIOS) keyboard scan reads all of them.
+	// Between scans the BIOS may read some individual rows (e.g. to check
+	// for CTRL+STOP), that's why we wait for all of them, not only for
+	// the rows that changed.
+	if (fast) unscannedRows = 0x1FF;
+}
+
+void Keyboard::KeyInserter::rowRead(unsigned row, EmuTime time)
+{
+	assert(unscannedRows != 0);
+	assert(row < 16);
+	unscannedRows &= uint16_t(~(1 << row));
+	if (unscannedRows == 0) {
+		// All rows have seen the new key state, continue right away
+		// instead of waiting for the (slower) 1/freq timeout.
+		removeSyncPoint();
+		setSyncPoint(time);
+	}
 }
 
 
@@ -2001,7 +2024,7 @@ void Keyboard::KeybDebuggable::write(unsigned /*address*/, uint8_t /*value*/)
 
 
 template<typename Archive>
-void Keyboard::KeyInserter::serialize(Archive& ar, unsigned /*version*/)
+void Keyboard::KeyInserter::serialize(Archive& ar, unsigned version)
 {
 	ar.template serializeBase<Schedulable>(*this);
 	ar.serialize("text", text_utf8,
@@ -2023,6 +2046,10 @@ void Keyboard::KeyInserter::serialize(Archive& ar, unsigned /*version*/)
 		           | (oldGraphLockOn ? KeyInfo::GRAPH_MASK : 0)
 		           | (oldCapsLockOn ? KeyInfo::CAPS_MASK : 0);
 	}
+	if (ar.versionAtLeast(version, 2)) {
+		ar.serialize("fast",          fast,
+		             "unscannedRows", unscannedRows);
+	}
 }
 
 // version 1: Initial version: {userKeyMatrix, dynKeymap, msxModifiers,
@@ -73,6 +73,14 @@ public:
 	 */
 	[[nodiscard]] std::span<const uint8_t, KeyMatrixPosition::NUM_ROWS> getKeys() const;
 
+	/** Must be called when the emulated MSX reads a row of the key matrix
+	  * (so not for peeks). Used by 'type -fast' to find out when the typed
+	  * keys have been seen.
+	  */
+	void signalRowRead(unsigned row, EmuTime time) {
+		if (keyTypeCmd.isWaitingForScan()) keyTypeCmd.rowRead(row, time);
+	}
+
 	void transferHostKeyMatrix(const Keyboard& source);
 	void setFocus(bool newFocus, EmuTime time);
 
@@ -152,6 +160,8 @@ private:
 			    StateChangeDistributor& stateChangeDistributor,
 			    Scheduler& scheduler);
 		[[nodiscard]] bool isActive() const { return isPending().has_value(); }
+		[[nodiscard]] bool isWaitingForScan() const { return unscannedRows != 0; }
+		void rowRead(unsigned row, EmuTime time);
 		template<typename Archive>
 		void serialize(Archive& ar, unsigned version);
 
@@ -176,7 +186,11 @@ private:
 		uint8_t oldLocksOn = 0;
 
 		bool releaseBeforePress = false;
+		bool fast = false;
 		int typingFrequency = 15;
+		// In fast mode: the rows that still need to be read by the MSX
+		// before the next key can be typed (see rowRead()).
+		uint16_t unscannedRows = 0;
 	} keyTypeCmd;
 
 	struct Msxcode2UnicodeCmd final : public Command {
@@ -287,6 +301,7 @@ private:
 	bool focus = true;
 };
 SERIALIZE_CLASS_VERSION(Keyboard, 5);
+SERIALIZE_CLASS_VERSION(Keyboard::KeyInserter, 2);
 
 } // namespace openmsx
 
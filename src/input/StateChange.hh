@@ -376,6 +376,8 @@ using StateChange = std::variant<
 	MouseState,
 	JoyMegaState
 >;
+// Keep this small: replays can contain millions of these (see ReverseManager).
+static_assert(sizeof(StateChange) <= 32);
 
 inline auto getTime(const StateChange& event)
 {
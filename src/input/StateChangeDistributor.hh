@@ -12,6 +12,17 @@
 
 namespace openmsx {
 
+/** All input that influences the emulation passes through here as
+  * timestamped StateChange events. Recording those (plus snapshots) is what
+  * makes replays deterministic.
+  *
+  * Note: the same property would in principle allow rollback netplay
+  * (exchange StateChanges, predict remote input, on a late input go back to
+  * a snapshot and re-simulate). But going back in time creates a complete
+  * new MSXMotherBoard from the snapshot (see ReverseManager::goTo()), which
+  * is far too slow to do within a single host frame. See 'reverse debug'
+  * for the actual snapshot take/restore times.
+  */
 class StateChangeDistributor
 {
 public:
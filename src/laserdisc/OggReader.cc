@@ -192,6 +192,10 @@ OggReader::OggReader(const std::string& filename, CliComm& cli_)
 	th_setup_free(tsi);
 	th_info_clear(&ti);
 	th_comment_clear(&tc);
+
+	seekIndex.emplace(filename, OggSeekIndex::Params{
+		.videoSerial = videoSerial, .audioSerial = audioSerial,
+		.granuleShift = granuleShift});
 }
 
 void OggReader::cleanup()
@@ -793,6 +797,29 @@ size_t OggReader::bisection(
 	uint64_t sampleA = 0, sampleB = maxSamples;
 	uint64_t frameA = 1, frameB = maxFrames;
 
+	auto isBefore = [&](size_t pFrame, size_t pSample) {
+		return pSample + getSampleRate() < sample &&
+		       pFrame + 64 < frame;
+	};
+	auto isAfter = [&](size_t pFrame, size_t pSample) {
+		return pSample > sample || pFrame > frame;
+	};
+
+	// Start from the narrowest interval that's known from earlier seeks.
+	for (const auto& p : seekPoints) {
+		if ((p.offset <= offsetA) || (p.offset >= offsetB)) continue;
+		if (isAfter(p.frame, p.sample)) {
+			offsetB = p.offset;
+			sampleB = p.sample;
+			frameB = p.frame;
+			break; // sorted on offset, so the next ones are after as well
+		} else if (isBefore(p.frame, p.sample)) {
+			offsetA = p.offset;
+			sampleA = p.sample;
+			frameA = p.frame;
+		}
+	}
+
 	while (true) {
 		uint64_t ratio = (frame - frameA) * SHIFT / (frameB - frameA);
 		if (ratio < 5) {
@@ -822,12 +849,19 @@ size_t OggReader::bisection(
 
 		state = PLAYING;
 
-		if (currentSample > sample || currentFrame > frame) {
+		if ((currentFrame != size_t(-1)) &&
+		    (currentSample != AudioFragment::UNKNOWN_POS)) {
+			auto it = std::ranges::lower_bound(seekPoints, offset, {}, &SeekPoint::offset);
+			if ((it == seekPoints.end()) || (it->offset != offset)) {
+				seekPoints.insert(it, SeekPoint{offset, currentFrame, currentSample});
+			}
+		}
+
+		if (isAfter(currentFrame, currentSample)) {
 			offsetB = offset;
 			sampleB = currentSample;
 			frameB = currentFrame;
-		} else if (currentSample + getSampleRate() < sample &&
-				currentFrame + 64 < frame) {
+		} else if (isBefore(currentFrame, currentSample)) {
 			offsetA = offset;
 			sampleA = currentSample;
 			frameA = currentFrame;
@@ -837,16 +871,11 @@ size_t OggReader::bisection(
 	}
 }
 
-size_t OggReader::findOffset(size_t frame, size_t sample)
+void OggReader::scanFileEnd()
 {
 	static constexpr size_t STEP = 32 * 1024;
 
-	// first calculate total length in bytes, samples and frames
-
-	// The file might have changed since we last requested its size,
-	// we assume that only data will be added to it and the ogg streams
-	// are exactly as before
-	fileSize = file.getSize();
+	// Calculate total length in bytes, samples and frames.
 	auto offset = fileSize - 1;
 
 	while (offset > 0) {
@@ -875,7 +904,21 @@ size_t OggReader::findOffset(size_t frame, size_t sample)
 		}
 	}
 
-	totalFrames = currentFrame;
+	fileEnd = FileEnd{offset, currentSample, currentFrame};
+}
+
+size_t OggReader::findOffset(size_t frame, size_t sample)
+{
+	// The file might have changed since we last requested its size,
+	// we assume that only data will be added to it and the ogg streams
+	// are exactly as before
+	if (auto size = file.getSize(); !fileEnd || (size != fileSize)) {
+		fileSize = size;
+		seekPoints.clear();
+		seekCache.clear();
+		scanFileEnd();
+	}
+	totalFrames = fileEnd->frames;
 
 	// If we're close to beginning, don't bother searching for it,
 	// just start at the beginning (arbitrary boundary of 1 second).
@@ -884,37 +927,63 @@ size_t OggReader::findOffset(size_t frame, size_t sample)
 		return 0;
 	}
 
-	auto maxOffset = offset;
-	auto maxSamples = currentSample;
-	auto maxFrames = currentFrame;
+	auto maxOffset = fileEnd->offset;
+	auto maxSamples = fileEnd->samples;
+	auto maxFrames = fileEnd->frames;
 
 	if ((sample > maxSamples) || (frame > maxFrames)) {
 		sample = maxSamples;
 		frame = maxFrames;
 	}
 
-	offset = bisection(frame, sample, maxOffset, maxSamples, maxFrames);
-
-	// Find key frame
-	file.seek(offset);
-	fileOffset = offset;
-	ogg_sync_reset(&sync);
-	currentFrame = frame;
-	currentSample = 0;
-	keyFrame = size_t(-1);
-	state = FIND_KEYFRAME;
+	if (seekIndex) {
+		if (auto target = seekIndex->find(frame, sample)) {
+			keyFrame = target->keyFrame;
+			return target->offset;
+		}
+	}
 
-	while (currentSample == 0 && nextPacket()) {
-		// continue reading
+	if (auto it = std::ranges::find_if(seekCache, [&](const SeekResult& r) {
+			return (r.frame == frame) && (r.sample == sample);
+		});
+	    it != seekCache.end()) {
+		auto result = *it;
+		seekCache.erase(it);
+		seekCache.push_back(result);
+		keyFrame = result.keyFrame;
+		return result.offset;
 	}
 
-	state = PLAYING;
+	auto offset = [&] {
+		auto offset1 = bisection(frame, sample, maxOffset, maxSamples, maxFrames);
 
-	if (keyFrame == one_of(size_t(-1), frame)) {
-		return offset;
-	}
+		// Find key frame
+		file.seek(offset1);
+		fileOffset = offset1;
+		ogg_sync_reset(&sync);
+		currentFrame = frame;
+		currentSample = 0;
+		keyFrame = size_t(-1);
+		state = FIND_KEYFRAME;
 
-	return bisection(keyFrame, sample, maxOffset, maxSamples, maxFrames);
+		while (currentSample == 0 && nextPacket()) {
+			// continue reading
+		}
+
+		state = PLAYING;
+
+		if (keyFrame == one_of(size_t(-1), frame)) {
+			return offset1;
+		}
+
+		return bisection(keyFrame, sample, maxOffset, maxSamples, maxFrames);
+	}();
+
+	if (seekCache.size() == SEEK_CACHE_SIZE) {
+		seekCache.erase(seekCache.begin());
+	}
+	seekCache.push_back(SeekResult{frame, sample, offset, keyFrame});
+	return offset;
 }
 
 bool OggReader::seek(size_t frame, size_t samples)
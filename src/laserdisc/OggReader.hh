@@ -2,6 +2,7 @@
 #define OGGREADER_HH
 
 #include "File.hh"
+#include "OggSeekIndex.hh"
 
 #include "circular_buffer.hh"
 #include "narrow.hh"
@@ -14,6 +15,7 @@
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -80,6 +82,7 @@ private:
 	void vorbisFoundPosition();
 	size_t frameNo(const ogg_packet* packet) const;
 
+	void scanFileEnd();
 	size_t findOffset(size_t frame, size_t sample);
 	size_t bisection(size_t frame, size_t sample,
 	                 size_t maxOffset, size_t maxSamples, size_t maxFrames);
@@ -127,6 +130,35 @@ private:
 	std::list<std::unique_ptr<AudioFragment>> audioList;
 	cb_queue<std::unique_ptr<AudioFragment>> recycleAudioList;
 
+	// Seeking requires decoding packets at several places in the file:
+	// near the end (to find the length) and at each bisection step. The
+	// (Pioneer) laserdisc games seek to the same frames over and over, so
+	// remember what was found. Only valid as long as the file size doesn't
+	// change.
+	struct FileEnd {
+		size_t offset;
+		size_t samples;
+		size_t frames;
+	};
+	std::optional<FileEnd> fileEnd;
+	struct SeekPoint { // the first frame/sample found after 'offset'
+		size_t offset;
+		size_t frame;
+		size_t sample;
+	};
+	std::vector<SeekPoint> seekPoints; // sorted on offset
+	struct SeekResult {
+		size_t frame;
+		size_t sample;
+		size_t offset;
+		size_t keyFrame;
+	};
+	static constexpr size_t SEEK_CACHE_SIZE = 64;
+	std::vector<SeekResult> seekCache; // most recently used at the back
+	// When available, this makes all of the above unnecessary (except
+	// for the total length).
+	std::optional<OggSeekIndex> seekIndex;
+
 	// Metadata
 	std::vector<size_t> stopFrames;
 	struct ChapterFrame {
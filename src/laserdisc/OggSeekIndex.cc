@@ -0,0 +1,212 @@
+#include "OggSeekIndex.hh"
+
+#include "File.hh"
+#include "FileOperations.hh"
+#include "MSXException.hh"
+
+#include "strCat.hh"
+#include "xxhash.hh"
+
+#include <ogg/ogg.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+
+namespace openmsx {
+
+// The index is stored in the user data directory. Format (all values in
+// native byte order, the file is ignored if that doesn't match):
+//   header: magic (8 bytes), byte order mark (uint32), ogg file size (uint64),
+//           modification time (int64), filename length (uint32),
+//           filename (not zero-terminated)
+//   entries: raw Entry structs
+static constexpr std::string_view INDEX_MAGIC = "oMSXogi1";
+static constexpr uint32_t INDEX_BYTE_ORDER_MARK = 0x01020304;
+static constexpr size_t INDEX_HEADER_SIZE = 8 + 4 + 8 + 8 + 4; // excluding filename
+
+// Not every page needs an entry, starting to decode a bit earlier than
+// strictly needed is cheap.
+static constexpr uint64_t MIN_DISTANCE = 64 * 1024;
+
+[[nodiscard]] static std::string getIndexCacheName(std::string_view filename)
+{
+	return strCat(FileOperations::getUserDataDir(), "/oggindex/",
+	              hex_string<8>(xxhash(filename)));
+}
+
+[[nodiscard]] static std::vector<uint8_t> makeHeader(
+	std::string_view filename, uint64_t size, int64_t time)
+{
+	auto len = uint32_t(filename.size());
+	std::vector<uint8_t> result(INDEX_HEADER_SIZE + len);
+	memcpy(&result[0],  INDEX_MAGIC.data(), 8);
+	memcpy(&result[8],  &INDEX_BYTE_ORDER_MARK, 4);
+	memcpy(&result[12], &size, 8);
+	memcpy(&result[20], &time, 8);
+	memcpy(&result[28], &len, 4);
+	memcpy(&result[INDEX_HEADER_SIZE], filename.data(), len);
+	return result;
+}
+
+[[nodiscard]] static std::optional<std::vector<OggSeekIndex::Entry>> loadIndex(
+	const std::string& filename, std::span<const uint8_t> header)
+{
+	using Entry = OggSeekIndex::Entry;
+	try {
+		File cacheFile(getIndexCacheName(filename));
+		auto size = cacheFile.getSize();
+		if ((size < header.size()) || ((size - header.size()) % sizeof(Entry))) {
+			return {};
+		}
+		std::vector<uint8_t> cacheHeader(header.size());
+		cacheFile.read(std::span{cacheHeader});
+		if (!std::ranges::equal(cacheHeader, header)) {
+			return {}; // stale, or belongs to a different file
+		}
+		std::vector<Entry> result((size - header.size()) / sizeof(Entry));
+		cacheFile.read(std::span{result});
+		return result;
+	} catch (MSXException&) {
+		return {}; // no (usable) index
+	}
+}
+
+static void saveIndex(const std::string& filename, std::span<const uint8_t> header,
+                      std::span<const OggSeekIndex::Entry> entries)
+{
+	try {
+		auto cacheName = getIndexCacheName(filename);
+		FileOperations::mkdirp(std::string(FileOperations::getDirName(cacheName)));
+		File cacheFile(cacheName, File::OpenMode::TRUNCATE);
+		cacheFile.write(header);
+		cacheFile.write(entries);
+	} catch (MSXException&) {
+		// ignore, only means the index must be rebuilt next time
+	}
+}
+
+[[nodiscard]] static std::vector<OggSeekIndex::Entry> buildIndex(
+	const std::string& filename, OggSeekIndex::Params params, const std::atomic<bool>& abort)
+{
+	static constexpr size_t CHUNK = 64 * 1024;
+
+	File file(filename);
+	auto remaining = file.getSize();
+
+	ogg_sync_state sync;
+	ogg_sync_init(&sync);
+
+	std::vector<OggSeekIndex::Entry> result;
+	OggSeekIndex::Entry state = {0, 0, 0, 0};
+	uint64_t offset = 0; // start of the next page
+	auto mask = (uint64_t(1) << params.granuleShift) - 1;
+	try {
+		while (!abort) {
+			ogg_page page;
+			long ret = ogg_sync_pageseek(&sync, &page);
+			if (ret < 0) {
+				offset += uint64_t(-ret); // skipped garbage
+				continue;
+			}
+			if (ret == 0) {
+				// need more data
+				if (remaining == 0) break;
+				auto chunk = std::min(CHUNK, remaining);
+				char* buffer = ogg_sync_buffer(&sync, long(chunk));
+				file.read(std::span{buffer, chunk});
+				ogg_sync_wrote(&sync, long(chunk));
+				remaining -= chunk;
+				continue;
+			}
+
+			if (result.empty() || ((offset - result.back().offset) >= MIN_DISTANCE)) {
+				state.offset = offset;
+				result.push_back(state);
+			}
+			offset += uint64_t(ret);
+
+			// granule position of the last packet that ends in this page
+			auto granule = ogg_page_granulepos(&page);
+			if (granule < 0) continue;
+			auto serial = ogg_page_serialno(&page);
+			if (serial == params.videoSerial) {
+				auto key = uint64_t(granule) >> params.granuleShift;
+				auto frame = key + (uint64_t(granule) & mask);
+				if (frame >= state.frame) {
+					state.frame = frame;
+					state.keyFrame = key;
+				}
+			} else if (serial == params.audioSerial) {
+				state.sample = std::max(state.sample, uint64_t(granule));
+			}
+		}
+	} catch (MSXException&) {
+		result.clear();
+	}
+	ogg_sync_clear(&sync);
+	if (abort) result.clear();
+	return result;
+}
+
+OggSeekIndex::OggSeekIndex(std::string filename, Params params)
+	: future(std::async(std::launch::async, [this, filename = std::move(filename), params] {
+		auto st = FileOperations::getStat(filename);
+		if (!st) return std::vector<Entry>{};
+		auto header = makeHeader(filename, uint64_t(st->st_size),
+		                         int64_t(FileOperations::getModificationDate(*st)));
+		if (auto loaded = loadIndex(filename, header)) {
+			return std::move(*loaded);
+		}
+		auto result = buildIndex(filename, params, abort);
+		if (!result.empty()) saveIndex(filename, header, result);
+		return result;
+	}))
+{
+}
+
+OggSeekIndex::~OggSeekIndex()
+{
+	abort = true;
+	if (future.valid()) future.wait();
+}
+
+std::optional<OggSeekIndex::Target> OggSeekIndex::find(size_t frame, size_t sample)
+{
+	if (!ready) {
+		using namespace std::chrono_literals;
+		if (future.wait_for(0s) != std::future_status::ready) return {};
+		entries = future.get();
+		ready = true;
+	}
+	return find(entries, frame, sample);
+}
+
+std::optional<OggSeekIndex::Target> OggSeekIndex::find(
+	std::span<const Entry> entries, size_t frame, size_t sample)
+{
+	if (entries.empty()) return {};
+
+	// The key frame of 'frame'. At the first page boundary where 'frame'
+	// is already decoded, the most recent frame has key frame 'k'. If
+	// 'k <= frame' then there's no other key frame in between. Otherwise
+	// take the (earlier) key frame of the previous boundary.
+	auto it = std::ranges::lower_bound(entries, uint64_t(frame), {}, &Entry::frame);
+	uint64_t keyFrame = ((it != entries.end()) && (it->keyFrame <= frame))
+	                  ? it->keyFrame
+	                  : ((it == entries.begin()) ? 0 : std::prev(it)->keyFrame);
+	if (keyFrame == 0) return Target{0, 1}; // start from the beginning
+
+	// The last page boundary before the key frame and before the audio
+	// sample, and then one more, because a packet can start in the page
+	// before the one in which it ends.
+	auto end = std::ranges::partition_point(entries, [&](const Entry& e) {
+		return ((e.frame + 1) < keyFrame) && (e.sample < sample);
+	});
+	auto n = std::distance(entries.begin(), end);
+	if (n < 2) return Target{0, size_t(keyFrame)};
+	return Target{size_t(entries[n - 2].offset), size_t(keyFrame)};
+}
+
+} // namespace openmsx
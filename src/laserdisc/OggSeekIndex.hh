@@ -0,0 +1,67 @@
+#ifndef OGGSEEKINDEX_HH
+#define OGGSEEKINDEX_HH
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace openmsx {
+
+/** Index on the pages of an ogg (laserdisc) file, to quickly find where to
+  * start decoding for a given video frame and audio sample.
+  *
+  * Building the index only requires reading the page headers of the whole
+  * file (no decoding). That's done in a background thread. The result is
+  * stored in the user data directory, so that reopening the same file (in a
+  * later session) doesn't need to scan it again. As long as the index is not
+  * ready, find() returns nothing and the caller must use a slower search.
+  */
+class OggSeekIndex
+{
+public:
+	struct Params {
+		int videoSerial;
+		int audioSerial;
+		int granuleShift;
+	};
+	/** The state at the start of a page. */
+	struct Entry {
+		uint64_t offset;   // start of the page
+		uint64_t frame;    // last video frame completed before this page (0 if none)
+		uint64_t keyFrame; // key frame of 'frame'
+		uint64_t sample;   // last audio sample completed before this page
+	};
+	struct Target {
+		size_t offset;   // start decoding here
+		size_t keyFrame; // key frame needed to decode the requested frame
+	};
+
+	OggSeekIndex(std::string filename, Params params);
+	OggSeekIndex(const OggSeekIndex&) = delete;
+	OggSeekIndex(OggSeekIndex&&) = delete;
+	OggSeekIndex& operator=(const OggSeekIndex&) = delete;
+	OggSeekIndex& operator=(OggSeekIndex&&) = delete;
+	~OggSeekIndex();
+
+	/** Where to start decoding to get the given frame and sample, or
+	  * nullopt when the index is not available (yet). */
+	[[nodiscard]] std::optional<Target> find(size_t frame, size_t sample);
+
+	/** Same as above, but on the given entries (sorted on offset). */
+	[[nodiscard]] static std::optional<Target> find(
+		std::span<const Entry> entries, size_t frame, size_t sample);
+
+private:
+	std::atomic<bool> abort = false;
+	std::future<std::vector<Entry>> future;
+	std::vector<Entry> entries;
+	bool ready = false;
+};
+
+} // namespace openmsx
+
+#endif
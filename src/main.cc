@@ -11,6 +11,7 @@
 #include "MSXException.hh"
 #include "Reactor.hh"
 #include "RenderSettings.hh"
+#include "StartupProfiler.hh"
 #include "Thread.hh"
 
 #include "one_of.hh"
@@ -68,7 +69,10 @@ static int main(int argc, char **argv)
 
 	try {
 		randomize(); // seed global random generator
-		initializeSDL();
+		{
+			StartupProfiler::Scope profile("SDL init");
+			initializeSDL();
+		}
 
 		Thread::setMainThread();
 		Reactor reactor;
@@ -90,6 +94,7 @@ static int main(int argc, char **argv)
 			auto& render = display.getRenderSettings().getRendererSetting();
 			if ((render.getEnum() == RenderSettings::RendererID::UNINITIALIZED) &&
 			    (parseStatus != CommandLineParser::Status::CONTROL)) {
+				StartupProfiler::Scope profile("video init");
 				render.setValue(render.getDefaultValue());
 				// Switching renderer requires events, handle
 				// these events before continuing with the rest
@@ -100,15 +105,22 @@ static int main(int argc, char **argv)
 				reactor.getEventDistributor().deliverEvents();
 			}
 
-			CliServer cliServer(reactor.getCommandController(),
+			CliServer cliServer(reactor.getGlobalCommandController(),
 			                    reactor.getEventDistributor(),
 			                    reactor.getGlobalCliComm());
 
 			if (parser.getParseStatus() == CommandLineParser::Status::RUN) {
+				StartupProfiler::Scope profile("power on");
 				reactor.powerOn();
 			}
-			display.repaint();
+			{
+				StartupProfiler::Scope profile("first repaint");
+				display.repaint();
+			}
+			StartupProfiler::finish();
 			reactor.run();
+		} else {
+			StartupProfiler::finish();
 		}
 	} catch (FatalError& e) {
 		std::cerr << "Fatal error: " << e.getMessage() << '\n';
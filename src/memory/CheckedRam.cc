@@ -53,7 +53,8 @@ uint8_t* CheckedRam::getWriteCacheLine(size_t addr)
 
 uint8_t* CheckedRam::getRWCacheLines(size_t addr, size_t size)
 {
-	// TODO optimize
+	if (numIncompleteLines == 0) [[likely]] return &ram[addr];
+
 	size_t num = size >> CacheLine::BITS;
 	size_t first = addr >> CacheLine::BITS;
 	for (auto i : xrange(num)) {
@@ -71,6 +72,7 @@ void CheckedRam::write(size_t addr, const uint8_t value)
 		uninitialized[line][addr & CacheLine::LOW] = false;
 		if (uninitialized[line].none()) [[unlikely]] {
 			completely_initialized_cacheline[line] = true;
+			--numIncompleteLines;
 			// This invalidates way too much stuff. But because
 			// (locally) we don't know exactly how this class ie
 			// being used in the MSXDevice, there's no easy way to
@@ -98,10 +100,12 @@ void CheckedRam::init()
 		// there is no callback function,
 		// do as if everything is initialized
 		completely_initialized_cacheline.assign(lines, true);
+		numIncompleteLines = 0;
 		// 'uninitialized' won't be accessed, so don't even allocate
 	} else {
 		// new callback function, forget about initialized areas
 		completely_initialized_cacheline.assign(lines, false);
+		numIncompleteLines = lines;
 
 		std::bitset<CacheLine::SIZE> allTrue;
 		allTrue.set();
@@ -65,6 +65,9 @@ private:
 
 private:
 	std::vector<bool> completely_initialized_cacheline;
+	// Number of 'false' entries in the vector above. Normally zero, then
+	// getRWCacheLines() doesn't need to check individual lines.
+	size_t numIncompleteLines = 0;
 	std::vector<std::bitset<CacheLine::SIZE>> uninitialized;
 	Ram ram;
 	MSXCPU& msxcpu;
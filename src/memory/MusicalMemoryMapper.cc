@@ -62,7 +62,7 @@ void MusicalMemoryMapper::writeIO(uint16_t port, byte value, EmuTime time)
 		// Mapper port.
 		if (!(controlReg & PORT_ACCESS_DISABLED)) {
 			MSXMemoryMapperBase::writeIOImpl(port, value, time);
-			invalidateDeviceRWCache(0x4000 * (port & 0x03), 0x4000);
+			updatePageCache(port & 0x03);
 		}
 	} else if (port & 1) {
 		// Sound chip.
@@ -80,6 +80,21 @@ void MusicalMemoryMapper::writeIO(uint16_t port, byte value, EmuTime time)
 	}
 }
 
+void MusicalMemoryMapper::updatePageCache(byte page)
+{
+	// Point the cache lines directly to the newly selected segment, unless
+	// this page needs special handling (see getReadCacheLine() and
+	// getWriteCacheLine()), then they're refilled on demand.
+	auto start = narrow_cast<uint16_t>(0x4000 * page);
+	bool special = writeProtected(start) ||
+	               ((controlReg & MEM_ACCESS_ENABLED) && (page == 1 || page == 2));
+	if (byte* data = special ? nullptr : checkedRam.getRWCacheLines(segmentOffset(page), 0x4000)) {
+		fillDeviceRWCache(start, 0x4000, data);
+	} else {
+		invalidateDeviceRWCache(start, 0x4000);
+	}
+}
+
 bool MusicalMemoryMapper::registerAccessAt(uint16_t address) const
 {
 	if (controlReg & MEM_ACCESS_ENABLED) {
@@ -176,7 +191,7 @@ void MusicalMemoryMapper::writeMem(uint16_t address, byte value, EmuTime time)
 		case 0xFE:
 		case 0xFF:
 			MSXMemoryMapperBase::writeIOImpl(address & 0xFF, value, time);
-			invalidateDeviceRWCache(0x4000 * (address & 0x03), 0x4000);
+			updatePageCache(address & 0x03);
 			return;
 		}
 	}
@@ -50,6 +50,11 @@ private:
 
 	void updateControlReg(byte value);
 
+	/** Update the cache lines of the given page after its segment was
+	  * switched.
+	  */
+	void updatePageCache(byte page);
+
 private:
 	SN76489 sn76489;
 	byte controlReg = 0;
@@ -18,20 +18,29 @@
 namespace openmsx {
 
 Ram::Ram(const DeviceConfig& config, const std::string& name,
-         static_string_view description, size_t size, bool* debugWrite)
+         static_string_view description, size_t size, bool* debugWrite,
+         uint8_t initialValue)
 	: xml(*config.getXML())
-	, ram(size)
+	, ram(MemBuffer<uint8_t>::zeroed(size))
 	, debuggable(std::in_place,
 		config.getMotherBoard(), name, description, *this, debugWrite ? debugWrite : &dummyDebugWrite)
 {
-	clear();
+	initialize(initialValue);
 }
 
-Ram::Ram(const XMLElement& xml_, size_t size)
+Ram::Ram(const XMLElement& xml_, size_t size, uint8_t initialValue)
 	: xml(xml_)
-	, ram(size)
+	, ram(MemBuffer<uint8_t>::zeroed(size))
 {
-	clear();
+	initialize(initialValue);
+}
+
+void Ram::initialize(uint8_t initialValue)
+{
+	// The buffer is already zero-filled, don't touch it (and so commit
+	// memory for it) when that's also the wanted content.
+	if ((initialValue == 0) && !xml.findChild("initialContent")) return;
+	clear(initialValue);
 }
 
 void Ram::clear(uint8_t c)
@@ -72,8 +81,18 @@ void Ram::clear(uint8_t c)
 			left -= tmp;
 		}
 	} else {
-		// no init pattern specified
-		std::ranges::fill(*this, c);
+		// No init pattern specified. Only write the pages that actually
+		// change: the buffer starts zero-filled and (for large buffers)
+		// the OS only commits memory for pages that get written. So
+		// e.g. a (mostly unused) sample RAM that gets cleared to zero
+		// doesn't cost any memory.
+		static constexpr size_t PAGE = 4096;
+		for (size_t start = 0; start < size(); start += PAGE) {
+			auto page = subspan(ram, start, std::min(PAGE, size() - start));
+			if (!std::ranges::all_of(page, [&](uint8_t b) { return b == c; })) {
+				std::ranges::fill(page, c);
+			}
+		}
 	}
 }
 
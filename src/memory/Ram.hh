@@ -32,12 +32,14 @@ private:
 class Ram
 {
 public:
-	/** Create Ram object with an associated debuggable. */
+	/** Create Ram object with an associated debuggable.
+	  * The content is initialized like clear(initialValue). */
 	Ram(const DeviceConfig& config, const std::string& name,
-	    static_string_view description, size_t size, bool* debugWrite = nullptr);
+	    static_string_view description, size_t size, bool* debugWrite = nullptr,
+	    uint8_t initialValue = 0xff);
 
 	/** Create Ram object without debuggable. */
-	Ram(const XMLElement& xml, size_t size);
+	Ram(const XMLElement& xml, size_t size, uint8_t initialValue = 0xff);
 
 	[[nodiscard]] const uint8_t& operator[](size_t addr) const {
 		return ram[addr];
@@ -54,11 +56,22 @@ public:
 	[[nodiscard]] auto end()   const { return ram.end(); }
 
 	[[nodiscard]] const std::string& getName() const;
+
+	/** Fill with the 'initialContent' pattern from the config, or else
+	  * with the given value. The buffer starts zero-filled and only the
+	  * pages that change are written. So clearing to zero doesn't commit
+	  * memory (when the Ram was also constructed with initialValue 0), but
+	  * any other value (like the default 0xff) commits the whole buffer. In-memory snapshots don't duplicate such identical
+	  * pages either (see the block store in DeltaBlock.cc).
+	  */
 	void clear(uint8_t c = 0xff);
 
 	template<typename Archive>
 	void serialize(Archive& ar, unsigned version);
 
+private:
+	void initialize(uint8_t initialValue);
+
 private:
 	const XMLElement& xml;
 	MemBuffer<uint8_t> ram;
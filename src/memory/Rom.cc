@@ -18,6 +18,7 @@
 #include "Reactor.hh"
 #include "RomDatabase.hh"
 #include "RomInfo.hh"
+#include "StartupProfiler.hh"
 #include "XMLElement.hh"
 
 #include "narrow.hh"
@@ -52,10 +53,34 @@ private:
 };
 
 
+// Read-only mappings of unpatched ROM images, indexed by sha1sum. Only
+// accessed from the main thread. Entries are removed (lazily) when the
+// last Rom using them is destroyed.
+using SharedRomMapping = std::shared_ptr<const MappedFile<const uint8_t>>;
+struct SharedRom {
+	Sha1Sum sha1;
+	std::weak_ptr<const MappedFile<const uint8_t>> mapping;
+};
+static std::vector<SharedRom> sharedRoms;
+
+[[nodiscard]] static SharedRomMapping getSharedMapping(File& file, const Sha1Sum& sha1)
+{
+	std::erase_if(sharedRoms, [](const auto& r) { return r.mapping.expired(); });
+	if (auto it = std::ranges::find(sharedRoms, sha1, &SharedRom::sha1);
+	    it != sharedRoms.end()) {
+		return it->mapping.lock();
+	}
+	auto result = std::make_shared<const MappedFile<const uint8_t>>(file.mmap<const uint8_t>());
+	sharedRoms.emplace_back(sha1, result);
+	return result;
+}
+
 Rom::Rom(std::string name_, static_string_view description_,
          DeviceConfig& config, std::string_view id /*= {}*/)
 	: name(std::move(name_)), description(description_)
 {
+	StartupProfiler::Scope profile(tmpStrCat("ROM ", name));
+
 	// Try all <rom> tags with matching "id" attribute.
 	std::string errors;
 	for (auto* c : config.getXML()->getChildren("rom")) {
@@ -190,18 +215,24 @@ void Rom::init(MSXMotherBoard& motherBoard, XMLElement& config,
 				"inside a <rom> section are no longer "
 				"supported.");
 		}
-		try {
-			mmap = file.mmap<uint8_t>();
-			rom = *mmap;
-		} catch (FileException&) {
-			throw MSXException("Error reading ROM image: ", filename);
-		}
-
 		// For file-based roms, calc sha1 via File::getSha1Sum(). It can
 		// possibly use the FilePool cache to avoid the calculation.
+		// This is also the key to share identical images.
 		if (originalSha1.empty()) {
 			originalSha1 = filePool.getSha1Sum(file, filename);
 		}
+		try {
+			if (config.findChild("patches")) {
+				// private (copy-on-write) mapping, patched below
+				mmap = file.mmap<uint8_t>();
+				rom = *mmap;
+			} else {
+				sharedMmap = getSharedMapping(file, originalSha1);
+				rom = *sharedMmap;
+			}
+		} catch (FileException&) {
+			throw MSXException("Error reading ROM image: ", filename);
+		}
 
 		// verify SHA1
 		if (!checkSHA1(config)) {
@@ -338,6 +369,7 @@ Rom::Rom(Rom&& r) noexcept
 	, file         (std::move(r.file))
 	, filename     (std::move(r.filename))
 	, mmap         (std::move(r.mmap))
+	, sharedMmap   (std::move(r.sharedMmap))
 	, originalSha1 (r.originalSha1)
 	, actualSha1   (r.actualSha1)
 	, name         (std::move(r.name))
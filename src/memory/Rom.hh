@@ -66,6 +66,9 @@ private:
 	File file; // can be a closed file
 	std::string filename;
 	std::optional<MappedFile<uint8_t>> mmap; // non-const to allow patching
+	// Unpatched images are mapped read-only, and shared between all Rom
+	// objects (possibly in different machines) with the same content.
+	std::shared_ptr<const MappedFile<const uint8_t>> sharedMmap; // can be nullptr
 
 	mutable Sha1Sum originalSha1;
 	mutable Sha1Sum actualSha1;
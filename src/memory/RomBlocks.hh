@@ -53,6 +53,11 @@ protected:
 	  *   (region i starts at Z80 address i * 0x2000)
 	  * @param adr pointer to memory, area must be at least 0x2000 bytes long
 	  * @param block Block number, only used for the 'romblock' debuggable, limited to 8-bit.
+	  * The CPU read cache lines for this region are immediately re-pointed
+	  * to the new memory (they're not merely invalidated), so a bank
+	  * switch doesn't cause slow reads afterwards. Subclasses that
+	  * intercept reads in (part of) this region must invalidate that part
+	  * again after calling this method.
 	  */
 	void setBank(unsigned region, const byte* adr, byte block);
 
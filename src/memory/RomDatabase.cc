@@ -3,7 +3,9 @@
 #include "CliComm.hh"
 #include "File.hh"
 #include "FileContext.hh"
+#include "FileOperations.hh"
 #include "MSXException.hh"
+#include "Version.hh"
 
 #include "String32.hh"
 #include "StringOp.hh"
@@ -13,13 +15,18 @@
 #include "rapidsax.hh"
 #include "stl.hh"
 #include "unreachable.hh"
+#include "xrange.hh"
 #include "xxhash.hh"
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cassert>
+#include <cstring>
 #include <ranges>
+#include <string>
 #include <string_view>
+#include <type_traits>
 
 namespace openmsx {
 
@@ -46,8 +53,13 @@ public:
 	void doctype(zstring_view txt);
 
 	[[nodiscard]] std::string_view getSystemID() const { return systemID; }
+	[[nodiscard]] bool hadWarnings() const { return warned; }
 
 private:
+	template<typename... Args> void warn(Args&&... args) {
+		warned = true;
+		cliComm.printWarning(std::forward<Args>(args)...);
+	}
 	[[nodiscard]] String32 cIndex(zstring_view str) const;
 	void addEntries();
 	void addAllEntries();
@@ -101,6 +113,7 @@ private:
 	State state = BEGIN;
 	unsigned unknownLevel = 0;
 	size_t initialSize;
+	bool warned = false;
 };
 
 void DBParser::start(zstring_view tag)
@@ -304,7 +317,7 @@ void DBParser::attribute(zstring_view name, zstring_view value)
 				if (auto g = StringOp::stringToBase<10, unsigned>(value)) {
 					genMSXid = *g;
 				} else {
-					cliComm.printWarning(
+					warn(
 						"Ignoring bad Generation MSX id (genmsxid) "
 						"in entry with title '", fromString32(bufStart, title),
 						": ", value);
@@ -346,7 +359,7 @@ void DBParser::attribute(zstring_view name, zstring_view value)
 				try {
 					dumps.back().hash = Sha1Sum(value);
 				} catch (MSXException& e) {
-					cliComm.printWarning(
+					warn(
 						"Ignoring bad dump for '", fromString32(bufStart, title),
 						"': ", e.getMessage());
 				}
@@ -406,7 +419,7 @@ void DBParser::text(zstring_view txt)
 		if (auto g = StringOp::stringToBase<10, unsigned>(txt)) {
 			genMSXid = *g;
 		} else {
-			cliComm.printWarning(
+			warn(
 				"Ignoring bad Generation MSX id (genmsxid) "
 				"in entry with title '", fromString32(bufStart, title),
 				": ", txt);
@@ -426,7 +439,7 @@ void DBParser::text(zstring_view txt)
 		try {
 			dumps.back().hash = Sha1Sum(txt);
 		} catch (MSXException& e) {
-			cliComm.printWarning(
+			warn(
 				"Ignoring bad dump for '", fromString32(bufStart, title),
 				"': ", e.getMessage());
 		}
@@ -492,7 +505,7 @@ void DBParser::addAllEntries()
 	// move non-duplicates up
 	while (it2 != last) {
 		if (it1->sha1 == it2->sha1) {
-			cliComm.printWarning(
+			warn(
 				"duplicate softwaredb entry SHA1: ",
 				it2->sha1);
 		} else {
@@ -629,7 +642,8 @@ void DBParser::doctype(zstring_view txt)
 	systemID = t.substr(0, pos2);
 }
 
-static void parseDB(CliComm& cliComm, char* buf, char* bufStart,
+// Returns true iff there were warnings.
+static bool parseDB(CliComm& cliComm, char* buf, char* bufStart,
                     RomDatabase::RomDB& db, UnknownTypes& unknownTypes)
 {
 	DBParser handler(db, unknownTypes, cliComm, bufStart);
@@ -641,18 +655,189 @@ static void parseDB(CliComm& cliComm, char* buf, char* bufStart,
 			"You're probably using an old incompatible file format.",
 			nullptr);
 	}
+	return handler.hadWarnings();
+}
+
+// The strings of the parsed entries point into the (large) xml files. Replace
+// them with a compact string table, without duplicates. Offset 0 is the empty
+// string.
+[[nodiscard]] static MemBuffer<char> compactStrings(RomDatabase::RomDB& db, const char* oldBuf)
+{
+	std::string table(1, '\0');
+	hash_map<std::string_view, uint32_t, XXHasher> offsets; // views in 'oldBuf'
+	auto intern = [&](std::string_view str) -> uint32_t {
+		if (str.empty()) return 0;
+		if (const auto* o = lookup(offsets, str)) return *o;
+		auto o = narrow<uint32_t>(table.size());
+		table.append(str);
+		table.push_back('\0');
+		offsets.emplace_noDuplicateCheck(str, o);
+		return o;
+	};
+	struct Offsets { uint32_t title, year, company, country, origType, remark; };
+	auto strOffsets = to_vector(std::views::transform(db, [&](const RomDatabase::Entry& e) {
+		const auto& r = e.romInfo;
+		return Offsets{intern(r.getTitle(oldBuf)),   intern(r.getYear(oldBuf)),
+		               intern(r.getCompany(oldBuf)), intern(r.getCountry(oldBuf)),
+		               intern(r.getOrigType(oldBuf)), intern(r.getRemark(oldBuf))};
+	}));
+
+	MemBuffer<char> result(table.size());
+	copy_to_range(table, std::span{result});
+	auto str32 = [&](uint32_t offset) {
+		String32 s;
+		toString32(result.data(), result.data() + offset, s);
+		return s;
+	};
+	for (auto i : xrange(db.size())) {
+		const auto& o = strOffsets[i];
+		auto& r = db[i].romInfo;
+		r = RomInfo(str32(o.title), str32(o.year),
+		                    str32(o.company), str32(o.country),
+		                    r.getOriginal(), str32(o.origType),
+		                    str32(o.remark), r.getRomType(), r.getGenMSXid());
+	}
+	return result;
+}
+
+// Parsing the software database takes a noticeable amount of time, so the
+// result is cached in a binary file. The cache is only used when all source
+// files still have the same size and modification time, and when it was
+// written by the same openMSX version. This is only done when String32 is an
+// offset (not a pointer), so that the entries don't depend on the location
+// of the string table. All values are in native byte order.
+//   header:  magic (8 bytes), byte order mark (uint32), sizeof(Entry) (uint32),
+//            openMSX version (uint32 length + chars),
+//            number of sources (uint32), per source:
+//              path (uint32 length + chars), size (int64, -1 when missing),
+//              modification time (int64)
+//            number of entries (uint32), string table size (uint32)
+//   entries: raw Entry structs (sorted on sha1sum)
+//   strings: see compactStrings()
+static constexpr bool CACHE_SUPPORTED = std::is_same_v<String32, uint32_t>;
+static constexpr std::string_view CACHE_MAGIC = "oMSXsdb1";
+static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+static_assert(std::is_trivially_copyable_v<RomDatabase::Entry>);
+
+[[nodiscard]] static std::string getCacheFilename()
+{
+	return FileOperations::getUserDataDir() + "/.softwaredb.cache";
+}
+
+// Everything in the cache header up to (not including) the number of entries.
+[[nodiscard]] static std::string getCacheHeader(std::span<const std::string> sources)
+{
+	std::string result;
+	auto write = [&](const auto& v) {
+		result.append(std::bit_cast<std::array<char, sizeof(v)>>(v).data(), sizeof(v));
+	};
+	auto writeStr = [&](std::string_view str) {
+		write(narrow<uint32_t>(str.size()));
+		result.append(str);
+	};
+	result.append(CACHE_MAGIC);
+	write(BYTE_ORDER_MARK);
+	write(uint32_t(sizeof(RomDatabase::Entry)));
+	writeStr(Version::full());
+	write(narrow<uint32_t>(sources.size()));
+	for (const auto& source : sources) {
+		writeStr(source);
+		int64_t size = -1;
+		int64_t time = 0;
+		if (auto st = FileOperations::getStat(source)) {
+			size = st->st_size;
+			time = FileOperations::getModificationDate(*st);
+		}
+		write(size);
+		write(time);
+	}
+	return result;
+}
+
+bool RomDatabase::loadCache(std::string_view header)
+{
+	try {
+		cache = File(getCacheFilename()).mmap<const char>();
+	} catch (MSXException&) {
+		return false; // doesn't exist (yet)
+	}
+	std::span<const char> data = cache;
+	if (!std::ranges::equal(data.first(std::min(data.size(), header.size())), header)) {
+		return false; // outdated
+	}
+	data = data.subspan(header.size());
+
+	uint32_t count, tableSize;
+	if (data.size() < 8) return false;
+	memcpy(&count,     &data[0], 4);
+	memcpy(&tableSize, &data[4], 4);
+	data = data.subspan(8);
+	if ((tableSize == 0) || (data.size() != (count * sizeof(Entry) + tableSize))) {
+		return false; // truncated (or concurrently written)
+	}
+	auto table = data.subspan(count * sizeof(Entry));
+	if ((table.front() != 0) || (table.back() != 0)) return false;
+
+	db.clear();
+	db.reserve(count);
+	for (auto i : xrange(count)) {
+		std::array<char, sizeof(Entry)> raw;
+		copy_to_range(data.subspan(i * sizeof(Entry), sizeof(Entry)), raw);
+		db.push_back(std::bit_cast<Entry>(raw));
+	}
+	bufferStart = table.data();
+	return true;
+}
+
+void RomDatabase::writeCache(std::string_view header) const
+{
+	std::string out(header);
+	auto write = [&](const void* p, size_t n) {
+		out.append(static_cast<const char*>(p), n);
+	};
+	auto count = narrow<uint32_t>(db.size());
+	auto tableSize = narrow<uint32_t>(buffer.size());
+	write(&count, 4);
+	write(&tableSize, 4);
+	write(db.data(), db.size() * sizeof(Entry));
+	write(buffer.data(), buffer.size());
+	// Other openMSX processes may have the current cache file mapped (and
+	// use it as their string table), so never modify it in place. Instead
+	// write a new file and rename it over the old one.
+	try {
+		std::string tmpName;
+		auto fp = FileOperations::openUniqueFile(FileOperations::getUserDataDir(), tmpName);
+		if (!fp) return;
+		bool ok = fwrite(out.data(), 1, out.size(), fp.get()) == out.size();
+		ok &= fclose(fp.release()) == 0;
+		if (!ok || (FileOperations::rename(tmpName, getCacheFilename()) != 0)) {
+			FileOperations::unlink(tmpName);
+		}
+	} catch (MSXException&) {
+		// ignore, the cache is only an optimization
+	}
 }
 
 RomDatabase::RomDatabase(CliComm& cliComm)
 {
+	// first user- then system-directory
+	auto sources = to_vector(std::views::transform(systemFileContext().getPaths(),
+		[](const std::string& p) { return p + "/softwaredb.xml"; }));
+	std::string header;
+	if constexpr (CACHE_SUPPORTED) {
+		header = getCacheHeader(sources);
+		if (loadCache(header)) return;
+		cache = {}; // release before the file gets rewritten
+	}
+
 	db.reserve(3500);
 	UnknownTypes unknownTypes;
-	// first user- then system-directory
+	bool warnings = false;
 	std::vector<File> files;
 	size_t bufferSize = 0;
-	for (const auto& p : systemFileContext().getPaths()) {
+	for (const auto& source : sources) {
 		try {
-			auto& f = files.emplace_back(p + "/softwaredb.xml");
+			auto& f = files.emplace_back(source);
 			bufferSize += f.getSize() + rapidsax::EXTRA_BUFFER_SPACE;
 		} catch (MSXException& /*e*/) {
 			// Ignore. It's not unusual the DB in the user
@@ -661,29 +846,34 @@ RomDatabase::RomDatabase(CliComm& cliComm)
 			// warning, but that's done below.
 		}
 	}
-	buffer.resize(bufferSize);
+	MemBuffer<char> xmlBuffer(bufferSize);
 	size_t bufferOffset = 0;
 	for (auto& file : files) {
 		try {
 			auto size = file.getSize();
-			auto* buf = &buffer[bufferOffset];
+			auto* buf = &xmlBuffer[bufferOffset];
 			bufferOffset += size + rapidsax::EXTRA_BUFFER_SPACE;
 			file.read(std::span{buf, size});
 			buf[size] = 0;
 
-			parseDB(cliComm, buf, buffer.data(), db, unknownTypes);
+			warnings |= parseDB(cliComm, buf, xmlBuffer.data(), db, unknownTypes);
 		} catch (rapidsax::ParseError& e) {
 			cliComm.printWarning(
 				"Rom database parsing failed: ", e.what());
+			warnings = true;
 		} catch (MSXException& /*e*/) {
 			// Ignore, see above
 		}
 	}
-	if (bufferSize) buffer[0] = 0;
+	if (bufferSize) xmlBuffer[0] = 0;
+	buffer = compactStrings(db, xmlBuffer.data());
+	bufferStart = buffer.data();
+
 	if (db.empty()) {
 		cliComm.printWarning(
 			"Couldn't load software database.\n"
 			"This may cause incorrect ROM mapper types to be used.");
+		warnings = true;
 	}
 	if (!unknownTypes.empty()) {
 		std::string output = "Unknown mapper types in software database: ";
@@ -691,6 +881,12 @@ RomDatabase::RomDatabase(CliComm& cliComm)
 			strAppend(output, type, " (", count, "x); ");
 		}
 		cliComm.printWarning(output);
+		warnings = true;
+	}
+	if constexpr (CACHE_SUPPORTED) {
+		// Don't cache a database with problems, so that the warnings
+		// are repeated each time.
+		if (!warnings) writeCache(header);
 	}
 }
 
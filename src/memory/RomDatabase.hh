@@ -3,9 +3,11 @@
 
 #include "RomInfo.hh"
 
+#include "MappedFile.hh"
 #include "MemBuffer.hh"
 #include "sha1.hh"
 
+#include <string_view>
 #include <vector>
 
 namespace openmsx {
@@ -29,11 +31,17 @@ public:
 	[[nodiscard]] const RomInfo* fetchRomInfo(const Sha1Sum& sha1sum) const;
 
 	[[nodiscard]] const RomDB& getFullDB() const { return db; }
-	[[nodiscard]] const char* getBufferStart() const { return buffer.data(); }
+	[[nodiscard]] const char* getBufferStart() const { return bufferStart; }
+
+private:
+	[[nodiscard]] bool loadCache(std::string_view header);
+	void writeCache(std::string_view header) const;
 
 private:
 	RomDB db;
-	MemBuffer<char> buffer;
+	MemBuffer<char> buffer; // string table, either this or part of 'cache'
+	MappedFile<const char> cache;
+	const char* bufferStart = nullptr;
 };
 
 } // namespace openmsx
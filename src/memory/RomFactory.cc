@@ -75,13 +75,89 @@
 #include "one_of.hh"
 #include "xrange.hh"
 
+#include <algorithm>
 #include <bit>
+#include <cassert>
 #include <memory>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace openmsx::RomFactory {
 
 using enum RomType;
 
+static void countMapperWrite(std::span<const uint8_t> data, size_t i,
+                             array_with_enum_index<RomType, unsigned>& typeGuess)
+{
+	auto value = uint16_t(data[i + 1] + (data[i + 2] << 8));
+	switch (value) {
+	case 0x5000:
+	case 0x9000:
+	case 0xb000:
+		typeGuess[KONAMI_SCC]++;
+		break;
+	case 0x4000:
+	case 0x8000:
+	case 0xa000:
+		typeGuess[KONAMI]++;
+		break;
+	case 0x6800:
+	case 0x7800:
+		typeGuess[ASCII8]++;
+		break;
+	case 0x6000:
+		typeGuess[KONAMI]++;
+		typeGuess[ASCII8]++;
+		typeGuess[ASCII16]++;
+		break;
+	case 0x7000:
+		typeGuess[KONAMI_SCC]++;
+		typeGuess[ASCII8]++;
+		typeGuess[ASCII16]++;
+		break;
+	case 0x77ff:
+		typeGuess[ASCII16]++;
+		break;
+	}
+}
+
+// Count the 'ld (nn),a' instructions (opcode 0x32) that write to a
+// mapper register of the different mapper types.
+[[nodiscard]] static array_with_enum_index<RomType, unsigned> countMapperWrites(
+	std::span<const uint8_t> data)
+{
+	array_with_enum_index<RomType, unsigned> typeGuess = {}; // 0-initialized
+	assert(data.size() >= 3);
+	auto end = data.size() - 3;
+	size_t i = 0;
+#ifdef __SSE2__
+	// All register addresses have 0x00 as low byte, except 0x77ff. So only
+	// look closer at the (few) positions where the opcode is followed by
+	// 0x00 or 0xff.
+	const __m128i opcode = _mm_set1_epi8(0x32);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i ones = _mm_set1_epi8(-1);
+	for (/**/; (i + 16) <= end; i += 16) {
+		__m128i v0 = _mm_loadu_si128(std::bit_cast<const __m128i*>(&data[i + 0]));
+		__m128i v1 = _mm_loadu_si128(std::bit_cast<const __m128i*>(&data[i + 1]));
+		__m128i lowByte = _mm_or_si128(_mm_cmpeq_epi8(v1, zero), _mm_cmpeq_epi8(v1, ones));
+		auto mask = unsigned(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(v0, opcode), lowByte)));
+		while (mask) {
+			countMapperWrite(data, i + std::countr_zero(mask), typeGuess);
+			mask &= mask - 1;
+		}
+	}
+#endif
+	for (/**/; i < end; ++i) {
+		if (data[i] == 0x32) {
+			countMapperWrite(data, i, typeGuess);
+		}
+	}
+	return typeGuess;
+}
+
 [[nodiscard]] static RomType guessRomType(const Rom& rom)
 {
 	auto size = rom.size();
@@ -125,41 +201,7 @@ using enum RomType;
 		//  with this instruction to the mapper-registers-addresses
 		//  occur.
 
-		array_with_enum_index<RomType, unsigned> typeGuess = {}; // 0-initialized
-		for (auto i : xrange(size - 3)) {
-			if (data[i] == 0x32) {
-				auto value = uint16_t(data[i + 1] + (data[i + 2] << 8));
-				switch (value) {
-				case 0x5000:
-				case 0x9000:
-				case 0xb000:
-					typeGuess[KONAMI_SCC]++;
-					break;
-				case 0x4000:
-				case 0x8000:
-				case 0xa000:
-					typeGuess[KONAMI]++;
-					break;
-				case 0x6800:
-				case 0x7800:
-					typeGuess[ASCII8]++;
-					break;
-				case 0x6000:
-					typeGuess[KONAMI]++;
-					typeGuess[ASCII8]++;
-					typeGuess[ASCII16]++;
-					break;
-				case 0x7000:
-					typeGuess[KONAMI_SCC]++;
-					typeGuess[ASCII8]++;
-					typeGuess[ASCII16]++;
-					break;
-				case 0x77ff:
-					typeGuess[ASCII16]++;
-					break;
-				}
-			}
-		}
+		auto typeGuess = countMapperWrites(data);
 		if (typeGuess[ASCII8]) typeGuess[ASCII8]--; // -1 -> max_int
 		RomType type = GENERIC_8KB;
 		for (auto [i, tg] : enumerate(typeGuess)) {
@@ -171,6 +213,27 @@ using enum RomType;
 	}
 }
 
+// The results of guessRomType() (which scans the whole ROM image), indexed by
+// sha1sum. So inserting the same unknown ROM again (e.g. also in another
+// machine) doesn't repeat the scan. Only accessed from the main thread.
+struct GuessedRomType {
+	Sha1Sum sha1;
+	RomType type;
+};
+static std::vector<GuessedRomType> guessedRomTypes;
+
+[[nodiscard]] static RomType getGuessedRomType(const Rom& rom)
+{
+	const auto& sha1 = rom.getSHA1();
+	if (auto it = std::ranges::find(guessedRomTypes, sha1, &GuessedRomType::sha1);
+	    it != guessedRomTypes.end()) {
+		return it->type;
+	}
+	auto type = guessRomType(rom);
+	guessedRomTypes.push_back({sha1, type});
+	return type;
+}
+
 std::unique_ptr<MSXDevice> create(DeviceConfig& config)
 {
 	Rom rom(std::string(config.getAttributeValue("id")), "rom", config);
@@ -199,7 +262,7 @@ std::unique_ptr<MSXDevice> create(DeviceConfig& config)
 					return PAGE23;
 				}
 			} else {
-				return guessRomType(rom);
+				return getGuessedRomType(rom);
 			}
 		} else {
 			// Use mapper type from config, even if this overrides DB.
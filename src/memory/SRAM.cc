@@ -12,6 +12,7 @@
 #include "small_buffer.hh"
 
 #include <algorithm>
+#include <vector>
 
 namespace openmsx {
 
@@ -60,6 +61,7 @@ SRAM::~SRAM()
 		schedulable->cancelRT();
 		save();
 	}
+	waitSave();
 }
 
 void SRAM::write(size_t addr, uint8_t value)
@@ -77,7 +79,7 @@ void SRAM::memset(size_t addr, uint8_t c, size_t aSize)
 		schedulable->scheduleRT(5000000); // sync to disk after 5s
 	}
 	assert((addr + aSize) <= size());
-	std::ranges::fill(ram.getWriteBackdoor().subspan(addr, aSize), c);
+	ram.memset(addr, c, aSize);
 }
 
 void SRAM::load(bool* loaded)
@@ -97,6 +99,10 @@ void SRAM::load(bool* loaded)
 		if (headerOk) {
 			file.read(ram.getWriteBackdoor());
 			if (loaded) *loaded = true;
+			// Only if the size matches, later saves can update the
+			// file in-place.
+			fileComplete = file.getSize() == ((header ? strlen(header) : 0) + size());
+			savedEpoch = ram.getDirtyPages().checkpoint();
 		} else {
 			config.getCliComm().printWarning(
 				"Warning no correct SRAM file: ", filename);
@@ -110,22 +116,83 @@ void SRAM::load(bool* loaded)
 	}
 }
 
-void SRAM::save() const
+// Only the pages that changed since the previous save are written, and that
+// happens in a background thread (so that e.g. a multi-megabyte flash ROM
+// doesn't stall emulation or exit). Only when the file doesn't have the
+// expected layout yet, the whole content is written.
+void SRAM::save()
 {
 	assert(config.getXML());
+	waitSave(); // at most one write in flight, also keeps them in order
+
 	const auto& filename = config.getChildData("sramname");
+	std::string resolved;
 	try {
-		File file(config.getFileContext().resolveCreate(filename),
-			  File::OpenMode::TRUNCATE);
-		if (header) {
-			auto length = strlen(header);
-			file.write(std::span{header, length});
-		}
-		file.write(std::span{ram});
+		resolved = config.getFileContext().resolveCreate(filename);
 	} catch (FileException& e) {
 		config.getCliComm().printWarning(
 			"Couldn't save SRAM ", filename,
 			" (", e.getMessage(), ").");
+		return;
+	}
+
+	struct Chunk {
+		size_t offset; // in the file
+		std::vector<uint8_t> data;
+	};
+	std::vector<Chunk> chunks;
+	size_t headerLen = header ? strlen(header) : 0;
+	bool full = !fileComplete;
+	if (full) {
+		auto& data = chunks.emplace_back(0).data;
+		data.reserve(headerLen + size());
+		data.assign(header, header + headerLen);
+		data.insert(data.end(), ram.begin(), ram.end());
+	} else {
+		ram.syncDebugWrites();
+		const auto& dirty = ram.getDirtyPages();
+		std::span<const uint8_t> content{ram};
+		for (size_t page = 0; page < dirty.numPages(); ++page) {
+			if (!dirty.isDirty(page, savedEpoch)) continue;
+			size_t addr = page * DirtyPages::PAGE_SIZE;
+			auto block = content.subspan(addr, std::min(DirtyPages::PAGE_SIZE, size() - addr));
+			if (chunks.empty() ||
+			    ((chunks.back().offset + chunks.back().data.size()) != (headerLen + addr))) {
+				chunks.emplace_back(headerLen + addr);
+			}
+			auto& data = chunks.back().data;
+			data.insert(data.end(), block.begin(), block.end());
+		}
+	}
+	savedEpoch = ram.getDirtyPages().checkpoint();
+	fileComplete = true; // reset in waitSave() if writing fails
+	if (chunks.empty()) return;
+
+	saving = std::async(std::launch::async,
+		[name = std::move(resolved), full, chunks = std::move(chunks)] {
+			try {
+				File file(name, full ? File::OpenMode::TRUNCATE
+				                     : File::OpenMode::NORMAL);
+				for (const auto& chunk : chunks) {
+					file.seek(chunk.offset);
+					file.write(std::span{chunk.data});
+				}
+				return std::string{};
+			} catch (FileException& e) {
+				return std::string(e.getMessage());
+			}
+		});
+}
+
+// Errors of a background save are only reported here (on the main thread).
+void SRAM::waitSave()
+{
+	if (!saving.valid()) return;
+	if (auto error = saving.get(); !error.empty()) {
+		fileComplete = false; // write everything next time
+		config.getCliComm().printWarning(
+			"Couldn't save SRAM ", config.getChildData("sramname"),
+			" (", error, ").");
 	}
 }
 
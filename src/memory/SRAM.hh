@@ -7,7 +7,9 @@
 #include "RTSchedulable.hh"
 
 #include <cstdint>
+#include <future>
 #include <optional>
+#include <string>
 
 namespace openmsx {
 
@@ -59,11 +61,21 @@ private:
 	std::optional<SRAMSchedulable> schedulable;
 
 	void load(bool* loaded);
-	void save() const;
+	void save();
+	void waitSave();
 
 	const DeviceConfig config;
 	TrackedRam ram;
 	const char* const header = nullptr;
+
+	// Pages written to since this epoch are not yet in the file.
+	DirtyPages::Epoch savedEpoch = 0;
+	// Does the file have the correct size and header (then only the dirty
+	// pages need to be written)?
+	bool fileComplete = false;
+	// The file is written in the background, the result is an error
+	// message (empty on success).
+	std::future<std::string> saving;
 };
 
 } // namespace openmsx
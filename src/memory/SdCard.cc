@@ -10,6 +10,7 @@
 #include "narrow.hh"
 #include "unreachable.hh"
 
+#include <algorithm>
 #include <memory>
 
 // TODO:
@@ -43,7 +44,14 @@ SdCard::SdCard(const DeviceConfig& config)
 {
 }
 
-SdCard::~SdCard() = default;
+SdCard::~SdCard()
+{
+	try {
+		flushWrites();
+	} catch (MSXException&) {
+		// nothing we can do here
+	}
+}
 
 // helper methods for 'transfer' to avoid duplication
 uint8_t SdCard::readCurrentByteFromCurrentSector()
@@ -51,7 +59,11 @@ uint8_t SdCard::readCurrentByteFromCurrentSector()
 	uint8_t result = [&] {
 		if (currentByteInSector == -1) {
 			try {
-				hd->readSector(currentSector, sectorBuf);
+				if (mode == Mode::MULTI_READ) {
+					readSectorBatched();
+				} else {
+					hd->readSector(currentSector, sectorBuf);
+				}
 				return START_BLOCK_TOKEN;
 			} catch (MSXException&) {
 				return DATA_ERROR_TOKEN_ERROR;
@@ -68,6 +80,42 @@ uint8_t SdCard::readCurrentByteFromCurrentSector()
 	return result;
 }
 
+// The host will (most likely) also read the following sectors, so read
+// those together with the requested one.
+void SdCard::readSectorBatched()
+{
+	if ((currentSector < readBatchStart) ||
+	    (currentSector >= (readBatchStart + readBatch.size()))) {
+		readBatch.resize(std::min(BATCH_SIZE, hd->getNbSectors() - currentSector));
+		try {
+			hd->readSectors(readBatch, currentSector);
+		} catch (MSXException&) {
+			// Only read the requested sector, so that an error
+			// is reported for the correct sector.
+			readBatch.clear();
+			hd->readSector(currentSector, sectorBuf);
+			return;
+		}
+		readBatchStart = currentSector;
+	}
+	sectorBuf = readBatch[currentSector - readBatchStart];
+}
+
+// Write the sectors collected during a CMD25 in one go. This happens when
+// the batch is full, at the end of the transfer, and before the next
+// command (and before a savestate), so other accesses never see stale data.
+void SdCard::flushWrites()
+{
+	if (writeBatch.empty()) return;
+	try {
+		hd->writeSectors(writeBatch, writeBatchStart);
+	} catch (MSXException&) {
+		writeBatch.clear();
+		throw;
+	}
+	writeBatch.clear();
+}
+
 uint8_t SdCard::transfer(uint8_t value, bool cs)
 {
 	if (!hd) return 0xFF; // no card inserted
@@ -151,6 +199,12 @@ uint8_t SdCard::transfer(uint8_t value, bool cs)
 		if (currentByteInSector == -1) {
 			if (value == STOP_TRAN_TOKEN) {
 				mode = COMMAND;
+				try {
+					flushWrites();
+				} catch (MSXException&) {
+					// too late to report, the blocks were
+					// already accepted
+				}
 			}
 			if (value == START_BLOCK_TOKEN_MBW) {
 				currentByteInSector++;
@@ -171,9 +225,15 @@ uint8_t SdCard::transfer(uint8_t value, bool cs)
 				// however, this makes no sense, CMD12 is only
 				// for Multiple Block Read!? Wrong in the spec?
 			} else {
-				// copy buffer to SD card
+				// collect the sector, write it together with
+				// the following ones
 				try {
-					hd->writeSector(currentSector, sectorBuf);
+					if (hd->isWriteProtected()) {
+						throw MSXException("write protected");
+					}
+					if (writeBatch.empty()) writeBatchStart = currentSector;
+					writeBatch.push_back(sectorBuf);
+					if (writeBatch.size() == BATCH_SIZE) flushWrites();
 					currentByteInSector = -1;
 					currentSector++;
 				} catch (MSXException&) {
@@ -213,6 +273,12 @@ void SdCard::executeCommand()
 	// can be given to a command
 	using enum Mode;
 	transferDelayCounter = 2;
+	readBatch.clear(); // the data may change from now on
+	try {
+		flushWrites(); // in case the host didn't send a stop token
+	} catch (MSXException&) {
+		// ignore, see STOP_TRAN_TOKEN
+	}
 	uint8_t command = cmdBuf[0] & 0x3F;
 	switch (command) {
 	case 0:  // GO_IDLE_STATE
@@ -337,6 +403,13 @@ SERIALIZE_ENUM(SdCard::Mode, modeInfo);
 template<typename Archive>
 void SdCard::serialize(Archive& ar, unsigned /*version*/)
 {
+	if constexpr (!Archive::IS_LOADER) {
+		try {
+			flushWrites(); // pending writes are not part of the state
+		} catch (MSXException&) {
+			// ignore, see STOP_TRAN_TOKEN
+		}
+	}
 	ar.serialize("mode",   mode,
 	             "cmdBuf", cmdBuf);
 	ar.serialize_blob("sectorBuf", sectorBuf.raw);
@@ -8,6 +8,7 @@
 #include <array>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace openmsx {
 
@@ -37,10 +38,25 @@ public:
 private:
 	void executeCommand();
 	[[nodiscard]] uint8_t readCurrentByteFromCurrentSector();
+	void readSectorBatched();
+	void flushWrites();
 
 private:
+	// Multi-block transfers (CMD18/CMD25) access the disk in batches of
+	// (up to) this many sectors.
+	static constexpr size_t BATCH_SIZE = 32; // 16kB
+
 	const std::unique_ptr<HD> hd; // can be nullptr
 
+	// Sectors [readBatchStart, +size) read ahead for the current CMD18.
+	// Not serialized, it's simply read again.
+	std::vector<SectorBuffer> readBatch;
+	size_t readBatchStart = 0;
+	// Sectors [writeBatchStart, +size) received during the current CMD25,
+	// but not yet written.
+	std::vector<SectorBuffer> writeBatch;
+	size_t writeBatchStart = 0;
+
 	std::array<uint8_t, 6> cmdBuf;
 	SectorBuffer sectorBuf;
 	unsigned cmdIdx = 0;
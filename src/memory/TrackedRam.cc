@@ -10,9 +10,18 @@ void TrackedRam::serialize(Archive& ar, unsigned /*version*/)
 	// Note: This is the exact same serialization format as the Ram class.
 	//  This allows to change from Ram to TrackedRam without having to
 	//  increase the class serialization version (of the user).
-	bool diff = writeSinceLastReverseSnapshot || !ar.isReverseSnapshot();
-	ar.serialize_blob("ram", std::span{ram}, diff);
-	if (ar.isReverseSnapshot()) writeSinceLastReverseSnapshot = false;
+	if constexpr (Archive::IS_LOADER) {
+		ar.serialize_blob("ram", std::span{ram});
+		dirty.markAllDirty();
+	} else if (ar.isReverseSnapshot()) {
+		syncDebugWrites();
+		// Only compare the pages that were written to since the
+		// previous reverse snapshot.
+		ar.serialize_blob("ram", std::span{ram}, dirty, lastReverseSnapshot);
+		lastReverseSnapshot = dirty.checkpoint();
+	} else {
+		ar.serialize_blob("ram", std::span{ram});
+	}
 }
 INSTANTIATE_SERIALIZE_METHODS(TrackedRam);
 
@@ -3,6 +3,10 @@
 
 #include "Ram.hh"
 
+#include "DirtyPages.hh"
+
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
 
 namespace openmsx {
@@ -13,11 +17,14 @@ class TrackedRam
 public:
 	// Most methods simply delegate to the internal 'ram' object.
 	TrackedRam(const DeviceConfig& config, const std::string& name,
-	           static_string_view description, size_t size)
-		: ram(config, name, description, size, &writeSinceLastReverseSnapshot) {}
+	           static_string_view description, size_t size,
+	           uint8_t initialValue = 0xff)
+		: ram(config, name, description, size, &debugWrite, initialValue)
+		, dirty(size) {}
 
 	TrackedRam(const XMLElement& xml, size_t size)
-		: ram(xml, size) {}
+		: ram(xml, size)
+		, dirty(size) {}
 
 	[[nodiscard]] size_t size() const {
 		return ram.size();
@@ -41,30 +48,55 @@ public:
 
 	// Only allow write/clear via an explicit method.
 	void write(size_t addr, uint8_t value) {
-		writeSinceLastReverseSnapshot = true;
+		dirty.markDirty(addr);
 		ram[addr] = value;
 	}
 
 	void clear(uint8_t c = 0xff) {
-		writeSinceLastReverseSnapshot = true;
+		dirty.markAllDirty();
 		ram.clear(c);
 	}
 
+	void memset(size_t addr, uint8_t c, size_t num) {
+		assert((addr + num) <= size());
+		dirty.markDirty(addr, num);
+		std::fill_n(ram.data() + addr, num, c);
+	}
+
 	// Some write operations are more efficient in bulk. For those this
 	// method can be used. It will mark the ram as dirty on each
 	// invocation, so the resulting pointer (although the same each time)
 	// should not be reused for multiple (distinct) bulk write operations.
 	[[nodiscard]] std::span<uint8_t> getWriteBackdoor() {
-		writeSinceLastReverseSnapshot = true;
+		dirty.markAllDirty();
 		return {ram.data(), size()};
 	}
 
+	/** Which pages were written to (e.g. to only look at the changed
+	  * parts). Writes via the debugger are only taken into account at
+	  * the next reverse snapshot or syncDebugWrites().
+	  */
+	[[nodiscard]] const DirtyPages& getDirtyPages() const { return dirty; }
+	[[nodiscard]] DirtyPages& getDirtyPages() { return dirty; }
+
+	/** Make writes via the debugger visible in getDirtyPages() (it then
+	  * conservatively marks everything dirty). Call this before looking
+	  * at the dirty pages. */
+	void syncDebugWrites() {
+		if (debugWrite) {
+			dirty.markAllDirty();
+			debugWrite = false;
+		}
+	}
+
 	template<typename Archive>
 	void serialize(Archive& ar, unsigned version);
 
 private:
 	Ram ram;
-	bool writeSinceLastReverseSnapshot = true;
+	DirtyPages dirty;
+	DirtyPages::Epoch lastReverseSnapshot = 0;
+	bool debugWrite = false; // written via the debugger (rare), marks everything dirty
 };
 
 } // namespace openmsx
@@ -0,0 +1,67 @@
+#include "AsyncSender.hh"
+
+#include "narrow.hh"
+
+#include <utility>
+
+namespace openmsx {
+
+AsyncSender::AsyncSender(Writer writer_)
+	: writer(std::move(writer_))
+{
+	thread = std::thread([this]() { workerLoop(); });
+}
+
+AsyncSender::~AsyncSender()
+{
+	{
+		std::scoped_lock lock(mutex);
+		stop = true;
+	}
+	cond.notify_one();
+	thread.join(); // only returns after the queue is drained
+}
+
+bool AsyncSender::send(std::span<const uint8_t> message)
+{
+	if (message.empty()) return true;
+	{
+		std::scoped_lock lock(mutex);
+		if ((pending.data.size() + message.size()) > MAX_QUEUED) {
+			return false;
+		}
+		pending.data.insert(pending.data.end(), message.begin(), message.end());
+		pending.sizes.push_back(narrow<uint32_t>(message.size()));
+	}
+	cond.notify_one();
+	return true;
+}
+
+void AsyncSender::flush()
+{
+	std::unique_lock lock(mutex);
+	emptyCond.wait(lock, [&] { return pending.empty() && !busy; });
+}
+
+void AsyncSender::workerLoop()
+{
+	std::unique_lock lock(mutex);
+	while (true) {
+		cond.wait(lock, [&] { return stop || !pending.empty(); });
+		if (pending.empty()) return; // stopped and queue is drained
+
+		// Take everything that's queued. The swap keeps the allocated
+		// buffers of both batches, so in steady state there are no
+		// allocations.
+		std::swap(current, pending);
+		busy = true;
+		lock.unlock();
+		writer(current);
+		current.clear();
+		lock.lock();
+		busy = false;
+		if (pending.empty()) emptyCond.notify_all();
+	}
+}
+
+} // namespace openmsx
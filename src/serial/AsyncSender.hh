@@ -0,0 +1,92 @@
+#ifndef ASYNCSENDER_HH
+#define ASYNCSENDER_HH
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace openmsx {
+
+/** Outbound queue for serial data that goes to the host (a network socket,
+  * a host MIDI port, ...).
+  *
+  * The emulation thread produces this data one byte or one (short) message
+  * at a time. Doing a system call for each of those would stall emulation,
+  * especially at high baud rates. Instead send() only appends to a queue, a
+  * helper thread takes everything that got queued in the mean time and
+  * passes it in one batch to the 'writer' callback.
+  *
+  * The writer is only called from the helper thread. The queue is drained
+  * (and the helper thread stopped) when this object is destroyed, so the
+  * resources used by the writer must outlive this object.
+  */
+class AsyncSender
+{
+public:
+	/** Don't queue more than this (in bytes), further data is dropped.
+	  * Only reached when the host side stops accepting data. */
+	static constexpr size_t MAX_QUEUED = 1024 * 1024;
+
+	/** A sequence of messages, concatenated in 'data'. */
+	struct Batch {
+		std::vector<uint8_t> data;
+		std::vector<uint32_t> sizes; // size of each message
+
+		[[nodiscard]] bool empty() const { return sizes.empty(); }
+		void clear() { data.clear(); sizes.clear(); }
+
+		/** Call 'op' for each message (as std::span<const uint8_t>). */
+		template<typename Op> void forEachMessage(Op op) const {
+			std::span<const uint8_t> rest = data;
+			for (auto size : sizes) {
+				op(rest.first(size));
+				rest = rest.subspan(size);
+			}
+		}
+	};
+	using Writer = std::function<void(const Batch&)>;
+
+public:
+	explicit AsyncSender(Writer writer);
+	AsyncSender(const AsyncSender&) = delete;
+	AsyncSender(AsyncSender&&) = delete;
+	AsyncSender& operator=(const AsyncSender&) = delete;
+	AsyncSender& operator=(AsyncSender&&) = delete;
+
+	/** Waits till all queued data is written. */
+	~AsyncSender();
+
+	/** Queue a message. Messages are never split over batches. Returns
+	  * false when the message got dropped because the queue is full.
+	  */
+	bool send(std::span<const uint8_t> message);
+
+	/** Wait till all queued data is written. */
+	void flush();
+
+private:
+	void workerLoop();
+
+private:
+	Writer writer;
+
+	std::mutex mutex;
+	std::condition_variable cond;      // signals new data (or stop)
+	std::condition_variable emptyCond; // signals everything is written
+	// The following are protected by 'mutex'.
+	Batch pending;
+	bool busy = false; // is the writer being called
+	bool stop = false;
+
+	Batch current; // only accessed by the helper thread
+
+	std::thread thread; // must be last, started after the above members are initialized
+};
+
+} // namespace openmsx
+
+#endif
@@ -9,6 +9,7 @@
 
 #include <mach/mach_time.h>
 
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <memory>
@@ -18,23 +19,57 @@ namespace openmsx {
 
 // MidiOutMessageBuffer ======================================================
 
+void MidiOutMessageBuffer::startSender()
+{
+	sender.emplace([this](const AsyncSender::Batch& batch) { sendMessages(batch); });
+}
+
+void MidiOutMessageBuffer::stopSender()
+{
+	sender.reset();
+}
+
 void MidiOutMessageBuffer::recvMessage(
 		const std::vector<uint8_t>& message, EmuTime /*time*/)
+{
+	// Only queue the message, the actual send happens in the sender thread.
+	if (sender && !sender->send(message)) {
+		fprintf(stderr, "MIDI output queue full, dropping message\n");
+	}
+}
+
+void MidiOutMessageBuffer::sendMessages(const AsyncSender::Batch& batch)
 {
 	// TODO: It would be better to schedule events based on EmuTime.
 	MIDITimeStamp abstime = mach_absolute_time();
 
-	MIDIPacketList packetList;
-	MIDIPacket *curPacket = MIDIPacketListInit(&packetList);
-	curPacket = MIDIPacketListAdd(&packetList, sizeof(packetList),
-			curPacket, abstime, message.size(), message.data());
-	if (!curPacket) {
-		fprintf(stderr, "Failed to package MIDI data\n");
-	} else if (OSStatus status = sendPacketList(&packetList)) {
-		fprintf(stderr, "Failed to send MIDI data (%d)\n", int(status));
-	} else {
-		//fprintf(stderr, "MIDI send OK: %02X\n", value);
-	}
+	// Put as many messages as fit in one packet list.
+	alignas(MIDIPacketList) std::array<Byte, 1024> buffer;
+	auto* packetList = reinterpret_cast<MIDIPacketList*>(buffer.data());
+	MIDIPacket* curPacket = MIDIPacketListInit(packetList);
+	auto sendList = [&] {
+		if (OSStatus status = sendPacketList(packetList)) {
+			fprintf(stderr, "Failed to send MIDI data (%d)\n", int(status));
+		}
+		curPacket = MIDIPacketListInit(packetList);
+	};
+	batch.forEachMessage([&](std::span<const uint8_t> message) {
+		auto add = [&] {
+			return MIDIPacketListAdd(packetList, buffer.size(),
+				curPacket, abstime, message.size(), message.data());
+		};
+		auto* packet = add();
+		if (!packet && (packetList->numPackets != 0)) {
+			sendList(); // list is full
+			packet = add();
+		}
+		if (!packet) {
+			fprintf(stderr, "Failed to package MIDI data\n");
+			return;
+		}
+		curPacket = packet;
+	});
+	if (packetList->numPackets != 0) sendList();
 }
 
 
@@ -82,11 +117,13 @@ void MidiOutCoreMIDI::plugHelper(Connector& /*connector*/,
 		client = 0;
 		throw PlugException("Failed to create MIDI port (", status, ')');
 	}
+	startSender();
 }
 
 void MidiOutCoreMIDI::unplugHelper(EmuTime /*time*/)
 {
 	clearBuffer();
+	stopSender();
 
 	// Dispose of the client; this automatically disposes of the port as well.
 	if (OSStatus status = MIDIClientDispose(client)) {
@@ -139,11 +176,13 @@ void MidiOutCoreMIDIVirtual::plugHelper(Connector& /*connector*/,
 		MIDIClientDispose(client);
 		throw PlugException("Failed to create MIDI endpoint (", status, ')');
 	}
+	startSender();
 }
 
 void MidiOutCoreMIDIVirtual::unplugHelper(EmuTime /*time*/)
 {
 	clearBuffer();
+	stopSender();
 
 	if (OSStatus status = MIDIEndpointDispose(endpoint)) {
 		fprintf(stderr, "Failed to dispose of MIDI port (%d)\n", int(status));
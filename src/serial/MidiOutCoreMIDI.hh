@@ -3,9 +3,11 @@
 
 #ifdef __APPLE__
 
+#include "AsyncSender.hh"
 #include "MidiOutDevice.hh"
 #include <CoreMIDI/MIDIServices.h>
 
+#include <optional>
 #include <vector>
 
 namespace openmsx {
@@ -13,15 +15,24 @@ namespace openmsx {
 class PluggingController;
 
 /** Puts MIDI messages into a MIDIPacketList.
+  * The messages are queued and sent (batched) from a separate thread, between
+  * startSender() and stopSender().
   */
 class MidiOutMessageBuffer : public MidiOutDevice
 {
 protected:
 	virtual OSStatus sendPacketList(MIDIPacketList *myPacketList) = 0;
 
+	void startSender();
+	void stopSender(); // waits till all queued messages are sent
+
 private:
 	void recvMessage(
 			const std::vector<uint8_t>& message, EmuTime time) override;
+	void sendMessages(const AsyncSender::Batch& batch); // called from the sender thread
+
+private:
+	std::optional<AsyncSender> sender;
 };
 
 /** Sends MIDI events to an existing CoreMIDI destination.
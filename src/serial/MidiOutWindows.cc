@@ -2,6 +2,7 @@
 
 #include "MidiOutWindows.hh"
 
+#include "MSXException.hh"
 #include "Midi_w32.hh"
 #include "PluggingController.hh"
 #include "PlugException.hh"
@@ -9,6 +10,7 @@
 
 #include "xrange.hh"
 
+#include <iostream>
 #include <memory>
 
 namespace openmsx {
@@ -39,10 +41,12 @@ void MidiOutWindows::plugHelper(Connector& /*connector*/, EmuTime /*time*/)
 	if (devIdx == unsigned(-1)) {
 		throw PlugException("Failed to open " + name);
 	}
+	sender.emplace([this](const AsyncSender::Batch& batch) { sendMessages(batch); });
 }
 
 void MidiOutWindows::unplugHelper(EmuTime /*time*/)
 {
+	sender.reset(); // waits till all queued messages are sent
 	if (devIdx != unsigned(-1)) {
 		w32_midiOutClose(devIdx);
 		devIdx = unsigned(-1);
@@ -61,8 +65,22 @@ zstring_view MidiOutWindows::getDescription() const
 
 void MidiOutWindows::recvMessage(const std::vector<uint8_t>& message, EmuTime /*time*/)
 {
-	if (devIdx != unsigned(-1)) {
-		w32_midiOutMsg(message.size(), message.data(), devIdx);
+	// Only queue the message, the (possibly blocking) midiOut calls
+	// happen in the sender thread.
+	if (sender) {
+		(void)sender->send(message); // dropped when the queue is full
+	}
+}
+
+void MidiOutWindows::sendMessages(const AsyncSender::Batch& batch)
+{
+	try {
+		batch.forEachMessage([&](std::span<const uint8_t> message) {
+			w32_midiOutMsg(message.size(), message.data(), devIdx);
+		});
+	} catch (FatalError& e) {
+		// can't propagate from the sender thread
+		std::cerr << "Error sending MIDI data: " << e.getMessage() << '\n';
 	}
 }
 
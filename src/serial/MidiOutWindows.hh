@@ -3,9 +3,12 @@
 
 #ifdef _WIN32
 
+#include "AsyncSender.hh"
 #include "MidiOutDevice.hh"
 #include "serialize_meta.hh"
 
+#include <optional>
+
 namespace openmsx {
 
 class PluggingController;
@@ -30,8 +33,12 @@ public:
 	template<typename Archive>
 	void serialize(Archive& ar, unsigned version);
 
+private:
+	void sendMessages(const AsyncSender::Batch& batch); // called from the sender thread
+
 private:
 	unsigned devIdx = unsigned(-1);
+	std::optional<AsyncSender> sender;
 	std::string name;
 	std::string desc;
 };
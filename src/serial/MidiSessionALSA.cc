@@ -1,5 +1,6 @@
 #include "MidiSessionALSA.hh"
 
+#include "AsyncSender.hh"
 #include "MidiInConnector.hh"
 #include "MidiInDevice.hh"
 #include "MidiOutDevice.hh"
@@ -18,6 +19,7 @@
 
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <thread>
 
 
@@ -51,10 +53,12 @@ public:
 private:
 	void connect();
 	void disconnect();
+	void sendMessages(const AsyncSender::Batch& batch); // called from the sender thread
 
 private:
 	snd_seq_t& seq;
-	snd_midi_event_t* event_parser;
+	snd_midi_event_t* event_parser; // only used by the sender thread while connected
+	std::optional<AsyncSender> sender;
 	int sourcePort = -1;
 	int destClient;
 	int destPort;
@@ -110,12 +114,14 @@ void MidiOutALSA::connect()
 	}
 
 	snd_midi_event_new(MAX_MESSAGE_SIZE, &event_parser);
+	sender.emplace([this](const AsyncSender::Batch& batch) { sendMessages(batch); });
 
 	connected = true;
 }
 
 void MidiOutALSA::disconnect()
 {
+	sender.reset(); // waits till all queued messages are sent
 	snd_midi_event_free(event_parser);
 	snd_seq_disconnect_to(&seq, sourcePort, destClient, destPort);
 	snd_seq_delete_simple_port(&seq, sourcePort);
@@ -136,34 +142,47 @@ zstring_view MidiOutALSA::getDescription() const
 void MidiOutALSA::recvMessage(
 		const std::vector<uint8_t>& message, EmuTime /*time*/)
 {
-	snd_seq_event_t ev;
-	snd_seq_ev_clear(&ev);
-
-	// Set routing.
-	snd_seq_ev_set_source(&ev, narrow_cast<uint8_t>(sourcePort));
-	snd_seq_ev_set_subs(&ev);
-
-	// Set message.
-	if (auto encodeLen = snd_midi_event_encode(
-			event_parser, message.data(), narrow<long>(message.size()), &ev);
-	    encodeLen < 0) {
-		std::cerr << "Error encoding MIDI message of type "
-		          << std::hex << int(message[0]) << std::dec
-		          << ": " << snd_strerror(narrow<int>(encodeLen)) << '\n';
-		return;
-	}
-	if (ev.type == SND_SEQ_EVENT_NONE) {
-		std::cerr << "Incomplete MIDI message of type "
-		          << std::hex << int(message[0]) << std::dec << '\n';
-		return;
+	// Only queue the message, sending happens (batched) in the sender
+	// thread, so that emulation doesn't wait on the sequencer.
+	if (!sender) return; // not connected
+	if (!sender->send(message)) {
+		std::cerr << "MIDI output queue full, dropping message\n";
 	}
+}
 
-	// Send event.
-	snd_seq_ev_set_direct(&ev);
-	if (int err = snd_seq_event_output(&seq, &ev); err < 0) {
-		std::cerr << "Error sending MIDI event: "
-		          << snd_strerror(err) << '\n';
-	}
+void MidiOutALSA::sendMessages(const AsyncSender::Batch& batch)
+{
+	batch.forEachMessage([&](std::span<const uint8_t> message) {
+		snd_seq_event_t ev;
+		snd_seq_ev_clear(&ev);
+
+		// Set routing.
+		snd_seq_ev_set_source(&ev, narrow_cast<uint8_t>(sourcePort));
+		snd_seq_ev_set_subs(&ev);
+
+		// Set message.
+		if (auto encodeLen = snd_midi_event_encode(
+				event_parser, message.data(), narrow<long>(message.size()), &ev);
+		    encodeLen < 0) {
+			std::cerr << "Error encoding MIDI message of type "
+			          << std::hex << int(message[0]) << std::dec
+			          << ": " << snd_strerror(narrow<int>(encodeLen)) << '\n';
+			return;
+		}
+		if (ev.type == SND_SEQ_EVENT_NONE) {
+			std::cerr << "Incomplete MIDI message of type "
+			          << std::hex << int(message[0]) << std::dec << '\n';
+			return;
+		}
+
+		// Queue event, this only fills the output buffer.
+		snd_seq_ev_set_direct(&ev);
+		if (int err = snd_seq_event_output(&seq, &ev); err < 0) {
+			std::cerr << "Error sending MIDI event: "
+			          << snd_strerror(err) << '\n';
+		}
+	});
+	// Send all events of this batch at once.
 	snd_seq_drain_output(&seq);
 }
 
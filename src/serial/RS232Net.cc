@@ -165,6 +165,7 @@ void RS232Net::plugHelper(Connector& connector_, EmuTime /*time*/)
 	if (sockfd == OPENMSX_INVALID_SOCKET) {
 		throw PlugException("Can't open connection");
 	}
+	socketError = false;
 
 	DTR = false;
 	RTS = true;
@@ -179,6 +180,7 @@ void RS232Net::plugHelper(Connector& connector_, EmuTime /*time*/)
 
 	setConnector(&connector_); // base class will do this in a moment,
 	                           // but thread already needs it
+	sender.emplace([this](const AsyncSender::Batch& batch) { net_write(batch); });
 	poller.emplace();
 	thread = std::thread([this]() { run(); });
 }
@@ -191,15 +193,20 @@ void RS232Net::unplugHelper(EmuTime /*time*/)
 			static constexpr std::array<char, 2> dtr_lo = {IP232_MAGIC, IP232_DTR_LO};
 			net_put(dtr_lo);
 		}
-		sock_close(sockfd);
-		sockfd = OPENMSX_INVALID_SOCKET;
 	}
-	// stop helper thread
+	sender.reset(); // waits till all queued data is written
+	// stop helper thread (shutdown also unblocks a pending recv())
 	if (thread.joinable()) {
+		if (sockfd != OPENMSX_INVALID_SOCKET) sock_shutdown(sockfd);
 		poller->abort();
 		thread.join();
 	}
 	poller.reset();
+	// only close when no other thread uses the socket anymore
+	if (sockfd != OPENMSX_INVALID_SOCKET) {
+		sock_close(sockfd);
+		sockfd = OPENMSX_INVALID_SOCKET;
+	}
 }
 
 zstring_view RS232Net::getName() const
@@ -217,7 +224,7 @@ void RS232Net::run()
 {
 	bool ipMagic = false;
 	while (true) {
-		if (sockfd == OPENMSX_INVALID_SOCKET) break;
+		if (socketError) break;
 #ifndef _WIN32
 		if (poller->poll(sockfd)) {
 			break; // error or abort
@@ -226,8 +233,7 @@ void RS232Net::run()
 		char b;
 		auto n = sock_recv(sockfd, &b, sizeof(b));
 		if (n < 0) { // error
-			sock_close(sockfd);
-			sockfd = OPENMSX_INVALID_SOCKET;
+			socketError = true;
 			break;
 		} else if (n == 0) { // no data, try again
 			continue;
@@ -359,17 +365,32 @@ void RS232Net::setRTS(bool status, EmuTime /*time*/)
 	}
 }
 
-// Socket routines below based on VICE emulator socket.c
-bool RS232Net::net_put(std::span<const char> buf)
+// Only queues the data, the actual socket writes happen (batched) in the
+// sender thread, so that emulation doesn't wait on a system call per byte.
+void RS232Net::net_put(std::span<const char> buf)
 {
-	assert(sockfd != OPENMSX_INVALID_SOCKET);
+	assert(sender);
+	// When the queue is full the peer isn't reading anymore, data is dropped.
+	(void)sender->send(std::span{std::bit_cast<const uint8_t*>(buf.data()), buf.size()});
+}
 
-	if (auto n = sock_send(sockfd, buf.data(), buf.size()); n < 0) {
-		sock_close(sockfd);
-		sockfd = OPENMSX_INVALID_SOCKET;
-		return false;
+// Socket routines below based on VICE emulator socket.c
+void RS232Net::net_write(const AsyncSender::Batch& batch)
+{
+	std::span<const char> buf{std::bit_cast<const char*>(batch.data.data()), batch.data.size()};
+	while (!buf.empty()) {
+		if (socketError) return; // drop data
+		auto n = sock_send(sockfd, buf.data(), buf.size());
+		if (n <= 0) {
+			// Don't close the socket here, the receiving thread
+			// may still use it. Shutting it down makes that
+			// thread stop.
+			socketError = true;
+			sock_shutdown(sockfd);
+			return;
+		}
+		buf = buf.subspan(size_t(n));
 	}
-	return true;
 }
 
 // Open a socket and initialise it for client operation
@@ -3,6 +3,7 @@
 
 #include "RS232Device.hh"
 
+#include "AsyncSender.hh"
 #include "BooleanSetting.hh"
 #include "EventListener.hh"
 #include "Socket.hh"
@@ -71,7 +72,8 @@ private:
 	// EventListener
 	bool signalEvent(const Event& event) override;
 
-	bool net_put(std::span<const char> buf);
+	void net_put(std::span<const char> buf);
+	void net_write(const AsyncSender::Batch& batch); // called from the sender thread
 	void open_socket(const NetworkSocketAddress& socket_address);
 
 private:
@@ -85,10 +87,15 @@ private:
 	BooleanSetting rs232NetUseIP232;
 
 	std::thread thread; // receiving thread (reads from 'sockfd')
+	std::optional<AsyncSender> sender; // writes to 'sockfd' in its own thread
 	std::mutex mutex; // to protect shared data between emulation and receiving thread
 	std::optional<Poller> poller; // safe to use from main and receiver thread without extra locking
 	cb_queue<char> queue; // read/written by both the main and the receiver thread. Must hold 'mutex' while doing so.
 	std::atomic<SOCKET> sockfd; // read/written by both threads (use std::atomic as an alternative for locking)
+	// Set by the receiving or sender thread when the connection broke.
+	// Those threads only shut down the socket, it's closed (on unplug)
+	// after both threads have stopped.
+	std::atomic<bool> socketError = false;
 
 	// These are written by the receiver thread and read by the main thread (use std::atomic as an alternative for locking)
 	std::atomic<bool> DCD; // Data Carrier Detect input status
@@ -1,6 +1,7 @@
 #include "serialize.hh"
 
 #include "FileOperations.hh"
+#include "ThreadPool.hh"
 #include "Version.hh"
 #include "XMLElement.hh"
 #include "XMLException.hh"
@@ -10,6 +11,8 @@
 #include "DeltaBlock.hh"
 #include "HexDump.hh"
 #include "MemBuffer.hh"
+#include "enumerate.hh"
+#include "function_ref.hh"
 #include "narrow.hh"
 #include "one_of.hh"
 #include "stl.hh"
@@ -17,16 +20,23 @@
 #include "build-info.hh"
 
 #include "cstdiop.hh" // for dup()
+#include <algorithm>
 #include <bit>
 #include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <limits>
+#include <system_error>
 
 namespace openmsx {
 
 using namespace std::literals;
 
+// Blobs at least this large are (de)compressed in parallel.
+static constexpr size_t PARALLEL_BLOB_SIZE = 4096;
+// Limit the amount of memory used for not yet compressed blobs.
+static constexpr size_t MAX_PENDING_BLOB_SIZE = 32 * 1024 * 1024;
+
 template<typename Derived>
 void ArchiveBase<Derived>::attribute(const char* name, const char* value)
 {
@@ -146,6 +156,15 @@ std::string_view MemInputArchive::loadStr()
 // semi-arbitrary. I only made it >= 52 so that the (incompressible) RP5C01
 // registers won't be compressed.
 static constexpr size_t SMALL_SIZE = 64;
+
+// Large blobs (e.g. a 4MB memory mapper) are split in pages, each page gets
+// its own DeltaBlock. Typically only a small part of such a blob changes
+// between two snapshots: the unchanged pages are shared with the previous
+// snapshot, and when the accumulated differences become too large only the
+// changed pages need a new (full) copy.
+static constexpr size_t BLOB_PAGE_SIZE = 4096;
+static_assert(BLOB_PAGE_SIZE == DirtyPages::PAGE_SIZE);
+
 void MemOutputArchive::serialize_blob(const char* /*tag*/, std::span<const uint8_t> data,
                                       bool diff)
 {
@@ -153,15 +172,38 @@ void MemOutputArchive::serialize_blob(const char* /*tag*/, std::span<const uint8
 	if (data.size() > SMALL_SIZE) {
 		auto deltaBlockIdx = unsigned(deltaBlocks.size());
 		save(deltaBlockIdx); // see comment below in MemInputArchive
-		deltaBlocks.push_back(diff
-			? lastDeltaBlocks.createNew(data.data(), data)
-			: lastDeltaBlocks.createNullDiff(data.data(), data));
+		while (!data.empty()) {
+			auto page = data.first(std::min(BLOB_PAGE_SIZE, data.size()));
+			deltaBlocks.push_back(diff
+				? lastDeltaBlocks.createNew(page.data(), page)
+				: lastDeltaBlocks.createNullDiff(page.data(), page));
+			data = data.subspan(page.size());
+		}
 	} else {
 		auto buf = buffer.allocate(data.size());
 		copy_to_range(data, buf);
 	}
 }
 
+void MemOutputArchive::serialize_blob(const char* tag, std::span<const uint8_t> data,
+                                      const DirtyPages& dirty, DirtyPages::Epoch since)
+{
+	if (data.size() <= SMALL_SIZE) {
+		serialize_blob(tag, data);
+		return;
+	}
+	assert(dirty.numPages() * BLOB_PAGE_SIZE >= data.size());
+	auto deltaBlockIdx = unsigned(deltaBlocks.size());
+	save(deltaBlockIdx);
+	for (size_t i = 0; !data.empty(); ++i) {
+		auto page = data.first(std::min(BLOB_PAGE_SIZE, data.size()));
+		deltaBlocks.push_back(dirty.isDirty(i, since)
+			? lastDeltaBlocks.createNew(page.data(), page)
+			: lastDeltaBlocks.createNullDiff(page.data(), page));
+		data = data.subspan(page.size());
+	}
+}
+
 void MemInputArchive::serialize_blob(const char* /*tag*/, std::span<uint8_t> data,
                                      bool /*diff*/)
 {
@@ -175,7 +217,11 @@ void MemInputArchive::serialize_blob(const char* /*tag*/, std::span<uint8_t> dat
 		// is possible that certain blobs are stored in the savestate,
 		// but skipped while loading. That's why we do need the index.
 		unsigned deltaBlockIdx; load(deltaBlockIdx);
-		deltaBlocks[deltaBlockIdx]->apply(data);
+		while (!data.empty()) { // one DeltaBlock per page
+			auto page = data.first(std::min(BLOB_PAGE_SIZE, data.size()));
+			deltaBlocks[deltaBlockIdx++]->apply(page);
+			data = data.subspan(page.size());
+		}
 	} else {
 		copy_to_range(std::span{buffer.getCurrentPos(), data.size()}, data);
 		buffer.skip(data.size());
@@ -184,16 +230,16 @@ void MemInputArchive::serialize_blob(const char* /*tag*/, std::span<uint8_t> dat
 
 ////
 
-XmlOutputArchive::XmlOutputArchive(zstring_view filename_)
+XmlOutputArchive::XmlOutputArchive(zstring_view filename_, bool append)
 	: filename(filename_)
 	, writer(*this)
 {
 	{
-		auto f = FileOperations::openFile(filename, "wb");
+		auto f = FileOperations::openFile(filename, append ? "ab" : "wb");
 		if (!f) error();
 		int duped_fd = dup(fileno(f.get()));
 		if (duped_fd == -1) error();
-		file = gzdopen(duped_fd, "wb9");
+		file = gzdopen(duped_fd, append ? "ab9" : "wb9");
 		if (!file) {
 			::close(duped_fd);
 			error();
@@ -218,6 +264,7 @@ void XmlOutputArchive::close()
 	if (!file) return; // already closed
 
 	writer.end("serial");
+	flushBlobs();
 
 	if (gzclose(file) != Z_OK) {
 		error();
@@ -236,18 +283,31 @@ XmlOutputArchive::~XmlOutputArchive()
 
 void XmlOutputArchive::write(std::span<const char> buf)
 {
-	if ((gzwrite(file, buf.data(), unsigned(buf.size())) == 0) && !buf.empty()) {
-		error();
+	if (!blobJobs.empty()) {
+		blobJobs.back().textAfter.append(buf.data(), buf.size());
+		return;
 	}
+	writeToFile(buf);
 }
 
 void XmlOutputArchive::write1(char c)
 {
+	if (!blobJobs.empty()) {
+		blobJobs.back().textAfter += c;
+		return;
+	}
 	if (gzputc(file, c) == -1) {
 		error();
 	}
 }
 
+void XmlOutputArchive::writeToFile(std::span<const char> buf)
+{
+	if ((gzwrite(file, buf.data(), unsigned(buf.size())) == 0) && !buf.empty()) {
+		error();
+	}
+}
+
 void XmlOutputArchive::check(bool condition) const
 {
 	assert(condition); (void)condition;
@@ -321,9 +381,58 @@ void XmlOutputArchive::endTag(const char* tag)
 	writer.end(tag);
 }
 
+[[nodiscard]] static std::string compressBlob(std::span<const uint8_t> data)
+{
+	// TODO check for overflow?
+	auto len = data.size();
+	auto dstLen = uLongf(len + len / 1000 + 12 + 1); // worst-case
+	MemBuffer<uint8_t> buf(dstLen);
+	if (compress2(buf.data(), &dstLen,
+	              std::bit_cast<const Bytef*>(data.data()),
+	              uLong(len), 9)
+	    != Z_OK) {
+		throw MSXException("Error while compressing blob.");
+	}
+	return Base64::encode(buf.first(dstLen));
+}
+
+void XmlOutputArchive::flushBlobs()
+{
+	if (blobJobs.empty()) return;
+	auto jobs = std::move(blobJobs);
+	blobJobs.clear();
+	pendingBlobSize = 0;
+
+	ThreadPool::parallelForTemporary(jobs.size(), [&](size_t i) {
+		jobs[i].encoded = compressBlob(jobs[i].data);
+	});
+	for (const auto& job : jobs) {
+		writeToFile(job.encoded);
+		writeToFile(job.textAfter);
+	}
+}
+
 void XmlOutputArchive::serialize_blob(
 	const char* tag, std::span<const uint8_t> data, bool /*diff*/)
 {
+	if (data.size() >= PARALLEL_BLOB_SIZE) {
+		// Compressing large blobs dominates the time to save a
+		// savestate, so defer it and later compress (a batch of)
+		// them in parallel. The size is stored so that loading can
+		// also decompress these blobs in parallel.
+		writer.begin(tag);
+		writer.attribute("encoding", "gz-base64");
+		writer.attribute("size", std::string_view(tmpStrCat(data.size())));
+		writer.beginDataRaw();
+		MemBuffer<uint8_t> copy(data.size());
+		copy_to_range(data, std::span{copy});
+		blobJobs.push_back(BlobJob{std::move(copy), {}, {}});
+		pendingBlobSize += data.size();
+		writer.end(tag);
+		if (pendingBlobSize >= MAX_PENDING_BLOB_SIZE) flushBlobs();
+		return;
+	}
+
 	std::string_view encoding;
 	std::string tmp;
 	if (false) {
@@ -335,17 +444,7 @@ void XmlOutputArchive::serialize_blob(
 		tmp = Base64::encode(data);
 	} else {
 		encoding = "gz-base64";
-		// TODO check for overflow?
-		auto len = data.size();
-		auto dstLen = uLongf(len + len / 1000 + 12 + 1); // worst-case
-		MemBuffer<uint8_t> buf(dstLen);
-		if (compress2(buf.data(), &dstLen,
-		              std::bit_cast<const Bytef*>(data.data()),
-		              uLong(len), 9)
-		    != Z_OK) {
-			throw MSXException("Error while compressing blob.");
-		}
-		tmp = Base64::encode(buf.first(dstLen));
+		tmp = compressBlob(data);
 	}
 	writer.begin(tag);
 	writer.attribute("encoding", encoding);
@@ -360,6 +459,74 @@ XmlInputArchive::XmlInputArchive(zstring_view filename)
 	xmlDoc.load(filename, "openmsx-serialize.dtd");
 	auto* root = xmlDoc.getRoot();
 	elems.emplace_back(root, root->getFirstChild());
+	decodeBlobs();
+}
+
+XmlInputArchive::XmlInputArchive(MemBuffer<char> data, std::string_view name)
+{
+	xmlDoc.load(std::move(data), name, "openmsx-serialize.dtd");
+	auto* root = xmlDoc.getRoot();
+	elems.emplace_back(root, root->getFirstChild());
+	decodeBlobs();
+}
+
+static void collectBlobs(const XMLElement& elem,
+                         function_ref<void(const XMLElement&, size_t)> action)
+{
+	if (elem.getFirstChild()) {
+		for (const auto& child : elem.getChildren()) collectBlobs(child, action);
+	} else if (elem.getAttributeValue("encoding", {}) == "gz-base64") {
+		if (auto size = StringOp::stringTo<size_t>(elem.getAttributeValue("size", {}));
+		    size && (*size >= PARALLEL_BLOB_SIZE)) {
+			action(elem, *size);
+		}
+	}
+}
+
+void XmlInputArchive::decodeBlobs()
+{
+	// Collect all large compressed blobs (only files written by newer
+	// openMSX versions store the size), and decompress them in parallel.
+	// This runs in the background: meanwhile the rest of the savestate
+	// gets loaded (which includes constructing the whole machine), and
+	// serialize_blob() only waits for the specific blob it needs. Blobs
+	// are decoded in document order, that's usually also the order in
+	// which they're loaded. On error a blob is simply not stored,
+	// serialize_blob() will then decode it again and report the error.
+	std::vector<std::pair<const XMLElement*, size_t>> found;
+	collectBlobs(*xmlDoc.getRoot(), [&](const XMLElement& elem, size_t size) {
+		found.emplace_back(&elem, size);
+	});
+	if (found.empty()) return;
+
+	blobJobs = std::vector<BlobJob>(found.size());
+	for (auto [i, f] : enumerate(found)) {
+		blobJobs[i].elem = f.first;
+		blobJobs[i].size = f.second;
+		blobIndex.emplace(f.first, i);
+	}
+	auto decodeAll = [this] {
+		ThreadPool::parallelForTemporary(blobJobs.size(), [&](size_t i) {
+			auto& job = blobJobs[i];
+			try {
+				auto buf = Base64::decode(job.elem->getData());
+				job.result.resize(job.size);
+				auto dstLen = uLongf(job.size);
+				job.ok = (uncompress(job.result.data(), &dstLen,
+				                     buf.data(), uLong(buf.size())) == Z_OK) &&
+				         (dstLen == job.size);
+			} catch (...) {
+				job.ok = false; // e.g. out of memory
+			}
+			job.done.store(true, std::memory_order_release);
+			job.done.notify_all();
+		});
+	};
+	try {
+		blobDecoder = std::async(std::launch::async, decodeAll);
+	} catch (std::system_error&) {
+		decodeAll(); // couldn't create thread
+	}
 }
 
 std::string_view XmlInputArchive::loadStr() const
@@ -529,6 +696,16 @@ void XmlInputArchive::serialize_blob(
 	const char* tag, std::span<uint8_t> data, bool /*diff*/)
 {
 	this->self().beginTag(tag);
+	if (const auto* idx = lookup(blobIndex, currentElement())) {
+		auto& job = blobJobs[*idx];
+		job.done.wait(false, std::memory_order_acquire);
+		auto decoded = std::move(job.result); // free memory on scope exit
+		if (job.ok && (job.size == data.size())) {
+			copy_to_range(std::span{decoded.data(), job.size}, data);
+			this->self().endTag(tag);
+			return;
+		}
+	}
 	std::string encoding;
 	this->self().attribute("encoding", encoding);
 
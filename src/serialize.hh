@@ -6,6 +6,7 @@
 #include "XMLOutputStream.hh"
 #include "serialize_core.hh"
 
+#include "DirtyPages.hh"
 #include "MemBuffer.hh"
 #include "StringOp.hh"
 #include "hash_map.hh"
@@ -17,7 +18,9 @@
 #include <zlib.h>
 
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <future>
 #include <memory>
 #include <optional>
 #include <span>
@@ -659,6 +662,19 @@ public:
 	{
 	}
 
+	/** Same as above, but serialize into the (possibly empty) given
+	  * memory, typically obtained from releaseCopy() of a previous
+	  * archive. */
+	MemOutputArchive(LastDeltaBlocks& lastDeltaBlocks_,
+	                 std::vector<std::shared_ptr<DeltaBlock>>& deltaBlocks_,
+			 bool reverseSnapshot_, MemBuffer<uint8_t>&& storage)
+		: buffer(std::move(storage))
+		, lastDeltaBlocks(lastDeltaBlocks_)
+		, deltaBlocks(deltaBlocks_)
+		, reverseSnapshot(reverseSnapshot_)
+	{
+	}
+
 	~MemOutputArchive()
 	{
 		assert(openSections.empty());
@@ -680,6 +696,11 @@ public:
 	void save(std::string_view s);
 	void serialize_blob(const char* tag, std::span<const uint8_t> data,
 	                    bool diff = true);
+	// Only the pages that are dirty (since the given epoch) can have
+	// changed since the previous snapshot, the other pages don't need
+	// to be compared.
+	void serialize_blob(const char* tag, std::span<const uint8_t> data,
+	                    const DirtyPages& dirty, DirtyPages::Epoch since);
 
 	using OutputArchiveBase<MemOutputArchive>::serialize;
 	template<typename T, typename ...Args>
@@ -723,6 +744,17 @@ public:
 		return std::move(buffer).release();
 	}
 
+	/** Return a copy of the serialized data, and give the internal
+	  * memory back via 'storage' so that it can be reused for the next
+	  * archive. For repeated snapshots this avoids (re)allocations
+	  * while serializing. */
+	[[nodiscard]] MemBuffer<uint8_t> releaseCopy(MemBuffer<uint8_t>& storage) &&
+	{
+		auto result = buffer.copyData();
+		storage = std::move(buffer).releaseStorage();
+		return result;
+	}
+
 private:
 	ALWAYS_INLINE void serialize_group(const std::tuple<>& /*tuple*/) const
 	{
@@ -843,7 +875,9 @@ private:
 class XmlOutputArchive final : public OutputArchiveBase<XmlOutputArchive>
 {
 public:
-	explicit XmlOutputArchive(zstring_view filename);
+	/** When 'append' is true, the output is appended to an existing file
+	  * as an additional gzip member. */
+	explicit XmlOutputArchive(zstring_view filename, bool append = false);
 	void close();
 	~XmlOutputArchive();
 
@@ -883,6 +917,11 @@ public:
 
 	void serialize_blob(const char* tag, std::span<const uint8_t> data,
 	                    bool diff = true);
+	void serialize_blob(const char* tag, std::span<const uint8_t> data,
+	                    const DirtyPages& /*dirty*/, DirtyPages::Epoch /*since*/)
+	{
+		serialize_blob(tag, data);
+	}
 
 	auto& getXMLOutputStream() { return writer; }
 
@@ -912,16 +951,35 @@ public:
 	void check(bool condition) const;
 	[[noreturn]] void error();
 
+private:
+	void writeToFile(std::span<const char> buf);
+	void flushBlobs();
+
 private:
 	zstring_view filename;
 	gzFile file = nullptr;
 	XMLOutputStream<XmlOutputArchive> writer;
+
+	// Large blobs are not compressed immediately. Instead their output is
+	// deferred (together with all the XML that follows it) until a batch
+	// of them can be compressed in parallel.
+	struct BlobJob {
+		MemBuffer<uint8_t> data; // copy, the original may be a temporary
+		std::string encoded;
+		std::string textAfter;
+	};
+	std::vector<BlobJob> blobJobs;
+	size_t pendingBlobSize = 0;
 };
 
 class XmlInputArchive final : public InputArchiveBase<XmlInputArchive>
 {
 public:
 	explicit XmlInputArchive(zstring_view filename);
+	/** Parse an in-memory document (must end with at least
+	  * rapidsax::EXTRA_BUFFER_SPACE zero bytes). 'name' is only used in
+	  * error messages. */
+	XmlInputArchive(MemBuffer<char> data, std::string_view name);
 
 	[[nodiscard]] bool versionAtLeast(unsigned actual, unsigned required) const
 	{
@@ -1005,9 +1063,23 @@ public:
 		return {};
 	}
 
+private:
+	void decodeBlobs();
+
 private:
 	XMLDocument xmlDoc{16384}; // tweak: initial allocator buffer size
 	std::vector<std::pair<XMLElement*, XMLElement*>> elems;
+	// Large blobs, decoded (in parallel) in the background, see decodeBlobs().
+	struct BlobJob {
+		const XMLElement* elem = nullptr;
+		size_t size = 0;
+		MemBuffer<uint8_t> result;
+		bool ok = false;
+		std::atomic<bool> done = false; // 'result' and 'ok' are valid
+	};
+	std::vector<BlobJob> blobJobs;
+	hash_map<const XMLElement*, size_t> blobIndex;
+	std::future<void> blobDecoder; // must be last: waits in its destructor
 };
 
 #define INSTANTIATE_SERIALIZE_METHODS(CLASS) \
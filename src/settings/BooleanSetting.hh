@@ -17,6 +17,7 @@ public:
 	void tabCompletion(std::vector<std::string>& tokens) const override;
 
 	[[nodiscard]] bool getBoolean() const noexcept {
+		if constexpr (PROFILE_SETTINGS) tickSettingCounter(SettingCounters::GetBoolean);
 		return getValue().getBoolean(getInterpreter());
 	}
 	void setBoolean(bool b) { setValue(TclObject(toString(b))); }
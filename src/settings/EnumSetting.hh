@@ -112,11 +112,13 @@ void EnumSetting<T>::tabCompletion(std::vector<std::string>& tokens) const
 template<EnumSettingValue T>
 T EnumSetting<T>::getEnum() const noexcept
 {
+	if constexpr (PROFILE_SETTINGS) tickSettingCounter(SettingCounters::GetEnum);
 	return static_cast<T>(fromStringBase(getValue().getString()));
 }
 template<> inline bool EnumSetting<bool>::getEnum() const noexcept
 {
 	// _exactly_ the same functionality as above, but suppress VS warning
+	if constexpr (PROFILE_SETTINGS) tickSettingCounter(SettingCounters::GetEnum);
 	return fromStringBase(getValue().getString()) != 0;
 }
 
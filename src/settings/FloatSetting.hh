@@ -18,8 +18,14 @@ public:
 	[[nodiscard]] std::string_view getTypeString() const override;
 	void additionalInfo(TclObject& result) const override;
 
-	[[nodiscard]] double getDouble() const noexcept { return getValue().getDouble(getInterpreter()); }
-	[[nodiscard]] float  getFloat()  const noexcept { return getValue().getFloat (getInterpreter()); }
+	[[nodiscard]] double getDouble() const noexcept {
+		if constexpr (PROFILE_SETTINGS) tickSettingCounter(SettingCounters::GetFloat);
+		return getValue().getDouble(getInterpreter());
+	}
+	[[nodiscard]] float getFloat() const noexcept {
+		if constexpr (PROFILE_SETTINGS) tickSettingCounter(SettingCounters::GetFloat);
+		return getValue().getFloat(getInterpreter());
+	}
 	void setDouble(double d);
 	void setFloat (float f);
 
@@ -18,7 +18,10 @@ public:
 	[[nodiscard]] std::string_view getTypeString() const override;
 	void additionalInfo(TclObject& result) const override;
 
-	[[nodiscard]] int getInt() const noexcept { return getValue().getInt(getInterpreter()); }
+	[[nodiscard]] int getInt() const noexcept {
+		if constexpr (PROFILE_SETTINGS) tickSettingCounter(SettingCounters::GetInt);
+		return getValue().getInt(getInterpreter());
+	}
 	void setInt(int i);
 
 	[[nodiscard]] int getMinValue() const { return minValue; }
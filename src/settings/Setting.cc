@@ -12,6 +12,28 @@
 
 namespace openmsx {
 
+std::ostream& operator<<(std::ostream& os, EnumTypeName<SettingCounters>)
+{
+	return os << "SettingCounters";
+}
+std::ostream& operator<<(std::ostream& os, EnumValueName<SettingCounters> evn)
+{
+	std::array<std::string_view, size_t(SettingCounters::NUM)> names = {
+		"GetBoolean",
+		"GetInt",
+		"GetFloat",
+		"GetEnum",
+	};
+	return os << names[size_t(evn.e)];
+}
+
+void tickSettingCounter(SettingCounters counter)
+{
+	// printed at program exit
+	static ProfileCounters<PROFILE_SETTINGS, SettingCounters> counters;
+	counters.tick(counter);
+}
+
 // class BaseSetting
 
 BaseSetting::BaseSetting(std::string_view name)
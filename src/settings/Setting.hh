@@ -1,6 +1,7 @@
 #ifndef SETTING_HH
 #define SETTING_HH
 
+#include "ProfileCounters.hh"
 #include "Subject.hh"
 #include "TclObject.hh"
 #include "static_string_view.hh"
@@ -19,6 +20,22 @@ class CommandController;
 class GlobalCommandController;
 class Interpreter;
 
+// Counts how often the (typed) value of a setting is requested, e.g. via
+// BooleanSetting::getBoolean(). Each such call converts the TclObject value,
+// so these should not be called on hot paths (instead cache the value and
+// update it from Observer<Setting>::update()).
+inline constexpr bool PROFILE_SETTINGS = false;
+enum class SettingCounters : uint8_t {
+	GetBoolean,
+	GetInt,
+	GetFloat,
+	GetEnum,
+	NUM // must be last
+};
+std::ostream& operator<<(std::ostream& os, EnumTypeName<SettingCounters>);
+std::ostream& operator<<(std::ostream& os, EnumValueName<SettingCounters> evn);
+void tickSettingCounter(SettingCounters counter);
+
 class BaseSetting
 {
 protected:
@@ -0,0 +1,147 @@
+#include "ALSASoundDriver.hh"
+
+#include "MSXException.hh"
+#include "Timer.hh"
+
+#include "MemBuffer.hh"
+
+#include <cerrno>
+
+namespace openmsx {
+
+static void check(int err, const char* what)
+{
+	if (err < 0) {
+		throw MSXException("Unable to open ALSA audio, ", what, ": ", snd_strerror(err));
+	}
+}
+
+ALSASoundDriver::ALSASoundDriver(Reactor& reactor_,
+                                 unsigned wantedFreq, unsigned wantedSamples)
+	: BufferedSoundDriver(reactor_)
+{
+	check(snd_pcm_open(&pcm, "default", SND_PCM_STREAM_PLAYBACK, 0), "open");
+	try {
+		snd_pcm_hw_params_t* hw;
+		snd_pcm_hw_params_alloca(&hw);
+		check(snd_pcm_hw_params_any(pcm, hw), "no configurations");
+		check(snd_pcm_hw_params_set_access(pcm, hw, SND_PCM_ACCESS_RW_INTERLEAVED), "access");
+		check(snd_pcm_hw_params_set_format(pcm, hw, SND_PCM_FORMAT_FLOAT), "format");
+		check(snd_pcm_hw_params_set_channels(pcm, hw, 2), "channels"); // stereo
+		unsigned rate = wantedFreq;
+		check(snd_pcm_hw_params_set_rate_near(pcm, hw, &rate, nullptr), "rate");
+		snd_pcm_uframes_t period = wantedSamples;
+		check(snd_pcm_hw_params_set_period_size_near(pcm, hw, &period, nullptr), "period size");
+		snd_pcm_uframes_t bufferSize = 2 * period;
+		check(snd_pcm_hw_params_set_buffer_size_near(pcm, hw, &bufferSize), "buffer size");
+		check(snd_pcm_hw_params(pcm, hw), "hw params");
+		check(snd_pcm_hw_params_get_period_size(hw, &period, nullptr), "period size");
+		check(snd_pcm_hw_params_get_rate(hw, &rate, nullptr), "rate");
+
+		snd_pcm_sw_params_t* sw;
+		snd_pcm_sw_params_alloca(&sw);
+		check(snd_pcm_sw_params_current(pcm, sw), "sw params");
+		check(snd_pcm_sw_params_set_start_threshold(pcm, sw, period), "start threshold");
+		check(snd_pcm_sw_params_set_avail_min(pcm, sw, period), "avail min");
+		check(snd_pcm_sw_params(pcm, sw), "sw params");
+
+		frequency = rate;
+		fragmentSize = unsigned(period);
+	} catch (MSXException&) {
+		snd_pcm_close(pcm);
+		throw;
+	}
+
+	// Same amount of buffering (in fragments) as SDLSoundDriver.
+	allocateBuffer(3 * fragmentSize + 1);
+	thread = std::thread([this] { run(); });
+}
+
+ALSASoundDriver::~ALSASoundDriver()
+{
+	{
+		std::scoped_lock lock(mutex);
+		stop = true;
+	}
+	cond.notify_one();
+	thread.join();
+	snd_pcm_close(pcm);
+}
+
+void ALSASoundDriver::mute()
+{
+	std::scoped_lock lock(mutex);
+	muted = true;
+}
+
+void ALSASoundDriver::unmute()
+{
+	{
+		std::scoped_lock lock(mutex);
+		if (!muted) return;
+		muted = false;
+		resetBuffer();
+	}
+	cond.notify_one();
+}
+
+unsigned ALSASoundDriver::getFrequency() const
+{
+	return frequency;
+}
+
+unsigned ALSASoundDriver::getSamples() const
+{
+	return fragmentSize;
+}
+
+double ALSASoundDriver::getLatency() const
+{
+	auto delay = deviceDelay.load(std::memory_order_relaxed);
+	return double(getBuffered() + delay) / double(frequency);
+}
+
+void ALSASoundDriver::run()
+{
+	MemBuffer<StereoFloat> fragment(fragmentSize);
+	std::unique_lock lock(mutex);
+	while (true) {
+		cond.wait(lock, [&] { return stop || !muted; });
+		if (stop) break;
+		pull(fragment);
+		lock.unlock();
+
+		write(fragment); // blocks till the device has room
+
+		lock.lock();
+		if (muted) {
+			// discard what's still queued in the device
+			snd_pcm_drop(pcm);
+			snd_pcm_prepare(pcm);
+			deviceDelay = 0;
+		}
+	}
+}
+
+void ALSASoundDriver::write(std::span<const StereoFloat> fragment)
+{
+	while (!fragment.empty()) {
+		auto r = snd_pcm_writei(pcm, fragment.data(), fragment.size());
+		if (r < 0) {
+			if (r == -EPIPE) countUnderrun(); // the device ran out of samples
+			if (snd_pcm_recover(pcm, int(r), 1) < 0) {
+				// e.g. the device was removed, drop this fragment
+				// (without busy looping) and retry with the next
+				Timer::sleep(uint64_t(fragment.size()) * 1'000'000 / frequency);
+				return;
+			}
+			continue;
+		}
+		fragment = fragment.subspan(size_t(r));
+	}
+	if (snd_pcm_sframes_t delay; snd_pcm_delay(pcm, &delay) == 0) {
+		deviceDelay.store(delay, std::memory_order_relaxed);
+	}
+}
+
+} // namespace openmsx
@@ -0,0 +1,62 @@
+#ifndef ALSASOUNDDRIVER_HH
+#define ALSASOUNDDRIVER_HH
+
+#include "BufferedSoundDriver.hh"
+
+#include <alsa/asoundlib.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace openmsx {
+
+class Reactor;
+
+/** Plays the sound directly via ALSA (on modern systems this typically
+  * goes to PipeWire or PulseAudio via their ALSA plugin).
+  *
+  * Compared to SDL this allows much smaller fragments (the 'samples'
+  * setting is used as the ALSA period size, with only two periods in the
+  * device buffer), so a lower latency. A thread pulls one fragment from
+  * the buffer each time the device has room for it. The actual delay of
+  * the device is measured after each fragment (snd_pcm_delay()).
+  */
+class ALSASoundDriver final : public BufferedSoundDriver
+{
+public:
+	ALSASoundDriver(Reactor& reactor, unsigned wantedFreq, unsigned wantedSamples);
+	ALSASoundDriver(const ALSASoundDriver&) = delete;
+	ALSASoundDriver(ALSASoundDriver&&) = delete;
+	ALSASoundDriver& operator=(const ALSASoundDriver&) = delete;
+	ALSASoundDriver& operator=(ALSASoundDriver&&) = delete;
+	~ALSASoundDriver() override;
+
+	void mute() override;
+	void unmute() override;
+
+	[[nodiscard]] unsigned getFrequency() const override;
+	[[nodiscard]] unsigned getSamples() const override;
+	[[nodiscard]] double getLatency() const override;
+
+private:
+	void run();
+	void write(std::span<const StereoFloat> fragment);
+
+private:
+	snd_pcm_t* pcm = nullptr;
+	unsigned frequency;
+	unsigned fragmentSize;
+	std::atomic<snd_pcm_sframes_t> deviceDelay = 0; // in samples
+
+	std::mutex mutex; // like SDL_LockAudioDevice(), held while pulling
+	std::condition_variable cond;
+	bool muted = true; // protected by 'mutex'
+	bool stop = false; // protected by 'mutex'
+	std::thread thread;
+};
+
+} // namespace openmsx
+
+#endif
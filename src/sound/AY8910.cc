@@ -169,21 +169,18 @@ inline void AY8910::ToneGenerator::reset()
 int AY8910::ToneGenerator::getDetune(const AY8910& ay8910)
 {
 	int result = 0;
-	if (float vibPerc = ay8910.vibratoPercent.getFloat();
+	if (float vibPerc = ay8910.vibratoPerc;
 	    vibPerc != 0.0f) {
-		auto vibratoPeriod = int(
-			NATIVE_FREQ_FLOAT /
-			ay8910.vibratoFrequency.getFloat());
+		auto vibratoPeriod = ay8910.vibratoPeriod;
 		vibratoCount += period;
 		vibratoCount %= vibratoPeriod;
 		result += narrow_cast<int>(
 			sinf((float(2 * Math::pi) * narrow_cast<float>(vibratoCount)) / narrow_cast<float>(vibratoPeriod))
 			* vibPerc * 0.01f * narrow_cast<float>(period));
 	}
-	if (float detunePerc = ay8910.detunePercent.getFloat();
+	if (float detunePerc = ay8910.detunePerc;
 	    detunePerc != 0.0f) {
-		float detunePeriod = NATIVE_FREQ_FLOAT /
-			ay8910.detuneFrequency.getFloat();
+		float detunePeriod = ay8910.detunePeriod;
 		detuneCount += period;
 		float noiseIdx = narrow_cast<float>(detuneCount) / detunePeriod;
 		float detuneNoise = noiseValue(       noiseIdx)
@@ -501,7 +498,7 @@ AY8910::AY8910(const std::string& name_, AY8910Periphery& periphery_,
 	, isAY8910(checkAY8910(config))
 	, ignorePortDirections(config.getChildDataAsBool("ignorePortDirections", true))
 {
-	update(vibratoPercent);
+	updateDetune();
 
 	// make valgrind happy
 	std::ranges::fill(regs, 0);
@@ -510,14 +507,18 @@ AY8910::AY8910(const std::string& name_, AY8910Periphery& periphery_,
 	registerSound(config);
 
 	// only attach once all initialization is successful
-	vibratoPercent.attach(*this);
-	detunePercent .attach(*this);
+	vibratoPercent  .attach(*this);
+	vibratoFrequency.attach(*this);
+	detunePercent   .attach(*this);
+	detuneFrequency .attach(*this);
 }
 
 AY8910::~AY8910()
 {
-	vibratoPercent.detach(*this);
-	detunePercent .detach(*this);
+	vibratoPercent  .detach(*this);
+	vibratoFrequency.detach(*this);
+	detunePercent   .detach(*this);
+	detuneFrequency .detach(*this);
 
 	unregisterSound();
 }
@@ -719,6 +720,10 @@ void AY8910::generateChannels(std::span<float*> bufs, unsigned num)
 	//   and ToneDisable and NoiseDisable come from the enable reg.
 	// Note that this means that if both tone and noise are disabled, the
 	// output is 1, not 0, and can be modulated by changing the volume.
+	// The output only changes when one of the (tone, noise, envelope)
+	// generators changes state. So instead of stepping sample per sample,
+	// each loop below jumps from one such event to the next and fills the
+	// constant span in between with addFill().
 	bool envelopeUpdated = false;
 	Envelope initialEnvelope = envelope;
 	NoiseGenerator initialNoise = noise;
@@ -981,14 +986,23 @@ float AY8910::getAmplificationFactorImpl() const
 
 void AY8910::update(const Setting& setting) noexcept
 {
-	if (&setting == one_of(&vibratoPercent, &detunePercent)) {
-		doDetune = (vibratoPercent.getFloat() != 0.0f) ||
-			   (detunePercent .getFloat() != 0.0f);
+	if (&setting == one_of(&vibratoPercent, &vibratoFrequency,
+	                       &detunePercent,  &detuneFrequency)) {
+		updateDetune();
 	} else {
 		ResampledSoundDevice::update(setting);
 	}
 }
 
+void AY8910::updateDetune()
+{
+	vibratoPerc   = vibratoPercent.getFloat();
+	vibratoPeriod = int(NATIVE_FREQ_FLOAT / vibratoFrequency.getFloat());
+	detunePerc    = detunePercent.getFloat();
+	detunePeriod  = NATIVE_FREQ_FLOAT / detuneFrequency.getFloat();
+	doDetune = (vibratoPerc != 0.0f) || (detunePerc != 0.0f);
+}
+
 
 // Debuggable
 
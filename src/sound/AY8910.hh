@@ -168,6 +168,7 @@ private:
 
 	// Observer<Setting>
 	void update(const Setting& setting) noexcept override;
+	void updateDetune();
 
 	void wrtReg(unsigned reg, uint8_t value, EmuTime time);
 
@@ -192,6 +193,13 @@ private:
 	std::array<uint8_t, 16> regs;
 	const bool isAY8910;
 	const bool ignorePortDirections;
+
+	// Values derived from the vibrato/detune settings. These are needed
+	// once per tone period, so don't read the settings themselves.
+	float vibratoPerc;
+	int vibratoPeriod;
+	float detunePerc;
+	float detunePeriod;
 	bool doDetune;
 };
 
@@ -10,6 +10,12 @@
 #include <array>
 #include <cassert>
 #include <iostream>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 namespace openmsx {
 
@@ -97,20 +103,31 @@ BlipBuffer::BlipBuffer()
 	std::ranges::fill(buffer, 0);
 }
 
-void BlipBuffer::addDelta(TimeIndex time, float delta)
+inline void BlipBuffer::addImpulse(TimeIndex time, float delta)
 {
-	unsigned tmp = time.toInt() + BLIP_IMPULSE_WIDTH;
-	assert(tmp < BUFFER_SIZE);
-	availSamp = std::max(availSamp, narrow<ptrdiff_t>(tmp));
-
 	auto phase = time.fractAsInt();
 	auto ofst = time.toInt() + offset;
 	const float* __restrict impulse = impulses[phase].data();
 	if ((ofst + BLIP_IMPULSE_WIDTH) <= BUFFER_SIZE) [[likely]] {
 		float* __restrict result = &buffer[ofst];
+#if defined(__SSE2__)
+		__m128 d = _mm_set1_ps(delta);
+		for (int i = 0; i < BLIP_IMPULSE_WIDTH; i += 4) {
+			__m128 r = _mm_loadu_ps(result + i);
+			__m128 m = _mm_loadu_ps(impulse + i);
+			_mm_storeu_ps(result + i, _mm_add_ps(r, _mm_mul_ps(m, d)));
+		}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+		for (int i = 0; i < BLIP_IMPULSE_WIDTH; i += 4) {
+			float32x4_t r = vld1q_f32(result + i);
+			float32x4_t m = vld1q_f32(impulse + i);
+			vst1q_f32(result + i, vmlaq_n_f32(r, m, delta));
+		}
+#else
 		for (auto i : xrange(BLIP_IMPULSE_WIDTH)) {
 			result[i] += impulse[i] * delta;
 		}
+#endif
 	} else {
 		for (auto i : xrange(BLIP_IMPULSE_WIDTH)) {
 			buffer[(ofst + i) & BUFFER_MASK] += impulse[i] * delta;
@@ -118,23 +135,87 @@ void BlipBuffer::addDelta(TimeIndex time, float delta)
 	}
 }
 
+void BlipBuffer::addDelta(TimeIndex time, float delta)
+{
+	unsigned tmp = time.toInt() + BLIP_IMPULSE_WIDTH;
+	assert(tmp < BUFFER_SIZE);
+	availSamp = std::max(availSamp, narrow<ptrdiff_t>(tmp));
+
+	addImpulse(time, delta);
+}
+
+void BlipBuffer::addDeltas(std::span<const Delta> deltas)
+{
+	if (deltas.empty()) return;
+	int maxTime = 0;
+	for (const auto& d : deltas) {
+		maxTime = std::max(maxTime, d.time.toInt());
+		addImpulse(d.time, d.delta);
+	}
+	unsigned tmp = maxTime + BLIP_IMPULSE_WIDTH;
+	assert(tmp < BUFFER_SIZE);
+	availSamp = std::max(availSamp, narrow<ptrdiff_t>(tmp));
+}
+
 static constexpr float BASS_FACTOR = 511.0f / 512.0f;
 
+#ifdef __SSE2__
+// Move the elements N positions up, shift in zeros: [a b c d] -> [0 a b c]
+template<int N>
+[[nodiscard]] static inline __m128 shiftUp(__m128 x)
+{
+	return _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), 4 * N));
+}
+#endif
+
 template<size_t PITCH>
 void BlipBuffer::readSamplesHelper(float* __restrict out, size_t samples)
 {
 	assert((offset + samples) <= BUFFER_SIZE);
 	auto acc = accum;
 	auto ofst = offset;
-	for (auto i : xrange(samples)) {
+	size_t i = 0;
+#ifdef __SSE2__
+	// The integrator is a recursive filter:
+	//   out[i] = acc;  acc = acc * BASS_FACTOR + buffer[i];
+	// Unrolled over 4 samples, the 4 outputs are the (decayed) accumulator
+	// plus a decaying prefix sum of the (shifted) input. That prefix sum
+	// takes 2 shift-multiply-add steps, so only the final 'acc' remains a
+	// serial dependency (once per 4 samples instead of once per sample).
+	constexpr float F1 = BASS_FACTOR;
+	constexpr float F2 = F1 * F1;
+	constexpr float F3 = F2 * F1;
+	const __m128 pow1 = _mm_set1_ps(F1);
+	const __m128 pow2 = _mm_set1_ps(F2);
+	const __m128 powAcc = _mm_setr_ps(1.0f, F1, F2, F3);
+	for (/**/; (i + 4) <= samples; i += 4) {
+		float* b = &buffer[ofst + i];
+		__m128 x = _mm_loadu_ps(b);
+		_mm_storeu_ps(b, _mm_setzero_ps());
+		__m128 c = shiftUp<1>(x); // 0, b0, b1, b2
+		c = _mm_add_ps(c, _mm_mul_ps(shiftUp<1>(c), pow1));
+		c = _mm_add_ps(c, _mm_mul_ps(shiftUp<2>(c), pow2));
+		__m128 o = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(acc), powAcc), c);
+		if constexpr (PITCH == 1) {
+			_mm_storeu_ps(&out[i], o);
+		} else {
+			alignas(16) std::array<float, 4> tmp;
+			_mm_store_ps(tmp.data(), o);
+			for (auto j : xrange(4)) out[(i + j) * PITCH] = tmp[j];
+		}
+		float o3 = _mm_cvtss_f32(_mm_shuffle_ps(o, o, _MM_SHUFFLE(3, 3, 3, 3)));
+		float b3 = _mm_cvtss_f32(_mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3)));
+		acc = o3 * F1 + b3;
+	}
+#endif
+	for (/**/; i < samples; ++i) {
 		out[i * PITCH] = acc;
 		acc *= BASS_FACTOR;
-		acc += buffer[ofst];
-		buffer[ofst] = 0.0f;
-		++ofst;
+		acc += buffer[ofst + i];
+		buffer[ofst + i] = 0.0f;
 	}
 	accum = acc;
-	offset = ofst & BUFFER_MASK;
+	offset = (ofst + samples) & BUFFER_MASK;
 }
 
 static bool isSilent(float x)
@@ -9,6 +9,7 @@
 
 #include "FixedPoint.hh"
 #include <array>
+#include <span>
 
 namespace openmsx {
 
@@ -23,15 +24,23 @@ public:
 
 	BlipBuffer();
 
+	struct Delta {
+		TimeIndex time;
+		float delta;
+	};
+
 	// Update amplitude of waveform at given time. Time is in output sample
 	// units and since the last time readSamples() was called.
 	void addDelta(TimeIndex time, float delta);
+	// Same as calling addDelta() for each element, but faster.
+	void addDeltas(std::span<const Delta> deltas);
 
 	// Read the given amount of samples into destination buffer.
 	template<size_t PITCH>
 	bool readSamples(float* out, size_t samples);
 
 private:
+	void addImpulse(TimeIndex time, float delta);
 	template<size_t PITCH>
 	void readSamplesHelper(float* out, size_t samples);
 
@@ -0,0 +1,175 @@
+#include "BufferedSoundDriver.hh"
+
+#include "MSXMixer.hh"
+
+#include "GlobalSettings.hh"
+#include "MSXMotherBoard.hh"
+#include "Reactor.hh"
+#include "RealTime.hh"
+#include "ThrottleManager.hh"
+#include "Timer.hh"
+
+#include "narrow.hh"
+#include "ranges.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace openmsx {
+
+// The output rate deviates at most this much from the input rate.
+static constexpr double MAX_RATE_DEVIATION = 0.005;
+// Weight of a new fill measurement in the (exponential) moving average.
+static constexpr double FILL_SMOOTHING = 1.0 / 32.0;
+
+BufferedSoundDriver::BufferedSoundDriver(Reactor& reactor_)
+	: reactor(reactor_)
+{
+}
+
+void BufferedSoundDriver::allocateBuffer(size_t size)
+{
+	mixBuffer.resize(size);
+	resetBuffer();
+}
+
+void BufferedSoundDriver::resetBuffer()
+{
+	readIdx  = 0;
+	writeIdx = 0;
+	prevSample = {0.0f, 0.0f};
+	resamplePos = 0.0;
+	avgFill = 0.5;
+	rateCorrection = 1.0;
+}
+
+void BufferedSoundDriver::setRateControl(bool enabled)
+{
+	rateControl = enabled;
+	if (!enabled) {
+		resamplePos = 0.0;
+		rateCorrection = 1.0;
+	}
+}
+
+unsigned BufferedSoundDriver::getBuffered() const
+{
+	return getBufferFilled(readIdx.load(std::memory_order_relaxed),
+	                       writeIdx.load(std::memory_order_relaxed));
+}
+
+unsigned BufferedSoundDriver::getBufferFilled(unsigned rdIdx, unsigned wrIdx) const
+{
+	int result = narrow_cast<int>(wrIdx - rdIdx);
+	if (result < 0) result += narrow<int>(mixBuffer.size());
+	assert((0 <= result) && (narrow<unsigned>(result) < mixBuffer.size()));
+	return result;
+}
+
+unsigned BufferedSoundDriver::getBufferFree(unsigned rdIdx, unsigned wrIdx) const
+{
+	// we can't distinguish completely filled from completely empty
+	// (in both cases readIx would be equal to writeIdx), so instead
+	// we define full as '(writeIdx + 1) == readIdx'.
+	auto result = narrow<unsigned>(mixBuffer.size() - 1 - getBufferFilled(rdIdx, wrIdx));
+	assert(narrow_cast<int>(result) >= 0);
+	assert(result < mixBuffer.size());
+	return result;
+}
+
+void BufferedSoundDriver::pull(std::span<StereoFloat> stream)
+{
+	auto len = stream.size();
+
+	// Consumer: the acquire-load of 'writeIdx' makes the samples written
+	// by uploadBuffer() visible, the release-store of 'readIdx' hands the
+	// consumed part of the buffer back to uploadBuffer().
+	unsigned rdIdx = readIdx.load(std::memory_order_relaxed);
+	unsigned wrIdx = writeIdx.load(std::memory_order_acquire);
+	size_t available = getBufferFilled(rdIdx, wrIdx);
+	if (auto num = std::min(len, available);
+	    (rdIdx + num) < mixBuffer.size()) {
+		copy_to_range(mixBuffer.subspan(rdIdx, num), stream);
+		rdIdx += narrow<unsigned>(num);
+	} else {
+		auto len1 = mixBuffer.size() - rdIdx;
+		copy_to_range(mixBuffer.subspan(rdIdx, len1), stream);
+		auto len2 = num - len1;
+		copy_to_range(mixBuffer.first(len2), stream.subspan(len1));
+		rdIdx = narrow<unsigned>(len2);
+	}
+	readIdx.store(rdIdx, std::memory_order_release);
+
+	auto missing = narrow_cast<ptrdiff_t>(len - available);
+	if (missing > 0) {
+		// buffer underrun
+		std::ranges::fill(subspan(stream, available, missing), StereoFloat{});
+		countUnderrun();
+	}
+}
+
+std::span<const StereoFloat> BufferedSoundDriver::adjustRate(std::span<const StereoFloat> buffer)
+{
+	auto fill = double(getBuffered()) / double(mixBuffer.size() - 1);
+	avgFill += (fill - avgFill) * FILL_SMOOTHING;
+	if (!rateControl || buffer.empty()) return buffer;
+
+	// more output samples when the buffer is less than half filled
+	rateCorrection = 1.0 + MAX_RATE_DEVIATION * (1.0 - 2.0 * avgFill);
+	double step = 1.0 / rateCorrection;
+
+	// 'prevSample' is at position 0, buffer[i] at position i+1.
+	auto size = double(buffer.size());
+	resampleBuffer.clear();
+	double pos = resamplePos;
+	while (pos < size) {
+		auto i = size_t(pos);
+		auto f = float(pos - double(i));
+		const auto& a = (i == 0) ? prevSample : buffer[i - 1];
+		const auto& b = buffer[i];
+		resampleBuffer.push_back({.left  = a.left  + f * (b.left  - a.left),
+		                          .right = a.right + f * (b.right - a.right)});
+		pos += step;
+	}
+	resamplePos = pos - size;
+	prevSample = buffer.back();
+	return resampleBuffer;
+}
+
+void BufferedSoundDriver::uploadBuffer(std::span<const StereoFloat> buffer)
+{
+	buffer = adjustRate(buffer);
+
+	// Producer, see pull().
+	unsigned wrIdx = writeIdx.load(std::memory_order_relaxed);
+	unsigned free = getBufferFree(readIdx.load(std::memory_order_acquire), wrIdx);
+	if (buffer.size() > free) {
+		auto* board = reactor.getMotherBoard();
+		if (board && !board->getMSXMixer().isSynchronousMode() && // when not recording
+		    reactor.getGlobalSettings().getThrottleManager().isThrottled()) {
+			do {
+				Timer::sleep(5000); // 5ms
+				board->getRealTime().resync();
+				free = getBufferFree(readIdx.load(std::memory_order_acquire), wrIdx);
+			} while (buffer.size() > free);
+		} else {
+			// drop excess samples
+			buffer = buffer.subspan(0, free);
+			overruns.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	assert(buffer.size() <= free);
+	if ((wrIdx + buffer.size()) < mixBuffer.size()) {
+		copy_to_range(buffer, mixBuffer.subspan(wrIdx));
+		wrIdx += narrow<unsigned>(buffer.size());
+	} else {
+		auto len1 = mixBuffer.size() - wrIdx;
+		copy_to_range(buffer.subspan(0, len1), mixBuffer.subspan(wrIdx));
+		auto len2 = buffer.size() - len1;
+		copy_to_range(buffer.subspan(len1, len2), std::span{mixBuffer});
+		wrIdx = narrow<unsigned>(len2);
+	}
+	writeIdx.store(wrIdx, std::memory_order_release);
+}
+
+} // namespace openmsx
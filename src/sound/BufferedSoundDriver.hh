@@ -0,0 +1,91 @@
+#ifndef BUFFEREDSOUNDDRIVER_HH
+#define BUFFEREDSOUNDDRIVER_HH
+
+#include "SoundDriver.hh"
+
+#include "MemBuffer.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace openmsx {
+
+class Reactor;
+
+/** Base class for the sound drivers where the host audio system pulls the
+  * samples (from its own thread), e.g. via a callback.
+  *
+  * The samples uploaded by the emulation are stored in a ring buffer, from
+  * where they're taken by pull(). When the buffer is full uploadBuffer()
+  * waits (when the emulation is throttled) or drops the excess samples.
+  *
+  * The rate at which the emulation produces samples never exactly matches
+  * the rate of the audio hardware. With rate control enabled the uploaded
+  * samples are resampled (linear interpolation) by a factor within 0.5%
+  * of 1, depending on the (smoothed) fill level of the buffer, so that the
+  * buffer stays about half filled. This avoids underruns and waiting in
+  * uploadBuffer(), also with small buffers. Such a small pitch change is
+  * inaudible.
+  */
+class BufferedSoundDriver : public SoundDriver
+{
+public:
+	void uploadBuffer(std::span<const StereoFloat> buffer) override;
+
+	[[nodiscard]] uint64_t getUnderruns() const override { return underruns; }
+	[[nodiscard]] uint64_t getOverruns() const override { return overruns; }
+
+	void setRateControl(bool enabled) override;
+	[[nodiscard]] double getBufferFill() const override { return avgFill; }
+	[[nodiscard]] double getRateCorrection() const override { return rateCorrection; }
+
+protected:
+	explicit BufferedSoundDriver(Reactor& reactor);
+
+	/** (Re)allocate the ring buffer, it can hold 'size - 1' samples.
+	  * The buffer is empty afterwards. */
+	void allocateBuffer(size_t size);
+
+	/** Empty the buffer. Must not run concurrently with pull() or
+	  * uploadBuffer(). */
+	void resetBuffer();
+
+	/** Number of samples in the buffer, can be called from any thread. */
+	[[nodiscard]] unsigned getBuffered() const;
+
+	/** Fill 'stream' from the buffer. On a buffer underrun the remainder
+	  * is filled with silence. Called from the audio thread. */
+	void pull(std::span<StereoFloat> stream);
+
+	void countUnderrun() { underruns.fetch_add(1, std::memory_order_relaxed); }
+
+private:
+	[[nodiscard]] unsigned getBufferFilled(unsigned readIdx, unsigned writeIdx) const;
+	[[nodiscard]] unsigned getBufferFree(unsigned readIdx, unsigned writeIdx) const;
+	[[nodiscard]] std::span<const StereoFloat> adjustRate(std::span<const StereoFloat> buffer);
+
+private:
+	Reactor& reactor;
+	MemBuffer<StereoFloat> mixBuffer;
+	// 'mixBuffer' is a single-producer (uploadBuffer(), emulation thread),
+	// single-consumer (pull(), audio thread) ring buffer. The producer
+	// only writes 'writeIdx', the consumer only 'readIdx', so no lock is
+	// needed.
+	std::atomic<unsigned> readIdx = 0;
+	std::atomic<unsigned> writeIdx = 0;
+	std::atomic<uint64_t> underruns = 0;
+	std::atomic<uint64_t> overruns = 0;
+
+	// Rate control, only accessed by the producer.
+	std::vector<StereoFloat> resampleBuffer;
+	StereoFloat prevSample = {0.0f, 0.0f};
+	double resamplePos = 0.0; // position of the next output sample
+	double avgFill = 0.5;
+	double rateCorrection = 1.0;
+	bool rateControl = false;
+};
+
+} // namespace openmsx
+
+#endif
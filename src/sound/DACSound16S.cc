@@ -7,9 +7,14 @@
 
 #include "narrow.hh"
 
+#include <algorithm>
+
 namespace openmsx {
 
 static constexpr unsigned DUMMY_INPUT_RATE = 44100; // actual rate depends on frequency setting
+// Normally the queue is flushed once per mixer update, this only limits
+// the memory use in case that doesn't happen for a long time.
+static constexpr size_t MAX_QUEUED_WRITES = 8192;
 
 DACSound16S::DACSound16S(std::string_view name_, static_string_view desc,
                          const DeviceConfig& config)
@@ -39,9 +44,25 @@ void DACSound16S::writeDAC(int16_t value, EmuTime time)
 	if (delta == 0) return;
 	lastWrittenValue = value;
 
-	BlipBuffer::TimeIndex t;
-	getHostSampleClock().getTicksTill(time, t);
-	blip.addDelta(t, narrow<float>(delta));
+	if (writes.size() == MAX_QUEUED_WRITES) [[unlikely]] flushWrites();
+	writes.push_back({time, narrow<float>(delta)});
+}
+
+void DACSound16S::flushWrites()
+{
+	// The host sample clock only advances after the samples are generated,
+	// so it's still the same as when these writes were queued. Except after
+	// the mixer was reinitialized, then (only) move the old writes forward.
+	const auto& clock = getHostSampleClock();
+	auto start = clock.getTime();
+	deltas.clear();
+	for (const auto& w : writes) {
+		BlipBuffer::TimeIndex t;
+		clock.getTicksTill(std::max(w.time, start), t);
+		deltas.push_back({t, w.delta});
+	}
+	blip.addDeltas(deltas);
+	writes.clear();
 }
 
 void DACSound16S::generateChannels(std::span<float*> bufs, unsigned num)
@@ -58,6 +79,7 @@ void DACSound16S::generateChannels(std::span<float*> bufs, unsigned num)
 bool DACSound16S::updateBuffer(size_t length, float* buffer,
                                EmuTime /*time*/)
 {
+	flushWrites();
 	return mixChannels(buffer, length);
 }
 
@@ -6,7 +6,10 @@
 #include "BlipBuffer.hh"
 #include "SoundDevice.hh"
 
+#include "EmuTime.hh"
+
 #include <cstdint>
+#include <vector>
 
 namespace openmsx {
 
@@ -30,8 +33,22 @@ private:
 	bool updateBuffer(size_t length, float* buffer,
 	                  EmuTime time) override;
 
+	void flushWrites();
+
 private:
 	BlipBuffer blip;
+
+	// Writes since the last mixer update, only synthesized (added to
+	// 'blip') right before the samples are generated. Sample players
+	// write the DAC at a high rate, this way the emulation loop only
+	// appends to this vector.
+	struct Write {
+		EmuTime time;
+		float delta;
+	};
+	std::vector<Write> writes;
+	std::vector<BlipBuffer::Delta> deltas; // reused by flushWrites()
+
 	int16_t lastWrittenValue = 0;
 };
 
@@ -4,6 +4,7 @@
 #include "SoundDevice.hh"
 
 #include "AviRecorder.hh"
+#include "FrameHashLogger.hh"
 #include "BooleanSetting.hh"
 #include "CommandException.hh"
 #include "FileOperations.hh"
@@ -13,8 +14,11 @@
 #include "MSXCliComm.hh"
 #include "MSXCommandController.hh"
 #include "MSXMotherBoard.hh"
+#include "PerfMonitor.hh"
+#include "PerfTrace.hh"
 #include "StringSetting.hh"
 #include "TclObject.hh"
+#include "ThreadPool.hh"
 #include "ThrottleManager.hh"
 
 #include "Math.hh"
@@ -30,6 +34,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <memory>
 #include <ranges>
@@ -48,6 +53,7 @@ MSXMixer::MSXMixer(Mixer& mixer_, MSXMotherBoard& motherBoard_,
 	, throttleManager(globalSettings.getThrottleManager())
 	, prevTime(getCurrentTime(), 44100)
 	, soundDeviceInfo(commandController.getMachineInfoCommand())
+	, soundProfileInfo(commandController.getMachineInfoCommand())
 {
 	reschedule2();
 
@@ -61,6 +67,9 @@ MSXMixer::~MSXMixer()
 	if (recorder) {
 		recorder->stop();
 	}
+	if (frameHashLogger) {
+		frameHashLogger->stop();
+	}
 	assert(infos.empty());
 
 	throttleManager.detach(*this);
@@ -148,17 +157,23 @@ void MSXMixer::setSynchronousMode(bool synchronous)
 
 double MSXMixer::getEffectiveSpeed() const
 {
-	return synchronousCounter ? 1.0 : speedManager.getSpeed();
+	return isSynchronousMode() ? 1.0 : speedManager.getSpeed();
 }
 
 void MSXMixer::updateStream(EmuTime time)
 {
+	PerfMonitor::Scope perf(PerfMonitor::Section::MIXER);
+	PerfTrace::Span trace("sound", "fragment", time);
 	unsigned count = prevTime.getTicksTill(time);
 	assert(count <= 8192);
 	inplace_buffer<StereoFloat, 8192> mixBuffer(uninitialized_tag{}, count);
 
 	// call generate() even if count==0 and even if muted
-	generate(mixBuffer, time);
+	if (muteCount && !recorder && !frameHashLogger) {
+		generateMuted(count, time);
+	} else {
+		generate(mixBuffer, time);
+	}
 
 	if (!muteCount && fragmentSize) {
 		mixer.uploadBuffer(*this, mixBuffer);
@@ -167,6 +182,9 @@ void MSXMixer::updateStream(EmuTime time)
 	if (recorder) {
 		recorder->addWave(mixBuffer);
 	}
+	if (frameHashLogger) {
+		frameHashLogger->addWave(mixBuffer);
+	}
 
 	prevTime += count;
 }
@@ -469,9 +487,28 @@ void MSXMixer::generate(std::span<StereoFloat> output, EmuTime time)
 	constexpr unsigned HAS_STEREO_FLAG = 2;
 	unsigned usedBuffers = 0;
 
+	// Optionally first let all devices generate their samples in parallel
+	// (each in its own buffer). The mixing below still happens in the same
+	// order on this thread, so the result is bit-identical to the serial
+	// generation.
+	bool parallel = false;
+	if (auto* pool = mixer.getThreadPool(); pool && (infos.size() > 1)) {
+		generateParallel(*pool, samples, time);
+		parallel = true;
+	}
+	auto updateBuffer = [&](size_t i, float* buffer) {
+		if (!parallel) {
+			return updateDeviceBuffer(infos[i], samples, buffer, time);
+		}
+		if (!parallelResults[i]) return false;
+		auto n = samples * (infos[i].device->isStereo() ? 2 : 1);
+		std::copy_n(parallelBuffers[i].data(), n, buffer);
+		return true;
+	};
+
 	// TODO: The Infos should be ordered such that all the mono
 	// devices are handled first
-	for (auto& info : infos) {
+	for (auto&& [i, info] : enumerate(infos)) {
 		SoundDevice& device = *info.device;
 		auto l1 = info.left1;
 		auto r1 = info.right1;
@@ -482,14 +519,14 @@ void MSXMixer::generate(std::span<StereoFloat> output, EmuTime time)
 				if (!(usedBuffers & HAS_MONO_FLAG)) {
 					// generate in 'monoBuf' (because it was still empty)
 					// then multiply in-place
-					if (device.updateBuffer(samples, monoBufPtr, time)) {
+					if (updateBuffer(i, monoBufPtr)) {
 						usedBuffers |= HAS_MONO_FLAG;
 						mul(monoBuf, l1);
 					}
 				} else {
 					// generate in 'tmpBuf' (as mono data)
 					// then multiply-accumulate into 'monoBuf'
-					if (device.updateBuffer(samples, tmpBufPtr, time)) {
+					if (updateBuffer(i, tmpBufPtr)) {
 						mulAcc(monoBuf, tmpBufMono, l1);
 					}
 				}
@@ -498,14 +535,14 @@ void MSXMixer::generate(std::span<StereoFloat> output, EmuTime time)
 				if (!(usedBuffers & HAS_STEREO_FLAG)) {
 					// 'stereoBuf' (which is still empty) is first filled with mono-data,
 					// then in-place expanded to stereo-data
-					if (device.updateBuffer(samples, stereoBufPtr, time)) {
+					if (updateBuffer(i, stereoBufPtr)) {
 						usedBuffers |= HAS_STEREO_FLAG;
 						mulExpand(stereoBuf, l1, r1);
 					}
 				} else {
 					// 'tmpBuf' is first filled with mono-data,
 					// then expanded to stereo and mul-acc into 'stereoBuf'
-					if (device.updateBuffer(samples, tmpBufPtr, time)) {
+					if (updateBuffer(i, tmpBufPtr)) {
 						mulExpandAcc(stereoBuf, tmpBufMono, l1, r1);
 					}
 				}
@@ -521,14 +558,14 @@ void MSXMixer::generate(std::span<StereoFloat> output, EmuTime time)
 				if (!(usedBuffers & HAS_STEREO_FLAG)) {
 					// generate in 'stereoBuf' (because it was still empty)
 					// then multiply in-place
-					if (device.updateBuffer(samples, stereoBufPtr, time)) {
+					if (updateBuffer(i, stereoBufPtr)) {
 						usedBuffers |= HAS_STEREO_FLAG;
 						mul(stereoBuf, l1);
 					}
 				} else {
 					// generate in 'tmpBuf' (as stereo data)
 					// then multiply-accumulate into 'stereoBuf'
-					if (device.updateBuffer(samples, tmpBufPtr, time)) {
+					if (updateBuffer(i, tmpBufPtr)) {
 						mulAcc(stereoBuf, tmpBufStereo, l1);
 					}
 				}
@@ -538,14 +575,14 @@ void MSXMixer::generate(std::span<StereoFloat> output, EmuTime time)
 				if (!(usedBuffers & HAS_STEREO_FLAG)) {
 					// generate in 'stereoBuf' (because it was still empty)
 					// then mix in-place
-					if (device.updateBuffer(samples, stereoBufPtr, time)) {
+					if (updateBuffer(i, stereoBufPtr)) {
 						usedBuffers |= HAS_STEREO_FLAG;
 						mulMix2(stereoBuf, l1, l2, r1, r2);
 					}
 				} else {
 					// 'tmpBuf' is first filled with stereo-data,
 					// then mixed into stereoBuf
-					if (device.updateBuffer(samples, tmpBufPtr, time)) {
+					if (updateBuffer(i, tmpBufPtr)) {
 						mulMix2Acc(stereoBuf, tmpBufStereo, l1, l2, r1, r2);
 					}
 				}
@@ -592,6 +629,51 @@ void MSXMixer::generate(std::span<StereoFloat> output, EmuTime time)
 	}
 }
 
+// Nobody uses the output (e.g. while fast-forwarding for a reverse seek), but
+// the sound devices must still generate their samples: their state is part of
+// the machine state. Only skip the mixing and the DC removal filter.
+void MSXMixer::generateMuted(size_t samples, EmuTime time)
+{
+	Math::DenormalGuard noDenormals;
+
+	if (auto* pool = mixer.getThreadPool(); pool && (infos.size() > 1) && (samples != 0)) {
+		generateParallel(*pool, samples, time);
+		return;
+	}
+	// +3 for processing in groups of 4, x2 for stereo devices
+	inplace_buffer<float, 2 * (8192 + 3)> buf(uninitialized_tag{}, 2 * (samples + 3));
+	for (auto& info : infos) {
+		bool ignore = updateDeviceBuffer(info, samples, buf.data(), time);
+		(void)ignore;
+	}
+}
+
+bool MSXMixer::updateDeviceBuffer(SoundDeviceInfo& info, size_t samples, float* buffer, EmuTime time)
+{
+	auto start = std::chrono::steady_clock::now();
+	bool result = info.device->updateBuffer(samples, buffer, time);
+	auto stop = std::chrono::steady_clock::now();
+	info.profile.nanoseconds += uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+	info.profile.samples += samples;
+	return result;
+}
+
+void MSXMixer::generateParallel(ThreadPool& pool, size_t samples, EmuTime time)
+{
+	// +3 for processing in groups of 4, x2 for stereo devices
+	static constexpr size_t BUFFER_SIZE = 2 * (8192 + 3);
+	while (parallelBuffers.size() < infos.size()) {
+		parallelBuffers.emplace_back(BUFFER_SIZE);
+	}
+	parallelResults.resize(infos.size());
+
+	pool.parallelFor(infos.size(), [&](size_t i) {
+		Math::DenormalGuard noDenormals; // also in the worker threads
+		parallelResults[i] = updateDeviceBuffer(
+			infos[i], samples, parallelBuffers[i].data(), time);
+	});
+}
+
 bool MSXMixer::needStereoRecording() const
 {
 	return std::ranges::any_of(infos, [](auto& info) {
@@ -656,6 +738,14 @@ void MSXMixer::setRecorder(AviRecorder* newRecorder)
 	recorder = newRecorder;
 }
 
+void MSXMixer::setFrameHashLogger(FrameHashLogger* logger)
+{
+	if ((frameHashLogger != nullptr) != (logger != nullptr)) {
+		setSynchronousMode(logger != nullptr);
+	}
+	frameHashLogger = logger;
+}
+
 void MSXMixer::update(const Setting& setting) noexcept
 {
 	if (&setting == &masterVolume) {
@@ -707,7 +797,7 @@ void MSXMixer::changeMuteSetting(const Setting& setting)
 
 void MSXMixer::update(const SpeedManager& /*speedManager*/) noexcept
 {
-	if (synchronousCounter == 0) {
+	if (!isSynchronousMode()) {
 		setMixerParams(fragmentSize, hostSampleRate);
 	} else {
 		// Avoid calling reInit() while recording because
@@ -856,4 +946,54 @@ void MSXMixer::SoundDeviceInfoTopic::tabCompletion(std::vector<std::string>& tok
 	}
 }
 
+
+
+MSXMixer::SoundProfileInfoTopic::SoundProfileInfoTopic(
+		InfoCommand& machineInfoCommand)
+	: InfoTopic(machineInfoCommand, "sound_profile")
+{
+}
+
+void MSXMixer::SoundProfileInfoTopic::execute(
+	std::span<const TclObject> tokens, TclObject& result) const
+{
+	auto& msxMixer = OUTER(MSXMixer, soundProfileInfo);
+	auto profileDict = [](const SoundDeviceInfo& info) {
+		return makeTclDict("nanoseconds", info.profile.nanoseconds,
+		                   "samples",     info.profile.samples);
+	};
+	switch (tokens.size()) {
+	case 2:
+		for (const auto& info : msxMixer.infos) {
+			result.addDictKeyValue(info.device->getName(), profileDict(info));
+		}
+		break;
+	case 3: {
+		const auto* info = msxMixer.findDeviceInfo(tokens[2].getString());
+		if (!info) {
+			throw CommandException("Unknown sound device");
+		}
+		result = profileDict(*info);
+		break;
+	}
+	default:
+		throw CommandException("Too many parameters");
+	}
+}
+
+std::string MSXMixer::SoundProfileInfoTopic::help(std::span<const TclObject> /*tokens*/) const
+{
+	return "Shows for each sound device the total time (in nanoseconds) "
+	       "spent generating sound and the number of generated samples.\n";
+}
+
+void MSXMixer::SoundProfileInfoTopic::tabCompletion(std::vector<std::string>& tokens) const
+{
+	if (tokens.size() == 3) {
+		completeString(tokens, std::views::transform(
+			OUTER(MSXMixer, soundProfileInfo).infos,
+			[](auto& info) -> std::string_view { return info.device->getName(); }));
+	}
+}
+
 } // namespace openmsx
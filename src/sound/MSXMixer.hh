@@ -7,9 +7,12 @@
 #include "Mixer.hh"
 #include "Schedulable.hh"
 
+#include "MemBuffer.hh"
 #include "Observer.hh"
+#include "aligned.hh"
 #include "dynarray.hh"
 
+#include <cstdint>
 #include <memory>
 #include <span>
 #include <vector>
@@ -28,6 +31,8 @@ class StringSetting;
 class BooleanSetting;
 class Setting;
 class AviRecorder;
+class FrameHashLogger;
+class ThreadPool;
 
 class MSXMixer final : private Schedulable, private Observer<Setting>
                      , private Observer<SpeedManager>
@@ -51,6 +56,14 @@ public:
 		dynarray<ChannelSettings> channelSettings;
 		float defaultVolume = 0.f;
 		float left1 = 0.f, right1 = 0.f, left2 = 0.f, right2 = 0.f;
+
+		// Accumulated wall-clock time spent in (and number of samples
+		// produced by) SoundDevice::updateBuffer(). Only two clock reads
+		// per device per fragment, so this is always enabled.
+		struct Profile {
+			uint64_t nanoseconds = 0;
+			uint64_t samples = 0;
+		} profile;
 	};
 
 public:
@@ -97,11 +110,14 @@ public:
 	 */
 	[[nodiscard]] double getEffectiveSpeed() const;
 
-	/** If we're recording, we want to emulate sound at 100% EmuTime speed.
-	 * See also getEffectiveSpeed().
+	/** If we're recording (or rendering offline, see
+	 * Mixer::isOfflineRender()), we want to emulate sound at 100% EmuTime
+	 * speed. See also getEffectiveSpeed().
 	 */
 	void setSynchronousMode(bool synchronous);
-	[[nodiscard]] bool isSynchronousMode() const { return synchronousCounter != 0; }
+	[[nodiscard]] bool isSynchronousMode() const {
+		return (synchronousCounter != 0) || mixer.isOfflineRender();
+	}
 
 	/** TODO
 	 * This methods (un)mute the sound.
@@ -133,6 +149,9 @@ public:
 	[[nodiscard]] bool needStereoRecording() const;
 	void setRecorder(AviRecorder* recorder);
 
+	// Called by FrameHashLogger
+	void setFrameHashLogger(FrameHashLogger* logger);
+
 	// Returns the nominal host sample rate (not adjusted for speed setting)
 	[[nodiscard]] unsigned getSampleRate() const { return hostSampleRate; }
 
@@ -147,7 +166,10 @@ private:
 	void updateMasterVolume();
 	void reschedule();
 	void reschedule2();
+	static bool updateDeviceBuffer(SoundDeviceInfo& info, size_t samples, float* buffer, EmuTime time);
 	void generate(std::span<StereoFloat> output, EmuTime time);
+	void generateMuted(size_t samples, EmuTime time);
+	void generateParallel(ThreadPool& pool, size_t samples, EmuTime time);
 
 	// Schedulable
 	void executeUntil(EmuTime time) override;
@@ -169,6 +191,11 @@ private:
 
 	std::vector<SoundDeviceInfo> infos;
 
+	// Only used when generating sound in parallel, one entry per device
+	// in 'infos' (same order).
+	std::vector<MemBuffer<float, SSE_ALIGNMENT>> parallelBuffers;
+	std::vector<uint8_t> parallelResults; // result of updateBuffer()
+
 	Mixer& mixer;
 	MSXMotherBoard& motherBoard;
 	MSXCommandController& commandController;
@@ -187,7 +214,16 @@ private:
 		void tabCompletion(std::vector<std::string>& tokens) const override;
 	} soundDeviceInfo;
 
+	struct SoundProfileInfoTopic final : InfoTopic {
+		explicit SoundProfileInfoTopic(InfoCommand& machineInfoCommand);
+		void execute(std::span<const TclObject> tokens,
+			     TclObject& result) const override;
+		[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
+		void tabCompletion(std::vector<std::string>& tokens) const override;
+	} soundProfileInfo;
+
 	AviRecorder* recorder = nullptr;
+	FrameHashLogger* frameHashLogger = nullptr;
 	unsigned synchronousCounter = 0;
 
 	unsigned muteCount = 1; // start muted
@@ -3,17 +3,28 @@
 #include "MSXMixer.hh"
 #include "NullSoundDriver.hh"
 #include "SDLSoundDriver.hh"
+#include "WavSoundDriver.hh"
+#include "components.hh"
+#if COMPONENT_ALSASOUND
+#include "ALSASoundDriver.hh"
+#endif
 
 #include "CliComm.hh"
 #include "CommandController.hh"
+#include "FileOperations.hh"
 #include "MSXException.hh"
+#include "Reactor.hh"
+#include "TclObject.hh"
+#include "ThreadPool.hh"
 
 #include "one_of.hh"
+#include "outer.hh"
 #include "stl.hh"
 #include "unreachable.hh"
 
 #include <cassert>
 #include <memory>
+#include <system_error>
 
 namespace openmsx {
 
@@ -27,7 +38,11 @@ static EnumSetting<Mixer::SoundDriverType>::Map getSoundDriverMap()
 {
 	EnumSetting<Mixer::SoundDriverType>::Map soundDriverMap = {
 		{ "null", Mixer::SoundDriverType::NONE },
-		{ "sdl",  Mixer::SoundDriverType::SDL } };
+		{ "sdl",  Mixer::SoundDriverType::SDL },
+		{ "wav",  Mixer::SoundDriverType::WAV } };
+#if COMPONENT_ALSASOUND
+	soundDriverMap.emplace_back("alsa", Mixer::SoundDriverType::ALSA);
+#endif
 	return soundDriverMap;
 }
 
@@ -38,6 +53,9 @@ Mixer::Mixer(Reactor& reactor_, CommandController& commandController_)
 		commandController, "sound_driver",
 		"select the sound output driver",
 		Mixer::SoundDriverType::SDL, getSoundDriverMap())
+	, wavFileSetting(
+		commandController, "sound_driver_wav_file",
+		"file written by the 'wav' sound driver", "openmsx_sound.wav")
 	, muteSetting(
 		commandController, "mute",
 		"(un)mute the emulation sound", false, Setting::Save::NO)
@@ -50,11 +68,27 @@ Mixer::Mixer(Reactor& reactor_, CommandController& commandController_)
 	, samplesSetting(
 		commandController, "samples",
 		"mixer samples", defaultSamples, 64, 8192)
+	, soundThreadsSetting(
+		commandController, "sound_threads",
+		"number of extra threads to generate the sound of the individual "
+		"sound devices in parallel (0 = generate all on the main thread)",
+		0, 0, 64)
+	, rateControlSetting(
+		commandController, "sound_rate_control",
+		"dynamically adjust the sound output rate (by at most 0.5%) to keep "
+		"the buffer of the sound driver half filled, this avoids buffer "
+		"underruns also with a small 'samples' setting",
+		true)
+	, soundDriverStatsInfo(reactor_.getOpenMSXInfoCommand())
 {
-	muteSetting       .attach(*this);
-	frequencySetting  .attach(*this);
-	samplesSetting    .attach(*this);
-	soundDriverSetting.attach(*this);
+	muteSetting        .attach(*this);
+	frequencySetting   .attach(*this);
+	samplesSetting     .attach(*this);
+	soundDriverSetting .attach(*this);
+	wavFileSetting     .attach(*this);
+	soundThreadsSetting.attach(*this);
+	rateControlSetting .attach(*this);
+	recreateThreadPool();
 
 	// Set correct initial mute state.
 	if (muteSetting.getBoolean()) ++muteCount;
@@ -66,11 +100,15 @@ Mixer::~Mixer()
 {
 	assert(msxMixers.empty());
 	driver.reset();
+	threadPool.reset();
 
-	soundDriverSetting.detach(*this);
-	samplesSetting    .detach(*this);
-	frequencySetting  .detach(*this);
-	muteSetting       .detach(*this);
+	rateControlSetting .detach(*this);
+	soundThreadsSetting.detach(*this);
+	wavFileSetting     .detach(*this);
+	soundDriverSetting .detach(*this);
+	samplesSetting     .detach(*this);
+	frequencySetting   .detach(*this);
+	muteSetting        .detach(*this);
 }
 
 void Mixer::reloadDriver()
@@ -80,6 +118,7 @@ void Mixer::reloadDriver()
 	// for some reason.
 
 	driver = std::make_unique<NullSoundDriver>();
+	offlineRender = false;
 
 	try {
 		switch (soundDriverSetting.getEnum()) {
@@ -89,6 +128,20 @@ void Mixer::reloadDriver()
 				frequencySetting.getInt(),
 				samplesSetting.getInt());
 			break;
+#if COMPONENT_ALSASOUND
+		case SoundDriverType::ALSA:
+			driver = std::make_unique<ALSASoundDriver>(
+				reactor,
+				frequencySetting.getInt(),
+				samplesSetting.getInt());
+			break;
+#endif
+		case SoundDriverType::WAV:
+			driver = std::make_unique<WavSoundDriver>(
+				FileOperations::expandTilde(std::string(wavFileSetting.getString())),
+				frequencySetting.getInt());
+			offlineRender = true;
+			break;
 		default:
 			// nothing, NullSoundDriver already created
 			break;
@@ -96,6 +149,20 @@ void Mixer::reloadDriver()
 	} catch (MSXException& e) {
 		commandController.getCliComm().printWarning(e.getMessage());
 	}
+	driver->setRateControl(rateControlSetting.getBoolean());
+}
+
+void Mixer::recreateThreadPool()
+{
+	threadPool.reset();
+	if (auto n = soundThreadsSetting.getInt(); n > 0) {
+		try {
+			threadPool = std::make_unique<ThreadPool>(n);
+		} catch (std::system_error& e) {
+			commandController.getCliComm().printWarning(
+				"Couldn't create sound threads: ", e.what());
+		}
+	}
 }
 
 void Mixer::registerMixer(MSXMixer& mixer)
@@ -158,6 +225,11 @@ void Mixer::uploadBuffer(MSXMixer& /*msxMixer*/, std::span<const StereoFloat> bu
 	driver->uploadBuffer(buffer);
 }
 
+double Mixer::getOutputLatency() const
+{
+	return driver ? driver->getLatency() : 0.0;
+}
+
 void Mixer::update(const Setting& setting) noexcept
 {
 	if (&setting == &muteSetting) {
@@ -166,12 +238,53 @@ void Mixer::update(const Setting& setting) noexcept
 		} else {
 			unmute();
 		}
+	} else if (&setting == &wavFileSetting) {
+		if (offlineRender) {
+			reloadDriver();
+			muteHelper();
+		}
 	} else if (&setting == one_of(&samplesSetting, &soundDriverSetting, &frequencySetting)) {
 		reloadDriver();
 		muteHelper();
+	} else if (&setting == &soundThreadsSetting) {
+		recreateThreadPool();
+	} else if (&setting == &rateControlSetting) {
+		if (driver) driver->setRateControl(rateControlSetting.getBoolean());
 	} else {
 		UNREACHABLE;
 	}
 }
 
+
+
+// class SoundDriverStatsInfo
+
+Mixer::SoundDriverStatsInfo::SoundDriverStatsInfo(InfoCommand& openMSXInfoCommand)
+	: InfoTopic(openMSXInfoCommand, "sound_driver_stats")
+{
+}
+
+void Mixer::SoundDriverStatsInfo::execute(std::span<const TclObject> /*tokens*/,
+                                          TclObject& result) const
+{
+	const auto& mixer = OUTER(Mixer, soundDriverStatsInfo);
+	const auto* driver = mixer.driver.get();
+	result.addDictKeyValues("underruns", driver ? driver->getUnderruns() : 0,
+	                        "overruns",  driver ? driver->getOverruns()  : 0,
+	                        "latency",   mixer.getOutputLatency() * 1000.0,
+	                        "fill",      driver ? driver->getBufferFill() : 0.0,
+	                        "rate",      driver ? driver->getRateCorrection() : 1.0);
+}
+
+std::string Mixer::SoundDriverStatsInfo::help(std::span<const TclObject> /*tokens*/) const
+{
+	return "Returns a dictionary with the number of buffer underruns and "
+	       "overruns of the current sound driver. Both can cause audible "
+	       "glitches. The counters restart when the sound driver is "
+	       "(re)initialized. 'latency' is the time (in ms) until the sound "
+	       "that's generated now is heard. 'fill' is the average fill level "
+	       "[0..1] of the driver's buffer and 'rate' the current output rate "
+	       "correction (see the 'sound_rate_control' setting).";
+}
+
 } // namespace openmsx
@@ -3,18 +3,23 @@
 
 #include "BooleanSetting.hh"
 #include "EnumSetting.hh"
+#include "FilenameSetting.hh"
+#include "InfoTopic.hh"
 #include "IntegerSetting.hh"
 
 #include "Observer.hh"
 
 #include <cstdint>
 #include <memory>
+#include <span>
+#include <string>
 #include <vector>
 
 namespace openmsx {
 
 class SoundDriver;
 class Reactor;
+class ThreadPool;
 class CommandController;
 class MSXMixer;
 
@@ -28,7 +33,7 @@ struct StereoFloat {
 class Mixer final : private Observer<Setting>
 {
 public:
-	enum class SoundDriverType : uint8_t { NONE, SDL };
+	enum class SoundDriverType : uint8_t { NONE, SDL, ALSA, WAV };
 
 	Mixer(Reactor& reactor, CommandController& commandController);
 	~Mixer();
@@ -58,9 +63,26 @@ public:
 	[[nodiscard]] IntegerSetting& getMasterVolume() { return masterVolume; }
 	[[nodiscard]] BooleanSetting& getMuteSetting() { return muteSetting; }
 
+	/** Worker threads to generate the sound of the individual sound
+	  * devices in parallel. Returns nullptr when sound must be generated
+	  * on the main thread (see 'sound_threads' setting).
+	  */
+	[[nodiscard]] ThreadPool* getThreadPool() { return threadPool.get(); }
+
+	/** Is the sound rendered offline (to a file) instead of being played
+	  * in real time? In that case the MSXMixers always generate sound as
+	  * if the emulation speed is 100%.
+	  */
+	[[nodiscard]] bool isOfflineRender() const { return offlineRender; }
+
+	/** The time, in seconds, until the samples that are uploaded now are
+	  * heard, as reported by the sound driver (see SoundDriver). */
+	[[nodiscard]] double getOutputLatency() const;
+
 private:
 	void reloadDriver();
 	void muteHelper();
+	void recreateThreadPool();
 
 	// Observer<Setting>
 	void update(const Setting& setting) noexcept override;
@@ -69,16 +91,28 @@ private:
 	std::vector<MSXMixer*> msxMixers; // unordered
 
 	std::unique_ptr<SoundDriver> driver;
+	std::unique_ptr<ThreadPool> threadPool;
 	Reactor& reactor;
 	CommandController& commandController;
 
 	EnumSetting<SoundDriverType> soundDriverSetting;
+	FilenameSetting wavFileSetting;
 	BooleanSetting muteSetting;
 	IntegerSetting masterVolume;
 	IntegerSetting frequencySetting;
 	IntegerSetting samplesSetting;
+	IntegerSetting soundThreadsSetting;
+	BooleanSetting rateControlSetting;
+
+	struct SoundDriverStatsInfo final : InfoTopic {
+		explicit SoundDriverStatsInfo(InfoCommand& openMSXInfoCommand);
+		void execute(std::span<const TclObject> tokens,
+			     TclObject& result) const override;
+		[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
+	} soundDriverStatsInfo;
 
 	int muteCount = 0;
+	bool offlineRender = false;
 };
 
 } // namespace openmsx
@@ -53,6 +53,9 @@ bool ResampleBlip<CHANNELS>::generateOutputImpl(float* dataOut, size_t hostNum,
 				assert(emuNum > 0);
 				buf[CHANNELS * emuNum + ch] =
 					buf[CHANNELS * (emuNum - 1) + ch] + 1.0f;
+				// First collect the changes, then add them all to
+				// the BlipBuffer in one go.
+				deltas.clear();
 				FP pos = pos1;
 				auto last = lastInput[ch]; // local var is slightly faster
 				for (unsigned i = 0; /**/; ++i) {
@@ -62,13 +65,12 @@ bool ResampleBlip<CHANNELS>::generateOutputImpl(float* dataOut, size_t hostNum,
 							break;
 						}
 						last = buf[CHANNELS * i + ch];
-						blip[ch].addDelta(
-							BlipBuffer::TimeIndex(pos),
-							delta);
+						deltas.push_back({BlipBuffer::TimeIndex(pos), delta});
 					}
 					pos += step;
 				}
 				lastInput[ch] = last;
+				blip[ch].addDeltas(deltas);
 			}
 		} else {
 			// input all zero
@@ -5,6 +5,7 @@
 #include "ResampleAlgo.hh"
 
 #include <array>
+#include <vector>
 
 namespace openmsx {
 
@@ -27,6 +28,7 @@ private:
 	using FP = FixedPoint<16>;
 	const FP step;
 	std::array<float, CHANNELS> lastInput;
+	std::vector<BlipBuffer::Delta> deltas; // reused between calls
 };
 
 } // namespace openmsx
@@ -19,7 +19,6 @@
 #include "aligned.hh"
 #include "narrow.hh"
 #include "ranges.hh"
-#include "small_buffer.hh"
 #include "stl.hh"
 #include "xrange.hh"
 
@@ -30,10 +29,17 @@
 #include <cmath>
 #include <cstddef>
 #include <iterator>
+#include <mutex>
 #include <vector>
 #ifdef __SSE2__
 #include <emmintrin.h>
 #endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 namespace openmsx {
 
@@ -56,6 +62,9 @@ static constexpr int COEFF_HALF_LEN = COEFF_LEN - 1;
 static constexpr size_t TAB_LEN      = ResampleHQ<1>::TAB_LEN;
 static constexpr size_t HALF_TAB_LEN = ResampleHQ<1>::HALF_TAB_LEN;
 
+// Process-wide, reference counted cache of coefficient tables. Shared by all
+// ResampleHQ instances (of all machines) with the same ratio, the tables don't
+// depend on the number of channels.
 class ResampleCoeffs
 {
 public:
@@ -65,7 +74,7 @@ public:
 	ResampleCoeffs& operator=(ResampleCoeffs&&) = delete;
 
 	static ResampleCoeffs& instance();
-	void getCoeffs(double ratio, std::span<const int16_t, HALF_TAB_LEN>& permute, float*& table, unsigned& filterLen);
+	void getCoeffs(double ratio, std::span<const int16_t, HALF_TAB_LEN>& permute, const float*& table, unsigned& filterLen);
 	void releaseCoeffs(double ratio);
 
 private:
@@ -85,6 +94,7 @@ private:
 		unsigned count;
 	};
 	std::vector<Element> cache; // typically 1-4 entries -> unsorted vector
+	std::mutex mutex; // the tables themselves are immutable once created
 };
 
 ResampleCoeffs::~ResampleCoeffs()
@@ -99,8 +109,9 @@ ResampleCoeffs& ResampleCoeffs::instance()
 }
 
 void ResampleCoeffs::getCoeffs(
-	double ratio, std::span<const int16_t, HALF_TAB_LEN>& permute, float*& table, unsigned& filterLen)
+	double ratio, std::span<const int16_t, HALF_TAB_LEN>& permute, const float*& table, unsigned& filterLen)
 {
+	std::scoped_lock lock(mutex);
 	if (auto it = std::ranges::find(cache, ratio, &Element::ratio);
 	    it != end(cache)) {
 		permute   = std::span<int16_t, HALF_TAB_LEN>{it->permute};
@@ -123,6 +134,7 @@ void ResampleCoeffs::getCoeffs(
 
 void ResampleCoeffs::releaseCoeffs(double ratio)
 {
+	std::scoped_lock lock(mutex);
 	auto it = rfind_unguarded(cache, ratio, &Element::ratio);
 	it->count--;
 	if (it->count == 0) {
@@ -389,6 +401,7 @@ ResampleHQ<CHANNELS>::ResampleHQ(
 	: ResampleAlgo(input_)
 	, hostClock(hostClock_)
 	, ratio(float(hostClock.getPeriod().toDouble() / getEmuClock().getPeriod().toDouble()))
+	, integerRatio(ratio == std::trunc(ratio))
 	, permute(dummyPermute) // Any better way to do this? (that also works with debug-STL)
 {
 	ResampleCoeffs::instance().getCoeffs(double(ratio), permute, table, filterLen);
@@ -542,9 +555,157 @@ static inline void calcSseStereo(const float* buf_, const float* tab_, size_t le
 
 #endif
 
+// The FIR inner loop is selected at compile time: AVX2 (optionally with FMA),
+// SSE2 (x86-64 baseline) or NEON (aarch64 baseline), else the plain c++ code.
+// The vectorized versions sum the terms in a different order, so results may
+// differ in the last bits.
+
+#ifdef __AVX2__
+
+static inline __m256 madd(__m256 a, __m256 b, __m256 c)
+{
+#ifdef __FMA__
+	return _mm256_fmadd_ps(a, b, c);
+#else
+	return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+template<bool REVERSE>
+static inline void calcAvxMono(const float* buf, const float* tab, size_t len, float* out)
+{
+	assert((len % 4) == 0);
+
+	const __m256i rev = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+	auto loadTab8 = [&](size_t i) {
+		return REVERSE ? _mm256_permutevar8x32_ps(_mm256_loadu_ps(tab - i - 8), rev)
+		               : _mm256_loadu_ps(tab + i);
+	};
+
+	__m256 a0 = _mm256_setzero_ps();
+	__m256 a1 = _mm256_setzero_ps();
+	size_t i = 0;
+	for (/**/; (i + 16) <= len; i += 16) {
+		a0 = madd(_mm256_loadu_ps(buf + i + 0), loadTab8(i + 0), a0);
+		a1 = madd(_mm256_loadu_ps(buf + i + 8), loadTab8(i + 8), a1);
+	}
+	if (len & 8) {
+		a0 = madd(_mm256_loadu_ps(buf + i), loadTab8(i), a0);
+		i += 8;
+	}
+	__m256 a8 = _mm256_add_ps(a0, a1);
+	__m128 a = _mm_add_ps(_mm256_castps256_ps128(a8), _mm256_extractf128_ps(a8, 1));
+	if (len & 4) {
+		__m128 t = REVERSE ? reverse(_mm_loadu_ps(tab - i - 4)) : _mm_loadu_ps(tab + i);
+		a = _mm_add_ps(a, _mm_mul_ps(_mm_loadu_ps(buf + i), t));
+	}
+
+	__m128 t = _mm_add_ps(a, _mm_movehl_ps(a, a));
+	__m128 r = _mm_add_ss(t, _mm_shuffle_ps(t, t, 1));
+	_mm_store_ss(out, r);
+}
+
+template<bool REVERSE>
+static inline void calcAvxStereo(const float* buf, const float* tab, size_t len, float* out)
+{
+	assert((len % 4) == 0);
+
+	// Each coefficient is used for both the left and right channel.
+	const __m256i dupLo = REVERSE ? _mm256_setr_epi32(7, 7, 6, 6, 5, 5, 4, 4)
+	                              : _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+	const __m256i dupHi = REVERSE ? _mm256_setr_epi32(3, 3, 2, 2, 1, 1, 0, 0)
+	                              : _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+
+	__m256 a0 = _mm256_setzero_ps();
+	__m256 a1 = _mm256_setzero_ps();
+	size_t i = 0;
+	for (/**/; (i + 8) <= len; i += 8) {
+		__m256 t = _mm256_loadu_ps(REVERSE ? (tab - i - 8) : (tab + i));
+		a0 = madd(_mm256_loadu_ps(buf + 2 * i + 0), _mm256_permutevar8x32_ps(t, dupLo), a0);
+		a1 = madd(_mm256_loadu_ps(buf + 2 * i + 8), _mm256_permutevar8x32_ps(t, dupHi), a1);
+	}
+	if (len & 4) {
+		// only the (lower) 4 elements are used
+		__m256 t = _mm256_castps128_ps256(_mm_loadu_ps(REVERSE ? (tab - i - 4) : (tab + i)));
+		const __m256i dup4 = REVERSE ? _mm256_setr_epi32(3, 3, 2, 2, 1, 1, 0, 0)
+		                             : _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+		a0 = madd(_mm256_loadu_ps(buf + 2 * i), _mm256_permutevar8x32_ps(t, dup4), a0);
+	}
+
+	__m256 a8 = _mm256_add_ps(a0, a1);
+	__m128 a = _mm_add_ps(_mm256_castps256_ps128(a8), _mm256_extractf128_ps(a8, 1));
+	__m128 r = _mm_add_ps(a, _mm_movehl_ps(a, a));
+	_mm_storel_pi(std::bit_cast<__m64*>(out), r);
+}
+
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+
+static inline float32x4_t reverse(float32x4_t x)
+{
+	float32x4_t r = vrev64q_f32(x);
+	return vcombine_f32(vget_high_f32(r), vget_low_f32(r));
+}
+
+template<bool REVERSE>
+static inline float32x4_t loadTab4(const float* tab, size_t i)
+{
+	return REVERSE ? reverse(vld1q_f32(tab - i - 4)) : vld1q_f32(tab + i);
+}
+
+template<bool REVERSE>
+static inline void calcNeonMono(const float* buf, const float* tab, size_t len, float* out)
+{
+	assert((len % 4) == 0);
+
+	float32x4_t a0 = vdupq_n_f32(0.0f);
+	float32x4_t a1 = vdupq_n_f32(0.0f);
+	size_t i = 0;
+	for (/**/; (i + 8) <= len; i += 8) {
+		a0 = vfmaq_f32(a0, vld1q_f32(buf + i + 0), loadTab4<REVERSE>(tab, i + 0));
+		a1 = vfmaq_f32(a1, vld1q_f32(buf + i + 4), loadTab4<REVERSE>(tab, i + 4));
+	}
+	if (len & 4) {
+		a0 = vfmaq_f32(a0, vld1q_f32(buf + i), loadTab4<REVERSE>(tab, i));
+	}
+	*out = vaddvq_f32(vaddq_f32(a0, a1));
+}
+
+template<bool REVERSE>
+static inline void calcNeonStereo(const float* buf, const float* tab, size_t len, float* out)
+{
+	assert((len % 4) == 0);
+
+	float32x4_t a0 = vdupq_n_f32(0.0f);
+	float32x4_t a1 = vdupq_n_f32(0.0f);
+	for (size_t i = 0; i < len; i += 4) {
+		float32x4_t t = loadTab4<REVERSE>(tab, i);
+		a0 = vfmaq_f32(a0, vld1q_f32(buf + 2 * i + 0), vzip1q_f32(t, t));
+		a1 = vfmaq_f32(a1, vld1q_f32(buf + 2 * i + 4), vzip2q_f32(t, t));
+	}
+	float32x4_t a = vaddq_f32(a0, a1);
+	vst1_f32(out, vadd_f32(vget_low_f32(a), vget_high_f32(a)));
+}
+
+#endif
+
+template<unsigned CHANNELS>
+typename ResampleHQ<CHANNELS>::Phase ResampleHQ<CHANNELS>::getPhase(float pos) const
+{
+	auto t = size_t(lrintf(pos * TAB_LEN)) % TAB_LEN;
+	if (!(t & HALF_TAB_LEN)) {
+		// first half, begin of row 't'
+		return {.tab = &table[permute[t] * filterLen], .reverse = false};
+	} else {
+		// 2nd half, end of row 'TAB_LEN - 1 - t'
+		return {.tab = &table[(permute[TAB_LEN - 1 - t] + 1) * filterLen], .reverse = true};
+	}
+}
+
 template<unsigned CHANNELS>
 void ResampleHQ<CHANNELS>::calcOutput(
-	float pos, float* __restrict output)
+	float pos, Phase phase, float* __restrict output)
 {
 	assert((filterLen & 3) == 0);
 
@@ -553,19 +714,29 @@ void ResampleHQ<CHANNELS>::calcOutput(
 	bufIdx *= CHANNELS;
 	const float* buf = &buffer[bufIdx];
 
-	auto t = size_t(lrintf(pos * TAB_LEN)) % TAB_LEN;
-	if (!(t & HALF_TAB_LEN)) {
-		// first half, begin of row 't'
-		t = permute[t];
-		const float* tab = &table[t * filterLen];
-
-#ifdef __SSE2__
+	const float* tab = phase.tab;
+	if (!phase.reverse) {
+#if defined(__AVX2__)
+		if constexpr (CHANNELS == 1) {
+			calcAvxMono  <false>(buf, tab, filterLen, output);
+		} else {
+			calcAvxStereo<false>(buf, tab, filterLen, output);
+		}
+		return;
+#elif defined(__SSE2__)
 		if constexpr (CHANNELS == 1) {
 			calcSseMono  <false>(buf, tab, filterLen, output);
 		} else {
 			calcSseStereo<false>(buf, tab, filterLen, output);
 		}
 		return;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+		if constexpr (CHANNELS == 1) {
+			calcNeonMono  <false>(buf, tab, filterLen, output);
+		} else {
+			calcNeonStereo<false>(buf, tab, filterLen, output);
+		}
+		return;
 #endif
 
 		// c++ version, both mono and stereo
@@ -584,17 +755,27 @@ void ResampleHQ<CHANNELS>::calcOutput(
 			++buf;
 		}
 	} else {
-		// 2nd half, end of row 'TAB_LEN - 1 - t'
-		t = permute[TAB_LEN - 1 - t];
-		const float* tab = &table[(t + 1) * filterLen];
-
-#ifdef __SSE2__
+#if defined(__AVX2__)
+		if constexpr (CHANNELS == 1) {
+			calcAvxMono  <true>(buf, tab, filterLen, output);
+		} else {
+			calcAvxStereo<true>(buf, tab, filterLen, output);
+		}
+		return;
+#elif defined(__SSE2__)
 		if constexpr (CHANNELS == 1) {
 			calcSseMono  <true>(buf, tab, filterLen, output);
 		} else {
 			calcSseStereo<true>(buf, tab, filterLen, output);
 		}
 		return;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+		if constexpr (CHANNELS == 1) {
+			calcNeonMono  <true>(buf, tab, filterLen, output);
+		} else {
+			calcNeonStereo<true>(buf, tab, filterLen, output);
+		}
+		return;
 #endif
 
 		// c++ version, both mono and stereo
@@ -616,11 +797,12 @@ void ResampleHQ<CHANNELS>::calcOutput(
 }
 
 template<unsigned CHANNELS>
-void ResampleHQ<CHANNELS>::prepareData(unsigned emuNum)
+bool ResampleHQ<CHANNELS>::prepareData(unsigned emuNum)
 {
-	// Still enough free space at end of buffer?
-	unsigned free = unsigned(buffer.size() / CHANNELS) - bufEnd;
-	if (free < emuNum) {
+	// Still enough free space at end of buffer? (+3 because generateInput()
+	// may write up to 3 values more than requested)
+	auto needed = [&] { return (bufEnd + emuNum) * size_t(CHANNELS) + 3; };
+	if (buffer.size() < needed()) {
 		// No, then move everything to the start
 		// (data needs to be in a contiguous memory block)
 		unsigned available = bufEnd - bufStart;
@@ -629,9 +811,7 @@ void ResampleHQ<CHANNELS>::prepareData(unsigned emuNum)
 		bufStart = 0;
 		bufEnd = available;
 
-		free = unsigned(buffer.size() / CHANNELS) - bufEnd;
-		auto missing = narrow_cast<int>(emuNum - free);
-		if (missing > 0) [[unlikely]] {
+		if (buffer.size() < needed()) [[unlikely]] {
 			// Still not enough room: grow the buffer.
 			// TODO an alternative is to instead of using a large
 			// buffer, chop the work in multiple smaller pieces.
@@ -639,23 +819,26 @@ void ResampleHQ<CHANNELS>::prepareData(unsigned emuNum)
 			// the CPU's data cache. OTOH too small chunks have
 			// more overhead. (Not yet implemented because it's
 			// more complex).
-			buffer.resize(buffer.size() + missing * size_t(CHANNELS));
+			buffer.resize(needed());
 		}
 	}
-	small_buffer<float, 8192> tmpBufExtra(uninitialized_tag{}, emuNum * CHANNELS + 3); // typical ~5194 (PSG, samples=1024) but could be larger
-	auto tmpBuf = subspan(tmpBufExtra, 0, emuNum * CHANNELS);
-	if (input.generateInput(tmpBufExtra.data(), emuNum)) {
-		copy_to_range(tmpBuf,
-		              subspan(buffer, bufEnd * CHANNELS));
+	auto newData = subspan(buffer, bufEnd * CHANNELS, emuNum * CHANNELS);
+	if (input.generateInput(newData.data(), emuNum)) {
 		bufEnd += emuNum;
 		nonzeroSamples = bufEnd - bufStart;
+	} else if (nonzeroSamples == 0) {
+		// Silent input, and all buffered samples are zero as well.
+		// Appending zeros and dropping the same amount at the front
+		// leaves the buffer as it is, so don't do either.
+		return false;
 	} else {
-		std::ranges::fill(subspan(buffer, bufEnd * CHANNELS, emuNum * CHANNELS), 0);
+		std::ranges::fill(newData, 0);
 		bufEnd += emuNum;
 	}
 
 	assert(bufStart <= bufEnd);
 	assert(bufEnd <= (buffer.size() / CHANNELS));
+	return true;
 }
 
 template<unsigned CHANNELS>
@@ -664,9 +847,7 @@ bool ResampleHQ<CHANNELS>::generateOutputImpl(
 {
 	auto& emuClk = getEmuClock();
 	unsigned emuNum = emuClk.getTicksTill(time);
-	if (emuNum > 0) {
-		prepareData(emuNum);
-	}
+	bool appended = (emuNum > 0) && prepareData(emuNum);
 
 	bool notMuted = nonzeroSamples > 0;
 	if (notMuted) {
@@ -675,13 +856,22 @@ bool ResampleHQ<CHANNELS>::generateOutputImpl(
 		assert(host1 > emuClk.getTime());
 		auto pos = narrow_cast<float>(emuClk.getTicksTillDouble(host1));
 		assert(pos <= (ratio + 2));
-		for (auto i : xrange(hostNum)) {
-			calcOutput(pos, &dataOut[i * CHANNELS]);
-			pos += ratio;
+		if (integerRatio) {
+			// All output samples use the same filter phase.
+			auto phase = getPhase(pos);
+			for (auto i : xrange(hostNum)) {
+				calcOutput(pos, phase, &dataOut[i * CHANNELS]);
+				pos += ratio;
+			}
+		} else {
+			for (auto i : xrange(hostNum)) {
+				calcOutput(pos, getPhase(pos), &dataOut[i * CHANNELS]);
+				pos += ratio;
+			}
 		}
 	}
 	emuClk += emuNum;
-	bufStart += emuNum;
+	if (appended) bufStart += emuNum;
 	nonzeroSamples = std::max<int>(0, nonzeroSamples - emuNum);
 
 	assert(bufStart <= bufEnd);
@@ -30,18 +30,24 @@ public:
 	                        EmuTime time) override;
 
 private:
-	void calcOutput(float pos, float* output);
-	void prepareData(unsigned emuNum);
+	struct Phase {
+		const float* tab; // row in the coefficient table
+		bool reverse;     // traverse that row backwards?
+	};
+	[[nodiscard]] Phase getPhase(float pos) const;
+	void calcOutput(float pos, Phase phase, float* output);
+	[[nodiscard]] bool prepareData(unsigned emuNum);
 
 private:
 	const DynamicClock& hostClock;
 	const float ratio;
+	const bool integerRatio; // e.g. integer decimation: filter phase never changes
 	unsigned bufStart;
 	unsigned bufEnd;
 	unsigned nonzeroSamples = 0;
 	unsigned filterLen;
 	std::vector<float> buffer;
-	float* table;
+	const float* table;
 	std::span<const int16_t, HALF_TAB_LEN> permute;
 };
 
@@ -473,15 +473,29 @@ void SCC::generateChannels(std::span<float*> bufs, unsigned num)
 			unsigned pos2 = pos[i];
 			unsigned incr2 = incr[i];
 			unsigned period2 = period[i] + 1;
-			for (auto j : xrange(num)) {
-				bufs[i][j] += out2;
-				count2 += incr2;
-				// Note: only for very small periods
-				//       this will take more than 1 iteration
-				while (count2 >= period2) [[unlikely]] {
-					count2 -= period2;
-					pos2 = (pos2 + 1) % 32;
-					out2 = volAdjustedWave[i][pos2];
+			float* buf = bufs[i];
+			assert(count2 < period2);
+			if (incr2 == 0) {
+				// frequency too high: output stays constant
+				for (auto j : xrange(num)) buf[j] += out2;
+			} else {
+				// The output only changes once per 'period2 / incr2'
+				// samples (typically many), so emit it in runs of
+				// constant samples.
+				unsigned j = 0;
+				while (j < num) {
+					unsigned run = (period2 - count2 + incr2 - 1) / incr2;
+					unsigned n = std::min(run, num - j);
+					for (auto k : xrange(n)) buf[j + k] += out2;
+					j += n;
+					count2 += n * incr2;
+					// Note: only for very small periods
+					//       this will take more than 1 iteration
+					while (count2 >= period2) {
+						count2 -= period2;
+						pos2 = (pos2 + 1) % 32;
+						out2 = volAdjustedWave[i][pos2];
+					}
 				}
 			}
 			out[i] = out2;
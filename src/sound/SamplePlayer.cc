@@ -6,9 +6,13 @@
 #include "MSXException.hh"
 #include "serialize.hh"
 
+#include "File.hh"
+#include "hash_map.hh"
 #include "narrow.hh"
 #include "xrange.hh"
+#include "xxhash.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 
@@ -16,25 +20,49 @@ namespace openmsx {
 
 static constexpr unsigned DUMMY_INPUT_RATE = 44100; // actual rate depends on .wav files
 
+// Decoded samples are shared by all SamplePlayers (of all machines) that use
+// the same (unmodified) .wav file. So creating a machine (again), or a second
+// instance of the same device, doesn't read and decode the files again.
+// Only accessed from the main thread.
+struct WavCacheEntry {
+	time_t time;
+	std::weak_ptr<const WavData> wav;
+};
+static hash_map<std::string, WavCacheEntry, XXHasher> wavCache;
+
+[[nodiscard]] static std::shared_ptr<const WavData> loadWav(const std::string& filename)
+{
+	File file(filename);
+	auto time = file.getModificationDate();
+	if (auto* entry = lookup(wavCache, filename); entry && (entry->time == time)) {
+		if (auto result = entry->wav.lock()) return result;
+	}
+	auto result = std::make_shared<const WavData>(std::move(file));
+	wavCache.insert_or_assign(filename, WavCacheEntry{time, result});
+	return result;
+}
+
 [[nodiscard]] static auto loadSamples(
 	std::string_view name, const DeviceConfig& config,
 	std::string_view baseName, std::string_view alternativeName,
 	unsigned numSamples)
 {
-	dynarray<WavData> result(numSamples); // initialize with empty WAVs
+	static const auto emptyWav = std::make_shared<const WavData>();
+	dynarray<std::shared_ptr<const WavData>> result(numSamples);
+	std::ranges::fill(result, emptyWav);
 
 	bool alreadyWarned = false;
 	const auto& context = systemFileContext();
 	for (auto i : xrange(numSamples)) {
 		try {
 			auto filename = tmpStrCat(baseName, i, ".wav");
-			result[i] = WavData(context.resolve(filename));
+			result[i] = loadWav(context.resolve(filename));
 		} catch (MSXException& e1) {
 			try {
 				if (alternativeName.empty()) throw;
 				auto filename = tmpStrCat(
 					alternativeName, i, ".wav");
-				result[i] = WavData(context.resolve(filename));
+				result[i] = loadWav(context.resolve(filename));
 			} catch (MSXException& /*e2*/) {
 				if (!alreadyWarned) {
 					alreadyWarned = true;
@@ -83,8 +111,8 @@ void SamplePlayer::play(unsigned sampleNum)
 void SamplePlayer::setWavParams()
 {
 	if ((currentSampleNum < samples.size()) &&
-	    samples[currentSampleNum].getSize()) {
-		const auto& wav = samples[currentSampleNum];
+	    samples[currentSampleNum]->getSize()) {
+		const auto& wav = *samples[currentSampleNum];
 		bufferSize = narrow<unsigned>(wav.getSize());
 
 		unsigned freq = wav.getFreq();
@@ -118,7 +146,7 @@ void SamplePlayer::generateChannels(std::span<float*> bufs, unsigned num)
 		return;
 	}
 
-	const auto& wav = samples[currentSampleNum];
+	const auto& wav = *samples[currentSampleNum];
 	for (auto i : xrange(num)) {
 		if (index >= bufferSize) {
 			if (nextSampleNum != unsigned(-1)) {
@@ -5,6 +5,8 @@
 #include "WavData.hh"
 #include "dynarray.hh"
 
+#include <memory>
+
 namespace openmsx {
 
 class SamplePlayer final : public ResampledSoundDevice
@@ -52,7 +54,9 @@ private:
 	void generateChannels(std::span<float*> bufs, unsigned num) override;
 
 private:
-	const dynarray<WavData> samples;
+	// Shared with other SamplePlayers (also of other machines) that use
+	// the same .wav files, never nullptr.
+	const dynarray<std::shared_ptr<const WavData>> samples;
 
 	unsigned index = 0; // avoid UMR on serialize
 	unsigned bufferSize;
@@ -185,6 +185,14 @@ void SoundDevice::muteChannel(unsigned channel, bool muted)
 	channelMuted[channel] = muted;
 }
 
+bool SoundDevice::isChannelUsed(unsigned channel) const
+{
+	assert(channel < numChannels);
+	return !channelMuted[channel]
+	    || channelBuffers[channel].requestCounter != 0
+	    || writer[channel];
+}
+
 std::span<const float> SoundDevice::getLastBuffer(unsigned channel)
 {
 	assert(channel < numChannels);
@@ -244,6 +244,12 @@ protected:
 	  */
 	[[nodiscard]] bool mixChannels(float* dataOut, size_t samples);
 
+	/** Is the output of the given channel used? It's not when the channel
+	  * is muted and it's also not being recorded or shown in the GUI. Then
+	  * generateChannels() can skip generating that channel (see above).
+	  */
+	[[nodiscard]] bool isChannelUsed(unsigned channel) const;
+
 	/** See MSXMixer::getHostSampleClock(). */
 	[[nodiscard]] const DynamicClock& getHostSampleClock() const;
 	[[nodiscard]] double getEffectiveSpeed() const;
@@ -2,6 +2,7 @@
 #define SOUNDDRIVER_HH
 
 #include "Mixer.hh"
+#include <cstdint>
 #include <span>
 
 namespace openmsx {
@@ -31,6 +32,33 @@ public:
 
 	virtual void uploadBuffer(std::span<const StereoFloat> buffer) = 0;
 
+	/** Number of times the sound output ran out of samples (buffer
+	  * underrun), and the number of times samples had to be dropped
+	  * because the buffer was full (overrun). Both can cause audible
+	  * glitches.
+	  */
+	[[nodiscard]] virtual uint64_t getUnderruns() const { return 0; }
+	[[nodiscard]] virtual uint64_t getOverruns() const { return 0; }
+
+	/** The (estimated) time, in seconds, until a sample that's uploaded
+	  * now is heard: the samples that are still buffered in the driver
+	  * plus the latency of the host audio system.
+	  */
+	[[nodiscard]] virtual double getLatency() const { return 0.0; }
+
+	/** Dynamic rate control: slightly speed up or slow down the output
+	  * to keep the driver's buffer half filled. Only has an effect on
+	  * drivers that buffer the samples.
+	  */
+	virtual void setRateControl(bool /*enabled*/) {}
+
+	/** Average fill level [0..1] of the driver's buffer. */
+	[[nodiscard]] virtual double getBufferFill() const { return 0.0; }
+
+	/** The number of output samples per uploaded sample, see
+	  * setRateControl(). */
+	[[nodiscard]] virtual double getRateCorrection() const { return 1.0; }
+
 protected:
 	SoundDriver() = default;
 };
@@ -11,6 +11,7 @@
 
 #include <array>
 #include <bit>
+#include <cassert>
 #include <cstdint>
 #include <span>
 
@@ -24,6 +25,25 @@ class WavData
 	};
 
 public:
+	/** The header info of a .wav file and a (non-owning) view on its
+	  * still undecoded sample data. */
+	struct Raw {
+		std::span<const uint8_t> data; // interleaved samples of all channels
+		unsigned freq = 0;
+		unsigned bits = 0; // 8 or 16
+		unsigned channels = 0;
+		size_t length = 0; // number of samples (per channel)
+
+		/** Convert the first channel of the samples in range
+		  * [first, first + out.size()) to 16-bit. */
+		template<typename Filter = NoFilter>
+		void convert(size_t first, std::span<int16_t> out, Filter&& filter = {}) const;
+	};
+
+	/** Parse the header of a .wav file (doesn't decode the samples).
+	  * Throws MSXException when the file is not a supported .wav file. */
+	[[nodiscard]] static Raw parse(std::span<const uint8_t> raw);
+
 	/** Construct empty wav. */
 	WavData() = default;
 
@@ -61,11 +81,9 @@ inline const T* WavData::read(std::span<const uint8_t> raw, size_t offset, size_
 	return std::bit_cast<const T*>(raw.data() + offset);
 }
 
-template<typename Filter>
-inline WavData::WavData(File file, Filter filter)
+inline WavData::Raw WavData::parse(std::span<const uint8_t> raw)
 {
 	// Read and check header
-	auto raw = file.mmap<const uint8_t>();
 	struct WavHeader {
 		std::array<char, 4> riffID;
 		Endian::L32 riffSize;
@@ -85,12 +103,13 @@ inline WavData::WavData(File file, Filter filter)
 	    (std::string_view{header->fmtID.data(),    4} != "fmt ")) {
 		throw MSXException("Invalid WAV file.");
 	}
-	unsigned bits = header->wBitsPerSample;
-	if ((header->wFormatTag != 1) || (bits != one_of(8u, 16u))) {
+	Raw result;
+	result.bits = header->wBitsPerSample;
+	if ((header->wFormatTag != 1) || (result.bits != one_of(8u, 16u))) {
 		throw MSXException("WAV format unsupported, must be 8 or 16 bit PCM.");
 	}
-	freq = header->dwSamplesPerSec;
-	unsigned channels = header->wChannels;
+	result.freq = header->dwSamplesPerSec;
+	result.channels = header->wChannels;
 
 	// Skip any extra format bytes
 	size_t pos = 20 + header->fmtSize;
@@ -110,25 +129,47 @@ inline WavData::WavData(File file, Filter filter)
 		pos += dataHeader->chunkSize;
 	}
 
-	// Read and convert sample data
-	size_t length = dataHeader->chunkSize / ((bits / 8) * channels);
-	buffer.resize(length);
-	filter.setFreq(freq);
+	// Check the sample data is present
+	size_t frameSize = (result.bits / 8) * result.channels;
+	result.length = dataHeader->chunkSize / frameSize;
+	size_t dataSize = result.length * frameSize;
+	result.data = std::span{read<uint8_t>(raw, pos, dataSize), dataSize};
+	return result;
+}
+
+template<typename Filter>
+inline void WavData::Raw::convert(size_t first, std::span<int16_t> out, Filter&& filter) const
+{
+	assert(first + out.size() <= length);
 	auto convertLoop = [&](const auto* in, auto convertFunc) {
-		for (auto i : xrange(length)) {
-			buffer[i] = filter(convertFunc(*in));
+		in += first * channels;
+		for (auto& o : out) {
+			o = filter(convertFunc(*in));
 			in += channels; // discard all but the first channel
 		}
 	};
 	if (bits == 8) {
-		convertLoop(read<uint8_t>(raw, pos, length * channels),
+		convertLoop(data.data(),
 		            [](uint8_t u8) { return int16_t((int16_t(u8) - 0x80) << 8); });
 	} else {
-		convertLoop(read<Endian::L16>(raw, pos, length * channels),
+		convertLoop(std::bit_cast<const Endian::L16*>(data.data()),
 		            [](Endian::L16 s16) { return int16_t(s16); });
 	}
 }
 
+template<typename Filter>
+inline WavData::WavData(File file, Filter filter)
+{
+	auto mmap = file.mmap<const uint8_t>();
+	auto raw = parse(mmap);
+	freq = raw.freq;
+
+	// Convert sample data
+	buffer.resize(raw.length);
+	filter.setFreq(freq);
+	raw.convert(0, std::span{buffer.data(), raw.length}, filter);
+}
+
 } // namespace openmsx
 
 #endif
@@ -0,0 +1,36 @@
+#include "WavSoundDriver.hh"
+
+namespace openmsx {
+
+WavSoundDriver::WavSoundDriver(const std::string& filename, unsigned frequency_)
+	: wavWriter(filename, 2, frequency_)
+	, frequency(frequency_)
+{
+}
+
+void WavSoundDriver::mute()
+{
+}
+
+void WavSoundDriver::unmute()
+{
+}
+
+unsigned WavSoundDriver::getFrequency() const
+{
+	return frequency;
+}
+
+unsigned WavSoundDriver::getSamples() const
+{
+	// There's no latency to worry about, so use the largest fragments
+	// MSXMixer can handle, this minimizes the per-fragment overhead.
+	return 8192;
+}
+
+void WavSoundDriver::uploadBuffer(std::span<const StereoFloat> buffer)
+{
+	wavWriter.write(buffer);
+}
+
+} // namespace openmsx
@@ -0,0 +1,37 @@
+#ifndef WAVSOUNDDRIVER_HH
+#define WAVSOUNDDRIVER_HH
+
+#include "SoundDriver.hh"
+#include "WavWriter.hh"
+
+#include <string>
+
+namespace openmsx {
+
+/** Sound driver that doesn't play the sound, but instead writes it to a wav
+  * file. It doesn't depend on (or synchronize with) any audio hardware. So
+  * in combination with 'set throttle off' this renders the sound as fast as
+  * possible, and (because the MSXMixer then always generates sound as-if
+  * the speed is 100%) the result is deterministic.
+  */
+class WavSoundDriver final : public SoundDriver
+{
+public:
+	WavSoundDriver(const std::string& filename, unsigned frequency);
+
+	void mute() override;
+	void unmute() override;
+
+	[[nodiscard]] unsigned getFrequency() const override;
+	[[nodiscard]] unsigned getSamples() const override;
+
+	void uploadBuffer(std::span<const StereoFloat> buffer) override;
+
+private:
+	Wav16Writer wavWriter;
+	unsigned frequency;
+};
+
+} // namespace openmsx
+
+#endif
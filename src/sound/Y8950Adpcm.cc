@@ -112,13 +112,30 @@ void Y8950Adpcm::sync(EmuTime time)
 {
 	if (isPlaying()) { // optimization, also correct without this test
 		unsigned ticks = clock.getTicksTill(time);
-		for (unsigned i = 0; isPlaying() && (i < ticks); ++i) {
+		while (isPlaying() && ticks) {
+			// Most calcSample() calls don't decode a new nibble, they
+			// only interpolate the output. Do all of those (but at
+			// least leave the last tick) in one step.
+			unsigned skip = std::min(ticks, ticksTillNextNibble(emu)) - 1;
+			emu.nowStep += skip * delta;
+			emu.output += narrow<int>(skip) * emu.sampleStep;
 			(void)calcSample(true); // ignore result
+			ticks -= skip + 1;
 		}
 	}
 	clock.advance(time);
 }
 
+unsigned Y8950Adpcm::ticksTillNextNibble(const PlayData& pd) const
+{
+	// The n-th calcSample() call decodes a nibble when 'nowStep + n * delta'
+	// overflows STEP_MASK.
+	static constexpr unsigned STEP_ONE = 1 << STEP_BITS;
+	if (pd.nowStep >= STEP_ONE) return 1;
+	if (delta == 0) return unsigned(-1);
+	return (STEP_ONE - pd.nowStep + delta - 1) / delta;
+}
+
 void Y8950Adpcm::schedule()
 {
 	assert(isPlaying());
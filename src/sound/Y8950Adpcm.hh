@@ -49,6 +49,7 @@ private:
 	void executeUntil(EmuTime time) override;
 
 	void schedule();
+	[[nodiscard]] unsigned ticksTillNextNibble(const PlayData& pd) const;
 	void restart(PlayData& pd) const;
 
 	[[nodiscard]] bool isPlaying() const;
@@ -1039,6 +1039,19 @@ void YM2151::chanCalc(unsigned chan)
 	op[0].mem_value = mem;
 }
 
+bool YM2151::isChannelSilent(unsigned chan) const
+{
+	// When the envelope of all operators is at or below ENV_QUIET (this
+	// is independent of TL and AM, those only attenuate more) and there's
+	// no feedback or delayed (MEM) sample left, then chanCalc() outputs
+	// silence and leaves the channel state unchanged. So it can be skipped.
+	// Note: this does not hold for the noise output of channel 7.
+	auto op = subspan<4>(oper, 4 * chan);
+	return std::ranges::all_of(op, [](auto& o) { return unsigned(o.volume) >= ENV_QUIET; }) &&
+	       (op[0].fb_out_prev == 0) && (op[0].fb_out_curr == 0) &&
+	       (op[0].mem_value == 0);
+}
+
 void YM2151::chan7Calc()
 {
 	m2 = c1 = c2 = mem = 0;
@@ -1510,10 +1523,12 @@ void YM2151::generateChannels(std::span<float*> bufs, unsigned num)
 
 		for (auto j : xrange(8 - 1)) {
 			chanOut[j] = 0;
-			chanCalc(j);
+			if (!isChannelSilent(j)) chanCalc(j);
 		}
 		chanOut[7] = 0;
-		chan7Calc(); // special case for channel 7
+		if ((noise & 0x80) || !isChannelSilent(7)) {
+			chan7Calc(); // special case for channel 7
+		}
 
 		for (auto j : xrange(8)) {
 			bufs[j][2 * i + 0] += narrow_cast<float>(narrow_cast<int>(chanOut[j] & pan[2 * j + 0]));
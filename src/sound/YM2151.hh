@@ -146,6 +146,7 @@ private:
 	// general chip methods
 	void chanCalc(unsigned chan);
 	void chan7Calc();
+	[[nodiscard]] bool isChannelSilent(unsigned chan) const;
 
 	void advanceEG();
 	void advance();
@@ -40,6 +40,7 @@
 #include <algorithm>
 #include <array>
 #include <cstring>
+#include <functional>
 
 namespace openmsx {
 namespace YM2413NukeYKT {
@@ -926,6 +927,8 @@ void YM2413::generateChannels(std::span<float*, 9 + 5> out_, uint32_t n)
 	std::array<float*, 9 + 5> out;
 	copy_to_range(out_, out);
 
+	bool idle = isIdle();
+
 	// Loop here (instead of in step18) seems faster. (why?)
 	if (test_mode_active) [[unlikely]] {
 		repeat(n, [&] { step18<true >(out); });
@@ -933,6 +936,32 @@ void YM2413::generateChannels(std::span<float*, 9 + 5> out_, uint32_t n)
 		repeat(n, [&] { step18<false>(out); });
 	}
 	test_mode_active = testMode;
+
+	if (idle) {
+		// Only zeros were added to the output buffers, so we can just as
+		// well report all channels as silent.
+		std::ranges::fill(out_, nullptr);
+	}
+}
+
+// Returns true when it's guaranteed that the next block of samples only
+// contains zeros (for all channels). That is when all operators are fully
+// released, no key-on is pending and no register write can change that
+// during this block.
+bool YM2413::isIdle() const
+{
+	if (test_mode_active) return false;
+	if (write_fm_cycle != uint8_t(-1)) return false;
+	if (std::ranges::any_of(writes, [](const auto& w) { return w.port != uint8_t(-1); })) return false;
+
+	if (delay6 || delay7 || delay10 || delay11 || delay12) return false;
+	if (std::ranges::any_of(sk_on, [](auto s) { return s & 1; })) return false;
+	if ((rhythm & 0x20) && (rhythm & 0x1f)) return false;
+	if (eg_kon[0] || eg_kon[1]) return false;
+	if (!eg_off[0] || !eg_off[1]) return false;
+	if (std::ranges::any_of(eg_dokon, std::identity{})) return false;
+	if (std::ranges::any_of(eg_state, [](auto s) { return s != EgState::release; })) return false;
+	return std::ranges::all_of(eg_level, [](auto l) { return l == 0x7f; });
 }
 
 template<bool TEST_MODE>
@@ -47,12 +47,14 @@
 *      * Move sub-operations in the pipeline (e.g. to eliminate temporary state)
 *        when this doesn't have an observable effect.
 *      * Lots of small tweak.
-*      * ...
 *
-* TODO:
 * - In openMSX the YM2413 is often silent for large periods of time (e.g. maybe
-*   the emulated MSX program doesn't use the YM2413). Can we easily detect an
-*   idle YM2413 and then bypass large parts of the emulation?
+*   the emulated MSX program doesn't use the YM2413). When at the start of a
+*   block of samples it's certain the whole block will only contain zeros (see
+*   isIdle()), all channels are reported as silent (nullptr). This allows the
+*   mixer/resampler to skip this device. The internal state (phase generators,
+*   LFO, envelope timer, ...) must still be emulated though, so that the output
+*   remains identical once the YM2413 is used again.
 */
 
 #ifndef YM2413NUKEYKT_HH
@@ -203,6 +205,8 @@ private:
 	void doModeWrite(uint8_t address, uint8_t value);
 	void changeFnumBlock(uint32_t ch);
 
+	[[nodiscard]] bool isIdle() const;
+
 private:
 	static const std::array<Patch, 15> m_patches;
 	static const array_with_enum_index<RmNum, Patch> r_patches;
@@ -658,6 +658,16 @@ inline int YMF262::Slot::op_calc(unsigned phase, unsigned lfo_am) const
 	return (p < TL_TAB_LEN) ? tlTab[p] : 0;
 }
 
+// Does this slot produce no output (op_calc() returns 0), and will it remain
+// like that until the next register write? In the OFF state nothing changes,
+// in the RELEASE state the attenuation can only increase.
+inline bool YMF262::Slot::isSilent() const
+{
+	return (state == EnvelopeState::OFF) ||
+	       ((state == EnvelopeState::RELEASE) &&
+	        ((narrow<int>(TLL) + volume) >= ENV_QUIET));
+}
+
 // calculate output of a standard 2 operator channel
 // (or 1st part of a 4-op channel)
 void YMF262::Channel::chan_calc(unsigned lfo_am)
@@ -1487,16 +1497,9 @@ uint8_t YMF262::peekStatus() const
 bool YMF262::checkMuteHelper() const
 {
 	// TODO this doesn't always mute when possible
-	for (const auto& ch : channel) {
-		for (const auto& sl : ch.slot) {
-			if (!((sl.state == EnvelopeState::OFF) ||
-			      ((sl.state == EnvelopeState::RELEASE) &&
-			       ((narrow<int>(sl.TLL) + sl.volume) >= ENV_QUIET)))) {
-				return false;
-			}
-		}
-	}
-	return true;
+	return std::ranges::all_of(channel, [](const auto& ch) {
+		return std::ranges::all_of(ch.slot, &Slot::isSilent);
+	});
 }
 
 void YMF262::setMixLevel(uint8_t x, EmuTime time)
@@ -1533,6 +1536,29 @@ void YMF262::generateChannels(std::span<float*> bufs, unsigned num)
 
 	bool rhythmEnabled = (rhythm & 0x20) != 0;
 
+	// Channels of which all slots are silent for the whole block produce
+	// only zeros, so they don't need to be calculated. The two halves of a
+	// 4op channel are only silent together. Rhythm channels are always
+	// calculated.
+	std::array<bool, 18> silent;
+	for (auto i : xrange(18)) {
+		silent[i] = std::ranges::all_of(channel[i].slot, &Slot::isSilent);
+	}
+	for (int k = 0; k <= 9; k += 9) {
+		for (auto i : xrange(3)) {
+			if (channel[k + i].extended) {
+				bool s = silent[k + i] && silent[k + i + 3];
+				silent[k + i] = silent[k + i + 3] = s;
+			}
+		}
+	}
+	if (rhythmEnabled) {
+		silent[6] = silent[7] = silent[8] = false;
+	}
+	for (auto i : xrange(18)) {
+		if (silent[i]) bufs[i] = nullptr;
+	}
+
 	for (auto j : xrange(num)) {
 		// Amplitude modulation: 27 output levels (triangle waveform);
 		// 1 level takes one of: 192, 256 or 448 samples
@@ -1555,7 +1581,8 @@ void YMF262::generateChannels(std::span<float*> bufs, unsigned num)
 				auto& ch0 = channel[k + i + 0];
 				auto& ch3 = channel[k + i + 3];
 				// extended 4op ch#0 part 1 or 2op ch#0
-				ch0.chan_calc(lfo_am);
+				if (!silent[k + i + 0]) ch0.chan_calc(lfo_am);
+				if (silent[k + i + 3]) continue;
 				if (ch0.extended) {
 					// extended 4op ch#0 part 2
 					ch3.chan_calc_ext(lfo_am);
@@ -1568,20 +1595,21 @@ void YMF262::generateChannels(std::span<float*> bufs, unsigned num)
 
 		// channels 6,7,8 rhythm or 2op mode
 		if (!rhythmEnabled) {
-			channel[6].chan_calc(lfo_am);
-			channel[7].chan_calc(lfo_am);
-			channel[8].chan_calc(lfo_am);
+			if (!silent[6]) channel[6].chan_calc(lfo_am);
+			if (!silent[7]) channel[7].chan_calc(lfo_am);
+			if (!silent[8]) channel[8].chan_calc(lfo_am);
 		} else {
 			// Rhythm part
 			chan_calc_rhythm(lfo_am);
 		}
 
 		// channels 15,16,17 are fixed 2-operator channels only
-		channel[15].chan_calc(lfo_am);
-		channel[16].chan_calc(lfo_am);
-		channel[17].chan_calc(lfo_am);
+		if (!silent[15]) channel[15].chan_calc(lfo_am);
+		if (!silent[16]) channel[16].chan_calc(lfo_am);
+		if (!silent[17]) channel[17].chan_calc(lfo_am);
 
 		for (auto i : xrange(18)) {
+			if (silent[i]) continue;
 			bufs[i][2 * j + 0] += narrow_cast<float>(chanOut[i] & pan[4 * i + 0]);
 			bufs[i][2 * j + 1] += narrow_cast<float>(chanOut[i] & pan[4 * i + 1]);
 			// unused c        += narrow_cast<float>(chanOut[i] & pan[4 * i + 2]);
@@ -1590,6 +1618,18 @@ void YMF262::generateChannels(std::span<float*> bufs, unsigned num)
 
 		advance();
 	}
+
+	// The skipped chan_calc() calls would still have shifted the feedback
+	// history of the modulator (with zeros, because the slot is silent).
+	// The second half of a 4op channel doesn't use that history.
+	for (auto i : xrange(18)) {
+		if (!silent[i] || (num == 0)) continue;
+		bool secondHalf = (i % 9 >= 3) && (i % 9 < 6) && channel[i - 3].extended;
+		if (secondHalf) continue;
+		auto& op1_out = channel[i].slot[MOD].op1_out;
+		op1_out[0] = (num == 1) ? op1_out[1] : 0;
+		op1_out[1] = 0;
+	}
 }
 
 
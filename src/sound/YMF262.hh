@@ -62,6 +62,7 @@ private:
 	public:
 		Slot();
 		[[nodiscard]] int op_calc(unsigned phase, unsigned lfo_am) const;
+		[[nodiscard]] bool isSilent() const;
 		void FM_KEYON(uint8_t key_set);
 		void FM_KEYOFF(uint8_t key_clr);
 		void advanceEnvelopeGenerator(unsigned egCnt);
@@ -40,6 +40,7 @@
 #include "narrow.hh"
 #include "one_of.hh"
 #include "outer.hh"
+#include "ranges.hh"
 #include "xrange.hh"
 
 #include <algorithm>
@@ -800,7 +801,7 @@ YMF278::YMF278(const std::string& name_, size_t ramSize, DeviceConfig& config,
 	, debugRegisters(motherBoard, getName())
 	, debugMemory   (motherBoard, getName())
 	, rom(getName() + " ROM", "rom", config)
-	, ram(config, getName() + " RAM", "YMF278 sample RAM", ramSize)
+	, ram(config, getName() + " RAM", "YMF278 sample RAM", ramSize, 0) // see clearRam()
 	, setupMemPtrs(std::move(setupMemPtrs_))
 {
 	if (rom.size() != 0x200000) { // 2MB
@@ -1070,6 +1071,24 @@ uint8_t YMF278::DebugMemory::read(unsigned address)
 	return ymf278.readMem(address);
 }
 
+void YMF278::DebugMemory::readBlock(unsigned start, std::span<uint8_t> output)
+{
+	// copy per 128kB chunk instead of byte per byte
+	const auto& ymf278 = OUTER(YMF278, debugMemory);
+	while (!output.empty()) {
+		auto offset = start & 0x1'FFFF;
+		auto num = std::min(output.size(), k128 - offset);
+		auto out = output.first(num);
+		if (auto chunk = ymf278.memPtrs[start >> 17].asOptional()) {
+			copy_to_range(chunk->subspan(offset, num), out);
+		} else {
+			std::ranges::fill(out, 0xFF);
+		}
+		start += narrow<unsigned>(num);
+		output = output.subspan(num);
+	}
+}
+
 void YMF278::DebugMemory::write(unsigned address, uint8_t value)
 {
 	auto& ymf278 = OUTER(YMF278, debugMemory);
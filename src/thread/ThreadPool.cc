@@ -0,0 +1,114 @@
+#include "ThreadPool.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <system_error>
+#include <utility>
+
+namespace openmsx {
+
+ThreadPool::ThreadPool(unsigned numWorkers)
+{
+	workers.reserve(numWorkers);
+	for (unsigned i = 0; i < numWorkers; ++i) {
+		workers.emplace_back([this]() { workerLoop(); });
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::scoped_lock lock(mutex);
+		stop = true;
+	}
+	startCond.notify_all();
+	for (auto& t : workers) {
+		t.join();
+	}
+}
+
+void ThreadPool::parallelFor(size_t n, function_ref<void(size_t)> func)
+{
+	if (n == 0) return;
+	if (workers.empty() || (n == 1)) {
+		for (size_t i = 0; i < n; ++i) func(i);
+		return;
+	}
+
+	{
+		std::scoped_lock lock(mutex);
+		assert(!job); // not reentrant
+		job = &func;
+		numParts = n;
+		nextPart = 0;
+		unfinished = n;
+		exception = nullptr;
+		++generation;
+	}
+	startCond.notify_all();
+
+	executeParts(); // also help ourselves
+
+	std::unique_lock lock(mutex);
+	doneCond.wait(lock, [&] { return unfinished == 0; });
+	job = nullptr;
+	if (exception) {
+		std::rethrow_exception(std::exchange(exception, nullptr));
+	}
+}
+
+void ThreadPool::parallelForTemporary(size_t n, function_ref<void(size_t)> func)
+{
+	auto numThreads = std::min(size_t(std::max(1u, std::thread::hardware_concurrency())), n);
+	if (numThreads > 1) {
+		std::optional<ThreadPool> pool;
+		try {
+			pool.emplace(unsigned(numThreads - 1));
+		} catch (std::system_error&) {
+			// fall back to sequential execution
+		}
+		if (pool) {
+			pool->parallelFor(n, func);
+			return;
+		}
+	}
+	for (size_t i = 0; i < n; ++i) func(i);
+}
+
+void ThreadPool::executeParts()
+{
+	std::unique_lock lock(mutex);
+	while (job && (nextPart < numParts)) {
+		size_t part = nextPart++;
+		auto* f = job;
+		lock.unlock();
+		std::exception_ptr e;
+		try {
+			(*f)(part);
+		} catch (...) {
+			e = std::current_exception();
+		}
+		lock.lock();
+		if (e && !exception) exception = e;
+		if (--unfinished == 0) {
+			doneCond.notify_one();
+		}
+	}
+}
+
+void ThreadPool::workerLoop()
+{
+	uint64_t seen = 0;
+	while (true) {
+		{
+			std::unique_lock lock(mutex);
+			startCond.wait(lock, [&] { return stop || (generation != seen); });
+			if (stop) return;
+			seen = generation;
+		}
+		executeParts();
+	}
+}
+
+} // namespace openmsx
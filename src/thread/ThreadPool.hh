@@ -0,0 +1,79 @@
+#ifndef THREADPOOL_HH
+#define THREADPOOL_HH
+
+#include "function_ref.hh"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openmsx {
+
+/** A fixed set of worker threads to execute fork-join style work.
+  *
+  * This is meant for (short) compute bound work that can be split in
+  * independent parts, e.g. generating the sound of each sound chip. The
+  * caller blocks until all parts are done, so the work can safely refer to
+  * data on the caller's stack.
+  */
+class ThreadPool
+{
+public:
+	/** Create a pool with the given number of worker threads. The thread
+	  * calling parallelFor() also executes work, so e.g. with 3 workers up
+	  * to 4 parts are executed concurrently.
+	  */
+	explicit ThreadPool(unsigned numWorkers);
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool(ThreadPool&&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	ThreadPool& operator=(ThreadPool&&) = delete;
+	~ThreadPool();
+
+	[[nodiscard]] unsigned getNumWorkers() const { return unsigned(workers.size()); }
+
+	/** Execute 'func(i)' for all 'i' in [0, n). There's no guarantee
+	  * about the order or about which thread executes which part. Returns
+	  * when all parts are finished. If one or more parts threw an
+	  * exception, one of those exceptions is rethrown (the other parts may
+	  * or may not have been executed).
+	  * Must not be called concurrently or recursively.
+	  */
+	void parallelFor(size_t n, function_ref<void(size_t)> func);
+
+	/** Like parallelFor(), but executed on a temporary pool with (at
+	  * most) one thread per core. Meant for occasional bulk work (e.g.
+	  * (de)compressing the blobs of a savestate) where keeping a pool
+	  * alive isn't worth it. Falls back to sequential execution if the
+	  * threads can't be created.
+	  */
+	static void parallelForTemporary(size_t n, function_ref<void(size_t)> func);
+
+private:
+	void workerLoop();
+	void executeParts();
+
+private:
+	std::vector<std::thread> workers;
+
+	std::mutex mutex;
+	std::condition_variable startCond;
+	std::condition_variable doneCond;
+
+	// The following are protected by 'mutex'.
+	function_ref<void(size_t)>* job = nullptr;
+	size_t numParts = 0;
+	size_t nextPart = 0;
+	size_t unfinished = 0; // parts not yet finished
+	uint64_t generation = 0; // incremented for each parallelFor() call
+	std::exception_ptr exception;
+	bool stop = false;
+};
+
+} // namespace openmsx
+
+#endif
@@ -1,8 +1,16 @@
 #include "Timer.hh"
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
+#ifdef _WIN32
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
 namespace openmsx::Timer {
 
 uint64_t getTime()
@@ -30,4 +38,118 @@ void sleep(uint64_t us)
 	std::this_thread::sleep_for(std::chrono::microseconds(us));
 }
 
+
+// Sleep with the best resolution the platform offers. On Windows the
+// default timer resolution is 15.6ms (unless some application raised it),
+// a high resolution waitable timer (Windows 10 1803 and later) does better.
+// Elsewhere std::this_thread::sleep_for() is already fine-grained.
+static void osSleep(uint64_t us)
+{
+#ifdef _WIN32
+	static HANDLE timer = CreateWaitableTimerExW(
+		nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (timer) {
+		LARGE_INTEGER due;
+		due.QuadPart = -static_cast<LONGLONG>(us * 10); // relative, in 100ns units
+		if (SetWaitableTimerEx(timer, &due, 0, nullptr, nullptr, nullptr, 0)) {
+			WaitForSingleObject(timer, INFINITE);
+			return;
+		}
+	}
+#endif
+	sleep(us);
+}
+
+static constexpr uint64_t MIN_SPIN = 20;   // us
+static constexpr uint64_t MAX_SPIN = 2000; // us, limits the wasted CPU time
+
+namespace {
+	struct SleepState {
+		SleepStats stats;
+		double oversleepEstimate = 0.0; // us, decaying maximum
+		bool calibrated = false;
+	};
+}
+
+static SleepState& getSleepState()
+{
+	static SleepState state;
+	return state;
+}
+
+// Measure how much a short sleep typically oversleeps on this host.
+static void calibrate(SleepState& state)
+{
+	static constexpr uint64_t REQUEST = 1000; // us
+	std::array<uint64_t, 8> over;
+	for (auto& o : over) {
+		auto start = getTime();
+		osSleep(REQUEST);
+		auto slept = getTime() - start;
+		o = (slept > REQUEST) ? (slept - REQUEST) : 0;
+	}
+	std::ranges::sort(over);
+	state.stats.calibration = over[over.size() * 3 / 4]; // ignore outliers
+	state.oversleepEstimate = double(state.stats.calibration);
+	state.calibrated = true;
+}
+
+static void addToHistogram(SleepStats::Histogram& histogram, uint64_t& max, uint64_t value)
+{
+	auto it = std::ranges::upper_bound(SleepStats::BUCKET_LIMITS, value);
+	++histogram[std::distance(SleepStats::BUCKET_LIMITS.begin(), it)];
+	max = std::max(max, value);
+}
+
+uint64_t sleepUntil(uint64_t target)
+{
+	auto& state = getSleepState();
+	auto& stats = state.stats;
+	if (!state.calibrated) [[unlikely]] calibrate(state);
+
+	auto margin = std::clamp(uint64_t(state.oversleepEstimate * 1.25) + MIN_SPIN,
+	                         MIN_SPIN, MAX_SPIN);
+	stats.spinMargin = margin;
+
+	auto now = getTime();
+	if (now + margin < target) {
+		auto wakeup = target - margin;
+		osSleep(wakeup - now);
+		now = getTime();
+		if (now >= wakeup) {
+			auto over = now - wakeup;
+			addToHistogram(stats.oversleep, stats.maxOversleep, over);
+			// Quickly follow an increase, slowly decay afterwards.
+			state.oversleepEstimate = std::max(double(over), state.oversleepEstimate * 0.98);
+		} else {
+			addToHistogram(stats.undersleep, stats.maxUndersleep, wakeup - now);
+		}
+	}
+
+	auto spinStart = now;
+	while (now < target) {
+		std::this_thread::yield();
+		now = getTime();
+	}
+	stats.spinTime += now - spinStart;
+	addToHistogram(stats.late, stats.maxLate, now - target);
+	++stats.count;
+	return now;
+}
+
+const SleepStats& getSleepStats()
+{
+	return getSleepState().stats;
+}
+
+void resetSleepStats()
+{
+	auto& stats = getSleepState().stats;
+	auto margin = stats.spinMargin;
+	auto calibration = stats.calibration;
+	stats = SleepStats{};
+	stats.spinMargin = margin;
+	stats.calibration = calibration;
+}
+
 } // namespace openmsx::Timer
@@ -1,6 +1,7 @@
 #ifndef TIMER_HH
 #define TIMER_HH
 
+#include <array>
 #include <cstdint>
 
 namespace openmsx::Timer {
@@ -14,6 +15,42 @@ namespace openmsx::Timer {
 	  */
 	void sleep(uint64_t us);
 
+	/** Sleep until the given point in time (as returned by getTime()).
+	  * Unlike sleep(), this aims to wake up exactly on time: it sleeps
+	  * until shortly before the target and then spins for the remainder.
+	  * The spin margin adapts to the observed oversleep of the OS sleep
+	  * (initially it's the result of a short calibration, done on the
+	  * first call). Only call this from one thread.
+	  * @result The time at which this method returned.
+	  */
+	uint64_t sleepUntil(uint64_t target);
+
+	/** Statistics of sleepUntil(). 'oversleep' and 'undersleep' is how
+	  * much later or earlier than requested the OS sleep woke up (the
+	  * jitter of the host). 'late' is how much later than the target
+	  * sleepUntil() returned (after spinning).
+	  */
+	struct SleepStats {
+		// bucket i counts the errors below BUCKET_LIMITS[i] (and not in
+		// a lower bucket), the last bucket counts the remaining ones
+		static constexpr std::array<uint64_t, 9> BUCKET_LIMITS = { // us
+			10, 25, 50, 100, 250, 500, 1000, 2500, 5000};
+		using Histogram = std::array<uint32_t, BUCKET_LIMITS.size() + 1>;
+
+		Histogram oversleep = {};
+		Histogram undersleep = {};
+		Histogram late = {};
+		uint64_t maxOversleep = 0;  // us
+		uint64_t maxUndersleep = 0; // us
+		uint64_t maxLate = 0;       // us
+		uint64_t spinMargin = 0;    // us, current value
+		uint64_t calibration = 0;   // us, oversleep measured by calibration
+		uint64_t spinTime = 0;      // us, total
+		uint32_t count = 0;
+	};
+	[[nodiscard]] const SleepStats& getSleepStats();
+	void resetSleepStats();
+
 } // namespace openmsx::Timer
 
 #endif
@@ -0,0 +1,50 @@
+#include "catch.hpp"
+#include "AsyncSender.hh"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+using namespace openmsx;
+
+TEST_CASE("AsyncSender")
+{
+	std::vector<std::vector<uint8_t>> received; // only touched by the helper thread
+	size_t batches = 0;
+	bool emptyBatch = false;
+	{
+		AsyncSender sender([&](const AsyncSender::Batch& batch) {
+			emptyBatch |= batch.empty(); // CHECK() is not thread-safe
+			++batches;
+			batch.forEachMessage([&](std::span<const uint8_t> message) {
+				received.emplace_back(message.begin(), message.end());
+			});
+		});
+
+		for (uint8_t i = 0; i < 100; ++i) {
+			std::array<uint8_t, 3> message = {i, uint8_t(i + 1), uint8_t(i + 2)};
+			CHECK(sender.send(std::span{message}.first(1 + i % 3)));
+		}
+		sender.flush();
+		CHECK(received.size() == 100);
+
+		CHECK(sender.send(std::array<uint8_t, 1>{200}));
+		CHECK(sender.send(std::span<const uint8_t>{})); // ignored
+
+		std::vector<uint8_t> huge(AsyncSender::MAX_QUEUED + 1);
+		CHECK(!sender.send(huge));
+	} // destructor drains the queue
+
+	REQUIRE(received.size() == 101);
+	CHECK(!emptyBatch);
+	CHECK(batches >= 1);
+	CHECK(batches <= 101);
+	for (uint8_t i = 0; i < 100; ++i) {
+		const auto& message = received[i];
+		REQUIRE(message.size() == size_t(1 + i % 3));
+		for (size_t j = 0; j < message.size(); ++j) {
+			CHECK(message[j] == uint8_t(i + j));
+		}
+	}
+	CHECK(received[100] == std::vector<uint8_t>{200});
+}
@@ -4,6 +4,8 @@
 
 #include <algorithm>
 #include <bit>
+#include <span>
+#include <vector>
 
 static void test_decode(const std::string& encoded, const std::string& decoded)
 {
@@ -50,3 +52,39 @@ TEST_CASE("Base64")
 	test_decode("MDEyMzQ1Njc4OUFCQ0RFRkdISUpLTE1OT1BRUlNUVVZXWFlaYWJjZGVmZ2hpamtsbW5vcHFyc3R1dnd4eXoK",
 	            "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz\n");
 }
+
+TEST_CASE("Base64: round trip")
+{
+	// Covers the (optional) SIMD code paths and the transitions between
+	// those and the scalar code (line ends, padding, end of buffer).
+	std::vector<uint8_t> data(1000);
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = uint8_t(i * 167 + (i >> 3));
+	}
+	for (size_t len = 0; len < data.size(); len += (len < 130) ? 1 : 37) {
+		auto input = std::span{data}.first(len);
+		auto encoded = Base64::encode(input);
+
+		auto decoded = Base64::decode(encoded);
+		REQUIRE(decoded.size() == len);
+		CHECK(std::ranges::equal(std::span{decoded}, input));
+
+		// Whitespace at arbitrary positions is ignored.
+		std::string spaced;
+		for (size_t i = 0; i < encoded.size(); ++i) {
+			if ((i % 13) == 5) spaced += ' ';
+			spaced += encoded[i];
+		}
+		std::vector<uint8_t> out(len);
+		CHECK(Base64::decode_inplace(spaced, out));
+		CHECK(std::ranges::equal(out, input));
+
+		// Wrong output size.
+		std::vector<uint8_t> tooBig(len + 1);
+		CHECK(!Base64::decode_inplace(encoded, tooBig));
+		if (len > 0) {
+			std::vector<uint8_t> tooSmall(len - 1);
+			CHECK(!Base64::decode_inplace(encoded, tooSmall));
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#include "catch.hpp"
+#include "BinaryCliCommParser.hh"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static string u32(uint32_t x)
+{
+	return {char(x >> 0), char(x >> 8), char(x >> 16), char(x >> 24)};
+}
+
+static string message(const vector<string>& commands)
+{
+	string msg;
+	for (const auto& c : commands) msg += u32(uint32_t(c.size())) + c;
+	return u32(uint32_t(msg.size())) + msg;
+}
+
+TEST_CASE("BinaryCliCommParser")
+{
+	vector<string> result;
+	BinaryCliCommParser parser([&](const string& cmd) { result.push_back(cmd); });
+
+	SECTION("single command") {
+		parser.parse(message({"foo"}));
+		CHECK(result == vector<string>{"foo"});
+	}
+	SECTION("batched commands") {
+		parser.parse(message({"foo", "", "bar baz"}));
+		CHECK(result == vector<string>{"foo", "", "bar baz"});
+	}
+	SECTION("multiple messages") {
+		parser.parse(message({"foo"}) + message({"bar"}));
+		CHECK(result == vector<string>{"foo", "bar"});
+	}
+	SECTION("split in arbitrary pieces") {
+		auto stream = message({"foo", "bar"}) + message({string("a\0<b>", 5)});
+		for (auto c : stream) parser.parse(span{&c, 1});
+		CHECK(result == vector<string>{"foo", "bar", string("a\0<b>", 5)});
+	}
+	SECTION("incomplete message") {
+		auto stream = message({"foo"});
+		parser.parse(span{stream}.first(stream.size() - 1));
+		CHECK(result.empty());
+		parser.parse(span{stream}.last(1));
+		CHECK(result == vector<string>{"foo"});
+	}
+	SECTION("malformed message") {
+		// The command claims to be larger than the message, the rest of
+		// this message is dropped, the next message is still parsed.
+		auto bad = u32(7) + u32(10) + "foo";
+		parser.parse(bad + message({"bar"}));
+		CHECK(result == vector<string>{"bar"});
+	}
+}
@@ -0,0 +1,135 @@
+#include "catch.hpp"
+#include "BitmapConverter.hh"
+
+#include "narrow.hh"
+#include "xrange.hh"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace openmsx;
+using Pixel = BitmapConverter::Pixel;
+
+// Straightforward scalar implementations, BitmapConverter (which may use
+// vectorized routines) must give identical results.
+struct Reference
+{
+	std::span<const Pixel, 16 * 2> palette16;
+	std::span<const Pixel, 256>    palette256;
+	std::span<const Pixel, 32768>  palette32768;
+
+	[[nodiscard]] static int clamp(int x) { return std::clamp(x, 0, 31); }
+
+	[[nodiscard]] Pixel yjk(int y, int j, int k) const {
+		int r = clamp(y + j);
+		int g = clamp(y + k);
+		int b = clamp((5 * y - 2 * j - k + 2) / 4);
+		return palette32768[(r << 10) + (g << 5) + b];
+	}
+
+	void graphic4(std::span<Pixel> out, std::span<const uint8_t, 128> v0) const {
+		for (auto i : xrange(128)) {
+			out[2 * i + 0] = palette16[v0[i] >> 4];
+			out[2 * i + 1] = palette16[v0[i] & 15];
+		}
+	}
+	void graphic5(std::span<Pixel> out, std::span<const uint8_t, 128> v0) const {
+		for (auto i : xrange(128)) {
+			out[4 * i + 0] = palette16[ 0 +  (v0[i] >> 6)     ];
+			out[4 * i + 1] = palette16[16 + ((v0[i] >> 4) & 3)];
+			out[4 * i + 2] = palette16[ 0 + ((v0[i] >> 2) & 3)];
+			out[4 * i + 3] = palette16[16 + ((v0[i] >> 0) & 3)];
+		}
+	}
+	void graphic6(std::span<Pixel> out, std::span<const uint8_t, 128> v0, std::span<const uint8_t, 128> v1) const {
+		for (auto i : xrange(128)) {
+			out[4 * i + 0] = palette16[v0[i] >> 4];
+			out[4 * i + 1] = palette16[v0[i] & 15];
+			out[4 * i + 2] = palette16[v1[i] >> 4];
+			out[4 * i + 3] = palette16[v1[i] & 15];
+		}
+	}
+	void graphic7(std::span<Pixel> out, std::span<const uint8_t, 128> v0, std::span<const uint8_t, 128> v1) const {
+		for (auto i : xrange(128)) {
+			out[2 * i + 0] = palette256[v0[i]];
+			out[2 * i + 1] = palette256[v1[i]];
+		}
+	}
+	void yjkyae(std::span<Pixel> out, std::span<const uint8_t, 128> v0, std::span<const uint8_t, 128> v1, bool yae) const {
+		for (auto i : xrange(64)) {
+			std::array<int, 4> p = {v0[2 * i], v1[2 * i], v0[2 * i + 1], v1[2 * i + 1]};
+			int j = (p[2] & 7) + ((p[3] & 3) << 3) - ((p[3] & 4) << 3);
+			int k = (p[0] & 7) + ((p[1] & 3) << 3) - ((p[1] & 4) << 3);
+			for (auto n : xrange(4)) {
+				out[4 * i + n] = (yae && (p[n] & 8)) ? palette16[p[n] >> 4]
+				                                     : yjk(p[n] >> 3, j, k);
+			}
+		}
+	}
+};
+
+TEST_CASE("BitmapConverter")
+{
+	std::mt19937 gen(1234);
+	// Random palette entries, so that a wrong index is (almost surely) detected.
+	std::array<Pixel, 16 * 2> palette16;
+	std::array<Pixel, 256>    palette256;
+	std::vector<Pixel>        palette32768(32768);
+	auto randomize = [&] {
+		for (auto& p : palette16)    p = Pixel(gen());
+		for (auto& p : palette256)   p = Pixel(gen());
+		for (auto& p : palette32768) p = Pixel(gen());
+	};
+	randomize();
+	std::span<const Pixel, 32768> pal32k{palette32768.data(), 32768};
+	BitmapConverter converter(palette16, palette256, pal32k);
+	Reference ref{palette16, palette256, pal32k};
+
+	std::array<uint8_t, 128> v0, v1;
+	std::array<Pixel, 512 + 1> out, expected;
+
+	auto check = [&](uint8_t mode, bool planar) {
+		// Marker after the used pixels, it must not be overwritten.
+		out.fill(0x12345678);
+		expected.fill(0x12345678);
+		// bitmap modes: M5..M3 in reg0, YAE and YJK in reg25
+		converter.setDisplayMode(DisplayMode(
+			uint8_t((mode & 0x1C) >> 1), 0, uint8_t((mode & 0x60) >> 2)));
+		if (planar) {
+			converter.convertLinePlanar(out, v0, v1);
+		} else {
+			converter.convertLine(out, v0);
+		}
+		switch (mode) {
+		case DisplayMode::GRAPHIC4: ref.graphic4(expected, v0); break;
+		case DisplayMode::GRAPHIC5: ref.graphic5(expected, v0); break;
+		case DisplayMode::GRAPHIC6: ref.graphic6(expected, v0, v1); break;
+		case DisplayMode::GRAPHIC7: ref.graphic7(expected, v0, v1); break;
+		case DisplayMode::GRAPHIC7 | DisplayMode::YJK: ref.yjkyae(expected, v0, v1, false); break;
+		case DisplayMode::GRAPHIC7 | DisplayMode::YJK | DisplayMode::YAE: ref.yjkyae(expected, v0, v1, true); break;
+		}
+		CHECK(out == expected);
+	};
+
+	for (auto iter : xrange(100)) {
+		std::ranges::generate(v0, [&] { return narrow_cast<uint8_t>(gen()); });
+		std::ranges::generate(v1, [&] { return narrow_cast<uint8_t>(gen()); });
+		if (iter == 1) { v0.fill(0x00); v1.fill(0x00); }
+		if (iter == 2) { v0.fill(0xFF); v1.fill(0xFF); }
+		if (iter == 3) { v0.fill(0xF8); v1.fill(0x04); } // k,j = -32 (minimum)
+		if (iter == 4) { v0.fill(0xFF); v1.fill(0xFB); } // k,j = +31 (maximum)
+		if (iter == 50) {
+			randomize();
+			converter.palette16Changed();
+		}
+		check(DisplayMode::GRAPHIC4, false);
+		check(DisplayMode::GRAPHIC5, false);
+		check(DisplayMode::GRAPHIC6, true);
+		check(DisplayMode::GRAPHIC7, true);
+		check(DisplayMode::GRAPHIC7 | DisplayMode::YJK, true);
+		check(DisplayMode::GRAPHIC7 | DisplayMode::YJK | DisplayMode::YAE, true);
+	}
+}
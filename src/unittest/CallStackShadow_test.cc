@@ -0,0 +1,55 @@
+#include "catch.hpp"
+#include "CallStackShadow.hh"
+
+#include <vector>
+
+using namespace openmsx;
+
+static std::vector<uint16_t> targets(const CallStackShadow& stack)
+{
+	std::vector<uint16_t> result;
+	for (const auto& frame : stack.getFrames()) result.push_back(frame.target);
+	return result;
+}
+
+TEST_CASE("CallStackShadow")
+{
+	CallStackShadow stack;
+	CHECK(stack.getFrames().empty());
+
+	// nested calls
+	stack.call(0x4000, 0xF000);
+	stack.call(0x4100, 0xEFFE);
+	stack.call(0x4200, 0xEFFC);
+	CHECK(targets(stack) == std::vector<uint16_t>{0x4000, 0x4100, 0x4200});
+
+	// SP below the deepest frame (e.g. PUSH): nothing changes
+	stack.unwind(0xEFFA);
+	CHECK(targets(stack) == std::vector<uint16_t>{0x4000, 0x4100, 0x4200});
+
+	// RET from the deepest routine
+	stack.unwind(0xEFFE);
+	CHECK(targets(stack) == std::vector<uint16_t>{0x4000, 0x4100});
+
+	// the next call at the same depth replaces the previous one
+	stack.call(0x4300, 0xEFFC);
+	CHECK(targets(stack) == std::vector<uint16_t>{0x4000, 0x4100, 0x4300});
+
+	// a call at a higher stack position drops all deeper frames (the
+	// returns in between were never observed)
+	stack.call(0x4400, 0xEFFE);
+	CHECK(targets(stack) == std::vector<uint16_t>{0x4000, 0x4400});
+
+	// SP reloaded far above everything
+	stack.unwind(0xF100);
+	CHECK(stack.getFrames().empty());
+
+	// depth is limited
+	for (unsigned i = 0; i < CallStackShadow::MAX_DEPTH + 10; ++i) {
+		stack.call(uint16_t(i), uint16_t(0xF000 - 2 * i));
+	}
+	CHECK(stack.getFrames().size() == CallStackShadow::MAX_DEPTH);
+
+	stack.clear();
+	CHECK(stack.getFrames().empty());
+}
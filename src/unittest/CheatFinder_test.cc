@@ -0,0 +1,145 @@
+#include "catch.hpp"
+#include "CheatFinder.hh"
+
+#include "Debuggable.hh"
+
+#include "xrange.hh"
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+using namespace openmsx;
+
+namespace {
+
+struct FakeMemory final : Debuggable
+{
+	explicit FakeMemory(unsigned size) : data(size) {}
+	[[nodiscard]] unsigned getSize() const override { return unsigned(data.size()); }
+	[[nodiscard]] std::string_view getDescription() const override { return "fake"; }
+	[[nodiscard]] uint8_t read(unsigned address) override { ++numReads; return data[address]; }
+	void write(unsigned address, uint8_t value) override { data[address] = value; }
+
+	std::vector<uint8_t> data;
+	size_t numReads = 0;
+};
+
+}
+
+[[nodiscard]] static bool refCompare(CheatFinder::Compare op, uint8_t a, uint8_t b)
+{
+	using enum CheatFinder::Compare;
+	switch (op) {
+		case EQUAL:         return a == b;
+		case NOT_EQUAL:     return a != b;
+		case LESS:          return a <  b;
+		case LESS_EQUAL:    return a <= b;
+		case GREATER:       return a >  b;
+		case GREATER_EQUAL: return a >= b;
+	}
+	return false;
+}
+
+static constexpr std::array allOps = {
+	CheatFinder::Compare::EQUAL, CheatFinder::Compare::NOT_EQUAL,
+	CheatFinder::Compare::LESS, CheatFinder::Compare::LESS_EQUAL,
+	CheatFinder::Compare::GREATER, CheatFinder::Compare::GREATER_EQUAL,
+};
+
+TEST_CASE("CheatFinder: parseCompare")
+{
+	CHECK(CheatFinder::parseCompare("==") == CheatFinder::Compare::EQUAL);
+	CHECK(CheatFinder::parseCompare("!=") == CheatFinder::Compare::NOT_EQUAL);
+	CHECK(CheatFinder::parseCompare("<")  == CheatFinder::Compare::LESS);
+	CHECK(CheatFinder::parseCompare("<=") == CheatFinder::Compare::LESS_EQUAL);
+	CHECK(CheatFinder::parseCompare(">")  == CheatFinder::Compare::GREATER);
+	CHECK(CheatFinder::parseCompare(">=") == CheatFinder::Compare::GREATER_EQUAL);
+	CHECK(!CheatFinder::parseCompare("="));
+}
+
+TEST_CASE("CheatFinder: compare64")
+{
+	// include the extremes, those are tricky for signed SIMD compares
+	std::array<uint8_t, 64> a, b;
+	std::mt19937 gen(42);
+	std::uniform_int_distribution<int> dist(0, 255);
+	for (int iter = 0; iter < 100; ++iter) {
+		for (auto i : xrange(64)) {
+			a[i] = uint8_t(dist(gen));
+			b[i] = (i % 4 == 0) ? a[i] : uint8_t(dist(gen));
+		}
+		a[1] = 0x00; b[1] = 0xff;
+		a[2] = 0xff; b[2] = 0x00;
+		a[3] = 0x7f; b[3] = 0x80;
+		for (auto op : allOps) {
+			auto mask = CheatFinder::compare64(op, a.data(), b.data());
+			for (auto i : xrange(64)) {
+				CHECK(((mask >> i) & 1) == refCompare(op, a[i], b[i]));
+			}
+		}
+	}
+}
+
+TEST_CASE("CheatFinder: search")
+{
+	using enum CheatFinder::Compare;
+	// not a multiple of the page size, nor of 64
+	FakeMemory mem(3 * CheatFinder::PAGE_SIZE + 100);
+	std::mt19937 gen(1234);
+	std::uniform_int_distribution<int> dist(0, 255);
+	for (auto& d : mem.data) d = uint8_t(dist(gen));
+
+	std::vector<unsigned> up = {5, 64, 4095, 4096, 3 * 4096 + 99};
+	std::vector<unsigned> down = {6, 8000};
+	for (auto a : up)   mem.data[a] = 100;
+	for (auto a : down) mem.data[a] = 100;
+
+	CheatFinder finder;
+	CHECK(!finder.isStarted());
+	finder.start("fake", mem);
+	CHECK(finder.isStarted());
+	CHECK(finder.getDebuggableName() == "fake");
+	CHECK(finder.getNumCandidates() == mem.data.size());
+	CHECK(finder.getResults().size() == mem.data.size());
+
+	// nothing changed
+	CHECK(finder.search(mem, EQUAL) == mem.data.size());
+
+	// a few locations increase, a few decrease
+	for (auto a : up)   mem.data[a] = 101;
+	for (auto a : down) mem.data[a] = 99;
+	auto expectedOld = std::vector<uint8_t>(mem.data);
+
+	CHECK(finder.search(mem, NOT_EQUAL) == up.size() + down.size());
+	CHECK(finder.search(mem, EQUAL) == up.size() + down.size()); // unchanged since
+
+	for (auto a : up) ++mem.data[a];
+	for (auto a : down) mem.data[a] = 0;
+	CHECK(finder.search(mem, GREATER) == up.size());
+	auto results = finder.getResults();
+	REQUIRE(results.size() == up.size());
+	for (auto i : xrange(up.size())) {
+		CHECK(results[i].address == up[i]);
+		CHECK(results[i].oldValue == expectedOld[up[i]]);
+		CHECK(results[i].newValue == mem.data[up[i]]);
+	}
+	CHECK(finder.getResults(2).size() == 2);
+
+	// pages without candidates are not read anymore
+	mem.data[4096] = 42;
+	mem.numReads = 0;
+	CHECK(finder.search(mem, EQUAL, 42) == 1);
+	CHECK(mem.numReads == 2 * CheatFinder::PAGE_SIZE + 100); // page 2 has no candidates
+	CHECK(finder.getResults()[0].address == 4096);
+
+	mem.numReads = 0;
+	CHECK(finder.search(mem, LESS_EQUAL) == 1);
+	CHECK(mem.numReads == CheatFinder::PAGE_SIZE);
+
+	finder.clear();
+	CHECK(!finder.isStarted());
+	CHECK(finder.getNumCandidates() == 0);
+}
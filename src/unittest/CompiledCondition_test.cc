@@ -0,0 +1,126 @@
+#include "catch.hpp"
+#include "CompiledCondition.hh"
+
+#include "Debuggable.hh"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+using namespace openmsx;
+
+namespace {
+
+struct FakeDebuggable final : Debuggable
+{
+	FakeDebuggable(std::string_view desc_, unsigned size_) : desc(desc_), size(size_) {}
+	[[nodiscard]] unsigned getSize() const override { return size; }
+	[[nodiscard]] std::string_view getDescription() const override { return desc; }
+	[[nodiscard]] uint8_t read(unsigned address) override { return data[address & 0xffff]; }
+	void write(unsigned address, uint8_t value) override { data[address & 0xffff] = value; }
+
+	std::string_view desc;
+	unsigned size;
+	std::array<uint8_t, 0x10000> data = {};
+};
+
+struct Machine
+{
+	Machine() {
+		regs.write(0, 0x12); // A
+		regs.write(1, 0x34); // F
+		regs.write(20, 0x40); // PC high
+		regs.write(21, 0x5a); // PC low
+		mem.write(0xc000, 0x01);
+		mem.write(0xc001, 0x80);
+		mem.write(0xffff, 0x77);
+	}
+
+	[[nodiscard]] auto lookup() {
+		return [&](std::string_view name) -> Debuggable* {
+			if (name == "CPU regs") return &regs;
+			if (name == "memory")   return &mem;
+			return nullptr;
+		};
+	}
+	[[nodiscard]] std::optional<bool> eval(std::string_view expr) {
+		auto cc = CompiledCondition::compile(expr);
+		REQUIRE(cc);
+		return cc->evaluate(lookup());
+	}
+	[[nodiscard]] std::optional<int64_t> value(std::string_view expr) {
+		auto cc = CompiledCondition::compile(expr);
+		REQUIRE(cc);
+		return cc->evaluateValue(lookup());
+	}
+
+	FakeDebuggable regs{"regs", 28};
+	FakeDebuggable mem{"mem", 0x10000};
+};
+
+} // namespace
+
+TEST_CASE("CompiledCondition: unsupported")
+{
+	auto fails = [](std::string_view expr) {
+		CHECK(!CompiledCondition::compile(expr));
+	};
+	fails("");
+	fails("$::wp_last_value == 3");
+	fails("[reg A] == [my_proc]");
+	fails("[reg XYZ] == 1");
+	fails("[reg A] * 2");
+	fails("[reg A] << 1");
+	fails("010 == 8"); // octal in Tcl 8
+	fails("1.5 > 1");
+	fails("[reg A] == 1 ; foo");
+	fails("[peek $addr] == 1");
+	fails("[peek 0x100 \"mem\"x] == 1");
+	fails("[reg A");
+	fails("([reg A] == 1");
+	fails("0x100000000 > 1");
+}
+
+TEST_CASE("CompiledCondition: evaluate")
+{
+	Machine m;
+	CHECK(m.eval("1") == true);
+	CHECK(m.eval("0") == false);
+	CHECK(m.eval("[reg A] == 0x12") == true);
+	CHECK(m.eval("[reg a]==18") == true);
+	CHECK(m.eval("[reg AF] == 0x1234") == true);
+	CHECK(m.eval("[reg PC] == 0x405a && [reg A] != 0") == true);
+	CHECK(m.eval("[reg PC] == 0x405a && [reg A] == 0") == false);
+	CHECK(m.eval("[reg PC] == 0 || [reg F] == 0x34") == true);
+	CHECK(m.eval("!([reg A] == 0x12)") == false);
+	CHECK(m.eval("[peek 0xc000] == 1") == true);
+	CHECK(m.eval("[peek16 0xc000] == 0x8001") == true);
+	CHECK(m.eval("[peek16_BE 0xc000] == 0x0180") == true);
+	CHECK(m.eval("[peek 0xc001 memory] & 0x80") == true);
+	CHECK(m.eval("[debug read {CPU regs} 0] == 0x12") == true);
+	CHECK(m.eval("[debug read \"memory\" 49152] == 1") == true);
+	CHECK(m.eval("[reg A] & 0x10 == 0x10") == false); // '==' binds tighter than '&'
+	CHECK(m.eval("([reg A] & 0x10) == 0x10") == true);
+	CHECK(m.eval("[reg A] + 1 == 0x13") == true);
+	CHECK(m.eval("-[reg A] < 0") == true);
+	CHECK(m.eval("~0 == -1") == true);
+	CHECK(m.eval("0b101 ^ 0o7 | 0 == 2") == true);
+	CHECK(m.eval("[reg A] >= 0x12 && [reg A] <= 0x12 && !([reg A] > 0x12) && !([reg A] < 0x12)") == true);
+
+	// these need the Tcl fallback
+	CHECK(m.eval("[peek16 0xffff] == 0") == std::nullopt); // address out of range
+	CHECK(m.eval("[debug read unknown 0] == 0") == std::nullopt);
+}
+
+TEST_CASE("CompiledCondition: evaluateValue")
+{
+	Machine m;
+	CHECK(m.value("42") == 42);
+	CHECK(m.value("[peek 0xc001]") == 0x80);
+	CHECK(m.value("[peek16 0xc000]") == 0x8001);
+	CHECK(m.value("[reg A] + [reg F]") == 0x46);
+	CHECK(m.value("[reg A] - 0x20") == -14);
+	CHECK(m.value("[debug read \"memory\" 0xffff] & 0x0f") == 7);
+	CHECK(m.value("[reg A] == 0x12") == 1);
+	CHECK(m.value("[peek16 0xffff]") == std::nullopt);
+}
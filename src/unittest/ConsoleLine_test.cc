@@ -3,6 +3,7 @@
 #include "ConsoleLine.hh"
 
 #include <algorithm>
+#include <vector>
 
 using namespace openmsx;
 
@@ -227,3 +228,49 @@ TEST_CASE("ConsoleLine")
 		}
 	}
 }
+
+TEST_CASE("ConsoleLine: wrap")
+{
+	auto col1 = static_cast<imColor>(101);
+	auto col2 = static_cast<imColor>(102);
+	auto col3 = static_cast<imColor>(103);
+	ConsoleLine line;
+	line.addChunk("abcdef",       col1);
+	line.addChunk("ghijklmnopqr", col2);
+	line.addChunk("stuvwxyz",     col3);
+
+	for (unsigned column = 1; column < 30; ++column) {
+		// reference: repeatedly split
+		std::vector<ConsoleLine> expected;
+		auto tmp = line;
+		do {
+			auto rest = tmp.splitAtColumn(column);
+			expected.push_back(std::move(tmp));
+			tmp = std::move(rest);
+		} while (!tmp.str().empty());
+
+		auto pieces = line.wrap(column);
+		REQUIRE(pieces.size() == expected.size());
+		for (size_t i = 0; i < pieces.size(); ++i) {
+			invariants(pieces[i]);
+			CHECK(pieces[i].str() == expected[i].str());
+			REQUIRE(pieces[i].numChunks() == expected[i].numChunks());
+			for (size_t j = 0; j < pieces[i].numChunks(); ++j) {
+				CHECK(pieces[i].chunkColor(j) == expected[i].chunkColor(j));
+				CHECK(pieces[i].chunkText(j) == expected[i].chunkText(j));
+			}
+		}
+
+		// only the last pieces
+		auto last = line.wrap(column, 2);
+		REQUIRE(last.size() == std::min<size_t>(2, expected.size()));
+		CHECK(last.back().str() == expected.back().str());
+	}
+
+	// an empty line stays a single (empty) line
+	ConsoleLine empty("", col1);
+	auto pieces = empty.wrap(10);
+	REQUIRE(pieces.size() == 1);
+	CHECK(pieces[0].str().empty());
+	CHECK(pieces[0].chunkColor(0) == col1);
+}
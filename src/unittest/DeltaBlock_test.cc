@@ -0,0 +1,190 @@
+#include "catch.hpp"
+#include "DeltaBlock.hh"
+
+#include "xrange.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace openmsx;
+
+static std::vector<uint8_t> restore(const DeltaBlock& block, size_t size)
+{
+	std::vector<uint8_t> result(size);
+	block.apply(result);
+	return result;
+}
+
+TEST_CASE("DeltaBlock: unchanged data is shared")
+{
+	std::vector<uint8_t> data(4096);
+	for (auto i : xrange(data.size())) data[i] = uint8_t(i / 16); // compressible
+
+	LastDeltaBlocks last;
+	auto b1 = last.createNew(&data, data);
+	auto b2 = last.createNew(&data, data);
+	CHECK(b1 == b2);
+
+	data[100] = 0xAA; // different from the reference now
+	auto b3 = last.createNew(&data, data);
+	CHECK(b3 != b1);
+	CHECK(restore(*b3, data.size()) == data);
+
+	// Null-diff returns the last block
+	auto b4 = last.createNullDiff(&data, data);
+	CHECK(b4 == b3);
+	last.clear();
+}
+
+TEST_CASE("DeltaBlock: identical blocks are shared between instances")
+{
+	std::vector<uint8_t> data1(4096, 0);
+	std::vector<uint8_t> data2(4096, 0);
+
+	LastDeltaBlocks last1;
+	LastDeltaBlocks last2;
+	auto b1 = last1.createNew(&data1, data1);
+	auto b2 = last2.createNew(&data2, data2);
+	CHECK(b1 == b2);
+
+	// both continue independently from the shared reference block
+	data1[10] = 1;
+	data2[20] = 2;
+	auto b3 = last1.createNew(&data1, data1);
+	auto b4 = last2.createNew(&data2, data2);
+	CHECK(restore(*b3, data1.size()) == data1);
+	CHECK(restore(*b4, data2.size()) == data2);
+
+	// still usable as reference after one instance released it
+	last1.clear();
+	DeltaBlockCopy::waitForBackgroundCompression();
+	data2[30] = 3;
+	auto b5 = last2.createNew(&data2, data2);
+	CHECK(restore(*b5, data2.size()) == data2);
+	CHECK(restore(*b1, data1.size()) == std::vector<uint8_t>(4096, 0));
+}
+
+TEST_CASE("DeltaBlock: history with background compression")
+{
+	std::mt19937 gen(1234);
+	std::vector<uint8_t> data(4096);
+	for (auto i : xrange(data.size())) data[i] = uint8_t(i / 32);
+
+	LastDeltaBlocks last;
+	std::vector<std::shared_ptr<DeltaBlock>> blocks;
+	std::vector<std::vector<uint8_t>> expected;
+	for (int s = 0; s < 200; ++s) {
+		// modify a few random bytes, after a while the accumulated
+		// difference becomes too large and a new copy is made (and the
+		// old copy is compressed in the background)
+		for (int j = 0; j < 10; ++j) {
+			data[gen() % data.size()] = uint8_t(gen());
+		}
+		blocks.push_back(last.createNew(&data, data));
+		expected.push_back(data);
+
+		// concurrently with the background compression
+		auto k = gen() % blocks.size();
+		CHECK(restore(*blocks[k], data.size()) == expected[k]);
+	}
+	last.clear();
+	DeltaBlockCopy::waitForBackgroundCompression();
+	for (auto k : xrange(blocks.size())) {
+		CHECK(restore(*blocks[k], data.size()) == expected[k]);
+	}
+
+	// blocks may be destroyed before they're compressed
+	blocks.clear();
+	DeltaBlockCopy::waitForBackgroundCompression();
+}
+
+TEST_CASE("DeltaBlock: various difference patterns")
+{
+	// Exercise the word-at-a-time code paths: short and long runs of
+	// (non-)matching bytes at different alignments.
+	std::mt19937 gen(5678);
+	std::vector<uint8_t> ref(3000);
+	for (auto& b : ref) b = uint8_t(gen());
+
+	LastDeltaBlocks last;
+	auto check = [&](const std::vector<uint8_t>& data) {
+		last.clear();
+		(void)last.createNew(&ref, ref); // reference copy
+		auto block = last.createNew(&ref, data);
+		CHECK(restore(*block, data.size()) == data);
+	};
+	for (size_t start : {0, 1, 15, 16, 17, 31, 33}) {
+		for (size_t len : {1, 2, 3, 15, 16, 17, 32, 63, 100, 1000}) {
+			auto data = ref;
+			for (auto i : xrange(start, std::min(start + len, data.size()))) {
+				data[i] = uint8_t(~data[i]); // all bytes different
+			}
+			check(data);
+
+			data = ref;
+			for (auto i : xrange(start, std::min(start + len, data.size()))) {
+				if (i % 3) data[i] = uint8_t(~data[i]); // interleaved equal bytes
+			}
+			check(data);
+		}
+	}
+	auto data = ref;
+	for (auto& b : data) b = uint8_t(~b); // everything different
+	check(data);
+	last.clear();
+}
+
+// Not run by default, use:  unittest "[.benchmark]"
+TEST_CASE("DeltaBlock benchmark", "[.benchmark]")
+{
+	static constexpr size_t SIZE = 128 * 1024; // e.g. MSX RAM
+	static constexpr int REPEAT = 2000;
+	std::mt19937 gen(42);
+
+	auto measure = [&](std::string_view name, auto modify) {
+		std::vector<uint8_t> data(SIZE);
+		for (auto i : xrange(SIZE)) data[i] = uint8_t(i / 64); // compressible
+		LastDeltaBlocks last;
+		std::vector<std::shared_ptr<DeltaBlock>> history; // keeps the reference blocks alive
+		std::vector<uint8_t> out(SIZE);
+		size_t deltaSize = 0;
+		double createTime = 0.0;
+		double applyTime = 0.0;
+		for (int r = 0; r < REPEAT; ++r) {
+			modify(data);
+			auto t0 = std::chrono::steady_clock::now();
+			auto block = last.createNew(&data, data);
+			auto t1 = std::chrono::steady_clock::now();
+			block->apply(out);
+			auto t2 = std::chrono::steady_clock::now();
+			createTime += std::chrono::duration<double>(t1 - t0).count();
+			applyTime  += std::chrono::duration<double>(t2 - t1).count();
+			deltaSize += block->getMemorySize();
+			history.push_back(std::move(block));
+		}
+		last.clear();
+		history.clear();
+		DeltaBlockCopy::waitForBackgroundCompression();
+		double mb = double(SIZE) * REPEAT / 1e6;
+		std::cout << name << ": create " << (mb / createTime) << " MB/s, apply "
+		          << (mb / applyTime) << " MB/s, average stored size "
+		          << (deltaSize / REPEAT) << " bytes\n";
+	};
+	// mostly static buffer (e.g. a ROM-like or idle RAM region)
+	measure("static     ", [](std::vector<uint8_t>&) {});
+	// game RAM: a variable area and a few scattered bytes change each frame
+	measure("game RAM   ", [&](std::vector<uint8_t>& data) {
+		auto base = 0xC000 + (gen() % 64) * 16;
+		for (auto i : xrange(256)) data[base + i] = uint8_t(gen());
+		for (int i = 0; i < 50; ++i) data[gen() % SIZE] = uint8_t(gen());
+	});
+	// large blocks get completely rewritten (e.g. a decompressed level)
+	measure("rewrites   ", [&](std::vector<uint8_t>& data) {
+		auto base = (gen() % (SIZE / 4096)) * 4096;
+		for (auto i : xrange(4096)) data[base + i] = uint8_t(gen());
+	});
+}
@@ -0,0 +1,45 @@
+#include "catch.hpp"
+#include "DirtyPages.hh"
+
+using namespace openmsx;
+
+TEST_CASE("DirtyPages")
+{
+	DirtyPages dirty(5 * DirtyPages::PAGE_SIZE + 100);
+	REQUIRE(dirty.numPages() == 6);
+
+	// initially everything is dirty
+	for (size_t p = 0; p < 6; ++p) CHECK(dirty.isDirty(p, 0));
+
+	auto a = dirty.checkpoint();
+	for (size_t p = 0; p < 6; ++p) CHECK(!dirty.isDirty(p, a));
+
+	dirty.markDirty(2 * DirtyPages::PAGE_SIZE + 7);
+	CHECK(!dirty.isDirty(1, a));
+	CHECK( dirty.isDirty(2, a));
+	CHECK(!dirty.isDirty(3, a));
+
+	// a second consumer
+	auto b = dirty.checkpoint();
+	CHECK(!dirty.isDirty(2, b));
+	dirty.markDirty(DirtyPages::PAGE_SIZE - 1, 2); // crosses page boundary
+	CHECK( dirty.isDirty(0, b));
+	CHECK( dirty.isDirty(1, b));
+	CHECK(!dirty.isDirty(2, b));
+	// first consumer sees writes from both epochs
+	CHECK( dirty.isDirty(0, a));
+	CHECK( dirty.isDirty(2, a));
+	CHECK(!dirty.isDirty(3, a));
+
+	dirty.markDirty(4 * DirtyPages::PAGE_SIZE, 0); // empty range
+	CHECK(!dirty.isDirty(4, a));
+
+	CHECK( dirty.isRangeDirty(0, DirtyPages::PAGE_SIZE, b));
+	CHECK(!dirty.isRangeDirty(2 * DirtyPages::PAGE_SIZE, 3 * DirtyPages::PAGE_SIZE, b));
+	CHECK( dirty.isRangeDirty(2 * DirtyPages::PAGE_SIZE - 1, 1, b)); // last byte of page 1
+	CHECK(!dirty.isRangeDirty(0, 0, a)); // empty range
+	CHECK( dirty.isRangeDirty(3 * DirtyPages::PAGE_SIZE, 100 * DirtyPages::PAGE_SIZE, 0)); // clipped
+
+	dirty.markAllDirty();
+	for (size_t p = 0; p < 6; ++p) CHECK(dirty.isDirty(p, b));
+}
@@ -15,6 +15,8 @@ static void test(const DivModByConst<DIVISOR>& c, const DivModBySame& s,
 		CHECK(c.mod(dividend) == (dividend % DIVISOR));
 		CHECK(s.mod(dividend) == (dividend % DIVISOR));
 	}
+	CHECK(s.div64  (dividend) == rd);
+	CHECK(s.divInC(dividend) == rd);
 }
 
 template<uint32_t DIVISOR>
@@ -44,4 +46,5 @@ TEST_CASE("DivModByConst, DivModBySame")
 	test<1000>();
 	test<90000>();
 	test<90017>();
+	test<0xFFFFFFFF>();
 }
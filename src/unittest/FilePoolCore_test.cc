@@ -3,6 +3,7 @@
 #include "FilePoolCore.hh"
 #include "File.hh"
 #include "FileOperations.hh"
+#include "Date.hh"
 #include "one_of.hh"
 #include "StringOp.hh"
 #include "Timer.hh"
@@ -119,19 +120,127 @@ TEST_CASE("FilePoolCore")
 		}
 	}
 
-	// write 'filecache' to disk
+	// 'filecache' was written to disk, reload it without any directories:
+	// all lookups must come from the cache
+	auto noDirectories = [] { return FilePoolCore::Directories{}; };
+	{
+		FilePoolCore pool(tmp + "/cache",
+				  noDirectories,
+				  [](std::string_view, float) {});
+		auto [file1, fname1] = pool.getFile(FileType::ROM, Sha1Sum("637a81ed8e8217bb01c15c67c39b43b0ab4e20f1"));
+		CHECK(file1.is_open());
+		CHECK(fname1 == tmp + "/e");
+		auto [file2, fname2] = pool.getFile(FileType::ROM, Sha1Sum("7e240de74fb1ed08fa08d38063f6a6a91462a815"));
+		CHECK(file2.is_open());
+		CHECK(fname2 == one_of(tmp + "/a", tmp + "/a2"));
+		auto [file3, fname3] = pool.getFile(FileType::ROM, Sha1Sum("f36b4825e5db2cf7dd2d2593b3f5c24c0311d8b2"));
+		CHECK(file3.is_open());
+		CHECK(fname3 == tmp + "/c");
+		auto [file4, fname4] = pool.getFile(FileType::ROM, Sha1Sum("aa6878b1c31a9420245df1daffb7b223338737a3"));
+		CHECK(!file4.is_open());
+	}
+
+	FileOperations::deleteRecursive(tmp);
+}
+
+TEST_CASE("FilePoolCore: read old text format")
+{
+	auto tmp = FileOperations::getTempDir() + "/filepool_unittest";
+	FileOperations::deleteRecursive(tmp);
+	FileOperations::mkdirp(tmp);
+	createFile(tmp + "/a",  "aaa"); // 7e240de74fb1ed08fa08d38063f6a6a91462a815
+	std::array<char, 24> buf;
+	auto time = FileOperations::getModificationDate(*FileOperations::getStat(tmp + "/a"));
+	createFile(tmp + "/cache", strCat("7e240de74fb1ed08fa08d38063f6a6a91462a815  ",
+	                                  Date::toString(time, buf), "  ", tmp, "/a\n"));
+
+	auto noDirectories = [] { return FilePoolCore::Directories{}; };
+	for (int i = 0; i < 2; ++i) { // first text, then converted to binary
+		FilePoolCore pool(tmp + "/cache",
+				  noDirectories,
+				  [](std::string_view, float) {});
+		auto [file, fname] = pool.getFile(FileType::ROM, Sha1Sum("7e240de74fb1ed08fa08d38063f6a6a91462a815"));
+		CHECK(file.is_open());
+		CHECK(fname == tmp + "/a");
+	}
 	auto lines = readLines(tmp + "/cache");
-	CHECK(lines.size() == 4);
-	CHECK(lines[0].starts_with("637a81ed8e8217bb01c15c67c39b43b0ab4e20f1"));
-	CHECK(lines[0].ends_with(tmp + "/e"));
-	CHECK(lines[1].starts_with("7e240de74fb1ed08fa08d38063f6a6a91462a815"));
-	CHECK((lines[1].ends_with(tmp + "/a") ||
-	       lines[1].ends_with(tmp + "/a2")));
-	CHECK(lines[2].starts_with("7e240de74fb1ed08fa08d38063f6a6a91462a815"));
-	CHECK((lines[2].ends_with(tmp + "/a") ||
-	       lines[2].ends_with(tmp + "/a2")));
-	CHECK(lines[3].starts_with("f36b4825e5db2cf7dd2d2593b3f5c24c0311d8b2"));
-	CHECK(lines[3].ends_with(tmp + "/c"));
+	REQUIRE(!lines.empty());
+	CHECK(lines[0].starts_with("oMSXfpc1")); // converted to binary format
+
+	FileOperations::deleteRecursive(tmp);
+}
+
+TEST_CASE("FilePoolCore: background indexing")
+{
+	auto tmp = FileOperations::getTempDir() + "/filepool_unittest";
+	FileOperations::deleteRecursive(tmp);
+	FileOperations::mkdirp(tmp + "/sub");
+	createFile(tmp + "/a",     "aaa"); // 7e240de74fb1ed08fa08d38063f6a6a91462a815
+	createFile(tmp + "/sub/b", "bbb"); // 5cb138284d431abd6a053a56625ec088bfb88912
+
+	auto getDirectories = [&] {
+		FilePoolCore::Directories result;
+		result.emplace_back(tmp, FileType::ROM);
+		return result;
+	};
+	{
+		FilePoolCore pool(tmp + "/cache",
+				  getDirectories,
+				  [](std::string_view, float) {});
+		pool.indexInBackground();
+		// waits for the background thread (if it's not yet finished)
+		{
+			auto [file, fname] = pool.getFile(FileType::ROM, Sha1Sum("5cb138284d431abd6a053a56625ec088bfb88912"));
+			CHECK(file.is_open());
+			CHECK(fname == tmp + "/sub/b");
+		}
+		CHECK(!pool.isIndexing());
+		{
+			auto [file, fname] = pool.getFile(FileType::ROM, Sha1Sum("7e240de74fb1ed08fa08d38063f6a6a91462a815"));
+			CHECK(file.is_open());
+			CHECK(fname == tmp + "/a");
+		}
+		// restart while running, and destroy while (possibly) still running
+		pool.indexInBackground();
+		pool.indexInBackground();
+	}
+
+	FileOperations::deleteRecursive(tmp);
+}
+
+TEST_CASE("FilePoolCore: prefetch sha1sums")
+{
+	auto tmp = FileOperations::getTempDir() + "/filepool_unittest";
+	FileOperations::deleteRecursive(tmp);
+	FileOperations::mkdirp(tmp);
+	createFile(tmp + "/a", "aaa"); // 7e240de74fb1ed08fa08d38063f6a6a91462a815
+	createFile(tmp + "/b", "bbb"); // 5cb138284d431abd6a053a56625ec088bfb88912
+
+	// The files are not in a filepool directory, so they can only be
+	// found via the cache.
+	auto noDirectories = [] { return FilePoolCore::Directories{}; };
+	{
+		FilePoolCore pool(tmp + "/cache",
+				  noDirectories,
+				  [](std::string_view, float) {});
+		std::vector<std::string> files = {tmp + "/a", tmp + "/b", tmp + "/missing"};
+		pool.prefetchSha1Sums(files);
+		{
+			auto [file, fname] = pool.getFile(FileType::ROM, Sha1Sum("7e240de74fb1ed08fa08d38063f6a6a91462a815"));
+			CHECK(file.is_open());
+			CHECK(fname == tmp + "/a");
+		}
+		{
+			auto [file, fname] = pool.getFile(FileType::ROM, Sha1Sum("5cb138284d431abd6a053a56625ec088bfb88912"));
+			CHECK(file.is_open());
+			CHECK(fname == tmp + "/b");
+		}
+		{
+			auto fname = tmp + "/b";
+			File file(fname);
+			CHECK(pool.getSha1Sum(file, fname) == Sha1Sum("5cb138284d431abd6a053a56625ec088bfb88912"));
+		}
+	}
 
 	FileOperations::deleteRecursive(tmp);
 }
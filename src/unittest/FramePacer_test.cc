@@ -0,0 +1,58 @@
+#include "catch.hpp"
+#include "FramePacer.hh"
+
+using namespace openmsx;
+
+TEST_CASE("FramePacer: refresh rate")
+{
+	FramePacer pacer;
+	CHECK(pacer.getRefreshPeriod() == 16'666);
+	pacer.setRefreshRate(144.0);
+	CHECK(pacer.getRefreshPeriod() == 6'944);
+	pacer.setRefreshRate(0.0); // unknown
+	CHECK(pacer.getRefreshPeriod() == 16'666);
+	pacer.setRefreshRate({});
+	CHECK(pacer.getRefreshPeriod() == 16'666);
+}
+
+TEST_CASE("FramePacer: paint time")
+{
+	FramePacer pacer;
+	pacer.setRefreshRate(100.0); // period 10ms
+	// nothing presented yet
+	CHECK(pacer.getNextPaintTime(1'000) == 11'000);
+
+	// render took 2ms, vblank at 100ms -> next at 110ms, start painting
+	// 'render estimate (2ms) + safety margin' before that
+	pacer.presented(2'000, 100'000);
+	CHECK(pacer.getNextPaintTime(100'000) == 107'500);
+	CHECK(pacer.getNextPaintTime(107'500) == 107'500);
+	// too late for the vblank at 110ms, aim for the one at 120ms
+	CHECK(pacer.getNextPaintTime(107'501) == 117'500);
+	CHECK(pacer.getNextPaintTime(125'000) == 127'500);
+
+	// the render estimate quickly follows slow renders
+	pacer.presented(4'000, 110'000);
+	CHECK(pacer.getNextPaintTime(110'000) == 115'500);
+
+	CHECK(pacer.getDisplayTime(110'000) == 120'000);
+	CHECK(pacer.getDisplayTime(117'000) == 130'000);
+}
+
+TEST_CASE("FramePacer: blend factor")
+{
+	FramePacer pacer;
+	CHECK(!pacer.isActive(0));
+	pacer.frameFinished(100'000);
+	CHECK(pacer.isActive(100'000));
+	CHECK(pacer.getBlendFactor(105'000) == 1.0f); // only one frame
+	pacer.frameFinished(120'000);
+	CHECK(pacer.getBlendFactor(110'000) == 0.0f);
+	CHECK(pacer.getBlendFactor(120'000) == 0.0f);
+	CHECK(pacer.getBlendFactor(125'000) == 0.25f);
+	CHECK(pacer.getBlendFactor(130'000) == 0.5f);
+	CHECK(pacer.getBlendFactor(140'000) == 1.0f);
+	CHECK(pacer.getBlendFactor(150'000) == 1.0f);
+	CHECK(pacer.isActive(219'999));
+	CHECK(!pacer.isActive(220'000));
+}
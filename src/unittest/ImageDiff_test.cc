@@ -0,0 +1,102 @@
+#include "catch.hpp"
+#include "ImageDiff.hh"
+
+#include "MSXException.hh"
+#include "PixelOperations.hh"
+
+#include "xrange.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace openmsx;
+using Pixel = uint32_t;
+
+// Straightforward scalar implementation, the real (vectorized) routine must
+// give identical results.
+static ImageDiff::Result refCompare(std::span<const Pixel> in1, std::span<const Pixel> in2,
+                                    std::span<Pixel> diff)
+{
+	PixelOperations pixelOps;
+	ImageDiff::Result result;
+	result.numPixels = in1.size();
+	for (auto i : xrange(in1.size())) {
+		auto dr = unsigned(std::abs(int(pixelOps.red  (in1[i])) - int(pixelOps.red  (in2[i]))));
+		auto dg = unsigned(std::abs(int(pixelOps.green(in1[i])) - int(pixelOps.green(in2[i]))));
+		auto db = unsigned(std::abs(int(pixelOps.blue (in1[i])) - int(pixelOps.blue (in2[i]))));
+		result.sumDelta += dr + dg + db;
+		result.maxDelta = std::max({result.maxDelta, dr, dg, db});
+		if (dr || dg || db) ++result.numDifferent;
+		diff[i] = pixelOps.combine(dr, dg, db);
+	}
+	return result;
+}
+
+TEST_CASE("ImageDiff: compareLine")
+{
+	PixelOperations pixelOps;
+	std::mt19937 gen(1234);
+	std::uniform_int_distribution<Pixel> dist;
+	std::uniform_int_distribution<int> small(-3, 3);
+
+	// Odd sizes also test the non-vectorized tail.
+	for (size_t size : {0, 1, 3, 4, 7, 16, 17, 320, 641}) {
+		std::vector<Pixel> in1(size), in2(size);
+		for (auto i : xrange(size)) {
+			in1[i] = dist(gen);
+			// mostly equal pixels, some slightly different ones,
+			// and different alpha values must be ignored
+			switch (i % 3) {
+			case 0: in2[i] = in1[i]; break;
+			case 1: in2[i] = in1[i] ^ pixelOps.getAmask(); break;
+			default: in2[i] = pixelOps.combine(
+				std::clamp(int(pixelOps.red  (in1[i])) + small(gen), 0, 255),
+				std::clamp(int(pixelOps.green(in1[i])) + small(gen), 0, 255),
+				std::clamp(int(pixelOps.blue (in1[i])) + small(gen), 0, 255));
+			}
+		}
+		std::vector<Pixel> diff(size), refDiff(size);
+		auto result = ImageDiff::compareLine(in1, in2, diff);
+		auto expected = refCompare(in1, in2, refDiff);
+		CHECK(result.numPixels    == expected.numPixels);
+		CHECK(result.numDifferent == expected.numDifferent);
+		CHECK(result.sumDelta     == expected.sumDelta);
+		CHECK(result.maxDelta     == expected.maxDelta);
+		CHECK(diff == refDiff);
+
+		// without diff output
+		auto result2 = ImageDiff::compareLine(in1, in2);
+		CHECK(result2.sumDelta == expected.sumDelta);
+	}
+}
+
+TEST_CASE("ImageDiff: compare")
+{
+	PixelOperations pixelOps;
+	ImageDiff::Image image1(5, 3);
+	std::ranges::fill(image1.pixels, pixelOps.combine(10, 20, 30));
+	ImageDiff::Image image2(5, 3);
+	std::ranges::copy(image1.pixels, image2.pixels.begin());
+
+	ImageDiff::Image diff;
+	auto same = ImageDiff::compare(image1, image2, &diff);
+	CHECK(same.numPixels == 15);
+	CHECK(same.numDifferent == 0);
+	CHECK(same.getMeanDelta() == 0.0);
+	CHECK(diff.width == 5);
+	CHECK(diff.height == 3);
+
+	image2.getLine(2)[4] = pixelOps.combine(10, 20, 60);
+	auto r = ImageDiff::compare(image1, image2, &diff);
+	CHECK(r.numDifferent == 1);
+	CHECK(r.maxDelta == 30);
+	CHECK(r.sumDelta == 30);
+	CHECK(diff.getLine(2)[4] == pixelOps.combine(0, 0, 30));
+	CHECK(diff.getLine(0)[0] == pixelOps.combine(0, 0, 0));
+
+	ImageDiff::Image image3(3, 5);
+	CHECK_THROWS_AS(ImageDiff::compare(image1, image3), MSXException);
+}
@@ -0,0 +1,199 @@
+#include "catch.hpp"
+#include "LineScalers.hh"
+
+#include "xrange.hh"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+
+using namespace openmsx;
+
+// Straightforward scalar implementations, the real (vectorized) routines must
+// give identical results.
+template<unsigned w1, unsigned w2>
+static void refBlendLines(std::span<const Pixel> in1, std::span<const Pixel> in2, std::span<Pixel> out)
+{
+	PixelOperations pixelOps;
+	for (auto i : xrange(out.size())) {
+		out[i] = pixelOps.template blend<w1, w2>(in1[i], in2[i]);
+	}
+}
+static void refAlphaBlendLines(std::span<const Pixel> in1, std::span<const Pixel> in2, std::span<Pixel> out)
+{
+	PixelOperations pixelOps;
+	for (auto i : xrange(out.size())) {
+		out[i] = pixelOps.alphaBlend(in1[i], in2[i]);
+	}
+}
+static void refAlphaBlendLines1(Pixel in1, std::span<const Pixel> in2, std::span<Pixel> out)
+{
+	PixelOperations pixelOps;
+	unsigned alpha = pixelOps.alpha(in1);
+	Pixel in1M = pixelOps.multiply(in1, alpha);
+	for (auto i : xrange(out.size())) {
+		out[i] = in1M + pixelOps.multiply(in2[i], 256 - alpha);
+	}
+}
+template<unsigned N>
+static void refScale_1onN(std::span<const Pixel> in, std::span<Pixel> out)
+{
+	for (auto i : xrange(in.size() * N)) {
+		out[i] = in[i / N];
+	}
+}
+
+static std::vector<Pixel> randomLine(size_t width, std::mt19937& gen)
+{
+	std::vector<Pixel> result(width);
+	// Also include extreme values, and alpha values 0 and 255.
+	std::uniform_int_distribution<int> special(0, 7);
+	for (auto& p : result) {
+		switch (special(gen)) {
+			case 0:  p = 0x00000000; break;
+			case 1:  p = 0xFFFFFFFF; break;
+			case 2:  p = gen() | 0xFF000000; break;
+			default: p = gen(); break;
+		}
+	}
+	return result;
+}
+
+template<unsigned w1, unsigned w2>
+static void testBlendLines(std::mt19937& gen)
+{
+	for (size_t width : {1, 3, 4, 7, 8, 15, 16, 17, 320, 333, 640}) {
+		auto in1 = randomLine(width, gen);
+		auto in2 = randomLine(width, gen);
+		std::vector<Pixel> out(width), ref(width);
+		blendLines<w1, w2>(in1, in2, out);
+		refBlendLines<w1, w2>(in1, in2, ref);
+		CHECK(out == ref);
+
+		// in-place
+		blendLines<w1, w2>(in1, in2, in1);
+		CHECK(in1 == ref);
+	}
+}
+
+TEST_CASE("LineScalers: blendLines")
+{
+	std::mt19937 gen(1234);
+	testBlendLines<1, 1>(gen);
+	testBlendLines<1, 3>(gen);
+	testBlendLines<3, 1>(gen);
+	testBlendLines<1, 7>(gen);
+	testBlendLines<3, 5>(gen);
+	testBlendLines<1, 2>(gen);
+	testBlendLines<2, 1>(gen);
+	testBlendLines<1, 15>(gen);
+	testBlendLines<3, 13>(gen);
+	testBlendLines<100, 156>(gen);
+}
+
+TEST_CASE("LineScalers: alphaBlendLines")
+{
+	std::mt19937 gen(4321);
+	for (size_t width : {1, 3, 4, 7, 8, 15, 16, 17, 320, 333, 640}) {
+		auto in1 = randomLine(width, gen);
+		auto in2 = randomLine(width, gen);
+		std::vector<Pixel> out(width), ref(width);
+		alphaBlendLines(in1, in2, out);
+		refAlphaBlendLines(in1, in2, ref);
+		CHECK(out == ref);
+
+		for (Pixel c : {0x01FFFFFFu, 0x80123456u, 0xFE00FF00u, Pixel(gen())}) {
+			alphaBlendLines(c, in2, out);
+			refAlphaBlendLines1(c, in2, ref);
+			CHECK(out == ref);
+		}
+	}
+}
+
+TEST_CASE("LineScalers: scale_1onN")
+{
+	std::mt19937 gen(5678);
+	for (size_t width : {1, 3, 4, 5, 8, 13, 320, 333}) {
+		auto in = randomLine(width, gen);
+		std::vector<Pixel> out(4 * width), ref(4 * width);
+
+		scale_1on2(in, std::span{out}.first(2 * width));
+		refScale_1onN<2>(in, ref);
+		CHECK(out == ref);
+
+		scale_1on3(in, std::span{out}.first(3 * width));
+		refScale_1onN<3>(in, ref);
+		CHECK(out == ref);
+
+		scale_1on4(in, out);
+		refScale_1onN<4>(in, ref);
+		CHECK(out == ref);
+	}
+}
+
+TEST_CASE("LineScalers: scale_2on1")
+{
+	// The SSE2 routine rounds up, the C++ routine rounds down.
+	std::mt19937 gen(8765);
+	for (size_t width : {1, 3, 4, 5, 8, 16, 17, 320, 333}) {
+		auto in = randomLine(2 * width, gen);
+		std::vector<Pixel> out(width);
+		scale_2on1(in, out);
+		for (auto i : xrange(width)) {
+			for (unsigned shift = 0; shift < 32; shift += 8) {
+				auto c0 = (in[2 * i + 0] >> shift) & 0xFF;
+				auto c1 = (in[2 * i + 1] >> shift) & 0xFF;
+				auto c  = (out[i] >> shift) & 0xFF;
+				CHECK(c >= ((c0 + c1 + 0) / 2));
+				CHECK(c <= ((c0 + c1 + 1) / 2));
+			}
+		}
+	}
+}
+
+// Not run by default, use:  unittest "[.benchmark]"
+TEST_CASE("LineScalers benchmark", "[.benchmark]")
+{
+	static constexpr size_t WIDTH = 640; // typical line width
+	static constexpr int REPEAT = 200000;
+	std::mt19937 gen(42);
+	auto in1 = randomLine(4 * WIDTH, gen);
+	auto in2 = randomLine(4 * WIDTH, gen);
+	std::vector<Pixel> out(4 * WIDTH);
+	std::span<const Pixel> src1 = std::span{in1}.first(WIDTH);
+	std::span<const Pixel> src2 = std::span{in2}.first(WIDTH);
+	std::span<Pixel> dst = std::span{out}.first(WIDTH);
+
+	Pixel checksum = 0; // use the result, so that it can't be optimized away
+	auto measure = [&](std::string_view name, auto f) {
+		auto start = std::chrono::steady_clock::now();
+		for (int r = 0; r < REPEAT; ++r) {
+			f();
+			checksum += out[r % WIDTH];
+		}
+		auto stop = std::chrono::steady_clock::now();
+		double s = std::chrono::duration<double>(stop - start).count();
+		std::cout << name << ": " << (double(WIDTH) * REPEAT / s / 1e6)
+		          << " Mpixel/s (output)\n";
+	};
+	measure("blendLines<1,1>      ", [&] { blendLines<1, 1>(src1, src2, dst); });
+	measure("  scalar             ", [&] { refBlendLines<1, 1>(src1, src2, dst); });
+	measure("blendLines<1,3>      ", [&] { blendLines<1, 3>(src1, src2, dst); });
+	measure("  scalar             ", [&] { refBlendLines<1, 3>(src1, src2, dst); });
+	measure("blendLines<1,2>      ", [&] { blendLines<1, 2>(src1, src2, dst); });
+	measure("  scalar             ", [&] { refBlendLines<1, 2>(src1, src2, dst); });
+	measure("alphaBlendLines      ", [&] { alphaBlendLines(src1, src2, dst); });
+	measure("  scalar             ", [&] { refAlphaBlendLines(src1, src2, dst); });
+	measure("alphaBlendLines(c)   ", [&] { alphaBlendLines(0x80123456, src2, dst); });
+	measure("  scalar             ", [&] { refAlphaBlendLines1(0x80123456, src2, dst); });
+	measure("scale_1on3           ", [&] { scale_1on3(src1.first(WIDTH / 3), dst.first(3 * (WIDTH / 3))); });
+	measure("  scalar             ", [&] { refScale_1onN<3>(src1.first(WIDTH / 3), dst); });
+	measure("scale_1on4           ", [&] { scale_1on4(src1.first(WIDTH / 4), dst); });
+	measure("  scalar             ", [&] { refScale_1onN<4>(src1.first(WIDTH / 4), dst); });
+	measure("scale_1on2           ", [&] { scale_1on2(src1.first(WIDTH / 2), dst); });
+	measure("scale_2on1           ", [&] { scale_2on1(std::span{in1}.first(2 * WIDTH), dst); });
+	std::cout << "(checksum " << checksum << ")\n";
+}
@@ -0,0 +1,77 @@
+#include "catch.hpp"
+
+#include "MPSCQueue.hh"
+
+#include "xrange.hh"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST_CASE("MPSCQueue: single thread")
+{
+	MPSCQueue<int> queue;
+	std::vector<int> out;
+	CHECK(queue.empty());
+	queue.popAll(out);
+	CHECK(out.empty());
+
+	queue.push(1);
+	queue.push(2);
+	queue.push(3);
+	CHECK(!queue.empty());
+	out.push_back(0); // popAll() appends
+	queue.popAll(out);
+	CHECK(out == std::vector{0, 1, 2, 3});
+	CHECK(queue.empty());
+
+	queue.push(4);
+	out.clear();
+	queue.popAll(out);
+	CHECK(out == std::vector{4});
+}
+
+TEST_CASE("MPSCQueue: move-only, remaining elements are destroyed")
+{
+	auto p = std::make_shared<int>(42);
+	{
+		MPSCQueue<std::shared_ptr<int>> queue;
+		queue.push(std::shared_ptr<int>(p));
+		queue.push(std::shared_ptr<int>(p));
+		CHECK(p.use_count() == 3);
+	}
+	CHECK(p.use_count() == 1);
+}
+
+TEST_CASE("MPSCQueue: multiple producers")
+{
+	static constexpr int NUM_THREADS = 4;
+	static constexpr int NUM_ITEMS = 10000;
+	MPSCQueue<int> queue;
+	std::vector<int> out;
+
+	std::vector<std::thread> producers;
+	for (auto t : xrange(NUM_THREADS)) {
+		producers.emplace_back([&queue, t] {
+			for (auto i : xrange(NUM_ITEMS)) {
+				queue.push(t * NUM_ITEMS + i);
+			}
+		});
+	}
+	// consume concurrently with the producers
+	while (out.size() < size_t(NUM_THREADS * NUM_ITEMS)) {
+		queue.popAll(out);
+	}
+	for (auto& p : producers) p.join();
+	CHECK(queue.empty());
+
+	// all elements are there, and per producer they're in order
+	for (auto t : xrange(NUM_THREADS)) {
+		std::vector<int> perThread;
+		std::ranges::copy_if(out, std::back_inserter(perThread),
+		                     [&](int v) { return v / NUM_ITEMS == t; });
+		REQUIRE(perThread.size() == size_t(NUM_ITEMS));
+		CHECK(std::ranges::is_sorted(perThread));
+	}
+}
@@ -0,0 +1,35 @@
+#include "catch.hpp"
+#include "RawFrame.hh"
+
+#include <memory>
+
+using namespace openmsx;
+
+TEST_CASE("RawFrame: memory is recycled")
+{
+	const RawFrame::Pixel* pixels = nullptr;
+	{
+		RawFrame frame(640, 240);
+		pixels = frame.getLineDirect(0).data();
+	}
+
+	SECTION("same dimensions") {
+		auto frame = std::make_unique<RawFrame>(640, 240);
+		CHECK(frame->getLineDirect(0).data() == pixels);
+		CHECK(frame->getHeight() == 240);
+		CHECK(frame->getLineWidthDirect(0) == 1); // starts black
+		CHECK(frame->getLineDirect(0)[0] == 0);
+
+		// Now the pool is empty again.
+		RawFrame frame2(640, 240);
+		CHECK(frame2.getLineDirect(0).data() != pixels);
+	}
+	SECTION("other dimensions") {
+		RawFrame frame(1280, 240);
+		CHECK(frame.getLineDirect(0).data() != pixels);
+		RawFrame frame2(640, 480);
+		CHECK(frame2.getLineDirect(0).data() != pixels);
+		RawFrame frame3(640, 240);
+		CHECK(frame3.getLineDirect(0).data() == pixels);
+	}
+}
@@ -0,0 +1,155 @@
+#include "catch.hpp"
+#include "SchedulerHeapQueue.hh"
+#include "SchedulerQueue.hh"
+
+#include "xrange.hh"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace openmsx;
+
+namespace {
+	struct Item {
+		uint64_t time = 0;
+		int id = 0;
+	};
+	struct LessItem {
+		bool operator()(const Item& x, const Item& y) const { return x.time < y.time; }
+	};
+	constexpr auto setSentinel = [](Item& i) { i.time = std::numeric_limits<uint64_t>::max(); };
+}
+
+// Simulate sync-point churn as done by the Scheduler: repeatedly remove the
+// front element and re-insert a (random) element that's a bit later. Also
+// occasionally remove an arbitrary element. Returns the order in which the
+// elements are removed from the front.
+template<typename Queue>
+static std::vector<int> churn(Queue& queue, int numDevices, int steps, uint32_t seed)
+{
+	std::mt19937 gen(seed);
+	std::uniform_int_distribution<uint64_t> delta(0, 1000);
+	std::uniform_int_distribution<int> dev(0, numDevices - 1);
+	std::vector<int> result;
+	result.reserve(steps);
+
+	for (auto i : xrange(numDevices)) {
+		queue.insert(Item{delta(gen), i}, setSentinel, LessItem{});
+	}
+	for (auto s : xrange(steps)) {
+		auto front = queue.front();
+		queue.remove_front();
+		result.push_back(front.id);
+		if ((s % 16) == 0) {
+			int id = dev(gen);
+			if (queue.remove([&](const Item& it) { return it.id == id; })) {
+				queue.insert(Item{front.time + delta(gen), id}, setSentinel, LessItem{});
+			}
+		}
+		// small deltas (including 0) to also test equal timestamps
+		queue.insert(Item{front.time + (delta(gen) & 7), front.id}, setSentinel, LessItem{});
+	}
+	return result;
+}
+
+TEST_CASE("SchedulerQueue")
+{
+	SchedulerQueue<Item> queue;
+	CHECK(queue.empty());
+
+	queue.insert(Item{10, 1}, setSentinel, LessItem{});
+	queue.insert(Item{5, 2}, setSentinel, LessItem{});
+	queue.insert(Item{10, 3}, setSentinel, LessItem{});
+	CHECK(queue.size() == 3);
+	CHECK(queue.front().id == 2);
+	queue.remove_front();
+	CHECK(queue.front().id == 1); // equal times keep insertion order
+	CHECK(queue.remove([](const Item& i) { return i.id == 1; }));
+	CHECK(!queue.remove([](const Item& i) { return i.id == 1; }));
+	CHECK(queue.front().id == 3);
+	queue.remove_all([](const Item& i) { return i.id == 3; });
+	CHECK(queue.empty());
+}
+
+TEST_CASE("SchedulerHeapQueue")
+{
+	SchedulerHeapQueue<Item, LessItem> queue;
+	CHECK(queue.empty());
+
+	queue.insert(Item{10, 1}, setSentinel, LessItem{});
+	queue.insert(Item{5, 2}, setSentinel, LessItem{});
+	queue.insert(Item{10, 3}, setSentinel, LessItem{});
+	CHECK(queue.size() == 3);
+	CHECK(queue.front().id == 2);
+	queue.remove_front();
+	CHECK(queue.front().id == 1); // equal times keep insertion order
+	CHECK(queue.remove([](const Item& i) { return i.id == 1; }));
+	CHECK(!queue.remove([](const Item& i) { return i.id == 1; }));
+	CHECK(queue.front().id == 3);
+
+	for (auto i : xrange(20)) {
+		queue.insert(Item{uint64_t(i % 4), i}, setSentinel, LessItem{});
+	}
+	queue.remove_all([](const Item& i) { return (i.id & 1) == 0; });
+	CHECK(queue.size() == 11);
+	uint64_t prevTime = 0;
+	int prevId = -1;
+	while (!queue.empty()) {
+		auto f = queue.front();
+		queue.remove_front();
+		CHECK((f.id & 1) != 0);
+		CHECK(f.time >= prevTime);
+		if (f.time == prevTime) CHECK(f.id > prevId);
+		prevTime = f.time;
+		prevId = f.id;
+	}
+
+	// with multiple matches, remove the smallest one (like SchedulerQueue)
+	queue.insert(Item{ 1, 0}, setSentinel, LessItem{});
+	queue.insert(Item{30, 7}, setSentinel, LessItem{});
+	queue.insert(Item{20, 7}, setSentinel, LessItem{});
+	queue.insert(Item{40, 8}, setSentinel, LessItem{});
+	queue.insert(Item{20, 9}, setSentinel, LessItem{});
+	CHECK(queue.remove([](const Item& i) { return i.id >= 7; }));
+	for (auto [time, id] : {std::pair{1, 0}, {20, 9}, {30, 7}, {40, 8}}) {
+		CHECK(queue.front().time == uint64_t(time));
+		CHECK(queue.front().id == id);
+		queue.remove_front();
+	}
+	CHECK(queue.empty());
+}
+
+TEST_CASE("SchedulerQueue and SchedulerHeapQueue give the same order")
+{
+	for (int numDevices : {1, 3, 10, 50}) {
+		SchedulerQueue<Item> sorted;
+		SchedulerHeapQueue<Item, LessItem> heap;
+		auto r1 = churn(sorted, numDevices, 10000, 1234);
+		auto r2 = churn(heap,   numDevices, 10000, 1234);
+		CHECK(r1 == r2);
+	}
+}
+
+// Not run by default, use:  unittest "[.benchmark]"
+TEST_CASE("SchedulerQueue benchmark", "[.benchmark]")
+{
+	auto measure = [](auto& queue, int numDevices) {
+		auto start = std::chrono::steady_clock::now();
+		auto r = churn(queue, numDevices, 1000000, 42);
+		auto stop = std::chrono::steady_clock::now();
+		CHECK(r.size() == 1000000);
+		return std::chrono::duration<double, std::milli>(stop - start).count();
+	};
+	for (int numDevices : {5, 10, 20, 50, 100, 200}) {
+		SchedulerQueue<Item> sorted;
+		SchedulerHeapQueue<Item, LessItem> heap;
+		auto t1 = measure(sorted, numDevices);
+		auto t2 = measure(heap, numDevices);
+		std::cout << numDevices << " sync-points: sorted " << t1
+		          << "ms, heap " << t2 << "ms\n";
+	}
+}
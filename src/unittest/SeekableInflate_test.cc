@@ -0,0 +1,68 @@
+#include "catch.hpp"
+
+#include "SeekableInflate.hh"
+
+#include <cstdint>
+#include <vector>
+
+#define ZLIB_CONST
+#include <zlib.h>
+
+using namespace openmsx;
+
+[[nodiscard]] static std::vector<uint8_t> rawDeflate(std::span<const uint8_t> data)
+{
+	z_stream s = {};
+	REQUIRE(deflateInit2(&s, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+	                     Z_DEFAULT_STRATEGY) == Z_OK);
+	std::vector<uint8_t> result(deflateBound(&s, uLong(data.size())));
+	s.next_in = data.data();
+	s.avail_in = uInt(data.size());
+	s.next_out = result.data();
+	s.avail_out = uInt(result.size());
+	REQUIRE(deflate(&s, Z_FINISH) == Z_STREAM_END);
+	result.resize(s.total_out);
+	deflateEnd(&s);
+	return result;
+}
+
+TEST_CASE("SeekableInflate")
+{
+	SECTION("empty") {
+		auto compressed = rawDeflate({});
+		SeekableInflate si(compressed);
+		CHECK(si.getSize() == 0);
+	}
+	SECTION("multiple checkpoints") {
+		// Pseudo random, but compressible, data of a few MB.
+		std::vector<uint8_t> data(5 * SeekableInflate::CHECKPOINT_DISTANCE + 1234);
+		uint32_t x = 12345;
+		for (auto& d : data) {
+			x = x * 1103515245 + 12345;
+			d = uint8_t((x >> 16) & 0x0f);
+		}
+		auto compressed = rawDeflate(data);
+		SeekableInflate si(compressed);
+		REQUIRE(si.getSize() == data.size());
+		CHECK(si.getNumCheckpoints() > 1);
+
+		auto check = [&](size_t pos, size_t len) {
+			std::vector<uint8_t> buf(len);
+			si.read(pos, buf);
+			CHECK(std::equal(buf.begin(), buf.end(), data.begin() + pos));
+		};
+		check(0, 100);
+		check(data.size() - 100, 100); // backwards
+		check(3 * SeekableInflate::CHECKPOINT_DISTANCE - 10, 3000); // across checkpoints
+		check(12345, 512);
+		check(0, data.size()); // everything
+
+		// alternating between two regions only decompresses each once
+		auto before = si.getNumInflates();
+		for (int i = 0; i < 10; ++i) {
+			check(100 + i, 10);
+			check(4 * SeekableInflate::CHECKPOINT_DISTANCE + i, 10);
+		}
+		CHECK(si.getNumInflates() <= (before + 2));
+	}
+}
@@ -0,0 +1,140 @@
+#include "catch.hpp"
+#include "SoftwareScaler.hh"
+
+#include "ThreadPool.hh"
+
+#include "xrange.hh"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace openmsx;
+
+static HQTables uniformTables(unsigned factor, std::array<uint8_t, 4> offsets, std::array<uint8_t, 3> weights)
+{
+	auto texels = size_t(64 * factor) * (64 * factor);
+	HQTables tables;
+	for (auto i : xrange(texels)) {
+		(void)i;
+		tables.offsets.insert(tables.offsets.end(), offsets.begin(), offsets.end());
+		tables.weights.insert(tables.weights.end(), weights.begin(), weights.end());
+	}
+	return tables;
+}
+
+TEST_CASE("SoftwareScaler: parse")
+{
+	auto check = [](std::string_view name, SoftwareScaler::Algo algo, unsigned factor) {
+		auto s = SoftwareScaler::parse(name);
+		REQUIRE(s);
+		CHECK(s->algo == algo);
+		CHECK(s->factor == factor);
+	};
+	check("hq2x",    SoftwareScaler::Algo::HQ,    2);
+	check("hq4x",    SoftwareScaler::Algo::HQ,    4);
+	check("scale2x", SoftwareScaler::Algo::SCALE, 2);
+	check("scale3x", SoftwareScaler::Algo::SCALE, 3);
+	CHECK(!SoftwareScaler::parse(""));
+	CHECK(!SoftwareScaler::parse("hq"));
+	CHECK(!SoftwareScaler::parse("hq1x"));
+	CHECK(!SoftwareScaler::parse("hq5x"));
+	CHECK(!SoftwareScaler::parse("scale2"));
+	CHECK(!SoftwareScaler::parse("simple2x"));
+}
+
+TEST_CASE("SoftwareScaler: scaleNx")
+{
+	static constexpr uint32_t A = 0xFF00'00FF;
+	static constexpr uint32_t B = 0xFFFF'0000;
+	// A A
+	// A B
+	std::vector<uint32_t> src = {A, A, A, B};
+
+	SECTION("scale2x") {
+		std::vector<uint32_t> dst(4 * 4);
+		scaleNxImage(2, src, 2, dst);
+		CHECK(dst == std::vector<uint32_t>{
+			A, A, A, A,
+			A, A, A, A,
+			A, A, A, B,
+			A, A, B, B});
+	}
+	SECTION("scale3x") {
+		// center sub-pixels are never changed
+		std::vector<uint32_t> dst(6 * 6);
+		scaleNxImage(3, src, 2, dst);
+		CHECK(dst == std::vector<uint32_t>{
+			A, A, A, A, A, A,
+			A, A, A, A, A, A,
+			A, A, A, A, A, A,
+			A, A, A, A, B, B,
+			A, A, A, B, B, B,
+			A, A, A, B, B, B});
+	}
+}
+
+TEST_CASE("SoftwareScaler: scaleHQ")
+{
+	std::mt19937 gen(1234);
+	unsigned width = 8, height = 6;
+	std::vector<uint32_t> src(width * height);
+	for (auto& p : src) p = uint32_t(gen());
+
+	for (unsigned factor : {2, 3, 4}) {
+		auto dstWidth = width * factor;
+		std::vector<uint32_t> dst(src.size() * factor * factor);
+
+		// only the center pixel
+		scaleHQImage(factor, uniformTables(factor, {0x80, 0x80, 0x80, 0x80}, {0, 0, 255}), src, width, dst);
+		for (auto y : xrange(height * factor)) {
+			for (auto x : xrange(dstWidth)) {
+				CHECK(dst[y * dstWidth + x] == src[(y / factor) * width + (x / factor)]);
+			}
+		}
+
+		// only the left neighbour (clamped at the border)
+		scaleHQImage(factor, uniformTables(factor, {0x00, 0x80, 0xFF, 0xFF}, {255, 0, 0}), src, width, dst);
+		for (auto y : xrange(height * factor)) {
+			for (auto x : xrange(dstWidth)) {
+				auto sx = std::max(int(x / factor) - 1, 0);
+				CHECK(dst[y * dstWidth + x] == src[(y / factor) * width + sx]);
+			}
+		}
+
+		// 50/50 mix of the lower-right and upper-left neighbours
+		scaleHQImage(factor, uniformTables(factor, {0xFF, 0xFF, 0x00, 0x00}, {128, 127, 0}), src, width, dst);
+		uint32_t p0 = src[0 * width + 0];
+		uint32_t p1 = src[1 * width + 1];
+		uint32_t mixed = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			unsigned c = ((p1 >> shift) & 0xFF) * 128 + ((p0 >> shift) & 0xFF) * 127;
+			mixed |= ((c + 127) / 255) << shift;
+		}
+		CHECK(dst[0] == mixed);
+	}
+}
+
+TEST_CASE("SoftwareScaler: threads")
+{
+	std::mt19937 gen(5678);
+	unsigned width = 32, height = 25;
+	std::vector<uint32_t> src(width * height);
+	// few colors, so that there are many equal neighbours
+	for (auto& p : src) p = (gen() & 1) ? 0xFF11'2233 : 0xFF99'AABB;
+
+	ThreadPool pool(3);
+	auto tables = uniformTables(2, {0x00, 0x80, 0x80, 0x00}, {100, 100, 55});
+	for (auto factor : {2u, 3u}) {
+		std::vector<uint32_t> dst1(src.size() * factor * factor);
+		std::vector<uint32_t> dst2(src.size() * factor * factor);
+		scaleNxImage(factor, src, width, dst1);
+		scaleNxImage(factor, src, width, dst2, &pool);
+		CHECK(dst1 == dst2);
+	}
+	std::vector<uint32_t> dst1(src.size() * 4);
+	std::vector<uint32_t> dst2(src.size() * 4);
+	scaleHQImage(2, tables, src, width, dst1);
+	scaleHQImage(2, tables, src, width, dst2, &pool);
+	CHECK(dst1 == dst2);
+}
@@ -0,0 +1,100 @@
+#include "catch.hpp"
+#include "SymbolIndex.hh"
+
+#include "SymbolManager.hh"
+
+#include "xrange.hh"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace openmsx;
+
+static Symbol sym(std::string name, uint16_t value)
+{
+	return Symbol{std::move(name), value, std::nullopt, std::nullopt};
+}
+
+static std::vector<std::string> names(std::span<const Symbol* const> symbols)
+{
+	std::vector<std::string> result;
+	for (const auto* s : symbols) result.push_back(s->name);
+	return result;
+}
+
+TEST_CASE("SymbolIndex: empty")
+{
+	SymbolIndex index;
+	CHECK(index.size() == 0);
+	CHECK(index.lookupValue(0x1234).empty());
+	CHECK(index.lookupName("foo") == nullptr);
+}
+
+TEST_CASE("SymbolIndex: lookup")
+{
+	std::vector<Symbol> file1 = {sym("start", 0x4000), sym("loop", 0x4010), sym("Loop2", 0x4010), sym("end", 0x4100)};
+	std::vector<Symbol> file2 = {sym("main", 0x4000), sym("LOOP", 0x8000), sym("data", 0xc000)};
+	std::vector<Symbol> file3 = {sym("init", 0x4000), sym("loop", 0x9000)};
+
+	SymbolIndex index;
+	index.insertFile(file1, 0);
+	index.insertFile(file2, 1);
+	CHECK(index.size() == 7);
+
+	CHECK(names(index.lookupValue(0x4000)) == std::vector<std::string>{"start", "main"});
+	CHECK(names(index.lookupValue(0x4010)) == std::vector<std::string>{"loop", "Loop2"});
+	CHECK(index.lookupValue(0x4001).empty());
+
+	// exact match preferred, otherwise case-insensitive, earlier files first
+	CHECK(index.lookupName("loop") == &file1[1]);
+	CHECK(index.lookupName("LOOP") == &file2[1]);
+	CHECK(index.lookupName("Loop") == &file1[1]);
+	CHECK(index.lookupExactName("Loop") == nullptr);
+	CHECK(index.lookupName("DATA") == &file2[2]);
+	CHECK(index.lookupName("nothing") == nullptr);
+
+	// insert in front: takes precedence
+	index.insertFile(file3, 0);
+	CHECK(names(index.lookupValue(0x4000)) == std::vector<std::string>{"init", "start", "main"});
+	CHECK(index.lookupName("loop") == &file3[1]);
+
+	// remove the middle file (file1)
+	index.eraseFile(file1, 1);
+	CHECK(index.size() == 5);
+	CHECK(names(index.lookupValue(0x4000)) == std::vector<std::string>{"init", "main"});
+	CHECK(index.lookupValue(0x4010).empty());
+	CHECK(index.lookupName("start") == nullptr);
+	CHECK(index.lookupName("loop") == &file3[1]);
+	CHECK(index.lookupName("LOOP") == &file2[1]);
+
+	// remove the first file (file3), the remaining key must still work
+	index.eraseFile(file3, 0);
+	CHECK(index.lookupName("loop") == &file2[1]);
+	CHECK(index.lookupExactName("loop") == nullptr);
+	CHECK(names(index.lookupValue(0x4000)) == std::vector<std::string>{"main"});
+
+	index.eraseFile(file2, 0);
+	CHECK(index.size() == 0);
+	CHECK(index.lookupName("loop") == nullptr);
+}
+
+TEST_CASE("SymbolIndex: many")
+{
+	// values wrap around, so some values have multiple symbols
+	std::vector<Symbol> file;
+	std::vector<size_t> count(0x10000);
+	for (auto i : xrange(20000)) {
+		auto v = uint16_t(i * 7);
+		file.push_back(sym("label" + std::to_string(i), v));
+		++count[v];
+	}
+	SymbolIndex index;
+	index.insertFile(file, 0);
+	for (auto i : xrange(20000)) {
+		auto found = index.lookupValue(file[i].value);
+		REQUIRE(found.size() == count[file[i].value]);
+		CHECK(std::ranges::find(found, &file[i]) != found.end());
+		CHECK(index.lookupName("LABEL" + std::to_string(i)) == &file[i]);
+	}
+}
@@ -0,0 +1,64 @@
+#include "catch.hpp"
+#include "TapeEdges.hh"
+
+#include "xrange.hh"
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace openmsx;
+
+TEST_CASE("TapeEdges: empty")
+{
+	TapeEdges edges;
+	CHECK(edges.size() == 0);
+	CHECK(edges.numEdges() == 0);
+	CHECK(edges.getLevel(0) == 0);
+
+	std::array<float, 3> buf = {1.0f, 2.0f, 3.0f};
+	edges.fill(0, buf);
+	CHECK(buf == std::array{0.0f, 0.0f, 0.0f});
+}
+
+TEST_CASE("TapeEdges: compare with waveform")
+{
+	// build the same signal as edges and as a plain waveform
+	TapeEdges edges;
+	std::vector<int8_t> wave;
+	std::mt19937 gen(42);
+	std::uniform_int_distribution<int> countDist(0, 10);
+	std::uniform_int_distribution<int> levelDist(0, 2);
+	for (int i = 0; i < 500; ++i) {
+		auto count = size_t(countDist(gen));
+		auto level = int8_t((levelDist(gen) - 1) * 127);
+		edges.append(count, level);
+		wave.insert(wave.end(), count, level);
+	}
+	REQUIRE(edges.size() == wave.size());
+	CHECK(edges.numEdges() < 500); // equal levels are merged
+
+	// sequential
+	for (auto i : xrange(wave.size() + 10)) {
+		CHECK(edges.getLevel(i) == ((i < wave.size()) ? wave[i] : 0));
+	}
+	// random order
+	std::uniform_int_distribution<size_t> posDist(0, wave.size() - 1);
+	for (int i = 0; i < 1000; ++i) {
+		auto pos = posDist(gen);
+		CHECK(edges.getLevel(pos) == wave[pos]);
+	}
+
+	// fill, with and without oversampling, also past the end
+	for (unsigned oversample : {1u, 4u}) {
+		std::vector<float> buf(50);
+		for (size_t pos = 0; pos < (wave.size() + 20) * oversample; pos += 37) {
+			edges.fill(pos, buf, oversample);
+			for (auto i : xrange(buf.size())) {
+				auto p = (pos + i) / oversample;
+				CHECK(buf[i] == ((p < wave.size()) ? float(wave[p]) : 0.0f));
+			}
+		}
+	}
+}
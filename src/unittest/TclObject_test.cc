@@ -36,6 +36,19 @@ TEST_CASE("TclObject, constructors")
 		TclObject t(42);
 		CHECK(t.getString() == "42");
 	}
+	SECTION("small int") {
+		// small ints are shared, modifying one doesn't affect the others
+		TclObject t1(5);
+		TclObject t2(5u);
+		t1.addListElement(6);
+		t2 = 7;
+		CHECK(t1.getString() == "5 6");
+		CHECK(t2.getString() == "7");
+		CHECK(TclObject(5).getString() == "5");
+		CHECK(TclObject(255).getString() == "255");
+		CHECK(TclObject(256).getString() == "256");
+		CHECK(TclObject(-1).getString() == "-1");
+	}
 	SECTION("double") {
 		TclObject t(6.28);
 		CHECK(t.getString() == "6.28");
@@ -0,0 +1,47 @@
+#include "catch.hpp"
+#include "ThreadPool.hh"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace openmsx;
+
+TEST_CASE("ThreadPool")
+{
+	for (unsigned numWorkers : {0, 1, 3}) {
+		ThreadPool pool(numWorkers);
+		CHECK(pool.getNumWorkers() == numWorkers);
+
+		for (size_t n : {0, 1, 2, 7, 100}) {
+			std::vector<int> out(n, 0);
+			pool.parallelFor(n, [&](size_t i) { out[i] += int(i) + 1; });
+			for (size_t i = 0; i < n; ++i) {
+				CHECK(out[i] == int(i) + 1); // each part executed exactly once
+			}
+		}
+
+		CHECK_THROWS_AS(pool.parallelFor(10, [&](size_t i) {
+			if (i == 4) throw std::runtime_error("oops");
+		}), std::runtime_error);
+
+		// pool is still usable after an exception
+		std::atomic<int> count = 0;
+		pool.parallelFor(3, [&](size_t) { ++count; });
+		CHECK(count == 3);
+	}
+}
+
+TEST_CASE("ThreadPool: parallelForTemporary")
+{
+	for (size_t n : {0, 1, 100}) {
+		std::vector<int> out(n, 0);
+		ThreadPool::parallelForTemporary(n, [&](size_t i) { out[i] += int(i) + 1; });
+		for (size_t i = 0; i < n; ++i) {
+			CHECK(out[i] == int(i) + 1);
+		}
+	}
+	CHECK_THROWS_AS(ThreadPool::parallelForTemporary(10, [&](size_t i) {
+		if (i == 4) throw std::runtime_error("oops");
+	}), std::runtime_error);
+}
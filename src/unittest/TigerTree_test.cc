@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <span>
+#include <vector>
 
 using namespace openmsx;
 
@@ -90,4 +91,45 @@ TEST_CASE("TigerTree")
 		CHECK(tt.calcHash(dummyCallback).toString() ==
 		      "PLHCYOTPV4TTXTUPHYGGVPMARGMFE4U5JYRV4VA");
 	}
+	SECTION("export and import leaf hashes") {
+		std::ranges::fill(subspan<3 * BLOCK_SIZE + 500>(buffer), 0);
+		std::vector<TigerHash> leaves;
+		{
+			TigerTree tt(data, 3 * BLOCK_SIZE + 500, dummyName);
+			CHECK(tt.getNumLeaves() == 4);
+			CHECK(!tt.allLeavesValid());
+			(void)tt.calcHash(dummyCallback);
+			CHECK(tt.allLeavesValid());
+			leaves.resize(tt.getNumLeaves());
+			tt.getLeafHashes(leaves);
+		}
+		// Different content, but the (imported) leaves say otherwise.
+		std::ranges::fill(subspan<3 * BLOCK_SIZE + 500>(buffer), 1);
+		TigerTree tt(data, 3 * BLOCK_SIZE + 500, dummyName);
+		tt.setLeafHashes(leaves);
+		CHECK(tt.allLeavesValid());
+		CHECK(tt.calcHash(dummyCallback).toString() ==
+		      "K6NHCUINLFZ7OUMUZ44JSRABL5C62WTCY2BONUI");
+	}
+}
+
+TEST_CASE("tiger_leaves")
+{
+	static constexpr auto BLOCK_SIZE = TigerTree::BLOCK_SIZE;
+	static constexpr size_t NUM = 11; // not a multiple of the interleave factor
+	std::vector<uint8_t> buffer_(NUM * BLOCK_SIZE + 1);
+	auto buffer = subspan(buffer_, 1);
+	for (size_t i = 0; i < buffer.size(); ++i) buffer[i] = uint8_t(i * 7 + (i >> 10));
+
+	std::vector<TigerHash> expected(NUM);
+	for (size_t i = 0; i < NUM; ++i) {
+		tiger_leaf(buffer.subspan(i * BLOCK_SIZE, BLOCK_SIZE), expected[i]);
+	}
+	for (size_t n = 0; n <= NUM; ++n) {
+		std::vector<TigerHash> result(n);
+		tiger_leaves(buffer.first(n * BLOCK_SIZE), result);
+		for (size_t i = 0; i < n; ++i) {
+			CHECK(result[i].h64 == expected[i].h64);
+		}
+	}
 }
@@ -0,0 +1,120 @@
+#include "catch.hpp"
+#include "TraceSummary.hh"
+
+#include "xrange.hh"
+
+#include <random>
+#include <vector>
+
+using namespace openmsx;
+
+static TraceSummary::Node refSummarize(const std::vector<bool>& v, size_t begin, size_t end)
+{
+	TraceSummary::Node result;
+	for (auto i : xrange(begin, end)) {
+		if (i == begin) {
+			result.first = v[i];
+		} else if (v[i] != v[i - 1]) {
+			++result.numEdges;
+		}
+		result.last = v[i];
+		result.anyFalse |= !v[i];
+		result.anyTrue  |=  v[i];
+	}
+	return result;
+}
+
+static void check(const TraceSummary& summary, const std::vector<bool>& v)
+{
+	REQUIRE(summary.size() == v.size());
+	for (auto i : xrange(v.size())) {
+		CHECK(summary[i] == v[i]);
+	}
+
+	// a selection of ranges, including the full range and ones that
+	// start/end at node boundaries
+	std::vector<size_t> points = {0, 1, 63, 64, 65, 1000, 1023, 1024, 1025, 5000, v.size() - 1, v.size()};
+	std::erase_if(points, [&](size_t p) { return p > v.size(); });
+	for (auto b : points) {
+		for (auto e : points) {
+			if (b > e) continue;
+			auto s = summary.summarize(b, e);
+			auto r = refSummarize(v, b, e);
+			CHECK(s.numEdges == r.numEdges);
+			CHECK(s.anyFalse == r.anyFalse);
+			CHECK(s.anyTrue  == r.anyTrue);
+			if (!r.empty()) {
+				CHECK(s.first == r.first);
+				CHECK(s.last  == r.last);
+			}
+		}
+		for (bool value : {false, true}) {
+			auto next = b;
+			while (next < v.size() && v[next] != value) ++next;
+			CHECK(summary.findNext(b, value) == next);
+
+			auto prev = summary.findPrev(b, value);
+			size_t p = b;
+			while (p > 0 && v[p - 1] != value) --p;
+			if (p == 0) {
+				CHECK(!prev);
+			} else {
+				REQUIRE(prev);
+				CHECK(*prev == p - 1);
+			}
+		}
+	}
+}
+
+TEST_CASE("TraceSummary: empty")
+{
+	TraceSummary summary;
+	CHECK(summary.size() == 0);
+	CHECK(summary.summarize(0, 0).empty());
+	CHECK(summary.findNext(0, true) == 0);
+	CHECK(!summary.findPrev(0, false));
+}
+
+TEST_CASE("TraceSummary: random")
+{
+	std::mt19937 gen(1234);
+	TraceSummary summary;
+	std::vector<bool> ref;
+	// long runs of the same value, as typical for probes
+	for (size_t len : {1, 10, 100, 5000, 20000}) {
+		std::uniform_int_distribution<size_t> runLength(1, len);
+		while (ref.size() < 30000) {
+			bool value = runLength(gen) & 1;
+			for (auto n = runLength(gen); n > 0; --n) {
+				summary.push_back(value);
+				ref.push_back(value);
+			}
+		}
+		check(summary, ref);
+
+		summary.truncate(ref.size() / 3);
+		ref.resize(ref.size() / 3);
+		check(summary, ref);
+
+		summary.dropFront(ref.size() / 3);
+		ref.erase(ref.begin(), ref.begin() + ptrdiff_t(ref.size() / 3));
+		check(summary, ref);
+
+		summary.clear();
+		ref.clear();
+	}
+}
+
+TEST_CASE("TraceSummary: constant")
+{
+	TraceSummary summary;
+	for (int i = 0; i < 100'000; ++i) summary.push_back(true);
+	summary.push_back(false);
+	CHECK(summary.findNext(0, false) == 100'000);
+	CHECK(summary.findPrev(100'000, false) == std::nullopt);
+	CHECK(summary.findPrev(100'001, true) == 99'999);
+	auto s = summary.summarize(0, summary.size());
+	CHECK(s.numEdges == 1);
+	CHECK(s.first);
+	CHECK(!s.last);
+}
@@ -0,0 +1,67 @@
+#include "catch.hpp"
+#include "VDPRegisterHistory.hh"
+
+#include <array>
+#include <cstdint>
+
+using namespace openmsx;
+
+static EmuTime t(uint64_t ticks) { return EmuTime::fromUint64(ticks); }
+
+TEST_CASE("VDPRegisterHistory: changes")
+{
+	VDPRegisterHistory history(4);
+	CHECK(history.empty());
+
+	history.record(t(10), 7, 0x00, 0x11);
+	history.record(t(20), 2, 0x06, 0x07);
+	history.record(t(30), 7, 0x11, 0x22);
+	CHECK(history.size() == 3);
+
+	auto changes = history.getChanges(t(15), t(30));
+	REQUIRE(changes.size() == 1);
+	CHECK(changes.begin()->reg == 2);
+	CHECK(history.getChanges(t(0), t(100)).size() == 3);
+
+	// current values: R#2=0x07, R#7=0x22
+	CHECK(history.getValueAt(t(35), 7, 0x22) == 0x22);
+	CHECK(history.getValueAt(t(30), 7, 0x22) == 0x22);
+	CHECK(history.getValueAt(t(29), 7, 0x22) == 0x11);
+	CHECK(history.getValueAt(t(5),  7, 0x22) == 0x00);
+	CHECK(history.getValueAt(t(5),  2, 0x07) == 0x06);
+	CHECK(history.getValueAt(t(5),  3, 0x42) == 0x42);
+
+	std::array<uint8_t, 32> regs = {};
+	regs[2] = 0x07;
+	regs[7] = 0x22;
+	CHECK(history.getValuesAt(t(25), regs));
+	CHECK(regs[2] == 0x07);
+	CHECK(regs[7] == 0x11);
+
+	// going back in time drops the newer changes
+	history.record(t(25), 9, 0x00, 0x80);
+	CHECK(history.size() == 3);
+	CHECK(history.getChanges(t(26), t(100)).empty());
+
+	history.clear();
+	CHECK(history.empty());
+}
+
+TEST_CASE("VDPRegisterHistory: overflow")
+{
+	VDPRegisterHistory history(2);
+	history.record(t(10), 1, 0x00, 0x01);
+	history.record(t(20), 1, 0x01, 0x02);
+	history.record(t(30), 1, 0x02, 0x03); // drops the oldest change
+	CHECK(history.size() == 2);
+
+	CHECK(history.getValueAt(t(25), 1, 0x03) == 0x02);
+	CHECK(history.getValueAt(t(20), 1, 0x03) == 0x02);
+	CHECK(history.getValueAt(t(15), 1, 0x03) == std::nullopt); // unknown
+	std::array<uint8_t, 32> regs = {};
+	CHECK(!history.getValuesAt(t(15), regs));
+
+	history.clear();
+	history.record(t(40), 1, 0x03, 0x04);
+	CHECK(history.getValueAt(t(35), 1, 0x04) == 0x03);
+}
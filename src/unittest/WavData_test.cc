@@ -176,3 +176,30 @@ TEST_CASE("WavData, content")
 		CHECK(wav.getSample(4) ==  0); // past end
 	}
 }
+
+TEST_CASE("WavData, parse")
+{
+	// stereo, 16 bit, the data chunk is preceded by some other chunk
+	static constexpr auto buffer = std::to_array<uint8_t>({
+		'R', 'I', 'F', 'F',  0x04,0x05,0x06,0x07, 'W', 'A', 'V', 'E',  'f', 'm', 't' ,' ',
+		0x10,0x00,0x00,0x00, 0x01,0x00,0x02,0x00, 0x22,0x56,0x00,0x00, 0x88,0x58,0x01,0x00,
+		0x04,0x00,0x10,0x00,
+		'L', 'I', 'S', 'T',  0x04,0x00,0x00,0x00, 0xaa,0xbb,0xcc,0xdd,
+		'd', 'a', 't', 'a',  0x12,0x00,0x00,0x00, // last (incomplete) frame is ignored
+		0x12,0x34,0xff,0xee, 0x56,0x78,0xdd,0xcc, 0x9a,0xbc,0xbb,0xaa, 0xde,0xf0,0x99,0x88,
+		0x01,0x02,
+	});
+	auto raw = WavData::parse(buffer);
+	CHECK(raw.freq == 22050);
+	CHECK(raw.bits == 16);
+	CHECK(raw.channels == 2);
+	CHECK(raw.length == 4);
+	CHECK(raw.data.size() == 16);
+	CHECK(raw.data.data() == &buffer[56]);
+
+	// convert only a part
+	std::array<int16_t, 2> out = {};
+	raw.convert(1, out);
+	CHECK(out[0] ==  0x7856);
+	CHECK(out[1] == -0x4366);
+}
@@ -66,6 +66,14 @@ TEST_CASE("XMLOutputStream: simple")
 		xml.end("abc");
 		CHECK(ss.str() == "<abc>\n  <def foo=\"bar\">qux</def>\n</abc>\n");
 	}
+	SECTION("data written directly by the caller") {
+		xml.begin("abc");
+		  xml.attribute("foo", "bar");
+		  xml.beginDataRaw();
+		  writer.write(std::span{"<&>", 3});
+		xml.end("abc");
+		CHECK(ss.str() == "<abc foo=\"bar\"><&></abc>\n");
+	}
 }
 
 TEST_CASE("XMLOutputStream: complex")
@@ -123,6 +123,9 @@ TEST_CASE("cb_queue") {
 	CHECK(q.pop_front() == 2); check_queue(q, 8, {4,5,6,7});
 	CHECK(q.pop_front() == 4); check_queue(q, 8, {5,6,7});
 	q.clear();                 check_queue(q, 8, {});
+	q.push_back({1,2,3});      check_queue(q, 8, {1,2,3});
+	q.append_range(vector{4,5,6,7,8,9}); check_queue(q, 16, {1,2,3,4,5,6,7,8,9});
+	q.append_range(vector<int>{});       check_queue(q, 16, {1,2,3,4,5,6,7,8,9});
 }
 
 static void check_queue(
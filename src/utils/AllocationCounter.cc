@@ -0,0 +1,97 @@
+#include "AllocationCounter.hh"
+
+#ifdef COUNT_ALLOCATIONS
+#include "MemoryOps.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace openmsx::AllocationCounter {
+
+#ifdef COUNT_ALLOCATIONS
+
+// Plain counters (no locks, no allocations), these are also used before
+// main() and after all other static objects are destroyed.
+static constinit std::atomic<uint64_t> allocations = 0;
+static constinit std::atomic<uint64_t> deallocations = 0;
+static constinit std::atomic<uint64_t> bytes = 0;
+
+static void count(size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+static void uncount(const void* p)
+{
+	if (p) deallocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+Counts get()
+{
+	return {.allocations   = allocations  .load(std::memory_order_relaxed),
+	        .deallocations = deallocations.load(std::memory_order_relaxed),
+	        .bytes         = bytes        .load(std::memory_order_relaxed)};
+}
+
+#else
+
+Counts get()
+{
+	return {};
+}
+
+#endif
+
+} // namespace openmsx::AllocationCounter
+
+#ifdef COUNT_ALLOCATIONS
+
+// Replacements for the global allocation functions. The standard library
+// implements the array and nothrow variants in terms of these.
+
+void* operator new(size_t size)
+{
+	openmsx::AllocationCounter::count(size);
+	if (size == 0) size = 1;
+	while (true) {
+		if (void* p = std::malloc(size)) return p;
+		auto* handler = std::get_new_handler();
+		if (!handler) throw std::bad_alloc();
+		handler();
+	}
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	openmsx::AllocationCounter::count(size);
+	auto align = std::max(static_cast<size_t>(alignment), sizeof(void*));
+	return openmsx::MemoryOps::mallocAligned(align, size ? size : 1);
+}
+
+void operator delete(void* p) noexcept
+{
+	openmsx::AllocationCounter::uncount(p);
+	std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t /*alignment*/) noexcept
+{
+	openmsx::AllocationCounter::uncount(p);
+	openmsx::MemoryOps::freeAligned(p);
+}
+
+void operator delete(void* p, size_t /*size*/) noexcept
+{
+	::operator delete(p);
+}
+
+void operator delete(void* p, size_t /*size*/, std::align_val_t alignment) noexcept
+{
+	::operator delete(p, alignment);
+}
+
+#endif
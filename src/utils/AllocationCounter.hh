@@ -0,0 +1,38 @@
+#ifndef ALLOCATIONCOUNTER_HH
+#define ALLOCATIONCOUNTER_HH
+
+#include <cstdint>
+
+namespace openmsx::AllocationCounter {
+
+/** Heap allocation statistics, counted over the whole process since it was
+  * started. Only available when openMSX was built with the meson option
+  * 'count_allocations' (COUNT_ALLOCATIONS), because that replaces the global
+  * operator new/delete, which costs a few atomic increments per allocation.
+  *
+  * Take a snapshot before and after e.g. creating a machine, the difference
+  * tells how many allocations that needed.
+  */
+struct Counts {
+	uint64_t allocations = 0;
+	uint64_t deallocations = 0;
+	uint64_t bytes = 0; // total number of bytes ever requested
+
+	[[nodiscard]] constexpr uint64_t live() const { return allocations - deallocations; }
+};
+
+[[nodiscard]] constexpr bool isEnabled()
+{
+#ifdef COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+/** Returns the current counts (all zero when not enabled). */
+[[nodiscard]] Counts get();
+
+} // namespace openmsx::AllocationCounter
+
+#endif
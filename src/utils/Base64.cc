@@ -6,39 +6,115 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cassert>
+#include <optional>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
 
 namespace Base64 {
 
 using openmsx::MemBuffer;
 
+static constexpr std::array<char, 64> base64_chars = {
+	'A','B','C','D','E','F','G','H','I','J','K','L','M','N','O','P','Q','R','S','T','U','V','W','X','Y','Z',
+	'a','b','c','d','e','f','g','h','i','j','k','l','m','n','o','p','q','r','s','t','u','v','w','x','y','z',
+	'0','1','2','3','4','5','6','7','8','9','+','/',
+};
+
 [[nodiscard]] static constexpr char encode(uint8_t c)
 {
-	constexpr std::array<char, 64> base64_chars = {
-		'A','B','C','D','E','F','G','H','I','J','K','L','M','N','O','P','Q','R','S','T','U','V','W','X','Y','Z',
-		'a','b','c','d','e','f','g','h','i','j','k','l','m','n','o','p','q','r','s','t','u','v','w','x','y','z',
-		'0','1','2','3','4','5','6','7','8','9','+','/',
-	};
 	assert(c < 64);
 	return base64_chars[c];
 }
 
+// Maps a base64 character to its value, all other characters to 0xff.
+static constexpr auto decodeTable = [] {
+	std::array<uint8_t, 256> result = {};
+	std::ranges::fill(result, uint8_t(-1));
+	for (auto i : xrange(64)) {
+		result[uint8_t(base64_chars[i])] = uint8_t(i);
+	}
+	return result;
+}();
+
 [[nodiscard]] static constexpr uint8_t decode(uint8_t c)
 {
-	if        ('A' <= c && c <= 'Z') {
-		return c - 'A';
-	} else if ('a' <= c && c <= 'z') {
-		return c - 'a' + 26;
-	} else if ('0' <= c && c <= '9') {
-		return c - '0' + 52;
-	} else if (c == '+') {
-		return 62;
-	} else if (c == '/') {
-		return 63;
-	} else {
-		return uint8_t(-1);
-	}
+	return decodeTable[c];
+}
+
+#ifdef __SSSE3__
+// The SIMD routines below are based on the algorithms by Wojciech Muła:
+//   http://0x80.pl/articles/index.html#base64-algorithm-new
+
+// Encode 12 bytes into 16 characters. Reads 16 input bytes (the last 4 are
+// ignored).
+static void encode12(const uint8_t* in, char* out)
+{
+	__m128i v = _mm_loadu_si128(std::bit_cast<const __m128i*>(in));
+	// Per 32-bit lane: the 3 input bytes in the order [b1 b0 b2 b1].
+	v = _mm_shuffle_epi8(v, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+	// Move each 6-bit field into its own byte.
+	__m128i t0 = _mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00));
+	__m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+	__m128i t2 = _mm_and_si128(v, _mm_set1_epi32(0x003f03f0));
+	__m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+	__m128i indices = _mm_or_si128(t1, t3);
+
+	// Translate the 6-bit values to characters: add an offset, that
+	// depends on the range the value is in.
+	__m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51)); // 0 for [0, 51], 1..12 for [52, 63]
+	__m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices); // [0, 25]
+	range = _mm_or_si128(range, _mm_and_si128(less, _mm_set1_epi8(13)));
+	const __m128i offsets = _mm_setr_epi8(
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+		'/' - 63, 'A', 0, 0);
+	__m128i result = _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+	_mm_storeu_si128(std::bit_cast<__m128i*>(out), result);
+}
+
+// Decode 16 characters into 12 bytes. Writes 16 output bytes (the last 4
+// contain garbage). Returns false (and writes nothing) when not all 16
+// characters are valid base64 characters (e.g. a newline or padding).
+[[nodiscard]] static bool decode16(const char* in, uint8_t* out)
+{
+	__m128i v = _mm_loadu_si128(std::bit_cast<const __m128i*>(in));
+	__m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi8(0x0f));
+	__m128i loNibbles = _mm_and_si128(v, _mm_set1_epi8(0x0f));
+
+	// Each (high nibble, low nibble) combination that's not a base64
+	// character has a common bit set in these two lookups.
+	const __m128i loLut = _mm_setr_epi8(
+		0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+		0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+	const __m128i hiLut = _mm_setr_epi8(
+		0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+		0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	__m128i lo = _mm_shuffle_epi8(loLut, loNibbles);
+	__m128i hi = _mm_shuffle_epi8(hiLut, hiNibbles);
+	__m128i invalid = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+	if (_mm_movemask_epi8(invalid) != 0xffff) return false;
+
+	// Translate the characters to their 6-bit values: add an offset that
+	// depends on the high nibble ('/' is the only special case).
+	const __m128i rollLut = _mm_setr_epi8(
+		0, 16, 19, 4, -65, -65, -71, -71,
+		0, 0, 0, 0, 0, 0, 0, 0);
+	__m128i isSlash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+	__m128i roll = _mm_shuffle_epi8(rollLut, _mm_add_epi8(isSlash, hiNibbles));
+	__m128i values = _mm_add_epi8(v, roll);
+
+	// Pack 4 x 6 bits into 3 bytes per 32-bit lane.
+	__m128i mergedAB = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+	__m128i merged = _mm_madd_epi16(mergedAB, _mm_set1_epi32(0x00011000));
+	__m128i result = _mm_shuffle_epi8(merged, _mm_setr_epi8(
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+	_mm_storeu_si128(std::bit_cast<__m128i*>(out), result);
+	return true;
 }
+#endif
 
 std::string encode(std::span<const uint8_t> input)
 {
@@ -53,6 +129,13 @@ std::string encode(std::span<const uint8_t> input)
 		while (!input.empty()) {
 			if (out) buf[out++] = '\n';
 			auto n = std::min<size_t>(IN_CHUNKS, input.size());
+#ifdef __SSSE3__
+			for (/**/; (n >= 12) && (input.size() >= 16); n -= 12) {
+				encode12(input.data(), &buf[out]);
+				out += 16;
+				input = input.subspan(12);
+			}
+#endif
 			for (/**/; n >= 3; n -= 3) {
 				buf[out++] = encode(uint8_t( (input[0] & 0xfc) >> 2));
 				buf[out++] = encode(uint8_t(((input[0] & 0x03) << 4) +
@@ -89,56 +172,32 @@ std::string encode(std::span<const uint8_t> input)
 	return ret;
 }
 
-MemBuffer<uint8_t> decode(std::string_view input)
-{
-	auto outSize = (input.size() * 3 + 3) / 4; // overestimation
-	MemBuffer<uint8_t> ret(outSize); // too big
-
-	unsigned i = 0;
-	size_t out = 0;
-	std::array<uint8_t, 4> buf4;
-	for (auto c : input) {
-		uint8_t d = decode(c);
-		if (d == uint8_t(-1)) continue;
-		buf4[i++] = d;
-		if (i == 4) {
-			i = 0;
-			ret[out++] = char(((buf4[0] & 0xff) << 2) + ((buf4[1] & 0x30) >> 4));
-			ret[out++] = char(((buf4[1] & 0x0f) << 4) + ((buf4[2] & 0x3c) >> 2));
-			ret[out++] = char(((buf4[2] & 0x03) << 6) + ((buf4[3] & 0xff) >> 0));
-		}
-	}
-	if (i) {
-		for (auto j : xrange(i, 4u)) {
-			buf4[j] = 0;
-		}
-		std::array<uint8_t, 3> buf3;
-		buf3[0] = narrow_cast<uint8_t>(((buf4[0] & 0xff) << 2) + ((buf4[1] & 0x30) >> 4));
-		buf3[1] = narrow_cast<uint8_t>(((buf4[1] & 0x0f) << 4) + ((buf4[2] & 0x3c) >> 2));
-		buf3[2] = narrow_cast<uint8_t>(((buf4[2] & 0x03) << 6) + ((buf4[3] & 0xff) >> 0));
-		for (auto j : xrange(i - 1)) {
-			ret[out++] = buf3[j];
-		}
-	}
-
-	assert(outSize >= out);
-	ret.resize(out); // shrink to correct size
-	return ret;
-}
-
-bool decode_inplace(std::string_view input, std::span<uint8_t> output)
+// Decode 'input' into 'output'. Returns the number of decoded bytes, or
+// std::nullopt when 'output' is too small.
+[[nodiscard]] static std::optional<size_t> decodeImpl(std::string_view input, std::span<uint8_t> output)
 {
 	auto outSize = output.size();
 	unsigned i = 0;
 	size_t out = 0;
 	std::array<uint8_t, 4> buf4;
-	for (auto c : input) {
-		uint8_t d = decode(c);
+	while (!input.empty()) {
+#ifdef __SSSE3__
+		// Fast path for 16 consecutive base64 characters (no newlines or
+		// padding in between), also needs room for 16 output bytes.
+		if ((i == 0) && (input.size() >= 16) && ((out + 16) <= outSize) &&
+		    decode16(input.data(), &output[out])) {
+			input.remove_prefix(16);
+			out += 12;
+			continue;
+		}
+#endif
+		uint8_t d = decode(input.front());
+		input.remove_prefix(1);
 		if (d == uint8_t(-1)) continue;
 		buf4[i++] = d;
 		if (i == 4) {
 			i = 0;
-			if ((out + 3) > outSize) [[unlikely]] return false;
+			if ((out + 3) > outSize) [[unlikely]] return {};
 			output[out++] = char(((buf4[0] & 0xff) << 2) + ((buf4[1] & 0x30) >> 4));
 			output[out++] = char(((buf4[1] & 0x0f) << 4) + ((buf4[2] & 0x3c) >> 2));
 			output[out++] = char(((buf4[2] & 0x03) << 6) + ((buf4[3] & 0xff) >> 0));
@@ -153,12 +212,27 @@ bool decode_inplace(std::string_view input, std::span<uint8_t> output)
 		buf3[1] = narrow_cast<uint8_t>(((buf4[1] & 0x0f) << 4) + ((buf4[2] & 0x3c) >> 2));
 		buf3[2] = narrow_cast<uint8_t>(((buf4[2] & 0x03) << 6) + ((buf4[3] & 0xff) >> 0));
 		for (auto j : xrange(i - 1)) {
-			if (out == outSize) [[unlikely]] return false;
+			if (out == outSize) [[unlikely]] return {};
 			output[out++] = buf3[j];
 		}
 	}
+	return out;
+}
 
-	return out == outSize;
+MemBuffer<uint8_t> decode(std::string_view input)
+{
+	auto outSize = (input.size() * 3 + 3) / 4; // overestimation
+	MemBuffer<uint8_t> ret(outSize); // too big
+	auto out = decodeImpl(input, ret);
+	assert(out); // can't fail with this output size
+	ret.resize(*out); // shrink to correct size
+	return ret;
+}
+
+bool decode_inplace(std::string_view input, std::span<uint8_t> output)
+{
+	auto out = decodeImpl(input, output);
+	return out && (*out == output.size());
 }
 
 } // namespace Base64
@@ -1,11 +1,17 @@
 #include "DeltaBlock.hh"
 
+#include "hash_map.hh"
 #include "lz4.hh"
 #include "ranges.hh"
+#include "xxhash.hh"
 
 #include <algorithm>
 #include <bit>
 #include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <tuple>
 #include <utility>
 #if STATISTICS
@@ -14,6 +20,9 @@
 #ifdef __SSE2__
 #include <emmintrin.h>
 #endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 namespace openmsx {
 
@@ -46,8 +55,22 @@ static void storeUleb(std::vector<uint8_t>& result, size_t value)
 }
 
 
-// --- Helper functions to compare {4,8,16} bytes at aligned memory locations ---
+// --- Helper functions to compare a word of {4,8,16} bytes ---
+
+// The widest word that can be compared efficiently on this platform. SSE2 is
+// part of the x86-64 baseline and NEON of the aarch64 baseline. 32-byte AVX2
+// compares were tried, but they were not faster (this is limited by memory
+// bandwidth) and they need a stricter relative alignment of both buffers.
+static constexpr ptrdiff_t WORD_SIZE =
+#if defined(__SSE2__)
+	sizeof(__m128i);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	sizeof(uint8x16_t);
+#else
+	sizeof(void*);
+#endif
 
+// Are all N bytes at 'p' and 'q' equal?
 template<int N> bool comp(const uint8_t* p, const uint8_t* q);
 
 template<> bool comp<4>(const uint8_t* p, const uint8_t* q)
@@ -62,7 +85,7 @@ template<> bool comp<8>(const uint8_t* p, const uint8_t* q)
 	       *std::bit_cast<const uint64_t*>(q);
 }
 
-#ifdef __SSE2__
+#if defined(__SSE2__)
 template<> bool comp<16>(const uint8_t* p, const uint8_t* q)
 {
 	// Tests show that (on my machine) using 1 128-bit load is faster than
@@ -73,6 +96,36 @@ template<> bool comp<16>(const uint8_t* p, const uint8_t* q)
 	__m128i d = _mm_cmpeq_epi8(a, b);
 	return _mm_movemask_epi8(d) == 0xffff;
 }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+template<> bool comp<16>(const uint8_t* p, const uint8_t* q)
+{
+	uint8x16_t d = vceqq_u8(vld1q_u8(p), vld1q_u8(q));
+	return vminvq_u8(d) == 0xff;
+}
+#endif
+
+// Are all N bytes at 'p' and 'q' different? Only implemented with SIMD
+// instructions, these don't need to be aligned.
+#if defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+#define HAVE_DIFF_WORD 1
+template<int N> bool diff(const uint8_t* p, const uint8_t* q);
+
+#if defined(__SSE2__)
+template<> bool diff<16>(const uint8_t* p, const uint8_t* q)
+{
+	__m128i a = _mm_loadu_si128(std::bit_cast<const __m128i*>(p));
+	__m128i b = _mm_loadu_si128(std::bit_cast<const __m128i*>(q));
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) == 0;
+}
+#else
+template<> bool diff<16>(const uint8_t* p, const uint8_t* q)
+{
+	uint8x16_t d = vceqq_u8(vld1q_u8(p), vld1q_u8(q));
+	return vmaxvq_u8(d) == 0;
+}
+#endif
+#else
+#define HAVE_DIFF_WORD 0
 #endif
 
 
@@ -91,17 +144,6 @@ static std::pair<const uint8_t*, const uint8_t*> scan_mismatch(
 {
 	assert((p_end - p) == (q_end - q));
 
-	// When SSE is available, work with 16-byte words, otherwise 4 or 8
-	// bytes. This routine also benefits from AVX2 instructions. Though not
-	// all x86_64 CPUs have AVX2 (all have SSE2), so using them requires
-	// extra run-time checks and that's not worth it at this point.
-	constexpr ptrdiff_t WORD_SIZE =
-#ifdef __SSE2__
-		sizeof(__m128i);
-#else
-		sizeof(void*);
-#endif
-
 	// Region too small or
 	// both buffers are differently aligned.
 	if (((p_end - p) < (2 * WORD_SIZE)) ||
@@ -150,14 +192,21 @@ end:	return std::mismatch(p, p_end, q);
 // Like scan_mismatch(), this places a temporary sentinel in the buffer, so the
 // buffer cannot be read-only memory.
 //
-// Unlike scan_mismatch() it's less obvious how to perform this function
-// word-at-a-time (it's possible with some bit hacks). Though luckily this
-// function is also less performance critical.
-[[nodiscard]] static constexpr std::pair<const uint8_t*, const uint8_t*> scan_match(
+// Most differing regions are short, so this first checks a whole word (when
+// SIMD instructions are available) and only continues word-at-a-time while
+// all bytes in the word differ (e.g. a buffer that got completely
+// overwritten). The remainder is handled byte-at-a-time.
+[[nodiscard]] static std::pair<const uint8_t*, const uint8_t*> scan_match(
 	const uint8_t* p, const uint8_t* p_end, const uint8_t* q, const uint8_t* q_end)
 {
 	assert((p_end - p) == (q_end - q));
 
+#if HAVE_DIFF_WORD
+	while (((p_end - p) >= WORD_SIZE) && diff<WORD_SIZE>(p, q)) {
+		p += WORD_SIZE; q += WORD_SIZE;
+	}
+#endif
+
 	// Code below is functionally equivalent to:
 	//   while ((p != p_end) && (*p != *q)) { ++p; ++q; }
 	//   return {p, q};
@@ -184,10 +233,14 @@ end:	return std::mismatch(p, p_end, q);
 //   n2 number of bytes are different, and here are the bytes
 //   n3 number of bytes are equal
 //   ...
-[[nodiscard]] static std::vector<uint8_t> calcDelta(
-	const uint8_t* oldBuf, std::span<const uint8_t> newBuf)
+// The delta is first built in 'result' (a scratch buffer that keeps its
+// capacity between calls), then copied into a buffer of exactly the right
+// size.
+[[nodiscard]] static MemBuffer<uint8_t> calcDelta(
+	const uint8_t* oldBuf, std::span<const uint8_t> newBuf,
+	std::vector<uint8_t>& result)
 {
-	std::vector<uint8_t> result;
+	result.clear();
 
 	const auto* p = oldBuf;
 	const auto* q = newBuf.data();
@@ -220,8 +273,9 @@ end:	return std::mismatch(p, p_end, q);
 		if (n3 != 0) storeUleb(result, n3);
 	}
 
-	result.shrink_to_fit();
-	return result;
+	MemBuffer<uint8_t> delta(result.size());
+	copy_to_range(result, std::span{delta});
+	return delta;
 }
 
 // Apply a previously calculated 'delta' to 'oldBuf' to get 'newbuf'.
@@ -239,6 +293,111 @@ static void applyDeltaInPlace(std::span<uint8_t> buf, std::span<const uint8_t> d
 	}
 }
 
+
+// --- Background compression ---
+
+// Compressing a block takes a relatively long time. But blocks that are no
+// longer the reference block (see LastDeltaBlocks::createNew()) don't need to
+// be compressed immediately. So do that in a background thread, this avoids
+// hiccups in the emulation when taking a reverse snapshot.
+//
+// This mutex protects the content of all DeltaBlockCopy objects while they
+// switch from uncompressed to compressed representation.
+static std::mutex compressMutex;
+
+namespace {
+
+class BackgroundCompressor
+{
+public:
+	static BackgroundCompressor& instance()
+	{
+		static BackgroundCompressor compressor;
+		return compressor;
+	}
+
+	BackgroundCompressor(const BackgroundCompressor&) = delete;
+	BackgroundCompressor(BackgroundCompressor&&) = delete;
+	BackgroundCompressor& operator=(const BackgroundCompressor&) = delete;
+	BackgroundCompressor& operator=(BackgroundCompressor&&) = delete;
+
+	~BackgroundCompressor()
+	{
+		{
+			std::scoped_lock lock(mutex);
+			stop = true; // drop pending work, those blocks simply remain uncompressed
+		}
+		workCond.notify_one();
+		thread.join();
+	}
+
+	void add(std::weak_ptr<DeltaBlockCopy> block, size_t size)
+	{
+		{
+			std::scoped_lock lock(mutex);
+			queue.emplace_back(std::move(block), size);
+		}
+		workCond.notify_one();
+	}
+
+	void wait()
+	{
+		std::unique_lock lock(mutex);
+		idleCond.wait(lock, [&] { return queue.empty() && !busy; });
+	}
+
+private:
+	BackgroundCompressor() = default;
+
+	void loop()
+	{
+		std::unique_lock lock(mutex);
+		while (true) {
+			workCond.wait(lock, [&] { return stop || !queue.empty(); });
+			if (stop) return;
+			auto [weak, size] = std::move(queue.front());
+			queue.pop_front();
+			busy = true;
+			lock.unlock();
+			if (auto block = weak.lock()) {
+				block->compress(size);
+			} // possibly this was the last reference to the block
+			lock.lock();
+			busy = false;
+			if (queue.empty()) idleCond.notify_all();
+		}
+	}
+
+private:
+	std::mutex mutex;
+	std::condition_variable workCond;
+	std::condition_variable idleCond;
+	std::deque<std::pair<std::weak_ptr<DeltaBlockCopy>, size_t>> queue; // protected by 'mutex'
+	bool busy = false; // protected by 'mutex'
+	bool stop = false; // protected by 'mutex'
+	std::thread thread{[this] { loop(); }}; // must be last
+};
+
+} // namespace
+
+
+// --- Process-wide block store ---
+
+// All DeltaBlockCopy objects created via LastDeltaBlocks, indexed by the hash
+// of their content. On a hash collision only the most recent block is kept in
+// the store (that only means the older block won't be shared anymore). Blocks
+// remove themselves on destruction. Protected by 'compressMutex'.
+[[nodiscard]] static hash_map<uint32_t, DeltaBlockCopy*>& getBlockStore()
+{
+	static hash_map<uint32_t, DeltaBlockCopy*> store;
+	return store;
+}
+
+[[nodiscard]] static uint32_t calcHash(std::span<const uint8_t> data)
+{
+	return xxhash_impl<false>(data.data(), data.size());
+}
+
 #if STATISTICS
 
 // class DeltaBlock
@@ -256,6 +415,7 @@ DeltaBlock::~DeltaBlock()
 
 DeltaBlockCopy::DeltaBlockCopy(std::span<const uint8_t> data)
 	: block(data.size())
+	, blockSize(data.size())
 {
 #ifdef DEBUG
 	sha1 = SHA1::calc(data);
@@ -270,8 +430,20 @@ DeltaBlockCopy::DeltaBlockCopy(std::span<const uint8_t> data)
 #endif
 }
 
+DeltaBlockCopy::~DeltaBlockCopy()
+{
+	std::scoped_lock lock(compressMutex);
+	if (inStore) {
+		auto& store = getBlockStore();
+		if (auto* p = lookup(store, hash); p && (*p == this)) {
+			store.erase(hash);
+		}
+	}
+}
+
 void DeltaBlockCopy::apply(std::span<uint8_t> dst) const
 {
+	std::scoped_lock lock(compressMutex);
 	if (compressed()) {
 		LZ4::decompress(block.data(), dst.data(), int(compressedSize), int(dst.size()));
 	} else {
@@ -294,9 +466,18 @@ void DeltaBlockCopy::compress(size_t size)
 		// compression isn't beneficial
 		return;
 	}
-	compressedSize = dstLen;
-	std::swap(block, buf2);
-	block.resize(compressedSize); // shrink to fit
+	buf2.resize(dstLen); // shrink to fit
+	{
+		// Possibly apply() is concurrently executed in another thread.
+		std::scoped_lock lock(compressMutex);
+		if (refUsers != 0) {
+			// (Again) used as reference by some LastDeltaBlocks,
+			// that requires the uncompressed data.
+			return;
+		}
+		std::swap(block, buf2);
+		compressedSize = dstLen;
+	}
 	assert(compressed());
 #ifdef DEBUG
 	MemBuffer<uint8_t> buf3(size);
@@ -312,20 +493,36 @@ void DeltaBlockCopy::compress(size_t size)
 #endif
 }
 
+size_t DeltaBlockCopy::getMemorySize() const
+{
+	std::scoped_lock lock(compressMutex); // possibly compressed concurrently
+	return compressed() ? compressedSize : blockSize;
+}
+
 const uint8_t* DeltaBlockCopy::getData()
 {
 	assert(!compressed());
 	return block.data();
 }
 
+void DeltaBlockCopy::compressInBackground(const std::shared_ptr<DeltaBlockCopy>& block, size_t size)
+{
+	BackgroundCompressor::instance().add(block, size);
+}
+
+void DeltaBlockCopy::waitForBackgroundCompression()
+{
+	BackgroundCompressor::instance().wait();
+}
+
 
 // class DeltaBlockDiff
 
 DeltaBlockDiff::DeltaBlockDiff(
 		std::shared_ptr<DeltaBlockCopy> prev_,
-		std::span<const uint8_t> data)
+		std::span<const uint8_t> data, std::vector<uint8_t>& scratch)
 	: prev(std::move(prev_))
-	, delta(calcDelta(prev->getData(), data))
+	, delta(calcDelta(prev->getData(), data, scratch))
 {
 #ifdef DEBUG
 	sha1 = SHA1::calc(data);
@@ -359,6 +556,51 @@ size_t DeltaBlockDiff::getDeltaSize() const
 
 // class LastDeltaBlocks
 
+// Returns a block with the given content that can be used as reference block:
+// an existing block from the store, or else a new block (which is added to the
+// store). Must be paired with releaseCopy().
+std::shared_ptr<DeltaBlockCopy> LastDeltaBlocks::acquireCopy(std::span<const uint8_t> data)
+{
+	auto hash = calcHash(data);
+	auto& store = getBlockStore();
+	// Declared outside the locked scope: when this turns out to be the
+	// last reference, the destructor locks the mutex again.
+	std::shared_ptr<DeltaBlockCopy> candidate;
+	{
+		std::scoped_lock lock(compressMutex);
+		if (auto* p = lookup(store, hash)) {
+			// Possibly being destroyed (in another thread), then
+			// lock() returns nullptr.
+			candidate = (*p)->weak_from_this().lock();
+			if (candidate && !candidate->compressed() &&
+			    (candidate->blockSize == data.size()) &&
+			    std::ranges::equal(std::span{candidate->block.data(), data.size()}, data)) {
+				++candidate->refUsers;
+				return candidate;
+			}
+		}
+	}
+	auto b = std::make_shared<DeltaBlockCopy>(data);
+	std::scoped_lock lock(compressMutex);
+	b->refUsers = 1;
+	b->hash = hash;
+	b->inStore = true;
+	store[hash] = b.get(); // possibly replaces an entry with the same hash
+	return b;
+}
+
+// This LastDeltaBlocks no longer uses 'block' as reference. When no other
+// LastDeltaBlocks uses it, it can be compressed.
+void LastDeltaBlocks::releaseCopy(const std::shared_ptr<DeltaBlockCopy>& block, size_t size)
+{
+	{
+		std::scoped_lock lock(compressMutex);
+		assert(block->refUsers > 0);
+		if (--block->refUsers != 0) return;
+	}
+	DeltaBlockCopy::compressInBackground(block, size);
+}
+
 std::shared_ptr<DeltaBlock> LastDeltaBlocks::createNew(
 		const void* id, std::span<const uint8_t> data)
 {
@@ -373,15 +615,21 @@ std::shared_ptr<DeltaBlock> LastDeltaBlocks::createNew(
 	assert(it->size == size);
 
 	auto ref = it->ref.lock();
+	if (ref && std::ranges::equal(std::span{ref->getData(), size}, data)) {
+		// Unchanged since the reference block was created (this is
+		// very common for the pages of a large RAM): share it.
+		it->last = ref;
+		return ref;
+	}
 	if (it->accSize >= size || !ref) {
 		if (ref) {
 			// We will switch to a new DeltaBlockCopy object. So
 			// now is a good time to compress the old one.
-			ref->compress(size);
+			releaseCopy(ref, size);
 		}
 		// Heuristic: create a new block when too many small
 		// differences have accumulated.
-		auto b = std::make_shared<DeltaBlockCopy>(data);
+		auto b = acquireCopy(data);
 		it->ref = b;
 		it->last = b;
 		it->accSize = 0;
@@ -389,7 +637,7 @@ std::shared_ptr<DeltaBlock> LastDeltaBlocks::createNew(
 	} else {
 		// Create diff based on earlier reference block.
 		// Reference remains unchanged.
-		auto b = std::make_shared<DeltaBlockDiff>(ref, data);
+		auto b = std::make_shared<DeltaBlockDiff>(ref, data, deltaScratch);
 		it->last = b;
 		it->accSize += b->getDeltaSize();
 		return b;
@@ -409,7 +657,8 @@ std::shared_ptr<DeltaBlock> LastDeltaBlocks::createNullDiff(
 
 	auto last = it->last.lock();
 	if (!last) {
-		auto b = std::make_shared<DeltaBlockCopy>(data);
+		if (auto ref = it->ref.lock()) releaseCopy(ref, size);
+		auto b = acquireCopy(data);
 		it->ref = b;
 		it->last = b;
 		it->accSize = 0;
@@ -426,7 +675,7 @@ void LastDeltaBlocks::clear()
 {
 	for (const Info& info : infos) {
 		if (auto ref = info.ref.lock()) {
-			ref->compress(info.size);
+			releaseCopy(ref, info.size);
 		}
 	}
 	infos.clear();
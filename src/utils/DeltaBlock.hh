@@ -24,6 +24,14 @@ public:
 	virtual ~DeltaBlock() = default;
 #endif
 	virtual void apply(std::span<uint8_t> dst) const = 0;
+	/** The size of the (uncompressed) data, apply() should be called
+	  * with a buffer of exactly this size. */
+	[[nodiscard]] virtual size_t getSize() const = 0;
+	/** The amount of memory used by this block itself. That excludes the
+	  * block it's based on, see getReference(). */
+	[[nodiscard]] virtual size_t getMemorySize() const = 0;
+	/** The block this block is based on (it shares ownership), or nullptr. */
+	[[nodiscard]] virtual const DeltaBlock* getReference() const { return nullptr; }
 
 protected:
 	DeltaBlock() = default;
@@ -42,44 +50,90 @@ protected:
 
 
 class DeltaBlockCopy final : public DeltaBlock
+                           , public std::enable_shared_from_this<DeltaBlockCopy>
 {
 public:
 	explicit DeltaBlockCopy(std::span<const uint8_t> data);
+	~DeltaBlockCopy() override;
 	void apply(std::span<uint8_t> dst) const override;
+	[[nodiscard]] size_t getSize() const override { return blockSize; }
+	[[nodiscard]] size_t getMemorySize() const override;
 	void compress(size_t size);
 	[[nodiscard]] const uint8_t* getData();
 
+	/** Like compress(), but executed later in a background thread. It's
+	  * fine if the block gets destroyed before that happens.
+	  * Must only be used on blocks that are no longer the reference for
+	  * new DeltaBlockDiff objects (getData() requires uncompressed data).
+	  */
+	static void compressInBackground(const std::shared_ptr<DeltaBlockCopy>& block, size_t size);
+	/** Wait till all pending background compressions are done. */
+	static void waitForBackgroundCompression();
+
 private:
 	[[nodiscard]] bool compressed() const { return compressedSize != 0; }
 
 	MemBuffer<uint8_t> block;
+	size_t blockSize; // uncompressed
 	size_t compressedSize = 0;
+
+	// Used by LastDeltaBlocks, protected by the same mutex as 'block'.
+	friend class LastDeltaBlocks;
+	int refUsers = 0; // number of LastDeltaBlocks using this as reference
+	uint32_t hash = 0; // only valid when 'inStore'
+	bool inStore = false; // registered in the process-wide block store
 };
 
 
 class DeltaBlockDiff final : public DeltaBlock
 {
 public:
+	/** 'scratch' is only used during construction, passing the same
+	  * vector for each block avoids most allocations. */
 	DeltaBlockDiff(std::shared_ptr<DeltaBlockCopy> prev_,
-	               std::span<const uint8_t> data);
+	               std::span<const uint8_t> data,
+	               std::vector<uint8_t>& scratch);
 	void apply(std::span<uint8_t> dst) const override;
+	[[nodiscard]] size_t getSize() const override { return prev->getSize(); }
+	[[nodiscard]] size_t getMemorySize() const override { return delta.size(); }
+	[[nodiscard]] const DeltaBlock* getReference() const override { return prev.get(); }
 	[[nodiscard]] size_t getDeltaSize() const;
 
 private:
 	const std::shared_ptr<DeltaBlockCopy> prev;
-	const std::vector<uint8_t> delta; // TODO could be tweaked to use OutputBuffer
+	const MemBuffer<uint8_t> delta;
 };
 
 
+/** Creates DeltaBlock objects for successive versions of the same memory
+  * blocks (e.g. for the successive reverse snapshots of one machine).
+  *
+  * The DeltaBlockCopy objects created by all LastDeltaBlocks instances are
+  * registered (by content hash) in a process-wide store. So identical blocks
+  * (zero-filled RAM, SRAM initialized from the same ROM, the memory of
+  * several instances of the same machine, ...) are only stored once.
+  */
 class LastDeltaBlocks
 {
 public:
+	LastDeltaBlocks() = default;
+	LastDeltaBlocks(const LastDeltaBlocks&) = delete;
+	LastDeltaBlocks(LastDeltaBlocks&&) = delete;
+	LastDeltaBlocks& operator=(const LastDeltaBlocks&) = delete;
+	LastDeltaBlocks& operator=(LastDeltaBlocks&&) = delete;
+	~LastDeltaBlocks() { clear(); }
+
 	[[nodiscard]] std::shared_ptr<DeltaBlock> createNew(
 		const void* id, std::span<const uint8_t> data);
 	[[nodiscard]] std::shared_ptr<DeltaBlock> createNullDiff(
 		const void* id, std::span<const uint8_t> data);
 	void clear();
 
+private:
+	[[nodiscard]] static std::shared_ptr<DeltaBlockCopy> acquireCopy(
+		std::span<const uint8_t> data);
+	static void releaseCopy(const std::shared_ptr<DeltaBlockCopy>& block, size_t size);
+
 private:
 	struct Info {
 		Info(const void* id_, size_t size_)
@@ -93,6 +147,7 @@ private:
 	};
 
 	std::vector<Info> infos;
+	std::vector<uint8_t> deltaScratch; // see DeltaBlockDiff
 };
 
 } // namespace openmsx
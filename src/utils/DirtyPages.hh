@@ -0,0 +1,81 @@
+#ifndef DIRTYPAGES_HH
+#define DIRTYPAGES_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace openmsx {
+
+/** Keeps track of which pages of a block of memory were written to.
+  *
+  * Instead of a single dirty bit per page, each page remembers the epoch in
+  * which it was last written. A consumer (e.g. the reverse snapshots or a
+  * memory viewer) calls checkpoint() after it processed the memory, and keeps
+  * the returned epoch. Later it can ask which pages were written since that
+  * epoch. Like this, multiple independent consumers can share the same
+  * administration, and a write is still only a single store.
+  *
+  * Initially all pages are dirty (also for a consumer that never made a
+  * checkpoint, it uses epoch 0).
+  */
+class DirtyPages
+{
+public:
+	using Epoch = uint64_t; // can't realistically overflow
+	static constexpr size_t PAGE_BITS = 12;
+	static constexpr size_t PAGE_SIZE = size_t(1) << PAGE_BITS; // 4kB
+
+	explicit DirtyPages(size_t size)
+		: stamps((size + PAGE_SIZE - 1) >> PAGE_BITS, 1) {}
+
+	[[nodiscard]] size_t numPages() const { return stamps.size(); }
+
+	void markDirty(size_t addr) {
+		assert((addr >> PAGE_BITS) < stamps.size());
+		stamps[addr >> PAGE_BITS] = epoch;
+	}
+	void markDirty(size_t addr, size_t num) {
+		if (num == 0) return;
+		auto first = addr >> PAGE_BITS;
+		auto last = (addr + num - 1) >> PAGE_BITS;
+		assert(last < stamps.size());
+		std::fill(stamps.begin() + first, stamps.begin() + last + 1, epoch);
+	}
+	void markAllDirty() {
+		std::ranges::fill(stamps, epoch);
+	}
+
+	/** Start a new epoch. Pages written before this call are not dirty
+	  * relative to the returned epoch, pages written after this call are.
+	  */
+	[[nodiscard]] Epoch checkpoint() { return ++epoch; }
+
+	/** Was the given page written to since the given epoch? */
+	[[nodiscard]] bool isDirty(size_t page, Epoch since) const {
+		assert(page < stamps.size());
+		return stamps[page] >= since;
+	}
+
+	/** Was any byte in the address range [addr, addr + num) written to
+	  * since the given epoch? Addresses past the end are ignored. */
+	[[nodiscard]] bool isRangeDirty(size_t addr, size_t num, Epoch since) const {
+		if (num == 0) return false;
+		auto first = addr >> PAGE_BITS;
+		auto last = std::min((addr + num - 1) >> PAGE_BITS, stamps.size() - 1);
+		for (auto page = first; page <= last; ++page) {
+			if (stamps[page] >= since) return true;
+		}
+		return false;
+	}
+
+private:
+	std::vector<Epoch> stamps; // per page: epoch of the last write
+	Epoch epoch = 1;
+};
+
+} // namespace openmsx
+
+#endif
@@ -29,16 +29,28 @@ public:
 	[[nodiscard]] uint32_t getDivisor() const { return divisor; }
 
 	[[nodiscard]] uint32_t div(uint64_t dividend) const
+	{
+		uint64_t result = div64(dividend);
+	#ifdef DEBUG
+		// we don't even want this overhead in devel builds
+		assert(result == uint32_t(result));
+	#endif
+		return uint32_t(result);
+	}
+
+	/** Same as div(), but the quotient doesn't need to fit in 32 bits
+	  * (the magic constants are valid for the full 64-bit range). */
+	[[nodiscard]] uint64_t div64(uint64_t dividend) const
 	{
 	#if defined __x86_64 && !defined _MSC_VER
 		auto t = narrow_cast<uint64_t>((__uint128_t(dividend) * m + a) >> 64);
-		return narrow_cast<uint32_t>(t >> s);
+		return t >> s;
 	#else
 		return divInC(dividend);
 	#endif
 	}
 
-	[[nodiscard]] uint32_t divInC(uint64_t dividend) const
+	[[nodiscard]] uint64_t divInC(uint64_t dividend) const
 	{
 		uint64_t t1 = uint64_t(uint32_t(dividend)) * uint32_t(m);
 		uint64_t t2 = (dividend >> 32) * uint32_t(m);
@@ -50,12 +62,7 @@ public:
 		uint64_t s3 = uint64_t(uint32_t(s2)) + uint32_t(t3);
 		uint64_t s4 = (s3 >> 32) + (s2 >> 32) + (t3 >> 32) + t4;
 
-		uint64_t result = s4 >> s;
-	#ifdef DEBUG
-		// we don't even want this overhead in devel builds
-		assert(result == uint32_t(result));
-	#endif
-		return uint32_t(result);
+		return s4 >> s;
 	}
 
 	[[nodiscard]] std::pair<uint32_t, uint32_t> divMod(uint64_t dividend) const
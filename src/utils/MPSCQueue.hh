@@ -0,0 +1,81 @@
+#ifndef MPSCQUEUE_HH
+#define MPSCQUEUE_HH
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+// MPSCQueue
+//
+// A lock-free multi-producer single-consumer queue:
+// - Any thread can push() elements, concurrently. Pushing never blocks
+//   (except in the memory allocator).
+// - One thread (the consumer) takes all queued elements at once with
+//   popAll(). Elements are returned in the order they were pushed (for
+//   elements pushed by the same thread; there's no well defined order
+//   between different threads anyway).
+//
+// Internally this is a singly linked list used as a stack (push() is a
+// compare-and-swap of the head pointer). popAll() atomically detaches the
+// whole list and reverses it. Taking all elements at once (instead of one
+// by one) avoids the ABA problem of a lock-free stack pop.
+
+template<typename T>
+class MPSCQueue
+{
+public:
+	MPSCQueue() = default;
+	MPSCQueue(const MPSCQueue&) = delete;
+	MPSCQueue(MPSCQueue&&) = delete;
+	MPSCQueue& operator=(const MPSCQueue&) = delete;
+	MPSCQueue& operator=(MPSCQueue&&) = delete;
+
+	~MPSCQueue() {
+		deleteList(head.load(std::memory_order_acquire));
+	}
+
+	// Can be called from any thread.
+	void push(T&& t) {
+		auto* node = new Node{std::move(t), head.load(std::memory_order_relaxed)};
+		while (!head.compare_exchange_weak(node->next, node,
+		                                   std::memory_order_release,
+		                                   std::memory_order_relaxed)) {
+			// 'node->next' was updated, try again
+		}
+	}
+
+	// Only call this from the consumer thread. Appends all queued elements
+	// (oldest first) to 'out'.
+	void popAll(std::vector<T>& out) {
+		Node* list = head.exchange(nullptr, std::memory_order_acquire);
+		auto oldSize = out.size();
+		for (Node* n = list; n; n = n->next) {
+			out.push_back(std::move(n->value));
+		}
+		std::reverse(out.begin() + oldSize, out.end());
+		deleteList(list);
+	}
+
+	// Only a hint when called from a producer thread.
+	[[nodiscard]] bool empty() const {
+		return head.load(std::memory_order_acquire) == nullptr;
+	}
+
+private:
+	struct Node {
+		T value;
+		Node* next;
+	};
+
+	static void deleteList(Node* n) {
+		while (n) {
+			delete std::exchange(n, n->next);
+		}
+	}
+
+private:
+	std::atomic<Node*> head = nullptr;
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include "MemoryOps.hh"
 
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cstddef>
 #include <cstdlib>
@@ -49,6 +50,25 @@ public:
 	{
 	}
 
+	/** Construct a zero-initialized memory buffer of given size.
+	  * Unlike filling a MemBuffer(size) with zeros, this (typically) doesn't
+	  * commit any memory for large buffers: the OS hands out zero-filled
+	  * pages only when they are first written.
+	  */
+	[[nodiscard]] static MemBuffer zeroed(size_t size)
+	{
+		MemBuffer result;
+		if constexpr (SIMPLE_MALLOC) {
+			result.dat = static_cast<T*>(calloc(size, sizeof(T)));
+			if (!result.dat && size) throw std::bad_alloc();
+		} else {
+			result.dat = static_cast<T*>(my_malloc(size * sizeof(T)));
+			std::fill_n(std::bit_cast<unsigned char*>(result.dat), size * sizeof(T), 0);
+		}
+		result.sz = size;
+		return result;
+	}
+
 	/** Move constructor. */
 	MemBuffer(MemBuffer&& other) noexcept
 		: dat(other.dat)
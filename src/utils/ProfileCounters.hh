@@ -87,6 +87,7 @@ template<bool ENABLED, typename ENUM>
 class ProfileCounters
 {
 public:
+	ProfileCounters() = default;
 	ProfileCounters(const ProfileCounters&) = delete;
 	ProfileCounters(ProfileCounters&&) = delete;
 	ProfileCounters& operator=(const ProfileCounters&) = delete;
@@ -56,6 +56,26 @@ void OutputBuffer::insertN(const void* __restrict data, size_t len)
 	}
 }
 
+OutputBuffer::OutputBuffer(MemBuffer<uint8_t>&& storage)
+	: buf(storage.empty() ? MemBuffer<uint8_t>(lastSize) : std::move(storage))
+	, end(buf.data())
+{
+}
+
+MemBuffer<uint8_t> OutputBuffer::copyData() const
+{
+	auto data = std::span<const uint8_t>(buf.data(), getPosition());
+	MemBuffer<uint8_t> result(data.size());
+	std::ranges::copy(data, result.data());
+	return result;
+}
+
+MemBuffer<uint8_t> OutputBuffer::releaseStorage() &&
+{
+	end = nullptr;
+	return std::move(buf);
+}
+
 MemBuffer<uint8_t> OutputBuffer::release() &&
 {
 	// Deallocate unused buffer space.
@@ -33,6 +33,12 @@ public:
 	 */
 	OutputBuffer();
 
+	/** Create an empty output buffer that (re)uses the given memory. See
+	  * copyData() and releaseStorage(). If 'storage' is empty this is the
+	  * same as the default constructor.
+	  */
+	explicit OutputBuffer(MemBuffer<uint8_t>&& storage);
+
 	/** Insert data at the end of this buffer.
 	  * This will automatically grow this buffer.
 	  */
@@ -154,6 +160,18 @@ public:
 	 */
 	[[nodiscard]] MemBuffer<uint8_t> release() &&;
 
+	/** Return a copy of the content (allocated with exactly the right
+	  * size). Together with releaseStorage() this allows to reuse the
+	  * (grown) memory of this buffer for a next OutputBuffer, so that
+	  * producing a result only needs a single allocation.
+	  */
+	[[nodiscard]] MemBuffer<uint8_t> copyData() const;
+
+	/** Release the full allocated memory (not only the used part), to
+	  * be passed to the constructor of a next OutputBuffer.
+	  */
+	[[nodiscard]] MemBuffer<uint8_t> releaseStorage() &&;
+
 private:
 	void insertGrow(const void* __restrict data, size_t len);
 	[[nodiscard]] uint8_t* allocateGrow(size_t len);
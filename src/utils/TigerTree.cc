@@ -3,11 +3,18 @@
 #include "Math.hh"
 #include "MemBuffer.hh"
 #include "ScopedAssign.hh"
+#include "ThreadPool.hh"
+#include "ranges.hh"
 #include "tiger.hh"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <map>
+#include <optional>
 #include <span>
+#include <system_error>
+#include <thread>
 
 namespace openmsx {
 
@@ -54,9 +61,79 @@ TigerTree::TigerTree(TTData& data_, size_t dataSize_, const std::string& name)
 
 const TigerHash& TigerTree::calcHash(const std::function<void(size_t, size_t)>& progressCallback)
 {
+	calcLeafHashes(progressCallback);
 	return calcHash(getTop(), progressCallback);
 }
 
+void TigerTree::calcLeafHashes(const std::function<void(size_t, size_t)>& progressCallback)
+{
+	// Hashing the leaves is by far the most expensive part (e.g. for a
+	// multi-GB hard disk image). Fetch the data for a batch of (complete)
+	// leaves sequentially (TTData is not reentrant), then hash the batch in
+	// parallel, each part with the multi-buffer tiger_leaves(). The
+	// remaining nodes (interior nodes and a partial last leaf) are
+	// calculated by the recursive calcHash().
+	static constexpr size_t BATCH_SIZE = 256; // leaves
+	static constexpr size_t PART_SIZE = 16; // leaves per ThreadPool part
+
+	size_t numFull = dataSize / BLOCK_SIZE;
+	size_t numInvalid = 0;
+	for (size_t block = 0; block < numFull; ++block) {
+		if (!entry.nodes[getLeaf(block).n].valid) ++numInvalid;
+	}
+	if (numInvalid == 0) return;
+
+	// Only worth it when there's a lot to do, not e.g. after a few sectors
+	// were written.
+	std::optional<ThreadPool> pool;
+	if (auto numThreads = std::thread::hardware_concurrency();
+	    (numThreads > 1) && (numInvalid >= 4 * BATCH_SIZE)) {
+		try {
+			pool.emplace(numThreads - 1);
+		} catch (std::system_error&) {
+			// fall back to sequential execution
+		}
+	}
+
+	MemBuffer<uint8_t> buffer(BATCH_SIZE * BLOCK_SIZE);
+	std::array<size_t, BATCH_SIZE> blocks;
+	std::array<TigerHash, BATCH_SIZE> hashes;
+	size_t block = 0;
+	while (true) {
+		size_t num = 0;
+		for (/**/; (block < numFull) && (num < BATCH_SIZE); ++block) {
+			if (entry.nodes[getLeaf(block).n].valid) continue;
+			const auto* d = data.getData(block * BLOCK_SIZE, BLOCK_SIZE);
+			copy_to_range(std::span{d, BLOCK_SIZE}, buffer.subspan(num * BLOCK_SIZE, BLOCK_SIZE));
+			blocks[num++] = block;
+		}
+		if (num == 0) break;
+
+		auto hashPart = [&](size_t part) {
+			size_t first = part * PART_SIZE;
+			size_t n = std::min(PART_SIZE, num - first);
+			tiger_leaves(buffer.subspan(first * BLOCK_SIZE, n * BLOCK_SIZE),
+			             subspan(hashes, first, n));
+		};
+		size_t numParts = (num + PART_SIZE - 1) / PART_SIZE;
+		if (pool) {
+			pool->parallelFor(numParts, hashPart);
+		} else {
+			for (size_t part = 0; part < numParts; ++part) hashPart(part);
+		}
+
+		for (size_t i = 0; i < num; ++i) {
+			auto& nod = entry.nodes[getLeaf(blocks[i]).n];
+			nod.hash = hashes[i];
+			nod.valid = true;
+		}
+		entry.numNodesValid += num;
+		if (progressCallback) {
+			progressCallback(entry.numNodesValid, entry.nodes.size());
+		}
+	}
+}
+
 void TigerTree::notifyChange(size_t offset, size_t len, time_t time)
 {
 	entry.time = time;
@@ -81,6 +158,40 @@ void TigerTree::notifyChange(size_t offset, size_t len, time_t time)
 	} while (++first <= last);
 }
 
+size_t TigerTree::getNumLeaves() const
+{
+	return (entry.nodes.size() + 1) / 2;
+}
+
+bool TigerTree::allLeavesValid() const
+{
+	for (size_t n = 0; n < entry.nodes.size(); n += 2) {
+		if (!entry.nodes[n].valid) return false;
+	}
+	return true;
+}
+
+void TigerTree::getLeafHashes(std::span<TigerHash> out) const
+{
+	assert(out.size() == getNumLeaves());
+	for (size_t i = 0; i < out.size(); ++i) {
+		const auto& nod = entry.nodes[getLeaf(i).n];
+		assert(nod.valid);
+		out[i] = nod.hash;
+	}
+}
+
+void TigerTree::setLeafHashes(std::span<const TigerHash> in)
+{
+	assert(in.size() == getNumLeaves());
+	for (size_t n = 0; n < entry.nodes.size(); ++n) {
+		auto& nod = entry.nodes[n];
+		nod.valid = (n & 1) == 0;
+		if (nod.valid) nod.hash = in[n / 2];
+	}
+	entry.numNodesValid = in.size();
+}
+
 const TigerHash& TigerTree::calcHash(Node node, const std::function<void(size_t, size_t)>& progressCallback)
 {
 	auto n = node.n;
@@ -31,6 +31,7 @@
 #include <cstdint>
 #include <ctime>
 #include <functional>
+#include <span>
 #include <string>
 
 namespace openmsx {
@@ -90,6 +91,20 @@ public:
 	 */
 	void notifyChange(size_t offset, size_t len, time_t time);
 
+	/** The leaf hashes (one per BLOCK_SIZE bytes of input) determine all
+	 * other nodes in the tree. These methods allow to store them outside
+	 * of this class (e.g. on disk), so that a later session can skip the
+	 * (expensive) leaf calculations.
+	 */
+	[[nodiscard]] size_t getNumLeaves() const;
+	[[nodiscard]] bool allLeavesValid() const;
+	/** Requires allLeavesValid() and out.size() == getNumLeaves(). */
+	void getLeafHashes(std::span<TigerHash> out) const;
+	/** Replace all leaf hashes, the interior nodes will be recalculated
+	 * on the next calcHash() call. Requires in.size() == getNumLeaves().
+	 */
+	void setLeafHashes(std::span<const TigerHash> in);
+
 private:
 	// functions to navigate in binary tree
 	struct Node {
@@ -104,6 +119,7 @@ private:
 	[[nodiscard]] Node getRightChild(Node node) const;
 
 	[[nodiscard]] const TigerHash& calcHash(Node node, const std::function<void(size_t, size_t)>& progressCallback);
+	void calcLeafHashes(const std::function<void(size_t, size_t)>& progressCallback);
 
 private:
 	TTData& data;
@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <cstdlib>
 #include <iterator>
+#include <ranges>
 #include <utility>
 
 /** Random access iterator for circular_buffer. */
@@ -352,6 +353,19 @@ public:
 		for (auto& e : list) push_back(e);
 	}
 
+	/** Like calling push_back() for each element, but grows the buffer
+	  * (at most) once. */
+	template<std::ranges::sized_range R>
+	void append_range(R&& range) {
+		auto n = std::ranges::size(range);
+		if (buf.reserve() < n) {
+			auto newCapacity = std::max(4uz, buf.capacity() * 2);
+			while (newCapacity < (buf.size() + n)) newCapacity *= 2;
+			buf.set_capacity(newCapacity);
+		}
+		for (auto&& e : range) buf.push_back(std::forward<decltype(e)>(e));
+	}
+
 	T pop_front() {
 		T t = std::move(buf.front());
 		buf.pop_front();
@@ -23,6 +23,7 @@ A million repetitions of "a"
 #include "MSXException.hh"
 
 #include "endian.hh"
+#include "inline.hh"
 #include "narrow.hh"
 #include "ranges.hh"
 #include "xrange.hh"
@@ -31,9 +32,17 @@ A million repetitions of "a"
 #include <bit>
 #include <cassert>
 #include <cstring>
+#include <utility>
 #ifdef __SSE2__
 #include <emmintrin.h> // SSE2
 #endif
+#if defined(__SHA__) && defined(__SSSE3__)
+#include <immintrin.h> // SHA extensions
+#define SHA1_X86_SHA
+#elif defined(__ARM_NEON) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#include <arm_neon.h> // crypto extensions
+#define SHA1_ARM_SHA
+#endif
 
 namespace openmsx {
 
@@ -96,6 +105,106 @@ WorkspaceBlock::WorkspaceBlock(std::span<const uint8_t, 64> buffer)
 	memcpy(data.data(), buffer.data(), sizeof(data));
 }
 
+#ifdef SHA1_X86_SHA
+// Process one block with the x86 SHA extensions. Each step does 4 rounds,
+// 'msg' holds the (big endian) message words of the next 4 steps.
+struct ShaNi {
+	__m128i abcd, e0, eNext;
+	__m128i msg[4]; // not std::array, that triggers -Wignored-attributes
+};
+
+template<int G>
+ALWAYS_INLINE void shaNiStep(ShaNi& s, std::span<const uint8_t, 64> buffer)
+{
+	if constexpr (G < 4) {
+		const __m128i mask = _mm_set_epi64x(0x0001020304050607, 0x08090a0b0c0d0e0f);
+		s.msg[G] = _mm_shuffle_epi8(_mm_loadu_si128(std::bit_cast<const __m128i*>(&buffer[16 * G])), mask);
+	}
+	const auto& m = s.msg[G % 4];
+	__m128i e = (G == 0) ? _mm_add_epi32(s.e0, m) : _mm_sha1nexte_epu32(s.eNext, m);
+	s.eNext = s.abcd;
+	if constexpr (3 <= G && G <= 18) s.msg[(G + 1) % 4] = _mm_sha1msg2_epu32(s.msg[(G + 1) % 4], m);
+	s.abcd = _mm_sha1rnds4_epu32(s.abcd, e, G / 5);
+	if constexpr (1 <= G && G <= 16) s.msg[(G + 3) % 4] = _mm_sha1msg1_epu32(s.msg[(G + 3) % 4], m);
+	if constexpr (2 <= G && G <= 17) s.msg[(G + 2) % 4] = _mm_xor_si128(s.msg[(G + 2) % 4], m);
+}
+
+template<int... G>
+ALWAYS_INLINE void shaNiSteps(ShaNi& s, std::span<const uint8_t, 64> buffer, std::integer_sequence<int, G...>)
+{
+	(shaNiStep<G>(s, buffer), ...);
+}
+
+static void transformShaNi(std::array<uint32_t, 5>& state, std::span<const uint8_t, 64> buffer)
+{
+	ShaNi s;
+	s.abcd = _mm_shuffle_epi32(_mm_loadu_si128(std::bit_cast<const __m128i*>(state.data())), 0x1B);
+	s.e0 = _mm_set_epi32(narrow_cast<int>(state[4]), 0, 0, 0);
+	const __m128i abcdSave = s.abcd;
+
+	shaNiSteps(s, buffer, std::make_integer_sequence<int, 20>{});
+
+	__m128i e = _mm_sha1nexte_epu32(s.eNext, s.e0);
+	__m128i abcd = _mm_shuffle_epi32(_mm_add_epi32(s.abcd, abcdSave), 0x1B);
+	_mm_storeu_si128(std::bit_cast<__m128i*>(state.data()), abcd);
+	state[4] = uint32_t(_mm_cvtsi128_si32(_mm_srli_si128(e, 12)));
+}
+#endif
+
+#ifdef SHA1_ARM_SHA
+// Process one block with the ARMv8 crypto extensions. Each step does 4
+// rounds, 'msg' holds the message words of the next 4 steps.
+struct ArmCe {
+	uint32x4_t abcd;
+	uint32_t e;
+	uint32x4_t msg[4];
+};
+
+template<int G>
+ALWAYS_INLINE void armCeStep(ArmCe& s)
+{
+	static constexpr std::array<uint32_t, 4> K = {0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6};
+	auto& m = s.msg[G % 4];
+	uint32x4_t wk = vaddq_u32(m, vdupq_n_u32(K[G / 5]));
+	uint32_t eNext = vsha1h_u32(vgetq_lane_u32(s.abcd, 0));
+	if constexpr (G < 5) {
+		s.abcd = vsha1cq_u32(s.abcd, s.e, wk);
+	} else if constexpr (10 <= G && G < 15) {
+		s.abcd = vsha1mq_u32(s.abcd, s.e, wk);
+	} else {
+		s.abcd = vsha1pq_u32(s.abcd, s.e, wk);
+	}
+	s.e = eNext;
+	if constexpr (G < 16) {
+		m = vsha1su1q_u32(vsha1su0q_u32(m, s.msg[(G + 1) % 4], s.msg[(G + 2) % 4]),
+		                  s.msg[(G + 3) % 4]);
+	}
+}
+
+template<int... G>
+ALWAYS_INLINE void armCeSteps(ArmCe& s, std::integer_sequence<int, G...>)
+{
+	(armCeStep<G>(s), ...);
+}
+
+static void transformArmCe(std::array<uint32_t, 5>& state, std::span<const uint8_t, 64> buffer)
+{
+	auto load = [&](int i) {
+		return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(&buffer[16 * i])));
+	};
+	ArmCe s{
+		.abcd = vld1q_u32(state.data()),
+		.e = state[4],
+		.msg = {load(0), load(1), load(2), load(3)},
+	};
+
+	armCeSteps(s, std::make_integer_sequence<int, 20>{});
+
+	vst1q_u32(state.data(), vaddq_u32(s.abcd, vld1q_u32(state.data())));
+	state[4] += s.e;
+}
+#endif
+
 
 // class Sha1Sum
 
@@ -272,6 +381,11 @@ SHA1::SHA1()
 
 void SHA1::transform(std::span<const uint8_t, 64> buffer)
 {
+#if defined(SHA1_X86_SHA)
+	transformShaNi(m_state.a, buffer);
+#elif defined(SHA1_ARM_SHA)
+	transformArmCe(m_state.a, buffer);
+#else
 	WorkspaceBlock block(buffer);
 
 	// Copy m_state[] to working vars
@@ -316,6 +430,7 @@ void SHA1::transform(std::span<const uint8_t, 64> buffer)
 	m_state.a[2] += c;
 	m_state.a[3] += d;
 	m_state.a[4] += e;
+#endif
 }
 
 // Use this function to hash in binary data and strings
@@ -8,6 +8,7 @@
 #include <bit>
 #include <cassert>
 #include <cstring>
+#include <tuple>
 
 namespace openmsx {
 
@@ -664,6 +665,77 @@ static void tiger_compress(std::span<const uint8_t, 64> input, std::span<uint64_
 	state[2] = c + cc;
 }
 
+// Same as tiger_compress(), but for N independent inputs at once. The rounds
+// of a single tiger_compress() form one long dependency chain (each round
+// needs the result of the previous one), so most of the time the CPU waits
+// for the table lookups. Interleaving the rounds of independent inputs
+// keeps more execution units busy.
+template<size_t N>
+static void tiger_compress_multi(std::span<const uint8_t* const, N> inputs,
+                                 std::span<std::array<uint64_t, 3>, N> states)
+{
+	using Lanes = std::array<uint64_t, N>;
+	Lanes a, b, c, aa, bb, cc;
+	std::array<Lanes, 8> x;
+	for (size_t i = 0; i < N; ++i) {
+		a[i] = states[i][0];
+		b[i] = states[i][1];
+		c[i] = states[i][2];
+		aa[i] = a[i];
+		bb[i] = b[i];
+		cc[i] = c[i];
+		for (size_t j = 0; j < 8; ++j) {
+			x[j][i] = Endian::read_UA_L64(inputs[i] + 8 * j);
+		}
+	}
+
+	auto pass = [&](Lanes& p, Lanes& q, Lanes& r, int mul) {
+		for (size_t j = 0; j < 8; ++j) {
+			for (size_t i = 0; i < N; ++i) {
+				switch (j % 3) {
+					case 0: round(p[i], q[i], r[i], x[j][i], mul); break;
+					case 1: round(q[i], r[i], p[i], x[j][i], mul); break;
+					case 2: round(r[i], p[i], q[i], x[j][i], mul); break;
+				}
+			}
+		}
+	};
+	auto keySchedule = [&] {
+		for (size_t i = 0; i < N; ++i) {
+			auto [x0, x1, x2, x3, x4, x5, x6, x7] = std::tie(
+				x[0][i], x[1][i], x[2][i], x[3][i], x[4][i], x[5][i], x[6][i], x[7][i]);
+			x0 -= x7 ^ 0xA5A5A5A5A5A5A5A5LL;
+			x1 ^= x0;
+			x2 += x1;
+			x3 -= x2 ^ ((~x1) << 19);
+			x4 ^= x3;
+			x5 += x4;
+			x6 -= x5 ^ ((~x4) >> 23);
+			x7 ^= x6;
+			x0 += x7;
+			x1 -= x0 ^ ((~x7) << 19);
+			x2 ^= x1;
+			x3 += x2;
+			x4 -= x3 ^ ((~x2) >> 23);
+			x5 ^= x4;
+			x6 += x5;
+			x7 -= x6 ^ 0x0123456789ABCDEFLL;
+		}
+	};
+
+	pass(a, b, c, 5);
+	keySchedule();
+	pass(c, a, b, 7);
+	keySchedule();
+	pass(b, c, a, 9);
+
+	for (size_t i = 0; i < N; ++i) {
+		states[i][0] = a[i] ^ aa[i];
+		states[i][1] = b[i] - bb[i];
+		states[i][2] = c[i] + cc[i];
+	}
+}
+
 static constexpr void initState(std::span<uint64_t, 3> state)
 {
 	state[0] = 0x0123456789ABCDEFULL;
@@ -730,6 +802,64 @@ void tiger_int(const TigerHash& h0, const TigerHash& h1, TigerHash& result)
 	returnState(result.h64);
 }
 
+template<size_t N>
+static void tiger_leaves_multi(std::span<const uint8_t> data, std::span<TigerHash, N> result)
+{
+	static constexpr size_t LEAF_SIZE = 1024;
+	assert(data.size() == N * LEAF_SIZE);
+
+	std::array<std::array<uint64_t, 3>, N> states;
+	for (auto& state : states) initState(state);
+
+	// The hashed message is a 0x00 marker byte followed by the 1024 data
+	// bytes. So the first and the last 64-byte chunk need a copy, all
+	// other chunks can be read directly from the data.
+	std::array<std::array<uint8_t, 64>, N> tmp;
+	std::array<const uint8_t*, N> ptrs;
+	for (size_t i = 0; i < N; ++i) {
+		tmp[i][0] = 0x00;
+		copy_to_range(data.subspan(i * LEAF_SIZE, 63), subspan<63>(tmp[i], 1));
+		ptrs[i] = tmp[i].data();
+	}
+	tiger_compress_multi<N>(ptrs, states);
+
+	for (size_t chunk = 1; chunk < LEAF_SIZE / 64; ++chunk) {
+		for (size_t i = 0; i < N; ++i) {
+			ptrs[i] = &data[i * LEAF_SIZE + 64 * chunk - 1];
+		}
+		tiger_compress_multi<N>(ptrs, states);
+	}
+
+	for (size_t i = 0; i < N; ++i) {
+		tmp[i] = {};
+		tmp[i][0] = data[i * LEAF_SIZE + LEAF_SIZE - 1];
+		tmp[i][1] = 0x01;
+		Endian::write_UA_L64(&tmp[i][56], uint64_t(LEAF_SIZE + 1) << 3);
+		ptrs[i] = tmp[i].data();
+	}
+	tiger_compress_multi<N>(ptrs, states);
+
+	for (size_t i = 0; i < N; ++i) {
+		result[i].h64 = states[i];
+		returnState(result[i].h64);
+	}
+}
+
+void tiger_leaves(std::span<const uint8_t> data, std::span<TigerHash> result)
+{
+	static constexpr size_t LEAF_SIZE = 1024;
+	static constexpr size_t N = 4;
+	assert(data.size() == result.size() * LEAF_SIZE);
+	while (result.size() >= N) {
+		tiger_leaves_multi<N>(data.first(N * LEAF_SIZE), result.first<N>());
+		data = data.subspan(N * LEAF_SIZE);
+		result = result.subspan(N);
+	}
+	for (size_t i = 0; i < result.size(); ++i) {
+		tiger_leaves_multi<1>(data.subspan(i * LEAF_SIZE, LEAF_SIZE), result.subspan(i).first<1>());
+	}
+}
+
 void tiger_leaf(std::span<uint8_t> data, TigerHash& result)
 {
 	static std::array<uint8_t, 64> last = {
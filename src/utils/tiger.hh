@@ -61,6 +61,14 @@ void tiger_int(const TigerHash& h0, const TigerHash& h1, TigerHash& result);
  */
 void tiger_leaf(std::span</*const*/uint8_t> data, TigerHash& result);
 
+/** Calculate the tiger-tree leaf hashes of several consecutive 1024-byte
+ * blocks, so data.size() must be 1024 * result.size(). Gives the same result
+ * as calling tiger_leaf() for each block, but it's faster because it
+ * processes multiple blocks in an interleaved way. Unlike tiger_leaf() this
+ * function doesn't (temporarily) modify the input and it is reentrant.
+ */
+void tiger_leaves(std::span<const uint8_t> data, std::span<TigerHash> result);
+
 } // namespace openmsx
 
 #endif
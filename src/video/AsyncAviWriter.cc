@@ -0,0 +1,152 @@
+#include "AsyncAviWriter.hh"
+
+#include "MSXException.hh"
+
+#include "ranges.hh"
+#include "stl.hh"
+#include "xrange.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace openmsx {
+
+AsyncAviWriter::AsyncAviWriter(const std::string& filename, unsigned width, unsigned height,
+                               unsigned channels, unsigned freq, bool fast)
+	: writer(filename, width, height, channels, freq, fast)
+{
+	for (auto& slot : slots) {
+		slot.pixels.resize(size_t(width) * height);
+	}
+	thread = std::thread([this]() { workerLoop(); });
+}
+
+AsyncAviWriter::~AsyncAviWriter()
+{
+	{
+		std::scoped_lock lock(mutex);
+		stop = true;
+	}
+	cond.notify_one();
+	thread.join(); // only returns after the queue is drained
+
+	if (!error) writePendingDuplicates(); // in case flush() wasn't called
+}
+
+bool AsyncAviWriter::addFrame(const FrameSource* video, std::span<const int16_t> audio)
+{
+	unsigned idx;
+	{
+		std::scoped_lock lock(mutex);
+		if (error) {
+			throw MSXException(*error);
+		}
+		if (count == QUEUE_SIZE) {
+			++stats.framesDropped;
+			append(pendingAudio, audio);
+			++pendingDuplicates;
+			return false;
+		}
+		idx = (head + count) % QUEUE_SIZE;
+	}
+
+	// This slot is not (yet) visible to the encoder thread.
+	auto& slot = slots[idx];
+	slot.audio.assign(pendingAudio.begin(), pendingAudio.end());
+	slot.duplicateAudio = pendingAudio.size();
+	slot.duplicates = pendingDuplicates;
+	append(slot.audio, audio);
+	pendingAudio.clear();
+	pendingDuplicates = 0;
+	writer.captureFrame(video, std::span{slot.pixels});
+
+	{
+		std::scoped_lock lock(mutex);
+		++count;
+		stats.maxQueueDepth = std::max(stats.maxQueueDepth, count);
+	}
+	cond.notify_one();
+	return true;
+}
+
+void AsyncAviWriter::flush()
+{
+	{
+		std::unique_lock lock(mutex);
+		emptyCond.wait(lock, [&] { return count == 0; });
+		if (error) return;
+	}
+	// The encoder thread is idle now (and stays idle, frames are only
+	// added from this thread).
+	writePendingDuplicates();
+}
+
+// Frames that were dropped at the very end are not followed by a queued
+// frame. Write them now (slot.pixels is empty). Only call this while the
+// encoder thread is idle.
+void AsyncAviWriter::writePendingDuplicates()
+{
+	if (pendingDuplicates == 0) return;
+	Slot slot;
+	slot.duplicateAudio = pendingAudio.size();
+	slot.audio = std::move(pendingAudio);
+	slot.duplicates = pendingDuplicates;
+	pendingAudio.clear();
+	pendingDuplicates = 0;
+	try {
+		encode(slot);
+	} catch (MSXException& e) {
+		// still finalize what we have so far
+		std::scoped_lock lock(mutex);
+		error = e.getMessage();
+	}
+}
+
+AsyncAviWriter::Stats AsyncAviWriter::getStats() const
+{
+	std::scoped_lock lock(mutex);
+	auto result = stats;
+	result.queueDepth = count;
+	return result;
+}
+
+void AsyncAviWriter::encode(const Slot& slot)
+{
+	std::span<const int16_t> audio = slot.audio;
+	for (auto i : xrange(slot.duplicates)) {
+		bool last = (i + 1) == slot.duplicates;
+		writer.addFrame({}, last ? audio.first(slot.duplicateAudio)
+		                         : std::span<const int16_t>{});
+	}
+	if (!slot.pixels.empty()) {
+		writer.addFrame(std::span{slot.pixels}, audio.subspan(slot.duplicateAudio));
+	}
+}
+
+void AsyncAviWriter::workerLoop()
+{
+	std::unique_lock lock(mutex);
+	while (true) {
+		cond.wait(lock, [&] { return stop || (count != 0); });
+		if (count == 0) return; // stopped and queue is drained
+
+		const auto& slot = slots[head];
+		bool failed = error.has_value();
+		lock.unlock();
+		std::optional<std::string> err;
+		if (!failed) {
+			try {
+				encode(slot);
+			} catch (MSXException& e) {
+				err = e.getMessage();
+			}
+		}
+		lock.lock();
+		if (err) error = std::move(err);
+		if (!failed && !err) ++stats.framesEncoded;
+		head = (head + 1) % QUEUE_SIZE;
+		if (--count == 0) emptyCond.notify_all();
+	}
+}
+
+} // namespace openmsx
@@ -0,0 +1,106 @@
+#ifndef ASYNCAVIWRITER_HH
+#define ASYNCAVIWRITER_HH
+
+#include "AviWriter.hh"
+#include "ZMBVEncoder.hh"
+
+#include "MemBuffer.hh"
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openmsx {
+
+class FrameSource;
+
+/** Wrapper around AviWriter that does the (expensive) video compression and
+  * the file writes in a background thread.
+  *
+  * Frames are copied from the FrameSource into a small fixed pool of
+  * buffers (on the calling thread) and are then handed over to the encoder
+  * thread. When the encoder can't keep up and all buffers are in use, the
+  * new frame is dropped: it's recorded as a repeat of the previous frame,
+  * and its audio is still recorded, so audio and video stay in sync.
+  */
+class AsyncAviWriter
+{
+public:
+	static constexpr unsigned QUEUE_SIZE = 8;
+
+	struct Stats {
+		unsigned queueDepth = 0;    // currently queued frames
+		unsigned maxQueueDepth = 0; // maximum since start of recording
+		uint64_t framesEncoded = 0;
+		uint64_t framesDropped = 0;
+	};
+
+public:
+	AsyncAviWriter(const std::string& filename, unsigned width, unsigned height,
+	               unsigned channels, unsigned freq, bool fast);
+	AsyncAviWriter(const AsyncAviWriter&) = delete;
+	AsyncAviWriter(AsyncAviWriter&&) = delete;
+	AsyncAviWriter& operator=(const AsyncAviWriter&) = delete;
+	AsyncAviWriter& operator=(AsyncAviWriter&&) = delete;
+
+	/** Waits till all queued frames are written. */
+	~AsyncAviWriter();
+
+	// The encoder thread doesn't access the fps (it's only used when the
+	// file is finalized), so this doesn't need locking.
+	void setFps(float fps) { writer.setFps(fps); }
+
+	/** Queue a frame (and the audio that goes with it) for encoding.
+	  * Returns false if the frame was dropped.
+	  * Throws MSXException when a previous frame couldn't be written.
+	  */
+	bool addFrame(const FrameSource* video, std::span<const int16_t> audio);
+
+	/** Wait till all queued frames are written, this includes the
+	  * frames that were dropped at the end of the recording. */
+	void flush();
+
+	[[nodiscard]] Stats getStats() const;
+
+private:
+	struct Slot {
+		MemBuffer<ZMBVEncoder::Pixel, SSE_ALIGNMENT> pixels;
+		std::vector<int16_t> audio;
+		size_t duplicateAudio = 0; // first part of 'audio' goes with the duplicates
+		unsigned duplicates = 0; // dropped frames that precede this frame
+	};
+
+	void workerLoop();
+	void encode(const Slot& slot);
+	void writePendingDuplicates();
+
+private:
+	AviWriter writer;
+	std::array<Slot, QUEUE_SIZE> slots;
+
+	// Only accessed from the emulation thread.
+	std::vector<int16_t> pendingAudio;
+	unsigned pendingDuplicates = 0;
+
+	mutable std::mutex mutex;
+	std::condition_variable cond;      // signals new work (or stop)
+	std::condition_variable emptyCond; // signals the queue became empty
+	// The following are protected by 'mutex'.
+	unsigned head = 0;  // slot that's (going to be) encoded next
+	unsigned count = 0; // number of queued slots (including the one being encoded)
+	Stats stats;
+	std::optional<std::string> error;
+	bool stop = false;
+
+	std::thread thread; // must be last, started after the above members are initialized
+};
+
+} // namespace openmsx
+
+#endif
@@ -1,6 +1,5 @@
 #include "AviRecorder.hh"
 
-#include "AviWriter.hh"
 #include "PostProcessor.hh"
 
 #include "CliComm.hh"
@@ -33,6 +32,7 @@ using namespace std::literals;
 AviRecorder::AviRecorder(Reactor& reactor_)
 	: reactor(reactor_)
 	, recordCommand(reactor.getCommandController())
+	, encoderInfo(reactor.getOpenMSXInfoCommand())
 {
 }
 
@@ -43,7 +43,7 @@ AviRecorder::~AviRecorder()
 }
 
 void AviRecorder::start(bool recordAudio, bool recordVideo, bool recordMono,
-                        bool recordStereo, const std::string& filename)
+                        bool recordStereo, bool fast, const std::string& filename)
 {
 	stop();
 	MSXMotherBoard* motherBoard = reactor.getMotherBoard();
@@ -80,13 +80,14 @@ void AviRecorder::start(bool recordAudio, bool recordVideo, bool recordMono,
 		}
 		// any source is fine because they all have the same bpp
 		warnedFps = false;
+		warnedDropped = false;
 		duration = EmuDuration::infinity();
 		prevTime = EmuTime::infinity();
 
 		try {
-			aviWriter = std::make_unique<AviWriter>(
+			aviWriter = std::make_unique<AsyncAviWriter>(
 				filename, frameWidth, frameHeight,
-				(recordAudio && stereo) ? 2 : 1, sampleRate);
+				(recordAudio && stereo) ? 2 : 1, sampleRate, fast);
 		} catch (MSXException& e) {
 			throw CommandException("Can't start recording: ",
 			                       e.getMessage());
@@ -114,7 +115,11 @@ void AviRecorder::stop()
 		mixer = nullptr;
 	}
 	sampleRate = 0;
-	aviWriter.reset();
+	if (aviWriter) {
+		aviWriter->flush();
+		lastStats = aviWriter->getStats();
+		aviWriter.reset();
+	}
 	wavWriter.reset();
 }
 
@@ -196,7 +201,13 @@ void AviRecorder::addImage(const FrameSource* frame, EmuTime time)
 	if (mixer) {
 		mixer->updateStream(time);
 	}
-	aviWriter->addFrame(frame, audioBuf);
+	if (!aviWriter->addFrame(frame, audioBuf) && !warnedDropped) {
+		warnedDropped = true;
+		reactor.getCliComm().printWarning(
+			"Video encoding can't keep up, some frames are "
+			"recorded as a repeat of the previous frame. See "
+			"'openmsx_info avi_encoder' for statistics.");
+	}
 	audioBuf.clear();
 }
 
@@ -215,6 +226,7 @@ void AviRecorder::processStart(Interpreter& interp, std::span<const TclObject> t
 	bool recordStereo = false;
 	bool doubleSize   = false;
 	bool tripleSize   = false;
+	bool fast         = false;
 	std::array info = {
 		valueArg("-prefix", prefix),
 		flagArg("-audioonly", audioOnly),
@@ -223,6 +235,7 @@ void AviRecorder::processStart(Interpreter& interp, std::span<const TclObject> t
 		flagArg("-stereo",    recordStereo),
 		flagArg("-doublesize", doubleSize),
 		flagArg("-triplesize", tripleSize),
+		flagArg("-fast",      fast),
 	};
 	auto arguments = parseTclArgs(interp, tokens.subspan(2), info);
 
@@ -269,7 +282,7 @@ void AviRecorder::processStart(Interpreter& interp, std::span<const TclObject> t
 	if (aviWriter || wavWriter) {
 		result = "Already recording.";
 	} else {
-		start(recordAudio, recordVideo, recordMono, recordStereo, filename);
+		start(recordAudio, recordVideo, recordMono, recordStereo, fast, filename);
 		result = tmpStrCat("Recording to ", filename);
 	}
 }
@@ -299,6 +312,38 @@ void AviRecorder::status(std::span<const TclObject> /*tokens*/, TclObject& resul
 	result.addDictKeyValue("status", isRecording() ? "recording"sv : "idle"sv);
 }
 
+// class AviRecorder::EncoderInfo
+
+AviRecorder::EncoderInfo::EncoderInfo(InfoCommand& openMSXInfoCommand)
+	: InfoTopic(openMSXInfoCommand, "avi_encoder")
+{
+}
+
+void AviRecorder::EncoderInfo::execute(std::span<const TclObject> /*tokens*/,
+                                       TclObject& result) const
+{
+	const auto& recorder = OUTER(AviRecorder, encoderInfo);
+	auto stats = recorder.aviWriter ? recorder.aviWriter->getStats()
+	                                : recorder.lastStats;
+	result.addDictKeyValues("recording", bool(recorder.aviWriter),
+	                        "queue_depth", stats.queueDepth,
+	                        "queue_size", AsyncAviWriter::QUEUE_SIZE,
+	                        "max_queue_depth", stats.maxQueueDepth,
+	                        "frames_encoded", stats.framesEncoded,
+	                        "frames_dropped", stats.framesDropped);
+}
+
+std::string AviRecorder::EncoderInfo::help(std::span<const TclObject> /*tokens*/) const
+{
+	return "Returns statistics about the background video encoder of the "
+	       "current (or else the last) video recording: the number of "
+	       "queued frames, the maximum number of queued frames, the number "
+	       "of encoded frames and the number of frames that were dropped "
+	       "(recorded as a repeat of the previous frame) because the "
+	       "encoder couldn't keep up.";
+}
+
+
 // class AviRecorder::Cmd
 
 AviRecorder::Cmd::Cmd(CommandController& commandController_)
@@ -334,9 +379,11 @@ std::string AviRecorder::Cmd::help(std::span<const TclObject> /*tokens*/) const
 	       "record status             Query recording state\n"
 	       "\n"
 	       "The start subcommand also accepts an optional -audioonly, -videoonly, "
-	       " -mono, -stereo, -doublesize, -triplesize flag.\n"
+	       " -mono, -stereo, -doublesize, -triplesize, -fast flag.\n"
 	       "Videos are recorded in a 320x240 size by default, at 640x480 when the "
-	       "-doublesize flag is used and at 960x720 when the -triplesize flag is used.";
+	       "-doublesize flag is used and at 960x720 when the -triplesize flag is used.\n"
+	       "The -fast flag uses about half the CPU time for video compression, but "
+	       "results in bigger files.";
 }
 
 void AviRecorder::Cmd::tabCompletion(std::vector<std::string>& tokens) const
@@ -351,7 +398,7 @@ void AviRecorder::Cmd::tabCompletion(std::vector<std::string>& tokens) const
 		static constexpr std::array options = {
 			"-prefix"sv, "-videoonly"sv, "-audioonly"sv,
 			"-doublesize"sv, "-triplesize"sv,
-			"-mono"sv, "-stereo"sv,
+			"-mono"sv, "-stereo"sv, "-fast"sv,
 		};
 		completeFileName(tokens, userFileContext(), options);
 	}
@@ -1,9 +1,11 @@
 #ifndef AVIRECORDER_HH
 #define AVIRECORDER_HH
 
+#include "AsyncAviWriter.hh"
 #include "Command.hh"
 #include "EmuDuration.hh"
 #include "EmuTime.hh"
+#include "InfoTopic.hh"
 #include "Mixer.hh"
 
 #include <cstdint>
@@ -14,7 +16,6 @@
 
 namespace openmsx {
 
-class AviWriter;
 class FrameSource;
 class Interpreter;
 class MSXMixer;
@@ -43,7 +44,7 @@ public:
 
 private:
 	void start(bool recordAudio, bool recordVideo, bool recordMono,
-		   bool recordStereo, const std::string& filename);
+		   bool recordStereo, bool fast, const std::string& filename);
 	void status(std::span<const TclObject> tokens, TclObject& result) const;
 
 	void processStart (Interpreter& interp, std::span<const TclObject> tokens, TclObject& result);
@@ -60,9 +61,17 @@ private:
 		void tabCompletion(std::vector<std::string>& tokens) const override;
 	} recordCommand;
 
+	struct EncoderInfo final : InfoTopic {
+		explicit EncoderInfo(InfoCommand& openMSXInfoCommand);
+		void execute(std::span<const TclObject> tokens,
+		             TclObject& result) const override;
+		[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
+	} encoderInfo;
+
 	std::vector<int16_t> audioBuf;
-	std::unique_ptr<AviWriter>   aviWriter; // can be nullptr
-	std::unique_ptr<Wav16Writer> wavWriter; // can be nullptr
+	std::unique_ptr<AsyncAviWriter> aviWriter; // can be nullptr
+	std::unique_ptr<Wav16Writer>    wavWriter; // can be nullptr
+	AsyncAviWriter::Stats lastStats; // of the last finished video recording
 	std::vector<PostProcessor*> postProcessors;
 	MSXMixer* mixer = nullptr;
 	EmuDuration duration = EmuDuration::infinity();
@@ -73,6 +82,7 @@ private:
 	bool warnedFps;
 	bool warnedSampleRate;
 	bool warnedStereo;
+	bool warnedDropped;
 	bool stereo;
 };
 
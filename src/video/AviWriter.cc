@@ -25,10 +25,11 @@ namespace openmsx {
 static constexpr unsigned AVI_HEADER_SIZE = 500;
 
 AviWriter::AviWriter(const std::string& filename_, unsigned width_,
-                     unsigned height_, unsigned channels_, unsigned freq_)
+                     unsigned height_, unsigned channels_, unsigned freq_,
+                     bool fast)
 	: file(filename_, "wb")
 	, filename(filename_)
-	, codec(width_, height_)
+	, codec(width_, height_, fast)
 	, width(width_)
 	, height(height_)
 	, channels(channels_)
@@ -274,7 +275,7 @@ void AviWriter::addAviChunk(std::span<const char, 4> tag, std::span<const uint8_
 	index[idxSize + 3] = size32;
 }
 
-void AviWriter::addFrame(const FrameSource* video, std::span<const int16_t> audio)
+void AviWriter::addFrame(std::span<const ZMBVEncoder::Pixel> video, std::span<const int16_t> audio)
 {
 	bool keyFrame = (frames++ % 300 == 0);
 	auto buffer = codec.compressFrame(keyFrame, video);
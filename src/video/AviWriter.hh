@@ -22,9 +22,17 @@ class AviWriter
 {
 public:
 	AviWriter(const std::string& filename, unsigned width, unsigned height,
-	          unsigned channels, unsigned freq);
+	          unsigned channels, unsigned freq, bool fast);
 	~AviWriter();
-	void addFrame(const FrameSource* video, std::span<const int16_t> audio);
+
+	/** See ZMBVEncoder::captureFrame(). */
+	void captureFrame(const FrameSource* frame, std::span<ZMBVEncoder::Pixel> out) const {
+		codec.captureFrame(frame, out);
+	}
+	/** Add a frame that was captured with captureFrame(), an empty span
+	  * repeats the previous frame. The audio is interleaved after it.
+	  */
+	void addFrame(std::span<const ZMBVEncoder::Pixel> video, std::span<const int16_t> audio);
 	void setFps(float fps_) { fps = fps_; }
 
 private:
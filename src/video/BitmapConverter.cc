@@ -8,8 +8,24 @@
 
 #include <algorithm>
 #include <bit>
+#include <cstring>
 #include <tuple>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+// The routines below have a vectorized implementation for SSE2 (x86-64
+// baseline), AVX2 and NEON (aarch64 baseline), selected at compile time. The
+// plain C++ code is the reference implementation, the vectorized versions must
+// give bit-identical results (see unittest/BitmapConverter_test.cc).
+
 namespace openmsx {
 
 BitmapConverter::BitmapConverter(
@@ -35,6 +51,12 @@ void BitmapConverter::calcDPalette()
 			dPalette[16 * i + j] = dp;
 		}
 	}
+	for (auto i : xrange(256)) {
+		qPalette[i] = {palette16[ 0 +  (i >> 6)     ],
+		               palette16[16 + ((i >> 4) & 3)],
+		               palette16[ 0 + ((i >> 2) & 3)],
+		               palette16[16 + ((i >> 0) & 3)]};
+	}
 }
 
 void BitmapConverter::convertLine(std::span<Pixel> buf, std::span<const uint8_t, 128> vramPtr)
@@ -144,15 +166,22 @@ void BitmapConverter::renderGraphic4(
 
 void BitmapConverter::renderGraphic5(
 	std::span<Pixel, 512> buf,
-	std::span<const uint8_t, 128> vramPtr0) const
+	std::span<const uint8_t, 128> vramPtr0)
 {
-	Pixel* __restrict pixelPtr = buf.data();
-	for (auto i : xrange(128)) {
+	/*for (auto i : xrange(128)) {
 		unsigned data = vramPtr0[i];
 		pixelPtr[4 * i + 0] = palette16[ 0 +  (data >> 6)     ];
 		pixelPtr[4 * i + 1] = palette16[16 + ((data >> 4) & 3)];
 		pixelPtr[4 * i + 2] = palette16[ 0 + ((data >> 2) & 3)];
 		pixelPtr[4 * i + 3] = palette16[16 + ((data >> 0) & 3)];
+	}*/
+	if (!dPaletteValid) [[unlikely]] {
+		calcDPalette();
+	}
+	Pixel* __restrict pixelPtr = buf.data();
+	for (auto i : xrange(128)) {
+		// 4 pixels (= 16 bytes, a single vector load/store) per byte
+		std::ranges::copy(qPalette[vramPtr0[i]], &pixelPtr[4 * i]);
 	}
 }
 
@@ -208,10 +237,26 @@ void BitmapConverter::renderGraphic7(
 	std::span<const uint8_t, 128> vramPtr1) const
 {
 	Pixel* __restrict pixelPtr = buf.data();
+#ifdef __AVX2__
+	const auto* pal = std::bit_cast<const int*>(palette256.data());
+	for (size_t i = 0; i < 128; i += 16) {
+		// 32 pixels per iteration
+		__m128i v0 = _mm_loadu_si128(std::bit_cast<const __m128i*>(&vramPtr0[i]));
+		__m128i v1 = _mm_loadu_si128(std::bit_cast<const __m128i*>(&vramPtr1[i]));
+		__m128i lo = _mm_unpacklo_epi8(v0, v1);
+		__m128i hi = _mm_unpackhi_epi8(v0, v1);
+		auto* out = std::bit_cast<__m256i*>(&pixelPtr[2 * i]);
+		_mm256_storeu_si256(out + 0, _mm256_i32gather_epi32(pal, _mm256_cvtepu8_epi32(lo), 4));
+		_mm256_storeu_si256(out + 1, _mm256_i32gather_epi32(pal, _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)), 4));
+		_mm256_storeu_si256(out + 2, _mm256_i32gather_epi32(pal, _mm256_cvtepu8_epi32(hi), 4));
+		_mm256_storeu_si256(out + 3, _mm256_i32gather_epi32(pal, _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)), 4));
+	}
+#else
 	for (auto i : xrange(128)) {
 		pixelPtr[2 * i + 0] = palette256[vramPtr0[i]];
 		pixelPtr[2 * i + 1] = palette256[vramPtr1[i]];
 	}
+#endif
 }
 
 static constexpr std::tuple<int, int, int> yjk2rgb(int y, int j, int k)
@@ -227,12 +272,99 @@ static constexpr std::tuple<int, int, int> yjk2rgb(int y, int j, int k)
 	return {r, g, b};
 }
 
-void BitmapConverter::renderYJK(
-	std::span<Pixel, 256> buf,
+// Calculate the index in palette32768 for all 256 pixels of a YJK line. The
+// calculation is done in 16-bit lanes, the pixel order is:
+//   p0 = vramPtr0[2 * i + 0], p1 = vramPtr1[2 * i + 0],
+//   p2 = vramPtr0[2 * i + 1], p3 = vramPtr1[2 * i + 1]
+// So when both planes are interleaved, each 16-bit lane contains either the
+// (p0,p1) or the (p2,p3) pair, and thus the bits for 'k' or 'j'.
+static void calcYJKIndices(
+	std::span<uint16_t, 256> indices,
 	std::span<const uint8_t, 128> vramPtr0,
-	std::span<const uint8_t, 128> vramPtr1) const
+	std::span<const uint8_t, 128> vramPtr1)
 {
-	Pixel* __restrict pixelPtr = buf.data();
+#if defined(__SSE2__)
+	// y = p >> 3, r = y + j, g = y + k, b = (5y - 2j - k + 2) >> 2   (clamped)
+	// Note: arithmetic shift instead of division, this only differs for
+	// negative values, and those get clamped to 0 anyway.
+	auto rgb = [](__m128i y, __m128i j, __m128i k) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i max = _mm_set1_epi16(31);
+		auto clamp = [&](__m128i x) { return _mm_min_epi16(_mm_max_epi16(x, zero), max); };
+		__m128i r = clamp(_mm_add_epi16(y, j));
+		__m128i g = clamp(_mm_add_epi16(y, k));
+		__m128i y5 = _mm_add_epi16(_mm_slli_epi16(y, 2), y);
+		__m128i jk = _mm_add_epi16(_mm_add_epi16(j, j), k);
+		__m128i b = clamp(_mm_srai_epi16(
+			_mm_add_epi16(_mm_sub_epi16(y5, jk), _mm_set1_epi16(2)), 2));
+		return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 10), _mm_slli_epi16(g, 5)), b);
+	};
+	// 16 pixels (4 groups) -> 16 indices
+	auto calc16 = [&](__m128i p, uint16_t* out) {
+		const __m128i zero = _mm_setzero_si128();
+		// 6-bit signed value: low 3 bits of both pixels in the 16-bit lane
+		__m128i val6 = _mm_or_si128(
+			_mm_and_si128(p, _mm_set1_epi16(0x07)),
+			_mm_and_si128(_mm_srli_epi16(p, 5), _mm_set1_epi16(0x38)));
+		__m128i kj = _mm_sub_epi16(_mm_xor_si128(val6, _mm_set1_epi16(32)), _mm_set1_epi16(32));
+		// broadcast k (even lanes) and j (odd lanes) over the 4 pixels of each group
+		__m128i kLo = _mm_shufflelo_epi16(kj, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128i jLo = _mm_shufflelo_epi16(kj, _MM_SHUFFLE(3, 3, 1, 1));
+		__m128i kHi = _mm_shufflehi_epi16(kj, _MM_SHUFFLE(2, 2, 0, 0));
+		__m128i jHi = _mm_shufflehi_epi16(kj, _MM_SHUFFLE(3, 3, 1, 1));
+		kLo = _mm_unpacklo_epi32(kLo, kLo);
+		jLo = _mm_unpacklo_epi32(jLo, jLo);
+		kHi = _mm_unpackhi_epi32(kHi, kHi);
+		jHi = _mm_unpackhi_epi32(jHi, jHi);
+		__m128i yLo = _mm_srli_epi16(_mm_unpacklo_epi8(p, zero), 3);
+		__m128i yHi = _mm_srli_epi16(_mm_unpackhi_epi8(p, zero), 3);
+		_mm_storeu_si128(std::bit_cast<__m128i*>(out + 0), rgb(yLo, jLo, kLo));
+		_mm_storeu_si128(std::bit_cast<__m128i*>(out + 8), rgb(yHi, jHi, kHi));
+	};
+	for (size_t i = 0; i < 128; i += 16) {
+		__m128i v0 = _mm_loadu_si128(std::bit_cast<const __m128i*>(&vramPtr0[i]));
+		__m128i v1 = _mm_loadu_si128(std::bit_cast<const __m128i*>(&vramPtr1[i]));
+		calc16(_mm_unpacklo_epi8(v0, v1), &indices[2 * i +  0]);
+		calc16(_mm_unpackhi_epi8(v0, v1), &indices[2 * i + 16]);
+	}
+#elif defined(__ARM_NEON)
+	// Same algorithm as the SSE2 version above.
+	auto rgb = [](int16x8_t y, int16x8_t j, int16x8_t k) {
+		const int16x8_t zero = vdupq_n_s16(0);
+		const int16x8_t max = vdupq_n_s16(31);
+		auto clamp = [&](int16x8_t x) { return vminq_s16(vmaxq_s16(x, zero), max); };
+		int16x8_t r = clamp(vaddq_s16(y, j));
+		int16x8_t g = clamp(vaddq_s16(y, k));
+		int16x8_t y5 = vaddq_s16(vshlq_n_s16(y, 2), y);
+		int16x8_t jk = vaddq_s16(vaddq_s16(j, j), k);
+		int16x8_t b = clamp(vshrq_n_s16(vaddq_s16(vsubq_s16(y5, jk), vdupq_n_s16(2)), 2));
+		return vorrq_u16(vorrq_u16(vshlq_n_u16(vreinterpretq_u16_s16(r), 10),
+		                           vshlq_n_u16(vreinterpretq_u16_s16(g), 5)),
+		                 vreinterpretq_u16_s16(b));
+	};
+	auto calc16 = [&](uint8x16_t p8, uint16_t* out) {
+		uint16x8_t p = vreinterpretq_u16_u8(p8);
+		uint16x8_t val6 = vorrq_u16(
+			vandq_u16(p, vdupq_n_u16(0x07)),
+			vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x38)));
+		int16x8_t kj = vsubq_s16(vreinterpretq_s16_u16(veorq_u16(val6, vdupq_n_u16(32))),
+		                         vdupq_n_s16(32));
+		int16x8x2_t kAndJ = vuzpq_s16(kj, kj); // k0 k1 k2 k3 k0.. | j0 j1 j2 j3 j0..
+		int16x8x2_t k2 = vzipq_s16(kAndJ.val[0], kAndJ.val[0]); // k0 k0 k1 k1 ..
+		int16x8x2_t j2 = vzipq_s16(kAndJ.val[1], kAndJ.val[1]);
+		int16x8x2_t k4 = vzipq_s16(k2.val[0], k2.val[0]); // k0 k0 k0 k0 k1 .. | k2 ..
+		int16x8x2_t j4 = vzipq_s16(j2.val[0], j2.val[0]);
+		int16x8_t yLo = vreinterpretq_s16_u16(vshrq_n_u16(vmovl_u8(vget_low_u8 (p8)), 3));
+		int16x8_t yHi = vreinterpretq_s16_u16(vshrq_n_u16(vmovl_u8(vget_high_u8(p8)), 3));
+		vst1q_u16(out + 0, rgb(yLo, j4.val[0], k4.val[0]));
+		vst1q_u16(out + 8, rgb(yHi, j4.val[1], k4.val[1]));
+	};
+	for (size_t i = 0; i < 128; i += 16) {
+		uint8x16x2_t p = vzipq_u8(vld1q_u8(&vramPtr0[i]), vld1q_u8(&vramPtr1[i]));
+		calc16(p.val[0], &indices[2 * i +  0]);
+		calc16(p.val[1], &indices[2 * i + 16]);
+	}
+#else
 	for (auto i : xrange(64)) {
 		std::array<unsigned, 4> p = {
 			vramPtr0[2 * i + 0],
@@ -246,10 +378,33 @@ void BitmapConverter::renderYJK(
 		for (auto n : xrange(4)) {
 			int y = narrow<int>(p[n] >> 3);
 			auto [r, g, b] = yjk2rgb(y, j, k);
-			int col = (r << 10) + (g << 5) + b;
-			pixelPtr[4 * i + n] = palette32768[col];
+			indices[4 * i + n] = narrow<uint16_t>((r << 10) + (g << 5) + b);
 		}
 	}
+#endif
+}
+
+void BitmapConverter::renderYJK(
+	std::span<Pixel, 256> buf,
+	std::span<const uint8_t, 128> vramPtr0,
+	std::span<const uint8_t, 128> vramPtr1) const
+{
+	std::array<uint16_t, 256> indices;
+	calcYJKIndices(indices, vramPtr0, vramPtr1);
+
+	Pixel* __restrict pixelPtr = buf.data();
+#ifdef __AVX2__
+	const auto* pal = std::bit_cast<const int*>(palette32768.data());
+	for (size_t i = 0; i < 256; i += 8) {
+		__m128i idx = _mm_loadu_si128(std::bit_cast<const __m128i*>(&indices[i]));
+		_mm256_storeu_si256(std::bit_cast<__m256i*>(&pixelPtr[i]),
+			_mm256_i32gather_epi32(pal, _mm256_cvtepu16_epi32(idx), 4));
+	}
+#else
+	for (auto i : xrange(256)) {
+		pixelPtr[i] = palette32768[indices[i]];
+	}
+#endif
 }
 
 void BitmapConverter::renderYAE(
@@ -257,7 +412,29 @@ void BitmapConverter::renderYAE(
 	std::span<const uint8_t, 128> vramPtr0,
 	std::span<const uint8_t, 128> vramPtr1) const
 {
+	std::array<uint16_t, 256> indices;
+	calcYJKIndices(indices, vramPtr0, vramPtr1);
+
 	Pixel* __restrict pixelPtr = buf.data();
+#ifdef __AVX2__
+	const auto* pal16 = std::bit_cast<const int*>(palette16.data());
+	const auto* pal32k = std::bit_cast<const int*>(palette32768.data());
+	for (size_t i = 0; i < 128; i += 4) {
+		// 8 pixels per iteration
+		uint32_t d0, d1;
+		memcpy(&d0, &vramPtr0[i], sizeof(d0));
+		memcpy(&d1, &vramPtr1[i], sizeof(d1));
+		__m128i p = _mm_unpacklo_epi8(_mm_cvtsi32_si128(int(d0)), _mm_cvtsi32_si128(int(d1)));
+		__m256i p32 = _mm256_cvtepu8_epi32(p);
+		__m256i isYAE = _mm256_cmpeq_epi32(_mm256_and_si256(p32, _mm256_set1_epi32(0x08)),
+		                                   _mm256_set1_epi32(0x08));
+		__m128i idx = _mm_loadu_si128(std::bit_cast<const __m128i*>(&indices[2 * i]));
+		__m256i yjk = _mm256_i32gather_epi32(pal32k, _mm256_cvtepu16_epi32(idx), 4);
+		__m256i yae = _mm256_i32gather_epi32(pal16, _mm256_srli_epi32(p32, 4), 4);
+		_mm256_storeu_si256(std::bit_cast<__m256i*>(&pixelPtr[2 * i]),
+		                    _mm256_blendv_epi8(yjk, yae, isYAE));
+	}
+#else
 	for (auto i : xrange(64)) {
 		std::array<unsigned, 4> p = {
 			vramPtr0[2 * i + 0],
@@ -265,23 +442,13 @@ void BitmapConverter::renderYAE(
 			vramPtr0[2 * i + 1],
 			vramPtr1[2 * i + 1],
 		};
-		int j = narrow<int>((p[2] & 7) + ((p[3] & 3) << 3)) - narrow<int>((p[3] & 4) << 3);
-		int k = narrow<int>((p[0] & 7) + ((p[1] & 3) << 3)) - narrow<int>((p[1] & 4) << 3);
-
 		for (auto n : xrange(4)) {
-			Pixel pix;
-			if (p[n] & 0x08) {
-				// YAE
-				pix = palette16[p[n] >> 4];
-			} else {
-				// YJK
-				int y = narrow<int>(p[n] >> 3);
-				auto [r, g, b] = yjk2rgb(y, j, k);
-				pix = palette32768[(r << 10) + (g << 5) + b];
-			}
-			pixelPtr[4 * i + n] = pix;
+			pixelPtr[4 * i + n] = (p[n] & 0x08)
+				? palette16[p[n] >> 4]                // YAE
+				: palette32768[indices[4 * i + n]];   // YJK
 		}
 	}
+#endif
 }
 
 void BitmapConverter::renderBogus(std::span<Pixel, 256> buf) const
@@ -86,7 +86,7 @@ private:
 	void renderGraphic4(std::span<Pixel, 256> buf,
 	                    std::span<const uint8_t, 128> vramPtr0);
 	void renderGraphic5(std::span<Pixel, 512> buf,
-	                    std::span<const uint8_t, 128> vramPtr0) const;
+	                    std::span<const uint8_t, 128> vramPtr0);
 	void renderGraphic6(std::span<Pixel, 512> buf,
 	                    std::span<const uint8_t, 128> vramPtr0,
 	                    std::span<const uint8_t, 128> vramPtr1);
@@ -107,6 +107,8 @@ private:
 	std::span<const Pixel, 32768>  palette32768;
 
 	std::array<DPixel, 16 * 16> dPalette;
+	// Graphic5: the 4 host pixels for every possible VRAM byte.
+	std::array<std::array<Pixel, 4>, 256> qPalette;
 	DisplayMode mode;
 	bool dPaletteValid = false;
 };
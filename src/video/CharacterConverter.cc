@@ -29,8 +29,12 @@ using Pixel = CharacterConverter::Pixel;
 
 CharacterConverter::CharacterConverter(
 	VDP& vdp_, std::span<const Pixel, 16> palFg_, std::span<const Pixel, 16> palBg_)
-	: vdp(vdp_), vram(vdp.getVRAM()), palFg(palFg_), palBg(palBg_)
+	: vdp(vdp_), vram(vdp.getVRAM()), dirtyPages(vram.getDirtyPages())
+	, palFg(palFg_), palBg(palBg_)
+	, cachedPixels(cachedLines.size() * CACHE_WIDTH)
 {
+	copy_to_range(palFg, cachedPalFg);
+	copy_to_range(palBg, cachedPalBg);
 }
 
 void CharacterConverter::setDisplayMode(DisplayMode mode)
@@ -39,7 +43,67 @@ void CharacterConverter::setDisplayMode(DisplayMode mode)
 	assert(modeBase < 0x0C);
 }
 
-void CharacterConverter::convertLine(std::span<Pixel> buf, int line) const
+CharacterConverter::CacheKey CharacterConverter::getCacheKey() const
+{
+	return {
+		.nameRange    = vram.nameTable   .getAddressRange(),
+		.patternRange = vram.patternTable.getAddressRange(),
+		.colorRange   = vram.colorTable  .getAddressRange(),
+		.modeBase = modeBase,
+		.fg = vdp.getForegroundColor(),
+		.bg = vdp.getBackgroundColor(),
+		.blinkFg = vdp.getBlinkForegroundColor(),
+		.blinkBg = vdp.getBlinkBackgroundColor(),
+		.verticalScroll = vdp.getVerticalScroll(),
+		.horizontalScrollHigh = vdp.getHorizontalScrollHigh(),
+		.blinkState = vdp.getBlinkState(),
+	};
+}
+
+bool CharacterConverter::isCacheValid(int line, const CacheKey& key) const
+{
+	const auto& cached = cachedLines[line];
+	if ((cached.epoch == 0) || (cached.key != key)) return false;
+
+	// Were any of the VRAM pages that contain the tables written to?
+	for (auto [first, last] : {key.nameRange, key.patternRange, key.colorRange}) {
+		if (first > last) continue; // disabled table
+		for (auto page : xrange(first >> DirtyPages::PAGE_BITS, (last >> DirtyPages::PAGE_BITS) + 1)) {
+			if (dirtyPages.isDirty(page, cached.epoch)) return false;
+		}
+	}
+	return true;
+}
+
+void CharacterConverter::checkPalette()
+{
+	if (std::ranges::equal(palFg, cachedPalFg) &&
+	    std::ranges::equal(palBg, cachedPalBg)) {
+		return;
+	}
+	copy_to_range(palFg, cachedPalFg);
+	copy_to_range(palBg, cachedPalBg);
+	for (auto& l : cachedLines) l.epoch = 0;
+}
+
+void CharacterConverter::convertLine(std::span<Pixel> buf, int line)
+{
+	assert(0 <= line && line < 256);
+	checkPalette();
+	auto key = getCacheKey();
+	auto width = (modeBase == DisplayMode::TEXT2) ? 512 : 256;
+	auto cached = subspan(cachedPixels, line * CACHE_WIDTH, width);
+	if (isCacheValid(line, key)) {
+		copy_to_range(cached, buf);
+		return;
+	}
+	render(buf, line);
+	copy_to_range(buf.first(width), cached);
+	// Writes to VRAM after this point (will) have a later epoch.
+	cachedLines[line] = {.key = key, .epoch = dirtyPages.checkpoint()};
+}
+
+void CharacterConverter::render(std::span<Pixel> buf, int line) const
 {
 	// TODO: Support YJK on modes other than Graphic 6/7.
 	switch (modeBase) {
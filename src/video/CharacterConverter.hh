@@ -1,8 +1,13 @@
 #ifndef CHARACTERCONVERTER_HH
 #define CHARACTERCONVERTER_HH
 
+#include "DirtyPages.hh"
+#include "MemBuffer.hh"
+
+#include <array>
 #include <cstdint>
 #include <span>
+#include <utility>
 
 namespace openmsx {
 
@@ -38,8 +43,12 @@ public:
 	  *            least 256 or 512 pixels, but more is allowed (the extra
 	  *            pixels aren't touched).
 	  * @param line Display line number [0..255].
+	  * Lines for which the VRAM tables, the palette and the relevant VDP
+	  * registers didn't change since the previous call are copied from a
+	  * cache instead of being rendered again (static screens are very
+	  * common in these modes).
 	  */
-	void convertLine(std::span<Pixel> buf, int line) const;
+	void convertLine(std::span<Pixel> buf, int line);
 
 	/** Select the display mode to use for scanline conversion.
 	  * @param mode The new display mode.
@@ -59,16 +68,49 @@ private:
 	inline void renderMultiHelper(Pixel* pixelPtr, int line,
 	                       unsigned mask, unsigned patternQuarter) const;
 
+	void render(std::span<Pixel> buf, int line) const;
+
 	[[nodiscard]] std::span<const uint8_t, 32> getNamePtr(int line, int scroll) const;
 
+	/** Everything, except for the VRAM and palette content, that
+	  * influences the rendered line.
+	  */
+	struct CacheKey {
+		std::pair<unsigned, unsigned> nameRange;
+		std::pair<unsigned, unsigned> patternRange;
+		std::pair<unsigned, unsigned> colorRange;
+		unsigned modeBase;
+		int fg, bg, blinkFg, blinkBg;
+		uint8_t verticalScroll;
+		uint8_t horizontalScrollHigh;
+		bool blinkState;
+
+		[[nodiscard]] bool operator==(const CacheKey&) const = default;
+	};
+	[[nodiscard]] CacheKey getCacheKey() const;
+	[[nodiscard]] bool isCacheValid(int line, const CacheKey& key) const;
+	void checkPalette();
+
 private:
 	VDP& vdp;
 	VDPVRAM& vram;
+	DirtyPages& dirtyPages;
 
 	std::span<const Pixel, 16> palFg;
 	std::span<const Pixel, 16> palBg;
 
 	unsigned modeBase = 0; // not strictly needed, but avoids Coverity warning
+
+	// Cache of rendered lines.
+	static constexpr size_t CACHE_WIDTH = 512;
+	struct CachedLine {
+		CacheKey key;
+		DirtyPages::Epoch epoch = 0; // 0 -> invalid
+	};
+	std::array<CachedLine, 256> cachedLines;
+	MemBuffer<Pixel> cachedPixels; // 256 lines of CACHE_WIDTH pixels
+	std::array<Pixel, 16> cachedPalFg;
+	std::array<Pixel, 16> cachedPalBg;
 };
 
 } // namespace openmsx
@@ -3,7 +3,6 @@
 #include "PixelOperations.hh"
 #include "RawFrame.hh"
 
-#include "inplace_buffer.hh"
 #include "xrange.hh"
 
 #include <bit>
@@ -23,7 +22,12 @@ Deflicker::Deflicker(std::span<std::unique_ptr<RawFrame>, 4> lastFrames_)
 void Deflicker::init()
 {
 	FrameSource::init(FieldType::NONINTERLACED);
-	setHeight(lastFrames[0]->getHeight());
+	auto height = lastFrames[0]->getHeight();
+	setHeight(height);
+
+	pitch = lastFrames[0]->getLineDirect(0).size(); // max line width
+	cache.resize(height * pitch);
+	cached.assign(height, false);
 }
 
 unsigned Deflicker::getLineWidth(unsigned line) const
@@ -75,11 +79,19 @@ std::span<const Pixel> Deflicker::getUnscaledLine(
 		return std::span{line0, width0};
 	}
 
-	// Prefer to write directly to the output buffer, if that's not
-	// possible store the intermediate result in a temp buffer.
-	inplace_buffer<Pixel, 1280> buf2(uninitialized_tag{}, width0);
-	auto* buf = helpBuf.data();
-	Pixel* out = (width0 <= helpBuf.size()) ? buf : buf2.data();
+	auto result = [&] {
+		std::span<const Pixel> out{&cache[line * pitch], width0};
+		if (width0 <= helpBuf.size()) {
+			// If it already fits, we're done
+			return out;
+		} else {
+			// Otherwise scale so that it does fit.
+			scaleLine(out, helpBuf);
+			return std::span<const Pixel>{helpBuf};
+		}
+	};
+	if (cached[line]) return result();
+	Pixel* out = &cache[line * pitch];
 
 	// Detect pixels that alternate between two different color values and
 	// replace those with the average color. We search for an alternating
@@ -125,14 +137,8 @@ std::span<const Pixel> Deflicker::getUnscaledLine(
 	               : line0[x];
 	}
 
-	if (width0 <= helpBuf.size()) {
-		// If it already fits, we're done
-		return std::span{buf, width0};
-	} else {
-		// Otherwise scale so that it does fit.
-		scaleLine(std::span{out, width0}, helpBuf);
-		return helpBuf;
-	}
+	cached[line] = true;
+	return result();
 }
 
 } // namespace openmsx
@@ -3,8 +3,10 @@
 
 #include "FrameSource.hh"
 
+#include <cstdint>
 #include <memory>
 #include <span>
+#include <vector>
 
 namespace openmsx {
 
@@ -20,6 +22,7 @@ public:
 	Deflicker& operator=(Deflicker&&) = default;
 	~Deflicker() = default;
 
+	/** Must be called each time 'lastFrames' changed. */
 	void init();
 
 	[[nodiscard]] unsigned getLineWidth(unsigned line) const override;
@@ -28,6 +31,12 @@ public:
 
 private:
 	std::span<std::unique_ptr<RawFrame>, 4> lastFrames;
+
+	// The same line is typically requested several times per frame (e.g.
+	// for display and for recording), so each line is only blended once.
+	mutable std::vector<Pixel> cache; // 'pitch' pixels per line
+	mutable std::vector<uint8_t> cached; // per line, is 'cache' valid
+	size_t pitch = 0;
 };
 
 } // namespace openmsx
@@ -1,9 +1,12 @@
 #include "Display.hh"
 
 #include "ImGuiManager.hh"
+#include "ImageDiff.hh"
 #include "Layer.hh"
 #include "OutputSurface.hh"
 #include "RendererFactory.hh"
+#include "VDP.hh"
+#include "VDPScreenShot.hh"
 #include "VideoLayer.hh"
 #include "VideoSystem.hh"
 #include "VideoSystemChangeListener.hh"
@@ -16,9 +19,12 @@
 #include "EventDistributor.hh"
 #include "FileContext.hh"
 #include "FileOperations.hh"
+#include "GlobalSettings.hh"
 #include "HardwareConfig.hh"
 #include "IntegerSetting.hh"
 #include "MSXMotherBoard.hh"
+#include "PerfMonitor.hh"
+#include "PerfTrace.hh"
 #include "Reactor.hh"
 #include "TclArgParser.hh"
 #include "Timer.hh"
@@ -47,6 +53,8 @@ Display::Display(Reactor& reactor_)
 	, osdGui(reactor_.getCommandController(), *this)
 	, reactor(reactor_)
 	, renderSettings(reactor.getCommandController())
+	, inputLatencyMeter(*this, reactor.getEventDistributor(),
+	                    reactor.getCommandController())
 {
 	frameDurationSum = 0;
 	repeat(NUM_FRAME_DURATIONS, [&] {
@@ -158,7 +166,16 @@ bool Display::signalEvent(const Event& event)
 	std::visit(overloaded{
 		[&](const FinishFrameEvent& e) {
 			if (e.needRender()) {
-				repaint();
+				if (renderSettings.getFramePacing() == RenderSettings::FramePacing::EMULATION) {
+					repaint();
+				} else {
+					// Painted from executeRT(), in sync with the
+					// host display (see repaintImpl()).
+					auto now = Timer::getTime();
+					framePacer.frameFinished(now);
+					updateFps(now); // count MSX frames, not host frames
+					if (!isPendingRT()) repaint();
+				}
 				reactor.getEventDistributor().distributeEvent(FrameDrawnEvent());
 			}
 		},
@@ -337,24 +354,52 @@ void Display::repaintImpl()
 
 	cancelRT(); // cancel delayed repaint
 
+	auto pacing = renderSettings.getFramePacing();
+	bool hostPacing = pacing != RenderSettings::FramePacing::EMULATION;
 	if (!renderFrozen) {
 		assert(videoSystem);
 		if (OutputSurface* surface = videoSystem->getOutputSurface()) {
+			PerfMonitor::Scope perf(PerfMonitor::Section::PAINT);
+			auto start = Timer::getTime();
+			frameBlend = (pacing == RenderSettings::FramePacing::BLEND)
+			           ? framePacer.getBlendFactor(framePacer.getDisplayTime(start))
+			           : 1.0f;
 			repaintImpl(*surface);
+			auto rendered = Timer::getTime();
 			videoSystem->flush();
+			if (hostPacing) framePacer.presented(rendered - start, Timer::getTime());
 		}
 	}
+	PerfMonitor::endFrame();
+	PerfTrace::frame();
+
+	for (const auto& error : screenShotWriter.takeErrors()) {
+		getCliComm().printWarning("Failed to save screenshot: ", error);
+	}
 
-	// update fps statistics
 	auto now = Timer::getTime();
+	if (!hostPacing) updateFps(now);
+
+	if (hostPacing && framePacer.isActive(now)) {
+		// Paint again just before the next vblank of the host display.
+		// Typically RealTime is sleeping at that moment, it keeps
+		// executing RTSchedulables while sleeping.
+		framePacer.setRefreshRate(videoSystem->getRefreshRate());
+		now = Timer::getTime();
+		scheduleRT(framePacer.getNextPaintTime(now) - now);
+	} else {
+		// TODO maybe revisit this later (and/or simplify other calls to repaintDelayed())
+		// This ensures a minimum framerate for ImGui
+		repaintDelayed(40 * 1000); // 25fps
+	}
+}
+
+void Display::updateFps(uint64_t now)
+{
 	auto duration = now - prevTimeStamp;
 	prevTimeStamp = now;
 	frameDurationSum += duration - frameDurations.pop_back();
 	frameDurations.push_front(duration);
-
-	// TODO maybe revisit this later (and/or simplify other calls to repaintDelayed())
-	// This ensures a minimum framerate for ImGui
-	repaintDelayed(40 * 1000); // 25fps
 }
 
 void Display::repaintImpl(OutputSurface& surface)
@@ -424,13 +469,23 @@ void Display::ScreenShotCmd::execute(std::span<const TclObject> tokens, TclObjec
 	bool rawShot = false;
 	bool doubleSize = false;
 	bool withOsd = false;
+	bool async = false;
 	std::string size;
+	std::string_view scalerName;
+	std::string_view formatName = "png";
+	std::string_view compareName;
+	std::string_view diffName;
 	std::array info = {
 		valueArg("-prefix", prefix),
 		flagArg("-raw", rawShot),
 		flagArg("-doublesize", doubleSize), // bwcompat, alias for -size 640
 		flagArg("-with-osd", withOsd),
-		valueArg("-size", size)
+		valueArg("-size", size),
+		valueArg("-scaler", scalerName),
+		valueArg("-format", formatName),
+		flagArg("-async", async),
+		valueArg("-compare", compareName),
+		valueArg("-diff", diffName)
 	};
 	auto arguments = parseTclArgs(getInterpreter(), tokens.subspan(1), info);
 
@@ -457,6 +512,39 @@ void Display::ScreenShotCmd::execute(std::span<const TclObject> tokens, TclObjec
 		}
 	}
 
+	if (!compareName.empty() && !rawShot) {
+		throw CommandException("-compare option can only be used in "
+		                       "combination with -raw");
+	}
+	if (!diffName.empty() && compareName.empty()) {
+		throw CommandException("-diff option can only be used in "
+		                       "combination with -compare");
+	}
+
+	std::optional<SoftwareScaler> scaler;
+	if (!scalerName.empty()) {
+		if (!rawShot) {
+			throw CommandException("-scaler option can only be used in "
+			                       "combination with -raw");
+		}
+		scaler = SoftwareScaler::parse(scalerName);
+		if (!scaler) {
+			throw CommandException("-scaler option must specify one of: "
+			                       "hq2x, hq3x, hq4x, scale2x, scale3x, scale4x");
+		}
+	}
+
+	ScreenShotWriter::Target target;
+	if (formatName == "png") {
+		target.format = ScreenShotWriter::Format::PNG;
+	} else if (formatName == "ppm") {
+		target.format = ScreenShotWriter::Format::PPM;
+	} else {
+		throw CommandException("-format option must specify one of: png, ppm");
+	}
+	target.compressionLevel = display.reactor.getGlobalSettings().getPngCompressionSetting().getInt();
+	target.async = async;
+
 	// backwards compatiblity
 	if (doubleSize) {
 		size = "640";
@@ -477,34 +565,90 @@ void Display::ScreenShotCmd::execute(std::span<const TclObject> tokens, TclObjec
 	default:
 		throw SyntaxError();
 	}
-	std::string filename = FileOperations::parseCommandFileArgument(
-		fname, SCREENSHOT_DIR, prefix, SCREENSHOT_EXTENSION);
+	if (compareName.empty()) {
+		target.filename = FileOperations::parseCommandFileArgument(
+			fname, SCREENSHOT_DIR, prefix, getExtension(target.format));
+	} else if (!fname.empty()) {
+		throw CommandException("-compare doesn't write a screenshot, "
+		                       "so don't specify a filename");
+	}
 
 	if (!rawShot) {
 		// take screenshot as displayed, possibly with other layers (OSD stuff, ImGUI)
 		try {
-			display.getVideoSystem().takeScreenShot(filename, withOsd);
+			display.getVideoSystem().takeScreenShot(target, withOsd);
 		} catch (MSXException& e) {
 			throw CommandException(
 				"Failed to take screenshot: ", e.getMessage());
 		}
+		// An asynchronous read back is handed over to the writer at the
+		// end of a repaint, so make sure there is one (also when paused).
+		if (async) display.repaintDelayed(40 * 1000);
 	} else {
-		auto* videoLayer = dynamic_cast<VideoLayer*>(
-			display.findActiveLayer());
-		if (!videoLayer) {
-			throw CommandException(
-				"Current renderer doesn't support taking screenshots.");
+		auto image = [&] {
+			auto* videoLayer = dynamic_cast<VideoLayer*>(
+				display.findActiveLayer());
+			if (!videoLayer) {
+				// No renderer that produces frames ('-renderer none'),
+				// rasterize the current VDP state instead.
+				auto* motherBoard = display.reactor.getMotherBoard();
+				auto* vdp = motherBoard ? dynamic_cast<VDP*>(motherBoard->findDevice("VDP"))
+				                        : nullptr;
+				if (!vdp) {
+					throw CommandException(
+						"Current renderer doesn't support taking screenshots.");
+				}
+				if (scaler || (size != "auto")) {
+					throw CommandException(
+						"-size and -scaler are not supported when there's "
+						"no renderer.");
+				}
+				return VDPScreenShot::grab(*vdp, motherBoard->getCurrentTime());
+			}
+			std::optional<unsigned> height = size == "auto" ? std::nullopt : size == "640" ? std::optional(480) : std::optional(240);
+			try {
+				return videoLayer->takeRawScreenShot(height, scaler);
+			} catch (MSXException& e) {
+				throw CommandException(
+					"Failed to take screenshot: ", e.getMessage());
+			}
+		}();
+
+		if (!compareName.empty()) {
+			// Compare in memory, only the (optional) difference image
+			// is written to file.
+			try {
+				auto reference = ImageDiff::load(
+					FileOperations::expandTilde(std::string(compareName)));
+				ScreenShotWriter::Image diff;
+				auto r = ImageDiff::compare(image, reference,
+				                            diffName.empty() ? nullptr : &diff);
+				if (!diffName.empty()) {
+					target.filename = FileOperations::parseCommandFileArgument(
+						diffName, SCREENSHOT_DIR, "", getExtension(target.format));
+					display.getScreenShotWriter().save(std::move(diff), target);
+					result.addDictKeyValue("diff", target.filename);
+				}
+				result.addDictKeyValues("pixels", r.numPixels,
+				                        "different", r.numDifferent,
+				                        "max_delta", r.maxDelta,
+				                        "mean_delta", r.getMeanDelta());
+			} catch (MSXException& e) {
+				throw CommandException(
+					"Failed to compare screenshot: ", e.getMessage());
+			}
+			return;
 		}
-		std::optional<unsigned> height = size == "auto" ? std::nullopt : size == "640" ? std::optional(480) : std::optional(240);
+
 		try {
-			videoLayer->takeRawScreenShot(height, filename);
+			display.getScreenShotWriter().save(std::move(image), target);
 		} catch (MSXException& e) {
 			throw CommandException(
 				"Failed to take screenshot: ", e.getMessage());
 		}
 	}
 
-	result = filename;
+	result = target.filename;
 }
 
 std::string Display::ScreenShotCmd::help(std::span<const TclObject> /*tokens*/) const
@@ -1,7 +1,10 @@
 #ifndef DISPLAY_HH
 #define DISPLAY_HH
 
+#include "FramePacer.hh"
+#include "InputLatencyMeter.hh"
 #include "RenderSettings.hh"
+#include "ScreenShotWriter.hh"
 
 #include "Command.hh"
 #include "EventListener.hh"
@@ -49,6 +52,7 @@ public:
 	[[nodiscard]] RenderSettings& getRenderSettings() { return renderSettings; }
 	[[nodiscard]] auto getRenderer() const { return currentRenderer; }
 	[[nodiscard]] OSDGUI& getOSDGUI() { return osdGui; }
+	[[nodiscard]] ScreenShotWriter& getScreenShotWriter() { return screenShotWriter; }
 
 	/** Redraw the display.
 	  * The repaintImpl() methods are for internal and VideoSystem/VisibleSurface use only.
@@ -85,8 +89,14 @@ public:
 	// Get the latest fps value
 	[[nodiscard]] float getFps() const;
 
+	/** Weight of the last MSX frame in the image that's being painted,
+	  * the rest is the frame before (see 'frame_pacing' = blend).
+	  */
+	[[nodiscard]] float getFrameBlend() const { return frameBlend; }
+
 private:
 	void resetVideoSystem();
+	void updateFps(uint64_t now);
 
 	// EventListener interface
 	bool signalEvent(const Event& event) override;
@@ -117,6 +127,9 @@ private:
 	uint64_t frameDurationSum;
 	uint64_t prevTimeStamp;
 
+	FramePacer framePacer;
+	float frameBlend = 1.0f;
+
 	struct ScreenShotCmd final : Command {
 		explicit ScreenShotCmd(CommandController& commandController);
 		void execute(std::span<const TclObject> tokens, TclObject& result) override;
@@ -134,6 +147,8 @@ private:
 
 	Reactor& reactor;
 	RenderSettings renderSettings;
+	InputLatencyMeter inputLatencyMeter;
+	ScreenShotWriter screenShotWriter;
 
 	// the current renderer
 	RenderSettings::RendererID currentRenderer = RenderSettings::RendererID::UNINITIALIZED;
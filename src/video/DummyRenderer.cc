@@ -89,6 +89,9 @@ void DummyRenderer::updateSpritesEnabled(bool /*enabled*/, EmuTime /*time*/) {
 void DummyRenderer::updateVRAM(unsigned /*offset*/, EmuTime /*time*/) {
 }
 
+void DummyRenderer::updateVRAMRange(unsigned /*offset*/, unsigned /*num*/, EmuTime /*time*/) {
+}
+
 void DummyRenderer::updateWindow(bool /*enabled*/, EmuTime /*time*/) {
 }
 
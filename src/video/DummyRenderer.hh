@@ -41,6 +41,7 @@ public:
 	void updateColorBase(unsigned addr, EmuTime time) override;
 	void updateSpritesEnabled(bool enabled, EmuTime time) override;
 	void updateVRAM(unsigned offset, EmuTime time) override;
+	void updateVRAMRange(unsigned offset, unsigned num, EmuTime time) override;
 	void updateWindow(bool enabled, EmuTime time) override;
 
 	// Layer interface:
@@ -0,0 +1,276 @@
+#include "FrameHashLogger.hh"
+
+#include "PostProcessor.hh"
+#include "RawFrame.hh"
+
+#include "CliComm.hh"
+#include "CommandException.hh"
+#include "Debugger.hh"
+#include "Display.hh"
+#include "FileContext.hh"
+#include "FileException.hh"
+#include "FileOperations.hh"
+#include "MSXCliComm.hh"
+#include "MSXMixer.hh"
+#include "MSXMotherBoard.hh"
+#include "Ram.hh"
+#include "Reactor.hh"
+#include "TclArgParser.hh"
+#include "TclObject.hh"
+
+#include "Math.hh"
+#include "MemBuffer.hh"
+#include "outer.hh"
+#include "strCat.hh"
+#include "xrange.hh"
+#include "xxhash.hh"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <string_view>
+#include <utility>
+
+namespace openmsx {
+
+template<typename T>
+[[nodiscard]] static uint32_t hashOf(std::span<const T> data)
+{
+	return xxhash(std::string_view(std::bit_cast<const char*>(data.data()), data.size_bytes()));
+}
+
+// Hash each line (only the used part of it, plus its width), then hash
+// those hashes.
+[[nodiscard]] static uint32_t hashFrame(const RawFrame& frame)
+{
+	std::vector<uint32_t> lineHashes;
+	lineHashes.reserve(2 * size_t(frame.getHeight()));
+	for (auto y : xrange(frame.getHeight())) {
+		auto width = frame.getLineWidthDirect(y);
+		lineHashes.push_back(width);
+		lineHashes.push_back(hashOf(frame.getLineDirect(y).first(width)));
+	}
+	return hashOf(std::span<const uint32_t>(lineHashes));
+}
+
+FrameHashLogger::FrameHashLogger(Reactor& reactor_)
+	: reactor(reactor_)
+	, frameHashCommand(reactor.getCommandController())
+{
+}
+
+FrameHashLogger::~FrameHashLogger()
+{
+	stop();
+}
+
+void FrameHashLogger::stop()
+{
+	for (auto* pp : postProcessors) {
+		pp->setFrameHashLogger(nullptr);
+	}
+	postProcessors.clear();
+	if (mixer) {
+		mixer->setFrameHashLogger(nullptr);
+		mixer = nullptr;
+	}
+	motherBoard = nullptr;
+	file = File();
+	audioBuf.clear();
+}
+
+void FrameHashLogger::addWave(std::span<const StereoFloat> data)
+{
+	// Same conversion as for avi recording: only differences that are
+	// audible in the 16-bit output matter.
+	for (const auto& s : data) {
+		audioBuf.push_back(Math::clipToInt16(lrintf(32768.0f * s.left)));
+		audioBuf.push_back(Math::clipToInt16(lrintf(32768.0f * s.right)));
+	}
+}
+
+uint32_t FrameHashLogger::hashRam() const
+{
+	// All RAM that has a debuggable (main RAM, memory mappers, ...), in a
+	// fixed order (the debuggables are stored in a hash map).
+	std::vector<std::pair<std::string_view, RamDebuggable*>> rams;
+	for (const auto& [name, debuggable] : motherBoard->getDebugger().getDebuggables()) {
+		if (auto* ram = dynamic_cast<RamDebuggable*>(debuggable)) {
+			rams.emplace_back(name, ram);
+		}
+	}
+	std::ranges::sort(rams, {}, &std::pair<std::string_view, RamDebuggable*>::first);
+
+	std::vector<uint32_t> hashes;
+	MemBuffer<uint8_t> buf;
+	for (auto [name, ram] : rams) {
+		buf.resize(ram->getSize());
+		ram->readBlock(0, buf);
+		hashes.push_back(hashOf(std::span<const uint8_t>(buf)));
+	}
+	return hashOf(std::span<const uint32_t>(hashes));
+}
+
+void FrameHashLogger::addFrame(const RawFrame& frame, EmuTime time)
+{
+	assert(isActive());
+	mixer->updateStream(time); // all audio up to the end of this frame
+
+	auto hashes = strCat(hex_string<8>(hashFrame(frame)), ' ',
+	                     hex_string<8>(hashOf(std::span<const int16_t>(audioBuf))));
+	audioBuf.clear();
+	if (withRam) {
+		strAppend(hashes, ' ', hex_string<8>(hashRam()));
+	}
+
+	if (file.is_open()) {
+		auto line = strCat(frameCount, ' ', hashes, '\n');
+		file.write(std::span{line});
+	}
+	if (toCliComm) {
+		motherBoard->getMSXCliComm().update(
+			CliComm::UpdateType::FRAME_HASH, tmpStrCat(frameCount), hashes);
+	}
+	++frameCount;
+}
+
+void FrameHashLogger::processStart(Interpreter& interp, std::span<const TclObject> tokens, TclObject& result)
+{
+	std::string_view prefix = "openmsx";
+	bool ram = false;
+	bool cliComm = false;
+	std::array info = {
+		valueArg("-prefix", prefix),
+		flagArg("-ram", ram),
+		flagArg("-clicomm", cliComm),
+	};
+	auto arguments = parseTclArgs(interp, tokens.subspan(2), info);
+	std::string_view filenameArg;
+	switch (arguments.size()) {
+	case 0:
+		// nothing
+		break;
+	case 1:
+		filenameArg = arguments[0].getString();
+		break;
+	default:
+		throw SyntaxError();
+	}
+
+	if (isActive()) {
+		throw CommandException("Already logging frame hashes.");
+	}
+	auto* board = reactor.getMotherBoard();
+	if (!board) {
+		throw CommandException("No machine.");
+	}
+	postProcessors.clear();
+	for (auto* l : reactor.getDisplay().getAllLayers()) {
+		if (auto* pp = dynamic_cast<PostProcessor*>(l)) {
+			postProcessors.push_back(pp);
+		}
+	}
+	if (postProcessors.empty()) {
+		throw CommandException(
+			"Current renderer doesn't produce frames to hash.");
+	}
+
+	// Only write a file when asked for, or when there's no other output.
+	filename.clear();
+	if (!cliComm || !filenameArg.empty()) {
+		filename = FileOperations::parseCommandFileArgument(
+			filenameArg, LOG_DIR, prefix, LOG_EXTENSION);
+		try {
+			file = File(filename, File::OpenMode::TRUNCATE);
+			std::string_view header = ram ? "# frame video audio ram\n"
+			                              : "# frame video audio\n";
+			file.write(std::span{header});
+		} catch (FileException& e) {
+			throw CommandException("Can't start logging frame hashes: ",
+			                       e.getMessage());
+		}
+	}
+	toCliComm = cliComm;
+	withRam = ram;
+	frameCount = 0;
+	audioBuf.clear();
+
+	// only register when all errors are checked for
+	motherBoard = board;
+	for (auto* pp : postProcessors) {
+		pp->setFrameHashLogger(this);
+	}
+	mixer = &motherBoard->getMSXMixer();
+	mixer->setFrameHashLogger(this);
+	result = filename;
+}
+
+void FrameHashLogger::status(TclObject& result) const
+{
+	result.addDictKeyValues("status", isActive() ? "active" : "idle",
+	                        "filename", filename,
+	                        "frames", frameCount,
+	                        "ram", withRam,
+	                        "clicomm", toCliComm);
+}
+
+
+// class FrameHashLogger::Cmd
+
+FrameHashLogger::Cmd::Cmd(CommandController& commandController_)
+	: Command(commandController_, "frame_hash")
+{
+}
+
+void FrameHashLogger::Cmd::execute(std::span<const TclObject> tokens, TclObject& result)
+{
+	if (tokens.size() < 2) {
+		throw CommandException("Missing argument");
+	}
+	auto& logger = OUTER(FrameHashLogger, frameHashCommand);
+	executeSubCommand(tokens[1].getString(),
+		"start",  [&]{ logger.processStart(getInterpreter(), tokens, result); },
+		"stop",   [&]{
+			checkNumArgs(tokens, 2, Prefix{2}, nullptr);
+			logger.stop(); },
+		"status", [&]{
+			checkNumArgs(tokens, 2, Prefix{2}, nullptr);
+			logger.status(result); });
+}
+
+std::string FrameHashLogger::Cmd::help(std::span<const TclObject> /*tokens*/) const
+{
+	return "Log a hash of the video, audio and optionally RAM of each frame, to check\n"
+	       "whether two runs are identical (determinism tests).\n"
+	       "frame_hash start              Log to file 'openmsxNNNN.txt'\n"
+	       "frame_hash start <filename>   Log to given file\n"
+	       "frame_hash start -prefix foo  Log to file 'fooNNNN.txt'\n"
+	       "frame_hash stop               Stop logging\n"
+	       "frame_hash status             Query logging state\n"
+	       "\n"
+	       "The start subcommand also accepts the -ram flag, to also hash all RAM, and\n"
+	       "the -clicomm flag, to send the hashes as 'framehash' updates to the\n"
+	       "CliComm connections (then a file is only written when a filename is given).\n"
+	       "Each line contains the frame number, then the hash of the frame, of the\n"
+	       "audio of that frame and (optionally) of the RAM at the end of the frame.";
+}
+
+void FrameHashLogger::Cmd::tabCompletion(std::vector<std::string>& tokens) const
+{
+	using namespace std::literals;
+	if (tokens.size() == 2) {
+		static constexpr std::array cmds = {
+			"start"sv, "stop"sv, "status"sv,
+		};
+		completeString(tokens, cmds);
+	} else if ((tokens.size() >= 3) && (tokens[1] == "start")) {
+		static constexpr std::array options = {
+			"-prefix"sv, "-ram"sv, "-clicomm"sv,
+		};
+		completeFileName(tokens, userFileContext(), options);
+	}
+}
+
+} // namespace openmsx
@@ -0,0 +1,81 @@
+#ifndef FRAMEHASHLOGGER_HH
+#define FRAMEHASHLOGGER_HH
+
+#include "Command.hh"
+#include "EmuTime.hh"
+#include "File.hh"
+#include "Mixer.hh"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace openmsx {
+
+class Interpreter;
+class MSXMixer;
+class MSXMotherBoard;
+class PostProcessor;
+class RawFrame;
+class Reactor;
+class TclObject;
+
+/** Logs a hash of each emulated frame, for cheap determinism checks.
+  *
+  * For each completed frame (of the active video source) this computes an
+  * xxhash of the RawFrame, of the audio that was generated during that
+  * frame and optionally of all RAM. Two runs (e.g. of different builds or
+  * on different hosts) can then be compared line by line, the first line
+  * that differs pinpoints the frame where the emulation diverged. The
+  * hashes are written to a text file and/or sent as 'framehash' CliComm
+  * updates.
+  *
+  * While active, sound is generated as-if running at 100% speed (like
+  * during avi recording), so the audio hashes don't depend on the 'speed'
+  * setting.
+  */
+class FrameHashLogger
+{
+public:
+	static constexpr std::string_view LOG_DIR = "framehashes";
+	static constexpr std::string_view LOG_EXTENSION = ".txt";
+
+public:
+	explicit FrameHashLogger(Reactor& reactor);
+	~FrameHashLogger();
+
+	void addWave(std::span<const StereoFloat> data);
+	void addFrame(const RawFrame& frame, EmuTime time);
+	void stop();
+	[[nodiscard]] bool isActive() const { return mixer != nullptr; }
+
+private:
+	void processStart(Interpreter& interp, std::span<const TclObject> tokens, TclObject& result);
+	void status(TclObject& result) const;
+	[[nodiscard]] uint32_t hashRam() const;
+
+private:
+	Reactor& reactor;
+
+	struct Cmd final : Command {
+		explicit Cmd(CommandController& commandController);
+		void execute(std::span<const TclObject> tokens, TclObject& result) override;
+		[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
+		void tabCompletion(std::vector<std::string>& tokens) const override;
+	} frameHashCommand;
+
+	std::vector<PostProcessor*> postProcessors;
+	MSXMixer* mixer = nullptr; // non-null while active
+	MSXMotherBoard* motherBoard = nullptr;
+	File file; // not open when only logging to CliComm
+	std::string filename;
+	std::vector<int16_t> audioBuf; // audio of the current frame
+	uint64_t frameCount = 0;
+	bool toCliComm = false;
+	bool withRam = false;
+};
+
+} // namespace openmsx
+
+#endif
@@ -0,0 +1,64 @@
+#include "FramePacer.hh"
+
+#include <algorithm>
+
+namespace openmsx {
+
+// Start painting a bit earlier than strictly needed.
+static constexpr uint64_t SAFETY_MARGIN = 500; // us
+// Without new MSX frames for this long, stop painting at the host rate.
+static constexpr uint64_t IDLE_TIMEOUT = 100'000; // us
+
+void FramePacer::setRefreshRate(std::optional<double> hz)
+{
+	// reject nonsense values (e.g. 0 when SDL doesn't know)
+	auto rate = (hz && (*hz >= 20.0) && (*hz <= 1000.0)) ? *hz : 60.0;
+	period = uint64_t(1'000'000.0 / rate);
+}
+
+void FramePacer::frameFinished(uint64_t time)
+{
+	finished[1] = finished[0];
+	finished[0] = time;
+}
+
+bool FramePacer::isActive(uint64_t now) const
+{
+	return (finished[0] != 0) && (now - finished[0] < IDLE_TIMEOUT);
+}
+
+void FramePacer::presented(uint64_t renderTime, uint64_t swapTime)
+{
+	renderEstimate = std::max(renderTime, renderEstimate - renderEstimate / 16);
+	lastSwap = swapTime;
+}
+
+uint64_t FramePacer::getNextPaintTime(uint64_t now) const
+{
+	auto lead = renderEstimate + SAFETY_MARGIN;
+	if (lastSwap == 0) return now + period;
+	// first vblank (after the last one) that can still be reached
+	auto earliest = now + lead;
+	auto vblank = lastSwap + period;
+	if (vblank < earliest) {
+		vblank += ((earliest - vblank + period - 1) / period) * period;
+	}
+	return vblank - lead;
+}
+
+uint64_t FramePacer::getDisplayTime(uint64_t now) const
+{
+	auto earliest = now + renderEstimate;
+	if (lastSwap == 0 || lastSwap >= earliest) return earliest;
+	return lastSwap + ((earliest - lastSwap + period - 1) / period) * period;
+}
+
+float FramePacer::getBlendFactor(uint64_t displayTime) const
+{
+	if (finished[1] == 0) return 1.0f;
+	auto interval = finished[0] - finished[1];
+	if (interval == 0 || displayTime <= finished[0]) return 0.0f;
+	return std::min(1.0f, float(displayTime - finished[0]) / float(interval));
+}
+
+} // namespace openmsx
@@ -0,0 +1,68 @@
+#ifndef FRAMEPACER_HH
+#define FRAMEPACER_HH
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace openmsx {
+
+/** Decides when to present frames on the host display, for the 'host' and
+  * 'blend' frame pacing modes (see RenderSettings::FramePacing).
+  *
+  * Finished MSX frames are queued with their (real) timestamp. Painting
+  * is scheduled so that it's done just before the next vblank of the host
+  * display. The vblank phase is derived from the moment the buffer swap
+  * returned (with vsync on, that's right after a vblank). Because painting
+  * then (almost) never has to wait for a vblank, the emulation doesn't get
+  * blocked by the swap.
+  *
+  * For 'blend', the presented image is a mix of the last two MSX frames,
+  * weighted by the time at which it will become visible. This delays the
+  * image by one MSX frame, but gives smooth motion when the host refresh
+  * rate is not a multiple of the MSX frame rate.
+  *
+  * All times are in us, as returned by Timer::getTime().
+  */
+class FramePacer
+{
+public:
+	/** The refresh rate of the host display (in Hz), nullopt when unknown
+	  * (then 60Hz is assumed).
+	  */
+	void setRefreshRate(std::optional<double> hz);
+	[[nodiscard]] uint64_t getRefreshPeriod() const { return period; }
+
+	/** An MSX frame was finished at the given time. */
+	void frameFinished(uint64_t time);
+
+	/** Are MSX frames (still) being produced? E.g. not when paused. */
+	[[nodiscard]] bool isActive(uint64_t now) const;
+
+	/** A frame was presented.
+	  * @param renderTime How long painting took (excluding the swap).
+	  * @param swapTime The moment the buffer swap returned.
+	  */
+	void presented(uint64_t renderTime, uint64_t swapTime);
+
+	/** When to start painting the next frame. */
+	[[nodiscard]] uint64_t getNextPaintTime(uint64_t now) const;
+
+	/** Estimate for when a frame that's painted now becomes visible. */
+	[[nodiscard]] uint64_t getDisplayTime(uint64_t now) const;
+
+	/** The weight (in [0, 1]) of the last MSX frame in an image that
+	  * becomes visible at 'displayTime', the rest is the frame before.
+	  */
+	[[nodiscard]] float getBlendFactor(uint64_t displayTime) const;
+
+private:
+	std::array<uint64_t, 2> finished = {}; // [0] is the last
+	uint64_t period = 16'666; // 60Hz
+	uint64_t lastSwap = 0;
+	uint64_t renderEstimate = 2'000; // quickly rises, slowly decays
+};
+
+} // namespace openmsx
+
+#endif
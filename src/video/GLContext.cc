@@ -3,6 +3,7 @@
 #include "GLDefaultScaler.hh"
 #include "gl_transform.hh"
 
+#include <array>
 #include <memory>
 
 namespace gl {
@@ -12,25 +13,15 @@ std::optional<Context> context;
 
 Context::Context()
 {
-	VertexShader   texVertexShader  ("texture.vert");
-	FragmentShader texFragmentShader("texture.frag");
-	progTex.attach(texVertexShader);
-	progTex.attach(texFragmentShader);
-	progTex.bindAttribLocation(0, "a_position");
-	progTex.bindAttribLocation(1, "a_texCoord");
-	progTex.link();
+	progTex.build({}, "texture.vert", "texture.frag",
+	              std::array{"a_position", "a_texCoord"});
 	progTex.activate();
 	glUniform1i(progTex.getUniformLocation("u_tex"), 0);
 	unifTexColor = progTex.getUniformLocation("u_color");
 	unifTexMvp   = progTex.getUniformLocation("u_mvpMatrix");
 
-	VertexShader   fillVertexShader  ("fill.vert");
-	FragmentShader fillFragmentShader("fill.frag");
-	progFill.attach(fillVertexShader);
-	progFill.attach(fillFragmentShader);
-	progFill.bindAttribLocation(0, "a_position");
-	progFill.bindAttribLocation(1, "a_color");
-	progFill.link();
+	progFill.build({}, "fill.vert", "fill.frag",
+	               std::array{"a_position", "a_color"});
 	progFill.activate();
 	unifFillMvp = progFill.getUniformLocation("u_mvpMatrix");
 }
@@ -45,6 +36,34 @@ openmsx::GLScaler& Context::getFallbackScaler()
 	return *fallbackScaler;
 }
 
+void Context::flushFillBatch()
+{
+	if (fillBatch.empty()) return;
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	progFill.activate();
+	glUniformMatrix4fv(unifFillMvp, 1, GL_FALSE, pixelMvp.data());
+
+	char* base = nullptr;
+	glBindBuffer(GL_ARRAY_BUFFER, fillBatchBuffer.get());
+	glBufferData(GL_ARRAY_BUFFER, GLsizeiptr(fillBatch.size() * sizeof(FillVertex)),
+	             fillBatch.data(), GL_STREAM_DRAW);
+	glVertexAttribPointer(0, 2, GL_INT, GL_FALSE, sizeof(FillVertex),
+	                      base);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(FillVertex),
+	                      base + sizeof(ivec2));
+	glEnableVertexAttribArray(1);
+	glDrawArrays(GL_TRIANGLES, 0, GLsizei(fillBatch.size()));
+	glDisableVertexAttribArray(1);
+	glDisableVertexAttribArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glDisable(GL_BLEND);
+
+	fillBatch.clear();
+}
+
 void Context::setupMvpMatrix(gl::vec2 logicalSize)
 {
 	pixelMvp = ortho(logicalSize.x, logicalSize.y);
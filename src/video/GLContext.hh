@@ -3,8 +3,12 @@
 
 #include "GLUtil.hh"
 #include "gl_mat.hh"
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <span>
+#include <vector>
 
 namespace openmsx { class GLScaler; }
 
@@ -39,6 +43,20 @@ struct Context
 	ShaderProgram progFill;
 	GLint unifFillMvp;
 
+	// Triangles that are drawn with progFill (with pixelMvp) are collected
+	// here, so that e.g. lots of OSD rectangles can be drawn with a single
+	// draw call. The batch must be flushed before drawing anything else
+	// (to keep the drawing order) or changing the relevant openGL state
+	// (e.g. the scissor rectangle).
+	struct FillVertex {
+		ivec2 position;
+		std::array<uint8_t, 4> color;
+	};
+	void addFillTriangles(std::span<const FillVertex> vertices) {
+		fillBatch.insert(fillBatch.end(), vertices.begin(), vertices.end());
+	}
+	void flushFillBatch();
+
 	// Model-View-Projection-matrix that maps integer vertex positions to host
 	// display pixel positions. (0,0) is the top-left pixel, (width-1,height-1) is
 	// the bottom-right pixel.
@@ -54,6 +72,8 @@ struct Context
 
 private:
 	std::unique_ptr<openmsx::GLScaler> fallbackScaler;
+	std::vector<FillVertex> fillBatch;
+	BufferObject fillBatchBuffer;
 };
 
 extern std::optional<Context> context;
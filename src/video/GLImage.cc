@@ -102,7 +102,6 @@ GLImage::GLImage(ivec2 size_, uint32_t rgba)
 		auto alpha = narrow_cast<uint8_t>((rgba >> 0) & 0xff);
 		bgA[i] = (alpha == 255) ? 256 : alpha;
 	}
-	initBuffers();
 }
 
 GLImage::GLImage(ivec2 size_, std::span<const uint32_t, 4> rgba,
@@ -124,8 +123,6 @@ GLImage::GLImage(ivec2 size_, std::span<const uint32_t, 4> rgba,
 
 	auto alpha = narrow_cast<uint8_t>((borderRGBA >> 0) & 0xff);
 	borderA = (alpha == 255) ? 256 : alpha;
-
-	initBuffers();
 }
 
 GLImage::GLImage(SDLSurfacePtr image)
@@ -133,15 +130,6 @@ GLImage::GLImage(SDLSurfacePtr image)
 {
 }
 
-void GLImage::initBuffers() const
-{
-	// border
-	std::array<uint8_t, 10> indices = {4, 0, 5, 1, 6, 2, 7, 3, 4, 0};
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementsBuffer.get());
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices.data(), GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-}
-
 void GLImage::draw(ivec2 pos, uint8_t r, uint8_t g, uint8_t b, uint8_t alpha)
 {
 	// 4-----------------7
@@ -165,14 +153,11 @@ void GLImage::draw(ivec2 pos, uint8_t r, uint8_t g, uint8_t b, uint8_t alpha)
 		pos + ivec2(size.x     , 0          ), // 7
 	};
 
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	glBindBuffer(GL_ARRAY_BUFFER, vbo[0].get());
-	glBufferData(GL_ARRAY_BUFFER, sizeof(positions), positions.data(), GL_STREAM_DRAW);
-
 	auto& glContext = *gl::context;
 	if (texture.get()) {
+		// Draw everything that was batched before, to keep the order.
+		glContext.flushFillBatch();
+
 		std::array<vec2, 4> tex = {
 			vec2(0.0f, 0.0f),
 			vec2(0.0f, 1.0f),
@@ -180,6 +165,8 @@ void GLImage::draw(ivec2 pos, uint8_t r, uint8_t g, uint8_t b, uint8_t alpha)
 			vec2(1.0f, 0.0f),
 		};
 
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		glContext.progTex.activate();
 		glUniform4f(glContext.unifTexColor,
 		            narrow<float>(r)     * (1.0f / 255.0f),
@@ -188,6 +175,8 @@ void GLImage::draw(ivec2 pos, uint8_t r, uint8_t g, uint8_t b, uint8_t alpha)
 			    narrow<float>(alpha) * (1.0f / 255.0f));
 		glUniformMatrix4fv(glContext.unifTexMvp, 1, GL_FALSE,
 		                   glContext.pixelMvp.data());
+		glBindBuffer(GL_ARRAY_BUFFER, vbo[0].get());
+		glBufferData(GL_ARRAY_BUFFER, sizeof(positions), positions.data(), GL_STREAM_DRAW);
 		const ivec2* offset = nullptr;
 		glVertexAttribPointer(0, 2, GL_INT, GL_FALSE, 0, offset + 4);
 		glEnableVertexAttribArray(0);
@@ -199,52 +188,53 @@ void GLImage::draw(ivec2 pos, uint8_t r, uint8_t g, uint8_t b, uint8_t alpha)
 		glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 		glDisableVertexAttribArray(1);
 		glDisableVertexAttribArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glDisable(GL_BLEND);
 	} else {
+		// Untextured: only add triangles to the batch, this allows to
+		// draw many (OSD) rectangles with a single draw call.
 		assert(r == 255);
 		assert(g == 255);
 		assert(b == 255);
-		glContext.progFill.activate();
-		glUniformMatrix4fv(glContext.unifFillMvp, 1, GL_FALSE,
-		                   glContext.pixelMvp.data());
-		glVertexAttribPointer(0, 2, GL_INT, GL_FALSE, 0, nullptr);
-		glEnableVertexAttribArray(0);
-		glVertexAttrib4f(1,
-		                 narrow<float>(borderR) * (1.0f / 255.0f),
-		                 narrow<float>(borderG) * (1.0f / 255.0f),
-		                 narrow<float>(borderB) * (1.0f / 255.0f),
-		                 narrow<float>(borderA * alpha) * (1.0f / (255.0f * 255.0f)));
+		using Vertex = gl::Context::FillVertex;
+		std::array<uint8_t, 4> borderCol = {
+			borderR, borderG, borderB, uint8_t((borderA * alpha) / 256)};
+		auto quad = [&](std::array<int, 4> idx, std::array<std::array<uint8_t, 4>, 4> col) {
+			// triangle fan 0-1-2-3 -> triangles 0-1-2 and 0-2-3
+			std::array<Vertex, 6> v = {
+				Vertex{positions[idx[0]], col[0]},
+				Vertex{positions[idx[1]], col[1]},
+				Vertex{positions[idx[2]], col[2]},
+				Vertex{positions[idx[0]], col[0]},
+				Vertex{positions[idx[2]], col[2]},
+				Vertex{positions[idx[3]], col[3]},
+			};
+			glContext.addFillTriangles(v);
+		};
+		auto borderQuad = [&](std::array<int, 4> idx) {
+			quad(idx, {borderCol, borderCol, borderCol, borderCol});
+		};
 
 		if ((2 * borderSize >= abs(size.x)) ||
 		    (2 * borderSize >= abs(size.y))) {
 			// only border
-			glDrawArrays(GL_TRIANGLE_FAN, 4, 4);
+			borderQuad({4, 5, 6, 7});
 		} else {
 			// border
 			if (borderSize > 0) {
-				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementsBuffer.get());
-				glDrawElements(GL_TRIANGLE_STRIP, 10, GL_UNSIGNED_BYTE, nullptr);
-				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+				borderQuad({4, 0, 1, 5}); // left
+				borderQuad({5, 1, 2, 6}); // bottom
+				borderQuad({6, 2, 3, 7}); // right
+				borderQuad({7, 3, 0, 4}); // top
 			}
 
 			// interior
-			std::array col = {
-				std::array<uint8_t, 4>{bgR[0], bgG[0], bgB[0], uint8_t((bgA[0] * alpha) / 256)},
-				std::array<uint8_t, 4>{bgR[2], bgG[2], bgB[2], uint8_t((bgA[2] * alpha) / 256)},
-				std::array<uint8_t, 4>{bgR[3], bgG[3], bgB[3], uint8_t((bgA[3] * alpha) / 256)},
-				std::array<uint8_t, 4>{bgR[1], bgG[1], bgB[1], uint8_t((bgA[1] * alpha) / 256)},
+			auto bg = [&](int i) {
+				return std::array<uint8_t, 4>{bgR[i], bgG[i], bgB[i], uint8_t((bgA[i] * alpha) / 256)};
 			};
-			glBindBuffer(GL_ARRAY_BUFFER, vbo[2].get());
-			glBufferData(GL_ARRAY_BUFFER, sizeof(col), col.data(), GL_STREAM_DRAW);
-			glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
-			glEnableVertexAttribArray(1);
-			glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-			glDisableVertexAttribArray(1);
+			quad({0, 1, 2, 3}, {bg(0), bg(2), bg(3), bg(1)});
 		}
-		glDisableVertexAttribArray(0);
 	}
-	glDisableVertexAttribArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glDisable(GL_BLEND);
 }
 
 } // namespace openmsx
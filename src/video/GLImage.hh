@@ -42,13 +42,9 @@ public:
 	 */
 	static void checkSize(gl::ivec2 size);
 
-private:
-	void initBuffers() const;
-
 private:
 	gl::ivec2 size;
-	std::array<gl::BufferObject, 3> vbo;
-	gl::BufferObject elementsBuffer;
+	std::array<gl::BufferObject, 2> vbo;
 	gl::Texture texture{gl::Null()}; // must come after size
 	int borderSize{0};
 	std::array<uint16_t, 4> bgA; // 0..256
@@ -3,13 +3,21 @@
 #include "File.hh"
 #include "FileContext.hh"
 #include "FileException.hh"
+#include "FileOperations.hh"
 #include "InitException.hh"
 
 #include "Version.hh"
+#include "sha1.hh"
+#include "strCat.hh"
+#include "xrange.hh"
 
+#include <algorithm>
+#include <array>
 #include <bit>
 #include <cstdio>
 #include <iostream>
+#include <optional>
+#include <vector>
 
 using namespace openmsx;
 
@@ -139,11 +147,59 @@ void FrameBufferObject::pop()
 }
 
 
+// class PixelReadback
+
+PixelReadback::PixelReadback(ivec2 offset, ivec2 size_)
+	: size(size_)
+{
+	auto bytes = GLsizeiptr(size.x) * size.y * sizeof(uint32_t);
+	glGenBuffers(1, &bufferId);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, bufferId);
+	glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+	// OpenGL ES only supports reading RGBA (not RGB)
+	glReadPixels(offset.x, offset.y, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glFlush(); // make sure the GPU starts on it
+}
+
+PixelReadback::~PixelReadback()
+{
+	if (fence) glDeleteSync(fence);
+	glDeleteBuffers(1, &bufferId); // ok to delete 0-buffer
+}
+
+bool PixelReadback::isReady()
+{
+	if (!fence) return true;
+	if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) return false;
+	glDeleteSync(fence);
+	fence = nullptr;
+	return true;
+}
+
+void PixelReadback::read(std::span<uint32_t> out)
+{
+	auto w = size_t(size.x);
+	auto h = size_t(size.y);
+	assert(out.size() == w * h);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, bufferId);
+	// (when not yet ready, this blocks)
+	if (const auto* ptr = static_cast<const uint32_t*>(
+		glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY))) {
+		for (auto y : xrange(h)) {
+			std::copy_n(ptr + (h - 1 - y) * w, w, &out[y * w]);
+		}
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+
 // class Shader
 
-void Shader::init(GLenum type, std::string_view header, std::string_view filename)
+static std::string loadShaderSource(GLenum type, std::string_view header, std::string_view filename)
 {
-	// Load shader source.
 	std::string source;
 	if constexpr (OPENGL_VERSION == OPENGL_ES_2_0) {
 		source += "#version 100\n";
@@ -161,6 +217,12 @@ void Shader::init(GLenum type, std::string_view header, std::string_view filenam
 	auto mmap = File(systemFileContext().resolve(tmpStrCat("shaders/", filename)))
 	           .mmap<const char>();
 	source.append(std::bit_cast<const char*>(mmap.data()), mmap.size());
+	return source;
+}
+
+void Shader::init(GLenum type, std::string_view header, std::string_view filename)
+{
+	auto source = loadShaderSource(type, header, filename);
 
 	// Allocate shader handle.
 	handle = glCreateShader(type);
@@ -251,6 +313,108 @@ void ShaderProgram::link()
 	}
 }
 
+// Linked programs are cached in this directory, in files named after the
+// sha1 of everything the program depends on (sources, attribute locations,
+// driver). A file contains PROGRAM_MAGIC, the binary format and the binary.
+static constexpr std::string_view PROGRAM_MAGIC = "oMSXglp1";
+
+[[nodiscard]] static bool programBinarySupported()
+{
+	static const bool result = [] {
+		if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary) return false;
+		GLint numFormats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+		return numFormats > 0;
+	}();
+	return result;
+}
+
+[[nodiscard]] static std::string getProgramCacheName(
+	std::string_view header, std::string_view vertexFile, std::string_view fragmentFile,
+	std::span<const char* const> attributes)
+{
+	SHA1 sha1;
+	auto add = [&](std::string_view s) {
+		sha1.update(std::span{std::bit_cast<const uint8_t*>(s.data()), s.size() + 1}); // incl. separator
+	};
+	auto addGLString = [&](GLenum name) {
+		const auto* s = std::bit_cast<const char*>(glGetString(name));
+		add(s ? s : "");
+	};
+	addGLString(GL_VENDOR);
+	addGLString(GL_RENDERER);
+	addGLString(GL_VERSION);
+	add(loadShaderSource(GL_VERTEX_SHADER, header, vertexFile));
+	add(loadShaderSource(GL_FRAGMENT_SHADER, header, fragmentFile));
+	for (const auto* attribute : attributes) add(attribute);
+	return strCat(FileOperations::getUserDataDir(), "/shadercache/", sha1.digest());
+}
+
+[[nodiscard]] static bool loadProgramBinary(GLuint handle, const std::string& cacheName)
+{
+	try {
+		File file(cacheName);
+		auto size = file.getSize();
+		std::array<char, PROGRAM_MAGIC.size()> magic;
+		GLenum format = 0;
+		if (size <= (magic.size() + sizeof(format))) return false;
+		file.read(std::span<char>{magic});
+		if (std::string_view(magic.data(), magic.size()) != PROGRAM_MAGIC) return false;
+		file.read(std::span<GLenum>{&format, 1});
+		std::vector<uint8_t> binary(size - magic.size() - sizeof(format));
+		file.read(std::span<uint8_t>{binary});
+		glProgramBinary(handle, format, binary.data(), GLsizei(binary.size()));
+	} catch (MSXException&) {
+		return false; // not (yet) in the cache
+	}
+	// Fails e.g. after a driver update that doesn't change the version string.
+	GLint linkStatus = GL_FALSE;
+	glGetProgramiv(handle, GL_LINK_STATUS, &linkStatus);
+	return linkStatus == GL_TRUE;
+}
+
+static void saveProgramBinary(GLuint handle, const std::string& cacheName)
+{
+	GLint length = 0;
+	glGetProgramiv(handle, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) return;
+	std::vector<uint8_t> binary(length);
+	GLenum format = 0;
+	glGetProgramBinary(handle, length, nullptr, &format, binary.data());
+	try {
+		FileOperations::mkdirp(std::string(FileOperations::getDirName(cacheName)));
+		File file(cacheName, File::OpenMode::TRUNCATE);
+		file.write(std::span<const char>{PROGRAM_MAGIC});
+		file.write(std::span<const GLenum>{&format, 1});
+		file.write(std::span<const uint8_t>{binary});
+	} catch (MSXException&) {
+		// ignore, only means the program gets compiled again next time
+	}
+}
+
+void ShaderProgram::build(
+	std::string_view header, std::string_view vertexFile, std::string_view fragmentFile,
+	std::span<const char* const> attributes)
+{
+	std::optional<std::string> cacheName;
+	if (programBinarySupported()) {
+		cacheName = getProgramCacheName(header, vertexFile, fragmentFile, attributes);
+		if (loadProgramBinary(handle, *cacheName)) return;
+		glProgramParameteri(handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
+	VertexShader   vShader(header, vertexFile);
+	FragmentShader fShader(header, fragmentFile);
+	attach(vShader);
+	attach(fShader);
+	for (auto i : xrange(attributes.size())) {
+		bindAttribLocation(unsigned(i), attributes[i]);
+	}
+	link();
+
+	if (cacheName) saveProgramBinary(handle, *cacheName);
+}
+
 void ShaderProgram::bindAttribLocation(unsigned index, const char* name)
 {
 	glBindAttribLocation(handle, index, name);
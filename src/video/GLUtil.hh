@@ -289,6 +289,158 @@ void PixelBuffer<T>::unmap() const
 }
 
 
+/** A pixel (unpack) buffer that stays mapped during its whole lifetime.
+  * Uploads from such a buffer (e.g. glTexSubImage2D()) are executed
+  * asynchronously by the GPU, a fence is used to know when the buffer can be
+  * overwritten again. Requires OpenGL 4.4 or the ARB_buffer_storage
+  * extension, see isSupported().
+  */
+template<typename T> class PersistentPixelBuffer
+{
+public:
+	[[nodiscard]] static bool isSupported() {
+		return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+	}
+
+	/** @param size Number of elements (of type T). */
+	explicit PersistentPixelBuffer(size_t size);
+	PersistentPixelBuffer(const PersistentPixelBuffer&) = delete;
+	PersistentPixelBuffer(PersistentPixelBuffer&& other) noexcept
+		: mapped(other.mapped), bufferId(other.bufferId), fence(other.fence)
+	{
+		other.mapped = {};
+		other.bufferId = 0;
+		other.fence = nullptr;
+	}
+	PersistentPixelBuffer& operator=(const PersistentPixelBuffer&) = delete;
+	PersistentPixelBuffer& operator=(PersistentPixelBuffer&& other) noexcept {
+		std::swap(mapped,   other.mapped);
+		std::swap(bufferId, other.bufferId);
+		std::swap(fence,    other.fence);
+		return *this;
+	}
+	~PersistentPixelBuffer();
+
+	/** The mapped memory, write-only. Only write to it after waitFence(). */
+	[[nodiscard]] std::span<T> getMapped() const { return mapped; }
+
+	/** The value to pass as 'data' to e.g. glTexSubImage2D() (while this
+	  * buffer is bound) to refer to the given element of 'getMapped()'.
+	  */
+	[[nodiscard]] const void* getOffset(size_t index) const {
+		return std::bit_cast<const void*>(index * sizeof(T));
+	}
+
+	void bind() const { glBindBuffer(GL_PIXEL_UNPACK_BUFFER, bufferId); }
+	void unbind() const { glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0); }
+
+	/** Insert a fence after the uploads that are issued so far. */
+	void setFence();
+
+	/** Wait till all uploads before the last setFence() are finished. */
+	void waitFence();
+
+private:
+	std::span<T> mapped;
+	GLuint bufferId = 0;
+	GLsync fence = nullptr;
+};
+
+template<typename T>
+PersistentPixelBuffer<T>::PersistentPixelBuffer(size_t size)
+{
+	static constexpr GLbitfield flags =
+		GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	auto bytes = GLsizeiptr(size * sizeof(T));
+	glGenBuffers(1, &bufferId);
+	bind();
+	glBufferStorage(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, flags);
+	auto* ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes, flags);
+	unbind();
+	if (ptr) mapped = std::span{std::bit_cast<T*>(ptr), size};
+}
+
+template<typename T>
+PersistentPixelBuffer<T>::~PersistentPixelBuffer()
+{
+	if (fence) glDeleteSync(fence);
+	if (!mapped.empty()) {
+		bind();
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		unbind();
+	}
+	glDeleteBuffers(1, &bufferId); // ok to delete 0-buffer
+}
+
+template<typename T>
+void PersistentPixelBuffer<T>::setFence()
+{
+	if (fence) glDeleteSync(fence);
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+template<typename T>
+void PersistentPixelBuffer<T>::waitFence()
+{
+	if (!fence) return;
+	// Typically the upload finished long ago (it was issued one frame
+	// earlier), so this normally doesn't block.
+	while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000) ==
+	       GL_TIMEOUT_EXPIRED) {
+		// keep waiting
+	}
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+
+/** Reads back a part of the current framebuffer via a pixel (pack) buffer.
+  * The constructor only issues the read, the GPU executes it asynchronously.
+  * Later, when isReady(), the pixels can be fetched without stalling the
+  * pipeline. Requires OpenGL 3.2 or the ARB_sync extension, see
+  * isSupported().
+  */
+class PixelReadback
+{
+public:
+	[[nodiscard]] static bool isSupported() {
+		return GLEW_VERSION_3_2 || GLEW_ARB_sync;
+	}
+
+	/** Start reading the given rectangle (in GL coordinates: (0, 0) is
+	  * bottom left) as RGBA pixels. */
+	PixelReadback(ivec2 offset, ivec2 size);
+	PixelReadback(const PixelReadback&) = delete;
+	PixelReadback(PixelReadback&& other) noexcept
+		: size(other.size), bufferId(other.bufferId), fence(other.fence)
+	{
+		other.bufferId = 0;
+		other.fence = nullptr;
+	}
+	PixelReadback& operator=(const PixelReadback&) = delete;
+	PixelReadback& operator=(PixelReadback&& other) noexcept {
+		std::swap(size,     other.size);
+		std::swap(bufferId, other.bufferId);
+		std::swap(fence,    other.fence);
+		return *this;
+	}
+	~PixelReadback();
+
+	[[nodiscard]] ivec2 getSize() const { return size; }
+
+	/** Has the GPU finished the read? Doesn't block. */
+	[[nodiscard]] bool isReady();
+
+	/** Copy the pixels to 'out', with the rows from top to bottom (so
+	  * flipped compared to openGL). Blocks when the read isn't finished. */
+	void read(std::span<uint32_t> out);
+
+private:
+	ivec2 size;
+	GLuint bufferId = 0;
+	GLsync fence = nullptr;
+};
+
 
 /** Wrapper around an OpenGL shader: a program executed on the GPU.
   * This class is a base class for vertex and fragment shaders.
@@ -389,6 +541,17 @@ public:
 	  */
 	void link();
 
+	/** Compiles the given vertex and fragment shader (both with 'header'
+	  * prepended), binds the attribute names to locations 0, 1, ... and
+	  * links them. This replaces the attach(), bindAttribLocation() and
+	  * link() calls.
+	  * When the driver supports it (GL 4.1 or ARB_get_program_binary) the
+	  * linked program is cached on disk. Next time the cached binary is
+	  * loaded, which is a lot faster than compiling the shaders.
+	  */
+	void build(std::string_view header, std::string_view vertexFile,
+	           std::string_view fragmentFile, std::span<const char* const> attributes);
+
 	/** Bind the given name for a vertex shader attribute to the given
 	  * location.
 	  */
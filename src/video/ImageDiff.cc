@@ -0,0 +1,180 @@
+#include "ImageDiff.hh"
+
+#include "File.hh"
+#include "MSXException.hh"
+#include "PNG.hh"
+#include "PixelOperations.hh"
+
+#include "one_of.hh"
+#include "xrange.hh"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdlib>
+#include <optional>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace openmsx::ImageDiff {
+
+using Pixel = uint32_t;
+
+void Result::merge(const Result& other)
+{
+	numPixels    += other.numPixels;
+	numDifferent += other.numDifferent;
+	sumDelta     += other.sumDelta;
+	maxDelta = std::max(maxDelta, other.maxDelta);
+}
+
+Result compareLine(std::span<const Pixel> line1, std::span<const Pixel> line2,
+                   std::span<Pixel> diff)
+{
+	assert(line1.size() == line2.size());
+	assert(diff.empty() || (diff.size() == line1.size()));
+
+	PixelOperations pixelOps;
+	const Pixel alpha = pixelOps.getAmask();
+	Result result;
+	result.numPixels = line1.size();
+
+	size_t i = 0;
+#ifdef __SSE2__
+	// 4 pixels at a time: the absolute difference of all bytes, then
+	// _mm_sad_epu8() sums those (the alpha bytes are masked out).
+	const auto* p1 = std::bit_cast<const __m128i*>(line1.data());
+	const auto* p2 = std::bit_cast<const __m128i*>(line2.data());
+	auto* pd = std::bit_cast<__m128i*>(diff.data());
+	const auto rgbMask = _mm_set1_epi32(int(~alpha));
+	const auto alphaMask = _mm_set1_epi32(int(alpha));
+	const auto zero = _mm_setzero_si128();
+	auto sum = zero;
+	auto max = zero;
+	size_t n = line1.size() / 4;
+	for (auto j : xrange(n)) {
+		auto x = _mm_and_si128(_mm_loadu_si128(p1 + j), rgbMask);
+		auto y = _mm_and_si128(_mm_loadu_si128(p2 + j), rgbMask);
+		auto d = _mm_or_si128(_mm_subs_epu8(x, y), _mm_subs_epu8(y, x));
+		sum = _mm_add_epi64(sum, _mm_sad_epu8(d, zero));
+		max = _mm_max_epu8(max, d);
+		auto same = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(d, zero)));
+		result.numDifferent += 4 - std::popcount(unsigned(same));
+		if (pd) _mm_storeu_si128(pd + j, _mm_or_si128(d, alphaMask));
+	}
+	alignas(16) std::array<uint64_t, 2> sums;
+	alignas(16) std::array<uint8_t, 16> maxs;
+	_mm_store_si128(std::bit_cast<__m128i*>(sums.data()), sum);
+	_mm_store_si128(std::bit_cast<__m128i*>(maxs.data()), max);
+	result.sumDelta = sums[0] + sums[1];
+	result.maxDelta = std::ranges::max(maxs);
+	i = 4 * n;
+#endif
+	for (/**/; i < line1.size(); ++i) {
+		Pixel x = line1[i] & ~alpha;
+		Pixel y = line2[i] & ~alpha;
+		Pixel d = alpha;
+		for (unsigned shift = 0; shift < 32; shift += 8) {
+			auto c = unsigned(std::abs(int((x >> shift) & 255) - int((y >> shift) & 255)));
+			result.sumDelta += c;
+			result.maxDelta = std::max(result.maxDelta, c);
+			d |= c << shift;
+		}
+		if (x != y) ++result.numDifferent;
+		if (!diff.empty()) diff[i] = d;
+	}
+	return result;
+}
+
+Result compare(const Image& image1, const Image& image2, Image* diff)
+{
+	if ((image1.width != image2.width) || (image1.height != image2.height)) {
+		throw MSXException(
+			"Images have a different size: ", image1.width, 'x', image1.height,
+			" vs ", image2.width, 'x', image2.height);
+	}
+	if (diff) *diff = Image(image1.width, image1.height);
+
+	Result result;
+	for (auto y : xrange(image1.height)) {
+		result.merge(compareLine(image1.getLine(y), image2.getLine(y),
+		                         diff ? diff->getLine(y) : std::span<Pixel>{}));
+	}
+	return result;
+}
+
+// Binary PPM with 8 bits per channel, as written by ScreenShotWriter.
+static std::optional<Image> loadPPM(std::span<const uint8_t> data)
+{
+	if ((data.size() < 2) || (data[0] != 'P') || (data[1] != '6')) return {};
+
+	size_t pos = 2;
+	auto readNumber = [&] {
+		while (pos < data.size()) {
+			if (data[pos] == '#') {
+				while ((pos < data.size()) && (data[pos] != '\n')) ++pos;
+			} else if (data[pos] == one_of(' ', '\t', '\r', '\n')) {
+				++pos;
+			} else {
+				break;
+			}
+		}
+		unsigned result = 0;
+		bool valid = false;
+		while ((pos < data.size()) && (data[pos] >= '0') && (data[pos] <= '9')) {
+			result = 10 * result + (data[pos++] - '0');
+			if (result > 65535) throw MSXException("Invalid PPM header");
+			valid = true;
+		}
+		if (!valid) throw MSXException("Invalid PPM header");
+		return result;
+	};
+	unsigned width  = readNumber();
+	unsigned height = readNumber();
+	unsigned maxVal = readNumber();
+	++pos; // single whitespace character
+	if (maxVal != 255) {
+		throw MSXException("Only PPM files with 8 bits per channel are supported");
+	}
+	if ((data.size() < pos) || ((data.size() - pos) < size_t(3) * width * height)) {
+		throw MSXException("PPM file is truncated");
+	}
+
+	PixelOperations pixelOps;
+	Image image(width, height);
+	const auto* in = &data[pos];
+	for (auto& p : image.pixels) {
+		p = pixelOps.combine(in[0], in[1], in[2]);
+		in += 3;
+	}
+	return image;
+}
+
+Image load(const std::string& filename)
+{
+	{
+		File file(filename);
+		auto data = file.mmap<const uint8_t>();
+		try {
+			if (auto image = loadPPM(std::span{data.data(), data.size()})) {
+				return std::move(*image);
+			}
+		} catch (MSXException& e) {
+			throw MSXException(
+				"Error while loading PPM file \"", filename, "\": ",
+				e.getMessage());
+		}
+	}
+
+	auto surface = PNG::load(filename, true);
+	Image image(unsigned(surface->w), unsigned(surface->h));
+	for (auto y : xrange(image.height)) {
+		std::ranges::copy(std::span{static_cast<const Pixel*>(surface.getLinePtr(y)), image.width},
+		                  image.getLine(y).begin());
+	}
+	return image;
+}
+
+} // namespace openmsx::ImageDiff
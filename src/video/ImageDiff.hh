@@ -0,0 +1,50 @@
+#ifndef IMAGEDIFF_HH
+#define IMAGEDIFF_HH
+
+#include "ScreenShotWriter.hh"
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+/** Compare (screenshot) images in memory, e.g. for visual regression tests.
+  * Only the color channels are compared, alpha is ignored.
+  */
+namespace openmsx::ImageDiff {
+
+	using Image = ScreenShotWriter::Image;
+
+	struct Result {
+		uint64_t numPixels = 0;
+		uint64_t numDifferent = 0; // pixels with at least one channel different
+		uint64_t sumDelta = 0; // sum of absolute channel differences
+		unsigned maxDelta = 0; // largest absolute channel difference
+
+		/** Average absolute difference per color channel [0..255]. */
+		[[nodiscard]] double getMeanDelta() const {
+			return numPixels ? double(sumDelta) / double(3 * numPixels) : 0.0;
+		}
+
+		void merge(const Result& other);
+	};
+
+	/** Compare two lines of pixels, both must have the same length.
+	  * Optionally store the per-channel absolute difference in 'diff' (so
+	  * black where both lines are the same). */
+	[[nodiscard]] Result compareLine(std::span<const uint32_t> line1,
+	                                 std::span<const uint32_t> line2,
+	                                 std::span<uint32_t> diff = {});
+
+	/** Compare two images of the same size, optionally also produce a
+	  * difference image (see compareLine()).
+	  * @throws MSXException when the sizes are different. */
+	[[nodiscard]] Result compare(const Image& image1, const Image& image2,
+	                             Image* diff = nullptr);
+
+	/** Load a reference image, either a PNG or a (binary) PPM file.
+	  * @throws MSXException when the file can't be read. */
+	[[nodiscard]] Image load(const std::string& filename);
+
+} // namespace openmsx::ImageDiff
+
+#endif
@@ -0,0 +1,168 @@
+#include "InputLatencyMeter.hh"
+
+#include "Display.hh"
+#include "PostProcessor.hh"
+#include "RawFrame.hh"
+
+#include "CliComm.hh"
+#include "CommandException.hh"
+#include "Event.hh"
+#include "EventDistributor.hh"
+#include "TclObject.hh"
+#include "Timer.hh"
+
+#include "outer.hh"
+#include "stl.hh"
+#include "xrange.hh"
+#include "xxhash.hh"
+
+#include <SDL.h>
+
+#include <array>
+#include <cstring>
+
+namespace openmsx {
+
+using namespace std::literals;
+
+// Give up when nothing changed on screen this long after the key press.
+static constexpr uint64_t TIMEOUT = 5'000'000; // us
+
+InputLatencyMeter::InputLatencyMeter(
+		Display& display_, EventDistributor& eventDistributor_,
+		CommandController& commandController)
+	: display(display_)
+	, eventDistributor(eventDistributor_)
+	, measureCmd(commandController)
+{
+	// Highest priority: the key press should also be seen when the console
+	// or the GUI has the focus (and this listener never blocks events).
+	eventDistributor.registerEventListener(EventType::KEY_DOWN, *this,
+	                                       EventDistributor::Priority::OTHER);
+	eventDistributor.registerEventListener(EventType::FRAME_DRAWN, *this);
+}
+
+InputLatencyMeter::~InputLatencyMeter()
+{
+	eventDistributor.unregisterEventListener(EventType::FRAME_DRAWN, *this);
+	eventDistributor.unregisterEventListener(EventType::KEY_DOWN, *this);
+}
+
+void InputLatencyMeter::start()
+{
+	if (!hashCurrentFrame()) {
+		throw CommandException(
+			"Measuring the input latency is not possible with the "
+			"current renderer.");
+	}
+	state = State::WAIT_KEY;
+}
+
+std::optional<uint32_t> InputLatencyMeter::hashCurrentFrame() const
+{
+	auto* postProcessor = dynamic_cast<PostProcessor*>(display.findActiveLayer());
+	if (!postProcessor) return {};
+	const auto* frame = postProcessor->getLastRawFrame();
+	if (!frame) return {};
+
+	uint32_t hash = 0;
+	for (auto y : xrange(frame->getHeight())) {
+		auto line = frame->getLineDirect(y).first(frame->getLineWidthDirect(y));
+		std::string_view bytes(reinterpret_cast<const char*>(line.data()),
+		                       line.size_bytes());
+		hash = hash * 31 + xxhash(bytes);
+	}
+	return hash;
+}
+
+void InputLatencyMeter::finish(std::optional<uint64_t> latency)
+{
+	state = State::IDLE;
+	lastResult = latency;
+	auto& cliComm = display.getCliComm();
+	if (latency) {
+		cliComm.printInfo("Input latency: ", double(*latency) * (1.0 / 1000.0),
+		                  "ms (key press to first changed frame)");
+	} else {
+		cliComm.printWarning("Input latency measurement failed: the screen "
+		                     "didn't change after the key press.");
+	}
+}
+
+bool InputLatencyMeter::signalEvent(const Event& event)
+{
+	if (state == State::IDLE) return false;
+
+	auto now = Timer::getTime();
+	std::visit(overloaded{
+		[&](const KeyDownEvent& e) {
+			if ((state != State::WAIT_KEY) || e.getRepeat()) return;
+			auto hash = hashCurrentFrame();
+			if (!hash) {
+				state = State::IDLE;
+				return;
+			}
+			referenceHash = *hash;
+			// The event might have waited a while in the SDL queue.
+			uint32_t sdlAge = SDL_GetTicks() - e.getCommonSdlEvent().timestamp;
+			keyTime = now - 1000 * uint64_t(sdlAge);
+			state = State::WAIT_FRAME;
+		},
+		[&](const FrameDrawnEvent& /*e*/) {
+			if (state != State::WAIT_FRAME) return;
+			auto hash = hashCurrentFrame();
+			if (hash && (*hash != referenceHash)) {
+				finish(now - keyTime);
+			} else if (!hash || ((now - keyTime) > TIMEOUT)) {
+				finish({});
+			}
+		},
+		[](const EventBase&) { /*ignore*/ }
+	}, event);
+	return false;
+}
+
+
+// class MeasureCmd
+
+InputLatencyMeter::MeasureCmd::MeasureCmd(CommandController& commandController_)
+	: Command(commandController_, "measure_input_latency")
+{
+}
+
+void InputLatencyMeter::MeasureCmd::execute(std::span<const TclObject> tokens, TclObject& result)
+{
+	checkNumArgs(tokens, Between{1, 2}, "?result?");
+	auto& meter = OUTER(InputLatencyMeter, measureCmd);
+	if (tokens.size() == 1) {
+		meter.start();
+		result = "Press a key that makes the MSX change the screen...";
+	} else if (tokens[1] == "result") {
+		if (meter.lastResult) {
+			result = double(*meter.lastResult) * (1.0 / 1000000.0);
+		}
+	} else {
+		throw SyntaxError();
+	}
+}
+
+std::string InputLatencyMeter::MeasureCmd::help(std::span<const TclObject> /*tokens*/) const
+{
+	return "measure_input_latency\n"
+	       "  Start an input latency measurement: the time between the next "
+	       "key press and the first displayed frame that is different from "
+	       "the frame at the moment of the key press. Only use this on a "
+	       "static screen. The result is printed when the measurement is "
+	       "done.\n"
+	       "measure_input_latency result\n"
+	       "  Returns the result (in seconds) of the last measurement, or "
+	       "an empty string if it failed.\n";
+}
+
+void InputLatencyMeter::MeasureCmd::tabCompletion(std::vector<std::string>& tokens) const
+{
+	static constexpr std::array cmds = {"result"sv};
+	completeString(tokens, cmds);
+}
+
+} // namespace openmsx
@@ -0,0 +1,65 @@
+#ifndef INPUTLATENCYMETER_HH
+#define INPUTLATENCYMETER_HH
+
+#include "Command.hh"
+#include "EventListener.hh"
+
+#include <cstdint>
+#include <optional>
+
+namespace openmsx {
+
+class Display;
+class EventDistributor;
+
+/** Measures the end-to-end input latency: the (real) time between a host
+  * key press and the first displayed frame that differs from the frame
+  * that was displayed at the moment of the key press.
+  *
+  * The measurement is started with the 'measure_input_latency' command,
+  * the next key press then starts the clock. Of course this only gives a
+  * meaningful result when the MSX screen is static until it reacts to that
+  * key press. The result is printed and also returned by
+  * 'measure_input_latency result'.
+  *
+  * The frames are compared on the output of the renderer (the last
+  * finished raw frame), so this includes the emulation latency (EventDelay,
+  * the time till the MSX program reads the input and updates VRAM, frame
+  * boundaries, ...) but not the latency of the host display.
+  */
+class InputLatencyMeter final : private EventListener
+{
+public:
+	InputLatencyMeter(Display& display, EventDistributor& eventDistributor,
+	                  CommandController& commandController);
+	~InputLatencyMeter();
+
+private:
+	void start();
+	[[nodiscard]] std::optional<uint32_t> hashCurrentFrame() const;
+	void finish(std::optional<uint64_t> latency);
+
+	// EventListener
+	bool signalEvent(const Event& event) override;
+
+private:
+	Display& display;
+	EventDistributor& eventDistributor;
+
+	struct MeasureCmd final : Command {
+		explicit MeasureCmd(CommandController& commandController);
+		void execute(std::span<const TclObject> tokens, TclObject& result) override;
+		[[nodiscard]] std::string help(std::span<const TclObject> tokens) const override;
+		void tabCompletion(std::vector<std::string>& tokens) const override;
+	} measureCmd;
+
+	enum class State : uint8_t { IDLE, WAIT_KEY, WAIT_FRAME };
+	State state = State::IDLE;
+	uint64_t keyTime = 0; // in us, see Timer::getTime()
+	uint32_t referenceHash = 0;
+	std::optional<uint64_t> lastResult; // in us
+};
+
+} // namespace openmsx
+
+#endif
@@ -1,7 +1,6 @@
 #include "OffScreenSurface.hh"
 
 #include "GLUtil.hh"
-#include "VisibleSurface.hh"
 
 namespace openmsx {
 
@@ -24,9 +23,4 @@ OffScreenSurface::OffScreenSurface(const OutputSurface& output)
 	fbo.push();
 }
 
-void OffScreenSurface::saveScreenshot(const std::string& filename)
-{
-	VisibleSurface::saveScreenshotGL(*this, filename);
-}
-
 } // namespace openmsx
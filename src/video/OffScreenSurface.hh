@@ -14,10 +14,6 @@ class OffScreenSurface final : public OutputSurface
 public:
 	explicit OffScreenSurface(const OutputSurface& output);
 
-private:
-	// OutputSurface
-	void saveScreenshot(const std::string& filename) override;
-
 private:
 	gl::Texture fboTex;
 	gl::FrameBufferObject fbo;
@@ -62,11 +62,6 @@ public:
 		return 0x00000000; // alpha = 0
 	}
 
-	/** Save the content of this OutputSurface to a PNG file.
-	  * @throws MSXException If creating the PNG file fails.
-	  */
-	virtual void saveScreenshot(const std::string& filename) = 0;
-
 protected:
 	OutputSurface() = default;
 
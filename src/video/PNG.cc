@@ -4,6 +4,7 @@
 
 #include "File.hh"
 #include "MSXException.hh"
+#include "ThreadPool.hh"
 #include "Version.hh"
 
 #include "cstdiop.hh"
@@ -11,9 +12,11 @@
 #include "narrow.hh"
 #include "one_of.hh"
 #include "small_buffer.hh"
+#include "xrange.hh"
 
 #include <SDL.h>
 #include <png.h>
+#include <zlib.h>
 
 #include <array>
 #include <bit>
@@ -24,6 +27,7 @@
 #include <iostream>
 #include <limits>
 #include <ranges>
+#include <vector>
 
 namespace openmsx::PNG {
 
@@ -232,8 +236,145 @@ static void flushData(png_structp ctx)
 	file->flush();
 }
 
+static uint8_t paethPredictor(uint8_t a, uint8_t b, uint8_t c)
+{
+	int p = a + b - c;
+	int pa = std::abs(p - a);
+	int pb = std::abs(p - b);
+	int pc = std::abs(p - c);
+	if ((pa <= pb) && (pa <= pc)) return a;
+	if (pb <= pc) return b;
+	return c;
+}
+
+// Filter one row of the image: 'out' gets the filter type byte followed by
+// the filtered row. 'prev' is the previous (unfiltered) row, or empty for
+// the first row. Like libpng we take the filter with the smallest sum of
+// absolute (signed) output values, though without the 'Average' filter.
+static void filterRow(std::span<const uint8_t> row, std::span<const uint8_t> prev,
+                      size_t bpp, std::span<uint8_t> out)
+{
+	assert(out.size() == (row.size() + 1));
+	auto left   = [&](size_t i) -> uint8_t { return (i >= bpp) ? row[i - bpp] : 0; };
+	auto up     = [&](size_t i) -> uint8_t { return prev.empty() ? 0 : prev[i]; };
+	auto upLeft = [&](size_t i) -> uint8_t { return (!prev.empty() && (i >= bpp)) ? prev[i - bpp] : 0; };
+	auto filter = [&](uint8_t type, size_t i) -> uint8_t {
+		switch (type) {
+		case 0:  return row[i];
+		case 1:  return uint8_t(row[i] - left(i));
+		case 2:  return uint8_t(row[i] - up(i));
+		default: return uint8_t(row[i] - paethPredictor(left(i), up(i), upLeft(i)));
+		}
+	};
+
+	static constexpr std::array<uint8_t, 4> types = {0, 1, 2, 4}; // none, sub, up, paeth
+	std::array<size_t, 4> sums = {};
+	for (auto i : xrange(row.size())) {
+		for (auto t : xrange(types.size())) {
+			sums[t] += std::abs(int(int8_t(filter(types[t], i))));
+		}
+	}
+	auto type = types[std::ranges::min_element(sums) - sums.begin()];
+	out[0] = type;
+	for (auto i : xrange(row.size())) {
+		out[i + 1] = filter(type, i);
+	}
+}
+
+// Compressed image data for a range of rows. All parts together form one
+// zlib stream: each part is a separate raw deflate stream that ends on a
+// byte boundary (Z_SYNC_FLUSH), except the last one, which is finished.
+struct DeflatedPart {
+	std::vector<uint8_t> data;
+	uLong adler = 0; // of the uncompressed (filtered) data
+	size_t size = 0; // of the uncompressed (filtered) data
+};
+
+static void deflateRows(std::span<const void*> rowPointers, size_t begin, size_t end,
+                        size_t rowBytes, size_t bpp, int compressionLevel,
+                        size_t headerSize, bool last, DeflatedPart& part)
+{
+	z_stream zs = {};
+	if (deflateInit2(&zs, compressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		throw MSXException("Failed to initialize zlib");
+	}
+	part.size = (end - begin) * (rowBytes + 1);
+	// Room for the worst case, plus the empty block of the sync flush.
+	part.data.resize(headerSize + deflateBound(&zs, uLong(part.size)) + 64);
+	zs.next_out = part.data.data() + headerSize;
+	zs.avail_out = uInt(part.data.size() - headerSize);
+
+	part.adler = adler32(0, nullptr, 0);
+	std::vector<uint8_t> filtered(rowBytes + 1);
+	for (auto y : xrange(begin, end)) {
+		auto row = std::span{static_cast<const uint8_t*>(rowPointers[y]), rowBytes};
+		auto prev = (y == 0) ? std::span<const uint8_t>{}
+		                     : std::span{static_cast<const uint8_t*>(rowPointers[y - 1]), rowBytes};
+		filterRow(row, prev, bpp, filtered);
+		part.adler = adler32(part.adler, filtered.data(), uInt(filtered.size()));
+		zs.next_in = filtered.data();
+		zs.avail_in = uInt(filtered.size());
+		auto r = deflate(&zs, Z_NO_FLUSH);
+		assert(r == Z_OK); (void)r;
+		assert(zs.avail_in == 0);
+	}
+	auto r = deflate(&zs, last ? Z_FINISH : Z_SYNC_FLUSH);
+	bool ok = last ? (r == Z_STREAM_END) : ((r == Z_OK) && (zs.avail_out != 0));
+	part.data.resize(part.data.size() - zs.avail_out);
+	deflateEnd(&zs);
+	if (!ok) throw MSXException("Failed to compress image data");
+}
+
+// Write the image data as (one or more) IDAT chunks. Bigger images are
+// split in stripes of rows that are compressed in parallel. This only
+// costs a few bytes per stripe, but the compression doesn't look back over
+// stripe boundaries.
+static void writeImageData(png_structp png, size_t width, std::span<const void*> rowPointers,
+                           bool color, int compressionLevel)
+{
+	static constexpr size_t STRIPE_SIZE = 256 * 1024; // in bytes of image data
+	static constexpr size_t HEADER_SIZE = 2; // zlib header, in front of the 1st part
+	auto height = rowPointers.size();
+	size_t bpp = color ? 3 : 1;
+	auto rowBytes = width * bpp;
+	auto rowsPerStripe = std::max<size_t>(1, STRIPE_SIZE / (rowBytes + 1));
+	auto numStripes = std::max<size_t>(1, (height + rowsPerStripe - 1) / rowsPerStripe);
+
+	std::vector<DeflatedPart> parts(numStripes);
+	ThreadPool::parallelForTemporary(numStripes, [&](size_t i) {
+		auto begin = i * rowsPerStripe;
+		auto end = std::min(begin + rowsPerStripe, height);
+		deflateRows(rowPointers, begin, end, rowBytes, bpp, compressionLevel,
+		            (i == 0) ? HEADER_SIZE : 0, i == (numStripes - 1), parts[i]);
+	});
+
+	// zlib header: deflate with 32kB window, plus the compression level
+	// (just informational), rounded up to a multiple of 31.
+	uint8_t cmf = 0x78;
+	uint8_t flevel = (compressionLevel < 2) ? 0 : (compressionLevel < 6) ? 1 : (compressionLevel == 6) ? 2 : 3;
+	auto flg = uint8_t(flevel << 6);
+	flg = uint8_t(flg + (31 - ((cmf * 256 + flg) % 31)) % 31);
+	parts.front().data[0] = cmf;
+	parts.front().data[1] = flg;
+
+	// zlib trailer: checksum of all uncompressed data
+	auto adler = adler32(0, nullptr, 0);
+	for (const auto& part : parts) {
+		adler = adler32_combine(adler, part.adler, z_off_t(part.size));
+	}
+	auto& lastData = parts.back().data;
+	auto pos = lastData.size();
+	lastData.resize(pos + 4);
+	Endian::write_UA_B32(&lastData[pos], uint32_t(adler));
+
+	static constexpr std::array<png_byte, 5> IDAT = {'I', 'D', 'A', 'T', 0};
+	for (const auto& part : parts) {
+		png_write_chunk(png, IDAT.data(), part.data.data(), part.data.size());
+	}
+}
+
 static void IMG_SavePNG_RW(size_t width, std::span<const void*> rowPointers,
-                           const std::string& filename, bool color)
+                           const std::string& filename, bool color, int compressionLevel)
 {
 	auto height = rowPointers.size();
 	assert(width  <= std::numeric_limits<png_uint_32>::max());
@@ -295,11 +436,14 @@ static void IMG_SavePNG_RW(size_t width, std::span<const void*> rowPointers,
 		// Write the file header information.  REQUIRED
 		png_write_info(png.ptr, png.info);
 
-		// Write out the entire image data in one call.
-		png_write_image(
-			png.ptr,
-			std::bit_cast<png_bytep*>(const_cast<void**>(rowPointers.data())));
-		png_write_end(png.ptr, png.info);
+		// Write the image data ourselves instead of via png_write_image(),
+		// so that it can be compressed with multiple threads. That also
+		// means png_write_end() can't be used (it would complain there's
+		// no image data), but all it does is write the IEND chunk.
+		writeImageData(png.ptr, width, rowPointers, color, compressionLevel);
+		static constexpr std::array<png_byte, 5> IEND = {'I', 'E', 'N', 'D', 0};
+		png_write_chunk(png.ptr, IEND.data(), nullptr, 0);
+		png_write_flush(png.ptr);
 	} catch (MSXException& e) {
 		throw MSXException(
 			"Error while writing PNG file \"", filename, "\": ",
@@ -307,7 +451,7 @@ static void IMG_SavePNG_RW(size_t width, std::span<const void*> rowPointers,
 	}
 }
 
-static void save(SDL_Surface* image, const std::string& filename)
+static void save(SDL_Surface* image, const std::string& filename, int compressionLevel)
 {
 	SDLAllocFormatPtr frmt24(SDL_AllocFormat(
 		Endian::BIG ? SDL_PIXELFORMAT_BGR24 : SDL_PIXELFORMAT_RGB24));
@@ -317,11 +461,11 @@ static void save(SDL_Surface* image, const std::string& filename)
 	small_buffer<const void*, 1080> rowPointers(std::views::transform(xrange(image->h),
 		[&](auto y) { return surf24.getLinePtr(y); }));
 
-	IMG_SavePNG_RW(image->w, rowPointers, filename, true);
+	IMG_SavePNG_RW(image->w, rowPointers, filename, true, compressionLevel);
 }
 
 void saveRGBA(size_t width, std::span<const uint32_t*> rowPointers,
-              const std::string& filename)
+              const std::string& filename, int compressionLevel)
 {
 	// this implementation creates 1 extra copy, can be optimized if required
 	auto height = narrow<unsigned>(rowPointers.size());
@@ -335,24 +479,24 @@ void saveRGBA(size_t width, std::span<const uint32_t*> rowPointers,
 		memcpy(surface.getLinePtr(y),
 		       rowPointers[y], width * sizeof(uint32_t));
 	}
-	save(surface.get(), filename);
+	save(surface.get(), filename, compressionLevel);
 }
 
 
 void saveRGB(size_t width, std::span<const uint8_t*> rowPointers,
-	     const std::string& filename)
+	     const std::string& filename, int compressionLevel)
 {
 	// Each row is width*3 bytes (packed RGB)
 	std::span rowPtrs{std::bit_cast<const void**>(rowPointers.data()), rowPointers.size()};
-	IMG_SavePNG_RW(width, rowPtrs, filename, true);
+	IMG_SavePNG_RW(width, rowPtrs, filename, true, compressionLevel);
 }
 
 void saveGrayscale(size_t width, std::span<const uint8_t*> rowPointers_,
-                   const std::string& filename)
+                   const std::string& filename, int compressionLevel)
 {
 	std::span rowPointers{std::bit_cast<const void**>(rowPointers_.data()),
 	                      rowPointers_.size()};
-	IMG_SavePNG_RW(width, rowPointers, filename, false);
+	IMG_SavePNG_RW(width, rowPointers, filename, false, compressionLevel);
 }
 
 } // namespace openmsx::PNG
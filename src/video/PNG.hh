@@ -18,13 +18,17 @@ namespace openmsx::PNG {
 	 */
 	[[nodiscard]] SDLSurfacePtr load(const std::string& filename, bool want32bpp);
 
+	/** Save functions. The 'compressionLevel' is the zlib level [0..9]:
+	  * lower is faster, higher gives smaller files. Large images are
+	  * compressed using multiple threads.
+	  */
 	void saveRGBA(size_t width, std::span<const uint32_t*> rowPointers,
-	              const std::string& filename);
+	              const std::string& filename, int compressionLevel);
 	/** Save an RGB (24bpp) buffer as a PNG file. Each row is width*3 bytes. */
 	void saveRGB(size_t width, std::span<const uint8_t*> rowPointers,
-	       const std::string& filename);
+	       const std::string& filename, int compressionLevel);
 	void saveGrayscale(size_t width, std::span<const uint8_t*> rowPointers,
-	                   const std::string& filename);
+	                   const std::string& filename, int compressionLevel);
 
 } // namespace openmsx::PNG
 
@@ -20,6 +20,7 @@ TODO:
 #include "GlobalSettings.hh"
 #include "IntegerSetting.hh"
 #include "MSXMotherBoard.hh"
+#include "PerfMonitor.hh"
 #include "Reactor.hh"
 #include "RealTime.hh"
 #include "SpeedManager.hh"
@@ -181,6 +182,8 @@ void PixelRenderer::frameStart(EmuTime time)
 {
 	if (!rasterizer->isActive()) {
 		frameSkipCounter = 999.0f;
+		realFrameCounter = 0.0f;
+		fastSkipCount = 0;
 		renderFrame = false;
 		prevRenderFrame = false;
 		paintFrame = false;
@@ -197,7 +200,24 @@ void PixelRenderer::frameStart(EmuTime time)
 		//       for every series of skipped frames there is also one painted
 		//       frame, so our boundary checks are offset by one.
 		auto counter = narrow_cast<int>(frameSkipCounter);
-		if (counter < renderSettings.getMinFrameSkip()) {
+		auto speed = speedManager.getSpeed();
+		if (speed > 1.0) {
+			realFrameCounter += 1.0f / float(speed);
+		} else {
+			realFrameCounter = 0.0f;
+			fastSkipCount = 0;
+		}
+		if ((speed > 1.0) && (realFrameCounter < 1.0f) &&
+		    (fastSkipCount < renderSettings.getMaxFrameSkip())) {
+			// Emulating faster than real time: less than one real
+			// frame passed since the last painted frame, so this
+			// frame could never be shown. Don't even render it.
+			// (VDP status and sprite collisions are calculated
+			// independently of the renderer, so that's not
+			// influenced).
+			paintFrame = false;
+			++fastSkipCount;
+		} else if (counter < renderSettings.getMinFrameSkip()) {
 			paintFrame = false;
 		} else if (counter > renderSettings.getMaxFrameSkip()) {
 			paintFrame = true;
@@ -205,7 +225,13 @@ void PixelRenderer::frameStart(EmuTime time)
 			paintFrame = realTime.timeLeft(
 				unsigned(finishFrameDuration), time);
 		}
-		frameSkipCounter += 1.0f / float(speedManager.getSpeed());
+		frameSkipCounter += 1.0f / float(speed);
+		if (paintFrame) {
+			// keep the fraction, so on average one frame is
+			// painted per real frame
+			realFrameCounter = std::max(realFrameCounter - 1.0f, 0.0f);
+			fastSkipCount = 0;
+		}
 	} else  {
 		// We need to render a frame every now and then,
 		// to show the user what is happening.
@@ -233,6 +259,7 @@ void PixelRenderer::frameStart(EmuTime time)
 
 void PixelRenderer::frameEnd(EmuTime time)
 {
+	PerfMonitor::Scope perf(PerfMonitor::Section::RASTERIZER);
 	if (renderFrame) {
 		// Render changes from this last frame.
 		sync(time, true);
@@ -531,6 +558,16 @@ void PixelRenderer::updateVRAM(unsigned offset, EmuTime time)
 	}
 }
 
+void PixelRenderer::updateVRAMRange(unsigned offset, unsigned num, EmuTime time)
+{
+	// All bytes change at the same time, so a single sync is enough.
+	if (renderFrame && displayEnabled &&
+	    std::ranges::any_of(xrange(offset, offset + num), [&](unsigned o) {
+		return checkSync(o, time); })) {
+		renderUntil(time);
+	}
+}
+
 void PixelRenderer::updateWindow(bool /*enabled*/, EmuTime /*time*/)
 {
 	// The bitmapVisibleWindow has moved to a different area.
@@ -563,6 +600,7 @@ void PixelRenderer::sync(EmuTime time, bool force)
 
 void PixelRenderer::renderUntil(EmuTime time)
 {
+	PerfMonitor::Scope perf(PerfMonitor::Section::RASTERIZER);
 	// Translate from time to pixel position.
 	int limitTicks = vdp.getTicksThisFrame(time);
 	assert(limitTicks <= vdp.getTicksPerFrame());
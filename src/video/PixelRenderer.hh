@@ -26,6 +26,16 @@ class VideoSourceSetting;
 
 /** Generic implementation of a pixel-based Renderer.
   * Uses a Rasterizer to plot actual pixels for a specific video system.
+  *
+  * Rendering happens on the emulation thread: before each VDP state change
+  * (and on VRAM writes to areas that are currently displayed) the frame is
+  * first rendered up to the current position, using the VDP registers and
+  * VRAM content as they are at that moment. Rendering on a separate thread
+  * would require a log of all those changes, including every VRAM write
+  * (also the ones done by the command engine). The Rasterizer would then
+  * need its own copy of VRAM to apply them to, and the sprite checker, which
+  * is also used for collision/overflow status, would have to be split
+  * between both threads. That's why this isn't done.
   */
 class PixelRenderer final : public Renderer, private Observer<Setting>
 {
@@ -61,6 +71,7 @@ public:
 	void updateColorBase(unsigned addr, EmuTime time) override;
 	void updateSpritesEnabled(bool enabled, EmuTime time) override;
 	void updateVRAM(unsigned offset, EmuTime time) override;
+	void updateVRAMRange(unsigned offset, unsigned num, EmuTime time) override;
 	void updateWindow(bool enabled, EmuTime time) override;
 
 private:
@@ -129,6 +140,11 @@ private:
 
 	float finishFrameDuration = 0.0f;
 	float frameSkipCounter = 999.0f; // force drawing of frame
+	/** When emulating faster than real time: the number of real frames
+	  * (fractional) that passed since the last painted frame, and the
+	  * number of emulated frames skipped because of that. */
+	float realFrameCounter = 0.0f;
+	int fastSkipCount = 0;
 
 	/** Number of the next position within a line to render.
 	  * Expressed in VDP clock ticks since start of line.
@@ -1,6 +1,7 @@
 #include "PostProcessor.hh"
 
 #include "AviRecorder.hh"
+#include "FrameHashLogger.hh"
 #include "CliComm.hh"
 #include "CommandException.hh"
 #include "Deflicker.hh"
@@ -15,11 +16,13 @@
 #include "GLScalerFactory.hh"
 #include "MSXMotherBoard.hh"
 #include "OutputSurface.hh"
-#include "PNG.hh"
+#include "PerfMonitor.hh"
+#include "PerfTrace.hh"
 #include "RawFrame.hh"
 #include "Reactor.hh"
 #include "RenderSettings.hh"
 #include "SuperImposedFrame.hh"
+#include "ThreadPool.hh"
 #include "gl_transform.hh"
 
 #include "MemBuffer.hh"
@@ -29,13 +32,18 @@
 #include "random.hh"
 #include "ranges.hh"
 #include "stl.hh"
+#include "strCat.hh"
 #include "xrange.hh"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <memory>
 #include <numeric>
+#include <optional>
+#include <thread>
+#include <vector>
 
 using namespace gl;
 
@@ -72,24 +80,18 @@ PostProcessor::PostProcessor(
 	preCalcNoise(renderSettings.getNoise());
 	initBuffers();
 
-	VertexShader   vertexShader  ("monitor3D.vert");
-	FragmentShader fragmentShader("monitor3D.frag");
-	monitor3DProg.attach(vertexShader);
-	monitor3DProg.attach(fragmentShader);
-	monitor3DProg.bindAttribLocation(0, "a_position");
-	monitor3DProg.bindAttribLocation(1, "a_normal");
-	monitor3DProg.bindAttribLocation(2, "a_texCoord");
-	monitor3DProg.link();
+	monitor3DProg.build({}, "monitor3D.vert", "monitor3D.frag",
+	                    std::array{"a_position", "a_normal", "a_texCoord"});
 	preCalcMonitor3D(renderSettings.getHorizontalStretch());
 
-	pbo.allocate(maxWidth * height * 2); // *2 for interlace    TODO only when 'canDoInterlace'
-
 	renderSettings.getNoiseSetting().attach(*this);
 	renderSettings.getHorizontalStretchSetting().attach(*this);
+	renderSettings.getAsyncTextureUploadSetting().attach(*this);
 }
 
 PostProcessor::~PostProcessor()
 {
+	renderSettings.getAsyncTextureUploadSetting().detach(*this);
 	renderSettings.getHorizontalStretchSetting().detach(*this);
 	renderSettings.getNoiseSetting().detach(*this);
 
@@ -100,6 +102,12 @@ PostProcessor::~PostProcessor()
 			"during recording.");
 		recorder->stop();
 	}
+	if (frameHashLogger) {
+		getCliComm().printWarning(
+			"Frame hash logging stopped, because you "
+			"changed machine or changed a video setting.");
+		frameHashLogger->stop();
+	}
 }
 
 void PostProcessor::initBuffers()
@@ -159,7 +167,8 @@ static void getScaledFrame(const FrameSource& paintFrame,
 	}
 }
 
-void PostProcessor::takeRawScreenShot(std::optional<unsigned> desiredHeight, const std::string& filename)
+ScreenShotWriter::Image PostProcessor::takeRawScreenShot(
+	std::optional<unsigned> desiredHeight, std::optional<SoftwareScaler> scaler)
 {
 	if (!paintFrame) {
 		throw CommandException("TODO");
@@ -176,7 +185,20 @@ void PostProcessor::takeRawScreenShot(std::optional<unsigned> desiredHeight, con
 	WorkBuffer workBuffer;
 	getScaledFrame(*paintFrame, lines, workBuffer);
 	unsigned width = (targetHeight == 240) ? 320 : 640;
-	PNG::saveRGBA(width, lines, filename);
+	ScreenShotWriter::Image image(width, lines);
+	if (!scaler) return image;
+
+	auto factor = scaler->factor;
+	ScreenShotWriter::Image scaled(width * factor, targetHeight * factor);
+	// Temporary threads, a screenshot is rare compared to the cost of
+	// creating them.
+	ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+	if (scaler->algo == SoftwareScaler::Algo::HQ) {
+		scaleHQImage(factor, HQTables::load(factor), image.pixels, width, scaled.pixels, &pool);
+	} else {
+		scaleNxImage(factor, image.pixels, width, scaled.pixels, &pool);
+	}
+	return scaled;
 }
 
 void PostProcessor::createRegions()
@@ -220,8 +242,22 @@ void PostProcessor::createRegions()
 	}
 }
 
+// Rotate and mirror noise texture in consecutive frames to avoid seeing
+// 'patterns' in the noise.
+static constexpr std::array NOISE_POS = {
+	std::array{vec2{-1, -1}, vec2{ 1, -1}, vec2{ 1,  1}, vec2{-1,  1}},
+	std::array{vec2{-1,  1}, vec2{ 1,  1}, vec2{ 1, -1}, vec2{-1, -1}},
+	std::array{vec2{-1,  1}, vec2{-1, -1}, vec2{ 1, -1}, vec2{ 1,  1}},
+	std::array{vec2{ 1,  1}, vec2{ 1, -1}, vec2{-1, -1}, vec2{-1,  1}},
+	std::array{vec2{ 1,  1}, vec2{-1,  1}, vec2{-1, -1}, vec2{ 1, -1}},
+	std::array{vec2{ 1, -1}, vec2{-1, -1}, vec2{-1,  1}, vec2{ 1,  1}},
+	std::array{vec2{ 1, -1}, vec2{ 1,  1}, vec2{-1,  1}, vec2{-1, -1}},
+	std::array{vec2{-1, -1}, vec2{-1,  1}, vec2{ 1,  1}, vec2{ 1, -1}},
+};
+
 void PostProcessor::paint(OutputSurface& /*output*/)
 {
+	PerfMonitor::Scope perf(PerfMonitor::Section::POST_PROCESSOR);
 	if (renderSettings.getInterleaveBlackFrame()) {
 		interleaveCount ^= 1;
 		if (interleaveCount) {
@@ -284,7 +320,9 @@ void PostProcessor::paint(OutputSurface& /*output*/)
 			     GL_UNSIGNED_BYTE,  // type
 			     nullptr);          // data
 		renderedFrame.fbo = FrameBufferObject(renderedFrame.tex);
+		renderedFrame.size = size;
 	}
+	renderedFrame.frameNr = frameCounter;
 	renderedFrame.fbo.push();
 
 	for (const auto& r : regions) {
@@ -298,7 +336,11 @@ void PostProcessor::paint(OutputSurface& /*output*/)
 			paintFrame->getHeight()); // dst
 	}
 
-	drawNoise();
+	// Glow mixes in the previous rendered frame, so then the noise must be
+	// part of the rendered frame. Otherwise it's added in the final pass.
+	bool fuseNoise = (glow == 0) && (deform != RenderSettings::DisplayDeform::_3D) &&
+	                 (renderSettings.getNoise() != 0.0f);
+	if (!fuseNoise) drawNoise();
 	drawGlow(glow);
 
 	renderedFrame.fbo.pop();
@@ -322,12 +364,47 @@ void PostProcessor::paint(OutputSurface& /*output*/)
 			vec2(x1, 1), vec2(x1, 0), vec2(x2, 0), vec2(x2, 1)
 		};
 
-		const auto& glContext = *gl::context;
-		glContext.progTex.activate();
-		glUniform4f(glContext.unifTexColor,
-				1.0f, 1.0f, 1.0f, 1.0f);
-		mat4 I;
-		glUniformMatrix4fv(glContext.unifTexMvp, 1, GL_FALSE, I.data());
+		// 'frame_pacing' = blend: mix in the previous MSX frame
+		const auto& prevFrame = renderedFrames[(frameCounter & 1) ^ 1];
+		float blend = display.getFrameBlend();
+		bool useBlend = (blend < 1.0f) && (prevFrame.frameNr == frameCounter - 1) &&
+		                (prevFrame.size == size);
+
+		// One pass, instead of separate (blended) passes per effect.
+		auto& output = getOutputProgram(fuseNoise, useBlend);
+		output.prog.activate();
+		if (useBlend) {
+			glUniform1f(output.unifPrevWeight, 1.0f - blend);
+			glActiveTexture(GL_TEXTURE1);
+			prevFrame.tex.bind();
+		}
+		if (fuseNoise) {
+			glActiveTexture(GL_TEXTURE2);
+			noiseTextureA.bind();
+			glActiveTexture(GL_TEXTURE3);
+			noiseTextureB.bind();
+
+			// Same noise pattern as drawNoise() would draw on the
+			// (visible part of the) rendered frame.
+			unsigned seq = frameCounter & 7;
+			const auto& nPos = NOISE_POS[seq];
+			auto nTex = getNoiseTexCoords();
+			auto noiseCoord = [&](vec2 t) {
+				vec2 p = 2.0f * t - vec2(1.0f);
+				float a = dot(p - nPos[0], nPos[1] - nPos[0]) * 0.25f;
+				float b = dot(p - nPos[0], nPos[3] - nPos[0]) * 0.25f;
+				return nTex[0] + a * (nTex[1] - nTex[0]) + b * (nTex[3] - nTex[0]);
+			};
+			std::array noise = {
+				noiseCoord(tex[0]), noiseCoord(tex[1]),
+				noiseCoord(tex[2]), noiseCoord(tex[3])
+			};
+			glBindBuffer(GL_ARRAY_BUFFER, noiseVBO.get());
+			glBufferData(GL_ARRAY_BUFFER, sizeof(noise), noise.data(), GL_STREAM_DRAW);
+			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+			glEnableVertexAttribArray(2);
+		}
+		glActiveTexture(GL_TEXTURE0);
 
 		glBindBuffer(GL_ARRAY_BUFFER, vbo.get());
 		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
@@ -340,6 +417,7 @@ void PostProcessor::paint(OutputSurface& /*output*/)
 
 		glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 
+		if (fuseNoise) glDisableVertexAttribArray(2);
 		glDisableVertexAttribArray(1);
 		glDisableVertexAttribArray(0);
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -348,6 +426,28 @@ void PostProcessor::paint(OutputSurface& /*output*/)
 	//gl::checkGLError("PostProcessor::paint");
 }
 
+PostProcessor::OutputProgram& PostProcessor::getOutputProgram(bool noise, bool blend)
+{
+	auto& result = outputProgs[int(noise) + 2 * int(blend)];
+	if (!result) {
+		result.emplace();
+		auto& prog = result->prog;
+		prog.build(strCat(noise ? "#define NOISE\n" : "",
+		                  blend ? "#define BLEND\n" : ""),
+		           "output.vert", "output.frag",
+		           std::array{"a_position", "a_texCoord", "a_noiseCoord"});
+		prog.activate();
+		mat4 I;
+		glUniformMatrix4fv(prog.getUniformLocation("u_mvpMatrix"), 1, GL_FALSE, I.data());
+		glUniform1i(prog.getUniformLocation("u_tex"), 0);
+		glUniform1i(prog.getUniformLocation("u_prevTex"), 1);
+		glUniform1i(prog.getUniformLocation("u_noiseA"), 2);
+		glUniform1i(prog.getUniformLocation("u_noiseB"), 3);
+		result->unifPrevWeight = prog.getUniformLocation("u_prevWeight");
+	}
+	return *result;
+}
+
 std::unique_ptr<RawFrame> PostProcessor::rotateFrames(
 	std::unique_ptr<RawFrame> finishedFrame, EmuTime time)
 {
@@ -448,6 +548,19 @@ std::unique_ptr<RawFrame> PostProcessor::rotateFrames(
 			assert(!recorder);
 		}
 	}
+	// Hash the raw (not deinterlaced/deflickered) frame, that only
+	// depends on the emulation, not on the video settings.
+	if (frameHashLogger && needRecord()) {
+		try {
+			frameHashLogger->addFrame(*lastFrames[0], time);
+		} catch (MSXException& e) {
+			getCliComm().printWarning(
+				"Frame hash logging stopped with error: ",
+				e.getMessage());
+			frameHashLogger->stop();
+			assert(!frameHashLogger);
+		}
+	}
 
 	// Return recycled frame to the caller
 	std::unique_ptr<RawFrame> reuseFrame = [&] {
@@ -477,12 +590,27 @@ void PostProcessor::update(const Setting& setting) noexcept
 		preCalcNoise(noiseSetting.getFloat());
 	} else if (&setting == &horizontalStretch) {
 		preCalcMonitor3D(horizontalStretch.getFloat());
+	} else if (&setting == &renderSettings.getAsyncTextureUploadSetting()) {
+		if (renderSettings.getAsyncTextureUpload() &&
+		    !gl::PersistentPixelBuffer<uint32_t>::isSupported()) {
+			getCliComm().printWarning(
+				"async_texture_upload requires OpenGL 4.4 or the "
+				"ARB_buffer_storage extension, using the normal upload.");
+		}
 	}
 }
 
+bool PostProcessor::useAsyncUpload() const
+{
+	return renderSettings.getAsyncTextureUpload() &&
+	       gl::PersistentPixelBuffer<uint32_t>::isSupported();
+}
+
 void PostProcessor::uploadFrame()
 {
+	PerfTrace::Span trace("gl", "upload");
 	createRegions();
+	for (auto& t : textures) t.numUploads = 0;
 
 	const unsigned srcHeight = paintFrame->getHeight();
 	for (const auto& r : regions) {
@@ -523,48 +651,102 @@ void PostProcessor::uploadBlock(
 	// create texture on demand
 	auto it = std::ranges::find(textures, lineWidth, &TextureData::width);
 	if (it == end(textures)) {
+		unsigned texHeight = height * 2; // *2 for interlace   TODO only when canDoInterlace
 		TextureData textureData;
 		textureData.tex.resize(narrow<GLsizei>(lineWidth),
-		                       narrow<GLsizei>(height * 2)); // *2 for interlace   TODO only when canDoInterlace
+		                       narrow<GLsizei>(texHeight));
+		textureData.contents.resize(size_t(lineWidth) * texHeight);
+		textureData.valid.assign(texHeight, false);
 		textures.push_back(std::move(textureData));
 		it = end(textures) - 1;
 	}
-	auto& tex = it->tex;
+	auto& [tex, contents, valid, pbos, nextPbo, numUploads] = *it;
+
+	// Optionally upload via (multi buffered) persistently mapped pixel
+	// buffers. Then glTexSubImage2D() returns immediately and the actual
+	// transfer overlaps with the emulation of the next frame.
+	if (useAsyncUpload()) {
+		if (pbos.empty()) {
+			pbos.emplace_back(contents.size());
+			pbos.emplace_back(contents.size());
+			if (std::ranges::any_of(pbos, [](auto& p) { return p.getMapped().empty(); })) {
+				pbos.clear(); // mapping failed, use the normal path
+			}
+			nextPbo = 0;
+		}
+	} else {
+		pbos.clear();
+	}
+	gl::PersistentPixelBuffer<uint32_t>* pbo = nullptr;
+	if (!pbos.empty()) {
+		// A frame can upload several regions to the same texture, so
+		// take the next buffer for each upload. With two buffers per
+		// upload a buffer is only reused after a full frame, so
+		// normally without waiting.
+		if (2 * ++numUploads > pbos.size()) {
+			gl::PersistentPixelBuffer<uint32_t> extra(contents.size());
+			if (!extra.getMapped().empty()) {
+				pbos.insert(pbos.begin() + nextPbo, std::move(extra));
+			}
+		}
+		pbo = &pbos[nextPbo];
+		nextPbo = (nextPbo + 1) % unsigned(pbos.size());
+		pbo->waitFence();
+		pbo->bind();
+	}
 
 	// bind texture
 	tex.bind();
 
-	// upload data
-	pbo.bind();
-	auto mapped = pbo.mapWrite();
-	auto numLines = srcEndY - srcStartY;
-	for (auto yy : xrange(numLines)) {
-		auto dest = mapped.subspan(yy * size_t(lineWidth), lineWidth);
-		auto line = paintFrame->getLine(narrow<int>(yy + srcStartY), dest);
-		if (line.data() != dest.data()) {
+	// Upload data, but skip the lines that are identical to what's
+	// already in the texture. Typically most of the screen doesn't change
+	// between two frames (and when emulation is paused nothing changes at
+	// all). Comparing is cheaper than uploading.
+	auto upload = [&](unsigned startY, unsigned endY) {
+#ifdef __APPLE__
+		// The nVidia GL driver for the GeForce 8000/9000 series seems to hang
+		// on texture data replacements that are 1 pixel wide and start on a
+		// line number that is a non-zero multiple of 16.
+		if (lineWidth == 1 && startY != 0 && startY % 16 == 0) {
+			startY--;
+		}
+#endif
+		auto offset = startY * size_t(lineWidth);
+		glTexSubImage2D(
+			GL_TEXTURE_2D,                // target
+			0,                            // level
+			0,                            // offset x
+			narrow<GLint>(startY),        // offset y
+			narrow<GLint>(lineWidth),     // width
+			narrow<GLint>(endY - startY), // height
+			GL_RGBA,                      // format
+			GL_UNSIGNED_BYTE,             // type
+			pbo ? pbo->getOffset(offset) : &contents[offset]); // data
+	};
+	std::optional<unsigned> changedStart;
+	for (auto y : xrange(srcStartY, srcEndY)) {
+		ALIGNAS_SSE std::array<uint32_t, 1280> buf; // large enough for widest line
+		auto line = paintFrame->getLine(narrow<int>(y), subspan(buf, 0, lineWidth));
+		auto dest = subspan(contents, y * size_t(lineWidth), lineWidth);
+		if (valid[y] && std::ranges::equal(line, dest)) {
+			if (changedStart) {
+				upload(*changedStart, y);
+				changedStart.reset();
+			}
+		} else {
 			copy_to_range(line, dest);
+			if (pbo) {
+				copy_to_range(line, pbo->getMapped().subspan(y * size_t(lineWidth), lineWidth));
+			}
+			valid[y] = true;
+			if (!changedStart) changedStart = y;
 		}
 	}
-	pbo.unmap();
-#ifdef __APPLE__
-	// The nVidia GL driver for the GeForce 8000/9000 series seems to hang
-	// on texture data replacements that are 1 pixel wide and start on a
-	// line number that is a non-zero multiple of 16.
-	if (lineWidth == 1 && srcStartY != 0 && srcStartY % 16 == 0) {
-		srcStartY--;
+	if (changedStart) upload(*changedStart, srcEndY);
+	if (pbo) {
+		pbo->setFence();
+		pbo->unbind();
 	}
-#endif
-	glTexSubImage2D(
-		GL_TEXTURE_2D,            // target
-		0,                        // level
-		0,                        // offset x
-		narrow<GLint>(srcStartY), // offset y
-		narrow<GLint>(lineWidth), // width
-		narrow<GLint>(numLines),  // height
-		GL_RGBA,                  // format
-		GL_UNSIGNED_BYTE,         // type
-		mapped.data());           // data
-	pbo.unbind();
 
 	// possibly upload scaler specific data
 	if (currScaler) {
@@ -652,29 +834,22 @@ void PostProcessor::preCalcNoise(float factor)
 #endif
 }
 
-void PostProcessor::drawNoise() const
+std::array<vec2, 4> PostProcessor::getNoiseTexCoords() const
 {
-	if (renderSettings.getNoise() == 0.0f) return;
-
-	// Rotate and mirror noise texture in consecutive frames to avoid
-	// seeing 'patterns' in the noise.
-	static constexpr std::array pos = {
-		std::array{vec2{-1, -1}, vec2{ 1, -1}, vec2{ 1,  1}, vec2{-1,  1}},
-		std::array{vec2{-1,  1}, vec2{ 1,  1}, vec2{ 1, -1}, vec2{-1, -1}},
-		std::array{vec2{-1,  1}, vec2{-1, -1}, vec2{ 1, -1}, vec2{ 1,  1}},
-		std::array{vec2{ 1,  1}, vec2{ 1, -1}, vec2{-1, -1}, vec2{-1,  1}},
-		std::array{vec2{ 1,  1}, vec2{-1,  1}, vec2{-1, -1}, vec2{ 1, -1}},
-		std::array{vec2{ 1, -1}, vec2{-1, -1}, vec2{-1,  1}, vec2{ 1,  1}},
-		std::array{vec2{ 1, -1}, vec2{ 1,  1}, vec2{-1,  1}, vec2{-1, -1}},
-		std::array{vec2{-1, -1}, vec2{-1,  1}, vec2{ 1,  1}, vec2{ 1, -1}},
-	};
 	vec2 noise(noiseX, noiseY);
-	const std::array tex = {
+	return {
 		noise + vec2(0.0f, 1.875f),
 		noise + vec2(2.0f, 1.875f),
 		noise + vec2(2.0f, 0.0f  ),
 		noise + vec2(0.0f, 0.0f  ),
 	};
+}
+
+void PostProcessor::drawNoise() const
+{
+	if (renderSettings.getNoise() == 0.0f) return;
+
+	const auto tex = getNoiseTexCoords();
 
 	const auto& glContext = *gl::context;
 	glContext.progTex.activate();
@@ -686,7 +861,7 @@ void PostProcessor::drawNoise() const
 	glUniformMatrix4fv(glContext.unifTexMvp, 1, GL_FALSE, I.data());
 
 	unsigned seq = frameCounter & 7;
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, pos[seq].data());
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, NOISE_POS[seq].data());
 	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, tex.data());
 	glEnableVertexAttribArray(0);
 	glEnableVertexAttribArray(1);
@@ -10,11 +10,13 @@
 
 #include <array>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace openmsx {
 
 class AviRecorder;
+class FrameHashLogger;
 class CliComm;
 class Deflicker;
 class DeinterlacedFrame;
@@ -87,6 +89,12 @@ public:
 	  */
 	[[nodiscard]] bool isRecording() const { return recorder != nullptr; }
 
+	/** Start/stop logging frame hashes.
+	  * @param logger Finished (raw) frames should be pushed to this
+	  *               FrameHashLogger, or nullptr to stop logging.
+	  */
+	void setFrameHashLogger(FrameHashLogger* logger) { frameHashLogger = logger; }
+
 	/** Get the frame that would be displayed. E.g. so that it can be
 	  * superimposed over the output of another PostProcessor, see
 	  * setSuperimposeVdpFrame().
@@ -100,7 +108,8 @@ public:
 	}
 
 	// VideoLayer
-	void takeRawScreenShot(std::optional<unsigned> height, const std::string& filename) override;
+	[[nodiscard]] ScreenShotWriter::Image takeRawScreenShot(
+		std::optional<unsigned> height, std::optional<SoftwareScaler> scaler) override;
 
 	[[nodiscard]] CliComm& getCliComm();
 
@@ -117,17 +126,22 @@ private:
 
 	void initBuffers();
 	void createRegions();
+	[[nodiscard]] bool useAsyncUpload() const;
 	void uploadFrame();
 	void uploadBlock(unsigned srcStartY, unsigned srcEndY,
 	                 unsigned lineWidth);
 
 	void preCalcNoise(float factor);
+	[[nodiscard]] std::array<gl::vec2, 4> getNoiseTexCoords() const;
 	void drawNoise() const;
 	void drawGlow(int glow);
 
 	void preCalcMonitor3D(float width);
 	void drawMonitor3D() const;
 
+	struct OutputProgram;
+	[[nodiscard]] OutputProgram& getOutputProgram(bool noise, bool blend);
+
 private:
 	Display& display;
 	RenderSettings& renderSettings;
@@ -160,6 +174,9 @@ private:
 	/** Video recorder, nullptr when not recording. */
 	AviRecorder* recorder = nullptr;
 
+	/** Frame hash logger, nullptr when not logging. */
+	FrameHashLogger* frameHashLogger = nullptr;
+
 	/** Video frame on which to superimpose the (VDP) output.
 	  * nullptr when not superimposing. */
 	const RawFrame* superImposeVideoFrame = nullptr;
@@ -185,6 +202,7 @@ private:
 		gl::ivec2 size; // (re)allocate when window size changes
 		gl::Texture tex;
 		gl::FrameBufferObject fbo;
+		unsigned frameNr = unsigned(-1); // value of 'frameCounter' when rendered
 	};
 	std::array<StoredFrame, 2> renderedFrames;
 
@@ -195,10 +213,18 @@ private:
 
 	struct TextureData {
 		gl::ColorTexture tex;
+		/** Copy of what was last uploaded to 'tex', used to only
+		  * upload the lines that changed since the previous frame. */
+		std::vector<uint32_t> contents;
+		std::vector<bool> valid; // per line: 'contents' is up-to-date
+		/** Empty, or (at least) two buffers per upload in a frame when
+		  * 'async_texture_upload' is on. Used round-robin. */
+		std::vector<gl::PersistentPixelBuffer<uint32_t>> pbos;
+		unsigned nextPbo = 0;
+		unsigned numUploads = 0; // in the current frame
 		[[nodiscard]] unsigned width() const { return tex.getWidth(); }
 	};
 	std::vector<TextureData> textures;
-	gl::PixelBuffer<unsigned> pbo;
 
 	gl::ColorTexture superImposeTex;
 
@@ -231,6 +257,16 @@ private:
 	gl::BufferObject elementBuffer;
 	gl::BufferObject vbo;
 	gl::BufferObject stretchVBO;
+	gl::BufferObject noiseVBO;
+
+	/** Shader for the final (non-3D) pass, one variant per combination
+	  * of effects that are fused in this pass. Built on first use.
+	  */
+	struct OutputProgram {
+		gl::ShaderProgram prog;
+		GLint unifPrevWeight;
+	};
+	std::array<std::optional<OutputProgram>, 4> outputProgs; // index: noise + 2 * blend
 
 	bool storedFrame = false;
 };
@@ -0,0 +1,164 @@
+#include "PresentThread.hh"
+
+#include "InitException.hh"
+#include "PerfTrace.hh"
+
+#include "build-info.hh"
+
+#include <cassert>
+#include <utility>
+
+namespace openmsx {
+
+bool PresentThread::isSupported()
+{
+#ifdef __APPLE__
+	// On macOS the (NSOpenGLContext of the) window may only be updated
+	// from the main thread.
+	return false;
+#else
+	return !PLATFORM_ANDROID &&
+	       (GLEW_VERSION_3_2 ||
+	        (GLEW_ARB_sync && (GLEW_VERSION_3_0 || GLEW_ARB_framebuffer_object)));
+#endif
+}
+
+PresentThread::PresentThread(SDL_Window* window_, SDL_GLContext mainContext)
+	: window(window_)
+{
+	assert(isSupported());
+	// This also makes the new context current, so switch back.
+	SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+	context = SDL_GL_CreateContext(window);
+	SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+	SDL_GL_MakeCurrent(window, mainContext);
+	if (!context) {
+		throw InitException("Failed to create shared openGL context: ", SDL_GetError());
+	}
+	// The texture names must be visible in the other context.
+	glFinish();
+	thread = std::thread([this]() { run(); });
+}
+
+PresentThread::~PresentThread()
+{
+	{
+		std::scoped_lock lock(mutex);
+		stop = true;
+	}
+	cond.notify_one();
+	thread.join();
+	SDL_GL_DeleteContext(context);
+
+	if (inFrame) slots[back].fbo.pop();
+	for (auto& slot : slots) {
+		if (slot.fence) glDeleteSync(slot.fence);
+	}
+}
+
+// Wait till the GPU is done with the commands that the previous owner of this
+// slot issued (this doesn't block the CPU).
+void PresentThread::acquire(Slot& slot)
+{
+	if (slot.fence) {
+		glWaitSync(slot.fence, 0, GL_TIMEOUT_IGNORED);
+		glDeleteSync(slot.fence);
+		slot.fence = nullptr;
+	}
+}
+
+void PresentThread::beginFrame(gl::ivec2 size)
+{
+	if (inFrame) return;
+	auto& slot = slots[back];
+	acquire(slot);
+	if (slot.size != size) {
+		slot.tex.resize(size.x, size.y);
+		if (slot.size == gl::ivec2()) {
+			slot.fbo = gl::FrameBufferObject(slot.tex);
+		}
+		slot.size = size;
+	}
+	slot.fbo.push();
+	inFrame = true;
+}
+
+void PresentThread::present()
+{
+	if (!inFrame) return;
+	auto& slot = slots[back];
+	slot.fbo.pop();
+	inFrame = false;
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glFlush(); // the fence must reach the GPU before the other context waits for it
+
+	last = back;
+	{
+		std::scoped_lock lock(mutex);
+		std::swap(back, ready);
+		newFrame = true;
+	}
+	cond.notify_one();
+}
+
+void PresentThread::setSwapInterval(int interval)
+{
+	swapInterval = interval;
+}
+
+gl::FrameBufferObject* PresentThread::getLastFrame()
+{
+	return (last == -1) ? nullptr : &slots[last].fbo;
+}
+
+void PresentThread::run()
+{
+	PerfTrace::setThreadName("present");
+	SDL_GL_MakeCurrent(window, context);
+	// Framebuffer objects are not shared between contexts, so this one
+	// is only used to read from the textures in the present thread.
+	GLuint readFbo;
+	glGenFramebuffers(1, &readFbo);
+	int currentInterval = 0;
+	SDL_GL_SetSwapInterval(currentInterval);
+
+	std::unique_lock lock(mutex);
+	while (true) {
+		cond.wait(lock, [&] { return stop || newFrame; });
+		if (stop) break;
+		std::swap(front, ready);
+		newFrame = false;
+		lock.unlock();
+
+		PerfTrace::Span span("paint", "present");
+		if (int interval = swapInterval; interval != currentInterval) {
+			currentInterval = interval;
+			if ((SDL_GL_SetSwapInterval(interval) < 0) && (interval == -1)) {
+				SDL_GL_SetSwapInterval(1);
+			}
+		}
+
+		auto& slot = slots[front];
+		acquire(slot);
+		// (Re-)attach, changes to the texture storage become visible in
+		// this context when the texture is attached.
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, readFbo);
+		glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+		                       GL_TEXTURE_2D, slot.tex.get(), 0);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		auto [w, h] = slot.size;
+		glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+		slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		glFlush();
+		SDL_GL_SwapWindow(window); // might wait for vsync
+
+		lock.lock();
+	}
+	lock.unlock();
+
+	glDeleteFramebuffers(1, &readFbo);
+	SDL_GL_MakeCurrent(window, nullptr);
+}
+
+} // namespace openmsx
@@ -0,0 +1,100 @@
+#ifndef PRESENTTHREAD_HH
+#define PRESENTTHREAD_HH
+
+#include "GLUtil.hh"
+
+#include <SDL.h>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace openmsx {
+
+/** Shows the rendered frames on the host display from a separate thread, so
+  * that a buffer swap that waits for the host vsync doesn't block the
+  * emulation.
+  *
+  * All openGL rendering (PostProcessor, OSD, ImGui) still happens on the
+  * main thread, but into one of three offscreen textures instead of into the
+  * window (triple buffering). A finished frame is handed over to the present
+  * thread, which (in its own, shared, openGL context) copies the most recent
+  * frame to the window and swaps the buffers. When the main thread produces
+  * frames faster than the display shows them, the older frames are skipped.
+  * GL sync objects make sure neither side uses a texture before the GPU is
+  * done with the commands of the other side.
+  */
+class PresentThread
+{
+public:
+	/** Is this supported by the openGL driver (and the platform)?
+	  * Requires OpenGL 3.2, or ARB_sync and ARB_framebuffer_object. */
+	[[nodiscard]] static bool isSupported();
+
+	/** Must be called from the main thread, with 'mainContext' current.
+	  * @throws InitException when the shared context can't be created. */
+	PresentThread(SDL_Window* window, SDL_GLContext mainContext);
+	PresentThread(const PresentThread&) = delete;
+	PresentThread(PresentThread&&) = delete;
+	PresentThread& operator=(const PresentThread&) = delete;
+	PresentThread& operator=(PresentThread&&) = delete;
+	~PresentThread();
+
+	/** Redirect rendering to the texture for the next frame. The texture
+	  * is (re)allocated when the size changed. Calling this again before
+	  * present() has no effect. */
+	void beginFrame(gl::ivec2 size);
+
+	/** Hand over the frame to the present thread, rendering goes to the
+	  * window (framebuffer 0) again. */
+	void present();
+
+	/** Swap interval as in SDL_GL_SetSwapInterval(). It's applied on the
+	  * present thread, -1 (adaptive vsync) falls back to 1 when needed. */
+	void setSwapInterval(int interval);
+
+	/** The framebuffer containing the last presented frame (e.g. to take
+	  * a screenshot), or nullptr when there's no such frame yet. */
+	[[nodiscard]] gl::FrameBufferObject* getLastFrame();
+
+private:
+	struct Slot {
+		gl::ColorTexture tex;
+		gl::FrameBufferObject fbo; // only for the main context
+		gl::ivec2 size;
+		GLsync fence = nullptr; // signaled when the previous user is done with 'tex'
+	};
+
+	void acquire(Slot& slot);
+	void run();
+
+private:
+	SDL_Window* window;
+	SDL_GLContext context; // shared with the main context
+	std::array<Slot, 3> slots;
+
+	// Only accessed from the main thread.
+	int back = 0; // main thread renders into this slot
+	int last = -1; // most recently presented slot
+	bool inFrame = false;
+
+	std::mutex mutex;
+	std::condition_variable cond;
+	// The following are protected by 'mutex'.
+	int ready = 1; // most recent finished frame (or a free slot)
+	bool newFrame = false; // does 'ready' contain a frame that wasn't shown yet?
+	bool stop = false;
+
+	// Only accessed from the present thread.
+	int front = 2; // present thread shows this slot
+
+	std::atomic<int> swapInterval = 0;
+
+	std::thread thread; // must be last, started after the above members are initialized
+};
+
+} // namespace openmsx
+
+#endif
@@ -1,7 +1,41 @@
 #include "RawFrame.hh"
 
+#include "stl.hh"
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <vector>
+
 namespace openmsx {
 
+// Upper limit for the memory in the pool. A machine with a VDP and a V9990
+// uses (at most) 5 + 5 frames of 640x240 and 1280x240 pixels.
+static constexpr size_t MAX_POOL_BYTES = 16 * 1024 * 1024;
+
+namespace {
+	struct Storage {
+		MemBuffer<RawFrame::Pixel, 64> data;
+		MemBuffer<unsigned> lineWidths;
+	};
+
+	struct Pool {
+		std::vector<Storage> storage;
+		size_t bytes = 0;
+	};
+}
+
+static Pool& getPool()
+{
+	static Pool pool;
+	return pool;
+}
+
+[[nodiscard]] static size_t getBytes(const Storage& s)
+{
+	return s.data.size() * sizeof(RawFrame::Pixel) + s.lineWidths.size() * sizeof(unsigned);
+}
+
 [[nodiscard]] static unsigned calcMaxWidth(unsigned maxWidth)
 {
 	unsigned bytes = maxWidth * sizeof(RawFrame::Pixel);
@@ -10,15 +44,29 @@ namespace openmsx {
 }
 
 RawFrame::RawFrame(unsigned maxWidth_, unsigned height_)
-	: lineWidths(height_)
-	, maxWidth(calcMaxWidth(maxWidth_))
+	: maxWidth(calcMaxWidth(maxWidth_))
 {
 	setHeight(height_);
 
 	// Allocate memory, make sure each line starts at a 64 byte boundary:
 	// - SSE instructions need 16 byte aligned data
 	// - cache line size on many CPUs is 64 bytes
-	data.resize(size_t(maxWidth) * height_);
+	size_t size = size_t(maxWidth) * height_;
+	// Prefer the most recently released memory, it's more likely still
+	// in the cache.
+	auto& pool = getPool();
+	auto match = std::ranges::find_if(std::views::reverse(pool.storage), [&](const Storage& s) {
+		return s.data.size() == size && s.lineWidths.size() == height_; });
+	if (match != std::views::reverse(pool.storage).end()) {
+		auto it = std::prev(match.base());
+		pool.bytes -= getBytes(*it);
+		data = std::move(it->data);
+		lineWidths = std::move(it->lineWidths);
+		move_pop_back(pool.storage, it);
+	} else {
+		data.resize(size);
+		lineWidths.resize(height_);
+	}
 
 	// Start with a black frame.
 	init(FieldType::NONINTERLACED);
@@ -27,6 +75,16 @@ RawFrame::RawFrame(unsigned maxWidth_, unsigned height_)
 	}
 }
 
+RawFrame::~RawFrame()
+{
+	auto& pool = getPool();
+	Storage s{std::move(data), std::move(lineWidths)};
+	auto bytes = getBytes(s);
+	if (pool.bytes + bytes > MAX_POOL_BYTES) return; // just free it
+	pool.bytes += bytes;
+	pool.storage.push_back(std::move(s));
+}
+
 unsigned RawFrame::getLineWidth(unsigned line) const
 {
 	assert(line < getHeight());
@@ -11,11 +11,17 @@ namespace openmsx {
 
 /** A video frame as output by the VDP scanline conversion unit,
   * before any postprocessing filters are applied.
+  *
+  * The memory of destroyed frames is kept in a small pool and reused for
+  * new frames with the same dimensions. E.g. on a reverse seek the renderer
+  * of the new machine then doesn't need to allocate (and page in) fresh
+  * memory. Only use this class from the main thread.
   */
 class RawFrame final : public FrameSource
 {
 public:
 	RawFrame(unsigned maxWidth, unsigned height);
+	~RawFrame();
 
 	[[nodiscard]] std::span<Pixel> getLineDirect(unsigned y) {
 		assert(y < getHeight());
@@ -5,11 +5,11 @@
 #include "Version.hh"
 
 #include "stl.hh"
-#include "unreachable.hh"
 
 #include "build-info.hh"
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <iostream>
 
@@ -147,6 +147,35 @@ RenderSettings::RenderSettings(CommandController& commandController)
 		" (typically 60Hz) differs from MSX framerate (50 or 60Hz).\n",
 		true)
 
+	, framePacingSetting(commandController,
+		"frame_pacing", "When to show a new frame on the host display:\n"
+		" emulation -> as soon as the MSX frame is finished\n"
+		" host -> in sync with the refresh of the host display, "
+		"more even on displays with a higher refresh rate (e.g. 144Hz)\n"
+		" blend -> like 'host', but blend between the last two MSX frames "
+		"for smoother motion (adds one MSX frame of latency)\n",
+		FramePacing::EMULATION,
+		EnumSetting<FramePacing>::Map{
+			{"emulation", FramePacing::EMULATION},
+			{"host",      FramePacing::HOST},
+			{"blend",     FramePacing::BLEND}})
+
+	, presentThreadSetting(commandController,
+		"present_thread",
+		"Show the rendered frames from a separate thread, so that waiting "
+		"for the host vsync doesn't block the emulation. Requires OpenGL "
+		"3.2 (or ARB_sync and ARB_framebuffer_object).",
+		false)
+
+	, maxFramesInFlightSetting(commandController,
+		"max_frames_in_flight",
+		"Maximum number of rendered frames the GPU may still be working "
+		"on. Lower values reduce the display latency (the driver can't "
+		"queue up frames), but give less overlap between the CPU and the "
+		"GPU. 0 means no limit (driver default). Not used together with "
+		"present_thread. Requires OpenGL 3.2 (or ARB_sync).",
+		0, 0, 3)
+
 	, fullStretchSetting(commandController,
 		"full_stretch", "Stretch the image to fill the entire screen in fullscreen mode", false)
 
@@ -178,10 +207,21 @@ RenderSettings::RenderSettings(CommandController& commandController)
 		"Useful on (100Hz+) lightboost enabled monitors to reduce "
 		"motion blur and double frame artifacts.",
 		false)
+
+	, asyncTextureUploadSetting(commandController,
+		"async_texture_upload",
+		"Upload the MSX frame to the GPU via persistently mapped pixel "
+		"buffers, so that the upload overlaps with the emulation of the "
+		"next frame. Requires OpenGL 4.4 (or ARB_buffer_storage).",
+		false)
 {
 	brightnessSetting.attach(*this);
 	contrastSetting  .attach(*this);
 	updateBrightnessAndContrast();
+	for (auto* setting : getCachedSettings()) {
+		setting->attach(*this);
+	}
+	updateCached();
 
 	auto& interp = commandController.getInterpreter();
 	colorMatrixSetting.setChecker([this, &interp](const TclObject& newValue) {
@@ -211,10 +251,50 @@ RenderSettings::RenderSettings(CommandController& commandController)
 
 RenderSettings::~RenderSettings()
 {
+	for (auto* setting : getCachedSettings()) {
+		setting->detach(*this);
+	}
 	brightnessSetting.detach(*this);
 	contrastSetting  .detach(*this);
 }
 
+std::array<Setting*, 18> RenderSettings::getCachedSettings()
+{
+	return {
+		&accuracySetting, &deinterlaceSetting, &deflickerSetting,
+		&maxFrameSkipSetting, &minFrameSkipSetting, &gammaSetting,
+		&glowSetting, &noiseSetting, &horizontalBlurSetting,
+		&scanlineAlphaSetting, &scaleAlgorithmSetting,
+		&disableSpritesSetting, &displayDeformSetting, &framePacingSetting,
+		&fullStretchSetting, &horizontalStretchSetting,
+		&interleaveBlackFrameSetting, &asyncTextureUploadSetting,
+	};
+}
+
+void RenderSettings::updateCached()
+{
+	cached = Cached{
+		.accuracy             = accuracySetting.getEnum(),
+		.deinterlace          = deinterlaceSetting.getBoolean(),
+		.deflicker            = deflickerSetting.getBoolean(),
+		.maxFrameSkip         = maxFrameSkipSetting.getInt(),
+		.minFrameSkip         = minFrameSkipSetting.getInt(),
+		.gamma                = gammaSetting.getFloat(),
+		.glow                 = glowSetting.getInt(),
+		.noise                = noiseSetting.getFloat(),
+		.horizontalBlur       = horizontalBlurSetting.getInt(),
+		.scanlineAlpha        = scanlineAlphaSetting.getInt(),
+		.scaleAlgorithm       = scaleAlgorithmSetting.getEnum(),
+		.disableSprites       = disableSpritesSetting.getBoolean(),
+		.displayDeform        = displayDeformSetting.getEnum(),
+		.framePacing          = framePacingSetting.getEnum(),
+		.fullStretch          = fullStretchSetting.getBoolean(),
+		.horizontalStretch    = horizontalStretchSetting.getFloat(),
+		.interleaveBlackFrame = interleaveBlackFrameSetting.getBoolean(),
+		.asyncTextureUpload   = asyncTextureUploadSetting.getBoolean(),
+	};
+}
+
 void RenderSettings::update(const Setting& setting) noexcept
 {
 	if (&setting == &brightnessSetting) {
@@ -222,7 +302,8 @@ void RenderSettings::update(const Setting& setting) noexcept
 	} else if (&setting == &contrastSetting) {
 		updateBrightnessAndContrast();
 	} else {
-		UNREACHABLE;
+		assert(contains(getCachedSettings(), &setting));
+		updateCached();
 	}
 }
 
@@ -11,6 +11,7 @@
 #include "gl_mat.hh"
 #include "narrow.hh"
 
+#include <array>
 #include <cstdint>
 
 namespace openmsx {
@@ -46,28 +47,35 @@ public:
 		NORMAL, _3D
 	};
 
+	/** When to present frames on the host display. */
+	enum class FramePacing : uint8_t {
+		EMULATION, // when the MSX frame is finished
+		HOST,      // at the host display refresh rate
+		BLEND,     // same, and blend between the last two MSX frames
+	};
+
 	explicit RenderSettings(CommandController& commandController);
 	~RenderSettings();
 
 	/** Accuracy [screen, line, pixel]. */
 	[[nodiscard]] EnumSetting<Accuracy>& getAccuracySetting() { return accuracySetting; }
-	[[nodiscard]] Accuracy getAccuracy() const { return accuracySetting.getEnum(); }
+	[[nodiscard]] Accuracy getAccuracy() const { return cached.accuracy; }
 
 	/** Deinterlacing [on, off]. */
 	[[nodiscard]] BooleanSetting& getDeinterlaceSetting() { return deinterlaceSetting; }
-	[[nodiscard]] bool getDeinterlace() const { return deinterlaceSetting.getBoolean(); }
+	[[nodiscard]] bool getDeinterlace() const { return cached.deinterlace; }
 
 	/** Deflicker [on, off]. */
 	[[nodiscard]] BooleanSetting& getDeflickerSetting() { return deflickerSetting; }
-	[[nodiscard]] bool getDeflicker() const { return deflickerSetting.getBoolean(); }
+	[[nodiscard]] bool getDeflicker() const { return cached.deflicker; }
 
 	/** The current max frameskip. */
 	[[nodiscard]] IntegerSetting& getMaxFrameSkipSetting() { return maxFrameSkipSetting; }
-	[[nodiscard]] int getMaxFrameSkip() const { return maxFrameSkipSetting.getInt(); }
+	[[nodiscard]] int getMaxFrameSkip() const { return cached.maxFrameSkip; }
 
 	/** The current min frameskip. */
 	[[nodiscard]] IntegerSetting& getMinFrameSkipSetting() { return minFrameSkipSetting; }
-	[[nodiscard]] int getMinFrameSkip() const { return minFrameSkipSetting.getInt(); }
+	[[nodiscard]] int getMinFrameSkip() const { return cached.minFrameSkip; }
 
 	/** Full screen [on, off]. */
 	[[nodiscard]] BooleanSetting& getFullScreenSetting() { return fullScreenSetting; }
@@ -75,7 +83,7 @@ public:
 
 	/** The amount of gamma correction. */
 	[[nodiscard]] FloatSetting& getGammaSetting() { return gammaSetting; }
-	[[nodiscard]] float getGamma() const { return gammaSetting.getFloat(); }
+	[[nodiscard]] float getGamma() const { return cached.gamma; }
 
 	/** Brightness video setting. */
 	[[nodiscard]] FloatSetting& getBrightnessSetting() { return brightnessSetting; }
@@ -92,26 +100,26 @@ public:
 
 	/** The amount of glow [0..100]. */
 	[[nodiscard]] IntegerSetting& getGlowSetting() { return glowSetting; }
-	[[nodiscard]] int getGlow() const { return glowSetting.getInt(); }
+	[[nodiscard]] int getGlow() const { return cached.glow; }
 
 	/** The amount of noise to add to the frame. */
 	[[nodiscard]] FloatSetting& getNoiseSetting() { return noiseSetting; }
-	[[nodiscard]] float getNoise() const { return noiseSetting.getFloat(); }
+	[[nodiscard]] float getNoise() const { return cached.noise; }
 
 	/** The amount of horizontal blur [0..256]. */
 	[[nodiscard]] IntegerSetting& getBlurSetting() { return horizontalBlurSetting; }
 	[[nodiscard]] int getBlurFactor() const {
-		return (horizontalBlurSetting.getInt()) * 256 / 100;
+		return cached.horizontalBlur * 256 / 100;
 	}
 
 	/** The alpha value [0..255] of the gap between scanlines. */
 	[[nodiscard]] IntegerSetting& getScanlineSetting() { return scanlineAlphaSetting; }
 	[[nodiscard]] int getScanlineFactor() const {
-		return 255 - ((scanlineAlphaSetting.getInt() * 255) / 100);
+		return 255 - ((cached.scanlineAlpha * 255) / 100);
 	}
 	/** The amount of space [0..1] between scanlines. */
 	[[nodiscard]] float getScanlineGap() const {
-		return narrow<float>(scanlineAlphaSetting.getInt()) * 0.01f;
+		return narrow<float>(cached.scanlineAlpha) * 0.01f;
 	}
 
 	/** The current renderer. */
@@ -124,7 +132,7 @@ public:
 	/** The current scaling algorithm. */
 	[[nodiscard]] auto& getScaleAlgorithmSetting() { return scaleAlgorithmSetting; }
 	[[nodiscard]] ScaleAlgorithm getScaleAlgorithm() const {
-		return scaleAlgorithmSetting.getEnum();
+		return cached.scaleAlgorithm;
 	}
 
 	/** The current scaling factor. */
@@ -141,7 +149,7 @@ public:
 
 	/** Disable sprite rendering? */
 	[[nodiscard]] BooleanSetting& getDisableSpritesSetting() { return disableSpritesSetting; }
-	[[nodiscard]] bool getDisableSprites() const { return disableSpritesSetting.getBoolean(); }
+	[[nodiscard]] bool getDisableSprites() const { return cached.disableSprites; }
 
 	/** CmdTiming [real, broken].
 	  * This setting is intended for debugging only, not for users. */
@@ -155,13 +163,23 @@ public:
 
 	/** Display deformation (normal, 3d). */
 	[[nodiscard]] auto& getDisplayDeformSetting() { return displayDeformSetting; }
-	[[nodiscard]] DisplayDeform getDisplayDeform() const { return displayDeformSetting.getEnum(); }
+	[[nodiscard]] DisplayDeform getDisplayDeform() const { return cached.displayDeform; }
 
 	/** VSync [on, off]. */
 	[[nodiscard]] BooleanSetting& getVSyncSetting() { return vSyncSetting; }
 
+	/** Frame pacing [emulation, host, blend]. */
+	[[nodiscard]] auto& getFramePacingSetting() { return framePacingSetting; }
+	[[nodiscard]] FramePacing getFramePacing() const { return cached.framePacing; }
+
+	/** Show the frames from a separate thread (see PresentThread). */
+	[[nodiscard]] BooleanSetting& getPresentThreadSetting() { return presentThreadSetting; }
+
+	/** Limit the number of frames queued in the GPU (0 = no limit). */
+	[[nodiscard]] IntegerSetting& getMaxFramesInFlightSetting() { return maxFramesInFlightSetting; }
+
 	[[nodiscard]] BooleanSetting& getFullStretchSetting() { return fullStretchSetting; }
-	[[nodiscard]] bool getFullStretch() const { return fullStretchSetting.getBoolean(); }
+	[[nodiscard]] bool getFullStretch() const { return cached.fullStretch; }
 
 	/** Amount of horizontal stretch.
 	  * This number represents the amount of MSX pixels (normal width) that
@@ -170,7 +188,7 @@ public:
 		return horizontalStretchSetting;
 	}
 	[[nodiscard]] float getHorizontalStretch() const {
-		return horizontalStretchSetting.getFloat();
+		return cached.horizontalStretch;
 	}
 
 	/** The amount of time until the pointer is hidden in the openMSX
@@ -184,7 +202,13 @@ public:
 
 	/** Is black frame interleaving enabled? */
 	[[nodiscard]] bool getInterleaveBlackFrame() const {
-		return interleaveBlackFrameSetting.getBoolean();
+		return cached.interleaveBlackFrame;
+	}
+
+	/** Upload the MSX frame via persistently mapped pixel buffers. */
+	[[nodiscard]] BooleanSetting& getAsyncTextureUploadSetting() { return asyncTextureUploadSetting; }
+	[[nodiscard]] bool getAsyncTextureUpload() const {
+		return cached.asyncTextureUpload;
 	}
 
 	/** Apply brightness, contrast and gamma transformation on the input
@@ -218,6 +242,10 @@ private:
 
 	void parseColorMatrix(Interpreter& interp, const TclObject& value);
 
+	/** The settings that are mirrored in 'cached'. */
+	[[nodiscard]] std::array<Setting*, 18> getCachedSettings();
+	void updateCached();
+
 private:
 	EnumSetting<Accuracy> accuracySetting;
 	BooleanSetting deinterlaceSetting;
@@ -242,10 +270,42 @@ private:
 	EnumSetting<bool> tooFastAccessSetting;
 	EnumSetting<DisplayDeform> displayDeformSetting;
 	BooleanSetting vSyncSetting;
+	EnumSetting<FramePacing> framePacingSetting;
+	BooleanSetting presentThreadSetting;
+	IntegerSetting maxFramesInFlightSetting;
 	BooleanSetting fullStretchSetting;
 	FloatSetting horizontalStretchSetting;
 	FloatSetting pointerHideDelaySetting;
 	BooleanSetting interleaveBlackFrameSetting;
+	BooleanSetting asyncTextureUploadSetting;
+
+	/** Copy of the values of the settings that are read on hot paths (per
+	  * frame, per line or per palette entry). Reading the setting itself
+	  * requires a conversion from TclObject (for enums even a string
+	  * lookup). Kept up-to-date via Observer<Setting>. RenderSettings is
+	  * the first observer of these settings, so other observers already
+	  * see the new values.
+	  */
+	struct Cached {
+		Accuracy accuracy;
+		bool deinterlace;
+		bool deflicker;
+		int maxFrameSkip;
+		int minFrameSkip;
+		float gamma;
+		int glow;
+		float noise;
+		int horizontalBlur;
+		int scanlineAlpha;
+		ScaleAlgorithm scaleAlgorithm;
+		bool disableSprites;
+		DisplayDeform displayDeform;
+		FramePacing framePacing;
+		bool fullStretch;
+		float horizontalStretch;
+		bool interleaveBlackFrame;
+		bool asyncTextureUpload;
+	} cached;
 
 	float brightness;
 	float contrast;
@@ -108,11 +108,11 @@ void SDLVideoSystem::flush()
 	screen->finish();
 }
 
-void SDLVideoSystem::takeScreenShot(const std::string& filename, bool withOsd)
+void SDLVideoSystem::takeScreenShot(const ScreenShotWriter::Target& target, bool withOsd)
 {
 	if (withOsd) {
 		// we can directly save current content as screenshot
-		screen->saveScreenshot(filename);
+		screen->takeScreenShot(*screen, target);
 	} else {
 		// we first need to re-render to an off-screen surface
 		// with OSD layers disabled
@@ -120,7 +120,7 @@ void SDLVideoSystem::takeScreenShot(const std::string& filename, bool withOsd)
 		ScopedLayerHider hideImgui(*imGuiLayer);
 		std::unique_ptr<OutputSurface> surf = screen->createOffScreenSurface();
 		display.repaintImpl(*surf);
-		surf->saveScreenshot(filename);
+		screen->takeScreenShot(*surf, target);
 	}
 }
 
@@ -183,9 +183,15 @@ void SDLVideoSystem::setWindowPosition(gl::ivec2 pos)
 	screen->setWindowPosition(pos);
 }
 
+std::optional<double> SDLVideoSystem::getRefreshRate()
+{
+	return screen->getRefreshRate();
+}
+
 void SDLVideoSystem::repaint()
 {
 	// With SDL we can simply repaint the display directly.
+	screen->beginFrame();
 	display.repaintImpl();
 }
 
@@ -43,7 +43,7 @@ public:
 		LaserdiscPlayer& ld) override;
 #endif
 	void flush() override;
-	void takeScreenShot(const std::string& filename, bool withOsd) override;
+	void takeScreenShot(const ScreenShotWriter::Target& target, bool withOsd) override;
 	void updateWindowTitle() override;
 	[[nodiscard]] std::optional<gl::ivec2> getMouseCoord() override;
 	[[nodiscard]] OutputSurface* getOutputSurface() override;
@@ -53,6 +53,7 @@ public:
 	void setClipboardText(zstring_view text) override;
 	[[nodiscard]] std::optional<gl::ivec2> getWindowPosition() override;
 	void setWindowPosition(gl::ivec2 pos) override;
+	[[nodiscard]] std::optional<double> getRefreshRate() override;
 	void repaint() override;
 
 private:
@@ -0,0 +1,134 @@
+#include "ScreenShotWriter.hh"
+
+#include "File.hh"
+#include "MSXException.hh"
+#include "PNG.hh"
+#include "PixelOperations.hh"
+
+#include "strCat.hh"
+#include "xrange.hh"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+namespace openmsx {
+
+ScreenShotWriter::Image::Image(unsigned width_, std::span<const uint32_t* const> rows)
+	: Image(width_, unsigned(rows.size()))
+{
+	for (auto y : xrange(height)) {
+		std::ranges::copy(std::span{rows[y], width}, getLine(y).begin());
+	}
+}
+
+static void writePPM(const ScreenShotWriter::Image& image, const std::string& filename)
+{
+	try {
+		File file(filename, File::OpenMode::TRUNCATE);
+		auto header = strCat("P6\n", image.width, ' ', image.height, "\n255\n");
+		file.write(std::span{header});
+
+		PixelOperations pixelOps;
+		MemBuffer<uint8_t> line(size_t(3) * image.width);
+		for (auto y : xrange(image.height)) {
+			auto* out = line.data();
+			for (auto p : image.getLine(y)) {
+				*out++ = uint8_t(pixelOps.red(p));
+				*out++ = uint8_t(pixelOps.green(p));
+				*out++ = uint8_t(pixelOps.blue(p));
+			}
+			file.write(std::span{line});
+		}
+	} catch (MSXException& e) {
+		throw MSXException(
+			"Error while writing PPM file \"", filename, "\": ",
+			e.getMessage());
+	}
+}
+
+void ScreenShotWriter::write(const Image& image, const Target& target)
+{
+	const auto& filename = target.filename;
+	switch (target.format) {
+	case Format::PNG: {
+		std::vector<const uint32_t*> rows(image.height);
+		for (auto y : xrange(image.height)) rows[y] = image.getLine(y).data();
+		PNG::saveRGBA(image.width, rows, filename, target.compressionLevel);
+		break;
+	}
+	case Format::PPM:
+		writePPM(image, filename);
+		break;
+	}
+}
+
+std::string_view getExtension(ScreenShotWriter::Format format)
+{
+	return (format == ScreenShotWriter::Format::PPM) ? ".ppm" : ".png";
+}
+
+ScreenShotWriter::~ScreenShotWriter()
+{
+	if (!thread.joinable()) return;
+	{
+		std::scoped_lock lock(mutex);
+		stop = true;
+	}
+	cond.notify_one();
+	thread.join(); // only returns after the queue is drained
+}
+
+void ScreenShotWriter::save(Image image, const Target& target)
+{
+	if (!target.async) {
+		write(image, target);
+		return;
+	}
+	{
+		std::scoped_lock lock(mutex);
+		queue.push_back(Job{std::move(image), target});
+	}
+	if (!thread.joinable()) {
+		thread = std::thread([this]() { workerLoop(); });
+	}
+	cond.notify_one();
+}
+
+void ScreenShotWriter::flush()
+{
+	std::unique_lock lock(mutex);
+	emptyCond.wait(lock, [&] { return queue.empty(); });
+}
+
+std::vector<std::string> ScreenShotWriter::takeErrors()
+{
+	std::scoped_lock lock(mutex);
+	return std::exchange(errors, {});
+}
+
+void ScreenShotWriter::workerLoop()
+{
+	std::unique_lock lock(mutex);
+	while (true) {
+		cond.wait(lock, [&] { return stop || !queue.empty(); });
+		if (queue.empty()) return; // stopped and queue is drained
+
+		// Only this thread removes elements, so this reference stays
+		// valid, also when other jobs are added in the meantime.
+		const auto& job = queue.front();
+		lock.unlock();
+		std::optional<std::string> err;
+		try {
+			write(job.image, job.target);
+		} catch (MSXException& e) {
+			err = e.getMessage();
+		}
+		lock.lock();
+		if (err) errors.push_back(std::move(*err));
+		queue.pop_front();
+		if (queue.empty()) emptyCond.notify_all();
+	}
+}
+
+} // namespace openmsx
@@ -0,0 +1,111 @@
+#ifndef SCREENSHOTWRITER_HH
+#define SCREENSHOTWRITER_HH
+
+#include "MemBuffer.hh"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace openmsx {
+
+/** Writes screenshots to file, optionally in a background thread.
+  *
+  * Encoding a PNG file takes much longer than grabbing the pixels. So when
+  * screenshots are taken often (e.g. every frame, to compare the output
+  * against reference images) the grabbed images can be queued, they're
+  * then encoded and written by a worker thread. Besides PNG there's also
+  * the (uncompressed) binary PPM format: that's much faster to write and
+  * trivial to read back for bulk comparisons.
+  */
+class ScreenShotWriter
+{
+public:
+	enum class Format : uint8_t { PNG, PPM };
+
+	/** Where (and how) to save a screenshot. */
+	struct Target {
+		std::string filename;
+		Format format = Format::PNG;
+		int compressionLevel = 6; // zlib level for PNG
+		bool async = false; // encode and write in the background
+	};
+
+	/** Pixels in the format of PixelOperations, rows from top to bottom. */
+	struct Image {
+		Image() = default;
+		Image(unsigned width_, unsigned height_)
+			: width(width_), height(height_)
+			, pixels(size_t(width_) * height_) {}
+
+		/** Copy the given rows. */
+		Image(unsigned width, std::span<const uint32_t* const> rows);
+
+		[[nodiscard]] std::span<uint32_t> getLine(unsigned y) {
+			return std::span{pixels}.subspan(size_t(y) * width, width);
+		}
+		[[nodiscard]] std::span<const uint32_t> getLine(unsigned y) const {
+			return std::span{pixels}.subspan(size_t(y) * width, width);
+		}
+
+		unsigned width = 0;
+		unsigned height = 0;
+		MemBuffer<uint32_t> pixels;
+	};
+
+	/** Write the image to file, on the calling thread.
+	  * @throws MSXException when writing fails. */
+	static void write(const Image& image, const Target& target);
+
+public:
+	ScreenShotWriter() = default;
+	ScreenShotWriter(const ScreenShotWriter&) = delete;
+	ScreenShotWriter(ScreenShotWriter&&) = delete;
+	ScreenShotWriter& operator=(const ScreenShotWriter&) = delete;
+	ScreenShotWriter& operator=(ScreenShotWriter&&) = delete;
+
+	/** Waits till all queued images are written. */
+	~ScreenShotWriter();
+
+	/** Write the image directly, or queue it when 'target.async' is set.
+	  * @throws MSXException when a direct write fails. */
+	void save(Image image, const Target& target);
+
+	/** Wait till all queued images are written. */
+	void flush();
+
+	/** The errors of the (queued) writes that failed since the previous
+	  * call. */
+	[[nodiscard]] std::vector<std::string> takeErrors();
+
+private:
+	struct Job {
+		Image image;
+		Target target;
+	};
+	void workerLoop();
+
+private:
+	std::mutex mutex;
+	std::condition_variable cond;      // signals new work (or stop)
+	std::condition_variable emptyCond; // signals the queue became empty
+	// The following are protected by 'mutex'.
+	std::deque<Job> queue;
+	std::vector<std::string> errors;
+	bool stop = false;
+
+	std::thread thread; // started on the first queued image
+};
+
+/** File extension (including the dot) for the given format. */
+[[nodiscard]] std::string_view getExtension(ScreenShotWriter::Format format);
+
+} // namespace openmsx
+
+#endif
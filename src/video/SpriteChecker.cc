@@ -26,6 +26,7 @@ SpriteChecker::SpriteChecker(VDP& vdp_, RenderSettings& renderSettings,
 	: vdp(vdp_), vram(vdp.getVRAM())
 	, limitSpritesSetting(renderSettings.getLimitSpritesSetting())
 	, frameStartTime(time)
+	, dirtyPages(vram.getDirtyPages())
 {
 	vram.spriteAttribTable.setObserver(this);
 	vram.spritePatternTable.setObserver(this);
@@ -38,6 +39,7 @@ void SpriteChecker::reset(EmuTime time)
 	collisionY = 0;
 
 	frameStart(time);
+	invalidateCache();
 
 	updateSpritesMethod = &SpriteChecker::updateSprites1;
 }
@@ -67,6 +69,150 @@ inline SpriteChecker::SpritePattern SpriteChecker::calculatePatternPlanar(
 	return !vdp.isSpriteMag() ? pattern : doublePattern(pattern);
 }
 
+SpriteChecker::CacheKey SpriteChecker::getCacheKey(int spriteMode) const
+{
+	return {
+		.attribRange  = vram.spriteAttribTable .getAddressRange(),
+		.patternRange = vram.spritePatternTable.getAddressRange(),
+		.displayDelta = vdp.getVerticalScroll() - vdp.getLineZero(),
+		.size = vdp.getSpriteSize(),
+		.spriteMode = spriteMode,
+		.mag = vdp.isSpriteMag(),
+		.planar = planar,
+		.limitSprites = limitSpritesSetting.getBoolean(),
+		.can0collide = vdp.canSpriteColor0Collide(),
+	};
+}
+
+void SpriteChecker::checkCacheKey(int spriteMode)
+{
+	auto key = getCacheKey(spriteMode);
+	if (key != cacheKey) {
+		cacheKey = key;
+		invalidateCache();
+	}
+}
+
+void SpriteChecker::invalidateCache()
+{
+	cachedEpoch.fill(0);
+}
+
+bool SpriteChecker::isLineCached(int line) const
+{
+	auto epoch = cachedEpoch[line];
+	if (epoch == 0) return false;
+
+	// Were any of the VRAM pages that contain the tables written to?
+	auto isDirty = [&](unsigned first, unsigned last) {
+		for (auto page : xrange(first >> DirtyPages::PAGE_BITS, (last >> DirtyPages::PAGE_BITS) + 1)) {
+			if (dirtyPages.isDirty(page, epoch)) return true;
+		}
+		return false;
+	};
+	for (auto [first, last] : {cacheKey.attribRange, cacheKey.patternRange}) {
+		if (first > last) continue; // disabled table
+		if (cacheKey.planar && (first < 0x10000) && (last >= 0x10000)) {
+			// The table is split over both planes, don't include all
+			// the VRAM in between.
+			if (isDirty(first, last & 0xFFFF) || isDirty(first | 0x10000, last)) return false;
+		} else {
+			if (isDirty(first, last)) return false;
+		}
+	}
+	return true;
+}
+
+template<typename CalcSprites>
+void SpriteChecker::fillSpriteLines(int minLine, int maxLine, CalcSprites calc)
+{
+	int runStart = -1;
+	auto calcRun = [&](int runEnd) {
+		if (runStart == -1) return;
+		// Only cache lines that didn't contain sprites yet (normally
+		// every line is only checked once per frame).
+		bool cacheable = std::all_of(&spriteCount[runStart], &spriteCount[runEnd],
+		                             [](auto c) { return c == 0; });
+		std::fill(&fifthSprite[runStart], &fifthSprite[runEnd], -1);
+		calc(runStart, runEnd);
+		// Writes to VRAM after this point (will) have a later epoch.
+		auto epoch = cacheable ? dirtyPages.checkpoint() : 0;
+		for (auto line : xrange(runStart, runEnd)) {
+			cachedEpoch[line] = epoch;
+			cachedCount[line] = spriteCount[line];
+			cachedCollision[line] = COLLISION_UNKNOWN;
+		}
+		runStart = -1;
+	};
+	for (auto line : xrange(minLine, maxLine)) {
+		if ((spriteCount[line] == 0) && isLineCached(line)) {
+			calcRun(line);
+			// spriteBuffer[line] and fifthSprite[line] still contain
+			// the values of the last time this line was calculated.
+			spriteCount[line] = cachedCount[line];
+		} else if (runStart == -1) {
+			runStart = line;
+		}
+	}
+	calcRun(maxLine);
+}
+
+template<int MAX_SPRITES>
+void SpriteChecker::updateStatus(int minLine, int maxLine, int numSprites)
+{
+	// The 5th (or 9th) sprite number is the one of the first line where
+	// this condition occurs.
+	int fifthSpriteNum = -1; // no 5th sprite detected
+	for (auto line : xrange(minLine, maxLine)) {
+		if (fifthSprite[line] != -1) {
+			fifthSpriteNum = fifthSprite[line];
+			break;
+		}
+	}
+
+	// Update status register.
+	uint8_t status = vdp.getStatusReg0();
+	if (fifthSpriteNum != -1) {
+		// Five (or nine) sprites on a line.
+		// According to TMS9918.pdf 5th sprite detection is only
+		// active when F flag is zero. Stuck to this for V9938.
+		// Dragon Quest 2 needs this.
+		if ((status & 0xC0) == 0) {
+			status = uint8_t(0x40 | (status & 0x20) | fifthSpriteNum);
+		}
+	}
+	if (~status & 0x40) {
+		// No 5th sprite detected, store number of latest sprite processed.
+		status = (status & 0x20) | uint8_t(std::min(numSprites, 31));
+	}
+	vdp.setSpriteStatus(status);
+
+	// Optimisation:
+	// If collision already occurred,
+	// that state is stable until it is reset by a status reg read,
+	// so no need to execute the checks.
+	// The spriteBuffer array is filled now, so we can bail out.
+	if (vdp.getStatusReg0() & 0x20) return;
+
+	for (auto line : xrange(minLine, maxLine)) {
+		auto& minXCollision = cachedCollision[line];
+		if (minXCollision == COLLISION_UNKNOWN) {
+			minXCollision = (MAX_SPRITES == 4) ? calcCollision1(line)
+			                                   : calcCollision2(line);
+		}
+		if (minXCollision < 256) {
+			vdp.setSpriteStatus(vdp.getStatusReg0() | 0x20);
+			// verified: collision coords are also filled
+			//           in for sprite mode 1
+			// x-coord should be increased by 12
+			// y-coord                         8
+			collisionX = minXCollision + 12;
+			collisionY = line - vdp.getLineZero() + 8;
+			return; // don't check lines with higher Y-coord
+		}
+	}
+}
+
 void SpriteChecker::updateSprites1(int limit)
 {
 	if (vdp.spritesEnabledFast()) {
@@ -84,7 +230,7 @@ void SpriteChecker::updateSprites1(int limit)
 	currentLine = limit;
 }
 
-inline void SpriteChecker::checkSprites1(int minLine, int maxLine)
+inline void SpriteChecker::calcSprites1(int minLine, int maxLine)
 {
 	// This implementation contains a double for-loop. The outer loop goes
 	// over the sprites, the inner loop over the to-be-checked lines. This
@@ -100,7 +246,7 @@ inline void SpriteChecker::checkSprites1(int minLine, int maxLine)
 	// This routine also needs to detect the sprite number of the 'first'
 	// 5th-sprite-condition. With 'first' meaning the first line where this
 	// condition occurs. Because our loops are swapped compared to the real
-	// VDP, we need some extra fixup logic to correctly detect this.
+	// VDP, we record this per line, see updateStatus().
 
 	// Calculate display line.
 	// This is the line sprites are checked at; the line they are displayed
@@ -114,11 +260,8 @@ inline void SpriteChecker::checkSprites1(int minLine, int maxLine)
 	int magSize = (mag + 1) * size;
 	auto attributePtr = vram.spriteAttribTable.getReadArea<32 * 4>(0);
 	uint8_t patternIndexMask = size == 16 ? 0xFC : 0xFF;
-	int fifthSpriteNum  = -1;  // no 5th sprite detected yet
-	int fifthSpriteLine = 999; // larger than any possible valid line
 
-	int sprite = 0;
-	for (/**/; sprite < 32; ++sprite) {
+	for (int sprite = 0; sprite < 32; ++sprite) {
 		int y = attributePtr[4 * sprite + 0];
 		if (y == 208) break;
 
@@ -134,10 +277,8 @@ inline void SpriteChecker::checkSprites1(int minLine, int maxLine)
 
 			auto visibleIndex = spriteCount[line];
 			if (visibleIndex == 4) {
-				// Find earliest line where this condition occurs.
-				if (line < fifthSpriteLine) {
-					fifthSpriteLine = line;
-					fifthSpriteNum = sprite;
+				if (fifthSprite[line] == -1) {
+					fifthSprite[line] = narrow<int8_t>(sprite);
 				}
 				if (limitSprites) continue;
 			}
@@ -154,30 +295,10 @@ inline void SpriteChecker::checkSprites1(int minLine, int maxLine)
 			spriteCount[line] = visibleIndex + 1;
 		}
 	}
+}
 
-	// Update status register.
-	uint8_t status = vdp.getStatusReg0();
-	if (fifthSpriteNum != -1) {
-		// Five sprites on a line.
-		// According to TMS9918.pdf 5th sprite detection is only
-		// active when F flag is zero.
-		if ((status & 0xC0) == 0) {
-			status = uint8_t(0x40 | (status & 0x20) | fifthSpriteNum);
-		}
-	}
-	if (~status & 0x40) {
-		// No 5th sprite detected, store number of latest sprite processed.
-		status = (status & 0x20) | uint8_t(std::min(sprite, 31));
-	}
-	vdp.setSpriteStatus(status);
-
-	// Optimisation:
-	// If collision already occurred,
-	// that state is stable until it is reset by a status reg read,
-	// so no need to execute the checks.
-	// The spriteBuffer array is filled now, so we can bail out.
-	if (vdp.getStatusReg0() & 0x20) return;
-
+int16_t SpriteChecker::calcCollision1(int line) const
+{
 	/*
 	Model for sprite collision: (or "coincidence" in TMS9918 data sheet)
 	- Reset when status reg is read.
@@ -193,53 +314,55 @@ inline void SpriteChecker::checkSprites1(int minLine, int maxLine)
 	Implemented by checking every pair for collisions.
 	For large numbers of sprites that would be slow,
 	but there are max 4 sprites and therefore max 6 pairs.
-	If any collision is found, method returns at once.
 	*/
 	bool can0collide = vdp.canSpriteColor0Collide();
-	for (auto line : xrange(minLine, maxLine)) {
-		int minXCollision = 999;
-		for (int i = std::min<int>(4, spriteCount[line]); --i >= 1; /**/) {
-			auto color1 = spriteBuffer[line][i].colorAttrib & 0xf;
-			if (!can0collide && (color1 == 0)) continue;
-			int x_i = spriteBuffer[line][i].x;
-			SpritePattern pattern_i = spriteBuffer[line][i].pattern;
-			for (int j = i; --j >= 0; /**/) {
-				auto color2 = spriteBuffer[line][j].colorAttrib & 0xf;
-				if (!can0collide && (color2 == 0)) continue;
-				// Do sprite i and sprite j collide?
-				int x_j = spriteBuffer[line][j].x;
-				int dist = x_j - x_i;
-				if ((-magSize < dist) && (dist < magSize)) {
-					SpritePattern pattern_j = spriteBuffer[line][j].pattern;
-					if (dist < 0) {
-						pattern_j <<= -dist;
-					} else {
-						pattern_j >>= dist;
-					}
-					SpritePattern colPat = pattern_i & pattern_j;
-					if (x_i < 0) {
-						assert(x_i >= -32);
-						colPat &= (1 << (32 + x_i)) - 1;
-					}
-					if (colPat) {
-						int xCollision = x_i + std::countl_zero(colPat);
-						assert(xCollision >= 0);
-						minXCollision = std::min(minXCollision, xCollision);
-					}
+	int magSize = (vdp.isSpriteMag() + 1) * vdp.getSpriteSize();
+	int minXCollision = NO_COLLISION;
+	for (int i = std::min<int>(4, spriteCount[line]); --i >= 1; /**/) {
+		auto color1 = spriteBuffer[line][i].colorAttrib & 0xf;
+		if (!can0collide && (color1 == 0)) continue;
+		int x_i = spriteBuffer[line][i].x;
+		SpritePattern pattern_i = spriteBuffer[line][i].pattern;
+		for (int j = i; --j >= 0; /**/) {
+			auto color2 = spriteBuffer[line][j].colorAttrib & 0xf;
+			if (!can0collide && (color2 == 0)) continue;
+			// Do sprite i and sprite j collide?
+			int x_j = spriteBuffer[line][j].x;
+			int dist = x_j - x_i;
+			if ((-magSize < dist) && (dist < magSize)) {
+				SpritePattern pattern_j = spriteBuffer[line][j].pattern;
+				if (dist < 0) {
+					pattern_j <<= -dist;
+				} else {
+					pattern_j >>= dist;
+				}
+				SpritePattern colPat = pattern_i & pattern_j;
+				if (x_i < 0) {
+					assert(x_i >= -32);
+					colPat &= (1 << (32 + x_i)) - 1;
+				}
+				if (colPat) {
+					int xCollision = x_i + std::countl_zero(colPat);
+					assert(xCollision >= 0);
+					minXCollision = std::min(minXCollision, xCollision);
 				}
 			}
 		}
-		if (minXCollision < 256) {
-			vdp.setSpriteStatus(vdp.getStatusReg0() | 0x20);
-			// verified: collision coords are also filled
-			//           in for sprite mode 1
-			// x-coord should be increased by 12
-			// y-coord                         8
-			collisionX = minXCollision + 12;
-			collisionY = line - vdp.getLineZero() + 8;
-			return; // don't check lines with higher Y-coord
-		}
 	}
+	return narrow<int16_t>(minXCollision);
+}
+
+inline void SpriteChecker::checkSprites1(int minLine, int maxLine)
+{
+	checkCacheKey(1);
+	fillSpriteLines(minLine, maxLine, [&](int from, int to) { calcSprites1(from, to); });
+
+	// Number of sprites before the end marker.
+	auto attributePtr = vram.spriteAttribTable.getReadArea<32 * 4>(0);
+	int numSprites = 0;
+	while ((numSprites < 32) && (attributePtr[4 * numSprites] != 208)) ++numSprites;
+
+	updateStatus<4>(minLine, maxLine, numSprites);
 }
 
 void SpriteChecker::updateSprites2(int limit)
@@ -260,32 +383,29 @@ void SpriteChecker::updateSprites2(int limit)
 	currentLine = limit;
 }
 
-inline void SpriteChecker::checkSprites2(int minLine, int maxLine)
+inline void SpriteChecker::calcSprites2(int minLine, int maxLine)
 {
-	// See comment in checkSprites1() about order of inner and outer loops.
+	// See comment in calcSprites1() about order of inner and outer loops.
 
 	// Calculate display line.
 	// This is the line sprites are checked at; the line they are displayed
 	// at is one lower.
 	int displayDelta = vdp.getVerticalScroll() - vdp.getLineZero();
 
-	// Get sprites for this line and detect 5th sprite if any.
+	// Get sprites for this line and detect 9th sprite if any.
 	bool limitSprites = limitSpritesSetting.getBoolean();
 	int size = vdp.getSpriteSize();
 	bool mag = vdp.isSpriteMag();
 	int magSize = (mag + 1) * size;
 	int patternIndexMask = (size == 16) ? 0xFC : 0xFF;
-	int ninthSpriteNum  = -1;  // no 9th sprite detected yet
-	int ninthSpriteLine = 999; // larger than any possible valid line
 
 	// Because it gave a measurable performance boost, we duplicated the
 	// code for planar and non-planar modes.
-	int sprite = 0;
 	if (planar) {
 		auto [attributePtr0, attributePtr1] =
 			vram.spriteAttribTable.getReadAreaPlanar<32 * 4>(512);
 		// TODO: Verify CC implementation.
-		for (/**/; sprite < 32; ++sprite) {
+		for (int sprite = 0; sprite < 32; ++sprite) {
 			int y = attributePtr0[2 * sprite + 0];
 			if (y == 216) break;
 
@@ -301,10 +421,8 @@ inline void SpriteChecker::checkSprites2(int minLine, int maxLine)
 
 				auto visibleIndex = spriteCount[line];
 				if (visibleIndex == 8) {
-					// Find earliest line where this condition occurs.
-					if (line < ninthSpriteLine) {
-						ninthSpriteLine = line;
-						ninthSpriteNum = sprite;
+					if (fifthSprite[line] == -1) {
+						fifthSprite[line] = narrow<int8_t>(sprite);
 					}
 					if (limitSprites) continue;
 				}
@@ -330,7 +448,7 @@ inline void SpriteChecker::checkSprites2(int minLine, int maxLine)
 		auto attributePtr0 =
 			vram.spriteAttribTable.getReadArea<32 * 4>(512);
 		// TODO: Verify CC implementation.
-		for (/**/; sprite < 32; ++sprite) {
+		for (int sprite = 0; sprite < 32; ++sprite) {
 			int y = attributePtr0[4 * sprite + 0];
 			if (y == 216) break;
 
@@ -346,10 +464,8 @@ inline void SpriteChecker::checkSprites2(int minLine, int maxLine)
 
 				auto visibleIndex = spriteCount[line];
 				if (visibleIndex == 8) {
-					// Find earliest line where this condition occurs.
-					if (line < ninthSpriteLine) {
-						ninthSpriteLine = line;
-						ninthSpriteNum = sprite;
+					if (fifthSprite[line] == -1) {
+						fifthSprite[line] = narrow<int8_t>(sprite);
 					}
 					if (limitSprites) continue;
 				}
@@ -384,31 +500,10 @@ inline void SpriteChecker::checkSprites2(int minLine, int maxLine)
 			}
 		}
 	}
+}
 
-	// Update status register.
-	uint8_t status = vdp.getStatusReg0();
-	if (ninthSpriteNum != -1) {
-		// Nine sprites on a line.
-		// According to TMS9918.pdf 5th sprite detection is only
-		// active when F flag is zero. Stuck to this for V9938.
-		// Dragon Quest 2 needs this.
-		if ((status & 0xC0) == 0) {
-			status = uint8_t(0x40 | (status & 0x20) | ninthSpriteNum);
-		}
-	}
-	if (~status & 0x40) {
-		// No 9th sprite detected, store number of latest sprite processed.
-		status = (status & 0x20) | uint8_t(std::min(sprite, 31));
-	}
-	vdp.setSpriteStatus(status);
-
-	// Optimisation:
-	// If collision already occurred,
-	// that state is stable until it is reset by a status reg read,
-	// so no need to execute the checks.
-	// The visibleSprites array is filled now, so we can bail out.
-	if (vdp.getStatusReg0() & 0x20) return;
-
+int16_t SpriteChecker::calcCollision2(int line) const
+{
 	/*
 	Model for sprite collision: (or "coincidence" in TMS9918 data sheet)
 	- Reset when status reg is read.
@@ -429,55 +524,67 @@ inline void SpriteChecker::checkSprites2(int minLine, int maxLine)
 	        Probably new approach is needed anyway for OR-ing.
 	*/
 	bool can0collide = vdp.canSpriteColor0Collide();
-	for (auto line : xrange(minLine, maxLine)) {
-		int minXCollision = 999; // no collision
-		std::span<SpriteInfo, 32 + 1> visibleSprites = spriteBuffer[line];
-		for (int i = std::min<int>(8, spriteCount[line]); --i >= 1; /**/) {
-			auto colorAttrib1 = visibleSprites[i].colorAttrib;
-			if (!can0collide && ((colorAttrib1 & 0xf) == 0)) continue;
+	int magSize = (vdp.isSpriteMag() + 1) * vdp.getSpriteSize();
+	int minXCollision = NO_COLLISION;
+	std::span<const SpriteInfo, 32 + 1> visibleSprites = spriteBuffer[line];
+	for (int i = std::min<int>(8, spriteCount[line]); --i >= 1; /**/) {
+		auto colorAttrib1 = visibleSprites[i].colorAttrib;
+		if (!can0collide && ((colorAttrib1 & 0xf) == 0)) continue;
+		// If CC or IC is set, this sprite cannot collide.
+		if (colorAttrib1 & 0x60) continue;
+
+		int x_i = visibleSprites[i].x;
+		SpritePattern pattern_i = visibleSprites[i].pattern;
+		for (int j = i; --j >= 0; /**/) {
+			auto colorAttrib2 = visibleSprites[j].colorAttrib;
+			if (!can0collide && ((colorAttrib2 & 0xf) == 0)) continue;
 			// If CC or IC is set, this sprite cannot collide.
-			if (colorAttrib1 & 0x60) continue;
-
-			int x_i = visibleSprites[i].x;
-			SpritePattern pattern_i = visibleSprites[i].pattern;
-			for (int j = i; --j >= 0; /**/) {
-				auto colorAttrib2 = visibleSprites[j].colorAttrib;
-				if (!can0collide && ((colorAttrib2 & 0xf) == 0)) continue;
-				// If CC or IC is set, this sprite cannot collide.
-				if (colorAttrib2 & 0x60) continue;
-
-				// Do sprite i and sprite j collide?
-				int x_j = visibleSprites[j].x;
-				int dist = x_j - x_i;
-				if ((-magSize < dist) && (dist < magSize)) {
-					SpritePattern pattern_j = visibleSprites[j].pattern;
-					if (dist < 0) {
-						pattern_j <<= -dist;
-					} else {
-						pattern_j >>= dist;
-					}
-					SpritePattern colPat = pattern_i & pattern_j;
-					if (x_i < 0) {
-						assert(x_i >= -32);
-						colPat &= (1 << (32 + x_i)) - 1;
-					}
-					if (colPat) {
-						int xCollision = x_i + std::countl_zero(colPat);
-						assert(xCollision >= 0);
-						minXCollision = std::min(minXCollision, xCollision);
-					}
+			if (colorAttrib2 & 0x60) continue;
+
+			// Do sprite i and sprite j collide?
+			int x_j = visibleSprites[j].x;
+			int dist = x_j - x_i;
+			if ((-magSize < dist) && (dist < magSize)) {
+				SpritePattern pattern_j = visibleSprites[j].pattern;
+				if (dist < 0) {
+					pattern_j <<= -dist;
+				} else {
+					pattern_j >>= dist;
+				}
+				SpritePattern colPat = pattern_i & pattern_j;
+				if (x_i < 0) {
+					assert(x_i >= -32);
+					colPat &= (1 << (32 + x_i)) - 1;
+				}
+				if (colPat) {
+					int xCollision = x_i + std::countl_zero(colPat);
+					assert(xCollision >= 0);
+					minXCollision = std::min(minXCollision, xCollision);
 				}
 			}
 		}
-		if (minXCollision < 256) {
-			vdp.setSpriteStatus(vdp.getStatusReg0() | 0x20);
-			// x-coord should be increased by 12
-			// y-coord                         8
-			collisionX = minXCollision + 12;
-			collisionY = line - vdp.getLineZero() + 8;
-			return; // don't check lines with higher Y-coord
-		}
 	}
+	return narrow<int16_t>(minXCollision);
+}
+
+inline void SpriteChecker::checkSprites2(int minLine, int maxLine)
+{
+	checkCacheKey(2);
+	fillSpriteLines(minLine, maxLine, [&](int from, int to) { calcSprites2(from, to); });
+
+	// Number of sprites before the end marker.
+	int numSprites = 0;
+	if (planar) {
+		auto [attributePtr0, attributePtr1] =
+			vram.spriteAttribTable.getReadAreaPlanar<32 * 4>(512);
+		while ((numSprites < 32) && (attributePtr0[2 * numSprites] != 216)) ++numSprites;
+	} else {
+		auto attributePtr0 =
+			vram.spriteAttribTable.getReadArea<32 * 4>(512);
+		while ((numSprites < 32) && (attributePtr0[4 * numSprites] != 216)) ++numSprites;
+	}
+
+	updateStatus<8>(minLine, maxLine, numSprites);
 }
 
 // version 1: initial version
@@ -499,6 +606,7 @@ void SpriteChecker::serialize(Archive& ar, unsigned version)
 		// first (partial) frame after loadstate.
 		std::ranges::fill(spriteCount, 0);
 		// content of spriteBuffer[] doesn't matter if spriteCount[] is 0
+		invalidateCache();
 	}
 	ar.serialize("collisionX", collisionX,
 	             "collisionY", collisionY);
@@ -1,6 +1,7 @@
 #ifndef SPRITECHECKER_HH
 #define SPRITECHECKER_HH
 
+#include "DirtyPages.hh"
 #include "DisplayMode.hh"
 #include "VDP.hh"
 #include "VDPVRAM.hh"
@@ -15,6 +16,7 @@
 #include <array>
 #include <cstdint>
 #include <span>
+#include <utility>
 
 namespace openmsx {
 
@@ -269,8 +271,14 @@ public:
 		checkUntil(time);
 	}
 
+	void updateVRAMRange(unsigned /*offset*/, unsigned /*num*/, EmuTime time) override {
+		checkUntil(time);
+	}
+
 	void updateWindow(bool /*enabled*/, EmuTime time) override {
 		sync(time);
+		// No need to invalidate the cache, the table address ranges are
+		// part of the cache key.
 	}
 
 	template<typename Archive>
@@ -317,6 +325,52 @@ private:
 	[[nodiscard]] SpritePattern calculatePatternNP(unsigned patternNr, unsigned y) const;
 	[[nodiscard]] SpritePattern calculatePatternPlanar(unsigned patternNr, unsigned y) const;
 
+	/** Cache of the per-line sprite checking results, see below. The
+	  * results for a line are still valid as long as this key is the same
+	  * and the VRAM pages of the tables weren't written to.
+	  */
+	struct CacheKey {
+		std::pair<unsigned, unsigned> attribRange;
+		std::pair<unsigned, unsigned> patternRange;
+		int displayDelta;
+		int size;
+		int spriteMode;
+		bool mag;
+		bool planar;
+		bool limitSprites;
+		bool can0collide;
+		[[nodiscard]] bool operator==(const CacheKey&) const = default;
+	};
+	[[nodiscard]] CacheKey getCacheKey(int spriteMode) const;
+	void checkCacheKey(int spriteMode);
+	[[nodiscard]] bool isLineCached(int line) const;
+	void invalidateCache();
+
+	/** Fill in spriteBuffer[], spriteCount[] and fifthSprite[] for the
+	  * given lines. Lines with valid cached results are taken from the
+	  * cache, for the others 'calc' is called.
+	  */
+	template<typename CalcSprites>
+	void fillSpriteLines(int minLine, int maxLine, CalcSprites calc);
+
+	/** Update the 5th (or 9th) sprite status and the collision status
+	  * for the given (already filled in) lines.
+	  */
+	template<int MAX_SPRITES>
+	void updateStatus(int minLine, int maxLine, int numSprites);
+
+	/** Calculate the visible sprites for the given lines.
+	  * @effect Fills in spriteBuffer[], spriteCount[] and fifthSprite[].
+	  */
+	void calcSprites1(int minLine, int maxLine);
+	void calcSprites2(int minLine, int maxLine);
+
+	/** X coordinate of the (leftmost) collision on the given line, or
+	  * NO_COLLISION. Only sprites in spriteBuffer[line] are considered.
+	  */
+	[[nodiscard]] int16_t calcCollision1(int line) const;
+	[[nodiscard]] int16_t calcCollision2(int line) const;
+
 	/** Check sprite collision and number of sprites per line.
 	  * This routine implements sprite mode 1 (MSX1).
 	  * Separated from display code to make MSX behaviour consistent
@@ -393,6 +447,24 @@ private:
 	  */
 	std::array<uint8_t, VDP::NUM_LINES_MAX> spriteCount;
 
+	/** Per line: the number of the sprite that triggered the 5th (mode 1)
+	  * or 9th (mode 2) sprite condition, or -1.
+	  */
+	std::array<int8_t, VDP::NUM_LINES_MAX> fifthSprite;
+
+	/** The (per-line) cache. Unlike spriteCount[] this is not cleared at
+	  * the start of a frame, and spriteBuffer[] isn't touched for lines
+	  * that are served from the cache. Many games leave the sprites
+	  * unchanged for many frames.
+	  */
+	static constexpr int16_t COLLISION_UNKNOWN = -1;
+	static constexpr int16_t NO_COLLISION = 999;
+	DirtyPages& dirtyPages;
+	CacheKey cacheKey = {};
+	std::array<DirtyPages::Epoch, VDP::NUM_LINES_MAX> cachedEpoch = {}; // 0 -> invalid
+	std::array<uint8_t, VDP::NUM_LINES_MAX> cachedCount;
+	std::array<int16_t, VDP::NUM_LINES_MAX> cachedCollision;
+
 	/** Is current display mode planar or not?
 	  * TODO: Introduce separate update methods for planar/non-planar modes.
 	  */
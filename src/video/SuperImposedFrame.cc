@@ -3,14 +3,54 @@
 #include "LineScalers.hh"
 
 #include "inplace_buffer.hh"
+#include "xrange.hh"
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cstdint>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace openmsx {
 
 using Pixel = uint32_t;
 
+enum class AlphaType : uint8_t { ALL_OPAQUE, ALL_TRANSPARENT, MIXED };
+
+[[nodiscard]] static AlphaType getAlphaType(std::span<const Pixel> line)
+{
+	// alpha is stored in the upper 8 bits, see PixelOperations
+	Pixel andAlpha = 0xFF000000;
+	Pixel orAlpha  = 0x00000000;
+	size_t i = 0;
+#ifdef __SSE2__
+	auto andV = _mm_set1_epi32(-1);
+	auto orV  = _mm_setzero_si128();
+	for (/**/; (i + 4) <= line.size(); i += 4) {
+		auto p = _mm_loadu_si128(std::bit_cast<const __m128i*>(&line[i]));
+		andV = _mm_and_si128(andV, p);
+		orV  = _mm_or_si128 (orV,  p);
+	}
+	std::array<Pixel, 4> a, o;
+	_mm_storeu_si128(std::bit_cast<__m128i*>(a.data()), andV);
+	_mm_storeu_si128(std::bit_cast<__m128i*>(o.data()), orV);
+	for (auto j : xrange(4)) {
+		andAlpha &= a[j];
+		orAlpha  |= o[j];
+	}
+#endif
+	for (/**/; i < line.size(); ++i) {
+		andAlpha &= line[i];
+		orAlpha  |= line[i];
+	}
+	if ((andAlpha & 0xFF000000) == 0xFF000000) return AlphaType::ALL_OPAQUE;
+	if ((orAlpha  & 0xFF000000) == 0x00000000) return AlphaType::ALL_TRANSPARENT;
+	return AlphaType::MIXED;
+}
+
 void SuperImposedFrame::init(
 	const FrameSource* top_, const FrameSource* bottom_)
 {
@@ -39,10 +79,22 @@ std::span<const FrameSource::Pixel> SuperImposedFrame::getUnscaledLine(
 	                      helpBuf.size()); // but no wider than the output buffer
 
 	auto tBuf = helpBuf.subspan(0, width);
+	auto tLine = top->getLine(narrow<int>(tNum), tBuf);
+
+	// Often (e.g. a V9990 screen without transparent pixels, or border
+	// lines) the top line is completely opaque or completely transparent.
+	// Then only one of the two lines is needed and no blending is required.
+	switch (getAlphaType(tLine)) {
+	case AlphaType::ALL_OPAQUE:
+		return tLine;
+	case AlphaType::ALL_TRANSPARENT:
+		return bottom->getLine(narrow<int>(bNum), tBuf);
+	default:
+		break;
+	}
+
 	inplace_buffer<Pixel, 1280> bBuf(uninitialized_tag{}, width);
-	auto tLine = top   ->getLine(narrow<int>(tNum), tBuf);
 	auto bLine = bottom->getLine(narrow<int>(bNum), bBuf);
-
 	alphaBlendLines(tLine, bLine, tBuf); // possibly tLine == tBuf
 	return tBuf;
 }
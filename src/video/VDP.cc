@@ -254,6 +254,7 @@ void VDP::resetInit()
 	// note: vram, spriteChecker, cmdEngine, renderer may not yet be
 	//       created at this point
 	std::ranges::fill(controlRegs, 0);
+	registerHistory.clear();
 	if (isVDPwithPALonly()) {
 		// Boots (and remains) in PAL mode, all other VDPs boot in NTSC.
 		controlRegs[9] |= 0x02;
@@ -786,6 +787,12 @@ uint8_t VDP::vramRead(EmuTime time)
 
 void VDP::scheduleCpuVramAccess(bool isRead, uint8_t write, EmuTime time)
 {
+	// Note: block I/O instructions (OTIR, INIR, ...) deliberately go
+	// through here one byte at a time. Each byte gets its own access slot,
+	// and both the renderer sync (VRAMWindow notification) and the
+	// 'too fast' detection depend on that exact per-byte timing. Batching
+	// such a burst (e.g. via VDPVRAM::cpuWriteBlock()) would lose this.
+
 	// Tested on real V9938: 'cpuVramData' is shared between read and write.
 	// E.g. OUT (#98),A followed by IN A,(#98) returns the just written value.
 	if (!isRead) cpuVramData = write;
@@ -1060,6 +1067,7 @@ void VDP::changeRegister(uint8_t reg, uint8_t val, EmuTime time)
 	}
 
 	if (!change) return;
+	registerHistory.record(time, reg, controlRegs[reg], val);
 
 	// Perform additional tasks before new value becomes active.
 	switch (reg) {
@@ -2025,6 +2033,7 @@ void VDP::serialize(Archive& ar, unsigned serVersion)
 
 	if constexpr (Archive::IS_LOADER) {
 		renderer->reInit();
+		registerHistory.clear();
 	}
 }
 INSTANTIATE_SERIALIZE_METHODS(VDP);
@@ -2,6 +2,7 @@
 #define VDP_HH
 
 #include "DisplayMode.hh"
+#include "VDPRegisterHistory.hh"
 #include "VideoSystemChangeListener.hh"
 #include "gl_vec.hh"
 
@@ -766,6 +767,9 @@ public:
 	// for debugging only
 	VDPCmdEngine& getCmdEngine() { return *cmdEngine; }
 
+	/** Recent changes to the control registers, for debugging only. */
+	[[nodiscard]] const VDPRegisterHistory& getRegisterHistory() const { return registerHistory; }
+
 	/** The frame that is currently being drawn, could be nullptr. */
 	[[nodiscard]] const RawFrame* getWorkingFrame(EmuTime time);
 
@@ -1189,6 +1193,10 @@ private:
 	  */
 	VDPClock frameStartTime;
 
+	/** Recent changes to the control registers (for debug tools).
+	  */
+	VDPRegisterHistory registerHistory;
+
 	/** Manages vertical scanning interrupt request.
 	  */
 	OptionalIRQHelper irqVertical;
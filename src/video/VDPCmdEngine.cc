@@ -40,7 +40,9 @@ TODO:
 #include "EmuTime.hh"
 #include "serialize.hh"
 
+#include "static_vector.hh"
 #include "unreachable.hh"
+#include "xrange.hh"
 
 #include <algorithm>
 #include <array>
@@ -164,6 +166,7 @@ struct Graphic4Mode
 	static constexpr uint8_t PIXELS_PER_BYTE = 2;
 	static constexpr uint8_t PIXELS_PER_BYTE_SHIFT = 1;
 	static constexpr unsigned PIXELS_PER_LINE = 256;
+	static constexpr bool PLANAR = false;
 	static unsigned addressOf(unsigned x, unsigned y, bool extVRAM);
 	static uint8_t point(const VDPVRAM& vram, unsigned x, unsigned y, bool extVRAM);
 	template<typename LogOp>
@@ -216,6 +219,7 @@ struct Graphic5Mode
 	static constexpr uint8_t PIXELS_PER_BYTE = 4;
 	static constexpr uint8_t PIXELS_PER_BYTE_SHIFT = 2;
 	static constexpr unsigned PIXELS_PER_LINE = 512;
+	static constexpr bool PLANAR = false;
 	static unsigned addressOf(unsigned x, unsigned y, bool extVRAM);
 	static uint8_t point(const VDPVRAM& vram, unsigned x, unsigned y, bool extVRAM);
 	template<typename LogOp>
@@ -270,6 +274,7 @@ struct Graphic6Mode
 	static constexpr uint8_t PIXELS_PER_BYTE = 2;
 	static constexpr uint8_t PIXELS_PER_BYTE_SHIFT = 1;
 	static constexpr unsigned PIXELS_PER_LINE = 512;
+	static constexpr bool PLANAR = true;
 	static unsigned addressOf(unsigned x, unsigned y, bool extVRAM);
 	static uint8_t point(const VDPVRAM& vram, unsigned x, unsigned y, bool extVRAM);
 	template<typename LogOp>
@@ -322,6 +327,7 @@ struct Graphic7Mode
 	static constexpr uint8_t PIXELS_PER_BYTE = 1;
 	static constexpr uint8_t PIXELS_PER_BYTE_SHIFT = 0;
 	static constexpr unsigned PIXELS_PER_LINE = 256;
+	static constexpr bool PLANAR = true;
 	static unsigned addressOf(unsigned x, unsigned y, bool extVRAM);
 	static uint8_t point(const VDPVRAM& vram, unsigned x, unsigned y, bool extVRAM);
 	template<typename LogOp>
@@ -372,6 +378,7 @@ struct NonBitmapMode
 	static constexpr uint8_t PIXELS_PER_BYTE = 1;
 	static constexpr uint8_t PIXELS_PER_BYTE_SHIFT = 0;
 	static constexpr unsigned PIXELS_PER_LINE = 256;
+	static constexpr bool PLANAR = false;
 	static unsigned addressOf(unsigned x, unsigned y, bool extVRAM);
 	static uint8_t point(const VDPVRAM& vram, unsigned x, unsigned y, bool extVRAM);
 	template<typename LogOp>
@@ -719,6 +726,108 @@ using TOrOp  = TransparentOp<OrOp>;
 using TXorOp = TransparentOp<XorOp>;
 using TNotOp = TransparentOp<NotOp>;
 
+/** A range of consecutive VRAM addresses. */
+struct AddressRun
+{
+	unsigned addr;
+	unsigned num;
+};
+
+/** Splits the 'num' bytes on line 'y' (no extended VRAM), starting at
+  * x-coordinate 'x' and stepping 'tx' pixels per byte, in ranges of
+  * consecutive VRAM addresses. That's a single range, except in the planar
+  * modes, where even and odd bytes live in different 64kB planes. Then there
+  * is one range per plane that is touched, ordered on plane.
+  */
+template<typename Mode>
+static static_vector<AddressRun, 2> getAddressRuns(
+	unsigned x, unsigned y, int tx, unsigned num)
+{
+	assert(num != 0);
+	unsigned xLast = x + (num - 1) * tx;
+	unsigned xMin = std::min(x, xLast);
+	unsigned xMax = std::max(x, xLast);
+	static_vector<AddressRun, 2> result;
+	if constexpr (Mode::PLANAR) {
+		int b0 = int(xMin >> Mode::PIXELS_PER_BYTE_SHIFT);
+		int b1 = int(xMax >> Mode::PIXELS_PER_BYTE_SHIFT);
+		for (int plane : {0, 1}) {
+			int first = b0 + ((b0 ^ plane) & 1);
+			int last  = b1 - ((b1 ^ plane) & 1);
+			if (first > last) continue;
+			result.push_back({
+				Mode::addressOf(unsigned(first) << Mode::PIXELS_PER_BYTE_SHIFT, y, false),
+				unsigned((last - first) / 2 + 1)});
+		}
+	} else {
+		unsigned addr = Mode::addressOf(xMin, y, false);
+		assert(Mode::addressOf(xMax, y, false) == addr + num - 1);
+		result.push_back({addr, num});
+	}
+	return result;
+}
+
+/** Executes a run of HMMV byte writes on one line in one go, instead of
+  * byte per byte. Only possible when no observer needs to be notified about
+  * these writes (see VDPVRAM::canCmdWriteBlock()).
+  * @return Were the bytes written?
+  */
+template<typename Mode>
+static bool fillBlock(VDPVRAM& vram, unsigned x, unsigned y, int tx,
+                      unsigned num, uint8_t value, EmuTime time)
+{
+	auto runs = getAddressRuns<Mode>(x, y, tx, num);
+	if (!std::ranges::all_of(runs, [&](const AddressRun& r) {
+		return vram.canCmdWriteBlock(r.addr, r.num); })) {
+		return false;
+	}
+	for (const auto& r : runs) {
+		vram.cmdFillBlock(r.addr, r.num, value, time);
+	}
+	return true;
+}
+
+/** Executes a run of HMMM/YMMM byte moves on one line in one go, instead of
+  * byte per byte. Next to the conditions of fillBlock(), this also requires
+  * that the result is the same as that of a memmove().
+  * @return Were the bytes copied?
+  */
+template<typename Mode>
+static bool copyBlock(VDPVRAM& vram, unsigned sx, unsigned sy,
+                      unsigned dx, unsigned dy, int tx,
+                      unsigned num, EmuTime time)
+{
+	if constexpr (Mode::PLANAR) {
+		// even bytes must stay even bytes
+		if (((sx ^ dx) >> Mode::PIXELS_PER_BYTE_SHIFT) & 1) return false;
+	}
+	auto srcRuns = getAddressRuns<Mode>(sx, sy, tx, num);
+	auto dstRuns = getAddressRuns<Mode>(dx, dy, tx, num);
+	assert(srcRuns.size() == dstRuns.size());
+	for (auto i : xrange(srcRuns.size())) {
+		const auto& src = srcRuns[i];
+		const auto& dst = dstRuns[i];
+		assert(src.num == dst.num);
+		if (!vram.canCmdReadBlock(src.addr, src.num) ||
+		    !vram.canCmdWriteBlock(dst.addr, dst.num)) {
+			return false;
+		}
+		// The VDP moves byte per byte in the direction of 'tx'. When the
+		// destination is ahead of an overlapping source, bytes that were
+		// already written get read again, a memmove() can't do that.
+		bool overlap = (dst.addr < src.addr + src.num) &&
+		               (src.addr < dst.addr + dst.num);
+		if (overlap && ((tx > 0) ? (dst.addr > src.addr)
+		                         : (dst.addr < src.addr))) {
+			return false;
+		}
+	}
+	for (auto i : xrange(srcRuns.size())) {
+		vram.cmdCopyBlock(dstRuns[i].addr, srcRuns[i].addr, srcRuns[i].num, time);
+	}
+	return true;
+}
+
 
 // Commands
 
@@ -1378,9 +1487,29 @@ void VDPCmdEngine::executeHmmv(EmuTime limit)
 		ADX, ANX << Mode::PIXELS_PER_BYTE_SHIFT, ARG);
 	bool dstExt = (ARG & MXD) != 0;
 	bool doPset = !dstExt || hasExtendedVRAM;
+	bool tryBlock = !dstExt;
 	auto calculator = getSlotCalculator(limit);
 
 	while (!calculator.limitReached()) {
+		if (tryBlock && (ANX > 1)) {
+			// Write all bytes of this line that complete before
+			// 'limit' in one go. The last byte of the line is left
+			// for the code below, it also moves to the next line.
+			tryBlock = false;
+			auto next = calculator;
+			unsigned num = 0;
+			do {
+				++num;
+				next.next(Delta::D48);
+			} while ((num < ANX - 1) && !next.limitReached());
+			if (fillBlock<Mode>(vram, ADX, DY, TX, num, COL,
+			                    calculator.getTime())) {
+				ADX += num * TX;
+				ANX -= num;
+				calculator = next;
+				continue;
+			}
+		}
 		if (doPset) [[likely]] {
 			vram.cmdWrite(Mode::addressOf(ADX, DY, dstExt),
 			              COL, calculator.getTime());
@@ -1391,6 +1520,7 @@ void VDPCmdEngine::executeHmmv(EmuTime limit)
 			delta = Delta::D104; // 48 + 56;
 			DY += TY; --NY;
 			ADX = DX; ANX = tmpNX;
+			tryBlock = !dstExt;
 			if (--tmpNY == 0) {
 				commandDone(calculator.getTime());
 				break;
@@ -1486,11 +1616,38 @@ void VDPCmdEngine::executeHmmm(EmuTime limit)
 	bool dstExt  = (ARG & MXD) != 0;
 	bool doPoint = !srcExt || hasExtendedVRAM;
 	bool doPset  = !dstExt || hasExtendedVRAM;
+	bool tryBlock = !srcExt && !dstExt;
 	auto calculator = getSlotCalculator(limit);
 
 	switch (phase) {
 	case 0:
 loop:		if (calculator.limitReached()) [[unlikely]] { phase = 0; break; }
+		if (tryBlock && (ANX > 1)) {
+			// Move all bytes of this line whose write completes
+			// before 'limit' in one go, except for the last byte
+			// of the line (see executeHmmv()).
+			tryBlock = false;
+			auto read = calculator; // read slot of byte 'num'
+			auto write = read;      // write slot of byte 'num'
+			write.next(Delta::D24);
+			EmuTime time = write.getTime();
+			unsigned num = 0;
+			while (!write.limitReached()) {
+				++num;
+				read = write;
+				read.next(Delta::D64);
+				if ((num == ANX - 1) || read.limitReached()) break;
+				write = read;
+				write.next(Delta::D24);
+			}
+			if ((num != 0) &&
+			    copyBlock<Mode>(vram, ASX, SY, ADX, DY, TX, num, time)) {
+				ASX += num * TX; ADX += num * TX;
+				ANX -= num;
+				calculator = read;
+				goto loop;
+			}
+		}
 		if (doPoint) [[likely]] {
 			tmpSrc = vram.cmdReadWindow.readNP(Mode::addressOf(ASX, SY, srcExt));
 		} else {
@@ -1510,6 +1667,7 @@ loop:		if (calculator.limitReached()) [[unlikely]] { phase = 0; break; }
 			delta = Delta::D128; // 64 + 64
 			SY += TY; DY += TY; --NY;
 			ASX = SX; ADX = DX; ANX = tmpNX;
+			tryBlock = !srcExt && !dstExt;
 			if (--tmpNY == 0) {
 				commandDone(calculator.getTime());
 				break;
@@ -1624,11 +1782,36 @@ void VDPCmdEngine::executeYmmm(EmuTime limit)
 	//  OTOH YMMM also uses DX for both read and write
 	bool dstExt = (ARG & MXD) != 0;
 	bool doPset  = !dstExt || hasExtendedVRAM;
+	bool tryBlock = !dstExt;
 	auto calculator = getSlotCalculator(limit);
 
 	switch (phase) {
 	case 0:
 loop:		if (calculator.limitReached()) [[unlikely]] { phase = 0; break; }
+		if (tryBlock && (ANX > 1)) {
+			// Same as in executeHmmm()
+			tryBlock = false;
+			auto read = calculator;
+			auto write = read;
+			write.next(Delta::D24);
+			EmuTime time = write.getTime();
+			unsigned num = 0;
+			while (!write.limitReached()) {
+				++num;
+				read = write;
+				read.next(Delta::D40);
+				if ((num == ANX - 1) || read.limitReached()) break;
+				write = read;
+				write.next(Delta::D24);
+			}
+			if ((num != 0) &&
+			    copyBlock<Mode>(vram, ADX, SY, ADX, DY, TX, num, time)) {
+				ADX += num * TX;
+				ANX -= num;
+				calculator = read;
+				goto loop;
+			}
+		}
 		if (doPset) [[likely]] {
 			tmpSrc = vram.cmdReadWindow.readNP(
 			       Mode::addressOf(ADX, SY, dstExt));
@@ -1646,6 +1829,7 @@ loop:		if (calculator.limitReached()) [[unlikely]] { phase = 0; break; }
 			// note: going to the next line does not take extra time
 			SY += TY; DY += TY; --NY;
 			ADX = DX; ANX = tmpNX;
+			tryBlock = !dstExt;
 			if (--tmpNY == 0) {
 				commandDone(calculator.getTime());
 				break;
@@ -0,0 +1,43 @@
+#include "VDPRegisterHistory.hh"
+
+#include <algorithm>
+
+namespace openmsx {
+
+void VDPRegisterHistory::record(EmuTime time, uint8_t reg, uint8_t oldValue, uint8_t newValue)
+{
+	while (!changes.empty() && changes.back().time > time) {
+		changes.pop_back();
+	}
+	if (changes.full()) {
+		changes.pop_front();
+		dropped = true;
+	}
+	changes.push_back(Change{.time = time, .reg = reg, .oldValue = oldValue, .newValue = newValue});
+}
+
+std::optional<uint8_t> VDPRegisterHistory::getValueAt(
+	EmuTime time, uint8_t reg, uint8_t currentValue) const
+{
+	// Undo the changes after 'time', newest first.
+	auto value = currentValue;
+	auto first = std::ranges::upper_bound(changes, time, {}, &Change::time);
+	for (auto it = changes.end(); it != first; ) {
+		--it;
+		if (it->reg == reg) value = it->oldValue;
+	}
+	if (dropped && (first == changes.begin())) return {};
+	return value;
+}
+
+bool VDPRegisterHistory::getValuesAt(EmuTime time, std::span<uint8_t, 32> regs) const
+{
+	auto first = std::ranges::upper_bound(changes, time, {}, &Change::time);
+	for (auto it = changes.end(); it != first; ) {
+		--it;
+		regs[it->reg] = it->oldValue;
+	}
+	return !dropped || (first != changes.begin());
+}
+
+} // namespace openmsx
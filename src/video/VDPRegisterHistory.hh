@@ -0,0 +1,71 @@
+#ifndef VDPREGISTERHISTORY_HH
+#define VDPREGISTERHISTORY_HH
+
+#include "EmuTime.hh"
+
+#include "circular_buffer.hh"
+#include "subrange_between.hh"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace openmsx {
+
+/** Recent history of changes to the VDP control registers (R#0-R#31).
+  *
+  * Debug tools (like the raster viewer) want to know in which line a
+  * register changed, or what the value of a register was at some earlier
+  * position in the frame. Instead of sampling the VDP state (every line),
+  * the VDP records each actual change (old and new value) in a fixed-size
+  * ring buffer. The oldest changes are dropped when the buffer is full.
+  */
+class VDPRegisterHistory
+{
+public:
+	struct Change {
+		EmuTime time;
+		uint8_t reg;
+		uint8_t oldValue;
+		uint8_t newValue;
+	};
+
+	static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+	explicit VDPRegisterHistory(size_t capacity = DEFAULT_CAPACITY)
+		: changes(capacity) {}
+
+	/** Record a change (the caller already checked 'oldValue != newValue').
+	  * Changes recorded at or after 'time' are dropped first, this happens
+	  * when emulation went back in time (reverse, loading a state). */
+	void record(EmuTime time, uint8_t reg, uint8_t oldValue, uint8_t newValue);
+
+	void clear() { changes.clear(); dropped = false; }
+
+	/** All changes in the interval [from, to), oldest first. */
+	[[nodiscard]] auto getChanges(EmuTime from, EmuTime to) const {
+		return subrange_between(changes, from, to, {}, &Change::time);
+	}
+
+	/** Reconstruct the value of a register at the given time, given its
+	  * current value. Returns std::nullopt if the history doesn't go back
+	  * far enough to know that (changes were dropped). */
+	[[nodiscard]] std::optional<uint8_t> getValueAt(
+		EmuTime time, uint8_t reg, uint8_t currentValue) const;
+
+	/** Like getValueAt(), but for all registers at once. 'regs' contains
+	  * the current values, and is updated in place. Returns false if the
+	  * history doesn't go back far enough. */
+	bool getValuesAt(EmuTime time, std::span<uint8_t, 32> regs) const;
+
+	[[nodiscard]] size_t size() const { return changes.size(); }
+	[[nodiscard]] bool empty() const { return changes.empty(); }
+
+private:
+	circular_buffer<Change> changes;
+	bool dropped = false; // did we ever drop changes because the buffer was full
+};
+
+} // namespace openmsx
+
+#endif
@@ -0,0 +1,172 @@
+#include "VDPScreenShot.hh"
+
+#include "BitmapConverter.hh"
+#include "CharacterConverter.hh"
+#include "Renderer.hh"
+#include "SpriteChecker.hh"
+#include "SpriteConverter.hh"
+#include "VDP.hh"
+#include "VDPVRAM.hh"
+
+#include "MemBuffer.hh"
+#include "PixelOperations.hh"
+#include "xrange.hh"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace openmsx::VDPScreenShot {
+
+using Pixel = uint32_t;
+
+// Plain palettes, without the gamma/contrast/color-matrix transformations
+// of the real renderers (those depend on the render settings).
+struct Palettes {
+	std::array<Pixel, 16 * 2> fg; // 2nd half only used in Graphic5
+	std::array<Pixel, 16> bg;
+	std::array<Pixel, 16> graphic7Sprites;
+	std::array<Pixel, 256> graphic7;
+	MemBuffer<Pixel> yjk{32768};
+};
+
+[[nodiscard]] static Pixel grbToPixel(uint16_t grb)
+{
+	auto c = [](unsigned v) { return (v * 255) / 7; };
+	PixelOperations pixelOps;
+	return pixelOps.combine(c((grb >> 4) & 7), c((grb >> 8) & 7), c(grb & 7));
+}
+
+static void calcPalettes(VDP& vdp, Palettes& pal)
+{
+	PixelOperations pixelOps;
+	if (vdp.isMSX1VDP()) {
+		auto msx1 = vdp.getMSX1Palette();
+		for (auto i : xrange(16)) {
+			pal.bg[i] = pixelOps.combine(msx1[i][0], msx1[i][1], msx1[i][2]);
+		}
+	} else {
+		for (auto i : xrange(16)) {
+			pal.bg[i] = grbToPixel(vdp.getPalette(i));
+			pal.graphic7Sprites[i] = grbToPixel(Renderer::GRAPHIC7_SPRITE_PALETTE[i]);
+		}
+		for (auto i : xrange(256)) {
+			// same bit shuffling as in the real renderers
+			auto r = (i & 0x1C) >> 2;
+			auto g = (i & 0xE0) >> 5;
+			auto b = (i & 0x03) == 3 ? 7 : (i & 0x03) * 2;
+			pal.graphic7[i] = grbToPixel(uint16_t((g << 8) | (r << 4) | b));
+		}
+		if (vdp.hasYJK()) {
+			auto c = [](unsigned v) { return (v * 255) / 31; };
+			for (auto rgb : xrange(32768u)) {
+				pal.yjk[rgb] = pixelOps.combine(
+					c((rgb >> 10) & 31), c((rgb >> 5) & 31), c(rgb & 31));
+			}
+		}
+	}
+	for (auto i : xrange(16)) {
+		pal.fg[i] = pal.fg[i + 16] = pal.bg[i];
+	}
+
+	// Color 0 is either transparent (shows the background color) or black.
+	// Graphic7 doesn't use transparency.
+	auto mode = vdp.getDisplayMode();
+	bool g7 = mode.getByte() == DisplayMode::GRAPHIC7;
+	int bgColor = vdp.getBackgroundColor() & 0x0F;
+	int tpIndex = (vdp.getTransparency() && !g7) ? bgColor : 0;
+	if (mode.getBase() == DisplayMode::GRAPHIC5) {
+		pal.fg[ 0] = pal.bg[tpIndex >> 2];
+		pal.fg[16] = pal.bg[tpIndex &  3];
+	} else {
+		pal.fg[0] = pal.bg[tpIndex];
+	}
+}
+
+static void drawSprites(VDP& vdp, int absLine, std::span<Pixel> buf,
+                        SpriteConverter& converter)
+{
+	auto mode = vdp.getDisplayMode();
+	if (mode.getSpriteMode(vdp.isMSX1VDP()) == 1) {
+		converter.drawMode1(absLine, 0, 256, buf);
+	} else if (mode.getByte() == DisplayMode::GRAPHIC5) {
+		converter.drawMode2<DisplayMode::GRAPHIC5>(absLine, 0, 256, buf);
+	} else if (mode.getByte() == DisplayMode::GRAPHIC6) {
+		converter.drawMode2<DisplayMode::GRAPHIC6>(absLine, 0, 256, buf);
+	} else {
+		converter.drawMode2<DisplayMode::GRAPHIC4>(absLine, 0, 256, buf);
+	}
+}
+
+ScreenShotWriter::Image grab(VDP& vdp, EmuTime time)
+{
+	auto& vram = vdp.getVRAM();
+	auto& spriteChecker = vdp.getSpriteChecker();
+	vram.sync(time);
+	spriteChecker.sync(time);
+
+	Palettes pal;
+	calcPalettes(vdp, pal);
+
+	auto mode = vdp.getDisplayMode();
+	auto width = mode.getLineWidth();
+	auto numLines = vdp.getNumberOfLines();
+	bool drawSpr = vdp.spritesEnabled() &&
+	               (mode.getSpriteMode(vdp.isMSX1VDP()) != 0);
+
+	CharacterConverter characterConverter(vdp, subspan<16>(pal.fg), pal.bg);
+	BitmapConverter bitmapConverter(pal.fg, pal.graphic7, subspan<32768>(pal.yjk));
+	SpriteConverter spriteConverter(spriteChecker,
+		(mode.getByte() == DisplayMode::GRAPHIC7) ? pal.graphic7Sprites : pal.bg);
+	characterConverter.setDisplayMode(mode);
+	bitmapConverter.setDisplayMode(mode);
+	spriteConverter.setDisplayMode(mode);
+	spriteConverter.setTransparency(vdp.getTransparency());
+
+	Pixel border = (mode.getByte() == DisplayMode::GRAPHIC7)
+	             ? pal.graphic7[vdp.getBackgroundColor()]
+	             : pal.fg[0];
+
+	MemBuffer<Pixel> image(size_t(width) * numLines);
+	for (auto y : xrange(numLines)) {
+		auto line = subspan(image, size_t(y) * width, width);
+		if (!vdp.isDisplayEnabled()) {
+			std::ranges::fill(line, border);
+			continue;
+		}
+		if (mode.isBitmapMode()) {
+			unsigned displayY = (y + vdp.getVerticalScroll()) & 255;
+			unsigned pageMask = (mode.isPlanar() ? 0x000 : 0x200) |
+			                    vdp.getEvenOddMask(y);
+			unsigned vramLine = (vram.nameTable.getMask() >> 7) & (pageMask | displayY);
+			if (mode.isPlanar()) {
+				auto [vramPtr0, vramPtr1] =
+					vram.bitmapCacheWindow.getReadAreaPlanar<256>(vramLine * 256);
+				bitmapConverter.convertLinePlanar(line, vramPtr0, vramPtr1);
+			} else {
+				auto vramPtr =
+					vram.bitmapCacheWindow.getReadArea<128>(vramLine * 128);
+				bitmapConverter.convertLine(line, vramPtr);
+			}
+		} else {
+			int displayY = mode.isTextMode() ? y : ((y + vdp.getVerticalScroll()) & 255);
+			characterConverter.convertLine(line, displayY);
+		}
+		if (drawSpr) {
+			drawSprites(vdp, vdp.getLineZero() + y, line, spriteConverter);
+		}
+	}
+
+	// Double the lines in the 512-pixel wide modes (keeps the aspect ratio).
+	auto repeat = (width == 512) ? 2 : 1;
+	std::vector<const Pixel*> rowPointers;
+	rowPointers.reserve(size_t(numLines) * repeat);
+	for (auto y : xrange(numLines)) {
+		for ([[maybe_unused]] auto r : xrange(repeat)) {
+			rowPointers.push_back(&image[size_t(y) * width]);
+		}
+	}
+	return {width, rowPointers};
+}
+
+} // namespace openmsx::VDPScreenShot
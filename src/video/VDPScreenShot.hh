@@ -0,0 +1,32 @@
+#ifndef VDPSCREENSHOT_HH
+#define VDPSCREENSHOT_HH
+
+#include "EmuTime.hh"
+#include "ScreenShotWriter.hh"
+
+namespace openmsx {
+
+class VDP;
+
+/** Screenshots for when there's no renderer at all ('-renderer none').
+  *
+  * The dummy renderer doesn't produce any frames, it doesn't even allocate
+  * a frame buffer. So instead of grabbing the last rendered frame, this
+  * rasterizes the current VDP state (VRAM, registers, palette, sprites)
+  * once, on demand. It uses the same converters as the real renderers, but
+  * it doesn't emulate raster effects: the whole display area is drawn with
+  * the current settings. Only the display area is included (no border).
+  * The result is 256 pixels wide, or 512 pixels wide with all lines
+  * doubled for the 512-pixel wide display modes.
+  */
+namespace VDPScreenShot {
+
+	/** Rasterize the current VDP state.
+	  */
+	[[nodiscard]] ScreenShotWriter::Image grab(VDP& vdp, EmuTime time);
+
+} // namespace VDPScreenShot
+
+} // namespace openmsx
+
+#endif
@@ -6,6 +6,7 @@
 #include "outer.hh"
 #include "ranges.hh"
 #include "serialize.hh"
+#include "xrange.hh"
 
 #include <algorithm>
 #include <array>
@@ -90,6 +91,13 @@ void VDPVRAM::PhysicalVRAMDebuggable::write(
 	vram.cpuWrite(address, value, time);
 }
 
+void VDPVRAM::PhysicalVRAMDebuggable::writeBlock(
+	unsigned start, std::span<const uint8_t> input, EmuTime time)
+{
+	auto& vram = OUTER(VDPVRAM, physicalVRAMDebug);
+	vram.cpuWriteBlock(start, input, time);
+}
+
 
 // class VDPVRAM
 
@@ -106,6 +114,7 @@ static constexpr unsigned bufferSize(unsigned size)
 VDPVRAM::VDPVRAM(VDP& vdp_, unsigned size, EmuTime time)
 	: vdp(vdp_)
 	, data(*vdp_.getDeviceConfig2().getXML(), bufferSize(size))
+	, dirty(data.size())
 	, logicalVRAMDebug (vdp)
 	, physicalVRAMDebug(vdp, size)
 	, actualSize(size)
@@ -139,6 +148,73 @@ void VDPVRAM::clear()
 		// give the same value.
 		std::ranges::fill(subspan(data, actualSize), 0xFF);
 	}
+	dirty.markAllDirty();
+}
+
+void VDPVRAM::cpuWriteBlock(unsigned address, std::span<const uint8_t> values, EmuTime time)
+{
+	#ifdef DEBUG
+	// Rewriting history is not allowed.
+	assert(time >= vramTime);
+	#endif
+	assert(vdp.isInsideFrame(time));
+
+	// Split in parts that don't wrap around because of mirroring. With a
+	// 'sizeMask' like 0x27FFF the address wraps at the end of each 32kB
+	// part, so split at the end of the low contiguous run of its bits.
+	unsigned lowMask = getLowSizeMask();
+	while (!values.empty()) {
+		unsigned addr = address & sizeMask;
+		auto num = std::min<size_t>(values.size(), lowMask + 1 - (addr & lowMask));
+		if (addr < actualSize) {
+			num = std::min<size_t>(num, actualSize - addr);
+			writeBlockCommon(addr, values.first(num), time);
+		} else {
+			// non-present ram chips, see cpuWrite()
+			assert(addr < 0x30000);
+		}
+		values = values.subspan(num);
+		address += unsigned(num);
+	}
+
+	cmdEngine->stealAccessSlot(time);
+}
+
+void VDPVRAM::writeBlockCommon(unsigned address, std::span<const uint8_t> values, EmuTime time)
+{
+	#ifdef DEBUG
+	vramTime = time;
+	#endif
+	auto num = unsigned(values.size());
+
+	// Like in cpuWrite(), sync with cmdEngine even if nothing changes.
+	if (std::ranges::any_of(xrange(address, address + num), [&](unsigned addr) {
+		return cmdReadWindow .isInside(addr) ||
+		       cmdWriteWindow.isInside(addr); })) {
+		cmdEngine->sync(time);
+	}
+
+	// Only notify about the part that actually changes.
+	std::span old{&data[address], num};
+	auto first = std::ranges::mismatch(old, values).in1 - old.begin();
+	if (first == num) return;
+	auto last = num - 1;
+	while (old[last] == values[last]) --last;
+	unsigned changedAddr = address + unsigned(first);
+	unsigned changedNum = unsigned(last - first + 1);
+
+	bitmapVisibleWindow.notifyRange(changedAddr, changedNum, time);
+	spriteAttribTable  .notifyRange(changedAddr, changedNum, time);
+	spritePatternTable .notifyRange(changedAddr, changedNum, time);
+
+	std::ranges::copy(values.subspan(first, changedNum), &data[changedAddr]);
+	dirty.markDirty(changedAddr, changedNum);
+
+	// See writeCommon() for the other windows.
+	assert(!bitmapCacheWindow.hasObserver());
+	assert(!nameTable.hasObserver());
+	assert(!colorTable.hasObserver());
+	assert(!patternTable.hasObserver());
 }
 
 void VDPVRAM::updateDisplayMode(DisplayMode mode, bool cmdBit, EmuTime time)
@@ -216,6 +292,7 @@ void VDPVRAM::updateVRMode(bool newVRmode, EmuTime time)
 			std::swap(data[i], data[swapAddr(i)]);
 		}
 	}
+	dirty.markAllDirty();
 }
 
 void VDPVRAM::setRenderer(Renderer* newRenderer, EmuTime time)
@@ -296,6 +373,7 @@ void VDPVRAM::change4k8kMapping(bool mapping8k)
 		}
 	}
 	copy_to_range(tmp, std::span{data});
+	dirty.markDirty(0, tmp.size());
 }
 
 
@@ -320,7 +398,16 @@ void VDPVRAM::serialize(Archive& ar, unsigned /*version*/)
 		setSizeMask(static_cast<MSXDevice&>(vdp).getCurrentTime());
 	}
 
-	ar.serialize_blob("data", std::span{data.data(), actualSize});
+	std::span vram{data.data(), actualSize};
+	if constexpr (Archive::IS_LOADER) {
+		ar.serialize_blob("data", vram);
+		dirty.markAllDirty();
+	} else if (ar.isReverseSnapshot()) {
+		ar.serialize_blob("data", vram, dirty, lastReverseSnapshot);
+		lastReverseSnapshot = dirty.checkpoint();
+	} else {
+		ar.serialize_blob("data", vram);
+	}
 	ar.serialize("cmdReadWindow",       cmdReadWindow,
 	             "cmdWriteWindow",      cmdWriteWindow,
 	             "nameTable",           nameTable,
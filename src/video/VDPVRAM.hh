@@ -8,10 +8,16 @@
 #include "Ram.hh"
 #include "SimpleDebuggable.hh"
 
+#include "DirtyPages.hh"
 #include "Math.hh"
+#include "xrange.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <span>
+#include <utility>
 
 namespace openmsx {
 
@@ -121,6 +127,7 @@ class DummyVRAMObserver final : public VRAMObserver
 {
 public:
 	void updateVRAM(unsigned /*offset*/, EmuTime /*time*/) override {}
+	void updateVRAMRange(unsigned /*offset*/, unsigned /*num*/, EmuTime /*time*/) override {}
 	void updateWindow(bool /*enabled*/, EmuTime /*time*/) override {}
 };
 
@@ -301,6 +308,15 @@ public:
 		observer = &dummyObserver;
 	}
 
+	/** The lowest and the highest VRAM address that can be accessed via
+	  * this window (not all addresses in between are necessarily inside
+	  * the window). For a disabled window this is an empty range.
+	  */
+	[[nodiscard]] std::pair<unsigned, unsigned> getAddressRange() const {
+		if (!isEnabled()) return {1, 0};
+		return {baseAddr, effectiveBaseMask};
+	}
+
 	/** Test whether an address is inside this window.
 	  * "Inside" is defined as: there is at least one index in this window,
 	  * which is mapped to the given address.
@@ -323,6 +339,24 @@ public:
 		}
 	}
 
+	/** Same as notify(), but for a range of addresses that all change at
+	  * the same time. The observer is notified at most once.
+	  * @param address The first address of the range.
+	  * @param num The number of addresses in the range.
+	  * @param time The moment in emulated time the change occurs.
+	  */
+	void notifyRange(unsigned address, unsigned num, EmuTime time) {
+		auto [lo, hi] = getAddressRange();
+		unsigned last = address + num - 1;
+		if ((last < lo) || (hi < address)) return;
+		for (auto addr : xrange(std::max(address, lo), std::min(last, hi) + 1)) {
+			if (isInside(addr)) {
+				observer->updateVRAMRange(addr - baseAddr, last - addr + 1, time);
+				return;
+			}
+		}
+	}
+
 	/** Inform VRAMWindow of changed sizeMask.
 	  * For the moment this only happens when switching the VR bit in VDP
 	  * register 8 (in VR=0 mode only 32kB VRAM is addressable).
@@ -483,6 +517,17 @@ public:
 		cmdEngine->stealAccessSlot(time);
 	}
 
+	/** Write a block of bytes to VRAM through the CPU interface, all at
+	  * the same moment in time. This has the same effect as calling
+	  * cpuWrite() for each byte, except that the observers get (at most)
+	  * one notification per window and that only one access slot is
+	  * taken from the command engine.
+	  * @param address The address of the first byte to write.
+	  * @param values The values to write.
+	  * @param time The moment in emulated time this write occurs.
+	  */
+	void cpuWriteBlock(unsigned address, std::span<const uint8_t> values, EmuTime time);
+
 	/** Read a byte from VRAM though the CPU interface.
 	  * @param address The address to read.
 	  * @param time The moment in emulated time this read occurs.
@@ -507,6 +552,77 @@ public:
 		return data[address];
 	}
 
+	/** Can the command engine write the block [address, address + num)
+	  * via cmdFillBlock() or cmdCopyBlock()? That's only allowed when
+	  * the block is present (not affected by the 'sizeMask' mirroring, no
+	  * missing RAM chips) and when
+	  * no window that has an observer overlaps with it. So skipping the
+	  * per-byte notifications doesn't make a difference.
+	  */
+	[[nodiscard]] bool canCmdWriteBlock(unsigned address, unsigned num) const {
+		assert(num != 0);
+		unsigned last = address + num - 1;
+		if ((last >= actualSize) || (last > getLowSizeMask())) return false;
+		auto overlaps = [&](const VRAMWindow& window) {
+			if (!window.hasObserver()) return false;
+			auto [lo, hi] = window.getAddressRange();
+			return (lo <= last) && (address <= hi);
+		};
+		return !overlaps(bitmapVisibleWindow) &&
+		       !overlaps(spriteAttribTable) &&
+		       !overlaps(spritePatternTable);
+	}
+
+	/** Is the block [address, address + num) present in VRAM, so that it
+	  * can be used as source for cmdCopyBlock()?
+	  */
+	[[nodiscard]] bool canCmdReadBlock(unsigned address, unsigned num) const {
+		assert(num != 0);
+		unsigned last = address + num - 1;
+		return (last < actualSize) && (last <= getLowSizeMask());
+	}
+
+	/** Fill a block of VRAM through the command engine. This has the same
+	  * effect as 'num' calls to cmdWrite(), but without notifying the
+	  * observers. Only allowed when canCmdWriteBlock() returned true.
+	  * @param address The first address to write.
+	  * @param num The number of bytes to write.
+	  * @param value The value to write.
+	  * @param time The moment in emulated time the first write occurs.
+	  */
+	void cmdFillBlock(unsigned address, unsigned num, uint8_t value, EmuTime time) {
+		assert(canCmdWriteBlock(address, num));
+		assert(vdp.isInsideFrame(time)); (void)time;
+		#ifdef DEBUG
+		assert(time >= vramTime);
+		vramTime = time;
+		#endif
+		std::memset(&data[address], value, num);
+		dirty.markDirty(address, num);
+	}
+
+	/** Copy a block of VRAM through the command engine. The blocks may
+	  * overlap, the result is as if the whole source block was read before
+	  * the destination block is written. Observers are not notified, so
+	  * this is only allowed when canCmdWriteBlock() returned true for the
+	  * destination and canCmdReadBlock() for the source.
+	  * @param dst The first address to write.
+	  * @param src The first address to read.
+	  * @param num The number of bytes to copy.
+	  * @param time The moment in emulated time the first write occurs.
+	  */
+	void cmdCopyBlock(unsigned dst, unsigned src, unsigned num, EmuTime time) {
+		assert(canCmdWriteBlock(dst, num));
+		assert(canCmdReadBlock(src, num));
+		assert(vdp.isInsideFrame(time)); (void)time;
+		#ifdef DEBUG
+		assert(time >= vramTime);
+		vramTime = time;
+		#endif
+		std::memmove(&data[dst], &data[src], num);
+		dirty.markDirty(dst, num);
+	}
+
 	/** Used by the VDP to signal display mode changes.
 	  * VDPVRAM will inform the Renderer, command engine and the sprite
 	  * checker of this change.
@@ -568,6 +684,10 @@ public:
 		return {data.data(), data.size()};
 	}
 
+	/** Which pages of the VRAM were written to. */
+	[[nodiscard]] const DirtyPages& getDirtyPages() const { return dirty; }
+	[[nodiscard]] DirtyPages& getDirtyPages() { return dirty; }
+
 	template<typename Archive>
 	void serialize(Archive& ar, unsigned version);
 
@@ -593,6 +713,7 @@ private:
 		spritePatternTable.notify(address, time);
 
 		data[address] = value;
+		dirty.markDirty(address);
 
 		// Cache dirty marking should happen after the commit,
 		// otherwise the cache could be re-validated based on old state.
@@ -620,6 +741,18 @@ private:
 		*/
 	}
 
+	/* The contiguous run of low 1-bits in 'sizeMask'. Addresses up to
+	 * this value are not changed by the mirroring. This is usually equal
+	 * to 'sizeMask', but e.g. not for 0x27FFF (192kB VRAM).
+	 */
+	[[nodiscard]] unsigned getLowSizeMask() const {
+		return (sizeMask ^ (sizeMask + 1)) >> 1;
+	}
+
+	/* Helper for cpuWriteBlock(), handles a block without mirroring.
+	 */
+	void writeBlockCommon(unsigned address, std::span<const uint8_t> values, EmuTime time);
+
 	void setSizeMask(EmuTime time);
 
 private:
@@ -631,6 +764,11 @@ private:
 	  */
 	Ram data;
 
+	/** Keeps track of which parts of 'data' were written to.
+	  */
+	DirtyPages dirty;
+	DirtyPages::Epoch lastReverseSnapshot = 0;
+
 	/** Debuggable with mode dependent view on the vram
 	  *   Screen7/8 are not interleaved in this mode.
 	  *   This debuggable is also at least 128kB in size (it possibly
@@ -653,6 +791,7 @@ private:
 		PhysicalVRAMDebuggable(const VDP& vdp, unsigned actualSize);
 		[[nodiscard]] uint8_t read(unsigned address, EmuTime time) override;
 		void write(unsigned address, uint8_t value, EmuTime time) override;
+		void writeBlock(unsigned start, std::span<const uint8_t> input, EmuTime time) override;
 	} physicalVRAMDebug;
 
 	// TODO: Renderer field can be removed, if updateDisplayMode
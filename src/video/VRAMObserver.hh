@@ -20,6 +20,18 @@ public:
 	  */
 	virtual void updateVRAM(unsigned offset, EmuTime time) = 0;
 
+	/** Informs the observer of a change in a range of VRAM bytes, that
+	  * all change at the same moment in time. This has the same effect as
+	  * calling updateVRAM() for each byte in the range, but it allows the
+	  * observer to do its work only once.
+	  * @param offset Offset of the first byte that will change,
+	  *               relative to window base address.
+	  * @param num Number of consecutive VRAM bytes that will change. Not
+	  *            all of them are necessarily inside the window.
+	  * @param time The moment in emulated time this change occurs.
+	  */
+	virtual void updateVRAMRange(unsigned offset, unsigned num, EmuTime time) = 0;
+
 	/** Informs the observer that the entire VRAM window will change.
 	  * This update is sent just before the change,
 	  * so the subcomponent can update itself to the given time
@@ -4,9 +4,11 @@
 #include "Layer.hh"
 
 #include "MSXEventListener.hh"
+#include "ScreenShotWriter.hh"
 #include "VideoSourceSetting.hh"
 
 #include "Observer.hh"
+#include "SoftwareScaler.hh"
 
 #include <cstdint>
 #include <optional>
@@ -39,10 +41,13 @@ public:
 	 * parameter should be either '240' or '480' if specified. If not
 	 * specified, the height will be determined based on the available
 	 * widths in the raw frame. The result will be scaled to either
-	 * '320x240' or '640x480' and written to a png file.
+	 * '320x240' or '640x480'.
+	 * Optionally the result is further scaled with the given (software)
+	 * scaler, e.g. 'hq2x' on a 320x240 image results in 640x480.
 	 */
-	virtual void takeRawScreenShot(
-		std::optional<unsigned> height, const std::string& filename) = 0;
+	[[nodiscard]] virtual ScreenShotWriter::Image takeRawScreenShot(
+		std::optional<unsigned> height,
+		std::optional<SoftwareScaler> scaler = {}) = 0;
 
 	// We used to test whether a Layer is active by looking at the
 	// Z-coordinate (Z_MSX_ACTIVE vs Z_MSX_PASSIVE). Though in case of
@@ -5,7 +5,7 @@
 namespace openmsx {
 
 void VideoSystem::takeScreenShot(
-	const std::string& /*filename*/, bool /*withOsd*/)
+	const ScreenShotWriter::Target& /*target*/, bool /*withOsd*/)
 {
 	throw MSXException(
 		"Taking screenshot not possible with current renderer.");
@@ -16,4 +16,9 @@ void VideoSystem::updateWindowTitle()
 	// ignore
 }
 
+std::optional<double> VideoSystem::getRefreshRate()
+{
+	return {};
+}
+
 } // namespace openmsx
@@ -1,6 +1,8 @@
 #ifndef VIDEOSYSTEM_HH
 #define VIDEOSYSTEM_HH
 
+#include "ScreenShotWriter.hh"
+
 #include "gl_vec.hh"
 #include "zstring_view.hh"
 
@@ -53,11 +55,11 @@ public:
 
 	/** Take a screenshot.
 	  * The default implementation throws an exception.
-	  * @param filename Name of the file to save the screenshot to.
+	  * @param target Name and format of the file to save the screenshot to.
 	  * @param withOsd Should OSD elements be included in the screenshot.
 	  * @throws MSXException If taking the screen shot fails.
 	  */
-	virtual void takeScreenShot(const std::string& filename, bool withOsd);
+	virtual void takeScreenShot(const ScreenShotWriter::Target& target, bool withOsd);
 
 	/** Called when the window title string has changed.
 	  */
@@ -78,6 +80,10 @@ public:
 	[[nodiscard]] virtual std::optional<gl::ivec2> getWindowPosition() = 0;
 	virtual void setWindowPosition(gl::ivec2 pos) = 0;
 
+	/** Refresh rate (in Hz) of the display that shows the window, or
+	  * nullopt when unknown. */
+	[[nodiscard]] virtual std::optional<double> getRefreshRate();
+
 	/** Requests a repaint of the output surface. An implementation might
 	 *  start a repaint directly, or trigger a queued rendering. */
 	virtual void repaint() = 0;
@@ -6,6 +6,7 @@
 #include "GLSnow.hh"
 #include "GLUtil.hh"
 #include "OffScreenSurface.hh"
+#include "PresentThread.hh"
 #include "RenderSettings.hh"
 #include "VideoSystem.hh"
 
@@ -21,7 +22,6 @@
 #include "InputEventGenerator.hh"
 #include "MemBuffer.hh"
 #include "OSDGUILayer.hh"
-#include "PNG.hh"
 
 #include "narrow.hh"
 #include "outer.hh"
@@ -61,6 +61,7 @@ VisibleSurface::VisibleSurface(
 	inputEventGenerator.getGrabInput().attach(*this);
 	renderSettings.getPointerHideDelaySetting().attach(*this);
 	renderSettings.getFullScreenSetting().attach(*this);
+	renderSettings.getPresentThreadSetting().attach(*this);
 	pauseSetting.attach(*this);
 
 	for (auto type : {EventType::MOUSE_MOTION,
@@ -155,6 +156,7 @@ VisibleSurface::VisibleSurface(
 	glGenVertexArrays(1, &vao);
 	glBindVertexArray(vao);
 #endif
+	updatePresentThread();
 	inputEventGenerator.initializeGrab();
 }
 
@@ -163,6 +165,9 @@ VisibleSurface::~VisibleSurface()
 	auto& renderSettings = display.getRenderSettings();
 	renderSettings.getVSyncSetting().detach(vSyncObserver);
 
+	pollScreenShots(true);
+	for (auto fence : frameFences) glDeleteSync(fence);
+	presentThread.reset();
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplSDL2_Shutdown();
 
@@ -185,6 +190,7 @@ VisibleSurface::~VisibleSurface()
 
 	inputEventGenerator.getGrabInput().detach(*this);
 	renderSettings.getPointerHideDelaySetting().detach(*this);
+	renderSettings.getPresentThreadSetting().detach(*this);
 	renderSettings.getFullScreenSetting().detach(*this);
 	pauseSetting.detach(*this);
 }
@@ -197,6 +203,16 @@ std::optional<gl::ivec2> VisibleSurface::getWindowPosition() const
 	return gl::ivec2{x, y};
 }
 
+std::optional<double> VisibleSurface::getRefreshRate() const
+{
+	int index = SDL_GetWindowDisplayIndex(window.get());
+	if (index < 0) return {};
+	SDL_DisplayMode mode;
+	if (SDL_GetCurrentDisplayMode(index, &mode) != 0) return {};
+	if (mode.refresh_rate <= 0) return {}; // unknown
+	return double(mode.refresh_rate);
+}
+
 void VisibleSurface::setWindowPosition(gl::ivec2 pos)
 {
 	if (SDL_GetWindowFlags(window.get()) & SDL_WINDOW_FULLSCREEN) return;
@@ -264,11 +280,40 @@ void VisibleSurface::createSurface(gl::ivec2 size, unsigned flags)
 	}
 }
 
-void VisibleSurface::update(const Setting& /*setting*/) noexcept
+void VisibleSurface::update(const Setting& setting) noexcept
 {
+	if (&setting == &display.getRenderSettings().getPresentThreadSetting()) {
+		updatePresentThread();
+		return;
+	}
 	updateCursor();
 }
 
+void VisibleSurface::updatePresentThread()
+{
+	auto& renderSettings = display.getRenderSettings();
+	bool enable = renderSettings.getPresentThreadSetting().getBoolean();
+	if (enable == bool(presentThread)) return;
+	if (enable) {
+		if (!PresentThread::isSupported()) {
+			cliComm.printWarning(
+				"Your OpenGL driver doesn't support showing the frames "
+				"from a separate thread (setting 'present_thread').");
+			return;
+		}
+		try {
+			presentThread = std::make_unique<PresentThread>(window.get(), glContext);
+		} catch (MSXException& e) {
+			cliComm.printWarning(e.getMessage());
+			return;
+		}
+	} else {
+		presentThread.reset();
+	}
+	// the swap interval is per context
+	vSyncObserver.update(renderSettings.getVSyncSetting());
+}
+
 void VisibleSurface::executeRT()
 {
 	// timer expired, hide cursor
@@ -354,30 +399,88 @@ std::optional<gl::ivec2> VisibleSurface::getMouseCoord() const
 }
 
 
-void VisibleSurface::saveScreenshot(const std::string& filename)
-{
-	saveScreenshotGL(*this, filename);
-}
-
-void VisibleSurface::saveScreenshotGL(
-	const OutputSurface& output, const std::string& filename)
+void VisibleSurface::takeScreenShot(
+	const OutputSurface& output, const ScreenShotWriter::Target& target)
 {
-	auto [x, y] = output.getViewOffset();
-	auto [w, h] = output.getViewSize();
+	// The window itself is only drawn by the present thread.
+	auto* fbo = (presentThread && (&output == this))
+	          ? presentThread->getLastFrame() : nullptr;
+	if (fbo) fbo->push();
+
+	auto offset = output.getViewOffset();
+	auto size = output.getViewSize();
+	if (target.async && gl::PixelReadback::isSupported()) {
+		pendingShots.emplace_back(gl::PixelReadback(offset, size), target);
+		if (fbo) fbo->pop();
+		return;
+	}
 
 	// OpenGL ES only supports reading RGBA (not RGB)
+	auto [w, h] = size;
 	MemBuffer<uint32_t> buffer(size_t(w) * size_t(h));
-	glReadPixels(x, y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, buffer.data());
+	glReadPixels(offset.x, offset.y, w, h, GL_RGBA, GL_UNSIGNED_BYTE, buffer.data());
+	if (fbo) fbo->pop();
 
 	small_buffer<const uint32_t*, 1080> rowPointers(std::views::transform(xrange(size_t(h)),
 		[&](auto i) { return &buffer[size_t(w) * (h - 1 - i)]; }));
+	display.getScreenShotWriter().save(
+		ScreenShotWriter::Image(w, rowPointers), target);
+}
+
+void VisibleSurface::pollScreenShots(bool wait)
+{
+	// Hand over in order of request, so stop at the first one that's not
+	// finished yet.
+	auto& writer = display.getScreenShotWriter();
+	auto it = pendingShots.begin();
+	for (/**/; it != pendingShots.end(); ++it) {
+		if (!wait && !it->readback.isReady()) break;
+		auto [w, h] = it->readback.getSize();
+		ScreenShotWriter::Image image(w, h);
+		it->readback.read(image.pixels);
+		writer.save(std::move(image), it->target); // async, doesn't throw
+	}
+	pendingShots.erase(pendingShots.begin(), it);
+}
 
-	PNG::saveRGBA(w, rowPointers, filename);
+void VisibleSurface::beginFrame()
+{
+	if (presentThread) presentThread->beginFrame(getPhysicalSize());
 }
 
 void VisibleSurface::finish()
 {
-	SDL_GL_SwapWindow(window.get());
+	if (!pendingShots.empty()) pollScreenShots(false);
+	if (presentThread) {
+		presentThread->present();
+	} else {
+		SDL_GL_SwapWindow(window.get());
+		limitFramesInFlight();
+	}
+}
+
+void VisibleSurface::limitFramesInFlight()
+{
+	// Without a limit, the driver may queue up several frames (typically
+	// up to 3) before SDL_GL_SwapWindow() blocks, each adds a frame of
+	// latency. Instead wait (on the CPU) till the GPU has finished all but
+	// the last 'limit - 1' frames.
+	auto limit = size_t(display.getRenderSettings().getMaxFramesInFlightSetting().getInt());
+	if ((limit == 0) || !(GLEW_VERSION_3_2 || GLEW_ARB_sync)) {
+		for (auto fence : frameFences) glDeleteSync(fence);
+		frameFences.clear();
+		return;
+	}
+	frameFences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	while (frameFences.size() >= limit) {
+		auto fence = frameFences.front();
+		frameFences.pop_front();
+		while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000) ==
+		       GL_TIMEOUT_EXPIRED) {
+			// keep waiting
+		}
+		glDeleteSync(fence);
+	}
 }
 
 std::unique_ptr<Layer> VisibleSurface::createSnowLayer()
@@ -410,6 +513,10 @@ void VisibleSurface::VSyncObserver::update(const Setting& setting) noexcept
 	// vsync is enabled, we attempt adaptive vsync.
 	int interval = syncSetting.getBoolean() ? -1 : 0;
 
+	if (visSurface.presentThread) {
+		visSurface.presentThread->setSwapInterval(interval);
+		return;
+	}
 	if ((SDL_GL_SetSwapInterval(interval) < 0) && (interval == -1)) {
 		// "Adaptive vsync" is not supported by all drivers. SDL
 		// documentation suggests to fallback to "regular vsync" in
@@ -2,13 +2,17 @@
 #define VISIBLESURFACE_HH
 
 #include "EventListener.hh"
+#include "GLUtil.hh"
 #include "Observer.hh"
 #include "OutputSurface.hh"
 #include "RTSchedulable.hh"
 #include "SDLSurfacePtr.hh"
+#include "ScreenShotWriter.hh"
 
+#include <deque>
 #include <memory>
 #include <optional>
+#include <vector>
 
 namespace openmsx {
 
@@ -20,6 +24,7 @@ class ImGuiManager;
 class InputEventGenerator;
 class Layer;
 class OSDGUI;
+class PresentThread;
 class Reactor;
 class Setting;
 class VideoSystem;
@@ -44,14 +49,23 @@ public:
 	[[nodiscard]] CliComm& getCliComm() const { return cliComm; }
 	[[nodiscard]] Display& getDisplay() const { return display; }
 
-	static void saveScreenshotGL(const OutputSurface& output,
-	                             const std::string& filename);
+	/** Take a screenshot of the given surface: either this surface or an
+	  * OffScreenSurface that's currently installed. When 'target.async'
+	  * is set (and supported) the pixels are read back asynchronously,
+	  * they're only written to file during one of the next finish() calls.
+	  * @throws MSXException when a direct write fails.
+	  */
+	void takeScreenShot(const OutputSurface& output,
+	                    const ScreenShotWriter::Target& target);
 
 	[[nodiscard]] std::optional<gl::ivec2> getMouseCoord() const;
 	void updateWindowTitle();
 	bool setFullScreen(bool fullscreen);
 	void resize();
 
+	/** Call this before painting a new frame. */
+	void beginFrame();
+
 	/** When a complete frame is finished, call this method.
 	  * It will 'actually' display it. E.g. when using double buffering
 	  * it will swap the front and back buffer.
@@ -75,8 +89,8 @@ public:
 	[[nodiscard]] std::optional<gl::ivec2> getWindowPosition() const;
 	void setWindowPosition(gl::ivec2 pos);
 
-	// OutputSurface
-	void saveScreenshot(const std::string& filename) override;
+	/** Refresh rate of the display that shows (the center of) the window. */
+	[[nodiscard]] std::optional<double> getRefreshRate() const;
 
 	// Observer
 	void update(const Setting& setting) noexcept override;
@@ -91,6 +105,9 @@ private:
 	void updateCursor();
 	void createSurface(gl::ivec2 size, unsigned flags);
 	void setViewPort(gl::ivec2 logicalSize, bool fullScreen);
+	void updatePresentThread();
+	void limitFramesInFlight();
+	void pollScreenShots(bool wait);
 
 private:
 	Display& display;
@@ -107,6 +124,17 @@ private:
 	[[no_unique_address]] SDLSubSystemInitializer<SDL_INIT_VIDEO> videoSubSystem;
 	SDLWindowPtr window;
 	SDL_GLContext glContext;
+	std::unique_ptr<PresentThread> presentThread;
+
+	struct PendingShot {
+		gl::PixelReadback readback;
+		ScreenShotWriter::Target target;
+	};
+	std::vector<PendingShot> pendingShots; // in order of request
+
+	// One fence per presented frame that the GPU may not have finished yet,
+	// oldest first, see 'max_frames_in_flight'.
+	std::deque<GLsync> frameFences;
 
 	bool grab = false;
 	bool guiActive = false;
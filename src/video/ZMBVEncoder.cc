@@ -8,6 +8,7 @@
 #include "cstd.hh"
 #include "endian.hh"
 #include "narrow.hh"
+#include "ranges.hh"
 #include "unreachable.hh"
 
 #include <algorithm>
@@ -19,6 +20,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <tuple>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace openmsx {
 
@@ -105,24 +109,32 @@ struct KeyframeHeader {
 };
 
 
-static inline void writePixel(
-	unsigned pixel, Endian::L32& dest)
+using LE_P = Endian::Little<ZMBVEncoder::Pixel>::type;
+
+// Convert a line of pixels to the format that's stored in the video stream.
+// This is done once when a frame is copied into 'newFrame', so all further
+// processing (block matching, xor-deltas) works directly on the final data.
+static void convertLine(std::span<const ZMBVEncoder::Pixel> in, LE_P* out)
 {
 	PixelOperations pixelOps;
-	unsigned r = pixelOps.red(pixel);
-	unsigned g = pixelOps.green(pixel);
-	unsigned b = pixelOps.blue(pixel);
-	dest = (r << 16) | (g <<  8) |  b;
+	for (auto x : xrange(in.size())) {
+		auto pixel = in[x];
+		unsigned r = pixelOps.red(pixel);
+		unsigned g = pixelOps.green(pixel);
+		unsigned b = pixelOps.blue(pixel);
+		out[x] = (r << 16) | (g <<  8) |  b;
+	}
 }
 
 
-ZMBVEncoder::ZMBVEncoder(unsigned width_, unsigned height_)
+ZMBVEncoder::ZMBVEncoder(unsigned width_, unsigned height_, bool fast_)
 	: width(width_)
 	, height(height_)
+	, fast(fast_)
 {
 	setupBuffers();
 	memset(&zstream, 0, sizeof(zstream));
-	deflateInit(&zstream, 6); // compression level
+	deflateInit(&zstream, fast ? Z_BEST_SPEED : 6); // compression level
 
 	// I did a small test: compression level vs compression speed
 	//  (recorded Space Manbow intro, video only)
@@ -141,6 +153,10 @@ ZMBVEncoder::ZMBVEncoder(unsigned width_, unsigned height_)
 	//   9   | 2m04.1 |   3253706
 	//
 	// Level 6 seems a good compromise between size/speed for THIS test.
+	//
+	// Since then the motion vector search got a lot faster, and now zlib
+	// takes most of the time: level 1 encodes about twice as fast as level
+	// 6, for ~50% bigger files. That's what 'fast' mode uses.
 }
 
 void ZMBVEncoder::setupBuffers()
@@ -181,13 +197,17 @@ unsigned ZMBVEncoder::neededSize() const
 
 unsigned ZMBVEncoder::possibleBlock(int vx, int vy, size_t offset)
 {
-	int ret = 0;
+	// Only used to test for '< 4', so stop counting once that's no longer
+	// possible. This function is called for many candidate vectors per
+	// block, and most of them are rejected after the first row(s).
+	unsigned ret = 0;
 	const auto* pOld = &(std::bit_cast<const Pixel*>(oldFrame.data()))[offset + (vy * pitch) + vx];
 	const auto* pNew = &(std::bit_cast<const Pixel*>(newFrame.data()))[offset];
 	for (unsigned y = 0; y < BLOCK_HEIGHT; y += 4) {
 		for (unsigned x = 0; x < BLOCK_WIDTH; x += 4) {
 			if (pOld[x] != pNew[x]) ++ret;
 		}
+		if (ret >= 4) break;
 		pOld += pitch * 4;
 		pNew += pitch * 4;
 	}
@@ -196,9 +216,24 @@ unsigned ZMBVEncoder::possibleBlock(int vx, int vy, size_t offset)
 
 unsigned ZMBVEncoder::compareBlock(int vx, int vy, size_t offset)
 {
-	int ret = 0;
 	const auto* pOld = &(std::bit_cast<const Pixel*>(oldFrame.data()))[offset + (vy * pitch) + vx];
 	const auto* pNew = &(std::bit_cast<const Pixel*>(newFrame.data()))[offset];
+#ifdef __SSE2__
+	// 4 pixels at a time, count the equal ones
+	int equal = 0;
+	repeat(BLOCK_HEIGHT, [&] {
+		const auto* o = std::bit_cast<const __m128i*>(pOld);
+		const auto* n = std::bit_cast<const __m128i*>(pNew);
+		for (auto x : xrange(BLOCK_WIDTH / 4)) {
+			auto eq = _mm_cmpeq_epi32(_mm_loadu_si128(o + x), _mm_loadu_si128(n + x));
+			equal += std::popcount(unsigned(_mm_movemask_ps(_mm_castsi128_ps(eq))));
+		}
+		pOld += pitch;
+		pNew += pitch;
+	});
+	return BLOCK_WIDTH * BLOCK_HEIGHT - equal;
+#else
+	int ret = 0;
 	repeat(BLOCK_HEIGHT, [&] {
 		for (auto x : xrange(BLOCK_WIDTH)) {
 			if (pOld[x] != pNew[x]) ++ret;
@@ -207,23 +242,34 @@ unsigned ZMBVEncoder::compareBlock(int vx, int vy, size_t offset)
 		pNew += pitch;
 	});
 	return ret;
+#endif
 }
 
 void ZMBVEncoder::addXorBlock(int vx, int vy, size_t offset, unsigned& workUsed)
 {
-	using LE_P = typename Endian::Little<Pixel>::type;
-
+	// The frames already contain the final (little endian) pixel format, so
+	// this is a plain xor of the bytes.
 	const auto* pOld = &(std::bit_cast<const Pixel*>(oldFrame.data()))[offset + (vy * pitch) + vx];
 	const auto* pNew = &(std::bit_cast<const Pixel*>(newFrame.data()))[offset];
+	auto* out = std::bit_cast<Pixel*>(&work[workUsed]);
 	repeat(BLOCK_HEIGHT, [&] {
+#ifdef __SSE2__
+		const auto* o = std::bit_cast<const __m128i*>(pOld);
+		const auto* n = std::bit_cast<const __m128i*>(pNew);
+		auto* d = std::bit_cast<__m128i*>(out);
+		for (auto x : xrange(BLOCK_WIDTH / 4)) {
+			_mm_storeu_si128(d + x, _mm_xor_si128(_mm_loadu_si128(o + x), _mm_loadu_si128(n + x)));
+		}
+#else
 		for (auto x : xrange(BLOCK_WIDTH)) {
-			auto pXor = pNew[x] ^ pOld[x];
-			writePixel(pXor, *std::bit_cast<LE_P*>(&work[workUsed]));
-			workUsed += sizeof(Pixel);
+			out[x] = pNew[x] ^ pOld[x];
 		}
+#endif
 		pOld += pitch;
 		pNew += pitch;
+		out += BLOCK_WIDTH;
 	});
+	workUsed += BLOCK_WIDTH * BLOCK_HEIGHT * sizeof(Pixel);
 }
 
 void ZMBVEncoder::addXorFrame(unsigned& workUsed)
@@ -270,19 +316,15 @@ void ZMBVEncoder::addXorFrame(unsigned& workUsed)
 
 void ZMBVEncoder::addFullFrame(unsigned& workUsed)
 {
-	using LE_P = typename Endian::Little<Pixel>::type;
 	static constexpr size_t pixelSize = sizeof(Pixel);
 
-	auto* readFrame =
+	const auto* readFrame =
 		&newFrame[pixelSize * (MAX_VECTOR + MAX_VECTOR * pitch)];
+	auto lineWidth = width * pixelSize;
 	repeat(height, [&] {
-		const auto* pixelsIn = std::bit_cast<const Pixel*>(readFrame);
-		auto* pixelsOut = std::bit_cast<LE_P*>(&work[workUsed]);
-		for (auto x : xrange(width)) {
-			writePixel(pixelsIn[x], pixelsOut[x]);
-		}
-		readFrame += pitch * sizeof(Pixel);
-		workUsed += narrow<unsigned>(width * sizeof(Pixel));
+		memcpy(&work[workUsed], readFrame, lineWidth);
+		readFrame += pitch * pixelSize;
+		workUsed += narrow<unsigned>(lineWidth);
 	});
 }
 
@@ -300,7 +342,18 @@ const ZMBVEncoder::Pixel* ZMBVEncoder::getScaledLine(const FrameSource* frame, u
 	}
 }
 
-std::span<const uint8_t> ZMBVEncoder::compressFrame(bool keyFrame, const FrameSource* frame)
+void ZMBVEncoder::captureFrame(const FrameSource* frame, std::span<Pixel> out) const
+{
+	assert(out.size() == size_t(width) * height);
+	auto* dest = out.data();
+	for (auto i : xrange(height)) {
+		const auto* scaled = getScaledLine(frame, i, dest);
+		if (scaled != dest) memcpy(dest, scaled, width * sizeof(Pixel));
+		dest += width;
+	}
+}
+
+std::span<const uint8_t> ZMBVEncoder::compressFrame(bool keyFrame, std::span<const Pixel> frame)
 {
 	std::swap(newFrame, oldFrame); // replace oldFrame with newFrame
 
@@ -326,17 +379,18 @@ std::span<const uint8_t> ZMBVEncoder::compressFrame(bool keyFrame, const FrameSo
 		deflateReset(&zstream); // restart deflate
 	}
 
-	// copy lines (to add black border)
-	static constexpr size_t pixelSize = sizeof(Pixel);
-	auto linePitch = pitch * pixelSize;
-	auto lineWidth = size_t(width) * pixelSize;
-	uint8_t* dest =
-		&newFrame[pixelSize * (MAX_VECTOR + MAX_VECTOR * pitch)];
-	for (auto i : xrange(height)) {
-		const auto* scaled = std::bit_cast<const uint8_t*>(
-			getScaledLine(frame, i, std::bit_cast<Pixel*>(dest)));
-		if (scaled != dest) memcpy(dest, scaled, lineWidth);
-		dest += linePitch;
+	if (frame.empty()) {
+		// repeat the previous frame
+		copy_to_range(std::span{oldFrame}, std::span{newFrame});
+	} else {
+		// copy lines (to add black border)
+		assert(frame.size() == size_t(width) * height);
+		auto* dest = std::bit_cast<LE_P*>(
+			&newFrame[sizeof(Pixel) * (MAX_VECTOR + MAX_VECTOR * pitch)]);
+		for (auto y : xrange(height)) {
+			convertLine(frame.subspan(y * width, width), dest);
+			dest += pitch;
+		}
 	}
 
 	// Add the frame data.
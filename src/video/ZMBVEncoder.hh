@@ -22,14 +22,28 @@ public:
 	static constexpr std::string_view CODEC_4CC = "ZMBV";
 	using Pixel = uint32_t;
 
-	ZMBVEncoder(unsigned width, unsigned height);
+	/** In 'fast' mode the fastest zlib compression level is used. That
+	  * roughly halves the encoding time, at the cost of ~50% bigger files.
+	  * The result is still a regular ZMBV stream.
+	  */
+	ZMBVEncoder(unsigned width, unsigned height, bool fast);
 	ZMBVEncoder(const ZMBVEncoder&) = delete;
 	ZMBVEncoder(ZMBVEncoder&&) = delete;
 	ZMBVEncoder& operator=(const ZMBVEncoder&) = delete;
 	ZMBVEncoder& operator=(ZMBVEncoder&&) = delete;
 	~ZMBVEncoder() = default;
 
-	[[nodiscard]] std::span<const uint8_t> compressFrame(bool keyFrame, const FrameSource* frame);
+	/** Copy the (scaled) content of the given frame to 'out', which
+	  * must have room for width x height pixels. The result can later be
+	  * passed to compressFrame(); this allows to do the (expensive)
+	  * compression at a later time or in a different thread.
+	  */
+	void captureFrame(const FrameSource* frame, std::span<Pixel> out) const;
+
+	/** Compress a frame that was captured with captureFrame(). An empty
+	  * span repeats the previous frame.
+	  */
+	[[nodiscard]] std::span<const uint8_t> compressFrame(bool keyFrame, std::span<const Pixel> frame);
 
 private:
 	void setupBuffers();
@@ -54,6 +68,7 @@ private:
 	unsigned width;
 	unsigned height;
 	size_t pitch;
+	bool fast;
 };
 
 } // namespace openmsx
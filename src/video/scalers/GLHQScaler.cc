@@ -8,6 +8,7 @@
 
 #include "inplace_buffer.hh"
 #include "narrow.hh"
+#include "strCat.hh"
 
 #include <algorithm>
 #include <array>
@@ -47,39 +48,46 @@ GLHQScaler::GLHQScaler(GLScaler& fallback_, unsigned maxWidth_, unsigned maxHeig
 	glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzleMask);
 #endif
 	edgeBuffer.allocate(maxWidth * maxHeight);
+}
+
+void GLHQScaler::loadTables(unsigned factor)
+{
+	// Only the tables for the zoom factor(s) that are actually used get
+	// loaded, usually that's only one of the three.
+	auto i = factor - 2;
+	if (tablesLoaded[i]) return;
+	tablesLoaded[i] = true;
 
 	const auto& context = systemFileContext();
+	auto n = narrow<GLsizei>(factor * 64);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-	std::string offsetsName = "shaders/HQ_xOffsets.dat";
-	std::string weightsName = "shaders/HQ_xWeights.dat";
-	for (auto i : xrange(3)) {
-		int n = i + 2;
-		offsetsName[10] = narrow<char>('0' + n);
-		auto offsets = File(context.resolve(offsetsName)).mmap<const uint8_t>();
-		offsetTexture[i].bind();
-		glTexImage2D(GL_TEXTURE_2D,       // target
-		             0,                   // level
-		             GL_RGBA,             // internal format
-		             n * 64,              // width
-		             n * 64,              // height
-		             0,                   // border
-		             GL_RGBA,             // format
-		             GL_UNSIGNED_BYTE,    // type
-		             offsets.data());     // data
-
-		weightsName[10] = narrow<char>('0' + n);
-		auto weights = File(context.resolve(weightsName)).mmap<const uint8_t>();
-		weightTexture[i].bind();
-		glTexImage2D(GL_TEXTURE_2D,       // target
-		             0,                   // level
-		             GL_RGB,              // internal format
-		             n * 64,              // width
-		             n * 64,              // height
-		             0,                   // border
-		             GL_RGB,              // format
-		             GL_UNSIGNED_BYTE,    // type
-		             weights.data());     // data
-	}
+
+	// The (pre-generated, see hq.py) offsets are packed in one byte per texel.
+	auto offsets = File(context.resolve(tmpStrCat("shaders/HQ", factor, "xOffsets.dat"))).mmap<const uint8_t>();
+	auto offsetFormat = (OPENGL_VERSION >= OPENGL_3_3) ? GL_RED : GL_LUMINANCE;
+	offsetTexture[i].bind();
+	glTexImage2D(GL_TEXTURE_2D,       // target
+	             0,                   // level
+	             offsetFormat,        // internal format
+	             n,                   // width
+	             n,                   // height
+	             0,                   // border
+	             offsetFormat,        // format
+	             GL_UNSIGNED_BYTE,    // type
+	             offsets.data());     // data
+
+	auto weights = File(context.resolve(tmpStrCat("shaders/HQ", factor, "xWeights.dat"))).mmap<const uint8_t>();
+	weightTexture[i].bind();
+	glTexImage2D(GL_TEXTURE_2D,       // target
+	             0,                   // level
+	             GL_RGB,              // internal format
+	             n,                   // width
+	             n,                   // height
+	             0,                   // border
+	             GL_RGB,              // format
+	             GL_UNSIGNED_BYTE,    // type
+	             weights.data());     // data
+
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 4); // restore to default
 }
 
@@ -93,6 +101,7 @@ void GLHQScaler::scaleImage(
 
 	if ((factorY >= 2) && ((srcWidth % 320) == 0)) {
 		assert(src.getHeight() == 2 * 240);
+		loadTables(factorY);
 		setup(superImpose != nullptr);
 		glActiveTexture(GL_TEXTURE4);
 		weightTexture[factorY - 2].bind();
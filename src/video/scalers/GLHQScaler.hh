@@ -22,11 +22,17 @@ public:
 		unsigned srcStartY, unsigned srcEndY,
 		unsigned lineWidth, FrameSource& paintFrame) override;
 
+private:
+	/** Upload the offset and weight tables for the given zoom factor (2-4),
+	  * if that wasn't done before. */
+	void loadTables(unsigned factor);
+
 private:
 	GLScaler& fallback;
 	gl::Texture edgeTexture;
 	std::array<gl::Texture, 3> offsetTexture;
 	std::array<gl::Texture, 3> weightTexture;
+	std::array<bool, 3> tablesLoaded = {};
 	gl::PixelBuffer<uint16_t> edgeBuffer;
 
 	unsigned maxWidth;
@@ -7,6 +7,8 @@
 #include "strCat.hh"
 #include "xrange.hh"
 
+#include <array>
+
 using namespace gl;
 
 namespace openmsx {
@@ -15,13 +17,8 @@ GLScaler::GLScaler(const std::string& progName)
 {
 	for (auto i : xrange(2)) {
 		auto header = tmpStrCat("#define SUPERIMPOSE ", char('0' + i), '\n');
-		VertexShader   vShader(header, progName + ".vert");
-		FragmentShader fShader(header, progName + ".frag");
-		program[i].attach(vShader);
-		program[i].attach(fShader);
-		program[i].bindAttribLocation(0, "a_position");
-		program[i].bindAttribLocation(1, "a_texCoord");
-		program[i].link();
+		program[i].build(header, progName + ".vert", progName + ".frag",
+		                 std::array{"a_position", "a_texCoord"});
 		program[i].activate();
 		glUniform1i(program[i].getUniformLocation("tex"), 0);
 		if (i == 1) {
@@ -2,19 +2,17 @@
 #define LINESCALERS_HH
 
 #include "PixelOperations.hh"
+#include "SIMDPixelOps.hh"
 
 #include "ranges.hh"
 #include "xrange.hh"
 
+#include <array>
 #include <bit>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
-#include <ranges>
 #include <span>
-#ifdef __SSE2__
-#include "emmintrin.h"
-#endif
 
 namespace openmsx {
 
@@ -70,6 +68,42 @@ void alphaBlendLines(Pixel in1, std::span<const Pixel> in2,
 
 // implementation
 
+// Scale 4 input pixels to 4*N output pixels, only for N=3 and N=4.
+#ifdef __SSE2__
+template<unsigned N>
+inline void scale_1onN_4pixels(const Pixel* __restrict in, Pixel* __restrict out)
+{
+	__m128i a = _mm_loadu_si128(std::bit_cast<const __m128i*>(in));
+	auto store = [&](unsigned k, __m128i v) {
+		_mm_storeu_si128(std::bit_cast<__m128i*>(out + 4 * k), v);
+	};
+	if constexpr (N == 3) {
+		store(0, _mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 0, 0)));
+		store(1, _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 2, 1, 1)));
+		store(2, _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 3, 3, 2)));
+	} else {
+		static_assert(N == 4);
+		store(0, _mm_shuffle_epi32(a, _MM_SHUFFLE(0, 0, 0, 0)));
+		store(1, _mm_shuffle_epi32(a, _MM_SHUFFLE(1, 1, 1, 1)));
+		store(2, _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 2, 2, 2)));
+		store(3, _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 3, 3, 3)));
+	}
+}
+#elif defined(__ARM_NEON)
+template<unsigned N>
+inline void scale_1onN_4pixels(const Pixel* __restrict in, Pixel* __restrict out)
+{
+	// interleaving stores of N times the same vector
+	uint32x4_t a = vld1q_u32(in);
+	if constexpr (N == 3) {
+		vst3q_u32(out, uint32x4x3_t{{a, a, a}});
+	} else {
+		static_assert(N == 4);
+		vst4q_u32(out, uint32x4x4_t{{a, a, a, a}});
+	}
+}
+#endif
+
 template<unsigned N>
 static inline void scale_1onN(
 	std::span<const Pixel> in, std::span<Pixel> out)
@@ -78,6 +112,13 @@ static inline void scale_1onN(
 	assert(in.size() == (outWidth / N));
 
 	size_t i = 0, j = 0;
+#if defined(__SSE2__) || defined(__ARM_NEON)
+	if constexpr ((N == 3) || (N == 4)) {
+		for (/* */; (i + 4 * N) <= outWidth; i += 4 * N, j += 4) {
+			scale_1onN_4pixels<N>(&in[j], &out[i]);
+		}
+	}
+#endif
 	for (/* */; i < (outWidth - (N - 1)); i += N, j += 1) {
 		Pixel pix = in[j];
 		for (auto k : xrange(N)) {
@@ -172,10 +213,20 @@ inline void scale_1on2(std::span<const Pixel> in, std::span<Pixel> out)
 #ifdef __SSE2__
 	size_t chunk = 4 * sizeof(__m128i) / sizeof(Pixel);
 	size_t srcWidth2 = srcWidth & ~(chunk - 1);
-	scale_1on2_SSE(in.data(), out.data(), srcWidth2);
+	if (srcWidth2 != 0) scale_1on2_SSE(in.data(), out.data(), srcWidth2);
 	in  = in .subspan(    srcWidth2);
 	out = out.subspan(2 * srcWidth2);
 	srcWidth -= srcWidth2;
+#elif defined(__ARM_NEON)
+	// interleaving store of 2 times the same vector
+	size_t srcWidth4 = srcWidth & ~3;
+	for (size_t x = 0; x < srcWidth4; x += 4) {
+		uint32x4_t a = vld1q_u32(&in[x]);
+		vst2q_u32(&out[2 * x], uint32x4x2_t{{a, a}});
+	}
+	in  = in .subspan(    srcWidth4);
+	out = out.subspan(2 * srcWidth4);
+	srcWidth -= srcWidth4;
 #endif
 
 	// C++ version. Used both on non-x86 machines and (possibly) on x86 for
@@ -238,12 +289,25 @@ inline void scale_2on1(std::span<const Pixel> in, std::span<Pixel> out)
 	auto outWidth = out.size();
 #ifdef __SSE2__
 	auto n64 = (outWidth * sizeof(Pixel)) & ~63;
-	scale_2on1_SSE(in.data(), out.data(), n64); // process 64 byte chunks
+	if (n64 != 0) scale_2on1_SSE(in.data(), out.data(), n64); // process 64 byte chunks
 	outWidth &= ((64 / sizeof(Pixel)) - 1); // remaining pixels (if any)
 	if (outWidth == 0) [[likely]] return;
 	in  = in .subspan(2 * n64 / sizeof(Pixel));
 	out = out.subspan(    n64 / sizeof(Pixel));
 	// fallthrough to c++ version
+#elif defined(__ARM_NEON)
+	// de-interleaving load: even and odd pixels in separate vectors
+	size_t outWidth4 = outWidth & ~3;
+	for (size_t x = 0; x < outWidth4; x += 4) {
+		uint32x4x2_t a = vld2q_u32(&in[2 * x]);
+		uint8x16_t b = NEONPixelOps::avgDown(vreinterpretq_u8_u32(a.val[0]),
+		                                     vreinterpretq_u8_u32(a.val[1]));
+		vst1q_u32(&out[x], vreinterpretq_u32_u8(b));
+	}
+	outWidth -= outWidth4;
+	if (outWidth == 0) [[likely]] return;
+	in  = in .subspan(2 * outWidth4);
+	out = out.subspan(    outWidth4);
 #endif
 	// pure C++ version
 	PixelOperations pixelOps;
@@ -461,13 +525,21 @@ template<unsigned w1, unsigned w2>
 void blendLines(std::span<const Pixel> in1, std::span<const Pixel> in2, std::span<Pixel> out)
 {
 	// It _IS_ allowed that the output is the same as one of the inputs.
-	// TODO SSE optimizations
-	// pure C++ version
 	assert(in1.size() == in2.size());
 	assert(in1.size() == out.size());
+	size_t width = out.size();
+	size_t i = 0;
+#if defined(__SSE2__) || defined(__ARM_NEON)
+	using Ops = SIMDPixelOps;
+	for (/* */; (i + Ops::N) <= width; i += Ops::N) {
+		Ops::store(&out[i], blendSIMD<Ops, w1, w2>(
+			Ops::load(&in1[i]), Ops::load(&in2[i])));
+	}
+#endif
+	// C++ version, also for the last few pixels of the line.
 	PixelOperations pixelOps;
-	for (auto [i1, i2, o] : std::views::zip(in1, in2, out)) {
-		o = pixelOps.template blend<w1, w2>(i1, i2);
+	for (/* */; i < width; ++i) {
+		out[i] = pixelOps.template blend<w1, w2>(in1[i], in2[i]);
 	}
 }
 
@@ -477,9 +549,18 @@ inline void alphaBlendLines(
 	// It _IS_ allowed that the output is the same as one of the inputs.
 	assert(in1.size() == in2.size());
 	assert(in1.size() == out.size());
+	size_t width = out.size();
+	size_t i = 0;
+#if defined(__SSE2__) || defined(__ARM_NEON)
+	using Ops = SIMDPixelOps;
+	for (/* */; (i + Ops::N) <= width; i += Ops::N) {
+		Ops::store(&out[i], Ops::alphaBlend(
+			Ops::load(&in1[i]), Ops::load(&in2[i])));
+	}
+#endif
 	PixelOperations pixelOps;
-	for (auto [i1, i2, o] : std::views::zip(in1, in2, out)) {
-		o = pixelOps.alphaBlend(i1, i2);
+	for (/* */; i < width; ++i) {
+		out[i] = pixelOps.alphaBlend(in1[i], in2[i]);
 	}
 }
 
@@ -503,8 +584,21 @@ inline void alphaBlendLines(
 	//    }
 	Pixel in1M = pixelOps.multiply(in1, alpha);
 	unsigned alpha2 = 256 - alpha;
-	for (auto [i2, o] : std::views::zip(in2, out)) {
-		o = in1M + pixelOps.multiply(i2, alpha2);
+	size_t width = out.size();
+	size_t i = 0;
+#if defined(__SSE2__) || defined(__ARM_NEON)
+	// The components of 'in1M' and 'multiply(in2, alpha2)' are both
+	// rounded down, so their sum can't overflow.
+	using Ops = SIMDPixelOps;
+	std::array<Pixel, Ops::N> in1MArray;
+	in1MArray.fill(in1M);
+	auto in1MV = Ops::load(in1MArray.data());
+	for (/* */; (i + Ops::N) <= width; i += Ops::N) {
+		Ops::store(&out[i], Ops::add(in1MV, Ops::multiply(Ops::load(&in2[i]), alpha2)));
+	}
+#endif
+	for (/* */; i < width; ++i) {
+		out[i] = in1M + pixelOps.multiply(in2[i], alpha2);
 	}
 }
 
@@ -0,0 +1,272 @@
+#ifndef SIMDPIXELOPS_HH
+#define SIMDPIXELOPS_HH
+
+#include "PixelOperations.hh"
+
+#include "narrow.hh"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+// Vectorized versions of some of the PixelOperations, used by the LineScalers.
+//
+// Each XxxPixelOps struct below operates on a vector of 'N' pixels and gives
+// bit-identical results to the corresponding (scalar) PixelOperations method.
+// Like the rest of openMSX the instruction set is selected at compile time:
+// SSE2 is part of the x86-64 baseline and NEON of the aarch64 baseline. The
+// AVX2 version is only used when the compiler is allowed to generate AVX2
+// instructions (e.g. -march=x86-64-v3 or -march=native).
+//
+// 'SIMDPixelOps' is an alias for the widest available implementation (if any).
+
+namespace openmsx {
+
+#ifdef __SSE2__
+struct SSE2PixelOps
+{
+	using V = __m128i;
+	static constexpr size_t N = sizeof(V) / sizeof(Pixel);
+
+	[[nodiscard]] static V load(const Pixel* p) {
+		return _mm_loadu_si128(std::bit_cast<const V*>(p));
+	}
+	static void store(Pixel* p, V v) {
+		_mm_storeu_si128(std::bit_cast<V*>(p), v);
+	}
+
+	// Per component: floor((x + y) / 2)
+	[[nodiscard]] static V avgDown(V x, V y) {
+		// _mm_avg_epu8() rounds up
+		V odd = _mm_and_si128(_mm_xor_si128(x, y), _mm_set1_epi8(1));
+		return _mm_sub_epi8(_mm_avg_epu8(x, y), odd);
+	}
+	// Per component: ceil((x + y) / 2)
+	[[nodiscard]] static V avgUp(V x, V y) {
+		return _mm_avg_epu8(x, y);
+	}
+	// Per component: floor((x * w1 + y * w2) / 2^L2), requires w1 + w2 <= 256
+	template<unsigned w1, unsigned w2, unsigned L2>
+	[[nodiscard]] static V weighted(V x, V y) {
+		V zero = _mm_setzero_si128();
+		V f1 = _mm_set1_epi16(w1);
+		V f2 = _mm_set1_epi16(w2);
+		auto half = [&](V a, V b) {
+			return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(a, f1),
+			                                    _mm_mullo_epi16(b, f2)), L2);
+		};
+		V lo = half(_mm_unpacklo_epi8(x, zero), _mm_unpacklo_epi8(y, zero));
+		V hi = half(_mm_unpackhi_epi8(x, zero), _mm_unpackhi_epi8(y, zero));
+		return _mm_packus_epi16(lo, hi);
+	}
+	// See PixelOperations::multiply()
+	[[nodiscard]] static V multiply(V p, unsigned x) {
+		V zero = _mm_setzero_si128();
+		V f = _mm_set1_epi16(narrow_cast<short>(x));
+		V lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), f), 8);
+		V hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), f), 8);
+		return _mm_packus_epi16(lo, hi);
+	}
+	// Per component addition, the caller guarantees there's no overflow.
+	[[nodiscard]] static V add(V x, V y) {
+		return _mm_add_epi8(x, y);
+	}
+	// See PixelOperations::alphaBlend()
+	[[nodiscard]] static V alphaBlend(V p1, V p2) {
+		// lerp(p2, p1, alpha(p1)), per component:
+		//   c2 + floor((c1 - c2) * alpha / 256)   (modulo 256)
+		V zero = _mm_setzero_si128();
+		auto half = [](V c1, V c2) {
+			constexpr int A = 0xFF; // _MM_SHUFFLE(3, 3, 3, 3)
+			V alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c1, A), A);
+			V t = _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(c1, c2), alpha), 8);
+			return _mm_and_si128(_mm_add_epi16(c2, t), _mm_set1_epi16(0xFF));
+		};
+		V lo = half(_mm_unpacklo_epi8(p1, zero), _mm_unpacklo_epi8(p2, zero));
+		V hi = half(_mm_unpackhi_epi8(p1, zero), _mm_unpackhi_epi8(p2, zero));
+		return _mm_packus_epi16(lo, hi);
+	}
+};
+#endif
+
+#ifdef __AVX2__
+struct AVX2PixelOps
+{
+	using V = __m256i;
+	static constexpr size_t N = sizeof(V) / sizeof(Pixel);
+
+	[[nodiscard]] static V load(const Pixel* p) {
+		return _mm256_loadu_si256(std::bit_cast<const V*>(p));
+	}
+	static void store(Pixel* p, V v) {
+		_mm256_storeu_si256(std::bit_cast<V*>(p), v);
+	}
+
+	// The unpack and pack instructions operate within 128-bit lanes, so
+	// the combination of both keeps the original pixel order.
+	[[nodiscard]] static V avgDown(V x, V y) {
+		V odd = _mm256_and_si256(_mm256_xor_si256(x, y), _mm256_set1_epi8(1));
+		return _mm256_sub_epi8(_mm256_avg_epu8(x, y), odd);
+	}
+	[[nodiscard]] static V avgUp(V x, V y) {
+		return _mm256_avg_epu8(x, y);
+	}
+	template<unsigned w1, unsigned w2, unsigned L2>
+	[[nodiscard]] static V weighted(V x, V y) {
+		V zero = _mm256_setzero_si256();
+		V f1 = _mm256_set1_epi16(w1);
+		V f2 = _mm256_set1_epi16(w2);
+		auto half = [&](V a, V b) {
+			return _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(a, f1),
+			                                          _mm256_mullo_epi16(b, f2)), L2);
+		};
+		V lo = half(_mm256_unpacklo_epi8(x, zero), _mm256_unpacklo_epi8(y, zero));
+		V hi = half(_mm256_unpackhi_epi8(x, zero), _mm256_unpackhi_epi8(y, zero));
+		return _mm256_packus_epi16(lo, hi);
+	}
+	[[nodiscard]] static V multiply(V p, unsigned x) {
+		V zero = _mm256_setzero_si256();
+		V f = _mm256_set1_epi16(narrow_cast<short>(x));
+		V lo = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(p, zero), f), 8);
+		V hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(p, zero), f), 8);
+		return _mm256_packus_epi16(lo, hi);
+	}
+	[[nodiscard]] static V add(V x, V y) {
+		return _mm256_add_epi8(x, y);
+	}
+	[[nodiscard]] static V alphaBlend(V p1, V p2) {
+		V zero = _mm256_setzero_si256();
+		auto half = [](V c1, V c2) {
+			constexpr int A = 0xFF; // _MM_SHUFFLE(3, 3, 3, 3)
+			V alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(c1, A), A);
+			V t = _mm256_srai_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(c1, c2), alpha), 8);
+			return _mm256_and_si256(_mm256_add_epi16(c2, t), _mm256_set1_epi16(0xFF));
+		};
+		V lo = half(_mm256_unpacklo_epi8(p1, zero), _mm256_unpacklo_epi8(p2, zero));
+		V hi = half(_mm256_unpackhi_epi8(p1, zero), _mm256_unpackhi_epi8(p2, zero));
+		return _mm256_packus_epi16(lo, hi);
+	}
+};
+#endif
+
+#ifdef __ARM_NEON
+struct NEONPixelOps
+{
+	using V = uint8x16_t;
+	static constexpr size_t N = sizeof(V) / sizeof(Pixel);
+
+	[[nodiscard]] static V load(const Pixel* p) {
+		return vld1q_u8(std::bit_cast<const uint8_t*>(p));
+	}
+	static void store(Pixel* p, V v) {
+		vst1q_u8(std::bit_cast<uint8_t*>(p), v);
+	}
+
+	[[nodiscard]] static V avgDown(V x, V y) {
+		return vhaddq_u8(x, y);
+	}
+	[[nodiscard]] static V avgUp(V x, V y) {
+		return vrhaddq_u8(x, y);
+	}
+	template<unsigned w1, unsigned w2, unsigned L2>
+	[[nodiscard]] static V weighted(V x, V y) {
+		// w1 + w2 <= 256 and w1, w2 != 0 so both weights fit in 8 bits
+		uint8x8_t f1 = vdup_n_u8(uint8_t(w1));
+		uint8x8_t f2 = vdup_n_u8(uint8_t(w2));
+		uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8 (x), f1), vget_low_u8 (y), f2);
+		uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(x), f1), vget_high_u8(y), f2);
+		return vcombine_u8(vmovn_u16(vshrq_n_u16(lo, L2)),
+		                   vmovn_u16(vshrq_n_u16(hi, L2)));
+	}
+	[[nodiscard]] static V multiply(V p, unsigned x) {
+		auto f = narrow_cast<uint16_t>(x); // can be 256
+		uint16x8_t lo = vmulq_n_u16(vmovl_u8(vget_low_u8 (p)), f);
+		uint16x8_t hi = vmulq_n_u16(vmovl_u8(vget_high_u8(p)), f);
+		return vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+	}
+	[[nodiscard]] static V add(V x, V y) {
+		return vaddq_u8(x, y);
+	}
+	[[nodiscard]] static V alphaBlend(V p1, V p2) {
+		// replicate the alpha component over all components of a pixel
+		V alpha = vreinterpretq_u8_u32(vmulq_n_u32(
+			vshrq_n_u32(vreinterpretq_u32_u8(p1), 24), 0x01010101));
+		auto half = [](uint8x8_t c1, uint8x8_t c2, uint8x8_t a) {
+			int16x8_t d = vreinterpretq_s16_u16(vsubl_u8(c1, c2));
+			int16x8_t t = vshrq_n_s16(vmulq_s16(d, vreinterpretq_s16_u16(vmovl_u8(a))), 8);
+			// vmovn() keeps the lower 8 bits, that's the required modulo 256
+			return vmovn_u16(vreinterpretq_u16_s16(
+				vaddq_s16(vreinterpretq_s16_u16(vmovl_u8(c2)), t)));
+		};
+		return vcombine_u8(
+			half(vget_low_u8 (p1), vget_low_u8 (p2), vget_low_u8 (alpha)),
+			half(vget_high_u8(p1), vget_high_u8(p2), vget_high_u8(alpha)));
+	}
+};
+#endif
+
+#if defined(__AVX2__)
+using SIMDPixelOps = AVX2PixelOps;
+#elif defined(__SSE2__)
+using SIMDPixelOps = SSE2PixelOps;
+#elif defined(__ARM_NEON)
+using SIMDPixelOps = NEONPixelOps;
+#endif
+
+/** Vectorized version of PixelOperations::blend<w1, w2>(). This follows the
+  * exact same steps as the scalar version, so that the result is identical.
+  */
+template<typename Ops, unsigned w1, unsigned w2>
+[[nodiscard]] inline typename Ops::V blendSIMD(typename Ops::V p1, typename Ops::V p2)
+{
+	constexpr unsigned total = w1 + w2;
+	if constexpr (w1 == 0) {
+		return p2;
+	} else if constexpr (w1 > w2) {
+		return blendSIMD<Ops, w2, w1>(p2, p1);
+
+	} else if constexpr (w1 == w2) {
+		// <1,1>
+		return Ops::avgDown(p1, p2);
+	} else if constexpr ((3 * w1) == w2) {
+		// <1,3>
+		auto p11 = Ops::avgDown(p1, p2);
+		return Ops::avgUp(p11, p2);
+	} else if constexpr ((7 * w1) == w2) {
+		// <1,7>
+		auto p11 = Ops::avgDown(p1, p2);
+		auto p13 = Ops::avgDown(p11, p2);
+		return Ops::avgUp(p13, p2);
+	} else if constexpr ((5 * w1) == (3 * w2)) {
+		// <3,5>
+		auto p11 = Ops::avgUp  (p1, p2);
+		auto p13 = Ops::avgDown(p11, p2);
+		return Ops::avgDown(p11, p13);
+
+	} else if constexpr (!std::has_single_bit(total)) {
+		// approximate with weights that sum to 256 (same as the scalar version)
+		constexpr unsigned newTotal = 256;
+		constexpr unsigned ww1 = (2 * w1 * newTotal + total) / (2 * total);
+		constexpr unsigned ww2 = 256 - ww1;
+		return blendSIMD<Ops, ww1, ww2>(p1, p2);
+
+	} else {
+		static_assert(total <= 256);
+		constexpr unsigned l2 = std::bit_width(total) - 1;
+		return Ops::template weighted<w1, w2, l2>(p1, p2);
+	}
+}
+
+} // namespace openmsx
+
+#endif
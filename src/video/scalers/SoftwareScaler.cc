@@ -0,0 +1,202 @@
+#include "SoftwareScaler.hh"
+
+#include "HQCommon.hh"
+
+#include "File.hh"
+#include "FileContext.hh"
+#include "FileException.hh"
+#include "ThreadPool.hh"
+
+#include "endian.hh"
+#include "narrow.hh"
+#include "strCat.hh"
+#include "xrange.hh"
+
+#include <algorithm>
+#include <cassert>
+
+namespace openmsx {
+
+using Pixel = uint32_t;
+
+std::optional<SoftwareScaler> SoftwareScaler::parse(std::string_view name)
+{
+	auto parseFactor = [](std::string_view s) -> std::optional<unsigned> {
+		if ((s.size() == 2) && (s[1] == 'x') && ('2' <= s[0]) && (s[0] <= '4')) {
+			return unsigned(s[0] - '0');
+		}
+		return std::nullopt;
+	};
+	if (name.starts_with("hq")) {
+		if (auto f = parseFactor(name.substr(2))) return SoftwareScaler{Algo::HQ, *f};
+	} else if (name.starts_with("scale")) {
+		if (auto f = parseFactor(name.substr(5))) return SoftwareScaler{Algo::SCALE, *f};
+	}
+	return std::nullopt;
+}
+
+HQTables HQTables::load(unsigned factor)
+{
+	assert((2 <= factor) && (factor <= 4));
+	const auto& context = systemFileContext();
+	auto readFile = [&](const char* kind, size_t size) {
+		auto name = strCat("shaders/HQ", factor, 'x', kind, ".dat");
+		File file(context.resolve(name));
+		if (file.getSize() != size) {
+			throw FileException("Unexpected size for ", name);
+		}
+		std::vector<uint8_t> result(size);
+		file.read(std::span{result});
+		return result;
+	};
+	auto texels = size_t(64 * factor) * (64 * factor);
+	HQTables result;
+	result.offsets = readFile("Offsets", 4 * texels);
+	result.weights = readFile("Weights", 3 * texels);
+	return result;
+}
+
+// Split the image in horizontal stripes, and (possibly in parallel) process
+// each of them.
+template<typename Func>
+static void forEachStripe(unsigned height, ThreadPool* pool, Func func)
+{
+	auto numStripes = pool ? std::min(height, pool->getNumWorkers() + 1) : 1;
+	auto doStripe = [&](size_t i) {
+		func(unsigned((height * i) / numStripes),
+		     unsigned((height * (i + 1)) / numStripes));
+	};
+	if (pool) {
+		pool->parallelFor(numStripes, doStripe);
+	} else {
+		doStripe(0);
+	}
+}
+
+// Access pixels, coordinates outside the image are clamped to the border
+// (like GL_CLAMP_TO_EDGE).
+struct ClampedImage
+{
+	std::span<const Pixel> src;
+	int width, height;
+
+	[[nodiscard]] std::span<const Pixel> line(int y) const {
+		y = std::clamp(y, 0, height - 1);
+		return src.subspan(size_t(y) * width, width);
+	}
+	[[nodiscard]] Pixel operator()(int x, int y) const {
+		return line(y)[std::clamp(x, 0, width - 1)];
+	}
+};
+
+// Which neighbour (-1 or +1) is on the same side as the given sub-pixel, or
+// 0 for the center sub-pixel (only for odd scale factors).
+[[nodiscard]] static int subPixelSide(unsigned sub, unsigned factor)
+{
+	unsigned pos2 = 2 * sub + 1; // 2x the position of the sub-pixel's center
+	return (pos2 < factor) ? -1 : (pos2 > factor) ? 1 : 0;
+}
+
+void scaleNxImage(unsigned factor, std::span<const Pixel> src, unsigned width,
+                  std::span<Pixel> dst, ThreadPool* pool)
+{
+	assert(width != 0);
+	assert((src.size() % width) == 0);
+	auto height = narrow<unsigned>(src.size() / width);
+	assert(dst.size() == src.size() * factor * factor);
+	ClampedImage img{src, int(width), int(height)};
+	auto dstWidth = width * factor;
+
+	forEachStripe(height, pool, [&](unsigned startY, unsigned endY) {
+		for (auto y : xrange(int(startY), int(endY))) {
+			for (auto x : xrange(int(width))) {
+				Pixel c5 = img(x, y);
+				for (auto sy : xrange(factor)) {
+					int dy = subPixelSide(sy, factor);
+					auto out = dst.subspan((size_t(y) * factor + sy) * dstWidth + size_t(x) * factor, factor);
+					for (auto sx : xrange(factor)) {
+						int dx = subPixelSide(sx, factor);
+						if ((dx == 0) || (dy == 0)) {
+							out[sx] = c5;
+							continue;
+						}
+						// Same conditions as in the scale2x shader.
+						Pixel left  = img(x + dx, y);
+						Pixel right = img(x - dx, y);
+						Pixel top   = img(x, y + dy);
+						Pixel bot   = img(x, y - dy);
+						int dot = 0;
+						for (int shift = 0; shift < 24; shift += 8) {
+							int lr = int((left >> shift) & 0xFF) - int((right >> shift) & 0xFF);
+							int tb = int((top  >> shift) & 0xFF) - int((bot   >> shift) & 0xFF);
+							dot += lr * tb;
+						}
+						bool sameLeftTop = ((left ^ top) & 0x00FF'FFFF) == 0;
+						out[sx] = ((dot == 0) || !sameLeftTop) ? c5 : top;
+					}
+				}
+			}
+		}
+	});
+}
+
+void scaleHQImage(unsigned factor, const HQTables& tables,
+                  std::span<const Pixel> src, unsigned width,
+                  std::span<Pixel> dst, ThreadPool* pool)
+{
+	assert(width != 0);
+	assert((width % 2) == 0); // required by calcEdgesGL()
+	assert((src.size() % width) == 0);
+	auto height = narrow<unsigned>(src.size() / width);
+	assert(dst.size() == src.size() * factor * factor);
+	auto tableWidth = size_t(64) * factor;
+	assert(tables.offsets.size() == 4 * tableWidth * tableWidth);
+	assert(tables.weights.size() == 3 * tableWidth * tableWidth);
+	ClampedImage img{src, int(width), int(height)};
+	auto dstWidth = width * factor;
+
+	// Offsets are encoded as 0x00, 0x80, 0xFF for resp -1, 0, +1.
+	auto offset = [](uint8_t o) { return ((o + 0x40) >> 7) - 1; };
+	auto mix = [](Pixel cx, Pixel cy, Pixel c5, const uint8_t* w) {
+		Pixel result = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			unsigned c = ((cx >> shift) & 0xFF) * w[0]
+			           + ((cy >> shift) & 0xFF) * w[1]
+			           + ((c5 >> shift) & 0xFF) * w[2];
+			// weights sum to 255 or 256, so clamp (like the GPU does)
+			result |= std::min((c + 127) / 255, 255u) << shift;
+		}
+		return result;
+	};
+
+	forEachStripe(height, pool, [&](unsigned startY, unsigned endY) {
+		EdgeHQ edgeOp;
+		std::vector<Endian::L32> edges(width / 2);
+		calcEdgesGL(img.line(int(startY) - 1), img.line(int(startY)), edges, edgeOp);
+		for (auto y : xrange(int(startY), int(endY))) {
+			calcEdgesGL(img.line(y), img.line(y + 1), edges, edgeOp);
+			for (auto x : xrange(int(width))) {
+				uint32_t edges2 = edges[x / 2];
+				uint32_t edge = (x & 1) ? (edges2 >> 16) : (edges2 & 0xFFFF);
+				// 12-bit edge pattern, as the 2 MSB aligned 6-bit
+				// groups (see calcEdgesGL())
+				auto ex = (edge >>  2) & 0x3F;
+				auto ey = (edge >> 10) & 0x3F;
+				Pixel c5 = img(x, y);
+				for (auto sy : xrange(factor)) {
+					auto out = dst.subspan((size_t(y) * factor + sy) * dstWidth + size_t(x) * factor, factor);
+					for (auto sx : xrange(factor)) {
+						auto t = (ey * factor + sy) * tableWidth + (ex * factor + sx);
+						const auto* o = &tables.offsets[4 * t];
+						const auto* w = &tables.weights[3 * t];
+						Pixel cx = img(x + offset(o[0]), y + offset(o[1]));
+						Pixel cy = img(x + offset(o[2]), y + offset(o[3]));
+						out[sx] = mix(cx, cy, c5, w);
+					}
+				}
+			}
+		}
+	});
+}
+
+} // namespace openmsx
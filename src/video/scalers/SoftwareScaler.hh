@@ -0,0 +1,60 @@
+#ifndef SOFTWARESCALER_HH
+#define SOFTWARESCALER_HH
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace openmsx {
+
+class ThreadPool;
+
+/** CPU implementations of the 'hq' and 'scale' (ScaleNx) scale algorithms.
+  * These give the same result as the GLHQScaler and GLScaleNxScaler shaders,
+  * but they don't need an openGL context, e.g. to produce scaled raw
+  * screenshots.
+  *
+  * Images are 'width x height' RGBA pixels, the output image is
+  * '(factor * width) x (factor * height)'. Optionally the work is split in
+  * horizontal stripes and executed on a thread pool.
+  */
+struct SoftwareScaler
+{
+	enum class Algo : uint8_t { SCALE, HQ };
+	Algo algo;
+	unsigned factor; // 2 - 4
+
+	/** Parse a name like "hq2x" or "scale3x", returns nullopt when the
+	  * name is not recognized.
+	  */
+	[[nodiscard]] static std::optional<SoftwareScaler> parse(std::string_view name);
+};
+
+/** The lookup tables of the 'hq' algorithm for one scale factor, these are
+  * the same tables the hq shader uses. For each 12-bit edge pattern and
+  * each output sub-pixel they contain which 2 neighbour pixels are mixed
+  * with the center pixel, and with which weights.
+  */
+struct HQTables
+{
+	std::vector<uint8_t> offsets; // (64 * factor)^2 x RGBA
+	std::vector<uint8_t> weights; // (64 * factor)^2 x RGB
+
+	/** Load the tables from the system 'shaders' directory.
+	  * Throws MSXException when the files can't be read.
+	  */
+	[[nodiscard]] static HQTables load(unsigned factor);
+};
+
+void scaleNxImage(unsigned factor, std::span<const uint32_t> src, unsigned width,
+                  std::span<uint32_t> dst, ThreadPool* pool = nullptr);
+
+void scaleHQImage(unsigned factor, const HQTables& tables,
+                  std::span<const uint32_t> src, unsigned width,
+                  std::span<uint32_t> dst, ThreadPool* pool = nullptr);
+
+} // namespace openmsx
+
+#endif
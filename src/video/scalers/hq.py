@@ -199,9 +199,22 @@ def transformWeights(weights, cellFunc):
 	for cell in cellFunc(scaledWeights):
 		yield min(255, 0 if cell is None else scaledWeights[cell])
 
+def packOffsets(weights):
+	'''Packs the (x, y) offsets of both neighbours in a single byte: each
+	coordinate is 0, 1 or 2 (left/top, center, right/bottom), this is
+	stored as the base-3 number x0 y0 x1 y1. The fragment shader unpacks
+	it again.
+	'''
+	packed = 0
+	for neighbour in computeNeighbours(weights):
+		n = 4 if neighbour is None else neighbour
+		packed = packed * 9 + (n % 3) * 3 + n // 3
+	return packed
+
 def computeOffsets(pixelExpr):
 	'''Computes offsets for the fragment shader.
-	Output is a 64N * 64N texture, where N is the zoom factor.
+	Output is a 64N * 64N texture (one byte per texel, see packOffsets()),
+	where N is the zoom factor.
 	'''
 	zoom = getZoom(pixelExpr)
 	for caseMajor in range(0, len(pixelExpr), 64):
@@ -209,9 +222,7 @@ def computeOffsets(pixelExpr):
 			for caseMinor in range(64):
 				for subX in range(zoom):
 					weights = pixelExpr[caseMajor + caseMinor][subY + subX]
-					for x, y in transformOffsets(weights):
-						yield x
-						yield y
+					yield packOffsets(weights)
 
 def computeWeights(pixelExpr, cellFunc):
 	'''Computes weights for the fragment shader.
@@ -4,12 +4,21 @@
 #include "V9990VRAM.hh"
 
 #include "narrow.hh"
+#include "ranges.hh"
 #include "unreachable.hh"
+#include "xrange.hh"
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cassert>
 #include <concepts>
 #include <cstdint>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace openmsx {
 
@@ -26,117 +35,86 @@ V9990BitmapConverter::V9990BitmapConverter(
 	setColorMode(V9990ColorMode::PP, V9990DisplayMode::B0); // initialize with dummy values
 }
 
-template<bool YJK, bool PAL, bool SKIP, std::unsigned_integral Pixel, typename ColorLookup>
-static inline void draw_YJK_YUV_PAL(
-	ColorLookup color, const V9990VRAM& vram,
-	Pixel* __restrict& out, unsigned& address, int firstX = 0)
+// Calculate the V9990 15-bit color index (GRB, 5 bits each) for each pixel in
+// 'data' (in YUV or YJK format, groups of 4 bytes). 'data.size()' must be a
+// multiple of 8.
+template<bool YJK>
+static void calcYJK_YUV(std::span<const uint8_t> data, std::span<uint16_t> idx)
 {
-	std::array<uint8_t, 4> data;
-	for (auto& d : data) {
-		d = vram.readVRAMBx(address++);
+	assert((data.size() % 8) == 0);
+	assert(idx.size() == data.size());
+#ifdef __SSE2__
+	// 2 groups (8 pixels) per iteration, one pixel per 16-bit lane.
+	auto zero = _mm_setzero_si128();
+	auto max = _mm_set1_epi16(31);
+	auto clamp = [&](__m128i x) { return _mm_max_epi16(_mm_min_epi16(x, max), zero); };
+	// The 3 lower bits of bytes 'i+1' and 'i' (in each group) form a 6-bit
+	// signed number (broadcast to all 4 lanes of the group).
+	auto get6 = [](__m128i low3, auto shuf0, auto shuf1) {
+		auto v = _mm_or_si128(_mm_slli_epi16(shuf1(low3), 3), shuf0(low3));
+		return _mm_srai_epi16(_mm_slli_epi16(v, 10), 10); // sign extend
+	};
+	auto b0 = [](__m128i x) { return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0x00), 0x00); };
+	auto b1 = [](__m128i x) { return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0x55), 0x55); };
+	auto b2 = [](__m128i x) { return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xAA), 0xAA); };
+	auto b3 = [](__m128i x) { return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xFF), 0xFF); };
+	for (size_t i = 0; i < data.size(); i += 8) {
+		auto d = _mm_unpacklo_epi8(_mm_loadl_epi64(std::bit_cast<const __m128i*>(&data[i])), zero);
+		auto low3 = _mm_and_si128(d, _mm_set1_epi16(7));
+		auto v = get6(low3, b0, b1);
+		auto u = get6(low3, b2, b3);
+		auto y = _mm_srli_epi16(d, 3);
+		auto r = clamp(_mm_add_epi16(y, u));
+		// note: for negative values '>> 2' differs from '/ 4', but both clamp to 0
+		auto g = clamp(_mm_srai_epi16(_mm_sub_epi16(_mm_sub_epi16(_mm_add_epi16(_mm_slli_epi16(y, 2), y),
+		                                                          _mm_add_epi16(u, u)), v), 2));
+		auto b = clamp(_mm_add_epi16(y, v));
+		// The only difference between YUV and YJK is that green and
+		// blue are swapped.
+		if constexpr (YJK) std::swap(g, b);
+		auto result = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(g, 10), _mm_slli_epi16(r, 5)), b);
+		_mm_storeu_si128(std::bit_cast<__m128i*>(&idx[i]), result);
 	}
-
-	int u = (data[2] & 7) + ((data[3] & 3) << 3) - ((data[3] & 4) << 3);
-	int v = (data[0] & 7) + ((data[1] & 3) << 3) - ((data[1] & 4) << 3);
-
-	for (auto i : xrange(SKIP ? firstX : 0, 4)) {
-		if (PAL && (data[i] & 0x08)) {
-			*out++ = color.lookup64(data[i] >> 4);
-		} else {
-			int y = (data[i] & 0xF8) >> 3;
+#else
+	for (size_t i = 0; i < data.size(); i += 4) {
+		int u = (data[i + 2] & 7) + ((data[i + 3] & 3) << 3) - ((data[i + 3] & 4) << 3);
+		int v = (data[i + 0] & 7) + ((data[i + 1] & 3) << 3) - ((data[i + 1] & 4) << 3);
+		for (auto j : xrange(4)) {
+			int y = (data[i + j] & 0xF8) >> 3;
 			int r = std::clamp(y + u,                   0, 31);
 			int g = std::clamp((5 * y - 2 * u - v) / 4, 0, 31);
 			int b = std::clamp(y + v,                   0, 31);
 			// The only difference between YUV and YJK is that
 			// green and blue are swapped.
 			if constexpr (YJK) std::swap(g, b);
-			*out++ = color.lookup32768((g << 10) + (r << 5) + b);
+			idx[i + j] = uint16_t((g << 10) + (r << 5) + b);
 		}
 	}
+#endif
 }
 
-template<std::unsigned_integral Pixel, typename ColorLookup>
-static void rasterBYUV(
-	ColorLookup color, const V9990& vdp, const V9990VRAM& vram,
-	std::span<Pixel> buf, unsigned x, unsigned y)
-{
-	Pixel* __restrict out = buf.data();
-	int nrPixels = narrow<int>(buf.size());
-	unsigned address = (x & ~3) + y * vdp.getImageWidth();
-	if (x & 3) {
-		draw_YJK_YUV_PAL<false, false, true>(
-			color, vram, out, address, x & 3);
-		nrPixels -= narrow<int>(4 - (x & 3));
-	}
-	for (/**/; nrPixels > 0; nrPixels -= 4) {
-		draw_YJK_YUV_PAL<false, false, false>(
-			color, vram, out, address);
-	}
-	// Note: this can draw up to 3 pixels too many, but that's ok.
-}
-
-template<std::unsigned_integral Pixel, typename ColorLookup>
-static void rasterBYUVP(
-	ColorLookup color, const V9990& vdp, const V9990VRAM& vram,
-	std::span<Pixel> buf, unsigned x, unsigned y)
-{
-	// TODO this mode cannot be shown in B4 and higher resolution modes
-	//      (So the dual palette for B4 modes is not an issue here.)
-	Pixel* __restrict out = buf.data();
-	int nrPixels = narrow<int>(buf.size());
-	unsigned address = (x & ~3) + y * vdp.getImageWidth();
-	if (x & 3) {
-		draw_YJK_YUV_PAL<false, true, true>(
-			color, vram, out, address, x & 3);
-		nrPixels -= narrow<int>(4 - (x & 3));
-	}
-	for (/**/; nrPixels > 0; nrPixels -= 4) {
-		draw_YJK_YUV_PAL<false, true, false>(
-			color, vram, out, address);
-	}
-	// Note: this can draw up to 3 pixels too many, but that's ok.
-}
-
-template<std::unsigned_integral Pixel, typename ColorLookup>
-static void rasterBYJK(
-	ColorLookup color, const V9990& vdp, const V9990VRAM& vram,
-	std::span<Pixel> buf, unsigned x, unsigned y)
-{
-	Pixel* __restrict out = buf.data();
-	int nrPixels = narrow<int>(buf.size());
-	unsigned address = (x & ~3) + y * vdp.getImageWidth();
-	if (x & 3) {
-		draw_YJK_YUV_PAL<true, false, true>(
-			color, vram, out, address, x & 3);
-		nrPixels -= narrow<int>(4 - (x & 3));
-	}
-	for (/**/; nrPixels > 0; nrPixels -= 4) {
-		draw_YJK_YUV_PAL<true, false, false>(
-			color, vram, out, address);
-	}
-	// Note: this can draw up to 3 pixels too many, but that's ok.
-}
+// The raster functions first fetch all VRAM bytes for the line (much faster
+// than reading them one by one, see V9990VRAM::readVRAMBx()), then convert.
 
-template<std::unsigned_integral Pixel, typename ColorLookup>
-static void rasterBYJKP(
+template<bool YJK, bool PAL, std::unsigned_integral Pixel, typename ColorLookup>
+static void rasterYJK_YUV(
 	ColorLookup color, const V9990& vdp, const V9990VRAM& vram,
 	std::span<Pixel> buf, unsigned x, unsigned y)
 {
-	// TODO this mode cannot be shown in B4 and higher resolution modes
-	//      (So the dual palette for B4 modes is not an issue here.)
-	Pixel* __restrict out = buf.data();
-	int nrPixels = narrow<int>(buf.size());
-	unsigned address = (x & ~3) + y * vdp.getImageWidth();
-	if (x & 3) {
-		draw_YJK_YUV_PAL<true, true, true>(
-			color, vram, out, address, x & 3);
-		nrPixels -= narrow<int>(4 - (x & 3));
+	// TODO the palette modes (BYUVP/BYJKP) cannot be shown in B4 and higher
+	//      resolution modes (So the dual palette for B4 modes is not an
+	//      issue here.)
+	unsigned first = x & 3; // start in the middle of a group of 4 pixels
+	auto num = (first + buf.size() + 7) & ~7; // see calcYJK_YUV()
+	std::array<uint8_t,  1024 + 8> data;
+	std::array<uint16_t, 1024 + 8> idx;
+	vram.readVRAMBx((x & ~3) + y * vdp.getImageWidth(), subspan(data, 0, num));
+	calcYJK_YUV<YJK>(subspan(data, 0, num), subspan(idx, 0, num));
+	for (auto i : xrange(buf.size())) {
+		auto d = data[first + i];
+		buf[i] = (PAL && (d & 0x08)) ? color.lookup64(d >> 4)
+		                             : color.lookup32768(idx[first + i]);
 	}
-	for (/**/; nrPixels > 0; nrPixels -= 4) {
-		draw_YJK_YUV_PAL<true, true, false>(
-			color, vram, out, address);
-	}
-	// Note: this can draw up to 3 pixels too many, but that's ok.
 }
 
 template<std::unsigned_integral Pixel, typename ColorLookup>
@@ -144,27 +122,21 @@ static void rasterBD16(
 	ColorLookup color, const V9990& vdp, const V9990VRAM& vram,
 	std::span<Pixel> buf, unsigned x, unsigned y)
 {
-	Pixel* __restrict out = buf.data();
-	int nrPixels = narrow<int>(buf.size());
-	unsigned address = 2 * (x + y * vdp.getImageWidth());
+	std::array<uint8_t, 2 * 1024> data;
+	auto line = subspan(data, 0, 2 * buf.size());
+	vram.readVRAMBx(2 * (x + y * vdp.getImageWidth()), line);
 	if (vdp.isSuperimposing()) {
 		auto transparent = color.lookup256(0);
-		for (/**/; nrPixels > 0; --nrPixels) {
-			uint8_t high = vram.readVRAMBx(address + 1);
-			if (high & 0x80) {
-				*out = transparent;
-			} else {
-				uint8_t low  = vram.readVRAMBx(address + 0);
-				*out = color.lookup32768(low + 256 * high);
-			}
-			address += 2;
-			out += 1;
+		for (auto i : xrange(buf.size())) {
+			uint8_t low  = line[2 * i + 0];
+			uint8_t high = line[2 * i + 1];
+			buf[i] = (high & 0x80) ? transparent : color.lookup32768(low + 256 * high);
 		}
 	} else {
-		for (/**/; nrPixels > 0; --nrPixels) {
-			uint8_t low  = vram.readVRAMBx(address++);
-			uint8_t high = vram.readVRAMBx(address++);
-			*out++ = color.lookup32768((low + 256 * high) & 0x7FFF);
+		for (auto i : xrange(buf.size())) {
+			uint8_t low  = line[2 * i + 0];
+			uint8_t high = line[2 * i + 1];
+			buf[i] = color.lookup32768((low + 256 * high) & 0x7FFF);
 		}
 	}
 }
@@ -174,11 +146,11 @@ static void rasterBD8(
 	ColorLookup color, const V9990& vdp, const V9990VRAM& vram,
 	std::span<Pixel> buf, unsigned x, unsigned y)
 {
-	Pixel* __restrict out = buf.data();
-	int nrPixels = narrow<int>(buf.size());
-	unsigned address = x + y * vdp.getImageWidth();
-	for (/**/; nrPixels > 0; --nrPixels) {
-		*out++ = color.lookup256(vram.readVRAMBx(address++));
+	std::array<uint8_t, 1024> data;
+	auto line = subspan(data, 0, buf.size());
+	vram.readVRAMBx(x + y * vdp.getImageWidth(), line);
+	for (auto i : xrange(buf.size())) {
+		buf[i] = color.lookup256(line[i]);
 	}
 }
 
@@ -187,115 +159,78 @@ static void rasterBP6(
 	ColorLookup color, const V9990& vdp, const V9990VRAM& vram,
 	std::span<Pixel> buf, unsigned x, unsigned y)
 {
-	Pixel* __restrict out = buf.data();
-	int nrPixels = narrow<int>(buf.size());
-	unsigned address = x + y * vdp.getImageWidth();
-	for (/**/; nrPixels > 0; --nrPixels) {
-		*out++ = color.lookup64(vram.readVRAMBx(address++) & 0x3F);
+	std::array<uint8_t, 1024> data;
+	auto line = subspan(data, 0, buf.size());
+	vram.readVRAMBx(x + y * vdp.getImageWidth(), line);
+	for (auto i : xrange(buf.size())) {
+		buf[i] = color.lookup64(line[i] & 0x3F);
 	}
 }
 
-template<std::unsigned_integral Pixel, typename ColorLookup>
+// 'HI_RES': Verified on real HW:
+//   Bit PLT05 in palette offset is ignored, instead for even pixels
+//   bit 'PLT05' is '0', for odd pixels it's '1'.
+template<bool HI_RES, std::unsigned_integral Pixel, typename ColorLookup>
 static void rasterBP4(
 	ColorLookup color, const V9990& vdp, const V9990VRAM& vram,
 	std::span<Pixel> buf, unsigned x, unsigned y)
 {
+	assert(!buf.empty());
+	color.set64Offset((vdp.getPaletteOffset() & (HI_RES ? 0x4 : 0xC)) << 2);
+	constexpr uint8_t ODD = HI_RES ? 32 : 0;
+	std::array<uint8_t, 1024 / 2 + 1> data;
+	auto line = subspan(data, 0, ((x & 1) + buf.size() + 1) / 2);
+	vram.readVRAMBx((x + y * vdp.getImageWidth()) / 2, line);
+
 	Pixel* __restrict out = buf.data();
-	int nrPixels = narrow<int>(buf.size());
-	assert(nrPixels > 0);
-	unsigned address = (x + y * vdp.getImageWidth()) / 2;
-	color.set64Offset((vdp.getPaletteOffset() & 0xC) << 2);
+	Pixel* end = out + buf.size();
+	const uint8_t* in = line.data();
 	if (x & 1) {
-		uint8_t data = vram.readVRAMBx(address++);
-		*out++ = color.lookup64(data & 0x0F);
-		--nrPixels;
+		*out++ = color.lookup64(ODD | (*in++ & 0x0F));
 	}
-	for (/**/; nrPixels > 0; nrPixels -= 2) {
-		uint8_t data = vram.readVRAMBx(address++);
-		*out++ = color.lookup64(data >> 4);
-		*out++ = color.lookup64(data & 0x0F);
-	}
-	// Note: this possibly draws 1 pixel too many, but that's ok.
-}
-template<std::unsigned_integral Pixel, typename ColorLookup>
-static void rasterBP4HiRes(
-	ColorLookup color, const V9990& vdp, const V9990VRAM& vram,
-	std::span<Pixel> buf, unsigned x, unsigned y)
-{
-	// Verified on real HW:
-	//   Bit PLT05 in palette offset is ignored, instead for even pixels
-	//   bit 'PLT05' is '0', for odd pixels it's '1'.
-	Pixel* __restrict out = buf.data();
-	int nrPixels = narrow<int>(buf.size());
-	unsigned address = (x + y * vdp.getImageWidth()) / 2;
-	color.set64Offset((vdp.getPaletteOffset() & 0x4) << 2);
-	if (x & 1) {
-		uint8_t data = vram.readVRAMBx(address++);
-		*out++ = color.lookup64(32 | (data & 0x0F));
-		--nrPixels;
+	for (/**/; (end - out) >= 2; out += 2) {
+		uint8_t d = *in++;
+		out[0] = color.lookup64(  0 | (d >> 4));
+		out[1] = color.lookup64(ODD | (d & 0x0F));
 	}
-	for (/**/; nrPixels > 0; nrPixels -= 2) {
-		uint8_t data = vram.readVRAMBx(address++);
-		*out++ = color.lookup64( 0 | (data >> 4  ));
-		*out++ = color.lookup64(32 | (data & 0x0F));
+	if (out != end) {
+		*out = color.lookup64(*in >> 4);
 	}
-	// Note: this possibly draws 1 pixel too many, but that's ok.
 }
 
-template<std::unsigned_integral Pixel, typename ColorLookup>
+template<bool HI_RES, std::unsigned_integral Pixel, typename ColorLookup>
 static void rasterBP2(
 	ColorLookup color, const V9990& vdp, const V9990VRAM& vram,
 	std::span<Pixel> buf, unsigned x, unsigned y)
 {
+	// For 'HI_RES' see rasterBP4().
+	assert(!buf.empty());
+	color.set64Offset((vdp.getPaletteOffset() & (HI_RES ? 0x7 : 0xF)) << 2);
+	constexpr uint8_t ODD = HI_RES ? 32 : 0;
+	std::array<uint8_t, 1024 / 4 + 1> data;
+	auto line = subspan(data, 0, ((x & 3) + buf.size() + 3) / 4);
+	vram.readVRAMBx((x + y * vdp.getImageWidth()) / 4, line);
+
 	Pixel* __restrict out = buf.data();
-	int nrPixels = narrow<int>(buf.size());
-	assert(nrPixels > 0);
-	unsigned address = (x + y * vdp.getImageWidth()) / 4;
-	color.set64Offset(vdp.getPaletteOffset() << 2);
-	if (x & 3) {
-		uint8_t data = vram.readVRAMBx(address++);
-		if ((x & 3) <= 1) *out++ = color.lookup64((data & 0x30) >> 4);
-		if ((x & 3) <= 2) *out++ = color.lookup64((data & 0x0C) >> 2);
-		if (true)         *out++ = color.lookup64((data & 0x03) >> 0);
-		nrPixels -= narrow<int>(4 - (x & 3));
+	Pixel* end = out + buf.size();
+	const uint8_t* in = line.data();
+	auto pixel = [&](uint8_t d, unsigned p) {
+		return color.lookup64(((p & 1) ? ODD : 0) | ((d >> (6 - 2 * p)) & 3));
+	};
+	if (auto p = x & 3) {
+		uint8_t d = *in++;
+		for (/**/; (p < 4) && (out != end); ++p) *out++ = pixel(d, p);
 	}
-	for (/**/; nrPixels > 0; nrPixels -= 4) {
-		uint8_t data = vram.readVRAMBx(address++);
-		*out++ = color.lookup64((data & 0xC0) >> 6);
-		*out++ = color.lookup64((data & 0x30) >> 4);
-		*out++ = color.lookup64((data & 0x0C) >> 2);
-		*out++ = color.lookup64((data & 0x03) >> 0);
-	}
-	// Note: this can draw up to 3 pixels too many, but that's ok.
-}
-template<std::unsigned_integral Pixel, typename ColorLookup>
-static void rasterBP2HiRes(
-	ColorLookup color, const V9990& vdp, const V9990VRAM& vram,
-	std::span<Pixel> buf, unsigned x, unsigned y)
-{
-	// Verified on real HW:
-	//   Bit PLT05 in palette offset is ignored, instead for even pixels
-	//   bit 'PLT05' is '0', for odd pixels it's '1'.
-	Pixel* __restrict out = buf.data();
-	int nrPixels = narrow<int>(buf.size());
-	assert(nrPixels > 0);
-	unsigned address = (x + y * vdp.getImageWidth()) / 4;
-	color.set64Offset((vdp.getPaletteOffset() & 0x7) << 2);
-	if (x & 3) {
-		uint8_t data = vram.readVRAMBx(address++);
-		if ((x & 3) <= 1) *out++ = color.lookup64(32 | ((data & 0x30) >> 4));
-		if ((x & 3) <= 2) *out++ = color.lookup64( 0 | ((data & 0x0C) >> 2));
-		if (true)         *out++ = color.lookup64(32 | ((data & 0x03) >> 0));
-		nrPixels -= narrow<int>(4 - (x & 3));
+	for (/**/; (end - out) >= 4; out += 4) {
+		uint8_t d = *in++;
+		out[0] = pixel(d, 0);
+		out[1] = pixel(d, 1);
+		out[2] = pixel(d, 2);
+		out[3] = pixel(d, 3);
 	}
-	for (/**/; nrPixels > 0; nrPixels -= 4) {
-		uint8_t data = vram.readVRAMBx(address++);
-		*out++ = color.lookup64( 0 | ((data & 0xC0) >> 6));
-		*out++ = color.lookup64(32 | ((data & 0x30) >> 4));
-		*out++ = color.lookup64( 0 | ((data & 0x0C) >> 2));
-		*out++ = color.lookup64(32 | ((data & 0x03) >> 0));
+	for (unsigned p = 0; out != end; ++p) {
+		*out++ = pixel(*in, p);
 	}
-	// Note: this can draw up to 3 pixels too many, but that's ok.
 }
 
 // Helper class to translate V9990 palette indices into host Pixel values.
@@ -355,17 +290,17 @@ static void raster(V9990ColorMode colorMode, bool highRes,
 {
 	switch (colorMode) {
 	using enum V9990ColorMode;
-	case BYUV:  return rasterBYUV <Pixel>(color, vdp, vram, out, x, y);
-	case BYUVP: return rasterBYUVP<Pixel>(color, vdp, vram, out, x, y);
-	case BYJK:  return rasterBYJK <Pixel>(color, vdp, vram, out, x, y);
-	case BYJKP: return rasterBYJKP<Pixel>(color, vdp, vram, out, x, y);
-	case BD16:  return rasterBD16 <Pixel>(color, vdp, vram, out, x, y);
-	case BD8:   return rasterBD8  <Pixel>(color, vdp, vram, out, x, y);
-	case BP6:   return rasterBP6  <Pixel>(color, vdp, vram, out, x, y);
-	case BP4:   return highRes ? rasterBP4HiRes<Pixel>(color, vdp, vram, out, x, y)
-	                           : rasterBP4     <Pixel>(color, vdp, vram, out, x, y);
-	case BP2:   return highRes ? rasterBP2HiRes<Pixel>(color, vdp, vram, out, x, y)
-	                           : rasterBP2     <Pixel>(color, vdp, vram, out, x, y);
+	case BYUV:  return rasterYJK_YUV<false, false, Pixel>(color, vdp, vram, out, x, y);
+	case BYUVP: return rasterYJK_YUV<false, true,  Pixel>(color, vdp, vram, out, x, y);
+	case BYJK:  return rasterYJK_YUV<true,  false, Pixel>(color, vdp, vram, out, x, y);
+	case BYJKP: return rasterYJK_YUV<true,  true,  Pixel>(color, vdp, vram, out, x, y);
+	case BD16:  return rasterBD16<Pixel>(color, vdp, vram, out, x, y);
+	case BD8:   return rasterBD8 <Pixel>(color, vdp, vram, out, x, y);
+	case BP6:   return rasterBP6 <Pixel>(color, vdp, vram, out, x, y);
+	case BP4:   return highRes ? rasterBP4<true,  Pixel>(color, vdp, vram, out, x, y)
+	                           : rasterBP4<false, Pixel>(color, vdp, vram, out, x, y);
+	case BP2:   return highRes ? rasterBP2<true,  Pixel>(color, vdp, vram, out, x, y)
+	                           : rasterBP2<false, Pixel>(color, vdp, vram, out, x, y);
 	default:    UNREACHABLE;
 	}
 }
@@ -471,7 +406,7 @@ void V9990BitmapConverter::convertLine(
 
 	if (cursor0.isVisible() || cursor1.isVisible()) {
 		// raster background into a temporary buffer
-		std::array<uint16_t, 1024 + 3> buf; // allow to draw upto 3 pixels too many, e.g. see rasterBP2()
+		std::array<uint16_t, 1024> buf;
 		raster(colorMode, highRes,
 		       IndexLookup(palette64_32768, palette256_32768),
 		       vdp, vram,
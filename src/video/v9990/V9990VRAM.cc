@@ -5,6 +5,11 @@
 #include "serialize.hh"
 
 #include <algorithm>
+#include <bit>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace openmsx {
 
@@ -27,6 +32,46 @@ void V9990VRAM::clear()
 	}
 }
 
+void V9990VRAM::readVRAMBx(unsigned address, std::span<uint8_t> dst) const
+{
+	// In Bx modes the even addresses are in the first half of the VRAM and
+	// the odd addresses in the second half. So the result is an interleave
+	// of two contiguous ranges.
+	if (dst.empty()) return;
+	if (address & 1) {
+		dst[0] = readVRAMBx(address++);
+		dst = dst.subspan(1);
+	}
+	constexpr unsigned HALF = VRAM_SIZE / 2;
+	const uint8_t* even = &data[0];
+	const uint8_t* odd  = &data[HALF];
+	while (dst.size() >= 2) {
+		unsigned start = (address & (VRAM_SIZE - 1)) / 2;
+		auto num = std::min<size_t>(dst.size() / 2, HALF - start); // don't wrap
+		const uint8_t* e = even + start;
+		const uint8_t* o = odd  + start;
+		uint8_t* d = dst.data();
+		size_t i = 0;
+#ifdef __SSE2__
+		for (/**/; (i + 16) <= num; i += 16) {
+			auto ve = _mm_loadu_si128(std::bit_cast<const __m128i*>(e + i));
+			auto vo = _mm_loadu_si128(std::bit_cast<const __m128i*>(o + i));
+			_mm_storeu_si128(std::bit_cast<__m128i*>(d + 2 * i +  0), _mm_unpacklo_epi8(ve, vo));
+			_mm_storeu_si128(std::bit_cast<__m128i*>(d + 2 * i + 16), _mm_unpackhi_epi8(ve, vo));
+		}
+#endif
+		for (/**/; i < num; ++i) {
+			d[2 * i + 0] = e[i];
+			d[2 * i + 1] = o[i];
+		}
+		address += unsigned(2 * num);
+		dst = dst.subspan(2 * num);
+	}
+	if (!dst.empty()) {
+		dst[0] = readVRAMBx(address);
+	}
+}
+
 unsigned V9990VRAM::mapAddress(unsigned address) const
 {
 	address &= 0x7FFFF; // change to assert?
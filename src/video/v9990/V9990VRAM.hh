@@ -7,6 +7,7 @@
 #include "TrackedRam.hh"
 
 #include <cstdint>
+#include <span>
 
 namespace openmsx {
 
@@ -56,6 +57,9 @@ public:
 	[[nodiscard]] uint8_t readVRAMBx(unsigned address) const {
 		return data[transformBx(address)];
 	}
+	/** Same as calling readVRAMBx() for the consecutive addresses
+	  * [address, address + dst.size()), but much faster. */
+	void readVRAMBx(unsigned address, std::span<uint8_t> dst) const;
 	[[nodiscard]] uint8_t readVRAMP1(unsigned address) const {
 		return data[transformP1(address)];
 	}
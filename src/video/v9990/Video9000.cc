@@ -119,13 +119,14 @@ void Video9000::paint(OutputSurface& output)
 	activeLayer->paint(output);
 }
 
-void Video9000::takeRawScreenShot(std::optional<unsigned> height, const std::string& filename)
+ScreenShotWriter::Image Video9000::takeRawScreenShot(
+	std::optional<unsigned> height, std::optional<SoftwareScaler> scaler)
 {
 	auto* layer = dynamic_cast<VideoLayer*>(activeLayer);
 	if (!layer) {
 		throw CommandException("TODO");
 	}
-	layer->takeRawScreenShot(height, filename);
+	return layer->takeRawScreenShot(height, scaler);
 }
 
 bool Video9000::signalEvent(const Event& event)
@@ -40,7 +40,8 @@ private:
 
 	// VideoLayer
 	void paint(OutputSurface& output) override;
-	void takeRawScreenShot(std::optional<unsigned> height, const std::string& filename) override;
+	[[nodiscard]] ScreenShotWriter::Image takeRawScreenShot(
+		std::optional<unsigned> height, std::optional<SoftwareScaler> scaler) override;
 
 	// EventListener
 	bool signalEvent(const Event& event) override;